@@ -0,0 +1,40 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "base/async_function.h"
+
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/notification.h"
+#include "absl/types/span.h"
+#include "common/value.h"
+
+namespace cel {
+
+absl::StatusOr<Value> AsyncFunction::Invoke(const InvokeContext& context,
+                                            absl::Span<const Value> args) const {
+  absl::StatusOr<Value> result =
+      absl::InternalError("asynchronous function did not produce a result");
+  absl::Notification done;
+  InvokeAsync(context, args, [&result, &done](absl::StatusOr<Value> value) {
+    result = std::move(value);
+    done.Notify();
+  });
+  done.WaitForNotification();
+  return result;
+}
+
+}  // namespace cel
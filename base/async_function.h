@@ -0,0 +1,58 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_BASE_ASYNC_FUNCTION_H_
+#define THIRD_PARTY_CEL_CPP_BASE_ASYNC_FUNCTION_H_
+
+#include "absl/functional/any_invocable.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "base/function.h"
+#include "common/value.h"
+
+namespace cel {
+
+// Interface for extension functions that complete asynchronously, e.g. by
+// issuing an RPC.
+//
+// Under the default evaluation entry points the interpreter calls Invoke(),
+// which starts the call and blocks until it completes, matching the behavior
+// of a synchronous extension function. Under asynchronous evaluation
+// (the stack machine's EvaluateAsynchronously) the interpreter suspends the
+// evaluation instead of blocking, so one thread can drive many in-flight
+// evaluations.
+class AsyncFunction : public Function {
+ public:
+  // Receives the result of the asynchronous call. Run exactly once, either
+  // inline from InvokeAsync or later from another thread (e.g. an RPC
+  // completion thread).
+  using DoneCallback = absl::AnyInvocable<void(absl::StatusOr<Value>) &&>;
+
+  // Starts the call. args and context are only guaranteed to be valid until
+  // InvokeAsync returns; implementations that complete later must copy what
+  // they need. Implementations must eventually run done exactly once.
+  virtual void InvokeAsync(const InvokeContext& context,
+                           absl::Span<const Value> args,
+                           DoneCallback done) const = 0;
+
+  // Blocking adapter: starts the call and waits for it to complete.
+  absl::StatusOr<Value> Invoke(const InvokeContext& context,
+                               absl::Span<const Value> args) const override;
+
+  const AsyncFunction* AsAsyncFunction() const final { return this; }
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_BASE_ASYNC_FUNCTION_H_
@@ -255,7 +255,7 @@ bool Attribute::operator<(const Attribute& other) const {
   return false;
 }
 
-const absl::StatusOr<std::string> Attribute::AsString() const {
+absl::StatusOr<std::string> Attribute::AsString() const {
   if (variable_name().empty()) {
     return absl::InvalidArgumentError(
         "Only ident rooted attributes are supported.");
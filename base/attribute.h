@@ -195,7 +195,7 @@ class Attribute final {
 
   bool operator<(const Attribute& other) const;
 
-  const absl::StatusOr<std::string> AsString() const;
+  absl::StatusOr<std::string> AsString() const;
 
  private:
   struct Impl final {
@@ -0,0 +1,80 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_BASE_ATTRIBUTE_PATTERN_INDEX_H_
+#define THIRD_PARTY_CEL_CPP_BASE_ATTRIBUTE_PATTERN_INDEX_H_
+
+#include <cstddef>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "base/attribute.h"
+
+namespace cel {
+
+// Index over a set of AttributePatterns, bucketed by root variable name.
+//
+// Attribute-tracked accesses only need to consider patterns rooted at the
+// accessed variable; with large pattern sets (hundreds of patterns in partial
+// evaluations) a per-access linear scan dominates, while the per-access
+// candidate set after bucketing is typically zero or one.
+//
+// The index stores pointers into the pattern storage it was built over, so
+// that storage must outlive the index and must not be reallocated. An
+// activation that owns its patterns can build the index once at binding time
+// and share it across every evaluation.
+class AttributePatternIndex final {
+ public:
+  // Pattern sets up to this size are cheaper to scan directly than to bucket;
+  // callers building an index lazily should skip sets at or below it.
+  static constexpr size_t kDirectScanThreshold = 4;
+
+  AttributePatternIndex() = default;
+
+  explicit AttributePatternIndex(absl::Span<const AttributePattern> patterns) {
+    buckets_.reserve(patterns.size());
+    for (const AttributePattern& pattern : patterns) {
+      buckets_[pattern.variable()].push_back(&pattern);
+    }
+  }
+
+  // Movable: buckets hold pointers into external pattern storage, which moves
+  // don't disturb.
+  AttributePatternIndex(AttributePatternIndex&&) = default;
+  AttributePatternIndex& operator=(AttributePatternIndex&&) = default;
+
+  // Returns the patterns rooted at `variable_name`; empty if none.
+  absl::Span<const AttributePattern* const> PatternsForRoot(
+      absl::string_view variable_name) const {
+    auto it = buckets_.find(variable_name);
+    if (it == buckets_.end()) {
+      return {};
+    }
+    return it->second;
+  }
+
+  bool empty() const { return buckets_.empty(); }
+
+ private:
+  // Keys view into the indexed patterns' own variable names.
+  absl::flat_hash_map<absl::string_view,
+                      absl::InlinedVector<const AttributePattern*, 4>>
+      buckets_;
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_BASE_ATTRIBUTE_PATTERN_INDEX_H_
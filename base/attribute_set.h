@@ -17,9 +17,9 @@
 
 #include <vector>
 
-#include "absl/container/btree_set.h"
 #include "absl/types/span.h"
 #include "base/attribute.h"
+#include "base/internal/persistent_set.h"
 
 namespace google::api::expr::runtime {
 class AttributeUtility;
@@ -34,9 +34,14 @@ class UnknownSet;
 
 // AttributeSet is a container for CEL attributes that are identified as
 // unknown during expression evaluation.
+//
+// Backed by an immutable, structurally shared tree: copies are O(1) and
+// merges share subtrees with both inputs, so the repeated unions performed
+// while propagating unknowns stay logarithmic instead of copying the
+// accumulated set each time.
 class AttributeSet final {
  private:
-  using Container = absl::btree_set<Attribute>;
+  using Container = base_internal::PersistentSet<Attribute>;
 
  public:
   using value_type = typename Container::value_type;
@@ -57,19 +62,15 @@ class AttributeSet final {
   }
 
   AttributeSet(const AttributeSet& set1, const AttributeSet& set2)
-      : attributes_(set1.attributes_) {
-    for (const auto& attr : set2.attributes_) {
-      Add(attr);
-    }
-  }
+      : attributes_(set1.attributes_.Union(set2.attributes_)) {}
 
   iterator begin() const { return attributes_.begin(); }
 
-  const_iterator cbegin() const { return attributes_.cbegin(); }
+  const_iterator cbegin() const { return attributes_.begin(); }
 
   iterator end() const { return attributes_.end(); }
 
-  const_iterator cend() const { return attributes_.cend(); }
+  const_iterator cend() const { return attributes_.end(); }
 
   size_type size() const { return attributes_.size(); }
 
@@ -93,12 +94,12 @@ class AttributeSet final {
   friend class UnknownValue;
   friend class base_internal::UnknownSet;
 
-  void Add(const Attribute& attribute) { attributes_.insert(attribute); }
+  void Add(const Attribute& attribute) {
+    attributes_ = attributes_.Insert(attribute);
+  }
 
   void Add(const AttributeSet& other) {
-    for (const auto& attribute : other) {
-      Add(attribute);
-    }
+    attributes_ = attributes_.Union(other.attributes_);
   }
 
   // Attribute container.
@@ -22,6 +22,8 @@
 
 namespace cel {
 
+class AsyncFunction;
+
 // Interface for extension functions.
 //
 // The host for the CEL environment may provide implementations to define custom
@@ -58,6 +60,11 @@ class Function {
   // follows CEL's logical short-circuiting behavior.
   virtual absl::StatusOr<Value> Invoke(const InvokeContext& context,
                                        absl::Span<const Value> args) const = 0;
+
+  // Returns the asynchronous interface for this function, or nullptr if the
+  // function only supports synchronous invocation. Overridden by
+  // cel::AsyncFunction; other implementations must not override this.
+  virtual const AsyncFunction* AsAsyncFunction() const { return nullptr; }
 };
 
 // Legacy type, aliased to the actual type.
@@ -16,13 +16,80 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include "absl/base/macros.h"
+#include "absl/base/no_destructor.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/hash/hash.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "base/kind.h"
 
 namespace cel {
 
+std::shared_ptr<const FunctionDescriptor::Impl> FunctionDescriptor::Intern(
+    absl::string_view name, bool receiver_style, std::vector<Kind> types,
+    bool is_strict) {
+  // Fields of an Impl, viewable without constructing one.
+  struct Key {
+    absl::string_view name;
+    bool receiver_style;
+    absl::Span<const Kind> types;
+    bool is_strict;
+  };
+  struct Hash {
+    using is_transparent = void;
+    size_t operator()(const Key& key) const {
+      return absl::HashOf(key.name, key.receiver_style, key.types,
+                          key.is_strict);
+    }
+    size_t operator()(const std::shared_ptr<const Impl>& impl) const {
+      return (*this)(Key{impl->name, impl->receiver_style,
+                         absl::MakeConstSpan(impl->types), impl->is_strict});
+    }
+  };
+  struct Eq {
+    using is_transparent = void;
+    bool operator()(const std::shared_ptr<const Impl>& lhs,
+                    const Key& rhs) const {
+      return lhs->name == rhs.name &&
+             lhs->receiver_style == rhs.receiver_style &&
+             absl::MakeConstSpan(lhs->types) == rhs.types &&
+             lhs->is_strict == rhs.is_strict;
+    }
+    bool operator()(const Key& lhs,
+                    const std::shared_ptr<const Impl>& rhs) const {
+      return (*this)(rhs, lhs);
+    }
+    bool operator()(const std::shared_ptr<const Impl>& lhs,
+                    const std::shared_ptr<const Impl>& rhs) const {
+      return (*this)(lhs, Key{rhs->name, rhs->receiver_style,
+                              absl::MakeConstSpan(rhs->types), rhs->is_strict});
+    }
+  };
+  // Interned descriptors are immortal: entries are never erased, so handles
+  // remain valid for the life of the process.
+  static absl::NoDestructor<absl::Mutex> mutex;
+  static absl::NoDestructor<
+      absl::flat_hash_set<std::shared_ptr<const Impl>, Hash, Eq>>
+      interned;
+
+  const Key key{name, receiver_style, absl::MakeConstSpan(types), is_strict};
+  absl::MutexLock lock(&*mutex);
+  auto it = interned->find(key);
+  if (it == interned->end()) {
+    it = interned
+             ->insert(std::make_shared<Impl>(name, receiver_style,
+                                             std::move(types), is_strict))
+             .first;
+  }
+  return *it;
+}
+
 bool FunctionDescriptor::ShapeMatches(bool receiver_style,
                                       absl::Span<const Kind> types) const {
   if (this->receiver_style() != receiver_style) {
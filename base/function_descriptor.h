@@ -27,12 +27,18 @@
 namespace cel {
 
 // Describes a function.
+//
+// Descriptors are interned process-wide: constructing a descriptor with the
+// same name, call style, argument kinds, and strictness yields a handle to
+// the same immortal storage. Registries and overload references that copy
+// descriptors therefore share one allocation per distinct signature, and
+// comparing identical descriptors takes the pointer-equality fast path in
+// `operator==` and `operator<`.
 class FunctionDescriptor final {
  public:
   FunctionDescriptor(absl::string_view name, bool receiver_style,
                      std::vector<Kind> types, bool is_strict = true)
-      : impl_(std::make_shared<Impl>(name, receiver_style, std::move(types),
-                                     is_strict)) {}
+      : impl_(Intern(name, receiver_style, std::move(types), is_strict)) {}
 
   // Function name.
   const std::string& name() const { return impl_->name; }
@@ -77,6 +83,13 @@ class FunctionDescriptor final {
     bool is_strict;
   };
 
+  // Returns the interned storage for the given fields, creating and
+  // retaining it process-wide on first use.
+  static std::shared_ptr<const Impl> Intern(absl::string_view name,
+                                            bool receiver_style,
+                                            std::vector<Kind> types,
+                                            bool is_strict);
+
   std::shared_ptr<const Impl> impl_;
 };
 
@@ -16,6 +16,7 @@
 #define THIRD_PARTY_CEL_CPP_BASE_FUNCTION_RESULT_H_
 
 #include <cstdint>
+#include <memory>
 #include <utility>
 
 #include "base/function_descriptor.h"
@@ -24,6 +25,11 @@ namespace cel {
 
 // Represents a function result that is unknown at the time of execution. This
 // allows for lazy evaluation of expensive functions.
+//
+// The descriptor is held behind a shared pointer: unknown processing copies
+// results freely while folding sets together, and sharing keeps those copies
+// at pointer cost instead of duplicating the descriptor's name and argument
+// kinds each time.
 class FunctionResult final {
  public:
   FunctionResult() = delete;
@@ -33,10 +39,18 @@ class FunctionResult final {
   FunctionResult& operator=(FunctionResult&&) = default;
 
   FunctionResult(FunctionDescriptor descriptor, int64_t expr_id)
+      : descriptor_(std::make_shared<const FunctionDescriptor>(
+            std::move(descriptor))),
+        expr_id_(expr_id) {}
+
+  // As above for callers that already hold a shared descriptor, avoiding the
+  // copy entirely.
+  FunctionResult(std::shared_ptr<const FunctionDescriptor> descriptor,
+                 int64_t expr_id)
       : descriptor_(std::move(descriptor)), expr_id_(expr_id) {}
 
   // The descriptor of the called function that return Unknown.
-  const FunctionDescriptor& descriptor() const { return descriptor_; }
+  const FunctionDescriptor& descriptor() const { return *descriptor_; }
 
   // The id of the |Expr| that triggered the function call step. Provided
   // informationally -- if two different |Expr|s generate the same unknown call,
@@ -47,13 +61,14 @@ class FunctionResult final {
   // comparator.
   // Compares descriptor then arguments elementwise.
   bool IsEqualTo(const FunctionResult& other) const {
-    return descriptor() == other.descriptor();
+    return descriptor_ == other.descriptor_ ||
+           descriptor() == other.descriptor();
   }
 
   // TODO: re-implement argument capture
 
  private:
-  FunctionDescriptor descriptor_;
+  std::shared_ptr<const FunctionDescriptor> descriptor_;
   int64_t expr_id_;
 };
 
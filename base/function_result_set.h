@@ -16,10 +16,9 @@
 #define THIRD_PARTY_CEL_CPP_BASE_FUNCTION_RESULT_SET_H_
 
 #include <initializer_list>
-#include <utility>
 
-#include "absl/container/btree_set.h"
 #include "base/function_result.h"
+#include "base/internal/persistent_set.h"
 
 namespace google::api::expr::runtime {
 class AttributeUtility;
@@ -36,9 +35,12 @@ class UnknownSet;
 // execution. Execution should advance further if this set of unknowns are
 // provided. It may not advance if only a subset are provided.
 // Set semantics use |IsEqualTo()| defined on |FunctionResult|.
+//
+// Like AttributeSet, backed by an immutable, structurally shared tree so
+// copies and repeated unions during unknown processing are cheap.
 class FunctionResultSet final {
  private:
-  using Container = absl::btree_set<FunctionResult>;
+  using Container = base_internal::PersistentSet<FunctionResult>;
 
  public:
   using value_type = typename Container::value_type;
@@ -56,19 +58,21 @@ class FunctionResultSet final {
   FunctionResultSet(const FunctionResultSet& lhs, const FunctionResultSet& rhs);
 
   // Initialize with a single FunctionResult.
-  explicit FunctionResultSet(FunctionResult initial)
-      : function_results_{std::move(initial)} {}
+  explicit FunctionResultSet(FunctionResult initial) { Add(initial); }
 
-  FunctionResultSet(std::initializer_list<FunctionResult> il)
-      : function_results_(il) {}
+  FunctionResultSet(std::initializer_list<FunctionResult> il) {
+    for (const auto& function_result : il) {
+      Add(function_result);
+    }
+  }
 
   iterator begin() const { return function_results_.begin(); }
 
-  const_iterator cbegin() const { return function_results_.cbegin(); }
+  const_iterator cbegin() const { return function_results_.begin(); }
 
   iterator end() const { return function_results_.end(); }
 
-  const_iterator cend() const { return function_results_.cend(); }
+  const_iterator cend() const { return function_results_.end(); }
 
   size_type size() const { return function_results_.size(); }
 
@@ -88,13 +92,11 @@ class FunctionResultSet final {
   friend class base_internal::UnknownSet;
 
   void Add(const FunctionResult& function_result) {
-    function_results_.insert(function_result);
+    function_results_ = function_results_.Insert(function_result);
   }
 
   void Add(const FunctionResultSet& other) {
-    for (const auto& function_result : other) {
-      Add(function_result);
-    }
+    function_results_ = function_results_.Union(other.function_results_);
   }
 
   Container function_results_;
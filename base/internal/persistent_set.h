@@ -0,0 +1,321 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_BASE_INTERNAL_PERSISTENT_SET_H_
+#define THIRD_PARTY_CEL_CPP_BASE_INTERNAL_PERSISTENT_SET_H_
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "absl/container/inlined_vector.h"
+
+namespace cel::base_internal {
+
+// An immutable, structurally shared ordered set.
+//
+// Implemented as a weight-balanced binary tree (Adams' representation, as in
+// the classic functional set libraries). Every operation returns a new set
+// that shares unmodified subtrees with its inputs, so copying a set is O(1)
+// and Union(m, n) with m <= n runs in O(m * log(n / m + 1)) — merging a
+// small set into a large accumulated one is logarithmic rather than a full
+// copy. This is the backing container for AttributeSet and
+// FunctionResultSet, whose repeated unions during unknown processing
+// otherwise degrade quadratically.
+//
+// Ordering and equivalence use `Compare` (strict weak ordering); elements
+// comparing equivalent are deduplicated.
+template <typename T, typename Compare = std::less<T>>
+class PersistentSet final {
+ private:
+  struct Node;
+  using NodePtr = std::shared_ptr<const Node>;
+
+  struct Node final {
+    Node(NodePtr left, T value, NodePtr right, size_t size)
+        : left(std::move(left)),
+          value(std::move(value)),
+          right(std::move(right)),
+          size(size) {}
+
+    const NodePtr left;
+    const T value;
+    const NodePtr right;
+    const size_t size;
+  };
+
+ public:
+  class const_iterator final {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    const_iterator() = default;
+
+    reference operator*() const { return stack_.back()->value; }
+
+    pointer operator->() const { return &stack_.back()->value; }
+
+    const_iterator& operator++() {
+      const Node* node = stack_.back();
+      stack_.pop_back();
+      PushLeftSpine(node->right.get());
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator result = *this;
+      ++*this;
+      return result;
+    }
+
+    friend bool operator==(const const_iterator& lhs,
+                           const const_iterator& rhs) {
+      if (lhs.stack_.empty() || rhs.stack_.empty()) {
+        return lhs.stack_.empty() && rhs.stack_.empty();
+      }
+      return lhs.stack_.back() == rhs.stack_.back();
+    }
+
+    friend bool operator!=(const const_iterator& lhs,
+                           const const_iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    friend class PersistentSet;
+
+    explicit const_iterator(const Node* root) { PushLeftSpine(root); }
+
+    void PushLeftSpine(const Node* node) {
+      while (node != nullptr) {
+        stack_.push_back(node);
+        node = node->left.get();
+      }
+    }
+
+    // The path of subtrees still to be visited; depth is logarithmic in the
+    // set size, so typical iterations stay within the inline capacity.
+    absl::InlinedVector<const Node*, 16> stack_;
+  };
+
+  using value_type = T;
+  using size_type = size_t;
+  using iterator = const_iterator;
+
+  PersistentSet() = default;
+  PersistentSet(const PersistentSet&) = default;
+  PersistentSet(PersistentSet&&) = default;
+  PersistentSet& operator=(const PersistentSet&) = default;
+  PersistentSet& operator=(PersistentSet&&) = default;
+
+  const_iterator begin() const { return const_iterator(root_.get()); }
+
+  const_iterator end() const { return const_iterator(); }
+
+  size_type size() const { return SizeOf(root_); }
+
+  bool empty() const { return root_ == nullptr; }
+
+  bool contains(const T& value) const {
+    const Node* node = root_.get();
+    while (node != nullptr) {
+      if (Compare()(value, node->value)) {
+        node = node->left.get();
+      } else if (Compare()(node->value, value)) {
+        node = node->right.get();
+      } else {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Returns this set with `value` added. Shares all subtrees off the
+  // insertion path with this set; returns an identical set when an
+  // equivalent element is already present.
+  PersistentSet Insert(const T& value) const {
+    return PersistentSet(InsertImpl(root_, value));
+  }
+
+  // Returns the union of both sets, sharing structure with both inputs.
+  PersistentSet Union(const PersistentSet& other) const {
+    return PersistentSet(UnionImpl(root_, other.root_));
+  }
+
+  // Equivalence under `Compare` of the element sequences.
+  friend bool operator==(const PersistentSet& lhs, const PersistentSet& rhs) {
+    if (lhs.root_ == rhs.root_) {
+      return true;
+    }
+    if (lhs.size() != rhs.size()) {
+      return false;
+    }
+    for (auto lhs_it = lhs.begin(), rhs_it = rhs.begin(); lhs_it != lhs.end();
+         ++lhs_it, ++rhs_it) {
+      if (Compare()(*lhs_it, *rhs_it) || Compare()(*rhs_it, *lhs_it)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  friend bool operator!=(const PersistentSet& lhs, const PersistentSet& rhs) {
+    return !(lhs == rhs);
+  }
+
+ private:
+  // Weight-balance parameters from Adams' "Implementing Sets Efficiently in
+  // a Functional Language": a subtree may be at most kDelta times heavier
+  // than its sibling, restored by a single rotation unless the inner
+  // grandchild outweighs the outer child by kRatio.
+  static constexpr size_t kDelta = 3;
+  static constexpr size_t kRatio = 2;
+
+  explicit PersistentSet(NodePtr root) : root_(std::move(root)) {}
+
+  static size_t SizeOf(const NodePtr& node) {
+    return node != nullptr ? node->size : 0;
+  }
+
+  static NodePtr MakeNode(NodePtr left, const T& value, NodePtr right) {
+    size_t size = SizeOf(left) + SizeOf(right) + 1;
+    return std::make_shared<const Node>(std::move(left), value,
+                                        std::move(right), size);
+  }
+
+  // Rebuilds a node whose children differ in weight by at most one
+  // insertion or one Join step, restoring the balance invariant with single
+  // or double rotations.
+  static NodePtr Balance(const NodePtr& left, const T& value,
+                         const NodePtr& right) {
+    size_t left_size = SizeOf(left);
+    size_t right_size = SizeOf(right);
+    if (left_size + right_size <= 1) {
+      return MakeNode(left, value, right);
+    }
+    if (right_size > kDelta * left_size) {
+      if (SizeOf(right->left) < kRatio * SizeOf(right->right)) {
+        // Single left rotation.
+        return MakeNode(MakeNode(left, value, right->left), right->value,
+                        right->right);
+      }
+      // Double left rotation.
+      return MakeNode(MakeNode(left, value, right->left->left),
+                      right->left->value,
+                      MakeNode(right->left->right, right->value,
+                               right->right));
+    }
+    if (left_size > kDelta * right_size) {
+      if (SizeOf(left->right) < kRatio * SizeOf(left->left)) {
+        // Single right rotation.
+        return MakeNode(left->left, left->value,
+                        MakeNode(left->right, value, right));
+      }
+      // Double right rotation.
+      return MakeNode(
+          MakeNode(left->left, left->value, left->right->left),
+          left->right->value, MakeNode(left->right->right, value, right));
+    }
+    return MakeNode(left, value, right);
+  }
+
+  static NodePtr InsertImpl(const NodePtr& node, const T& value) {
+    if (node == nullptr) {
+      return MakeNode(nullptr, value, nullptr);
+    }
+    if (Compare()(value, node->value)) {
+      NodePtr left = InsertImpl(node->left, value);
+      if (left == node->left) {
+        return node;
+      }
+      return Balance(left, node->value, node->right);
+    }
+    if (Compare()(node->value, value)) {
+      NodePtr right = InsertImpl(node->right, value);
+      if (right == node->right) {
+        return node;
+      }
+      return Balance(node->left, node->value, right);
+    }
+    // Equivalent element already present; share the whole subtree.
+    return node;
+  }
+
+  // Concatenates left < value < right into one balanced tree, descending
+  // the heavier side's spine until the weights are compatible.
+  static NodePtr Join(const NodePtr& left, const T& value,
+                      const NodePtr& right) {
+    if (left == nullptr) {
+      return InsertImpl(right, value);
+    }
+    if (right == nullptr) {
+      return InsertImpl(left, value);
+    }
+    if (SizeOf(left) > kDelta * SizeOf(right)) {
+      return Balance(left->left, left->value, Join(left->right, value, right));
+    }
+    if (SizeOf(right) > kDelta * SizeOf(left)) {
+      return Balance(Join(left, value, right->left), right->value,
+                     right->right);
+    }
+    return MakeNode(left, value, right);
+  }
+
+  struct SplitResult {
+    NodePtr left;
+    NodePtr right;
+  };
+
+  // Partitions the tree into elements less than and greater than `value`,
+  // dropping an equivalent element if present.
+  static SplitResult Split(const NodePtr& node, const T& value) {
+    if (node == nullptr) {
+      return SplitResult{nullptr, nullptr};
+    }
+    if (Compare()(value, node->value)) {
+      SplitResult split = Split(node->left, value);
+      return SplitResult{std::move(split.left),
+                         Join(split.right, node->value, node->right)};
+    }
+    if (Compare()(node->value, value)) {
+      SplitResult split = Split(node->right, value);
+      return SplitResult{Join(node->left, node->value, split.left),
+                         std::move(split.right)};
+    }
+    return SplitResult{node->left, node->right};
+  }
+
+  static NodePtr UnionImpl(const NodePtr& lhs, const NodePtr& rhs) {
+    if (lhs == nullptr) {
+      return rhs;
+    }
+    if (rhs == nullptr || lhs == rhs) {
+      return lhs;
+    }
+    SplitResult split = Split(lhs, rhs->value);
+    return Join(UnionImpl(split.left, rhs->left), rhs->value,
+                UnionImpl(split.right, rhs->right));
+  }
+
+  NodePtr root_;
+};
+
+}  // namespace cel::base_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_BASE_INTERNAL_PERSISTENT_SET_H_
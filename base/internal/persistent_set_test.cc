@@ -0,0 +1,155 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "base/internal/persistent_set.h"
+
+#include <string>
+#include <vector>
+
+#include "internal/testing.h"
+
+namespace cel::base_internal {
+namespace {
+
+using testing::ElementsAre;
+using testing::ElementsAreArray;
+
+std::vector<int> Elements(const PersistentSet<int>& set) {
+  return std::vector<int>(set.begin(), set.end());
+}
+
+TEST(PersistentSetTest, EmptySet) {
+  PersistentSet<int> set;
+  EXPECT_TRUE(set.empty());
+  EXPECT_EQ(set.size(), 0);
+  EXPECT_EQ(set.begin(), set.end());
+  EXPECT_FALSE(set.contains(1));
+}
+
+TEST(PersistentSetTest, InsertIsPersistent) {
+  PersistentSet<int> empty;
+  PersistentSet<int> one = empty.Insert(1);
+  PersistentSet<int> two = one.Insert(2);
+
+  EXPECT_TRUE(empty.empty());
+  EXPECT_THAT(Elements(one), ElementsAre(1));
+  EXPECT_THAT(Elements(two), ElementsAre(1, 2));
+  EXPECT_TRUE(two.contains(1));
+  EXPECT_TRUE(two.contains(2));
+  EXPECT_FALSE(one.contains(2));
+}
+
+TEST(PersistentSetTest, IterationIsSortedAndDeduplicated) {
+  PersistentSet<int> set;
+  for (int value : {5, 3, 9, 3, 1, 7, 5, 9}) {
+    set = set.Insert(value);
+  }
+  EXPECT_EQ(set.size(), 5);
+  EXPECT_THAT(Elements(set), ElementsAre(1, 3, 5, 7, 9));
+}
+
+TEST(PersistentSetTest, UnionMergesAndShares) {
+  PersistentSet<int> evens;
+  PersistentSet<int> odds;
+  for (int i = 0; i < 100; i += 2) {
+    evens = evens.Insert(i);
+    odds = odds.Insert(i + 1);
+  }
+
+  PersistentSet<int> merged = evens.Union(odds);
+  EXPECT_EQ(merged.size(), 100);
+  std::vector<int> expected;
+  for (int i = 0; i < 100; ++i) {
+    expected.push_back(i);
+  }
+  EXPECT_THAT(Elements(merged), ElementsAreArray(expected));
+  // Inputs are untouched.
+  EXPECT_EQ(evens.size(), 50);
+  EXPECT_EQ(odds.size(), 50);
+}
+
+TEST(PersistentSetTest, UnionWithOverlap) {
+  PersistentSet<int> lhs;
+  PersistentSet<int> rhs;
+  for (int i = 0; i < 20; ++i) {
+    lhs = lhs.Insert(i);
+  }
+  for (int i = 10; i < 30; ++i) {
+    rhs = rhs.Insert(i);
+  }
+  PersistentSet<int> merged = lhs.Union(rhs);
+  EXPECT_EQ(merged.size(), 30);
+  for (int i = 0; i < 30; ++i) {
+    EXPECT_TRUE(merged.contains(i)) << i;
+  }
+}
+
+TEST(PersistentSetTest, UnionWithEmptySharesRoot) {
+  PersistentSet<int> set = PersistentSet<int>().Insert(1).Insert(2);
+  EXPECT_EQ(set.Union(PersistentSet<int>()), set);
+  EXPECT_EQ(PersistentSet<int>().Union(set), set);
+}
+
+TEST(PersistentSetTest, Equality) {
+  PersistentSet<int> lhs;
+  PersistentSet<int> rhs;
+  // Same elements in different insertion orders compare equal.
+  for (int value : {1, 2, 3, 4, 5}) {
+    lhs = lhs.Insert(value);
+  }
+  for (int value : {5, 3, 1, 4, 2}) {
+    rhs = rhs.Insert(value);
+  }
+  EXPECT_EQ(lhs, rhs);
+  EXPECT_NE(lhs, rhs.Insert(6));
+  EXPECT_NE(lhs, PersistentSet<int>());
+}
+
+TEST(PersistentSetTest, InsertExistingReturnsSameTree) {
+  PersistentSet<int> set = PersistentSet<int>().Insert(1).Insert(2).Insert(3);
+  PersistentSet<int> same = set.Insert(2);
+  EXPECT_EQ(set, same);
+  EXPECT_EQ(same.size(), 3);
+}
+
+TEST(PersistentSetTest, StaysBalancedUnderSortedInsertion) {
+  // Sorted insertion is the worst case for an unbalanced tree; with 10k
+  // elements an unbalanced right spine would overflow iteration and make
+  // contains() linear. Completing quickly with correct ordering is the
+  // signal that rebalancing works.
+  PersistentSet<int> set;
+  for (int i = 0; i < 10000; ++i) {
+    set = set.Insert(i);
+  }
+  EXPECT_EQ(set.size(), 10000);
+  EXPECT_TRUE(set.contains(0));
+  EXPECT_TRUE(set.contains(9999));
+  int expected = 0;
+  for (int value : set) {
+    EXPECT_EQ(value, expected++);
+  }
+  EXPECT_EQ(expected, 10000);
+}
+
+TEST(PersistentSetTest, WorksWithStrings) {
+  PersistentSet<std::string> set;
+  for (const char* value : {"b", "a", "c", "a"}) {
+    set = set.Insert(value);
+  }
+  EXPECT_THAT(std::vector<std::string>(set.begin(), set.end()),
+              ElementsAre("a", "b", "c"));
+}
+
+}  // namespace
+}  // namespace cel::base_internal
@@ -0,0 +1,124 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/ast_index.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "common/expr.h"
+
+namespace cel {
+
+namespace {
+
+// Appends pointers to the direct children of `expr` in the same order
+// `AstTraverse` visits them.
+void AppendChildren(const Expr& expr, std::vector<const Expr*>& children) {
+  if (expr.has_select_expr()) {
+    const auto& select_expr = expr.select_expr();
+    if (select_expr.has_operand()) {
+      children.push_back(&select_expr.operand());
+    }
+  } else if (expr.has_call_expr()) {
+    const auto& call_expr = expr.call_expr();
+    if (call_expr.has_target()) {
+      children.push_back(&call_expr.target());
+    }
+    for (const auto& arg : call_expr.args()) {
+      children.push_back(&arg);
+    }
+  } else if (expr.has_list_expr()) {
+    for (const auto& element : expr.list_expr().elements()) {
+      children.push_back(&element.expr());
+    }
+  } else if (expr.has_struct_expr()) {
+    for (const auto& field : expr.struct_expr().fields()) {
+      if (field.has_value()) {
+        children.push_back(&field.value());
+      }
+    }
+  } else if (expr.has_map_expr()) {
+    for (const auto& entry : expr.map_expr().entries()) {
+      if (entry.has_key()) {
+        children.push_back(&entry.key());
+      }
+      if (entry.has_value()) {
+        children.push_back(&entry.value());
+      }
+    }
+  } else if (expr.has_comprehension_expr()) {
+    const auto& comprehension_expr = expr.comprehension_expr();
+    children.push_back(&comprehension_expr.iter_range());
+    children.push_back(&comprehension_expr.accu_init());
+    children.push_back(&comprehension_expr.loop_condition());
+    children.push_back(&comprehension_expr.loop_step());
+    children.push_back(&comprehension_expr.result());
+  }
+}
+
+}  // namespace
+
+AstIndex::AstIndex(const Expr& root) {
+  // Depth-first walk assigning pre-order positions and parents. The pending
+  // stack holds (node, parent position) pairs; children are pushed in reverse
+  // so they pop in source order.
+  struct Pending {
+    const Expr* expr;
+    int32_t parent;
+  };
+  std::vector<Pending> stack;
+  std::vector<const Expr*> scratch_children;
+  stack.push_back(Pending{&root, kNoParent});
+  while (!stack.empty()) {
+    Pending pending = stack.back();
+    stack.pop_back();
+    int32_t position = static_cast<int32_t>(nodes_.size());
+    nodes_.push_back(Node{pending.expr, pending.parent, 0, 0, position + 1});
+    scratch_children.clear();
+    AppendChildren(*pending.expr, scratch_children);
+    for (auto it = scratch_children.rbegin(); it != scratch_children.rend();
+         ++it) {
+      stack.push_back(Pending{*it, position});
+    }
+  }
+
+  // Subtree extents. Nodes are in pre-order, so walking backwards guarantees
+  // every node's extent is final before its parent absorbs it.
+  for (int32_t position = size() - 1; position > 0; --position) {
+    Node& parent = nodes_[nodes_[position].parent];
+    if (nodes_[position].subtree_end > parent.subtree_end) {
+      parent.subtree_end = nodes_[position].subtree_end;
+    }
+  }
+
+  // Child ranges, built with a counting pass so each node's children form a
+  // contiguous, source-ordered run in `children_`.
+  for (int32_t position = 1; position < size(); ++position) {
+    ++nodes_[nodes_[position].parent].children_end;
+  }
+  int32_t offset = 0;
+  for (Node& node : nodes_) {
+    node.children_begin = offset;
+    offset += node.children_end;
+    node.children_end = node.children_begin;
+  }
+  children_.resize(offset);
+  for (int32_t position = 1; position < size(); ++position) {
+    Node& parent = nodes_[nodes_[position].parent];
+    children_[parent.children_end++] = position;
+  }
+}
+
+}  // namespace cel
@@ -0,0 +1,94 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_COMMON_AST_INDEX_H_
+#define THIRD_PARTY_CEL_CPP_COMMON_AST_INDEX_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/types/span.h"
+#include "common/expr.h"
+
+namespace cel {
+
+// `AstIndex` is a flattened, cache-friendly pre-order view of an `Expr` tree.
+//
+// All per-node information lives in contiguous arrays indexed by pre-order
+// position, so whole-tree passes over large expressions can iterate linearly
+// instead of repeatedly chasing child pointers through the tree. The layout
+// also answers the structural questions traversal visitors usually recompute:
+// the parent of a node, its direct children, and the extent of its subtree.
+//
+// Child order matches `AstTraverse`: select operand; call target then
+// arguments; list elements; struct field values; map entry keys and values
+// interleaved; comprehension range, init, condition, step, result.
+//
+// The index borrows the tree: the `Expr` must outlive the index and must not
+// be mutated while the index is in use.
+class AstIndex final {
+ public:
+  // Sentinel parent position for the root node.
+  static constexpr int32_t kNoParent = -1;
+
+  struct Node final {
+    // Not null. The indexed expression node.
+    const Expr* expr;
+    // Pre-order position of the parent, or `kNoParent` for the root.
+    int32_t parent;
+    // Range of this node's direct children in `children()`, in source order.
+    int32_t children_begin;
+    int32_t children_end;
+    // One past the last pre-order position in this node's subtree. The
+    // descendants of the node at position `i`, inclusive of the node itself,
+    // are exactly the positions `[i, subtree_end)`.
+    int32_t subtree_end;
+  };
+
+  explicit AstIndex(const Expr& root ABSL_ATTRIBUTE_LIFETIME_BOUND);
+
+  AstIndex(const AstIndex&) = delete;
+  AstIndex& operator=(const AstIndex&) = delete;
+  AstIndex(AstIndex&&) = default;
+  AstIndex& operator=(AstIndex&&) = default;
+
+  // Number of nodes in the tree.
+  int32_t size() const { return static_cast<int32_t>(nodes_.size()); }
+
+  // All nodes in pre-order; position 0 is the root.
+  absl::Span<const Node> nodes() const ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return absl::MakeConstSpan(nodes_);
+  }
+
+  const Node& node(int32_t position) const ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return nodes_[position];
+  }
+
+  // Pre-order positions of the direct children of the node at `position`.
+  absl::Span<const int32_t> children(int32_t position) const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    const Node& node = nodes_[position];
+    return absl::MakeConstSpan(children_)
+        .subspan(node.children_begin, node.children_end - node.children_begin);
+  }
+
+ private:
+  std::vector<Node> nodes_;
+  std::vector<int32_t> children_;
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_COMMON_AST_INDEX_H_
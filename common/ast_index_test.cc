@@ -0,0 +1,151 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/ast_index.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "common/expr.h"
+#include "internal/testing.h"
+
+namespace cel {
+namespace {
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+Expr MakeIdentExpr(ExprId id, absl::string_view name) {
+  Expr expr;
+  expr.set_id(id);
+  expr.mutable_ident_expr().set_name(name);
+  return expr;
+}
+
+Expr MakeConstExpr(ExprId id, int64_t value) {
+  Expr expr;
+  expr.set_id(id);
+  expr.mutable_const_expr().set_int_value(value);
+  return expr;
+}
+
+std::vector<ExprId> IdsOf(const AstIndex& index) {
+  std::vector<ExprId> ids;
+  ids.reserve(index.size());
+  for (const AstIndex::Node& node : index.nodes()) {
+    ids.push_back(node.expr->id());
+  }
+  return ids;
+}
+
+TEST(AstIndex, SingleNode) {
+  Expr root = MakeIdentExpr(1, "a");
+  AstIndex index(root);
+  ASSERT_EQ(index.size(), 1);
+  EXPECT_EQ(index.node(0).expr, &root);
+  EXPECT_EQ(index.node(0).parent, AstIndex::kNoParent);
+  EXPECT_EQ(index.node(0).subtree_end, 1);
+  EXPECT_THAT(index.children(0), IsEmpty());
+}
+
+TEST(AstIndex, PreorderAndParents) {
+  // t.f(a.b, 1)
+  Expr root;
+  root.set_id(1);
+  auto& call_expr = root.mutable_call_expr();
+  call_expr.set_function("f");
+  call_expr.set_target(MakeIdentExpr(2, "t"));
+  Expr select;
+  select.set_id(3);
+  select.mutable_select_expr().set_operand(MakeIdentExpr(4, "a"));
+  select.mutable_select_expr().set_field("b");
+  call_expr.mutable_args().push_back(std::move(select));
+  call_expr.mutable_args().push_back(MakeConstExpr(5, 1));
+
+  AstIndex index(root);
+  ASSERT_EQ(index.size(), 5);
+  EXPECT_THAT(IdsOf(index), ElementsAre(1, 2, 3, 4, 5));
+  EXPECT_EQ(index.node(0).parent, AstIndex::kNoParent);
+  EXPECT_EQ(index.node(1).parent, 0);
+  EXPECT_EQ(index.node(2).parent, 0);
+  EXPECT_EQ(index.node(3).parent, 2);
+  EXPECT_EQ(index.node(4).parent, 0);
+  EXPECT_THAT(index.children(0), ElementsAre(1, 2, 4));
+  EXPECT_THAT(index.children(2), ElementsAre(3));
+}
+
+TEST(AstIndex, SubtreeExtents) {
+  // t.f(a.b, 1): the select subtree spans positions [2, 4).
+  Expr root;
+  root.set_id(1);
+  auto& call_expr = root.mutable_call_expr();
+  call_expr.set_function("f");
+  call_expr.set_target(MakeIdentExpr(2, "t"));
+  Expr select;
+  select.set_id(3);
+  select.mutable_select_expr().set_operand(MakeIdentExpr(4, "a"));
+  select.mutable_select_expr().set_field("b");
+  call_expr.mutable_args().push_back(std::move(select));
+  call_expr.mutable_args().push_back(MakeConstExpr(5, 1));
+
+  AstIndex index(root);
+  ASSERT_EQ(index.size(), 5);
+  EXPECT_EQ(index.node(0).subtree_end, 5);
+  EXPECT_EQ(index.node(1).subtree_end, 2);
+  EXPECT_EQ(index.node(2).subtree_end, 4);
+  EXPECT_EQ(index.node(3).subtree_end, 4);
+  EXPECT_EQ(index.node(4).subtree_end, 5);
+}
+
+TEST(AstIndex, MapEntriesInterleaveKeysAndValues) {
+  // {"k1": 1, "k2": 2}
+  Expr root;
+  root.set_id(1);
+  auto& map_expr = root.mutable_map_expr();
+  MapExprEntry entry1;
+  entry1.set_key(MakeConstExpr(2, 10));
+  entry1.set_value(MakeConstExpr(3, 11));
+  map_expr.mutable_entries().push_back(std::move(entry1));
+  MapExprEntry entry2;
+  entry2.set_key(MakeConstExpr(4, 20));
+  entry2.set_value(MakeConstExpr(5, 21));
+  map_expr.mutable_entries().push_back(std::move(entry2));
+
+  AstIndex index(root);
+  EXPECT_THAT(IdsOf(index), ElementsAre(1, 2, 3, 4, 5));
+  EXPECT_THAT(index.children(0), ElementsAre(1, 2, 3, 4));
+}
+
+TEST(AstIndex, ComprehensionChildren) {
+  Expr root;
+  root.set_id(1);
+  auto& comprehension_expr = root.mutable_comprehension_expr();
+  comprehension_expr.set_iter_var("x");
+  comprehension_expr.set_accu_var("__result__");
+  comprehension_expr.set_iter_range(MakeIdentExpr(2, "range"));
+  comprehension_expr.set_accu_init(MakeConstExpr(3, 0));
+  comprehension_expr.set_loop_condition(MakeConstExpr(4, 1));
+  comprehension_expr.set_loop_step(MakeIdentExpr(5, "__result__"));
+  comprehension_expr.set_result(MakeIdentExpr(6, "__result__"));
+
+  AstIndex index(root);
+  EXPECT_THAT(IdsOf(index), ElementsAre(1, 2, 3, 4, 5, 6));
+  EXPECT_THAT(index.children(0), ElementsAre(1, 2, 3, 4, 5));
+  EXPECT_EQ(index.node(0).subtree_end, 6);
+}
+
+}  // namespace
+}  // namespace cel
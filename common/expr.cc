@@ -14,10 +14,82 @@
 
 #include "common/expr.h"
 
+#include <cstddef>
+#include <new>
+
 #include "absl/base/no_destructor.h"
+#include "absl/log/absl_check.h"
 
 namespace cel {
 
+namespace {
+
+// A freed `Expr` node awaiting reuse. The node's own storage holds the link to
+// the next free node.
+struct FreeExprNode {
+  FreeExprNode* next;
+};
+
+static_assert(sizeof(Expr) >= sizeof(FreeExprNode),
+              "Expr must be large enough to hold a free list link");
+
+// Upper bound on the number of nodes retained per thread. Beyond this the
+// excess is returned to the global allocator, keeping the worst-case retained
+// memory small while still covering typical expression sizes.
+constexpr size_t kMaxFreeExprNodes = 1024;
+
+struct ExprNodeFreeList {
+  ExprNodeFreeList() = default;
+
+  ~ExprNodeFreeList() {
+    while (head != nullptr) {
+      FreeExprNode* node = head;
+      head = node->next;
+      ::operator delete(node);
+    }
+  }
+
+  FreeExprNode* head = nullptr;
+  size_t size = 0;
+};
+
+ExprNodeFreeList& ThreadLocalExprNodeFreeList() {
+  static thread_local ExprNodeFreeList free_list;
+  return free_list;
+}
+
+}  // namespace
+
+void* Expr::operator new(size_t size) {
+  ABSL_DCHECK_EQ(size, sizeof(Expr));
+  ExprNodeFreeList& free_list = ThreadLocalExprNodeFreeList();
+  if (free_list.head != nullptr) {
+    FreeExprNode* node = free_list.head;
+    free_list.head = node->next;
+    --free_list.size;
+    return node;
+  }
+  return ::operator new(size);
+}
+
+void Expr::operator delete(void* ptr, size_t size) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  // Nodes freed on another thread land on that thread's list; each list is
+  // bounded independently so this stays safe regardless of which thread tears
+  // down an AST.
+  ExprNodeFreeList& free_list = ThreadLocalExprNodeFreeList();
+  if (size == sizeof(Expr) && free_list.size < kMaxFreeExprNodes) {
+    auto* node = static_cast<FreeExprNode*>(ptr);
+    node->next = free_list.head;
+    free_list.head = node;
+    ++free_list.size;
+    return;
+  }
+  ::operator delete(ptr);
+}
+
 const UnspecifiedExpr& UnspecifiedExpr::default_instance() {
   static const absl::NoDestructor<UnspecifiedExpr> instance;
   return *instance;
@@ -15,6 +15,7 @@
 #ifndef THIRD_PARTY_CEL_CPP_COMMON_EXPR_H_
 #define THIRD_PARTY_CEL_CPP_COMMON_EXPR_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -758,6 +759,14 @@ class Expr final {
   Expr(const Expr&) = delete;
   Expr& operator=(const Expr&) = delete;
 
+  // `Expr` nodes are individually heap allocated by the parser and the macro
+  // factories, then freed together when the resulting AST is discarded. The
+  // class-specific allocation functions recycle freed nodes through a bounded
+  // thread-local free list, so repeat parse-and-discard cycles reuse warm
+  // memory instead of round-tripping through the global allocator per node.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size) noexcept;
+
   void Clear();
 
   ABSL_MUST_USE_RESULT ExprId id() const { return id_; }
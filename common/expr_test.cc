@@ -14,8 +14,10 @@
 
 #include "common/expr.h"
 
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "internal/testing.h"
 
@@ -555,5 +557,31 @@ TEST(Expr, Id) {
   EXPECT_THAT(expr.id(), Eq(1));
 }
 
+TEST(Expr, NodeAllocationRecycling) {
+  // Freed nodes are recycled LIFO from a thread-local list, so a free followed
+  // by an allocation on the same thread returns the same storage.
+  auto expr = std::make_unique<Expr>();
+  const void* recycled = expr.get();
+  expr.reset();
+  expr = std::make_unique<Expr>();
+  EXPECT_EQ(static_cast<const void*>(expr.get()), recycled);
+}
+
+TEST(Expr, NodeAllocationBulkChurn) {
+  // Exceeding the per-thread retention bound must degrade gracefully to the
+  // global allocator.
+  for (int round = 0; round < 4; ++round) {
+    std::vector<std::unique_ptr<Expr>> exprs;
+    exprs.reserve(4096);
+    for (int i = 0; i < 4096; ++i) {
+      exprs.push_back(std::make_unique<Expr>());
+      exprs.back()->set_id(i);
+    }
+    for (int i = 0; i < 4096; ++i) {
+      EXPECT_THAT(exprs[i]->id(), Eq(i));
+    }
+  }
+}
+
 }  // namespace
 }  // namespace cel
@@ -14,6 +14,7 @@
 
 #include "common/internal/byte_string.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -325,6 +326,65 @@ void ByteString::RemoveSuffix(size_t n) {
   }
 }
 
+ByteString ByteString::Concat(Allocator<> allocator, const ByteString& lhs,
+                              const ByteString& rhs) {
+  const absl::optional<absl::string_view> lhs_flat = lhs.TryFlat();
+  const absl::optional<absl::string_view> rhs_flat = rhs.TryFlat();
+  if (!lhs_flat.has_value() || !rhs_flat.has_value()) {
+    // At least one operand is a Cord too large to view contiguously; append
+    // the Cords so existing tree storage is shared rather than copied.
+    absl::Cord cord = lhs.ToCord();
+    cord.Append(rhs.ToCord());
+    return ByteString(allocator, cord);
+  }
+  const size_t size = lhs_flat->size() + rhs_flat->size();
+  ABSL_DCHECK_LE(size, kByteStringViewMaxSize);
+  ByteString result(allocator);
+  if (size <= kSmallByteStringCapacity) {
+    // Kind and arena were set by the constructor.
+    result.rep_.small.size = size;
+    std::memcpy(result.rep_.small.data, lhs_flat->data(), lhs_flat->size());
+    std::memcpy(result.rep_.small.data + lhs_flat->size(), rhs_flat->data(),
+                rhs_flat->size());
+    return result;
+  }
+  auto* arena = allocator.arena();
+  if (arena != nullptr) {
+    // Write the result directly into arena storage instead of concatenating
+    // into a temporary and copying it again.
+    char* data =
+        static_cast<char*>(arena->AllocateAligned(size, alignof(char)));
+    std::memcpy(data, lhs_flat->data(), lhs_flat->size());
+    std::memcpy(data + lhs_flat->size(), rhs_flat->data(), rhs_flat->size());
+    result.rep_.header.kind = ByteStringKind::kMedium;
+    result.rep_.medium.size = size;
+    result.rep_.medium.data = data;
+    result.rep_.medium.owner =
+        reinterpret_cast<uintptr_t>(arena) | kMetadataOwnerArenaBit;
+    return result;
+  }
+  std::string string;
+  string.reserve(size);
+  string.append(*lhs_flat);
+  string.append(*rhs_flat);
+  result.SetMedium(nullptr, std::move(string));
+  return result;
+}
+
+ByteString ByteString::Substr(Allocator<> allocator, size_t pos,
+                              size_t n) const {
+  const size_t current_size = size();
+  ABSL_DCHECK_LE(pos, current_size);
+  n = std::min(n, current_size - pos);
+  if (const absl::optional<absl::string_view> flat = TryFlat();
+      flat.has_value()) {
+    return ByteString(allocator, flat->substr(pos, n));
+  }
+  // A Cord too large to view contiguously; the subcord shares the original
+  // storage, and the constructor flattens it into the arena if one is used.
+  return ByteString(allocator, GetLarge().Subcord(pos, n));
+}
+
 std::string ByteString::ToString() const {
   switch (GetKind()) {
     case ByteStringKind::kSmall:
@@ -1161,41 +1221,44 @@ absl::string_view ByteStringView::GetFlat(std::string& scratch) const {
 }
 
 bool ByteStringView::Equals(ByteStringView rhs) const noexcept {
-  switch (GetKind()) {
-    case ByteStringViewKind::kString:
-      switch (rhs.GetKind()) {
-        case ByteStringViewKind::kString:
-          return GetString() == rhs.GetString();
-        case ByteStringViewKind::kCord:
-          return GetString() == rhs.GetSubcord();
-      }
-    case ByteStringViewKind::kCord:
-      switch (rhs.GetKind()) {
-        case ByteStringViewKind::kString:
-          return GetSubcord() == rhs.GetString();
-        case ByteStringViewKind::kCord:
-          return GetSubcord() == rhs.GetSubcord();
-      }
+  // Every representation knows its size, so unequal lengths are rejected
+  // without touching the bytes or materializing a subcord.
+  if (size() != rhs.size()) {
+    return false;
+  }
+  // Cords that happen to be contiguous are compared through the single-pass
+  // flat kernel (one memcmp with early exit on the first differing byte)
+  // instead of absl::Cord's chunked iteration.
+  const auto lhs_flat = TryFlat();
+  const auto rhs_flat = rhs.TryFlat();
+  if (lhs_flat && rhs_flat) {
+    return *lhs_flat == *rhs_flat;
+  }
+  if (lhs_flat) {
+    return rhs.GetSubcord() == *lhs_flat;
+  }
+  if (rhs_flat) {
+    return GetSubcord() == *rhs_flat;
   }
+  return GetSubcord() == rhs.GetSubcord();
 }
 
 int ByteStringView::Compare(ByteStringView rhs) const noexcept {
-  switch (GetKind()) {
-    case ByteStringViewKind::kString:
-      switch (rhs.GetKind()) {
-        case ByteStringViewKind::kString:
-          return GetString().compare(rhs.GetString());
-        case ByteStringViewKind::kCord:
-          return -rhs.GetSubcord().Compare(GetString());
-      }
-    case ByteStringViewKind::kCord:
-      switch (rhs.GetKind()) {
-        case ByteStringViewKind::kString:
-          return GetSubcord().Compare(rhs.GetString());
-        case ByteStringViewKind::kCord:
-          return GetSubcord().Compare(rhs.GetSubcord());
-      }
+  // Three-way compare for the sort paths (e.g. map key ordering): both sides
+  // flat is the common case and resolves with one pass over the shorter
+  // operand; a fragmented side falls back to absl::Cord's chunked compare.
+  const auto lhs_flat = TryFlat();
+  const auto rhs_flat = rhs.TryFlat();
+  if (lhs_flat && rhs_flat) {
+    return lhs_flat->compare(*rhs_flat);
+  }
+  if (lhs_flat) {
+    return -rhs.GetSubcord().Compare(*lhs_flat);
+  }
+  if (rhs_flat) {
+    return GetSubcord().Compare(*rhs_flat);
   }
+  return GetSubcord().Compare(rhs.GetSubcord());
 }
 
 bool ByteStringView::StartsWith(ByteStringView rhs) const noexcept {
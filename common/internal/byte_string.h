@@ -281,6 +281,20 @@ class CEL_COMMON_INTERNAL_BYTE_STRING_TRIVIAL_ABI
 
   void RemoveSuffix(size_t n);
 
+  // Returns the concatenation of `lhs` and `rhs`, allocated using
+  // `allocator`. When both operands are flat the result is written once into
+  // contiguous storage (small, or medium for larger results); a Cord is only
+  // built when an operand is a Cord too large to view contiguously, so its
+  // tree storage is shared instead of copied.
+  static ByteString Concat(Allocator<> allocator, const ByteString& lhs,
+                           const ByteString& rhs);
+
+  // Returns the substring of length at most `n` starting at `pos`, allocated
+  // using `allocator`. `pos` must not exceed size(). Flat operands produce
+  // contiguous results; a Cord operand too large to view contiguously
+  // produces a subcord sharing the original storage.
+  ByteString Substr(Allocator<> allocator, size_t pos, size_t n) const;
+
   std::string ToString() const;
 
   absl::Cord ToCord() const&;
@@ -15,6 +15,8 @@
 #include "common/internal/byte_string.h"
 
 #include <algorithm>
+#include <cstddef>
+#include <limits>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -22,6 +24,7 @@
 #include "absl/base/no_destructor.h"
 #include "absl/hash/hash.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/cord_test_helpers.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
@@ -838,6 +841,30 @@ TEST_P(ByteStringTest, Compare) {
   EXPECT_EQ(byte_string.Compare(GetMediumOrLargeCord()), 0);
 }
 
+TEST_P(ByteStringTest, EqualsFragmentedCord) {
+  ByteString byte_string =
+      ByteString::Owned(GetAllocator(), GetMediumOrLargeFragmentedCord());
+  EXPECT_TRUE(byte_string.Equals(GetMediumStringView()));
+  EXPECT_TRUE(byte_string.Equals(GetMediumOrLargeCord()));
+  EXPECT_TRUE(byte_string.Equals(GetMediumOrLargeFragmentedCord()));
+  // Unequal sizes are rejected without comparing bytes.
+  EXPECT_FALSE(byte_string.Equals(GetMediumStringView().substr(1)));
+}
+
+TEST_P(ByteStringTest, CompareFragmentedCord) {
+  ByteString byte_string =
+      ByteString::Owned(GetAllocator(), GetMediumOrLargeFragmentedCord());
+  EXPECT_EQ(byte_string.Compare(GetMediumStringView()), 0);
+  EXPECT_EQ(byte_string.Compare(GetMediumOrLargeCord()), 0);
+  EXPECT_EQ(byte_string.Compare(GetMediumOrLargeFragmentedCord()), 0);
+  // A proper prefix orders before the longer string, regardless of which
+  // side is fragmented.
+  EXPECT_GT(byte_string.Compare(
+                GetMediumStringView().substr(0, kSmallByteStringCapacity)),
+            0);
+  EXPECT_LT(byte_string.Compare(absl::Cord("Z")), 0);
+}
+
 TEST_P(ByteStringTest, StartsWith) {
   ByteString byte_string =
       ByteString::Owned(GetAllocator(), GetMediumOrLargeCord());
@@ -912,6 +939,76 @@ TEST_P(ByteStringTest, RemoveSuffixMediumOrLarge) {
             GetMediumStringView().substr(0, kSmallByteStringCapacity));
 }
 
+TEST_P(ByteStringTest, ConcatSmall) {
+  ByteString lhs = ByteString::Owned(GetAllocator(), "foo");
+  ByteString rhs = ByteString::Owned(GetAllocator(), "bar");
+  ByteString result = ByteString::Concat(GetAllocator(), lhs, rhs);
+  EXPECT_EQ(GetKind(result), ByteStringKind::kSmall);
+  EXPECT_EQ(result, absl::string_view("foobar"));
+}
+
+TEST_P(ByteStringTest, ConcatMedium) {
+  ByteString lhs = ByteString::Owned(GetAllocator(), GetSmallStringView());
+  ByteString rhs = ByteString::Owned(GetAllocator(), GetMediumStringView());
+  ByteString result = ByteString::Concat(GetAllocator(), lhs, rhs);
+  std::string expected = absl::StrCat(GetSmallStringView(),
+                                      GetMediumStringView());
+  EXPECT_EQ(GetKind(result), ByteStringKind::kMedium);
+  EXPECT_EQ(result, absl::string_view(expected));
+  EXPECT_EQ(result.GetArena(), GetAllocator().arena());
+}
+
+TEST_P(ByteStringTest, ConcatNonFlatOperand) {
+  ByteString lhs =
+      ByteString::Owned(GetAllocator(), GetMediumOrLargeFragmentedCord());
+  ByteString rhs = ByteString::Owned(GetAllocator(), GetSmallStringView());
+  ByteString result = ByteString::Concat(GetAllocator(), lhs, rhs);
+  std::string expected = absl::StrCat(GetMediumStringView(),
+                                      GetSmallStringView());
+  EXPECT_EQ(result, absl::string_view(expected));
+  if (GetAllocator().arena() == nullptr) {
+    EXPECT_EQ(GetKind(result), ByteStringKind::kLarge);
+  } else {
+    // The fragmented operand was flattened into the arena on construction, so
+    // concatenation stays on the contiguous fast path.
+    EXPECT_EQ(GetKind(result), ByteStringKind::kMedium);
+  }
+}
+
+TEST_P(ByteStringTest, SubstrSmall) {
+  ByteString byte_string =
+      ByteString::Owned(GetAllocator(), GetMediumStringView());
+  ByteString result = byte_string.Substr(GetAllocator(), 2, 8);
+  EXPECT_EQ(GetKind(result), ByteStringKind::kSmall);
+  EXPECT_EQ(result, GetMediumStringView().substr(2, 8));
+}
+
+TEST_P(ByteStringTest, SubstrMedium) {
+  ByteString byte_string =
+      ByteString::Owned(GetAllocator(), GetMediumStringView());
+  ByteString result =
+      byte_string.Substr(GetAllocator(), 1, byte_string.size() - 1);
+  EXPECT_EQ(GetKind(result), ByteStringKind::kMedium);
+  EXPECT_EQ(result, GetMediumStringView().substr(1));
+}
+
+TEST_P(ByteStringTest, SubstrClampsLength) {
+  ByteString byte_string =
+      ByteString::Owned(GetAllocator(), GetSmallStringView());
+  ByteString result = byte_string.Substr(
+      GetAllocator(), 1, std::numeric_limits<size_t>::max());
+  EXPECT_EQ(result, GetSmallStringView().substr(1));
+}
+
+TEST_P(ByteStringTest, SubstrFragmentedCord) {
+  ByteString byte_string =
+      ByteString::Owned(GetAllocator(), GetMediumOrLargeFragmentedCord());
+  ByteString result = byte_string.Substr(
+      GetAllocator(), kSmallByteStringCapacity - 1, kSmallByteStringCapacity);
+  EXPECT_EQ(result, GetMediumStringView().substr(kSmallByteStringCapacity - 1,
+                                                 kSmallByteStringCapacity));
+}
+
 TEST_P(ByteStringTest, ToStringSmall) {
   ByteString byte_string =
       ByteString::Owned(GetAllocator(), GetSmallStringView());
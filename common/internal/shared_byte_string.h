@@ -30,6 +30,7 @@
 #include "absl/meta/type_traits.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "common/internal/arena_string.h"
 #include "common/internal/reference_count.h"
 
@@ -183,6 +184,18 @@ class SharedByteString final {
     }
   }
 
+  // Retrieves the contents of this byte string as `absl::string_view` when
+  // they are already contiguous: always for the `absl::string_view`
+  // representation, and for an `absl::Cord` with a single flat chunk. Returns
+  // `absl::nullopt` when the cord is fragmented.
+  absl::optional<absl::string_view> TryFlat() const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    if (header_.is_cord) {
+      return cord_ptr()->TryFlat();
+    }
+    return absl::string_view(content_.string.data, header_.size);
+  }
+
   void swap(SharedByteString& other) noexcept {
     using std::swap;
     if (header_.is_cord) {
@@ -14,6 +14,9 @@
 
 #include "common/json.h"
 
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <initializer_list>
 #include <string>
 #include <utility>
@@ -22,8 +25,10 @@
 #include "absl/functional/overload.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/escaping.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/variant.h"
@@ -31,6 +36,7 @@
 #include "internal/copy_on_write.h"
 #include "internal/proto_wire.h"
 #include "internal/status_macros.h"
+#include "internal/utf8.h"
 
 namespace cel {
 
@@ -399,4 +405,336 @@ absl::StatusOr<Any> JsonObjectToAny(const JsonObject& json) {
   return MakeAny(MakeTypeUrl(kJsonObjectTypeName), std::move(data));
 }
 
+namespace {
+
+// Matches protobuf's default recursion limit for parsing.
+inline constexpr int kJsonMaxDepth = 100;
+
+// Recursive descent parser for RFC 8259 JSON text. Arrays and objects are
+// built in place with `JsonArrayBuilder` and `JsonObjectBuilder`, avoiding
+// any intermediate message representation.
+class JsonTextParser final {
+ public:
+  explicit JsonTextParser(absl::string_view json_text)
+      : begin_(json_text.data()),
+        p_(json_text.data()),
+        end_(json_text.data() + json_text.size()) {}
+
+  absl::StatusOr<Json> Parse() {
+    SkipWhitespace();
+    CEL_ASSIGN_OR_RETURN(Json json, ParseValue(0));
+    SkipWhitespace();
+    if (p_ != end_) {
+      return Error("unexpected trailing input");
+    }
+    return json;
+  }
+
+ private:
+  absl::StatusOr<Json> ParseValue(int depth) {
+    if (depth > kJsonMaxDepth) {
+      return Error("nesting exceeds maximum depth");
+    }
+    if (p_ == end_) {
+      return Error("unexpected end of input");
+    }
+    switch (*p_) {
+      case '{':
+        return ParseObject(depth);
+      case '[':
+        return ParseArray(depth);
+      case '"': {
+        CEL_ASSIGN_OR_RETURN(std::string string, ParseString());
+        return Json(JsonString(std::move(string)));
+      }
+      case 't':
+        CEL_RETURN_IF_ERROR(Consume("true"));
+        return Json(true);
+      case 'f':
+        CEL_RETURN_IF_ERROR(Consume("false"));
+        return Json(false);
+      case 'n':
+        CEL_RETURN_IF_ERROR(Consume("null"));
+        return Json(kJsonNull);
+      default:
+        if (*p_ == '-' || absl::ascii_isdigit(*p_)) {
+          return ParseNumber();
+        }
+        return Error("unexpected character");
+    }
+  }
+
+  absl::StatusOr<Json> ParseArray(int depth) {
+    ++p_;  // '['
+    JsonArrayBuilder builder;
+    SkipWhitespace();
+    if (p_ != end_ && *p_ == ']') {
+      ++p_;
+      return Json(std::move(builder).Build());
+    }
+    while (true) {
+      SkipWhitespace();
+      CEL_ASSIGN_OR_RETURN(Json element, ParseValue(depth + 1));
+      builder.push_back(std::move(element));
+      SkipWhitespace();
+      if (p_ == end_) {
+        return Error("unexpected end of input in array");
+      }
+      if (*p_ == ',') {
+        ++p_;
+        continue;
+      }
+      if (*p_ == ']') {
+        ++p_;
+        return Json(std::move(builder).Build());
+      }
+      return Error("expected ',' or ']' in array");
+    }
+  }
+
+  absl::StatusOr<Json> ParseObject(int depth) {
+    ++p_;  // '{'
+    JsonObjectBuilder builder;
+    SkipWhitespace();
+    if (p_ != end_ && *p_ == '}') {
+      ++p_;
+      return Json(std::move(builder).Build());
+    }
+    while (true) {
+      SkipWhitespace();
+      if (p_ == end_ || *p_ != '"') {
+        return Error("expected string key in object");
+      }
+      CEL_ASSIGN_OR_RETURN(std::string key, ParseString());
+      SkipWhitespace();
+      if (p_ == end_ || *p_ != ':') {
+        return Error("expected ':' in object");
+      }
+      ++p_;
+      SkipWhitespace();
+      CEL_ASSIGN_OR_RETURN(Json value, ParseValue(depth + 1));
+      // Duplicate keys keep the last value, consistent with
+      // `google.protobuf.Struct`.
+      builder.insert_or_assign(JsonString(std::move(key)), std::move(value));
+      SkipWhitespace();
+      if (p_ == end_) {
+        return Error("unexpected end of input in object");
+      }
+      if (*p_ == ',') {
+        ++p_;
+        continue;
+      }
+      if (*p_ == '}') {
+        ++p_;
+        return Json(std::move(builder).Build());
+      }
+      return Error("expected ',' or '}' in object");
+    }
+  }
+
+  absl::StatusOr<std::string> ParseString() {
+    ++p_;  // '"'
+    // Fast path: scan for the closing quote. If no escapes or control
+    // characters intervene, the raw span is the string.
+    const char* start = p_;
+    while (p_ != end_ && *p_ != '"' && *p_ != '\\' &&
+           static_cast<unsigned char>(*p_) >= 0x20) {
+      ++p_;
+    }
+    if (p_ == end_) {
+      return Error("unterminated string");
+    }
+    if (*p_ == '"') {
+      absl::string_view raw(start, p_ - start);
+      if (!internal::Utf8IsValid(raw)) {
+        return Error("invalid UTF-8 in string");
+      }
+      ++p_;
+      return std::string(raw);
+    }
+    std::string result(start, p_ - start);
+    while (true) {
+      if (p_ == end_) {
+        return Error("unterminated string");
+      }
+      char c = *p_;
+      if (c == '"') {
+        ++p_;
+        if (!internal::Utf8IsValid(result)) {
+          return Error("invalid UTF-8 in string");
+        }
+        return result;
+      }
+      if (static_cast<unsigned char>(c) < 0x20) {
+        return Error("unescaped control character in string");
+      }
+      if (c != '\\') {
+        result.push_back(c);
+        ++p_;
+        continue;
+      }
+      ++p_;
+      if (p_ == end_) {
+        return Error("unterminated escape sequence");
+      }
+      switch (*p_) {
+        case '"':
+          result.push_back('"');
+          ++p_;
+          break;
+        case '\\':
+          result.push_back('\\');
+          ++p_;
+          break;
+        case '/':
+          result.push_back('/');
+          ++p_;
+          break;
+        case 'b':
+          result.push_back('\b');
+          ++p_;
+          break;
+        case 'f':
+          result.push_back('\f');
+          ++p_;
+          break;
+        case 'n':
+          result.push_back('\n');
+          ++p_;
+          break;
+        case 'r':
+          result.push_back('\r');
+          ++p_;
+          break;
+        case 't':
+          result.push_back('\t');
+          ++p_;
+          break;
+        case 'u': {
+          ++p_;
+          CEL_ASSIGN_OR_RETURN(uint32_t code_unit, ParseHex4());
+          char32_t code_point = static_cast<char32_t>(code_unit);
+          if (code_unit >= 0xd800 && code_unit <= 0xdbff) {
+            // High surrogate: require a low surrogate escape to follow.
+            if (end_ - p_ < 2 || p_[0] != '\\' || p_[1] != 'u') {
+              return Error("unpaired surrogate in string escape");
+            }
+            p_ += 2;
+            CEL_ASSIGN_OR_RETURN(uint32_t low, ParseHex4());
+            if (low < 0xdc00 || low > 0xdfff) {
+              return Error("unpaired surrogate in string escape");
+            }
+            code_point = static_cast<char32_t>(
+                0x10000 + ((code_unit - 0xd800) << 10) + (low - 0xdc00));
+          } else if (code_unit >= 0xdc00 && code_unit <= 0xdfff) {
+            return Error("unpaired surrogate in string escape");
+          }
+          internal::Utf8Encode(result, code_point);
+          break;
+        }
+        default:
+          return Error("invalid escape sequence");
+      }
+    }
+  }
+
+  absl::StatusOr<uint32_t> ParseHex4() {
+    if (end_ - p_ < 4) {
+      return Error("truncated \\u escape");
+    }
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+      char c = p_[i];
+      uint32_t digit;
+      if (c >= '0' && c <= '9') {
+        digit = c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        digit = c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        digit = c - 'A' + 10;
+      } else {
+        return Error("invalid \\u escape");
+      }
+      value = (value << 4) | digit;
+    }
+    p_ += 4;
+    return value;
+  }
+
+  absl::StatusOr<Json> ParseNumber() {
+    const char* start = p_;
+    if (p_ != end_ && *p_ == '-') {
+      ++p_;
+    }
+    if (p_ == end_ || !absl::ascii_isdigit(*p_)) {
+      return Error("invalid number");
+    }
+    if (*p_ == '0') {
+      ++p_;
+    } else {
+      while (p_ != end_ && absl::ascii_isdigit(*p_)) {
+        ++p_;
+      }
+    }
+    if (p_ != end_ && *p_ == '.') {
+      ++p_;
+      if (p_ == end_ || !absl::ascii_isdigit(*p_)) {
+        return Error("invalid number");
+      }
+      while (p_ != end_ && absl::ascii_isdigit(*p_)) {
+        ++p_;
+      }
+    }
+    if (p_ != end_ && (*p_ == 'e' || *p_ == 'E')) {
+      ++p_;
+      if (p_ != end_ && (*p_ == '+' || *p_ == '-')) {
+        ++p_;
+      }
+      if (p_ == end_ || !absl::ascii_isdigit(*p_)) {
+        return Error("invalid number");
+      }
+      while (p_ != end_ && absl::ascii_isdigit(*p_)) {
+        ++p_;
+      }
+    }
+    double value;
+    if (!absl::SimpleAtod(absl::string_view(start, p_ - start), &value) ||
+        !std::isfinite(value)) {
+      return Error("number out of range");
+    }
+    return Json(value);
+  }
+
+  absl::Status Consume(absl::string_view literal) {
+    if (static_cast<size_t>(end_ - p_) < literal.size() ||
+        absl::string_view(p_, literal.size()) != literal) {
+      return Error("unexpected character");
+    }
+    p_ += literal.size();
+    return absl::OkStatus();
+  }
+
+  void SkipWhitespace() {
+    while (p_ != end_ &&
+           (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) {
+      ++p_;
+    }
+  }
+
+  absl::Status Error(absl::string_view message) const {
+    return absl::InvalidArgumentError(
+        absl::StrCat("invalid JSON at offset ", p_ - begin_, ": ", message));
+  }
+
+  const char* const begin_;
+  const char* p_;
+  const char* const end_;
+};
+
+}  // namespace
+
+absl::StatusOr<Json> ParseJson(absl::string_view json_text) {
+  return JsonTextParser(json_text).Parse();
+}
+
 }  // namespace cel
@@ -465,6 +465,12 @@ Json JsonUint(uint64_t value);
 Json JsonBytes(absl::string_view value);
 Json JsonBytes(const absl::Cord& value);
 
+// `cel::ParseJson` parses UTF-8 encoded JSON text (RFC 8259) directly into
+// `cel::Json`, building arrays and objects in place rather than converting
+// from an intermediate message representation. Nesting is limited to 100
+// levels. Duplicate object keys keep the last value.
+absl::StatusOr<Json> ParseJson(absl::string_view json_text);
+
 // Serializes `json` as `google.protobuf.Any` with type `google.protobuf.Value`.
 absl::StatusOr<Any> JsonToAny(const Json& json);
 absl::Status JsonToAnyValue(const Json& json, absl::Cord& data);
@@ -0,0 +1,377 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/json_serializer.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <utility>
+
+#include "absl/functional/overload.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/variant.h"
+#include "common/casting.h"
+#include "common/json.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "common/value_manager.h"
+#include "internal/status_macros.h"
+#include "internal/time.h"
+
+namespace cel {
+
+namespace {
+
+// Appends `value` as a quoted JSON string. Bytes are copied in escape-free
+// runs found by a single scan, so the common case (no escapes) is one
+// append of the whole string.
+void AppendEscapedString(absl::string_view value, std::string& out) {
+  out.push_back('"');
+  size_t clean_begin = 0;
+  for (size_t i = 0; i < value.size(); ++i) {
+    const unsigned char c = static_cast<unsigned char>(value[i]);
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+    out.append(value.data() + clean_begin, i - clean_begin);
+    switch (c) {
+      case '"':
+        out.append("\\\"");
+        break;
+      case '\\':
+        out.append("\\\\");
+        break;
+      case '\b':
+        out.append("\\b");
+        break;
+      case '\f':
+        out.append("\\f");
+        break;
+      case '\n':
+        out.append("\\n");
+        break;
+      case '\r':
+        out.append("\\r");
+        break;
+      case '\t':
+        out.append("\\t");
+        break;
+      default:
+        absl::StrAppendFormat(&out, "\\u%04x", c);
+        break;
+    }
+    clean_begin = i + 1;
+  }
+  out.append(value.data() + clean_begin, value.size() - clean_begin);
+  out.push_back('"');
+}
+
+void AppendInt(int64_t value, std::string& out) {
+  if (value < kJsonMinInt || value > kJsonMaxInt) {
+    // Matches JsonInt: integers outside the double-safe range serialize as
+    // decimal strings per the proto3 JSON mapping.
+    absl::StrAppend(&out, "\"", value, "\"");
+    return;
+  }
+  absl::StrAppend(&out, value);
+}
+
+void AppendUint(uint64_t value, std::string& out) {
+  if (value > kJsonMaxUint) {
+    absl::StrAppend(&out, "\"", value, "\"");
+    return;
+  }
+  absl::StrAppend(&out, value);
+}
+
+void AppendDouble(double value, std::string& out) {
+  if (std::isnan(value)) {
+    out.append("\"NaN\"");
+    return;
+  }
+  if (std::isinf(value)) {
+    out.append(std::signbit(value) ? "\"-Infinity\"" : "\"Infinity\"");
+    return;
+  }
+  if (std::floor(value) == value && value >= kJsonMinInt &&
+      value <= kJsonMaxInt) {
+    absl::StrAppend(&out, static_cast<int64_t>(value));
+    return;
+  }
+  // Shortest representation that round-trips.
+  char buffer[32];
+  int length = 0;
+  for (int precision : {15, 16, 17}) {
+    length = absl::SNPrintF(buffer, sizeof(buffer), "%.*g", precision, value);
+    if (std::strtod(buffer, nullptr) == value) {
+      break;
+    }
+  }
+  out.append(buffer, static_cast<size_t>(length));
+}
+
+// Serializer for the fallback path: struct values and opaque types convert
+// through the `Json` variant first.
+void AppendJson(const Json& json, std::string& out) {
+  absl::visit(
+      absl::Overload([&out](JsonNull) -> void { out.append("null"); },
+                     [&out](JsonBool value) -> void {
+                       out.append(value ? "true" : "false");
+                     },
+                     [&out](JsonNumber value) -> void {
+                       AppendDouble(value, out);
+                     },
+                     [&out](const JsonString& value) -> void {
+                       if (auto flat = value.TryFlat(); flat.has_value()) {
+                         AppendEscapedString(*flat, out);
+                       } else {
+                         AppendEscapedString(static_cast<std::string>(value),
+                                             out);
+                       }
+                     },
+                     [&out](const JsonArray& value) -> void {
+                       out.push_back('[');
+                       bool first = true;
+                       for (const auto& element : value) {
+                         if (!first) out.push_back(',');
+                         first = false;
+                         AppendJson(element, out);
+                       }
+                       out.push_back(']');
+                     },
+                     [&out](const JsonObject& value) -> void {
+                       out.push_back('{');
+                       bool first = true;
+                       for (const auto& entry : value) {
+                         if (!first) out.push_back(',');
+                         first = false;
+                         if (auto flat = entry.first.TryFlat();
+                             flat.has_value()) {
+                           AppendEscapedString(*flat, out);
+                         } else {
+                           AppendEscapedString(
+                               static_cast<std::string>(entry.first), out);
+                         }
+                         out.push_back(':');
+                         AppendJson(entry.second, out);
+                       }
+                       out.push_back('}');
+                     }),
+      json);
+}
+
+// JSON object keys are always strings; bool, int and uint map keys are
+// stringified per the proto3 JSON mapping.
+absl::Status AppendMapKey(const Value& key, std::string& out) {
+  switch (key.kind()) {
+    case ValueKind::kBool:
+      out.append(Cast<BoolValue>(key).NativeValue() ? "\"true\"" : "\"false\"");
+      return absl::OkStatus();
+    case ValueKind::kInt:
+      absl::StrAppend(&out, "\"", Cast<IntValue>(key).NativeValue(), "\"");
+      return absl::OkStatus();
+    case ValueKind::kUint:
+      absl::StrAppend(&out, "\"", Cast<UintValue>(key).NativeValue(), "\"");
+      return absl::OkStatus();
+    case ValueKind::kString: {
+      std::string scratch;
+      AppendEscapedString(Cast<StringValue>(key).NativeString(scratch), out);
+      return absl::OkStatus();
+    }
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrCat("cannot serialize map with key of type ",
+                       ValueKindToString(key.kind()), " to JSON"));
+  }
+}
+
+// Conservative size estimate for the reserve pass. Scalar estimates cover
+// the common emitted widths; strings assume no escapes (escapes grow the
+// buffer through the ordinary append path).
+absl::Status EstimateSize(ValueManager& value_manager, const Value& value,
+                          size_t& estimate) {
+  switch (value.kind()) {
+    case ValueKind::kNull:
+      estimate += 4;
+      return absl::OkStatus();
+    case ValueKind::kBool:
+      estimate += 5;
+      return absl::OkStatus();
+    case ValueKind::kInt:
+    case ValueKind::kUint:
+    case ValueKind::kDouble:
+      estimate += 24;
+      return absl::OkStatus();
+    case ValueKind::kString: {
+      std::string scratch;
+      estimate += Cast<StringValue>(value).NativeString(scratch).size() + 2;
+      return absl::OkStatus();
+    }
+    case ValueKind::kBytes: {
+      const size_t size = Cast<BytesValue>(value).Size();
+      estimate += 4 * ((size + 2) / 3) + 2;
+      return absl::OkStatus();
+    }
+    case ValueKind::kDuration:
+    case ValueKind::kTimestamp:
+      estimate += 32;
+      return absl::OkStatus();
+    case ValueKind::kList: {
+      estimate += 2;
+      size_t* estimate_ptr = &estimate;
+      return Cast<ListValue>(value).ForEach(
+          value_manager,
+          [&value_manager, estimate_ptr](
+              const Value& element) -> absl::StatusOr<bool> {
+            *estimate_ptr += 1;
+            CEL_RETURN_IF_ERROR(
+                EstimateSize(value_manager, element, *estimate_ptr));
+            return true;
+          });
+    }
+    case ValueKind::kMap: {
+      estimate += 2;
+      size_t* estimate_ptr = &estimate;
+      return Cast<MapValue>(value).ForEach(
+          value_manager,
+          [&value_manager, estimate_ptr](
+              const Value& key, const Value& entry) -> absl::StatusOr<bool> {
+            *estimate_ptr += 4;
+            CEL_RETURN_IF_ERROR(
+                EstimateSize(value_manager, key, *estimate_ptr));
+            CEL_RETURN_IF_ERROR(
+                EstimateSize(value_manager, entry, *estimate_ptr));
+            return true;
+          });
+    }
+    default:
+      // Fallback-path values are not traversed twice.
+      estimate += 16;
+      return absl::OkStatus();
+  }
+}
+
+absl::Status SerializeTo(ValueManager& value_manager, const Value& value,
+                         std::string& out) {
+  switch (value.kind()) {
+    case ValueKind::kNull:
+      out.append("null");
+      return absl::OkStatus();
+    case ValueKind::kBool:
+      out.append(Cast<BoolValue>(value).NativeValue() ? "true" : "false");
+      return absl::OkStatus();
+    case ValueKind::kInt:
+      AppendInt(Cast<IntValue>(value).NativeValue(), out);
+      return absl::OkStatus();
+    case ValueKind::kUint:
+      AppendUint(Cast<UintValue>(value).NativeValue(), out);
+      return absl::OkStatus();
+    case ValueKind::kDouble:
+      AppendDouble(Cast<DoubleValue>(value).NativeValue(), out);
+      return absl::OkStatus();
+    case ValueKind::kString: {
+      std::string scratch;
+      AppendEscapedString(Cast<StringValue>(value).NativeString(scratch), out);
+      return absl::OkStatus();
+    }
+    case ValueKind::kBytes: {
+      std::string scratch;
+      out.push_back('"');
+      out.append(absl::Base64Escape(
+          Cast<BytesValue>(value).NativeString(scratch)));
+      out.push_back('"');
+      return absl::OkStatus();
+    }
+    case ValueKind::kDuration: {
+      CEL_ASSIGN_OR_RETURN(
+          auto encoded, internal::EncodeDurationToJson(
+                            Cast<DurationValue>(value).NativeValue()));
+      AppendEscapedString(encoded, out);
+      return absl::OkStatus();
+    }
+    case ValueKind::kTimestamp: {
+      CEL_ASSIGN_OR_RETURN(
+          auto encoded, internal::EncodeTimestampToJson(
+                            Cast<TimestampValue>(value).NativeValue()));
+      AppendEscapedString(encoded, out);
+      return absl::OkStatus();
+    }
+    case ValueKind::kList: {
+      out.push_back('[');
+      bool first = true;
+      CEL_RETURN_IF_ERROR(Cast<ListValue>(value).ForEach(
+          value_manager,
+          [&value_manager, &out,
+           &first](const Value& element) -> absl::StatusOr<bool> {
+            if (!first) out.push_back(',');
+            first = false;
+            CEL_RETURN_IF_ERROR(SerializeTo(value_manager, element, out));
+            return true;
+          }));
+      out.push_back(']');
+      return absl::OkStatus();
+    }
+    case ValueKind::kMap: {
+      out.push_back('{');
+      bool first = true;
+      CEL_RETURN_IF_ERROR(Cast<MapValue>(value).ForEach(
+          value_manager,
+          [&value_manager, &out, &first](
+              const Value& key, const Value& entry) -> absl::StatusOr<bool> {
+            if (!first) out.push_back(',');
+            first = false;
+            CEL_RETURN_IF_ERROR(AppendMapKey(key, out));
+            out.push_back(':');
+            CEL_RETURN_IF_ERROR(SerializeTo(value_manager, entry, out));
+            return true;
+          }));
+      out.push_back('}');
+      return absl::OkStatus();
+    }
+    default: {
+      // Structs (and any other convertible kind) go through the variant;
+      // non-convertible kinds (errors, unknowns) fail here.
+      CEL_ASSIGN_OR_RETURN(Json json, value.ConvertToJson(value_manager));
+      AppendJson(json, out);
+      return absl::OkStatus();
+    }
+  }
+}
+
+}  // namespace
+
+absl::Status SerializeValueAsJson(ValueManager& value_manager,
+                                  const Value& value, std::string& output) {
+  size_t estimate = 0;
+  CEL_RETURN_IF_ERROR(EstimateSize(value_manager, value, estimate));
+  output.reserve(output.size() + estimate);
+  return SerializeTo(value_manager, value, output);
+}
+
+absl::StatusOr<std::string> SerializeValueAsJson(ValueManager& value_manager,
+                                                 const Value& value) {
+  std::string output;
+  CEL_RETURN_IF_ERROR(SerializeValueAsJson(value_manager, value, output));
+  return output;
+}
+
+}  // namespace cel
@@ -0,0 +1,51 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_COMMON_JSON_SERIALIZER_H_
+#define THIRD_PARTY_CEL_CPP_COMMON_JSON_SERIALIZER_H_
+
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+
+namespace cel {
+
+// Serializes `value` directly to JSON text, following the proto3 JSON
+// mapping (integers outside the double-safe range and non-finite doubles
+// become strings, bytes become base64, durations and timestamps become
+// their canonical string forms).
+//
+// Unlike `Value::ConvertToJson`, which materializes the intermediate `Json`
+// variant (allocating copy-on-write arrays and maps per node), this
+// recurses over the value interfaces and appends straight into `output`
+// after a size-estimation pass reserves the buffer once. Struct values and
+// opaque types without a direct emission path still fall back to
+// `ConvertToJson` and are serialized from the variant.
+//
+// Map keys must be bool, int, uint or string (as for `ConvertToJson`);
+// other key kinds produce an InvalidArgumentError. Errors and unknowns are
+// not serializable.
+absl::Status SerializeValueAsJson(ValueManager& value_manager,
+                                  const Value& value, std::string& output);
+
+// As above, returning the serialized text.
+absl::StatusOr<std::string> SerializeValueAsJson(ValueManager& value_manager,
+                                                 const Value& value);
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_COMMON_JSON_SERIALIZER_H_
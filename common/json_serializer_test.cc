@@ -0,0 +1,154 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/json_serializer.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "base/type_provider.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "common/values/legacy_value_manager.h"
+#include "internal/testing.h"
+
+namespace cel {
+namespace {
+
+using cel::internal::IsOkAndHolds;
+using cel::internal::StatusIs;
+
+class JsonSerializerTest : public testing::Test {
+ public:
+  JsonSerializerTest()
+      : value_manager_(MemoryManagerRef::ReferenceCounting(),
+                       TypeProvider::Builtin()) {}
+
+ protected:
+  common_internal::LegacyValueManager value_manager_;
+};
+
+TEST_F(JsonSerializerTest, Scalars) {
+  EXPECT_THAT(SerializeValueAsJson(value_manager_, NullValue()),
+              IsOkAndHolds("null"));
+  EXPECT_THAT(SerializeValueAsJson(value_manager_, BoolValue(true)),
+              IsOkAndHolds("true"));
+  EXPECT_THAT(SerializeValueAsJson(value_manager_, IntValue(42)),
+              IsOkAndHolds("42"));
+  EXPECT_THAT(SerializeValueAsJson(value_manager_, UintValue(7)),
+              IsOkAndHolds("7"));
+  EXPECT_THAT(SerializeValueAsJson(value_manager_, DoubleValue(1.5)),
+              IsOkAndHolds("1.5"));
+  EXPECT_THAT(SerializeValueAsJson(value_manager_, DoubleValue(3.0)),
+              IsOkAndHolds("3"));
+}
+
+TEST_F(JsonSerializerTest, IntegersOutsideDoubleSafeRangeAreStrings) {
+  EXPECT_THAT(
+      SerializeValueAsJson(value_manager_, IntValue(int64_t{1} << 60)),
+      IsOkAndHolds("\"1152921504606846976\""));
+  EXPECT_THAT(
+      SerializeValueAsJson(value_manager_, UintValue(uint64_t{1} << 60)),
+      IsOkAndHolds("\"1152921504606846976\""));
+}
+
+TEST_F(JsonSerializerTest, NonFiniteDoublesAreStrings) {
+  EXPECT_THAT(SerializeValueAsJson(value_manager_,
+                                   DoubleValue(std::nan(""))),
+              IsOkAndHolds("\"NaN\""));
+  EXPECT_THAT(
+      SerializeValueAsJson(
+          value_manager_,
+          DoubleValue(-std::numeric_limits<double>::infinity())),
+      IsOkAndHolds("\"-Infinity\""));
+}
+
+TEST_F(JsonSerializerTest, DoubleRoundTrips) {
+  ASSERT_OK_AND_ASSIGN(std::string serialized,
+                       SerializeValueAsJson(value_manager_, DoubleValue(0.1)));
+  EXPECT_EQ(std::strtod(serialized.c_str(), nullptr), 0.1);
+}
+
+TEST_F(JsonSerializerTest, StringsAreEscaped) {
+  ASSERT_OK_AND_ASSIGN(
+      StringValue value,
+      value_manager_.CreateStringValue("a\"b\\c\nd\x01e"));
+  EXPECT_THAT(SerializeValueAsJson(value_manager_, value),
+              IsOkAndHolds("\"a\\\"b\\\\c\\nd\\u0001e\""));
+}
+
+TEST_F(JsonSerializerTest, BytesAreBase64) {
+  ASSERT_OK_AND_ASSIGN(BytesValue value,
+                       value_manager_.CreateBytesValue("foo"));
+  EXPECT_THAT(SerializeValueAsJson(value_manager_, value),
+              IsOkAndHolds("\"Zm9v\""));
+}
+
+TEST_F(JsonSerializerTest, DurationAndTimestamp) {
+  EXPECT_THAT(SerializeValueAsJson(value_manager_,
+                                   DurationValue(absl::Seconds(90))),
+              IsOkAndHolds("\"90s\""));
+  EXPECT_THAT(SerializeValueAsJson(value_manager_,
+                                   TimestampValue(absl::UnixEpoch())),
+              IsOkAndHolds("\"1970-01-01T00:00:00Z\""));
+}
+
+TEST_F(JsonSerializerTest, ListsAndMapsRecurse) {
+  ASSERT_OK_AND_ASSIGN(
+      auto list_builder,
+      value_manager_.NewListValueBuilder(value_manager_.GetDynListType()));
+  ASSERT_OK(list_builder->Add(IntValue(1)));
+  ASSERT_OK(list_builder->Add(value_manager_.CreateUncheckedStringValue("x")));
+  auto list = std::move(*list_builder).Build();
+
+  ASSERT_OK_AND_ASSIGN(
+      auto map_builder,
+      value_manager_.NewMapValueBuilder(value_manager_.GetDynDynMapType()));
+  // One entry: map iteration order is not specified.
+  ASSERT_OK(map_builder->Put(value_manager_.CreateUncheckedStringValue("l"),
+                             std::move(list)));
+  auto map = std::move(*map_builder).Build();
+
+  ASSERT_OK_AND_ASSIGN(std::string serialized,
+                       SerializeValueAsJson(value_manager_, map));
+  EXPECT_EQ(serialized, "{\"l\":[1,\"x\"]}");
+}
+
+TEST_F(JsonSerializerTest, NonStringMapKeysAreStringified) {
+  ASSERT_OK_AND_ASSIGN(
+      auto map_builder,
+      value_manager_.NewMapValueBuilder(value_manager_.GetDynDynMapType()));
+  ASSERT_OK(map_builder->Put(IntValue(3), IntValue(9)));
+  auto map = std::move(*map_builder).Build();
+
+  EXPECT_THAT(SerializeValueAsJson(value_manager_, map),
+              IsOkAndHolds("{\"3\":9}"));
+}
+
+TEST_F(JsonSerializerTest, ErrorValueIsNotSerializable) {
+  EXPECT_THAT(
+      SerializeValueAsJson(value_manager_,
+                           ErrorValue(absl::InternalError("boom")))
+          .status(),
+      StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+}  // namespace
+}  // namespace cel
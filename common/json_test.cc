@@ -15,6 +15,7 @@
 #include "common/json.h"
 
 #include "absl/hash/hash_testing.h"
+#include "absl/status/status.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
@@ -156,5 +157,52 @@ TEST(JsonBytes, Basic) {
               VariantWith<JsonString>(Eq(absl::Base64Escape("foo"))));
 }
 
+TEST(ParseJson, Scalars) {
+  EXPECT_THAT(ParseJson("null"),
+              IsOkAndHolds(VariantWith<JsonNull>(Eq(kJsonNull))));
+  EXPECT_THAT(ParseJson("true"), IsOkAndHolds(VariantWith<JsonBool>(IsTrue())));
+  EXPECT_THAT(ParseJson("false"),
+              IsOkAndHolds(VariantWith<JsonBool>(IsFalse())));
+  EXPECT_THAT(ParseJson("-1.5e2"),
+              IsOkAndHolds(VariantWith<JsonNumber>(-150.0)));
+  EXPECT_THAT(ParseJson(R"json("foo")json"),
+              IsOkAndHolds(VariantWith<JsonString>(Eq("foo"))));
+}
+
+TEST(ParseJson, Nested) {
+  EXPECT_THAT(
+      ParseJson(R"json({"foo": [1, true, null], "bar": {}})json"),
+      IsOkAndHolds(Eq(Json(MakeJsonObject(
+          {{JsonString("foo"),
+            MakeJsonArray({Json(1.0), Json(true), Json(kJsonNull)})},
+           {JsonString("bar"), MakeJsonObject({})}})))));
+}
+
+TEST(ParseJson, StringEscapes) {
+  EXPECT_THAT(ParseJson(R"json("a\n\t\"\\é😀")json"),
+              IsOkAndHolds(VariantWith<JsonString>(
+                  Eq("a\n\t\"\\\xc3\xa9\xf0\x9f\x98\x80"))));
+  EXPECT_THAT(ParseJson(R"json("\ud83d")json"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ParseJson, DuplicateKeysKeepLast) {
+  EXPECT_THAT(ParseJson(R"json({"foo": 1, "foo": 2})json"),
+              IsOkAndHolds(Eq(Json(
+                  MakeJsonObject({{JsonString("foo"), Json(2.0)}})))));
+}
+
+TEST(ParseJson, Malformed) {
+  EXPECT_THAT(ParseJson(""), StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseJson("{"), StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseJson("[1,]"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseJson("01"), StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseJson("true false"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseJson("\"\x80\""),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 }  // namespace
 }  // namespace cel::internal
@@ -14,7 +14,6 @@
 
 #include "common/legacy_value.h"
 
-#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -26,14 +25,15 @@
 #include "absl/base/attributes.h"
 #include "absl/base/nullability.h"
 #include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/functional/overload.h"
 #include "absl/log/absl_check.h"
-#include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "absl/types/variant.h"
@@ -285,140 +285,151 @@ absl::StatusOr<JsonObject> MessageWrapperToJsonObject(
   return std::move(builder).Build();
 }
 
-class CelListImpl final : public CelList {
+// Adapts a modern `ListValue` to the legacy `CelList` interface without
+// materializing it: elements are converted on access, so handing a modern
+// list to a legacy consumer costs one wrapper allocation instead of a deep
+// copy per boundary crossing. Conversion failures surface as error values at
+// access time, per the legacy container convention.
+class ModernListAsCelList final : public CelList {
  public:
-  CelListImpl() : CelListImpl(nullptr, 0) {}
+  ModernListAsCelList(ListValue value, size_t size,
+                      absl::Nonnull<google::protobuf::Arena*> arena)
+      : value_(std::move(value)), size_(size), arena_(arena) {}
 
-  CelListImpl(const CelValue* elements, size_t elements_size)
-      : elements_(elements), elements_size_(elements_size) {}
+  CelValue operator[](int index) const override { return Get(arena_, index); }
 
-  CelValue operator[](int index) const override {
-    ABSL_DCHECK_LT(index, size());
-    return elements_[index];
+  CelValue Get(google::protobuf::Arena* arena, int index) const override {
+    if (arena == nullptr) {
+      arena = arena_;
+    }
+    common_internal::LegacyTypeReflector value_provider;
+    common_internal::LegacyValueManager value_manager(
+        extensions::ProtoMemoryManagerRef(arena), value_provider);
+    Value element;
+    if (absl::Status status =
+            value_.Get(value_manager, static_cast<size_t>(index), element);
+        !status.ok()) {
+      return CelValue::CreateError(
+          google::protobuf::Arena::Create<absl::Status>(arena, std::move(status)));
+    }
+    absl::StatusOr<CelValue> legacy = LegacyValue(arena, element);
+    if (!legacy.ok()) {
+      return CelValue::CreateError(google::protobuf::Arena::Create<absl::Status>(
+          arena, std::move(legacy).status()));
+    }
+    return *std::move(legacy);
   }
 
-  int size() const override { return static_cast<int>(elements_size_); }
-
-  bool empty() const override { return elements_size_ == 0; }
+  int size() const override { return static_cast<int>(size_); }
 
  private:
-  const CelValue* const elements_;
-  const size_t elements_size_;
+  ListValue value_;
+  const size_t size_;
+  absl::Nonnull<google::protobuf::Arena*> const arena_;
 };
 
-class CelMapImpl final : public CelMap, public CelList {
+// As above, for `MapValue`: lookups convert the legacy key to a (view-backed)
+// modern key and convert back only the accessed entry, and presence tests
+// never construct the value. The key list is materialized at most once, on
+// first use.
+class ModernMapAsCelMap final : public CelMap {
  public:
-  using Entry = std::pair<CelValue, CelValue>;
-
-  // We sort in the following partitions in order: [bool, int, uint, string].
-  // Among the partitions the values are sorted as if by `<`.
-  static bool LessKey(const CelValue& lhs, const CelValue& rhs) {
-    if (lhs.IsBool()) {
-      if (rhs.IsBool()) {
-        return lhs.BoolOrDie() < rhs.BoolOrDie();
-      }
-      return true;
-    }
-    if (lhs.IsInt64()) {
-      if (rhs.IsInt64()) {
-        return lhs.Int64OrDie() < rhs.Int64OrDie();
-      }
-      return !rhs.IsBool();
-    }
-    if (lhs.IsUint64()) {
-      if (rhs.IsUint64()) {
-        return lhs.Uint64OrDie() < rhs.Uint64OrDie();
-      }
-      return !(rhs.IsBool() || rhs.IsInt64());
-    }
-    if (lhs.IsString()) {
-      if (rhs.IsString()) {
-        return lhs.StringOrDie().value() < rhs.StringOrDie().value();
-      }
-      return !(rhs.IsBool() || rhs.IsInt64() || rhs.IsUint64());
-    }
-    ABSL_DLOG(FATAL) << "invalid map key";
-    return false;
-  }
+  ModernMapAsCelMap(MapValue value, size_t size,
+                    absl::Nonnull<google::protobuf::Arena*> arena)
+      : value_(std::move(value)), size_(size), arena_(arena) {}
 
-  static bool EqualKey(const CelValue& lhs, const CelValue& rhs) {
-    if (lhs.IsBool() && rhs.IsBool()) {
-      return lhs.BoolOrDie() == rhs.BoolOrDie();
-    }
-    if (lhs.IsInt64() && rhs.IsInt64()) {
-      return lhs.Int64OrDie() == rhs.Int64OrDie();
-    }
-    if (lhs.IsUint64() && rhs.IsUint64()) {
-      return lhs.Uint64OrDie() == rhs.Uint64OrDie();
-    }
-    if (lhs.IsString() && rhs.IsString()) {
-      return lhs.StringOrDie().value() == rhs.StringOrDie().value();
-    }
-    return false;
+  absl::optional<CelValue> operator[](CelValue key) const override {
+    return Get(arena_, key);
   }
 
-  struct KeyCompare {
-    using is_transparent = void;
-
-    bool operator()(const CelValue& lhs, const CelValue& rhs) const {
-      return LessKey(lhs, rhs);
+  absl::optional<CelValue> Get(google::protobuf::Arena* arena,
+                               CelValue key) const override {
+    if (arena == nullptr) {
+      arena = arena_;
     }
-
-    bool operator()(const Entry& lhs, const Entry& rhs) const {
-      return (*this)(lhs.first, rhs.first);
+    if (key.IsError() || key.IsUnknownSet()) {
+      return key;
     }
-
-    bool operator()(const CelValue& lhs, const Entry& rhs) const {
-      return (*this)(lhs, rhs.first);
+    if (absl::Status status = CelValue::CheckMapKeyType(key); !status.ok()) {
+      return CelValue::CreateError(
+          google::protobuf::Arena::Create<absl::Status>(arena, std::move(status)));
     }
-
-    bool operator()(const Entry& lhs, const CelValue& rhs) const {
-      return (*this)(lhs.first, rhs);
+    absl::StatusOr<Value> modern_key =
+        interop_internal::FromLegacyValue(arena, key);
+    if (!modern_key.ok()) {
+      return CelValue::CreateError(google::protobuf::Arena::Create<absl::Status>(
+          arena, std::move(modern_key).status()));
     }
-  };
-
-  CelMapImpl() : CelMapImpl(nullptr, 0) {}
-
-  CelMapImpl(const Entry* entries, size_t entries_size)
-      : entries_(entries), entries_size_(entries_size) {}
-
-  absl::optional<CelValue> operator[](CelValue key) const override {
-    if (key.IsError() || key.IsUnknownSet()) {
-      return key;
+    common_internal::LegacyTypeReflector value_provider;
+    common_internal::LegacyValueManager value_manager(
+        extensions::ProtoMemoryManagerRef(arena), value_provider);
+    Value entry;
+    absl::StatusOr<bool> found =
+        value_.Find(value_manager, *modern_key, entry);
+    if (!found.ok()) {
+      return CelValue::CreateError(google::protobuf::Arena::Create<absl::Status>(
+          arena, std::move(found).status()));
     }
-    auto it = std::lower_bound(begin(), end(), key, KeyCompare{});
-    if (it == end() || !EqualKey(it->first, key)) {
+    if (!*found) {
       return absl::nullopt;
     }
-    return it->second;
-  }
-
-  CelValue operator[](int index) const override {
-    if (index >= size()) {
-      return CelValue::CreateNull();
+    absl::StatusOr<CelValue> legacy = LegacyValue(arena, entry);
+    if (!legacy.ok()) {
+      return CelValue::CreateError(google::protobuf::Arena::Create<absl::Status>(
+          arena, std::move(legacy).status()));
     }
-    return entries_[index].first;
+    return *std::move(legacy);
   }
 
   absl::StatusOr<bool> Has(const CelValue& key) const override {
     CEL_RETURN_IF_ERROR(CelValue::CheckMapKeyType(key));
-    auto it = std::lower_bound(begin(), end(), key, KeyCompare{});
-    return it != end() && EqualKey(it->first, key);
+    CEL_ASSIGN_OR_RETURN(Value modern_key,
+                         interop_internal::FromLegacyValue(arena_, key));
+    common_internal::LegacyTypeReflector value_provider;
+    common_internal::LegacyValueManager value_manager(
+        extensions::ProtoMemoryManagerRef(arena_), value_provider);
+    Value result;
+    CEL_RETURN_IF_ERROR(value_.Has(value_manager, modern_key, result));
+    if (auto bool_result = As<BoolValue>(result); bool_result.has_value()) {
+      return bool_result->NativeValue();
+    }
+    if (auto error_result = As<ErrorValue>(result); error_result.has_value()) {
+      return error_result->NativeValue();
+    }
+    return false;
   }
 
-  int size() const override { return entries_size_; }
-
-  bool empty() const override { return entries_size_ == 0; }
-
-  const Entry* begin() const { return entries_; }
+  int size() const override { return static_cast<int>(size_); }
 
-  const Entry* end() const { return entries_ + entries_size_; }
+  absl::StatusOr<const CelList*> ListKeys() const override {
+    return ListKeys(arena_);
+  }
 
-  absl::StatusOr<const CelList*> ListKeys() const override { return this; }
+  absl::StatusOr<const CelList*> ListKeys(
+      google::protobuf::Arena* arena) const override {
+    static_cast<void>(arena);
+    absl::MutexLock lock(&keys_mutex_);
+    if (keys_ == nullptr) {
+      // Keys are cached on the wrapper's own arena so repeated iteration
+      // (e.g. a re-run comprehension) materializes them at most once.
+      common_internal::LegacyTypeReflector value_provider;
+      common_internal::LegacyValueManager value_manager(
+          extensions::ProtoMemoryManagerRef(arena_), value_provider);
+      ListValue keys;
+      CEL_RETURN_IF_ERROR(value_.ListKeys(value_manager, keys));
+      CEL_ASSIGN_OR_RETURN(auto keys_size, keys.Size());
+      keys_ = google::protobuf::Arena::Create<ModernListAsCelList>(
+          arena_, std::move(keys), keys_size, arena_);
+    }
+    return keys_;
+  }
 
  private:
-  const Entry* const entries_;
-  const size_t entries_size_;
+  MapValue value_;
+  const size_t size_;
+  absl::Nonnull<google::protobuf::Arena*> const arena_;
+  mutable absl::Mutex keys_mutex_;
+  mutable const CelList* keys_ ABSL_GUARDED_BY(keys_mutex_) = nullptr;
 };
 
 class CelListValue final : public ContainerBackedListImpl {
@@ -628,6 +639,11 @@ cel_common_internal_LegacyListValue_Contains(uintptr_t impl,
       extensions::ProtoMemoryManagerArena(value_manager.GetMemoryManager());
   CEL_ASSIGN_OR_RETURN(auto legacy_other, LegacyValue(arena, other));
   const auto* cel_list = AsCelList(impl);
+  if (absl::optional<bool> contained = cel_list->ContainsValue(legacy_other);
+      contained.has_value()) {
+    result = BoolValue{*contained};
+    return absl::OkStatus();
+  }
   for (int i = 0; i < cel_list->size(); ++i) {
     auto element = cel_list->Get(arena, i);
     absl::optional<bool> equal =
@@ -778,9 +794,19 @@ cel_common_internal_LegacyMapValue_Has(uintptr_t impl,
     case ValueKind::kInt:
       ABSL_FALLTHROUGH_INTENDED;
     case ValueKind::kUint:
-      ABSL_FALLTHROUGH_INTENDED;
-    case ValueKind::kString:
       break;
+    case ValueKind::kString: {
+      // A presence test only needs the key for the duration of the call, so
+      // the legacy key can alias the handle's contents directly rather than
+      // being copied onto the evaluation arena as the general conversion
+      // would do for non-pooled strings.
+      std::string scratch;
+      CEL_ASSIGN_OR_RETURN(
+          auto has, AsCelMap(impl)->Has(CelValue::CreateStringView(
+                        Cast<StringValue>(key).NativeString(scratch))));
+      result = BoolValue{has};
+      return absl::OkStatus();
+    }
     default:
       return InvalidMapKeyTypeError(key.kind());
   }
@@ -1285,31 +1311,16 @@ absl::StatusOr<google::api::expr::runtime::CelValue> LegacyValue(
         return CelValue::CreateList(
             AsCelList(legacy_list_value->NativeValue()));
       }
-      // We have a non-legacy `ListValue`. We are going to have to
-      // materialize it in its entirety to `CelList`.
+      // We have a non-legacy `ListValue`. Wrap it in a lazy adapter that
+      // converts elements on access instead of materializing the whole list.
       auto list_value = Cast<ListValue>(modern_value);
       CEL_ASSIGN_OR_RETURN(auto list_value_size, list_value.Size());
       if (list_value_size == 0) {
         return CelValue::CreateList();
       }
-      auto* elements = static_cast<CelValue*>(arena->AllocateAligned(
-          sizeof(CelValue) * list_value_size, alignof(CelValue)));
-      common_internal::LegacyTypeReflector value_provider;
-      common_internal::LegacyValueManager value_manager(
-          extensions::ProtoMemoryManagerRef(arena), value_provider);
-      CEL_RETURN_IF_ERROR(list_value.ForEach(
-          value_manager,
-          [arena, elements](size_t index,
-                            const Value& element) -> absl::StatusOr<bool> {
-            CEL_ASSIGN_OR_RETURN(elements[index], LegacyValue(arena, element));
-            return true;
-          }));
-      // We don't bother registering CelListImpl's destructor, it doesn't own
-      // anything and is not trivially destructible simply due to having a
-      // virtual destructor.
-      return CelValue::CreateList(::new (
-          arena->AllocateAligned(sizeof(CelListImpl), alignof(CelListImpl)))
-                                      CelListImpl(elements, list_value_size));
+      return CelValue::CreateList(
+          google::protobuf::Arena::Create<ModernListAsCelList>(
+              arena, std::move(list_value), list_value_size, arena));
     }
     case ValueKind::kMap: {
       if (auto legacy_map_value =
@@ -1317,34 +1328,17 @@ absl::StatusOr<google::api::expr::runtime::CelValue> LegacyValue(
           legacy_map_value.has_value()) {
         return CelValue::CreateMap(AsCelMap(legacy_map_value->NativeValue()));
       }
-      // We have a non-legacy `MapValue`. We are going to have to
-      // materialize it in its entirety to `CelMap`.
+      // We have a non-legacy `MapValue`. Wrap it in a lazy adapter that
+      // performs lookups against the modern map instead of materializing the
+      // whole map.
       auto map_value = Cast<MapValue>(modern_value);
       CEL_ASSIGN_OR_RETURN(auto map_value_size, map_value.Size());
       if (map_value_size == 0) {
         return CelValue::CreateMap();
       }
-      auto* entries = static_cast<CelMapImpl::Entry*>(
-          arena->AllocateAligned(sizeof(CelMapImpl::Entry) * map_value_size,
-                                 alignof(CelMapImpl::Entry)));
-      size_t entry_count = 0;
-      common_internal::LegacyTypeReflector value_provider;
-      common_internal::LegacyValueManager value_manager(
-          extensions::ProtoMemoryManagerRef(arena), value_provider);
-      CEL_RETURN_IF_ERROR(map_value.ForEach(
-          value_manager,
-          [arena, entries, &entry_count](
-              const Value& key, const Value& value) -> absl::StatusOr<bool> {
-            auto* entry = ::new (static_cast<void*>(entries + entry_count++))
-                CelMapImpl::Entry{};
-            CEL_ASSIGN_OR_RETURN(entry->first, LegacyValue(arena, key));
-            CEL_ASSIGN_OR_RETURN(entry->second, LegacyValue(arena, value));
-            return true;
-          }));
-      std::sort(entries, entries + map_value_size, CelMapImpl::KeyCompare{});
-      return CelValue::CreateMap(::new (
-          arena->AllocateAligned(sizeof(CelMapImpl), alignof(CelMapImpl)))
-                                     CelMapImpl(entries, map_value_size));
+      return CelValue::CreateMap(
+          google::protobuf::Arena::Create<ModernMapAsCelMap>(
+              arena, std::move(map_value), map_value_size, arena));
     }
     case ValueKind::kUnknown:
       return CelValue::CreateUnknownSet(google::protobuf::Arena::Create<Unknown>(
@@ -1492,65 +1486,33 @@ absl::StatusOr<google::api::expr::runtime::CelValue> ToLegacyValue(
         return CelValue::CreateList(
             AsCelList(legacy_list_value->NativeValue()));
       }
-      // We have a non-legacy `ListValue`. We are going to have to
-      // materialize it in its entirety to `CelList`.
+      // We have a non-legacy `ListValue`. Wrap it in a lazy adapter that
+      // converts elements on access instead of materializing the whole list.
       auto list_value = Cast<ListValue>(value);
       CEL_ASSIGN_OR_RETURN(auto list_value_size, list_value.Size());
       if (list_value_size == 0) {
         return CelValue::CreateList();
       }
-      auto* elements = static_cast<CelValue*>(arena->AllocateAligned(
-          sizeof(CelValue) * list_value_size, alignof(CelValue)));
-      common_internal::LegacyTypeReflector value_provider;
-      common_internal::LegacyValueManager value_manager(
-          extensions::ProtoMemoryManagerRef(arena), value_provider);
-      CEL_RETURN_IF_ERROR(list_value.ForEach(
-          value_manager,
-          [arena, elements](size_t index,
-                            const Value& element) -> absl::StatusOr<bool> {
-            CEL_ASSIGN_OR_RETURN(elements[index], LegacyValue(arena, element));
-            return true;
-          }));
-      // We don't bother registering CelListImpl's destructor, it doesn't own
-      // anything and is not trivially destructible simply due to having a
-      // virtual destructor.
-      return CelValue::CreateList(::new (
-          arena->AllocateAligned(sizeof(CelListImpl), alignof(CelListImpl)))
-                                      CelListImpl(elements, list_value_size));
+      return CelValue::CreateList(
+          google::protobuf::Arena::Create<ModernListAsCelList>(
+              arena, std::move(list_value), list_value_size, arena));
     }
     case ValueKind::kMap: {
       if (auto legacy_map_value = As<common_internal::LegacyMapValue>(value);
           legacy_map_value.has_value()) {
         return CelValue::CreateMap(AsCelMap(legacy_map_value->NativeValue()));
       }
-      // We have a non-legacy `MapValue`. We are going to have to
-      // materialize it in its entirety to `CelMap`.
+      // We have a non-legacy `MapValue`. Wrap it in a lazy adapter that
+      // performs lookups against the modern map instead of materializing the
+      // whole map.
       auto map_value = Cast<MapValue>(value);
       CEL_ASSIGN_OR_RETURN(auto map_value_size, map_value.Size());
       if (map_value_size == 0) {
         return CelValue::CreateMap();
       }
-      auto* entries = static_cast<CelMapImpl::Entry*>(
-          arena->AllocateAligned(sizeof(CelMapImpl::Entry) * map_value_size,
-                                 alignof(CelMapImpl::Entry)));
-      size_t entry_count = 0;
-      common_internal::LegacyTypeReflector value_provider;
-      common_internal::LegacyValueManager value_manager(
-          extensions::ProtoMemoryManagerRef(arena), value_provider);
-      CEL_RETURN_IF_ERROR(map_value.ForEach(
-          value_manager,
-          [arena, entries, &entry_count](
-              const Value& key, const Value& value) -> absl::StatusOr<bool> {
-            auto* entry = ::new (static_cast<void*>(entries + entry_count++))
-                CelMapImpl::Entry{};
-            CEL_ASSIGN_OR_RETURN(entry->first, LegacyValue(arena, key));
-            CEL_ASSIGN_OR_RETURN(entry->second, LegacyValue(arena, value));
-            return true;
-          }));
-      std::sort(entries, entries + map_value_size, CelMapImpl::KeyCompare{});
-      return CelValue::CreateMap(::new (
-          arena->AllocateAligned(sizeof(CelMapImpl), alignof(CelMapImpl)))
-                                     CelMapImpl(entries, map_value_size));
+      return CelValue::CreateMap(
+          google::protobuf::Arena::Create<ModernMapAsCelMap>(
+              arena, std::move(map_value), map_value_size, arena));
     }
     case ValueKind::kUnknown:
       return CelValue::CreateUnknownSet(google::protobuf::Arena::Create<Unknown>(
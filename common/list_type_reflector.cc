@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <cstddef>
 #include <string>
 #include <type_traits>
@@ -21,10 +22,13 @@
 #include "absl/base/attributes.h"
 #include "absl/base/call_once.h"
 #include "absl/base/macros.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "common/casting.h"
 #include "common/json.h"
 #include "common/memory.h"
@@ -34,6 +38,7 @@
 #include "common/type_reflector.h"
 #include "common/value.h"
 #include "common/value_factory.h"
+#include "common/value_kind.h"
 #include "common/value_manager.h"
 #include "internal/dynamic_loader.h"  // IWYU pragma: keep
 #include "internal/status_macros.h"
@@ -42,10 +47,19 @@ namespace cel {
 
 namespace {
 
+// Elements are stored inline in the value object body up to this capacity,
+// spilling to the heap beyond it. The 1-3 element lists which dominate
+// evaluation (small literals, argument building) avoid a separate element
+// allocation and the indirection that comes with it.
+inline constexpr size_t kInlineListCapacity = 4;
+
+template <typename T>
+using ListValueElements = absl::InlinedVector<T, kInlineListCapacity>;
+
 template <typename T>
 class TypedListValue final : public ParsedListValueInterface {
  public:
-  TypedListValue(ListType type, std::vector<T>&& elements)
+  TypedListValue(ListType type, ListValueElements<T>&& elements)
       : type_(std::move(type)), elements_(std::move(elements)) {}
 
   std::string DebugString() const override {
@@ -68,6 +82,18 @@ class TypedListValue final : public ParsedListValueInterface {
     return std::move(builder).Build();
   }
 
+  absl::StatusOr<size_t> GetChunk(ValueManager& value_manager, size_t index,
+                                  absl::Span<Value> out) const override {
+    if (index >= elements_.size()) {
+      return size_t{0};
+    }
+    const size_t count = std::min(out.size(), elements_.size() - index);
+    for (size_t i = 0; i < count; ++i) {
+      out[i] = elements_[index + i];
+    }
+    return count;
+  }
+
   absl::Status ForEach(ValueManager& value_manager,
                        ForEachCallback callback) const override {
     for (const auto& element : elements_) {
@@ -118,7 +144,7 @@ class TypedListValue final : public ParsedListValueInterface {
   }
 
   const ListType type_;
-  const std::vector<T> elements_;
+  const ListValueElements<T> elements_;
 };
 
 template <typename T>
@@ -168,7 +194,7 @@ class ListValueBuilderImpl final : public ListValueBuilder {
  private:
   MemoryManagerRef memory_manager_;
   ListType type_;
-  std::vector<T> elements_;
+  ListValueElements<T> elements_;
 };
 
 template <>
@@ -186,6 +212,12 @@ class ListValueBuilderImpl<Value> final : public ListValueBuilder {
     if (value.Is<ErrorValue>()) {
       return value.As<ErrorValue>().NativeValue();
     }
+    if (elements_.empty()) {
+      homogeneous_kind_ = value.kind();
+    } else if (homogeneous_kind_.has_value() &&
+               *homogeneous_kind_ != value.kind()) {
+      homogeneous_kind_.reset();
+    }
     elements_.push_back(std::move(value));
     return absl::OkStatus();
   }
@@ -196,15 +228,50 @@ class ListValueBuilderImpl<Value> final : public ListValueBuilder {
 
   void Reserve(size_t capacity) override { elements_.reserve(capacity); }
 
+  // A dyn-typed list whose elements all turned out to be the same primitive
+  // kind is re-packed into the matching typed representation, so retained
+  // lists (numeric ranges, ID lists) store raw primitives instead of boxed
+  // values.
   ListValue Build() && override {
+    if (homogeneous_kind_.has_value()) {
+      switch (*homogeneous_kind_) {
+        case ValueKind::kBool:
+          return std::move(*this).BuildSpecialized<BoolValue>();
+        case ValueKind::kInt:
+          return std::move(*this).BuildSpecialized<IntValue>();
+        case ValueKind::kUint:
+          return std::move(*this).BuildSpecialized<UintValue>();
+        case ValueKind::kDouble:
+          return std::move(*this).BuildSpecialized<DoubleValue>();
+        case ValueKind::kString:
+          return std::move(*this).BuildSpecialized<StringValue>();
+        default:
+          break;
+      }
+    }
     return ParsedListValue(memory_manager_.MakeShared<TypedListValue<Value>>(
         std::move(type_), std::move(elements_)));
   }
 
  private:
+  template <typename T>
+  ListValue BuildSpecialized() && {
+    ListValueElements<T> typed_elements;
+    typed_elements.reserve(elements_.size());
+    for (Value& element : elements_) {
+      typed_elements.push_back(Cast<T>(std::move(element)));
+    }
+    return ParsedListValue(
+        memory_manager_.template MakeShared<TypedListValue<T>>(
+            std::move(type_), std::move(typed_elements)));
+  }
+
   MemoryManagerRef memory_manager_;
   ListType type_;
-  std::vector<Value> elements_;
+  ListValueElements<Value> elements_;
+  // Kind shared by every element added so far, or nullopt once two kinds
+  // have been observed (or no element has been added yet).
+  absl::optional<ValueKind> homogeneous_kind_;
 };
 
 using LegacyTypeReflector_NewListValueBuilder =
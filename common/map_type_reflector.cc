@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <cstddef>
 #include <string>
 #include <type_traits>
@@ -49,6 +50,11 @@ namespace cel {
 
 namespace {
 
+// Maps at or below this size are represented as a flat sorted array instead of
+// a hash table. Most evaluated maps are small, and for them a contiguous array
+// with a linear key scan is both smaller and faster than hash table buckets.
+constexpr size_t kSmallMapMaxSize = 16;
+
 template <typename T>
 struct MapValueKeyHash;
 template <typename T>
@@ -425,6 +431,163 @@ class TypedMapValue final : public ParsedMapValueInterface {
       entries_;
 };
 
+template <typename K, typename V>
+class SmallMapValueKeyIterator final : public ValueIterator {
+ public:
+  explicit SmallMapValueKeyIterator(
+      const std::vector<std::pair<K, V>>& entries ABSL_ATTRIBUTE_LIFETIME_BOUND)
+      : begin_(entries.begin()), end_(entries.end()) {}
+
+  bool HasNext() override { return begin_ != end_; }
+
+  absl::Status Next(ValueManager&, Value& result) override {
+    if (ABSL_PREDICT_FALSE(begin_ == end_)) {
+      return absl::FailedPreconditionError(
+          "ValueIterator::Next() called when "
+          "ValueIterator::HasNext() returns false");
+    }
+    auto key = Value(begin_->first);
+    ++begin_;
+    result = std::move(key);
+    return absl::OkStatus();
+  }
+
+ private:
+  typename std::vector<std::pair<K, V>>::const_iterator begin_;
+  const typename std::vector<std::pair<K, V>>::const_iterator end_;
+};
+
+// Flat sorted-array representation for small maps. Entries are kept in a
+// single contiguous allocation ordered by `MapValueKeyLess` and lookups are a
+// linear scan, which beats hashing for the handful of entries involved.
+template <typename K, typename V>
+class SmallMapValue final : public ParsedMapValueInterface {
+ public:
+  using key_type = std::decay_t<decltype(std::declval<K>().GetType(
+      std::declval<TypeManager&>()))>;
+
+  SmallMapValue(MapType type, std::vector<std::pair<K, V>>&& entries)
+      : type_(std::move(type)), entries_(std::move(entries)) {}
+
+  std::string DebugString() const override {
+    // Entries are already sorted by key.
+    return absl::StrCat(
+        "{",
+        absl::StrJoin(entries_, ", ",
+                      absl::PairFormatter(absl::StreamFormatter(), ": ",
+                                          absl::StreamFormatter())),
+        "}");
+  }
+
+  bool IsEmpty() const override { return entries_.empty(); }
+
+  size_t Size() const override { return entries_.size(); }
+
+  absl::StatusOr<JsonObject> ConvertToJsonObject(
+      AnyToJsonConverter& value_manager) const override {
+    JsonObjectBuilder builder;
+    builder.reserve(Size());
+    for (const auto& entry : entries_) {
+      CEL_ASSIGN_OR_RETURN(auto json_key, MapValueKeyJson<K>{}(entry.first));
+      CEL_ASSIGN_OR_RETURN(auto json_value,
+                           entry.second.ConvertToJson(value_manager));
+      if (!builder.insert(std::pair{std::move(json_key), std::move(json_value)})
+               .second) {
+        return absl::FailedPreconditionError(
+            "cannot convert map with duplicate keys to JSON");
+      }
+    }
+    return std::move(builder).Build();
+  }
+
+  absl::Status ListKeys(ValueManager& value_manager,
+                        ListValue& result) const override {
+    CEL_ASSIGN_OR_RETURN(
+        auto keys,
+        value_manager.NewListValueBuilder(
+            value_manager.CreateListType(Cast<key_type>(type_.key()))));
+    keys->Reserve(Size());
+    for (const auto& entry : entries_) {
+      CEL_RETURN_IF_ERROR(keys->Add(entry.first));
+    }
+    result = std::move(*keys).Build();
+    return absl::OkStatus();
+  }
+
+  absl::Status ForEach(ValueManager& value_manager,
+                       ForEachCallback callback) const override {
+    for (const auto& entry : entries_) {
+      CEL_ASSIGN_OR_RETURN(auto ok, callback(entry.first, entry.second));
+      if (!ok) {
+        break;
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<absl::Nonnull<ValueIteratorPtr>> NewIterator(
+      ValueManager&) const override {
+    return std::make_unique<SmallMapValueKeyIterator<K, V>>(entries_);
+  }
+
+ protected:
+  Type GetTypeImpl(TypeManager&) const override { return type_; }
+
+ private:
+  absl::StatusOr<bool> FindImpl(ValueManager&, const Value& key,
+                                Value& result) const override {
+    const auto& typed_key = Cast<K>(key);
+    for (const auto& entry : entries_) {
+      if (MapValueKeyEqualTo<K>{}(entry.first, typed_key)) {
+        result = entry.second;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  absl::StatusOr<bool> HasImpl(ValueManager&, const Value& key) const override {
+    const auto& typed_key = Cast<K>(key);
+    for (const auto& entry : entries_) {
+      if (MapValueKeyEqualTo<K>{}(entry.first, typed_key)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  NativeTypeId GetNativeTypeId() const noexcept override {
+    return NativeTypeId::For<SmallMapValue<K, V>>();
+  }
+
+  const MapType type_;
+  const std::vector<std::pair<K, V>> entries_;
+};
+
+// Chooses the map representation based on the final size: small maps become
+// `SmallMapValue`, everything else stays a hash table.
+template <typename K, typename V>
+MapValue MakeMapValue(MemoryManagerRef memory_manager, MapType&& type,
+                      ValueFlatHashMapFor<K, V>&& entries) {
+  if (entries.size() <= kSmallMapMaxSize) {
+    std::vector<std::pair<K, V>> small_entries;
+    small_entries.reserve(entries.size());
+    for (auto& entry : entries) {
+      small_entries.push_back(
+          std::pair{K(entry.first), V(std::move(entry.second))});
+    }
+    std::stable_sort(
+        small_entries.begin(), small_entries.end(),
+        [](const std::pair<K, V>& lhs, const std::pair<K, V>& rhs) -> bool {
+          return MapValueKeyLess<K>{}(lhs.first, rhs.first);
+        });
+    return ParsedMapValue(memory_manager.MakeShared<SmallMapValue<K, V>>(
+        std::move(type), std::move(small_entries)));
+  }
+  return ParsedMapValue(memory_manager.MakeShared<TypedMapValue<K, V>>(
+      std::move(type), std::move(entries)));
+}
+
 template <typename K, typename V>
 class MapValueBuilderImpl final : public MapValueBuilder {
  public:
@@ -470,8 +633,7 @@ class MapValueBuilderImpl final : public MapValueBuilder {
   void Reserve(size_t capacity) override { entries_.reserve(capacity); }
 
   MapValue Build() && override {
-    return ParsedMapValue(memory_manager_.MakeShared<TypedMapValue<K, V>>(
-        std::move(type_), std::move(entries_)));
+    return MakeMapValue(memory_manager_, std::move(type_), std::move(entries_));
   }
 
  private:
@@ -515,8 +677,7 @@ class MapValueBuilderImpl<Value, V> final : public MapValueBuilder {
   void Reserve(size_t capacity) override { entries_.reserve(capacity); }
 
   MapValue Build() && override {
-    return ParsedMapValue(memory_manager_.MakeShared<TypedMapValue<Value, V>>(
-        std::move(type_), std::move(entries_)));
+    return MakeMapValue(memory_manager_, std::move(type_), std::move(entries_));
   }
 
  private:
@@ -561,8 +722,7 @@ class MapValueBuilderImpl<K, Value> final : public MapValueBuilder {
   void Reserve(size_t capacity) override { entries_.reserve(capacity); }
 
   MapValue Build() && override {
-    return ParsedMapValue(memory_manager_.MakeShared<TypedMapValue<K, Value>>(
-        std::move(type_), std::move(entries_)));
+    return MakeMapValue(memory_manager_, std::move(type_), std::move(entries_));
   }
 
  private:
@@ -599,9 +759,7 @@ class MapValueBuilderImpl<Value, Value> final : public MapValueBuilder {
   void Reserve(size_t capacity) override { entries_.reserve(capacity); }
 
   MapValue Build() && override {
-    return ParsedMapValue(
-        memory_manager_.MakeShared<TypedMapValue<Value, Value>>(
-            std::move(type_), std::move(entries_)));
+    return MakeMapValue(memory_manager_, std::move(type_), std::move(entries_));
   }
 
  private:
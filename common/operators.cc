@@ -1,142 +1,92 @@
 #include "common/operators.h"
 
-#include <map>
-#include <memory>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
 #include <string>
 
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
 namespace google {
 namespace api {
 namespace expr {
 namespace common {
 
 namespace {
-// These functions provide access to reverse mappings for operators.
-// Functions generally map from text expression to Expr representation,
+// These tables provide access to reverse mappings for operators.
+// Tables generally map from text expression to Expr representation,
 // e.g., from "&&" to "_&&_". Reverse operators provides a mapping from
 // Expr to textual mapping, e.g., from "_&&_" to "&&".
+//
+// Each table is sorted by key and built entirely at compile time, so a
+// lookup is a binary search over a handful of entries with no lazy
+// initialization or hashing. These lookups sit on the parse hot path.
+
+struct OperatorEntry {
+  absl::string_view key;
+  absl::string_view value;
+};
+
+struct PrecedenceEntry {
+  absl::string_view key;
+  int value;
+};
+
+constexpr OperatorEntry kUnaryOperators[] = {
+    {"!_", "!"},
+    {"-_", "-"},
+};
+
+constexpr OperatorEntry kBinaryOperators[] = {
+    {"@in", "in"},  {"_!=_", "!="}, {"_%_", "%"},   {"_&&_", "&&"},
+    {"_*_", "*"},   {"_+_", "+"},   {"_-_", "-"},   {"_/_", "/"},
+    {"_<=_", "<="}, {"_<_", "<"},   {"_==_", "=="}, {"_>=_", ">="},
+    {"_>_", ">"},   {"_in_", "in"}, {"_||_", "||"},
+};
+
+constexpr OperatorEntry kReverseOperators[] = {
+    {"!", "!_"},    {"!=", "_!=_"}, {"%", "_%_"},   {"&&", "_&&_"},
+    {"*", "_*_"},   {"+", "_+_"},   {"-", "_-_"},   {"/", "_/_"},
+    {"<", "_<_"},   {"<=", "_<=_"}, {"==", "_==_"}, {">", "_>_"},
+    {">=", "_>=_"}, {"in", "@in"},  {"||", "_||_"},
+};
+
+constexpr OperatorEntry kOperators[] = {
+    {"!_", "!"},    {"-_", "-"},    {"@in", "in"},  {"_!=_", "!="},
+    {"_%_", "%"},   {"_&&_", "&&"}, {"_*_", "*"},   {"_+_", "+"},
+    {"_-_", "-"},   {"_/_", "/"},   {"_<=_", "<="}, {"_<_", "<"},
+    {"_==_", "=="}, {"_>=_", ">="}, {"_>_", ">"},   {"_in_", "in"},
+    {"_||_", "||"},
+};
 
-const std::map<std::string, std::string>& UnaryOperators() {
-  static std::shared_ptr<std::map<std::string, std::string>> unaries_map =
-      [&]() {
-        auto u = std::make_shared<std::map<std::string, std::string>>(
-            std::map<std::string, std::string>{
-                {CelOperator::NEGATE, "-"}, {CelOperator::LOGICAL_NOT, "!"}});
-        return u;
-      }();
-  return *unaries_map;
-}
-
-const std::map<std::string, std::string>& BinaryOperators() {
-  static std::shared_ptr<std::map<std::string, std::string>> binops_map =
-      [&]() {
-        auto c = std::make_shared<std::map<std::string, std::string>>(
-            std::map<std::string, std::string>{
-                {CelOperator::LOGICAL_OR, "||"},
-                {CelOperator::LOGICAL_AND, "&&"},
-                {CelOperator::LESS_EQUALS, "<="},
-                {CelOperator::LESS, "<"},
-                {CelOperator::GREATER_EQUALS, ">="},
-                {CelOperator::GREATER, ">"},
-                {CelOperator::EQUALS, "=="},
-                {CelOperator::NOT_EQUALS, "!="},
-                {CelOperator::IN_DEPRECATED, "in"},
-                {CelOperator::IN, "in"},
-                {CelOperator::ADD, "+"},
-                {CelOperator::SUBTRACT, "-"},
-                {CelOperator::MULTIPLY, "*"},
-                {CelOperator::DIVIDE, "/"},
-                {CelOperator::MODULO, "%"}});
-        return c;
-      }();
-  return *binops_map;
-}
-
-const std::map<std::string, std::string>& ReverseOperators() {
-  static std::shared_ptr<std::map<std::string, std::string>> operators_map =
-      [&]() {
-        auto c = std::make_shared<std::map<std::string, std::string>>(
-            std::map<std::string, std::string>{
-                {"+", CelOperator::ADD},
-                {"-", CelOperator::SUBTRACT},
-                {"*", CelOperator::MULTIPLY},
-                {"/", CelOperator::DIVIDE},
-                {"%", CelOperator::MODULO},
-                {"==", CelOperator::EQUALS},
-                {"!=", CelOperator::NOT_EQUALS},
-                {">", CelOperator::GREATER},
-                {">=", CelOperator::GREATER_EQUALS},
-                {"<", CelOperator::LESS},
-                {"<=", CelOperator::LESS_EQUALS},
-                {"&&", CelOperator::LOGICAL_AND},
-                {"!", CelOperator::LOGICAL_NOT},
-                {"||", CelOperator::LOGICAL_OR},
-                {"in", CelOperator::IN},
-            });
-        return c;
-      }();
-  return *operators_map;
-}
-
-const std::map<std::string, std::string>& Operators() {
-  static std::shared_ptr<std::map<std::string, std::string>> operators_map =
-      [&]() {
-        auto c = std::make_shared<std::map<std::string, std::string>>(
-            std::map<std::string, std::string>{
-                {CelOperator::ADD, "+"},
-                {CelOperator::SUBTRACT, "-"},
-                {CelOperator::MULTIPLY, "*"},
-                {CelOperator::DIVIDE, "/"},
-                {CelOperator::MODULO, "%"},
-                {CelOperator::EQUALS, "=="},
-                {CelOperator::NOT_EQUALS, "!="},
-                {CelOperator::GREATER, ">"},
-                {CelOperator::GREATER_EQUALS, ">="},
-                {CelOperator::LESS, "<"},
-                {CelOperator::LESS_EQUALS, "<="},
-                {CelOperator::LOGICAL_AND, "&&"},
-                {CelOperator::LOGICAL_NOT, "!"},
-                {CelOperator::LOGICAL_OR, "||"},
-                {CelOperator::IN, "in"},
-                {CelOperator::IN_DEPRECATED, "in"},
-                {CelOperator::NEGATE, "-"}});
-        return c;
-      }();
-  return *operators_map;
+// precedence of the operator, where the higher value means higher.
+constexpr PrecedenceEntry kPrecedences[] = {
+    {"!_", 2},   {"-_", 2},   {"@in", 5},   {"_!=_", 5}, {"_%_", 3},
+    {"_&&_", 6}, {"_*_", 3},  {"_+_", 4},   {"_-_", 4},  {"_/_", 3},
+    {"_<=_", 5}, {"_<_", 5},  {"_==_", 5},  {"_>=_", 5}, {"_>_", 5},
+    {"_?_:_", 8}, {"_[_]", 1}, {"_in_", 5}, {"_||_", 7},
+};
+
+template <typename Entry, size_t N>
+const Entry* FindEntry(const Entry (&table)[N], absl::string_view key) {
+  auto it = std::lower_bound(std::begin(table), std::end(table), key,
+                             [](const Entry& entry, absl::string_view key) {
+                               return entry.key < key;
+                             });
+  if (it == std::end(table) || it->key != key) {
+    return nullptr;
+  }
+  return it;
 }
 
-// precedence of the operator, where the higher value means higher.
-const std::map<std::string, int>& Precedences() {
-  static std::shared_ptr<std::map<std::string, int>> precedence_map = [&]() {
-    auto c = std::make_shared<std::map<std::string, int>>(
-        std::map<std::string, int>{{CelOperator::CONDITIONAL, 8},
-
-                                   {CelOperator::LOGICAL_OR, 7},
-
-                                   {CelOperator::LOGICAL_AND, 6},
-
-                                   {CelOperator::EQUALS, 5},
-                                   {CelOperator::GREATER, 5},
-                                   {CelOperator::GREATER_EQUALS, 5},
-                                   {CelOperator::IN, 5},
-                                   {CelOperator::LESS, 5},
-                                   {CelOperator::LESS_EQUALS, 5},
-                                   {CelOperator::NOT_EQUALS, 5},
-                                   {CelOperator::IN_DEPRECATED, 5},
-
-                                   {CelOperator::ADD, 4},
-                                   {CelOperator::SUBTRACT, 4},
-
-                                   {CelOperator::DIVIDE, 3},
-                                   {CelOperator::MODULO, 3},
-                                   {CelOperator::MULTIPLY, 3},
-
-                                   {CelOperator::LOGICAL_NOT, 2},
-                                   {CelOperator::NEGATE, 2},
-
-                                   {CelOperator::INDEX, 1}});
-    return c;
-  }();
-  return *precedence_map;
+template <typename Entry, size_t N>
+absl::optional<std::string> FindValue(const Entry (&table)[N],
+                                      absl::string_view key) {
+  if (const Entry* entry = FindEntry(table, key); entry != nullptr) {
+    return std::string(entry->value);
+  }
+  return absl::optional<std::string>();
 }
 
 }  // namespace
@@ -172,48 +122,27 @@ const absl::string_view CelOperator::OPT_INDEX = "_[?_]";
 const absl::string_view CelOperator::OPT_SELECT = "_?._";
 
 int LookupPrecedence(const std::string& op) {
-  auto precs = Precedences();
-  auto p = precs.find(op);
-  if (p != precs.end()) {
-    return p->second;
+  if (const PrecedenceEntry* entry = FindEntry(kPrecedences, op);
+      entry != nullptr) {
+    return entry->value;
   }
   return 0;
 }
 
 absl::optional<std::string> LookupUnaryOperator(const std::string& op) {
-  auto unary_ops = UnaryOperators();
-  auto o = unary_ops.find(op);
-  if (o == unary_ops.end()) {
-    return absl::optional<std::string>();
-  }
-  return o->second;
+  return FindValue(kUnaryOperators, op);
 }
 
 absl::optional<std::string> LookupBinaryOperator(const std::string& op) {
-  auto bin_ops = BinaryOperators();
-  auto o = bin_ops.find(op);
-  if (o == bin_ops.end()) {
-    return absl::optional<std::string>();
-  }
-  return o->second;
+  return FindValue(kBinaryOperators, op);
 }
 
 absl::optional<std::string> LookupOperator(const std::string& op) {
-  auto ops = Operators();
-  auto o = ops.find(op);
-  if (o == ops.end()) {
-    return absl::optional<std::string>();
-  }
-  return o->second;
+  return FindValue(kOperators, op);
 }
 
 absl::optional<std::string> ReverseLookupOperator(const std::string& op) {
-  auto rev_ops = ReverseOperators();
-  auto o = rev_ops.find(op);
-  if (o == rev_ops.end()) {
-    return absl::optional<std::string>();
-  }
-  return o->second;
+  return FindValue(kReverseOperators, op);
 }
 
 bool IsOperatorSamePrecedence(const std::string& op,
@@ -195,6 +195,19 @@ TEST_P(TypeReflectorTest, NewListValueBuilderCoverage_Dynamic) {
   EXPECT_EQ(value.DebugString(), "[0, 1, 2]");
 }
 
+TEST_P(TypeReflectorTest, NewListValueBuilderCoverage_SpillsInlineCapacity) {
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       value_manager().NewListValueBuilder(
+                           ListType(type_factory().GetDynListType())));
+  for (int64_t i = 0; i < 8; ++i) {
+    EXPECT_OK(builder->Add(IntValue(i)));
+  }
+  EXPECT_EQ(builder->Size(), 8);
+  auto value = std::move(*builder).Build();
+  EXPECT_THAT(value.Size(), IsOkAndHolds(8));
+  EXPECT_EQ(value.DebugString(), "[0, 1, 2, 3, 4, 5, 6, 7]");
+}
+
 TEST_P(TypeReflectorTest, NewMapValueBuilderCoverage_DynamicDynamic) {
   ASSERT_OK_AND_ASSIGN(auto builder,
                        value_manager().NewMapValueBuilder(
@@ -237,6 +250,44 @@ TEST_P(TypeReflectorTest, NewMapValueBuilderCoverage_DynamicStatic) {
   EXPECT_EQ(value.DebugString(), "{true: 0}");
 }
 
+TEST_P(TypeReflectorTest, NewMapValueBuilderCoverage_SmallMapLookup) {
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       value_manager().NewMapValueBuilder(
+                           type_factory().CreateMapType(IntType(), IntType())));
+  for (int64_t i = 0; i < 4; ++i) {
+    EXPECT_OK(builder->Put(IntValue(i), IntValue(i * 2)));
+  }
+  auto value = std::move(*builder).Build();
+  EXPECT_THAT(value.Size(), IsOkAndHolds(4));
+  ASSERT_OK_AND_ASSIGN(auto found, value.Get(value_manager(), IntValue(3)));
+  EXPECT_TRUE(InstanceOf<IntValue>(found));
+  EXPECT_EQ(Cast<IntValue>(found).NativeValue(), 6);
+  ASSERT_OK_AND_ASSIGN(auto has, value.Has(value_manager(), IntValue(7)));
+  EXPECT_TRUE(InstanceOf<BoolValue>(has));
+  EXPECT_FALSE(Cast<BoolValue>(has).NativeValue());
+  EXPECT_EQ(value.DebugString(), "{0: 0, 1: 2, 2: 4, 3: 6}");
+}
+
+TEST_P(TypeReflectorTest, NewMapValueBuilderCoverage_LargeMapLookup) {
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       value_manager().NewMapValueBuilder(
+                           type_factory().CreateMapType(IntType(), IntType())));
+  constexpr int64_t kEntries = 32;
+  builder->Reserve(kEntries);
+  for (int64_t i = 0; i < kEntries; ++i) {
+    EXPECT_OK(builder->Put(IntValue(i), IntValue(i * 2)));
+  }
+  auto value = std::move(*builder).Build();
+  EXPECT_THAT(value.Size(), IsOkAndHolds(kEntries));
+  ASSERT_OK_AND_ASSIGN(auto found, value.Get(value_manager(), IntValue(31)));
+  EXPECT_TRUE(InstanceOf<IntValue>(found));
+  EXPECT_EQ(Cast<IntValue>(found).NativeValue(), 62);
+  ASSERT_OK_AND_ASSIGN(auto has,
+                       value.Has(value_manager(), IntValue(kEntries)));
+  EXPECT_TRUE(InstanceOf<BoolValue>(has));
+  EXPECT_FALSE(Cast<BoolValue>(has).NativeValue());
+}
+
 TEST_P(TypeReflectorTest, JsonKeyCoverage) {
   ASSERT_OK_AND_ASSIGN(auto builder, value_manager().NewMapValueBuilder(MapType(
                                          type_factory().GetDynDynMapType())));
@@ -358,6 +358,17 @@ absl::StatusOr<Value> ListValue::Get(ValueManager& value_manager,
   return result;
 }
 
+absl::StatusOr<size_t> ListValue::GetChunk(ValueManager& value_manager,
+                                           size_t index,
+                                           absl::Span<Value> out) const {
+  return absl::visit(
+      [&value_manager, index,
+       out](const auto& alternative) -> absl::StatusOr<size_t> {
+        return alternative.GetChunk(value_manager, index, out);
+      },
+      variant_);
+}
+
 absl::Status ListValue::ForEach(ValueManager& value_manager,
                                 ForEachCallback callback) const {
   return absl::visit(
@@ -598,6 +598,11 @@ inline absl::Status ParsedListValue::Get(ValueManager& value_manager,
   return interface_->Get(value_manager, index, result);
 }
 
+inline absl::StatusOr<size_t> ParsedListValue::GetChunk(
+    ValueManager& value_manager, size_t index, absl::Span<Value> out) const {
+  return interface_->GetChunk(value_manager, index, out);
+}
+
 inline absl::Status ParsedListValue::ForEach(ValueManager& value_manager,
                                              ForEachCallback callback) const {
   return interface_->ForEach(value_manager, callback);
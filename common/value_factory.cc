@@ -25,11 +25,14 @@
 #include "absl/base/attributes.h"
 #include "absl/base/nullability.h"
 #include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/node_hash_set.h"
 #include "absl/functional/overload.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "absl/types/optional.h"
 #include "absl/types/variant.h"
@@ -297,6 +300,12 @@ Value ValueFactory::CreateValueFromJson(Json json) {
       std::move(json));
 }
 
+absl::StatusOr<Value> ValueFactory::CreateValueFromJsonText(
+    absl::string_view json_text) {
+  CEL_ASSIGN_OR_RETURN(Json json, ParseJson(json_text));
+  return CreateValueFromJson(std::move(json));
+}
+
 ListValue ValueFactory::CreateListValueFromJsonArray(JsonArray json) {
   if (json.empty()) {
     return ListValue(GetZeroDynListValue());
@@ -411,6 +420,46 @@ absl::StatusOr<BytesValue> ValueFactory::CreateBytesValue(std::string value) {
   }
 }
 
+namespace {
+
+// Process-wide immortal pool backing ValueFactory::InternStringValue.
+//
+// node_hash_set gives the pooled strings stable addresses, so every interned
+// StringValue for the same contents is an ArenaString view of one buffer and
+// equality between interned values reduces to pointer identity. Entries are
+// deliberately never freed; the pool is bounded in practice by the universe
+// of small enum-like strings fed through it.
+class InternedStringPool final {
+ public:
+  static InternedStringPool* Get() {
+    static InternedStringPool* pool = new InternedStringPool();
+    return pool;
+  }
+
+  absl::string_view Intern(absl::string_view value) {
+    absl::MutexLock lock(&mutex_);
+    return *strings_.emplace(value).first;
+  }
+
+ private:
+  absl::Mutex mutex_;
+  absl::node_hash_set<std::string> strings_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Strings longer than this are not worth pooling: they are unlikely to be
+// enum-like and would grow the immortal pool without bound.
+constexpr size_t kMaxInternedStringSize = 256;
+
+}  // namespace
+
+StringValue ValueFactory::InternStringValue(absl::string_view value) {
+  if (value.size() > kMaxInternedStringSize) {
+    return CreateUncheckedStringValue(value);
+  }
+  return StringValue(
+      common_internal::ArenaString(InternedStringPool::Get()->Intern(value)));
+}
+
 StringValue ValueFactory::CreateUncheckedStringValue(std::string value) {
   auto memory_manager = GetMemoryManager();
   switch (memory_manager.memory_management()) {
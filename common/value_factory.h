@@ -43,6 +43,11 @@ class ValueFactory : public virtual TypeFactory {
   // JSON value `json`.
   Value CreateValueFromJson(Json json);
 
+  // `CreateValueFromJsonText` parses the JSON text `json_text` and constructs
+  // a new `Value` that is equivalent to it. Elements of arrays and objects
+  // are converted lazily, on access.
+  absl::StatusOr<Value> CreateValueFromJsonText(absl::string_view json_text);
+
   // `CreateListValueFromJsonArray` constructs a new `ListValue` that is
   // equivalent to the JSON array `JsonArray`.
   ListValue CreateListValueFromJsonArray(JsonArray json);
@@ -155,6 +160,14 @@ class ValueFactory : public virtual TypeFactory {
         absl::MakeCordFromExternal(value, std::forward<Releaser>(releaser)));
   }
 
+  // Returns a `StringValue` canonicalized through a process-wide immortal
+  // string pool. Repeated interning of equal contents yields values sharing
+  // one storage, so equality between them short-circuits on pointer
+  // identity. Intended for small enum-like strings bound over and over
+  // (labels, region names); strings longer than 256 bytes are returned as
+  // ordinary uninterned copies. Pool entries are never freed.
+  StringValue InternStringValue(absl::string_view value);
+
   absl::StatusOr<DurationValue> CreateDurationValue(absl::Duration value);
 
   DurationValue CreateUncheckedDurationValue(absl::Duration value) {
@@ -183,6 +196,11 @@ class ValueFactory : public virtual TypeFactory {
 
   UnknownValue CreateUnknownValue(AttributeSet attribute_set,
                                   FunctionResultSet function_result_set) {
+    if (attribute_set.empty() && function_result_set.empty()) {
+      // The default-constructed representation shares empty singletons, so
+      // empty unknowns (used as sentinels by some callers) allocate nothing.
+      return UnknownValue{Unknown{}};
+    }
     return UnknownValue{
         Unknown{std::move(attribute_set), std::move(function_result_set)}};
   }
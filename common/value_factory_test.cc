@@ -311,6 +311,23 @@ TEST_P(ValueFactoryTest, OptionalType) {
             ProcessLocalTypeCache::Get()->GetDynOptionalType());
 }
 
+TEST_P(ValueFactoryTest, InternStringValue) {
+  StringValue first = value_factory().InternStringValue("ALLOW");
+  StringValue second = value_factory().InternStringValue("ALLOW");
+
+  // Interned values for equal contents share one immortal storage.
+  ASSERT_TRUE(first.TryFlat().has_value());
+  ASSERT_TRUE(second.TryFlat().has_value());
+  EXPECT_EQ(first.TryFlat()->data(), second.TryFlat()->data());
+  EXPECT_TRUE(first.Equals(second));
+  EXPECT_FALSE(first.Equals(value_factory().InternStringValue("DENY")));
+
+  // Strings above the interning bound are returned as ordinary copies.
+  std::string long_string(1024, 'x');
+  StringValue uninterned = value_factory().InternStringValue(long_string);
+  EXPECT_TRUE(uninterned.Equals(value_factory().InternStringValue(long_string)));
+}
+
 INSTANTIATE_TEST_SUITE_P(
     ValueFactoryTest, ValueFactoryTest,
     ::testing::Combine(::testing::Values(MemoryManagement::kPooling,
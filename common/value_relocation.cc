@@ -0,0 +1,168 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/value_relocation.h"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "common/casting.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "common/value_manager.h"
+#include "internal/status_macros.h"
+
+namespace cel {
+
+namespace {
+
+absl::StatusOr<Value> RelocateString(ValueManager& value_manager,
+                                     const StringValue& string_value) {
+  std::string scratch;
+  return value_manager.CreateUncheckedStringValue(
+      std::string(string_value.NativeString(scratch)));
+}
+
+absl::StatusOr<Value> RelocateBytes(ValueManager& value_manager,
+                                    const BytesValue& bytes_value) {
+  std::string scratch;
+  CEL_ASSIGN_OR_RETURN(
+      auto relocated,
+      value_manager.CreateBytesValue(
+          std::string(bytes_value.NativeString(scratch))));
+  return relocated;
+}
+
+absl::StatusOr<Value> RelocateList(ValueManager& value_manager,
+                                   const ListValue& list_value) {
+  CEL_ASSIGN_OR_RETURN(auto builder,
+                       value_manager.NewListValueBuilder(
+                           value_manager.CreateListType(DynType())));
+  CEL_ASSIGN_OR_RETURN(size_t size, list_value.Size());
+  builder->Reserve(size);
+  CEL_RETURN_IF_ERROR(list_value.ForEach(
+      value_manager, [&](const Value& element) -> absl::StatusOr<bool> {
+        CEL_ASSIGN_OR_RETURN(auto relocated,
+                             RelocateValue(value_manager, element));
+        CEL_RETURN_IF_ERROR(builder->Add(std::move(relocated)));
+        return true;
+      }));
+  return std::move(*builder).Build();
+}
+
+absl::StatusOr<Value> RelocateMap(ValueManager& value_manager,
+                                  const MapValue& map_value) {
+  CEL_ASSIGN_OR_RETURN(auto builder, value_manager.NewMapValueBuilder(
+                                         value_manager.GetDynDynMapType()));
+  CEL_ASSIGN_OR_RETURN(size_t size, map_value.Size());
+  builder->Reserve(size);
+  CEL_RETURN_IF_ERROR(map_value.ForEach(
+      value_manager,
+      [&](const Value& key, const Value& entry) -> absl::StatusOr<bool> {
+        CEL_ASSIGN_OR_RETURN(auto relocated_key,
+                             RelocateValue(value_manager, key));
+        CEL_ASSIGN_OR_RETURN(auto relocated_entry,
+                             RelocateValue(value_manager, entry));
+        CEL_RETURN_IF_ERROR(
+            builder->Put(std::move(relocated_key), std::move(relocated_entry)));
+        return true;
+      }));
+  return std::move(*builder).Build();
+}
+
+absl::StatusOr<Value> RelocateStruct(ValueManager& value_manager,
+                                     const StructValue& struct_value) {
+  std::string name(struct_value.GetTypeName());
+  CEL_ASSIGN_OR_RETURN(auto builder, value_manager.NewValueBuilder(name));
+  if (!builder.has_value()) {
+    return absl::FailedPreconditionError(absl::StrCat(
+        "cannot relocate struct value: no builder for type: ", name));
+  }
+  CEL_RETURN_IF_ERROR(struct_value.ForEachField(
+      value_manager,
+      [&](absl::string_view field, const Value& field_value)
+          -> absl::StatusOr<bool> {
+        CEL_ASSIGN_OR_RETURN(auto relocated,
+                             RelocateValue(value_manager, field_value));
+        CEL_RETURN_IF_ERROR(
+            (*builder)->SetFieldByName(field, std::move(relocated)));
+        return true;
+      }));
+  return std::move(**builder).Build();
+}
+
+absl::StatusOr<Value> RelocateOpaque(ValueManager& value_manager,
+                                     const Value& opaque_value) {
+  if (auto optional_value = As<OptionalValue>(opaque_value); optional_value) {
+    if (!optional_value->HasValue()) {
+      return Value(OptionalValue::None());
+    }
+    CEL_ASSIGN_OR_RETURN(auto relocated,
+                         RelocateValue(value_manager, optional_value->Value()));
+    return Value(OptionalValue::Of(value_manager.GetMemoryManager(),
+                                   std::move(relocated)));
+  }
+  return absl::UnimplementedError(
+      absl::StrCat("cannot relocate opaque value: ",
+                   Cast<OpaqueValue>(opaque_value).GetTypeName()));
+}
+
+}  // namespace
+
+absl::StatusOr<Value> RelocateValue(ValueManager& value_manager,
+                                    const Value& value) {
+  switch (value.kind()) {
+    case ValueKind::kNull:
+    case ValueKind::kBool:
+    case ValueKind::kInt:
+    case ValueKind::kUint:
+    case ValueKind::kDouble:
+    case ValueKind::kDuration:
+    case ValueKind::kTimestamp:
+      // Inline representations; nothing references external memory.
+      return value;
+    case ValueKind::kError:
+      // absl::Status owns its message and payloads.
+      return value;
+    case ValueKind::kUnknown:
+      // Unknown sets own their attribute and function result storage.
+      return value;
+    case ValueKind::kType:
+      // Types are owned by type pools that outlive programs.
+      return value;
+    case ValueKind::kString:
+      return RelocateString(value_manager, Cast<StringValue>(value));
+    case ValueKind::kBytes:
+      return RelocateBytes(value_manager, Cast<BytesValue>(value));
+    case ValueKind::kList:
+      return RelocateList(value_manager, value.As<ListValue>());
+    case ValueKind::kMap:
+      return RelocateMap(value_manager, value.As<MapValue>());
+    case ValueKind::kStruct:
+      return RelocateStruct(value_manager, value.As<StructValue>());
+    case ValueKind::kOpaque:
+      return RelocateOpaque(value_manager, value);
+    default:
+      return absl::InternalError(absl::StrCat(
+          "unexpected value kind: ", ValueKindToString(value.kind())));
+  }
+}
+
+}  // namespace cel
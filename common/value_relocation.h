@@ -0,0 +1,42 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_COMMON_VALUE_RELOCATION_H_
+#define THIRD_PARTY_CEL_CPP_COMMON_VALUE_RELOCATION_H_
+
+#include "absl/status/statusor.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+
+namespace cel {
+
+// Re-creates `value` using memory owned by `value_manager` in a single pass,
+// so the result and its transitive children no longer reference memory owned
+// by the evaluation that produced them (for example a per-evaluation arena
+// that is about to be reset or reused).
+//
+// Values with inline or self-owning representations (numerics, bool, null,
+// duration, timestamp, errors, unknowns, types) are returned as-is. String
+// and bytes contents are copied into the target manager. Lists, maps,
+// optionals and structs are rebuilt through the target manager's builders
+// with their children relocated recursively; struct relocation requires the
+// target manager's type reflector to provide a builder for the struct's type
+// and fails with FAILED_PRECONDITION otherwise. Opaque values other than
+// optionals cannot be relocated and fail with UNIMPLEMENTED.
+absl::StatusOr<Value> RelocateValue(ValueManager& value_manager,
+                                    const Value& value);
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_COMMON_VALUE_RELOCATION_H_
@@ -0,0 +1,149 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/value_relocation.h"
+
+#include <utility>
+
+#include "absl/status/status.h"
+#include "base/type_provider.h"
+#include "common/casting.h"
+#include "common/memory.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "common/values/legacy_value_manager.h"
+#include "internal/testing.h"
+
+namespace cel {
+namespace {
+
+using cel::internal::IsOkAndHolds;
+
+class ValueRelocationTest : public testing::Test {
+ public:
+  ValueRelocationTest()
+      : source_manager_(MemoryManagerRef::ReferenceCounting(),
+                        TypeProvider::Builtin()),
+        target_manager_(MemoryManagerRef::ReferenceCounting(),
+                        TypeProvider::Builtin()) {}
+
+ protected:
+  common_internal::LegacyValueManager source_manager_;
+  common_internal::LegacyValueManager target_manager_;
+};
+
+TEST_F(ValueRelocationTest, ScalarsPassThrough) {
+  ASSERT_OK_AND_ASSIGN(
+      Value relocated,
+      RelocateValue(target_manager_, source_manager_.CreateIntValue(42)));
+  ASSERT_TRUE(InstanceOf<IntValue>(relocated));
+  EXPECT_EQ(Cast<IntValue>(relocated).NativeValue(), 42);
+
+  ASSERT_OK_AND_ASSIGN(relocated,
+                       RelocateValue(target_manager_, BoolValue(true)));
+  ASSERT_TRUE(InstanceOf<BoolValue>(relocated));
+  EXPECT_TRUE(Cast<BoolValue>(relocated).NativeValue());
+}
+
+TEST_F(ValueRelocationTest, StringContentCopied) {
+  Value source = source_manager_.CreateUncheckedStringValue(
+      "a string long enough to not be stored inline in the handle");
+
+  ASSERT_OK_AND_ASSIGN(Value relocated,
+                       RelocateValue(target_manager_, source));
+  ASSERT_TRUE(InstanceOf<StringValue>(relocated));
+  EXPECT_TRUE(Cast<StringValue>(relocated).Equals(
+      "a string long enough to not be stored inline in the handle"));
+}
+
+TEST_F(ValueRelocationTest, ListRebuiltRecursively) {
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       source_manager_.NewListValueBuilder(
+                           source_manager_.CreateListType(DynType())));
+  ASSERT_OK(builder->Add(source_manager_.CreateIntValue(1)));
+  ASSERT_OK(builder->Add(source_manager_.CreateUncheckedStringValue("two")));
+  Value source = std::move(*builder).Build();
+
+  ASSERT_OK_AND_ASSIGN(Value relocated,
+                       RelocateValue(target_manager_, source));
+  ASSERT_TRUE(relocated.Is<ListValue>());
+  ListValue list_value = relocated.As<ListValue>();
+  EXPECT_THAT(list_value.Size(), IsOkAndHolds(2));
+
+  ASSERT_OK_AND_ASSIGN(Value element, list_value.Get(target_manager_, 0));
+  ASSERT_TRUE(InstanceOf<IntValue>(element));
+  EXPECT_EQ(Cast<IntValue>(element).NativeValue(), 1);
+  ASSERT_OK_AND_ASSIGN(element, list_value.Get(target_manager_, 1));
+  ASSERT_TRUE(InstanceOf<StringValue>(element));
+  EXPECT_TRUE(Cast<StringValue>(element).Equals("two"));
+}
+
+TEST_F(ValueRelocationTest, MapRebuiltRecursively) {
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       source_manager_.NewMapValueBuilder(
+                           source_manager_.GetDynDynMapType()));
+  ASSERT_OK(builder->Put(source_manager_.CreateUncheckedStringValue("a"),
+                         source_manager_.CreateIntValue(1)));
+  Value source = std::move(*builder).Build();
+
+  ASSERT_OK_AND_ASSIGN(Value relocated,
+                       RelocateValue(target_manager_, source));
+  ASSERT_TRUE(relocated.Is<MapValue>());
+  MapValue map_value = relocated.As<MapValue>();
+  EXPECT_THAT(map_value.Size(), IsOkAndHolds(1));
+
+  ASSERT_OK_AND_ASSIGN(
+      Value entry,
+      map_value.Get(target_manager_,
+                    target_manager_.CreateUncheckedStringValue("a")));
+  ASSERT_TRUE(InstanceOf<IntValue>(entry));
+  EXPECT_EQ(Cast<IntValue>(entry).NativeValue(), 1);
+}
+
+TEST_F(ValueRelocationTest, OptionalRebuilt) {
+  Value source = Value(OptionalValue::Of(
+      source_manager_.GetMemoryManager(),
+      source_manager_.CreateUncheckedStringValue("present")));
+
+  ASSERT_OK_AND_ASSIGN(Value relocated,
+                       RelocateValue(target_manager_, source));
+  auto optional_value = As<OptionalValue>(relocated);
+  ASSERT_TRUE(optional_value.has_value());
+  ASSERT_TRUE(optional_value->HasValue());
+  ASSERT_TRUE(InstanceOf<StringValue>(optional_value->Value()));
+  EXPECT_TRUE(Cast<StringValue>(optional_value->Value()).Equals("present"));
+
+  ASSERT_OK_AND_ASSIGN(relocated,
+                       RelocateValue(target_manager_, Value(OptionalValue::None())));
+  optional_value = As<OptionalValue>(relocated);
+  ASSERT_TRUE(optional_value.has_value());
+  EXPECT_FALSE(optional_value->HasValue());
+}
+
+TEST_F(ValueRelocationTest, ErrorAndUnknownPassThrough) {
+  ASSERT_OK_AND_ASSIGN(
+      Value relocated,
+      RelocateValue(target_manager_,
+                    ErrorValue(absl::InternalError("test error"))));
+  ASSERT_TRUE(InstanceOf<ErrorValue>(relocated));
+  EXPECT_EQ(Cast<ErrorValue>(relocated).NativeValue().message(), "test error");
+
+  ASSERT_OK_AND_ASSIGN(relocated,
+                       RelocateValue(target_manager_, UnknownValue()));
+  EXPECT_TRUE(InstanceOf<UnknownValue>(relocated));
+}
+
+}  // namespace
+}  // namespace cel
@@ -14,6 +14,7 @@
 
 #include "common/values/legacy_list_value.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <string>
@@ -27,6 +28,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "common/any.h"
 #include "common/casting.h"
 #include "common/json.h"
@@ -237,6 +239,22 @@ absl::Status LegacyListValue::Get(ValueManager& value_manager, size_t index,
   return (*legacy_list_value_vtable.get)(impl_, value_manager, index, result);
 }
 
+absl::StatusOr<size_t> LegacyListValue::GetChunk(ValueManager& value_manager,
+                                                 size_t index,
+                                                 absl::Span<Value> out) const {
+  InitializeLegacyListValue();
+  const size_t size = (*legacy_list_value_vtable.size)(impl_);
+  if (index >= size) {
+    return size_t{0};
+  }
+  const size_t count = std::min(out.size(), size - index);
+  for (size_t i = 0; i < count; ++i) {
+    CEL_RETURN_IF_ERROR(
+        (*legacy_list_value_vtable.get)(impl_, value_manager, index + i, out[i]));
+  }
+  return count;
+}
+
 absl::Status LegacyListValue::ForEach(ValueManager& value_manager,
                                       ForEachCallback callback) const {
   return ForEach(
@@ -28,6 +28,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "common/any.h"
 #include "common/json.h"
 #include "common/type.h"
@@ -113,6 +114,12 @@ class LegacyListValue final {
   absl::Status Get(ValueManager& value_manager, size_t index,
                    Value& result) const;
 
+  // See ListValue::GetChunk for documentation. Legacy lists resolve each
+  // element through the vtable, so this saves the per-element wrapper
+  // dispatch only.
+  absl::StatusOr<size_t> GetChunk(ValueManager& value_manager, size_t index,
+                                  absl::Span<Value> out) const;
+
   using ForEachCallback = typename ListValueInterface::ForEachCallback;
 
   using ForEachWithIndexCallback =
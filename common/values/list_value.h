@@ -35,6 +35,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "absl/types/variant.h"
 #include "common/any.h"
 #include "common/casting.h"
@@ -153,6 +154,13 @@ class ListValue final {
                    Value& result) const;
   absl::StatusOr<Value> Get(ValueManager& value_manager, size_t index) const;
 
+  // Copies up to `out.size()` elements starting at `index` into `out` and
+  // returns the number copied, which is zero once `index` reaches the end of
+  // the list. One call fetches the whole run, so bulk consumers such as
+  // comprehension loops avoid a dispatch per element.
+  absl::StatusOr<size_t> GetChunk(ValueManager& value_manager, size_t index,
+                                  absl::Span<Value> out) const;
+
   using ForEachCallback = typename ListValueInterface::ForEachCallback;
 
   using ForEachWithIndexCallback =
@@ -21,6 +21,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
+#include "absl/types/span.h"
 #include "common/any.h"
 #include "common/casting.h"
 #include "common/json.h"
@@ -53,6 +54,18 @@ class ListValueTest : public common_internal::ThreadCompatibleValueTest<> {
   ListType GetIntListType() {
     return type_factory().CreateListType(IntTypeView());
   }
+
+  template <typename... Args>
+  absl::StatusOr<ListValue> NewDynListValue(Args&&... args) {
+    CEL_ASSIGN_OR_RETURN(auto builder, value_manager().NewListValueBuilder(
+                                           GetDynListType()));
+    (static_cast<void>(builder->Add(std::forward<Args>(args))), ...);
+    return std::move(*builder).Build();
+  }
+
+  ListType GetDynListType() {
+    return type_factory().CreateListType(DynTypeView());
+  }
 };
 
 TEST_P(ListValueTest, Default) {
@@ -120,6 +133,48 @@ TEST_P(ListValueTest, Get) {
               StatusIs(absl::StatusCode::kInvalidArgument));
 }
 
+TEST_P(ListValueTest, GetChunk) {
+  ASSERT_OK_AND_ASSIGN(auto value,
+                       NewIntListValue(IntValue(0), IntValue(1), IntValue(2)));
+  std::vector<Value> chunk(2);
+  ASSERT_OK_AND_ASSIGN(auto count,
+                       value.GetChunk(value_manager(), 0, absl::MakeSpan(chunk)));
+  ASSERT_EQ(count, 2);
+  EXPECT_EQ(Cast<IntValue>(chunk[0]).NativeValue(), 0);
+  EXPECT_EQ(Cast<IntValue>(chunk[1]).NativeValue(), 1);
+  // A chunk that extends past the end is truncated; past-the-end reads are
+  // empty.
+  ASSERT_OK_AND_ASSIGN(count,
+                       value.GetChunk(value_manager(), 2, absl::MakeSpan(chunk)));
+  ASSERT_EQ(count, 1);
+  EXPECT_EQ(Cast<IntValue>(chunk[0]).NativeValue(), 2);
+  EXPECT_THAT(value.GetChunk(value_manager(), 3, absl::MakeSpan(chunk)),
+              IsOkAndHolds(0));
+}
+
+TEST_P(ListValueTest, HomogeneousDynList) {
+  // A dyn-typed builder whose elements all share one primitive kind produces
+  // the typed representation; behavior is indistinguishable from the boxed
+  // one.
+  ASSERT_OK_AND_ASSIGN(auto value,
+                       NewDynListValue(IntValue(0), IntValue(1), IntValue(2)));
+  EXPECT_THAT(value.Size(), IsOkAndHolds(3));
+  ASSERT_OK_AND_ASSIGN(auto element, value.Get(value_manager(), 1));
+  ASSERT_TRUE(InstanceOf<IntValue>(element));
+  EXPECT_EQ(Cast<IntValue>(element).NativeValue(), 1);
+  EXPECT_EQ(value.DebugString(), "[0, 1, 2]");
+}
+
+TEST_P(ListValueTest, HeterogeneousDynList) {
+  ASSERT_OK_AND_ASSIGN(
+      auto value,
+      NewDynListValue(IntValue(0), DoubleValue(1.5), BoolValue(true)));
+  EXPECT_THAT(value.Size(), IsOkAndHolds(3));
+  ASSERT_OK_AND_ASSIGN(auto element, value.Get(value_manager(), 1));
+  ASSERT_TRUE(InstanceOf<DoubleValue>(element));
+  EXPECT_EQ(Cast<DoubleValue>(element).NativeValue(), 1.5);
+}
+
 TEST_P(ListValueTest, ForEach) {
   ASSERT_OK_AND_ASSIGN(auto value,
                        NewIntListValue(IntValue(0), IntValue(1), IntValue(2)));
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <cstddef>
 #include <memory>
 
@@ -21,6 +22,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "common/casting.h"
 #include "common/value.h"
 #include "common/values/values.h"
@@ -75,6 +77,19 @@ absl::Status ParsedListValueInterface::Get(ValueManager& value_manager,
   return GetImpl(value_manager, index, result);
 }
 
+absl::StatusOr<size_t> ParsedListValueInterface::GetChunk(
+    ValueManager& value_manager, size_t index, absl::Span<Value> out) const {
+  const size_t size = Size();
+  if (index >= size) {
+    return size_t{0};
+  }
+  const size_t count = std::min(out.size(), size - index);
+  for (size_t i = 0; i < count; ++i) {
+    CEL_RETURN_IF_ERROR(GetImpl(value_manager, index + i, out[i]));
+  }
+  return count;
+}
+
 absl::Status ParsedListValueInterface::ForEach(ValueManager& value_manager,
                                                ForEachCallback callback) const {
   return ForEach(
@@ -37,6 +37,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "common/any.h"
 #include "common/casting.h"
 #include "common/json.h"
@@ -84,6 +85,13 @@ class ParsedListValueInterface : public ListValueInterface {
   absl::Status Get(ValueManager& value_manager, size_t index,
                    Value& result) const;
 
+  // See ListValue::GetChunk for documentation. The default implementation
+  // fills `out` element by element; implementations with contiguous storage
+  // should override it with a direct copy.
+  virtual absl::StatusOr<size_t> GetChunk(ValueManager& value_manager,
+                                          size_t index,
+                                          absl::Span<Value> out) const;
+
   virtual absl::Status ForEach(ValueManager& value_manager,
                                ForEachCallback callback) const;
 
@@ -183,6 +191,10 @@ class ParsedListValue {
   absl::Status Get(ValueManager& value_manager, size_t index,
                    Value& result) const;
 
+  // See ListValue::GetChunk for documentation.
+  absl::StatusOr<size_t> GetChunk(ValueManager& value_manager, size_t index,
+                                  absl::Span<Value> out) const;
+
   using ForEachCallback = typename ListValueInterface::ForEachCallback;
 
   using ForEachWithIndexCallback =
@@ -117,7 +117,7 @@ bool StringValue::IsEmpty() const {
       [](const auto& alternative) -> bool { return alternative.empty(); });
 }
 
-bool StringValue::Equals(absl::string_view string) const {
+bool StringValue::EqualsSlow(absl::string_view string) const {
   return NativeValue([string](const auto& alternative) -> bool {
     return alternative == string;
   });
@@ -129,7 +129,7 @@ bool StringValue::Equals(const absl::Cord& string) const {
   });
 }
 
-bool StringValue::Equals(const StringValue& string) const {
+bool StringValue::EqualsSlow(const StringValue& string) const {
   return string.NativeValue(
       [this](const auto& alternative) -> bool { return Equals(alternative); });
 }
@@ -154,7 +154,7 @@ int CompareImpl(const absl::Cord& lhs, const absl::Cord& rhs) {
 
 }  // namespace
 
-int StringValue::Compare(absl::string_view string) const {
+int StringValue::CompareSlow(absl::string_view string) const {
   return NativeValue([string](const auto& alternative) -> int {
     return CompareImpl(alternative, string);
   });
@@ -166,7 +166,7 @@ int StringValue::Compare(const absl::Cord& string) const {
   });
 }
 
-int StringValue::Compare(const StringValue& string) const {
+int StringValue::CompareSlow(const StringValue& string) const {
   return string.NativeValue(
       [this](const auto& alternative) -> int { return Compare(alternative); });
 }
@@ -30,6 +30,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "common/any.h"
 #include "common/internal/arena_string.h"
 #include "common/internal/shared_byte_string.h"
@@ -128,6 +129,18 @@ class StringValue final {
 
   absl::Cord NativeCord() const { return value_.ToCord(); }
 
+  // Returns the contents as a contiguous view without materializing, when
+  // the underlying representation is already flat: a view-backed
+  // representation, or a cord made of a single chunk. Returns `absl::nullopt`
+  // for fragmented cords; use `NativeString` to materialize in that case.
+  //
+  // The returned view aliases this value and is invalidated by assigning to
+  // or destroying it.
+  absl::optional<absl::string_view> TryFlat() const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return value_.TryFlat();
+  }
+
   template <typename Visitor>
   std::common_type_t<std::invoke_result_t<Visitor, absl::string_view>,
                      std::invoke_result_t<Visitor, const absl::Cord&>>
@@ -144,13 +157,36 @@ class StringValue final {
 
   bool IsEmpty() const;
 
-  bool Equals(absl::string_view string) const;
+  // Equality and ordering against flat representations compare the bytes
+  // directly; only fragmented cords fall back to the out-of-line chunked
+  // comparisons.
+  bool Equals(absl::string_view string) const {
+    if (auto flat = value_.TryFlat(); flat.has_value()) {
+      return *flat == string;
+    }
+    return EqualsSlow(string);
+  }
   bool Equals(const absl::Cord& string) const;
-  bool Equals(const StringValue& string) const;
+  bool Equals(const StringValue& string) const {
+    if (auto flat = string.value_.TryFlat(); flat.has_value()) {
+      return Equals(*flat);
+    }
+    return EqualsSlow(string);
+  }
 
-  int Compare(absl::string_view string) const;
+  int Compare(absl::string_view string) const {
+    if (auto flat = value_.TryFlat(); flat.has_value()) {
+      return flat->compare(string);
+    }
+    return CompareSlow(string);
+  }
   int Compare(const absl::Cord& string) const;
-  int Compare(const StringValue& string) const;
+  int Compare(const StringValue& string) const {
+    if (auto flat = string.value_.TryFlat(); flat.has_value()) {
+      return Compare(*flat);
+    }
+    return CompareSlow(string);
+  }
 
   std::string ToString() const { return NativeString(); }
 
@@ -173,6 +209,12 @@ class StringValue final {
   friend const common_internal::SharedByteString&
   common_internal::AsSharedByteString(const StringValue& value);
 
+  bool EqualsSlow(absl::string_view string) const;
+  bool EqualsSlow(const StringValue& string) const;
+
+  int CompareSlow(absl::string_view string) const;
+  int CompareSlow(const StringValue& string) const;
+
   common_internal::SharedByteString value_;
 };
 
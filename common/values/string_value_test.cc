@@ -116,6 +116,29 @@ TEST_P(StringValueTest, HashValue) {
             absl::HashOf(absl::string_view("foo")));
 }
 
+TEST_P(StringValueTest, TryFlat) {
+  EXPECT_THAT(StringValue("foo").TryFlat(),
+              testing::Optional(absl::string_view("foo")));
+  EXPECT_THAT(StringValue(absl::Cord("foo")).TryFlat(),
+              testing::Optional(absl::string_view("foo")));
+  EXPECT_EQ(
+      StringValue(absl::MakeFragmentedCord({std::string(1024, 'a'),
+                                            std::string(1024, 'b')}))
+          .TryFlat(),
+      absl::nullopt);
+}
+
+TEST_P(StringValueTest, EqualsFragmented) {
+  StringValue fragmented(
+      absl::MakeFragmentedCord({std::string(1024, 'a'), "foo"}));
+  StringValue flat(std::string(1024, 'a') + "foo");
+  EXPECT_TRUE(fragmented.Equals(flat));
+  EXPECT_TRUE(flat.Equals(fragmented));
+  EXPECT_EQ(fragmented.Compare(flat), 0);
+  EXPECT_EQ(flat.Compare(fragmented), 0);
+  EXPECT_LT(fragmented.Compare(StringValue("b")), 0);
+}
+
 TEST_P(StringValueTest, Equality) {
   EXPECT_NE(StringValue("foo"), "bar");
   EXPECT_NE("bar", StringValue("foo"));
@@ -50,7 +50,13 @@ absl::Nonnull<const ProcessLocalValueCache*> ProcessLocalValueCache::Get() {
 }
 
 ErrorValue ProcessLocalValueCache::GetDefaultErrorValue() const {
-  return default_error_value_;
+  // `absl::Status` reference counts its representation, so copies of a single
+  // process-global error value would serialize every thread on one cache
+  // line. Each thread constructs its own replica with a distinct
+  // representation; copies then only touch thread-private state.
+  static thread_local const ErrorValue default_error_value(
+      absl::UnknownError("unknown error"));
+  return default_error_value;
 }
 
 absl::optional<ParsedListValue> ProcessLocalValueCache::GetEmptyListValue(
@@ -94,8 +100,7 @@ OptionalValue ProcessLocalValueCache::GetEmptyDynOptionalValue() const {
   return *dyn_optional_value_;
 }
 
-ProcessLocalValueCache::ProcessLocalValueCache()
-    : default_error_value_(absl::UnknownError("unknown error")) {
+ProcessLocalValueCache::ProcessLocalValueCache() {
   MemoryManagerRef memory_manager = MemoryManagerRef::Unmanaged();
   const auto& list_types = ProcessLocalTypeCache::Get()->ListTypes();
   list_values_.reserve(list_types.size());
@@ -45,6 +45,14 @@ using MapValueCacheMap = absl::flat_hash_map<MapTypeView, ParsedMapValue>;
 using OptionalValueCacheMap =
     absl::flat_hash_map<OptionalTypeView, OptionalValue>;
 
+// Process-wide cache of common values.
+//
+// The empty list, map, and optional values are allocated with
+// `MemoryManager::Unmanaged()`, so the `Shared` handles given out here carry
+// no reference count: copying them is a contention-free read no matter how
+// many threads share them. The default error value is the exception -- it
+// wraps an `absl::Status` whose representation is reference counted -- so it
+// is replicated per thread instead of shared.
 class ProcessLocalValueCache final {
  public:
   static absl::Nonnull<const ProcessLocalValueCache*> Get();
@@ -71,7 +79,6 @@ class ProcessLocalValueCache final {
 
   ProcessLocalValueCache();
 
-  const ErrorValue default_error_value_;
   ListValueCacheMap list_values_;
   MapValueCacheMap map_values_;
   OptionalValueCacheMap optional_values_;
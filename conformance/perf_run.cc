@@ -0,0 +1,301 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Performance companion to the conformance runner. Evaluates a fixed corpus
+// of expressions through the conformance service and reports nanoseconds per
+// evaluation for each. The report can be written to a baseline file with
+// --output and a later run can be compared against it with --baseline, which
+// exits non-zero if any expression regressed by more than --threshold.
+//
+// Baseline format is one entry per line, `<name> <nanos_per_eval>`, with `#`
+// comment lines ignored, so baselines diff cleanly and are trivial to consume
+// from scripts.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "google/api/expr/conformance/v1alpha1/conformance_service.pb.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "conformance/service.h"
+#include "internal/status_macros.h"
+
+ABSL_FLAG(bool, opt, false, "Enable optimizations (constant folding)");
+ABSL_FLAG(
+    bool, modern, false,
+    "Use modern cel::Value APIs implementation of the conformance service.");
+ABSL_FLAG(bool, arena, false,
+          "Use arena memory manager (default: global heap ref-counted). Only "
+          "affects the modern implementation");
+ABSL_FLAG(bool, recursive, false,
+          "Enable recursive plans. Depth limited to slightly more than the "
+          "default nesting limit.");
+ABSL_FLAG(int, iterations, 1000, "Timed evaluations per expression");
+ABSL_FLAG(int, repetitions, 5,
+          "Timing batches per expression; the fastest batch is reported to "
+          "reduce scheduling noise");
+ABSL_FLAG(std::string, output, "",
+          "File to write the timing report to (default: stdout)");
+ABSL_FLAG(std::string, baseline, "",
+          "Baseline file to compare against; regressions beyond --threshold "
+          "cause a non-zero exit");
+ABSL_FLAG(double, threshold, 1.2,
+          "Maximum allowed ratio of current to baseline nanos per evaluation "
+          "before an expression is flagged as a regression");
+
+namespace {
+
+using google::api::expr::conformance::v1alpha1::EvalRequest;
+using google::api::expr::conformance::v1alpha1::EvalResponse;
+using google::api::expr::conformance::v1alpha1::ParseRequest;
+using google::api::expr::conformance::v1alpha1::ParseResponse;
+
+struct CorpusEntry {
+  absl::string_view name;
+  absl::string_view expr;
+};
+
+// Fixed corpus exercising the major evaluator code paths. Entries are
+// append-only: renaming or removing one silently drops its baseline
+// comparison.
+constexpr CorpusEntry kCorpus[] = {
+    {"integer_math", "(3 + 4 * 5 - 6 / 2) % 7"},
+    {"fp_math", "(3.0 + 4.0 * 5.0 - 6.0 / 2.0) / 7.0"},
+    {"logic_short_circuit", "false && (1 / 0 > 0) || true"},
+    {"ternary_chain", "1 < 2 ? (2 < 3 ? 'a' : 'b') : 'c'"},
+    {"string_concat", "'hello' + ' ' + 'world' + '!'"},
+    {"string_functions",
+     "'hello world'.contains('world') && 'hello'.startsWith('he') && "
+     "'world'.endsWith('ld')"},
+    {"string_size", "size('hello world') + size('hello'.substring(1))"},
+    {"regex_matches", "'127.0.0.1'.matches(r'^\\d+\\.\\d+\\.\\d+\\.\\d+$')"},
+    {"list_literal", "[1, 2, 3, 4, 5, 6, 7, 8, 9, 10][5]"},
+    {"list_concat_in", "3 in [1, 2] + [3, 4]"},
+    {"map_literal", "{'a': 1, 'b': 2, 'c': 3}['b']"},
+    {"comprehension_exists", "[1, 2, 3, 4, 5, 6, 7, 8].exists(x, x > 7)"},
+    {"comprehension_map_filter",
+     "[1, 2, 3, 4, 5, 6, 7, 8].map(x, x * x).filter(x, x % 2 == 0)"},
+    {"nested_comprehension",
+     "[[1, 2], [3, 4], [5, 6]].all(l, l.exists(x, x % 2 == 0))"},
+    {"select_chain", "{'a': {'b': {'c': {'d': 42}}}}.a.b.c.d"},
+    {"optional_select_chain",
+     "{'a': {'b': {'c': 42}}}.?a.?b.?c.orValue(-1)"},
+    {"type_conversions", "int('42') + int(4.2) + size(string(12345))"},
+    {"timestamp_math",
+     "timestamp('2024-01-01T00:00:00Z') + duration('1h') > "
+     "timestamp('2024-01-01T00:30:00Z')"},
+    {"bytes_conversion", "size(bytes('hello')) == 5"},
+    {"heterogeneous_equality", "1 == 1.0 && 2u == 2 && !(1 == '1')"},
+};
+
+struct TimingResult {
+  std::string name;
+  int64_t nanos_per_eval;
+};
+
+// Parses once, then reports per-evaluation wall time for the fastest of
+// --repetitions batches of --iterations evaluations.
+absl::StatusOr<int64_t> TimeExpression(
+    cel_conformance::ConformanceServiceInterface& service,
+    const CorpusEntry& entry) {
+  ParseRequest parse_request;
+  parse_request.set_cel_source(std::string(entry.expr));
+  parse_request.set_source_location(std::string(entry.name));
+  ParseResponse parse_response;
+  service.Parse(parse_request, parse_response);
+  if (!parse_response.issues().empty()) {
+    // Some corpus entries need syntax the selected service configuration does
+    // not parse (e.g. optionals under the legacy service); report unsupported
+    // so the caller can skip instead of failing the whole run.
+    return absl::UnimplementedError(absl::StrCat(
+        "failed to parse corpus entry ", entry.name, ": ",
+        parse_response.issues(0).message()));
+  }
+
+  EvalRequest eval_request;
+  *eval_request.mutable_parsed_expr() = parse_response.parsed_expr();
+
+  const int iterations = std::max(absl::GetFlag(FLAGS_iterations), 1);
+  const int repetitions = std::max(absl::GetFlag(FLAGS_repetitions), 1);
+
+  // Warm up once so plan creation and lazy initialization are not timed, and
+  // fail fast on expressions that do not evaluate.
+  {
+    EvalResponse eval_response;
+    CEL_RETURN_IF_ERROR(service.Eval(eval_request, eval_response));
+    if (!eval_response.has_result()) {
+      return absl::InternalError(absl::StrCat(
+          "corpus entry ", entry.name, " produced no result"));
+    }
+  }
+
+  absl::Duration best = absl::InfiniteDuration();
+  for (int repetition = 0; repetition < repetitions; ++repetition) {
+    absl::Time start = absl::Now();
+    for (int i = 0; i < iterations; ++i) {
+      EvalResponse eval_response;
+      CEL_RETURN_IF_ERROR(service.Eval(eval_request, eval_response));
+    }
+    best = std::min(best, absl::Now() - start);
+  }
+  return absl::ToInt64Nanoseconds(best) / iterations;
+}
+
+absl::StatusOr<absl::flat_hash_map<std::string, int64_t>> ReadBaseline(
+    const std::string& path) {
+  std::ifstream in;
+  in.open(path, std::ios_base::in);
+  if (!in.is_open()) {
+    return absl::UnknownError(
+        absl::StrCat("failed to open baseline file: ", path));
+  }
+  absl::flat_hash_map<std::string, int64_t> baseline;
+  std::string line;
+  while (std::getline(in, line)) {
+    absl::string_view trimmed = absl::StripAsciiWhitespace(line);
+    if (trimmed.empty() || absl::StartsWith(trimmed, "#")) {
+      continue;
+    }
+    std::vector<absl::string_view> fields =
+        absl::StrSplit(trimmed, ' ', absl::SkipEmpty());
+    int64_t nanos = 0;
+    if (fields.size() != 2 || !absl::SimpleAtoi(fields[1], &nanos)) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("malformed baseline line: ", line));
+    }
+    baseline[std::string(fields[0])] = nanos;
+  }
+  return baseline;
+}
+
+absl::Status WriteReport(const std::vector<TimingResult>& results,
+                         const std::string& path) {
+  std::ofstream out;
+  std::ostream* sink = &std::cout;
+  if (!path.empty()) {
+    out.open(path, std::ios_base::out | std::ios_base::trunc);
+    if (!out.is_open()) {
+      return absl::UnknownError(
+          absl::StrCat("failed to open output file: ", path));
+    }
+    sink = &out;
+  }
+  *sink << "# nanos per evaluation, fastest of "
+        << absl::GetFlag(FLAGS_repetitions) << " x "
+        << absl::GetFlag(FLAGS_iterations) << " evaluations\n";
+  for (const TimingResult& result : results) {
+    *sink << result.name << " " << result.nanos_per_eval << "\n";
+  }
+  return absl::OkStatus();
+}
+
+// Returns the number of regressed expressions.
+absl::StatusOr<int> CompareAgainstBaseline(
+    const std::vector<TimingResult>& results, const std::string& path) {
+  CEL_ASSIGN_OR_RETURN(auto baseline, ReadBaseline(path));
+  const double threshold = absl::GetFlag(FLAGS_threshold);
+  int regressions = 0;
+  for (const TimingResult& result : results) {
+    auto it = baseline.find(result.name);
+    if (it == baseline.end()) {
+      std::cerr << "NEW " << result.name << " " << result.nanos_per_eval
+                << "ns (no baseline entry)\n";
+      continue;
+    }
+    const double ratio = it->second == 0
+                             ? 1.0
+                             : static_cast<double>(result.nanos_per_eval) /
+                                   static_cast<double>(it->second);
+    if (ratio > threshold) {
+      ++regressions;
+      std::cerr << "REGRESSION " << result.name << " " << it->second << "ns -> "
+                << result.nanos_per_eval << "ns (" << ratio << "x, threshold "
+                << threshold << "x)\n";
+    }
+  }
+  for (const auto& entry : baseline) {
+    if (std::none_of(results.begin(), results.end(),
+                     [&entry](const TimingResult& result) {
+                       return result.name == entry.first;
+                     })) {
+      std::cerr << "MISSING " << entry.first
+                << " (in baseline but not in this run)\n";
+    }
+  }
+  return regressions;
+}
+
+absl::Status RunCorpus() {
+  CEL_ASSIGN_OR_RETURN(auto service,
+                       cel_conformance::NewConformanceService(
+                           cel_conformance::ConformanceServiceOptions{
+                               .optimize = absl::GetFlag(FLAGS_opt),
+                               .modern = absl::GetFlag(FLAGS_modern),
+                               .arena = absl::GetFlag(FLAGS_arena),
+                               .recursive = absl::GetFlag(FLAGS_recursive)}));
+
+  std::vector<TimingResult> results;
+  results.reserve(sizeof(kCorpus) / sizeof(kCorpus[0]));
+  for (const CorpusEntry& entry : kCorpus) {
+    absl::StatusOr<int64_t> nanos = TimeExpression(*service, entry);
+    if (absl::IsUnimplemented(nanos.status())) {
+      std::cerr << "SKIP " << entry.name << ": " << nanos.status().message()
+                << "\n";
+      continue;
+    }
+    CEL_RETURN_IF_ERROR(nanos.status());
+    results.push_back({std::string(entry.name), *nanos});
+  }
+
+  CEL_RETURN_IF_ERROR(WriteReport(results, absl::GetFlag(FLAGS_output)));
+
+  const std::string baseline_path = absl::GetFlag(FLAGS_baseline);
+  if (!baseline_path.empty()) {
+    CEL_ASSIGN_OR_RETURN(int regressions,
+                         CompareAgainstBaseline(results, baseline_path));
+    if (regressions > 0) {
+      return absl::FailedPreconditionError(
+          absl::StrCat(regressions, " expression(s) regressed beyond the ",
+                       absl::GetFlag(FLAGS_threshold), "x threshold"));
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  if (absl::Status status = RunCorpus(); !status.ok()) {
+    std::cerr << status << "\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -61,16 +61,17 @@ def _conformance_test_args(modern, arena, optimize, recursive, skip_tests, dashb
         args.append("--dashboard")
     return args
 
-def _conformance_test(name, data, modern, arena, optimize, recursive, skip_tests, tags, dashboard):
+def _conformance_test(name, data, modern, arena, optimize, recursive, skip_tests, tags, dashboard, shard_count):
     native.cc_test(
         name = _conformance_test_name(name, modern, arena, optimize, recursive),
         args = _conformance_test_args(modern, arena, optimize, recursive, skip_tests, dashboard) + ["$(location " + test + ")" for test in data],
         data = data,
         deps = ["//conformance:run"],
+        shard_count = shard_count,
         tags = tags,
     )
 
-def gen_conformance_tests(name, data, dashboard = False, skip_tests_modern = [], skip_tests_legacy = [], tags = []):
+def gen_conformance_tests(name, data, dashboard = False, skip_tests_modern = [], skip_tests_legacy = [], tags = [], shard_count = 1):
     """Generates conformance tests.
 
     Args:
@@ -80,20 +81,26 @@ def gen_conformance_tests(name, data, dashboard = False, skip_tests_modern = [],
         skip_tests_legacy: tests to skip for the legacy implementation
         tags: tags added to the generated targets
         dashboard: enable dashboard mode
+        shard_count: number of processes the corpus of each generated test is
+            split across. The runner registers one gtest case per corpus entry,
+            so gtest's sharding protocol assigns cases to shards round-robin
+            over registration (file) order — deterministic for a fixed corpus —
+            and the build tool runs the shards as separate processes and merges
+            their results into a single test status and log.
     """
 
     # Modern
-    # _conformance_test(name = name, data = data, modern = True, arena = False, optimize = False, recursive = False, skip_tests = skip_tests_modern, tags = tags, dashboard = dashboard)
-    # _conformance_test(name = name, data = data, modern = True, arena = False, optimize = True, recursive = False, skip_tests = skip_tests_modern, tags = tags, dashboard = dashboard)
-    # _conformance_test(name = name, data = data, modern = True, arena = False, optimize = False, recursive = True, skip_tests = skip_tests_modern, tags = tags, dashboard = dashboard)
-    # _conformance_test(name = name, data = data, modern = True, arena = False, optimize = True, recursive = True, skip_tests = skip_tests_modern, tags = tags, dashboard = dashboard)
-    _conformance_test(name = name, data = data, modern = True, arena = True, optimize = False, recursive = False, skip_tests = skip_tests_modern, tags = tags, dashboard = dashboard)
-    _conformance_test(name = name, data = data, modern = True, arena = True, optimize = True, recursive = False, skip_tests = skip_tests_modern, tags = tags, dashboard = dashboard)
-    _conformance_test(name = name, data = data, modern = True, arena = True, optimize = False, recursive = True, skip_tests = skip_tests_modern, tags = tags, dashboard = dashboard)
-    _conformance_test(name = name, data = data, modern = True, arena = True, optimize = True, recursive = True, skip_tests = skip_tests_modern, tags = tags, dashboard = dashboard)
+    # _conformance_test(name = name, data = data, modern = True, arena = False, optimize = False, recursive = False, skip_tests = skip_tests_modern, tags = tags, dashboard = dashboard, shard_count = shard_count)
+    # _conformance_test(name = name, data = data, modern = True, arena = False, optimize = True, recursive = False, skip_tests = skip_tests_modern, tags = tags, dashboard = dashboard, shard_count = shard_count)
+    # _conformance_test(name = name, data = data, modern = True, arena = False, optimize = False, recursive = True, skip_tests = skip_tests_modern, tags = tags, dashboard = dashboard, shard_count = shard_count)
+    # _conformance_test(name = name, data = data, modern = True, arena = False, optimize = True, recursive = True, skip_tests = skip_tests_modern, tags = tags, dashboard = dashboard, shard_count = shard_count)
+    _conformance_test(name = name, data = data, modern = True, arena = True, optimize = False, recursive = False, skip_tests = skip_tests_modern, tags = tags, dashboard = dashboard, shard_count = shard_count)
+    _conformance_test(name = name, data = data, modern = True, arena = True, optimize = True, recursive = False, skip_tests = skip_tests_modern, tags = tags, dashboard = dashboard, shard_count = shard_count)
+    _conformance_test(name = name, data = data, modern = True, arena = True, optimize = False, recursive = True, skip_tests = skip_tests_modern, tags = tags, dashboard = dashboard, shard_count = shard_count)
+    _conformance_test(name = name, data = data, modern = True, arena = True, optimize = True, recursive = True, skip_tests = skip_tests_modern, tags = tags, dashboard = dashboard, shard_count = shard_count)
 
     # Legacy
-    _conformance_test(name = name, data = data, modern = False, arena = True, optimize = False, recursive = False, skip_tests = skip_tests_legacy, tags = tags, dashboard = dashboard)
-    _conformance_test(name = name, data = data, modern = False, arena = True, optimize = True, recursive = False, skip_tests = skip_tests_legacy, tags = tags, dashboard = dashboard)
-    _conformance_test(name = name, data = data, modern = False, arena = True, optimize = False, recursive = True, skip_tests = skip_tests_legacy, tags = tags, dashboard = dashboard)
-    _conformance_test(name = name, data = data, modern = False, arena = True, optimize = True, recursive = True, skip_tests = skip_tests_legacy, tags = tags, dashboard = dashboard)
+    _conformance_test(name = name, data = data, modern = False, arena = True, optimize = False, recursive = False, skip_tests = skip_tests_legacy, tags = tags, dashboard = dashboard, shard_count = shard_count)
+    _conformance_test(name = name, data = data, modern = False, arena = True, optimize = True, recursive = False, skip_tests = skip_tests_legacy, tags = tags, dashboard = dashboard, shard_count = shard_count)
+    _conformance_test(name = name, data = data, modern = False, arena = True, optimize = False, recursive = True, skip_tests = skip_tests_legacy, tags = tags, dashboard = dashboard, shard_count = shard_count)
+    _conformance_test(name = name, data = data, modern = False, arena = True, optimize = True, recursive = True, skip_tests = skip_tests_legacy, tags = tags, dashboard = dashboard, shard_count = shard_count)
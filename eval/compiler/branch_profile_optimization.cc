@@ -0,0 +1,215 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/branch_profile_optimization.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "base/ast_internal/ast_impl.h"
+#include "base/ast_internal/expr.h"
+#include "base/builtins.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/expression_step_base.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::ast_internal::AstImpl;
+using ::cel::ast_internal::Expr;
+
+// Minimum improvement in short-circuit rate required to swap, to avoid
+// reordering on noise.
+constexpr double kSwapMargin = 0.05;
+
+bool IsBinaryLogicCall(const Expr& node) {
+  return node.has_call_expr() && !node.call_expr().has_target() &&
+         node.call_expr().args().size() == 2 &&
+         (node.call_expr().function() == cel::builtin::kAnd ||
+          node.call_expr().function() == cel::builtin::kOr);
+}
+
+// Observes the boolean outcome of a logic operand without disturbing the
+// stack.
+class RecordBranchStep : public ExpressionStepBase {
+ public:
+  RecordBranchStep(int64_t expr_id, std::shared_ptr<BranchProfile> profile)
+      : ExpressionStepBase(/*expr_id=*/expr_id, /*comes_from_ast=*/false),
+        expr_id_(expr_id),
+        profile_(std::move(profile)) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    if (!frame->value_stack().HasEnough(1)) {
+      return absl::InternalError("stack underflow in branch profile step.");
+    }
+    const cel::Value& value = frame->value_stack().Peek();
+    if (value->Is<cel::BoolValue>()) {
+      profile_->RecordOutcome(expr_id_,
+                              value.As<cel::BoolValue>().NativeValue());
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  int64_t expr_id_;
+  std::shared_ptr<BranchProfile> profile_;
+};
+
+class BranchProfileRecorder : public ProgramOptimizer {
+ public:
+  explicit BranchProfileRecorder(std::shared_ptr<BranchProfile> profile)
+      : profile_(std::move(profile)) {}
+
+  absl::Status OnPreVisit(PlannerContext& context, const Expr& node) override {
+    path_.push_back(&node);
+    return absl::OkStatus();
+  }
+
+  absl::Status OnPostVisit(PlannerContext& context, const Expr& node) override {
+    if (path_.empty() || path_.back() != &node) {
+      return absl::InternalError("BranchProfileRecorder called out of order.");
+    }
+    path_.pop_back();
+
+    // Only operands of a binary logic call are recorded.
+    if (path_.empty() || !IsBinaryLogicCall(*path_.back())) {
+      return absl::OkStatus();
+    }
+    if (context.GetSubplan(node).empty()) {
+      return absl::OkStatus();
+    }
+    return context.AddSubplanStep(
+        node, std::make_unique<RecordBranchStep>(node.id(), profile_));
+  }
+
+ private:
+  std::shared_ptr<BranchProfile> profile_;
+  std::vector<const Expr*> path_;
+};
+
+class ProfileGuidedBranchReorder : public AstTransform {
+ public:
+  ProfileGuidedBranchReorder(std::shared_ptr<const BranchProfile> profile,
+                             int64_t min_samples)
+      : profile_(std::move(profile)), min_samples_(min_samples) {}
+
+  absl::Status UpdateAst(PlannerContext& context,
+                         AstImpl& ast) const override {
+    Reorder(ast.root_expr());
+    return absl::OkStatus();
+  }
+
+ private:
+  void Reorder(Expr& expr) const {
+    // Reorder children first so nested logic nodes are considered with their
+    // final operand sets.
+    if (expr.has_call_expr()) {
+      auto& call = expr.mutable_call_expr();
+      if (call.has_target()) {
+        Reorder(call.mutable_target());
+      }
+      for (Expr& arg : call.mutable_args()) {
+        Reorder(arg);
+      }
+      if (IsBinaryLogicCall(expr)) {
+        MaybeSwapOperands(expr);
+      }
+      return;
+    }
+    if (expr.has_select_expr()) {
+      Reorder(expr.mutable_select_expr().mutable_operand());
+      return;
+    }
+    if (expr.has_list_expr()) {
+      for (auto& element : expr.mutable_list_expr().mutable_elements()) {
+        Reorder(element.mutable_expr());
+      }
+      return;
+    }
+    if (expr.has_map_expr()) {
+      for (auto& entry : expr.mutable_map_expr().mutable_entries()) {
+        if (entry.has_key()) {
+          Reorder(entry.mutable_key());
+        }
+        if (entry.has_value()) {
+          Reorder(entry.mutable_value());
+        }
+      }
+      return;
+    }
+    if (expr.has_struct_expr()) {
+      for (auto& field : expr.mutable_struct_expr().mutable_fields()) {
+        if (field.has_value()) {
+          Reorder(field.mutable_value());
+        }
+      }
+      return;
+    }
+    if (expr.has_comprehension_expr()) {
+      auto& comprehension = expr.mutable_comprehension_expr();
+      Reorder(comprehension.mutable_iter_range());
+      Reorder(comprehension.mutable_accu_init());
+      Reorder(comprehension.mutable_loop_condition());
+      Reorder(comprehension.mutable_loop_step());
+      Reorder(comprehension.mutable_result());
+      return;
+    }
+  }
+
+  void MaybeSwapOperands(Expr& expr) const {
+    auto& args = expr.mutable_call_expr().mutable_args();
+    BranchProfile::Counts lhs = profile_->GetCounts(args[0].id());
+    BranchProfile::Counts rhs = profile_->GetCounts(args[1].id());
+    if (lhs.evaluated < min_samples_ || rhs.evaluated < min_samples_) {
+      return;
+    }
+
+    // The operand most likely to short-circuit should go first: `false` for
+    // `&&`, `true` for `||`.
+    const bool is_and = expr.call_expr().function() == cel::builtin::kAnd;
+    double lhs_rate = static_cast<double>(is_and ? lhs.evaluated - lhs.truthy
+                                                 : lhs.truthy) /
+                      static_cast<double>(lhs.evaluated);
+    double rhs_rate = static_cast<double>(is_and ? rhs.evaluated - rhs.truthy
+                                                 : rhs.truthy) /
+                      static_cast<double>(rhs.evaluated);
+    if (rhs_rate > lhs_rate + kSwapMargin) {
+      std::swap(args[0], args[1]);
+    }
+  }
+
+  std::shared_ptr<const BranchProfile> profile_;
+  int64_t min_samples_;
+};
+
+}  // namespace
+
+ProgramOptimizerFactory CreateBranchProfileRecorder(
+    std::shared_ptr<BranchProfile> profile) {
+  return [profile = std::move(profile)](PlannerContext&, const AstImpl&) {
+    return std::make_unique<BranchProfileRecorder>(profile);
+  };
+}
+
+std::unique_ptr<AstTransform> CreateProfileGuidedBranchReorder(
+    std::shared_ptr<const BranchProfile> profile, int64_t min_samples) {
+  return std::make_unique<ProfileGuidedBranchReorder>(std::move(profile),
+                                                      min_samples);
+}
+
+}  // namespace google::api::expr::runtime
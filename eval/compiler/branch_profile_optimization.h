@@ -0,0 +1,80 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_COMPILER_BRANCH_PROFILE_OPTIMIZATION_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_COMPILER_BRANCH_PROFILE_OPTIMIZATION_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+
+namespace google::api::expr::runtime {
+
+// Observed boolean outcomes for the operands of `&&` / `||` nodes, keyed by
+// operand expression id. Thread-safe; one instance is shared between the
+// recording extension and, later, the reordering transform for the same
+// expression (ids must come from the same AST).
+class BranchProfile {
+ public:
+  struct Counts {
+    int64_t evaluated = 0;
+    int64_t truthy = 0;
+  };
+
+  void RecordOutcome(int64_t expr_id, bool value) {
+    absl::MutexLock lock(&mu_);
+    Counts& counts = counts_[expr_id];
+    ++counts.evaluated;
+    if (value) {
+      ++counts.truthy;
+    }
+  }
+
+  Counts GetCounts(int64_t expr_id) const {
+    absl::MutexLock lock(&mu_);
+    auto it = counts_.find(expr_id);
+    return it == counts_.end() ? Counts{} : it->second;
+  }
+
+ private:
+  mutable absl::Mutex mu_;
+  absl::flat_hash_map<int64_t, Counts> counts_ ABSL_GUARDED_BY(mu_);
+};
+
+// Create a new extension for the FlatExprBuilder that records the boolean
+// outcome of every `&&` / `||` operand into `profile` during evaluation.
+// Intended for a bounded profiling phase: each observation takes a lock, so
+// this is not meant to stay enabled on serving replicas indefinitely.
+ProgramOptimizerFactory CreateBranchProfileRecorder(
+    std::shared_ptr<BranchProfile> profile);
+
+// Create an AST transform that consumes a recorded profile and swaps the
+// operands of `&&` / `||` nodes when the profile shows the second operand
+// short-circuits more often than the first, shortening the average path.
+//
+// CEL's boolean operators are commutative (there are no side effects, and
+// true/false wins over an error on either side), so reordering preserves
+// results; when both operands error, the reported error may change to the
+// other operand's. Nodes with fewer than `min_samples` observations per
+// operand are left alone.
+std::unique_ptr<AstTransform> CreateProfileGuidedBranchReorder(
+    std::shared_ptr<const BranchProfile> profile, int64_t min_samples = 100);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_COMPILER_BRANCH_PROFILE_OPTIMIZATION_H_
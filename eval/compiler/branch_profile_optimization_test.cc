@@ -0,0 +1,143 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/branch_profile_optimization.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/status.h"
+#include "eval/compiler/cel_expression_builder_flat_impl.h"
+#include "eval/compiler/flat_expr_builder.h"
+#include "eval/public/activation.h"
+#include "eval/public/builtin_func_registrar.h"
+#include "eval/public/cel_expression.h"
+#include "eval/public/cel_value.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::google::api::expr::parser::Parse;
+using testing::Contains;
+using testing::Not;
+
+namespace exprpb = google::api::expr::v1alpha1;
+
+class BranchProfileOptimizationTest : public testing::Test {
+ public:
+  void SetUp() override {
+    // a || b, with `a` almost never true in "production".
+    ASSERT_OK_AND_ASSIGN(parsed_, Parse("a || b"));
+    lhs_id_ = parsed_.expr().call_expr().args(0).id();
+    rhs_id_ = parsed_.expr().call_expr().args(1).id();
+  }
+
+ protected:
+  // Runs the expression `iterations` times with the recorder installed,
+  // accumulating outcomes into `profile`.
+  void RecordProfile(std::shared_ptr<BranchProfile> profile, int iterations) {
+    CelExpressionBuilderFlatImpl builder;
+    builder.flat_expr_builder().AddProgramOptimizer(
+        CreateBranchProfileRecorder(profile));
+    ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+    ASSERT_OK_AND_ASSIGN(
+        auto plan,
+        builder.CreateExpression(&parsed_.expr(), &parsed_.source_info()));
+
+    Activation activation;
+    activation.InsertValue("a", CelValue::CreateBool(false));
+    activation.InsertValue("b", CelValue::CreateBool(true));
+    for (int i = 0; i < iterations; ++i) {
+      google::protobuf::Arena arena;
+      ASSERT_OK_AND_ASSIGN(CelValue result, plan->Evaluate(activation, &arena));
+      ASSERT_TRUE(result.IsBool());
+      ASSERT_TRUE(result.BoolOrDie());
+    }
+  }
+
+  // Plans with the reorder transform and returns the AST-correlated expr ids
+  // observed during a traced evaluation, in order.
+  std::vector<int64_t> TraceReordered(
+      std::shared_ptr<const BranchProfile> profile, int64_t min_samples) {
+    CelExpressionBuilderFlatImpl builder;
+    builder.flat_expr_builder().AddAstTransform(
+        CreateProfileGuidedBranchReorder(profile, min_samples));
+    EXPECT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+    auto plan_or =
+        builder.CreateExpression(&parsed_.expr(), &parsed_.source_info());
+    EXPECT_OK(plan_or.status());
+
+    Activation activation;
+    activation.InsertValue("a", CelValue::CreateBool(false));
+    activation.InsertValue("b", CelValue::CreateBool(true));
+    google::protobuf::Arena arena;
+    std::vector<int64_t> trace;
+    auto status = (*plan_or)->Trace(
+        activation, &arena,
+        [&trace](int64_t expr_id, const CelValue&, google::protobuf::Arena*) {
+          trace.push_back(expr_id);
+          return absl::OkStatus();
+        });
+    EXPECT_OK(status.status());
+    return trace;
+  }
+
+  exprpb::ParsedExpr parsed_;
+  int64_t lhs_id_;
+  int64_t rhs_id_;
+};
+
+TEST_F(BranchProfileOptimizationTest, RecorderCountsOperandOutcomes) {
+  auto profile = std::make_shared<BranchProfile>();
+  RecordProfile(profile, 20);
+
+  BranchProfile::Counts lhs = profile->GetCounts(lhs_id_);
+  EXPECT_EQ(lhs.evaluated, 20);
+  EXPECT_EQ(lhs.truthy, 0);
+
+  BranchProfile::Counts rhs = profile->GetCounts(rhs_id_);
+  EXPECT_EQ(rhs.evaluated, 20);
+  EXPECT_EQ(rhs.truthy, 20);
+}
+
+TEST_F(BranchProfileOptimizationTest, ReordersTowardShortCircuit) {
+  auto profile = std::make_shared<BranchProfile>();
+  RecordProfile(profile, 20);
+
+  // `b` short-circuits `||` far more often, so it is evaluated first; with
+  // short-circuiting the old first operand is never reached at all.
+  std::vector<int64_t> trace =
+      TraceReordered(profile, /*min_samples=*/10);
+  EXPECT_THAT(trace, Contains(rhs_id_));
+  EXPECT_THAT(trace, Not(Contains(lhs_id_)));
+}
+
+TEST_F(BranchProfileOptimizationTest, InsufficientSamplesLeaveOrderAlone) {
+  auto profile = std::make_shared<BranchProfile>();
+  RecordProfile(profile, 5);
+
+  std::vector<int64_t> trace =
+      TraceReordered(profile, /*min_samples=*/100);
+  // Original order: `a` evaluates first and fails to short-circuit.
+  EXPECT_THAT(trace, Contains(lhs_id_));
+  EXPECT_THAT(trace, Contains(rhs_id_));
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
@@ -16,7 +16,11 @@
 
 #include "eval/compiler/cel_expression_builder_flat_impl.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <memory>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -26,6 +30,7 @@
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "base/ast.h"
 #include "common/native_type.h"
 #include "eval/eval/cel_expression_flat_impl.h"
@@ -35,6 +40,7 @@
 #include "extensions/protobuf/ast_converters.h"
 #include "internal/status_macros.h"
 #include "runtime/runtime_issue.h"
+#include "runtime/runtime_options.h"
 
 namespace google::api::expr::runtime {
 
@@ -81,22 +87,125 @@ CelExpressionBuilderFlatImpl::CreateExpression(
 }
 
 absl::StatusOr<std::unique_ptr<CelExpression>>
-CelExpressionBuilderFlatImpl::CreateExpressionImpl(
-    std::unique_ptr<Ast> converted_ast,
+CelExpressionBuilderFlatImpl::CreateExpressionWithUnknowns(
+    const CheckedExpr* checked_expr,
+    cel::UnknownProcessingOptions unknown_processing,
+    std::vector<absl::Status>* warnings) const {
+  ABSL_ASSERT(checked_expr != nullptr);
+  CEL_ASSIGN_OR_RETURN(
+      std::unique_ptr<Ast> converted_ast,
+      cel::extensions::CreateAstFromCheckedExpr(*checked_expr));
+
+  cel::RuntimeOptions options = flat_expr_builder_.options();
+  options.unknown_processing = unknown_processing;
+  return CreateExpressionImpl(std::move(converted_ast), warnings, &options);
+}
+
+std::vector<absl::StatusOr<std::unique_ptr<CelExpression>>>
+CelExpressionBuilderFlatImpl::CreateExpressions(
+    absl::Span<const CheckedExpr* const> checked_exprs,
+    int max_concurrency) const {
+  std::vector<absl::StatusOr<std::unique_ptr<CelExpression>>> results;
+  results.reserve(checked_exprs.size());
+  for (size_t i = 0; i < checked_exprs.size(); ++i) {
+    results.push_back(absl::UnimplementedError("expression not planned"));
+  }
+
+  if (max_concurrency <= 0) {
+    max_concurrency =
+        static_cast<int>(std::thread::hardware_concurrency());
+  }
+  size_t num_threads = std::min<size_t>(
+      checked_exprs.size(), std::max(max_concurrency, 1));
+
+  // Workers claim expressions through a shared cursor, so threads that draw
+  // cheap expressions keep the expensive ones from serializing the batch.
+  // Each result slot is written by exactly one worker.
+  std::atomic<size_t> next(0);
+  auto worker = [this, checked_exprs, &next, &results]() {
+    while (true) {
+      size_t i = next.fetch_add(1, std::memory_order_relaxed);
+      if (i >= checked_exprs.size()) {
+        return;
+      }
+      results[i] = CreateExpression(checked_exprs[i], /*warnings=*/nullptr);
+    }
+  };
+
+  if (num_threads <= 1) {
+    worker();
+    return results;
+  }
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back(worker);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return results;
+}
+
+absl::StatusOr<std::unique_ptr<CelExpression>>
+CelExpressionBuilderFlatImpl::CreateTieredExpression(
+    const CheckedExpr* checked_expr, const TieredExpressionOptions& options,
     std::vector<absl::Status>* warnings) const {
+  ABSL_ASSERT(checked_expr != nullptr);
+  if (options.promotion_threshold <= 0) {
+    return CreateExpression(checked_expr, warnings);
+  }
+
+  CEL_ASSIGN_OR_RETURN(
+      std::unique_ptr<Ast> converted_ast,
+      cel::extensions::CreateAstFromCheckedExpr(*checked_expr));
+
   std::vector<RuntimeIssue> issues;
   auto* issues_ptr = (warnings != nullptr) ? &issues : nullptr;
+  CEL_ASSIGN_OR_RETURN(FlatExpression impl,
+                       flat_expr_builder_.CreateBaselineExpressionImpl(
+                           std::move(converted_ast), issues_ptr));
+  if (issues_ptr != nullptr) {
+    for (const auto& issue : issues) {
+      warnings->push_back(issue.ToStatus());
+    }
+  }
+
+  // The re-plan goes through CreateExpression so the optimized program is
+  // exactly what non-tiered planning would produce, including plan cache
+  // participation and recursive program detection.
+  TieredCelExpression::Replanner replan =
+      [this, checked_expr_copy = CheckedExpr(*checked_expr)]()
+      -> absl::StatusOr<std::unique_ptr<CelExpression>> {
+    return CreateExpression(&checked_expr_copy, /*warnings=*/nullptr);
+  };
 
+  return std::make_unique<TieredCelExpression>(
+      std::make_unique<CelExpressionFlatImpl>(std::move(impl)),
+      std::move(replan), options);
+}
+
+absl::StatusOr<std::unique_ptr<CelExpression>>
+CelExpressionBuilderFlatImpl::CreateExpressionImpl(
+    std::unique_ptr<Ast> converted_ast, std::vector<absl::Status>* warnings,
+    const cel::RuntimeOptions* options_override) const {
+  std::vector<RuntimeIssue> issues;
+  auto* issues_ptr = (warnings != nullptr) ? &issues : nullptr;
+
+  const cel::RuntimeOptions& options = options_override != nullptr
+                                           ? *options_override
+                                           : flat_expr_builder_.options();
   CEL_ASSIGN_OR_RETURN(FlatExpression impl,
                        flat_expr_builder_.CreateExpressionImpl(
-                           std::move(converted_ast), issues_ptr));
+                           std::move(converted_ast), issues_ptr, options));
 
   if (issues_ptr != nullptr) {
     for (const auto& issue : issues) {
       warnings->push_back(issue.ToStatus());
     }
   }
-  if (flat_expr_builder_.options().max_recursion_depth != 0 &&
+  if (options.max_recursion_depth != 0 &&
       !impl.subexpressions().empty() &&
       // mainline expression is exactly one recursive step.
       impl.subexpressions().front().size() == 1 &&
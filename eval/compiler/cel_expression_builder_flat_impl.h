@@ -26,8 +26,10 @@
 #include "google/api/expr/v1alpha1/syntax.pb.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "base/ast.h"
 #include "eval/compiler/flat_expr_builder.h"
+#include "eval/compiler/tiered_expression.h"
 #include "eval/public/cel_expression.h"
 #include "runtime/runtime_options.h"
 
@@ -61,6 +63,50 @@ class CelExpressionBuilderFlatImpl : public CelExpressionBuilder {
       const google::api::expr::v1alpha1::CheckedExpr* checked_expr,
       std::vector<absl::Status>* warnings) const override;
 
+  // Plans `checked_expr` with `unknown_processing` in place of the builder's
+  // configured RuntimeOptions::unknown_processing, for this program only.
+  //
+  // This makes unknown support a per-program decision: programs planned with
+  // kDisabled skip attribute trail maintenance during evaluation, so a
+  // runtime does not have to pay the dual-stack cost across every program
+  // because a few need unknowns.
+  absl::StatusOr<std::unique_ptr<CelExpression>> CreateExpressionWithUnknowns(
+      const google::api::expr::v1alpha1::CheckedExpr* checked_expr,
+      cel::UnknownProcessingOptions unknown_processing,
+      std::vector<absl::Status>* warnings = nullptr) const;
+
+  // Plans each of `checked_exprs` and returns the results in input order.
+  //
+  // Planning is distributed over up to `max_concurrency` threads (hardware
+  // concurrency when <= 0), all sharing this builder's immutable function and
+  // type registries. A failure planning one expression is reported in the
+  // corresponding result slot and does not abort the rest of the batch.
+  //
+  // The registries and builder must not be mutated while a call is in flight.
+  // Any registered AST transforms and program optimizer factories must be safe
+  // to run concurrently; notably, constant folding backed by a shared
+  // google::protobuf::Arena is not.
+  std::vector<absl::StatusOr<std::unique_ptr<CelExpression>>>
+  CreateExpressions(
+      absl::Span<const google::api::expr::v1alpha1::CheckedExpr* const>
+          checked_exprs,
+      int max_concurrency = 0) const;
+
+  // Plans `checked_expr` as a TieredCelExpression: a baseline program built
+  // without the registered program optimizers starts serving immediately, and
+  // after `options.promotion_threshold` evaluations the expression is
+  // re-planned through the normal fully optimized path (on
+  // `options.executor` when set, otherwise inline) and swapped in.
+  //
+  // A non-positive threshold disables tiering and is equivalent to
+  // CreateExpression. `warnings` is filled from the baseline plan. When a
+  // non-null executor is supplied, this builder and its registries must
+  // outlive the re-plan.
+  absl::StatusOr<std::unique_ptr<CelExpression>> CreateTieredExpression(
+      const google::api::expr::v1alpha1::CheckedExpr* checked_expr,
+      const TieredExpressionOptions& options,
+      std::vector<absl::Status>* warnings = nullptr) const;
+
   FlatExprBuilder& flat_expr_builder() { return flat_expr_builder_; }
 
   void set_container(std::string container) override {
@@ -71,7 +117,8 @@ class CelExpressionBuilderFlatImpl : public CelExpressionBuilder {
  private:
   absl::StatusOr<std::unique_ptr<CelExpression>> CreateExpressionImpl(
       std::unique_ptr<cel::Ast> converted_ast,
-      std::vector<absl::Status>* warnings) const;
+      std::vector<absl::Status>* warnings,
+      const cel::RuntimeOptions* options_override = nullptr) const;
 
   FlatExprBuilder flat_expr_builder_;
 };
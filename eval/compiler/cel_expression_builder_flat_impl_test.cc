@@ -29,12 +29,14 @@
 #include "absl/algorithm/container.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "eval/compiler/constant_folding.h"
 #include "eval/compiler/regex_precompilation_optimization.h"
 #include "eval/eval/cel_expression_flat_impl.h"
 #include "eval/public/activation.h"
 #include "eval/public/builtin_func_registrar.h"
+#include "eval/public/cel_attribute.h"
 #include "eval/public/cel_expression.h"
 #include "eval/public/cel_function.h"
 #include "eval/public/cel_value.h"
@@ -72,6 +74,7 @@ using testing::_;
 using testing::Contains;
 using testing::HasSubstr;
 using testing::IsNull;
+using testing::Not;
 using testing::NotNull;
 using cel::internal::StatusIs;
 
@@ -251,6 +254,36 @@ TEST_P(RecursivePlanTest, ParsedExprRecursiveTraceSupport) {
   EXPECT_THAT(result, test_case.matcher);
 }
 
+TEST_P(RecursivePlanTest, TracePlanServesUntracedEvaluation) {
+  const RecursiveTestCase& test_case = GetParam();
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr, ParseWithBind(test_case.expr));
+  cel::RuntimeOptions options;
+  options.container = "google.api.expr.test.v1.proto3";
+  google::protobuf::Arena arena;
+  // Unbounded.
+  options.max_recursion_depth = -1;
+  options.enable_recursive_tracing = true;
+  CelExpressionBuilderFlatImpl builder(options);
+
+  ASSERT_OK(SetupBuilder(builder));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<CelExpression> plan,
+                       builder.CreateExpression(&parsed_expr.expr(),
+                                                &parsed_expr.source_info()));
+
+  EXPECT_THAT(dynamic_cast<const CelExpressionRecursiveImpl*>(plan.get()),
+              NotNull());
+
+  Activation activation;
+
+  ASSERT_OK(SetupActivation(activation, &arena));
+
+  // The same plan evaluates without a listener installed; tracing is a
+  // per-evaluation decision, not a separate compiled plan.
+  ASSERT_OK_AND_ASSIGN(CelValue result, plan->Evaluate(activation, &arena));
+  EXPECT_THAT(result, test_case.matcher);
+}
+
 TEST_P(RecursivePlanTest, Disabled) {
   google::protobuf::LinkMessageReflection<TestAllTypes>();
 
@@ -305,6 +338,11 @@ INSTANTIATE_TEST_SUITE_P(
          test::IsCelBool(true)},
         {"compre_map", "8 in [1, 2, 3, 4].map(x, x * 2)",
          test::IsCelBool(true)},
+        {"compre_filter", "[1, 2, 3, 4].filter(x, x > 2).size() == 2",
+         test::IsCelBool(true)},
+        {"nested_compre",
+         "[[1, 2], [3, 4]].all(l, l.exists(x, x == 2 || x == 3))",
+         test::IsCelBool(true)},
         {"map_var_compre_exists", "map_var.exists(key, key == 'b')",
          test::IsCelBool(true)},
         {"map_compre_exists", "{'a': 1, 'b': 2}.exists(k, k == 'b')",
@@ -379,6 +417,90 @@ TEST(CelExpressionBuilderFlatImplTest, CheckedExpr) {
   EXPECT_THAT(result, test::IsCelInt64(3));
 }
 
+TEST(CelExpressionBuilderFlatImplTest, CheckedExprPerProgramUnknowns) {
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr, Parse("var + 1"));
+  CheckedExpr checked_expr;
+  checked_expr.mutable_expr()->Swap(parsed_expr.mutable_expr());
+  checked_expr.mutable_source_info()->Swap(parsed_expr.mutable_source_info());
+
+  // Unknowns are disabled for the builder; only the program planned with the
+  // override pays for attribute tracking.
+  CelExpressionBuilderFlatImpl builder;
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CelExpression> unknown_plan,
+      builder.CreateExpressionWithUnknowns(
+          &checked_expr, cel::UnknownProcessingOptions::kAttributeOnly));
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<CelExpression> plain_plan,
+                       builder.CreateExpression(&checked_expr));
+
+  Activation activation;
+  activation.set_unknown_attribute_patterns({CelAttributePattern("var", {})});
+  google::protobuf::Arena arena;
+
+  ASSERT_OK_AND_ASSIGN(CelValue result,
+                       unknown_plan->Evaluate(activation, &arena));
+  EXPECT_TRUE(result.IsUnknownSet());
+
+  // Without the override the unknown pattern is ignored and the unbound
+  // variable surfaces as an error.
+  ASSERT_OK_AND_ASSIGN(result, plain_plan->Evaluate(activation, &arena));
+  EXPECT_TRUE(result.IsError());
+}
+
+TEST(CelExpressionBuilderFlatImplTest, CheckedExprBatch) {
+  constexpr int kNumExprs = 64;
+  std::vector<CheckedExpr> checked_exprs;
+  checked_exprs.reserve(kNumExprs);
+  std::vector<const CheckedExpr*> checked_expr_ptrs;
+  checked_expr_ptrs.reserve(kNumExprs);
+  for (int i = 0; i < kNumExprs; ++i) {
+    ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr,
+                         Parse(absl::StrCat(i, " + ", i)));
+    CheckedExpr& checked_expr = checked_exprs.emplace_back();
+    checked_expr.mutable_expr()->Swap(parsed_expr.mutable_expr());
+    checked_expr.mutable_source_info()->Swap(parsed_expr.mutable_source_info());
+    checked_expr_ptrs.push_back(&checked_expr);
+  }
+
+  CelExpressionBuilderFlatImpl builder;
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+
+  std::vector<absl::StatusOr<std::unique_ptr<CelExpression>>> plans =
+      builder.CreateExpressions(checked_expr_ptrs, /*max_concurrency=*/4);
+
+  ASSERT_EQ(plans.size(), kNumExprs);
+  for (int i = 0; i < kNumExprs; ++i) {
+    ASSERT_OK(plans[i]);
+    Activation activation;
+    google::protobuf::Arena arena;
+    ASSERT_OK_AND_ASSIGN(CelValue result,
+                         (*plans[i])->Evaluate(activation, &arena));
+    EXPECT_THAT(result, test::IsCelInt64(2 * i));
+  }
+}
+
+TEST(CelExpressionBuilderFlatImplTest, CheckedExprBatchReportsPerExprErrors) {
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr, Parse("1 + 2"));
+  CheckedExpr good_expr;
+  good_expr.mutable_expr()->Swap(parsed_expr.mutable_expr());
+  good_expr.mutable_source_info()->Swap(parsed_expr.mutable_source_info());
+  // An empty expression fails planning without aborting the batch.
+  CheckedExpr bad_expr;
+
+  CelExpressionBuilderFlatImpl builder;
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+
+  std::vector<const CheckedExpr*> checked_expr_ptrs = {&good_expr, &bad_expr};
+  std::vector<absl::StatusOr<std::unique_ptr<CelExpression>>> plans =
+      builder.CreateExpressions(checked_expr_ptrs);
+
+  ASSERT_EQ(plans.size(), 2);
+  EXPECT_OK(plans[0]);
+  EXPECT_THAT(plans[1], Not(cel::internal::IsOk()));
+}
+
 TEST(CelExpressionBuilderFlatImplTest, CheckedExprWithWarnings) {
   ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr, Parse("1 + 2"));
   CheckedExpr checked_expr;
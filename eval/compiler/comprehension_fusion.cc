@@ -0,0 +1,446 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/comprehension_fusion.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "base/ast_internal/ast_impl.h"
+#include "base/builtins.h"
+#include "common/expr.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::ComprehensionExpr;
+using ::cel::Expr;
+using ::cel::kAccumulatorVariableName;
+
+bool IsAccuIdent(const Expr& expr) {
+  return expr.has_ident_expr() &&
+         expr.ident_expr().name() == kAccumulatorVariableName;
+}
+
+bool IsConstTrue(const Expr& expr) {
+  return expr.has_const_expr() && expr.const_expr().has_bool_value() &&
+         expr.const_expr().bool_value();
+}
+
+bool IsEmptyList(const Expr& expr) {
+  return expr.has_list_expr() && expr.list_expr().elements().empty();
+}
+
+// Returns true if any subexpression is an identifier with the given name.
+//
+// Deliberately ignores shadowing: a nested comprehension rebinding the name
+// makes this check conservative (fusion is skipped), never unsound.
+bool ReferencesIdent(const Expr& expr, absl::string_view name) {
+  if (expr.has_ident_expr()) {
+    return expr.ident_expr().name() == name;
+  }
+  if (expr.has_select_expr()) {
+    return ReferencesIdent(expr.select_expr().operand(), name);
+  }
+  if (expr.has_call_expr()) {
+    const auto& call = expr.call_expr();
+    if (call.has_target() && ReferencesIdent(call.target(), name)) {
+      return true;
+    }
+    for (const Expr& arg : call.args()) {
+      if (ReferencesIdent(arg, name)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (expr.has_list_expr()) {
+    for (const auto& element : expr.list_expr().elements()) {
+      if (ReferencesIdent(element.expr(), name)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (expr.has_struct_expr()) {
+    for (const auto& field : expr.struct_expr().fields()) {
+      if (ReferencesIdent(field.value(), name)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (expr.has_map_expr()) {
+    for (const auto& entry : expr.map_expr().entries()) {
+      if (ReferencesIdent(entry.key(), name) ||
+          ReferencesIdent(entry.value(), name)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (expr.has_comprehension_expr()) {
+    const auto& comprehension = expr.comprehension_expr();
+    return (comprehension.has_iter_range() &&
+            ReferencesIdent(comprehension.iter_range(), name)) ||
+           (comprehension.has_accu_init() &&
+            ReferencesIdent(comprehension.accu_init(), name)) ||
+           (comprehension.has_loop_condition() &&
+            ReferencesIdent(comprehension.loop_condition(), name)) ||
+           (comprehension.has_loop_step() &&
+            ReferencesIdent(comprehension.loop_step(), name)) ||
+           (comprehension.has_result() &&
+            ReferencesIdent(comprehension.result(), name));
+  }
+  return false;
+}
+
+// Returns true if any subexpression is a comprehension.
+//
+// Used to rule out identifier shadowing before substitution: macro
+// accumulator and iteration variables may be rebound by nested loops.
+bool ContainsComprehension(const Expr& expr) {
+  if (expr.has_comprehension_expr()) {
+    return true;
+  }
+  if (expr.has_select_expr()) {
+    return ContainsComprehension(expr.select_expr().operand());
+  }
+  if (expr.has_call_expr()) {
+    const auto& call = expr.call_expr();
+    if (call.has_target() && ContainsComprehension(call.target())) {
+      return true;
+    }
+    for (const Expr& arg : call.args()) {
+      if (ContainsComprehension(arg)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (expr.has_list_expr()) {
+    for (const auto& element : expr.list_expr().elements()) {
+      if (ContainsComprehension(element.expr())) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (expr.has_struct_expr()) {
+    for (const auto& field : expr.struct_expr().fields()) {
+      if (ContainsComprehension(field.value())) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (expr.has_map_expr()) {
+    for (const auto& entry : expr.map_expr().entries()) {
+      if (ContainsComprehension(entry.key()) ||
+          ContainsComprehension(entry.value())) {
+        return true;
+      }
+    }
+    return false;
+  }
+  return false;
+}
+
+// Counts identifier references to `name`, recording the last site seen.
+int CountIdentRefs(Expr& expr, absl::string_view name, Expr*& site) {
+  if (expr.has_ident_expr()) {
+    if (expr.ident_expr().name() == name) {
+      site = &expr;
+      return 1;
+    }
+    return 0;
+  }
+  int count = 0;
+  if (expr.has_select_expr()) {
+    count += CountIdentRefs(expr.mutable_select_expr().mutable_operand(), name,
+                            site);
+  } else if (expr.has_call_expr()) {
+    auto& call = expr.mutable_call_expr();
+    if (call.has_target()) {
+      count += CountIdentRefs(call.mutable_target(), name, site);
+    }
+    for (Expr& arg : call.mutable_args()) {
+      count += CountIdentRefs(arg, name, site);
+    }
+  } else if (expr.has_list_expr()) {
+    for (auto& element : expr.mutable_list_expr().mutable_elements()) {
+      if (element.has_expr()) {
+        count += CountIdentRefs(element.mutable_expr(), name, site);
+      }
+    }
+  } else if (expr.has_struct_expr()) {
+    for (auto& field : expr.mutable_struct_expr().mutable_fields()) {
+      count += CountIdentRefs(field.mutable_value(), name, site);
+    }
+  } else if (expr.has_map_expr()) {
+    for (auto& entry : expr.mutable_map_expr().mutable_entries()) {
+      count += CountIdentRefs(entry.mutable_key(), name, site);
+      count += CountIdentRefs(entry.mutable_value(), name, site);
+    }
+  }
+  return count;
+}
+
+// Matches `__result__ + [<element>]`, the append shape used by the map and
+// filter macro expansions.
+bool IsAccuAppend(const Expr& expr) {
+  if (!expr.has_call_expr()) {
+    return false;
+  }
+  const auto& call = expr.call_expr();
+  if (call.function() != cel::builtin::kAdd || call.has_target() ||
+      call.args().size() != 2) {
+    return false;
+  }
+  return IsAccuIdent(call.args()[0]) && call.args()[1].has_list_expr() &&
+         call.args()[1].list_expr().elements().size() == 1 &&
+         !call.args()[1].list_expr().elements()[0].optional();
+}
+
+// Matches the exact loop step produced by the filter macro:
+// `<predicate> ? __result__ + [<iter_var>] : __result__`.
+bool IsFilterLoopStep(const Expr& expr, absl::string_view iter_var) {
+  if (!expr.has_call_expr()) {
+    return false;
+  }
+  const auto& call = expr.call_expr();
+  if (call.function() != cel::builtin::kTernary || call.has_target() ||
+      call.args().size() != 3) {
+    return false;
+  }
+  const Expr& append = call.args()[1];
+  if (!IsAccuAppend(append)) {
+    return false;
+  }
+  const Expr& element =
+      append.call_expr().args()[1].list_expr().elements()[0].expr();
+  return element.has_ident_expr() && element.ident_expr().name() == iter_var &&
+         IsAccuIdent(call.args()[2]) &&
+         !ReferencesIdent(call.args()[0], kAccumulatorVariableName);
+}
+
+// Returns true if the comprehension is exactly the filter macro expansion:
+// the loop appends the unmodified element when the predicate holds and the
+// result is the plain accumulated list.
+bool IsFusableFilter(const ComprehensionExpr& comprehension) {
+  return !comprehension.iter_var().empty() &&
+         comprehension.accu_var() == kAccumulatorVariableName &&
+         comprehension.has_iter_range() && comprehension.has_accu_init() &&
+         IsEmptyList(comprehension.accu_init()) &&
+         comprehension.has_loop_condition() &&
+         IsConstTrue(comprehension.loop_condition()) &&
+         comprehension.has_loop_step() &&
+         IsFilterLoopStep(comprehension.loop_step(),
+                          comprehension.iter_var()) &&
+         comprehension.has_result() && IsAccuIdent(comprehension.result());
+}
+
+// Matches the map macro expansion: the loop unconditionally appends the
+// mapped element and the result is the plain accumulated list.
+bool IsFusableMap(const ComprehensionExpr& comprehension) {
+  return !comprehension.iter_var().empty() &&
+         comprehension.accu_var() == kAccumulatorVariableName &&
+         comprehension.has_iter_range() && comprehension.has_accu_init() &&
+         IsEmptyList(comprehension.accu_init()) &&
+         comprehension.has_loop_condition() &&
+         IsConstTrue(comprehension.loop_condition()) &&
+         comprehension.has_loop_step() && IsAccuAppend(comprehension.loop_step()) &&
+         !ReferencesIdent(comprehension.loop_step().call_expr().args()[1],
+                          kAccumulatorVariableName) &&
+         comprehension.has_result() && IsAccuIdent(comprehension.result());
+}
+
+// Returns true if `outer` may consume a fused producer: its loop body must
+// use the standard accumulator and its loop condition must not observe the
+// iteration variable (conditions are evaluated before the variable is
+// rebound). Short circuiting conditions (exists/all) are only eligible when
+// streaming is requested.
+bool IsFusableConsumer(const ComprehensionExpr& outer,
+                       ComprehensionFusionOption option) {
+  if (outer.accu_var() != kAccumulatorVariableName ||
+      !outer.has_loop_condition() || !outer.has_loop_step()) {
+    return false;
+  }
+  if (IsConstTrue(outer.loop_condition())) {
+    return true;
+  }
+  return option == ComprehensionFusionOption::kStreaming &&
+         !ReferencesIdent(outer.loop_condition(), outer.iter_var());
+}
+
+// Attempts to fuse `outer` with a filter comprehension in its iteration
+// range. Returns true if a rewrite was applied.
+//
+// For `E.filter(x, p)` feeding a comprehension over `x`, iterating `E`
+// directly and guarding the outer loop step with `p` is equivalent:
+//
+//   loop_step' = p ? loop_step : __result__
+//
+// The inner ternary node is reused for the guard so no new expression ids
+// are introduced.
+bool TryFuseFilter(ComprehensionExpr& outer, ComprehensionFusionOption option) {
+  ComprehensionExpr& inner =
+      outer.mutable_iter_range().mutable_comprehension_expr();
+  if (!IsFusableFilter(inner) || inner.iter_var() != outer.iter_var() ||
+      !IsFusableConsumer(outer, option)) {
+    return false;
+  }
+
+  // Detach the pieces of the inner comprehension before overwriting the
+  // iteration range that owns it.
+  std::unique_ptr<Expr> fused_range = inner.release_iter_range();
+  std::unique_ptr<Expr> guard = inner.release_loop_step();
+
+  // Replace the inner append branch with the outer loop step; the false
+  // branch already yields the untouched accumulator.
+  guard->mutable_call_expr().mutable_args()[1] =
+      std::move(*outer.release_loop_step());
+  outer.set_loop_step(std::move(guard));
+  outer.set_iter_range(std::move(fused_range));
+  return true;
+}
+
+// Attempts to fuse `outer` with a map comprehension in its iteration range.
+// Returns true if a rewrite was applied.
+//
+// For `E.map(x, f)` feeding a comprehension over `x`, the mapped element
+// expression is substituted for the iteration variable in the outer loop
+// step. Substitution is only performed when the variable occurs exactly
+// once (so `f` is not duplicated or dropped) and the loop step binds no
+// nested loops that could shadow it.
+bool TryFuseMap(ComprehensionExpr& outer, ComprehensionFusionOption option) {
+  ComprehensionExpr& inner =
+      outer.mutable_iter_range().mutable_comprehension_expr();
+  if (!IsFusableMap(inner) || inner.iter_var() != outer.iter_var() ||
+      !IsFusableConsumer(outer, option) ||
+      ContainsComprehension(outer.loop_step())) {
+    return false;
+  }
+  Expr* site = nullptr;
+  if (CountIdentRefs(outer.mutable_loop_step(), outer.iter_var(), site) != 1) {
+    return false;
+  }
+
+  std::unique_ptr<Expr> fused_range = inner.release_iter_range();
+  Expr& mapped_element = inner.mutable_loop_step()
+                             .mutable_call_expr()
+                             .mutable_args()[1]
+                             .mutable_list_expr()
+                             .mutable_elements()[0]
+                             .mutable_expr();
+  *site = std::move(mapped_element);
+  outer.set_iter_range(std::move(fused_range));
+  return true;
+}
+
+bool TryFuse(ComprehensionExpr& outer, ComprehensionFusionOption option) {
+  if (!outer.has_iter_range() ||
+      !outer.iter_range().has_comprehension_expr() ||
+      outer.iter_var().empty()) {
+    return false;
+  }
+  return TryFuseFilter(outer, option) || TryFuseMap(outer, option);
+}
+
+bool FuseExpr(Expr& expr, ComprehensionFusionOption option) {
+  bool rewritten = false;
+  if (expr.has_comprehension_expr()) {
+    while (TryFuse(expr.mutable_comprehension_expr(), option)) {
+      rewritten = true;
+    }
+  }
+  // Recurse after fusing so spliced subtrees are visited exactly once.
+  if (expr.has_select_expr()) {
+    rewritten |= FuseExpr(expr.mutable_select_expr().mutable_operand(), option);
+  } else if (expr.has_call_expr()) {
+    auto& call = expr.mutable_call_expr();
+    if (call.has_target()) {
+      rewritten |= FuseExpr(call.mutable_target(), option);
+    }
+    for (Expr& arg : call.mutable_args()) {
+      rewritten |= FuseExpr(arg, option);
+    }
+  } else if (expr.has_list_expr()) {
+    for (auto& element : expr.mutable_list_expr().mutable_elements()) {
+      if (element.has_expr()) {
+        rewritten |= FuseExpr(element.mutable_expr(), option);
+      }
+    }
+  } else if (expr.has_struct_expr()) {
+    for (auto& field : expr.mutable_struct_expr().mutable_fields()) {
+      rewritten |= FuseExpr(field.mutable_value(), option);
+    }
+  } else if (expr.has_map_expr()) {
+    for (auto& entry : expr.mutable_map_expr().mutable_entries()) {
+      rewritten |= FuseExpr(entry.mutable_key(), option);
+      rewritten |= FuseExpr(entry.mutable_value(), option);
+    }
+  } else if (expr.has_comprehension_expr()) {
+    auto& comprehension = expr.mutable_comprehension_expr();
+    if (comprehension.has_iter_range()) {
+      rewritten |= FuseExpr(comprehension.mutable_iter_range(), option);
+    }
+    if (comprehension.has_accu_init()) {
+      rewritten |= FuseExpr(comprehension.mutable_accu_init(), option);
+    }
+    if (comprehension.has_loop_condition()) {
+      rewritten |= FuseExpr(comprehension.mutable_loop_condition(), option);
+    }
+    if (comprehension.has_loop_step()) {
+      rewritten |= FuseExpr(comprehension.mutable_loop_step(), option);
+    }
+    if (comprehension.has_result()) {
+      rewritten |= FuseExpr(comprehension.mutable_result(), option);
+    }
+  }
+  return rewritten;
+}
+
+class ComprehensionFusionExtension : public AstTransform {
+ public:
+  explicit ComprehensionFusionExtension(ComprehensionFusionOption option)
+      : option_(option) {}
+
+  absl::Status UpdateAst(PlannerContext& context,
+                         cel::ast_internal::AstImpl& ast) const override {
+    FuseComprehensions(ast, option_);
+    return absl::OkStatus();
+  }
+
+ private:
+  ComprehensionFusionOption option_;
+};
+
+}  // namespace
+
+bool FuseComprehensions(cel::ast_internal::AstImpl& ast,
+                        ComprehensionFusionOption option) {
+  return FuseExpr(ast.root_expr(), option);
+}
+
+std::unique_ptr<AstTransform> NewComprehensionFusionExtension(
+    ComprehensionFusionOption option) {
+  return std::make_unique<ComprehensionFusionExtension>(option);
+}
+
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,61 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_COMPILER_COMPREHENSION_FUSION_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_COMPILER_COMPREHENSION_FUSION_H_
+
+#include <memory>
+
+#include "base/ast_internal/ast_impl.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+
+namespace google::api::expr::runtime {
+
+// Fuses chained list comprehensions into a single loop.
+//
+// The filter macro materializes its result as an intermediate list, so a
+// chain like `list.filter(x, p).map(x, f)` allocates one list per stage.
+// When the stages use the same iteration variable and the standard macro
+// accumulator, the chain is rewritten into the equivalent single
+// comprehension (the shape produced by the three argument map macro), e.g.
+// `list.map(x, p, f)`, eliminating the intermediate list.
+//
+// Only exact macro shapes are rewritten; handwritten comprehensions or loop
+// bodies that reference the accumulator directly are left untouched.
+enum class ComprehensionFusionOption {
+  // Fuse only stages whose consumer cannot short circuit (map/filter
+  // chains). Both the unfused and fused programs visit every element, so
+  // any error produced by a stage still surfaces.
+  kExhaustiveOnly,
+  // Additionally stream producer stages into short circuiting consumers
+  // (exists/all). The consumer stops evaluating producer stages as soon as
+  // the answer is known, so a chain like `list.map(x, f).exists(x, q)` no
+  // longer computes `f` past the match. Errors a fully materialized
+  // intermediate list would have surfaced after the deciding element are
+  // consequently skipped.
+  kStreaming,
+};
+
+// Returns true if any rewrite was applied.
+bool FuseComprehensions(
+    cel::ast_internal::AstImpl& ast,
+    ComprehensionFusionOption option = ComprehensionFusionOption::kExhaustiveOnly);
+
+// Create a new AST transform applying comprehension fusion before planning.
+std::unique_ptr<AstTransform> NewComprehensionFusionExtension(
+    ComprehensionFusionOption option = ComprehensionFusionOption::kExhaustiveOnly);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_COMPILER_COMPREHENSION_FUSION_H_
@@ -0,0 +1,190 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/comprehension_fusion.h"
+
+#include <memory>
+#include <string>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/statusor.h"
+#include "base/ast.h"
+#include "base/ast_internal/ast_impl.h"
+#include "eval/compiler/cel_expression_builder_flat_impl.h"
+#include "eval/public/activation.h"
+#include "eval/public/builtin_func_registrar.h"
+#include "eval/public/cel_expression.h"
+#include "eval/public/cel_value.h"
+#include "extensions/protobuf/ast_converters.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::ast_internal::AstImpl;
+using ::google::api::expr::parser::Parse;
+
+namespace exprpb = google::api::expr::v1alpha1;
+
+absl::StatusOr<std::unique_ptr<cel::Ast>> ParseToAst(
+    const std::string& expression) {
+  CEL_ASSIGN_OR_RETURN(exprpb::ParsedExpr parsed_expr, Parse(expression));
+  return cel::extensions::CreateAstFromParsedExpr(parsed_expr);
+}
+
+TEST(FuseComprehensions, FusesFilterMap) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<cel::Ast> ast,
+                       ParseToAst("[1, 2, 3].filter(x, x > 1).map(x, x * 2)"));
+  AstImpl& ast_impl = AstImpl::CastFromPublicAst(*ast);
+
+  EXPECT_TRUE(FuseComprehensions(ast_impl));
+
+  // The fused comprehension iterates the original literal directly.
+  const auto& root = ast_impl.root_expr();
+  ASSERT_TRUE(root.has_comprehension_expr());
+  EXPECT_TRUE(root.comprehension_expr().iter_range().has_list_expr());
+}
+
+TEST(FuseComprehensions, FusesFilterFilterChain) {
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<cel::Ast> ast,
+      ParseToAst("[1, 2, 3].filter(x, x > 0).filter(x, x < 3)"));
+  AstImpl& ast_impl = AstImpl::CastFromPublicAst(*ast);
+
+  EXPECT_TRUE(FuseComprehensions(ast_impl));
+
+  const auto& root = ast_impl.root_expr();
+  ASSERT_TRUE(root.has_comprehension_expr());
+  EXPECT_TRUE(root.comprehension_expr().iter_range().has_list_expr());
+}
+
+TEST(FuseComprehensions, FusesMapMapChain) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<cel::Ast> ast,
+                       ParseToAst("[1, 2, 3].map(x, x + 1).map(x, x * 2)"));
+  AstImpl& ast_impl = AstImpl::CastFromPublicAst(*ast);
+
+  EXPECT_TRUE(FuseComprehensions(ast_impl));
+
+  const auto& root = ast_impl.root_expr();
+  ASSERT_TRUE(root.has_comprehension_expr());
+  EXPECT_TRUE(root.comprehension_expr().iter_range().has_list_expr());
+}
+
+TEST(FuseComprehensions, SkipsMapSubstitutionWhenVarRepeated) {
+  // `x` occurs twice in the consumer, so substituting `x + 1` would
+  // duplicate the producer expression.
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<cel::Ast> ast,
+                       ParseToAst("[1, 2, 3].map(x, x + 1).map(x, x * x)"));
+  AstImpl& ast_impl = AstImpl::CastFromPublicAst(*ast);
+
+  EXPECT_FALSE(FuseComprehensions(ast_impl));
+}
+
+TEST(FuseComprehensions, SkipsMismatchedIterVars) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<cel::Ast> ast,
+                       ParseToAst("[1, 2, 3].filter(x, x > 1).map(y, y * 2)"));
+  AstImpl& ast_impl = AstImpl::CastFromPublicAst(*ast);
+
+  EXPECT_FALSE(FuseComprehensions(ast_impl));
+}
+
+TEST(FuseComprehensions, SkipsShortCircuitingOuterLoop) {
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<cel::Ast> ast,
+      ParseToAst("[1, 2, 3].filter(x, x > 1).exists(x, x == 2)"));
+  AstImpl& ast_impl = AstImpl::CastFromPublicAst(*ast);
+
+  EXPECT_FALSE(FuseComprehensions(ast_impl));
+}
+
+TEST(FuseComprehensions, StreamingFusesFilterIntoExists) {
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<cel::Ast> ast,
+      ParseToAst("[1, 2, 3].filter(x, x > 1).exists(x, x == 2)"));
+  AstImpl& ast_impl = AstImpl::CastFromPublicAst(*ast);
+
+  EXPECT_TRUE(
+      FuseComprehensions(ast_impl, ComprehensionFusionOption::kStreaming));
+
+  const auto& root = ast_impl.root_expr();
+  ASSERT_TRUE(root.has_comprehension_expr());
+  EXPECT_TRUE(root.comprehension_expr().iter_range().has_list_expr());
+}
+
+TEST(FuseComprehensions, StreamingFusesMapIntoExists) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<cel::Ast> ast,
+                       ParseToAst("[1, 2, 3].map(x, x * 2).exists(x, x == 4)"));
+  AstImpl& ast_impl = AstImpl::CastFromPublicAst(*ast);
+
+  EXPECT_TRUE(
+      FuseComprehensions(ast_impl, ComprehensionFusionOption::kStreaming));
+
+  const auto& root = ast_impl.root_expr();
+  ASSERT_TRUE(root.has_comprehension_expr());
+  EXPECT_TRUE(root.comprehension_expr().iter_range().has_list_expr());
+}
+
+TEST(FuseComprehensions, StreamedProgramEvaluatesCorrectly) {
+  ASSERT_OK_AND_ASSIGN(
+      exprpb::ParsedExpr parsed_expr,
+      Parse("[1, 2, 3, 4].map(x, x * 2).exists(x, x == 6)"));
+
+  CelExpressionBuilderFlatImpl builder;
+  builder.flat_expr_builder().AddAstTransform(NewComprehensionFusionExtension(
+      ComprehensionFusionOption::kStreaming));
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CelExpression> plan,
+      builder.CreateExpression(&parsed_expr.expr(),
+                               &parsed_expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  ASSERT_OK_AND_ASSIGN(CelValue result, plan->Evaluate(activation, &arena));
+
+  ASSERT_TRUE(result.IsBool());
+  EXPECT_TRUE(result.BoolOrDie());
+}
+
+TEST(FuseComprehensions, FusedProgramEvaluatesCorrectly) {
+  ASSERT_OK_AND_ASSIGN(
+      exprpb::ParsedExpr parsed_expr,
+      Parse("[1, 2, 3, 4].filter(x, x % 2 == 0).map(x, x * 10)"));
+
+  CelExpressionBuilderFlatImpl builder;
+  builder.flat_expr_builder().AddAstTransform(
+      NewComprehensionFusionExtension());
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CelExpression> plan,
+      builder.CreateExpression(&parsed_expr.expr(),
+                               &parsed_expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  ASSERT_OK_AND_ASSIGN(CelValue result, plan->Evaluate(activation, &arena));
+
+  ASSERT_TRUE(result.IsList());
+  const CelList& list = *result.ListOrDie();
+  ASSERT_EQ(list.size(), 2);
+  EXPECT_EQ((list)[0].Int64OrDie(), 20);
+  EXPECT_EQ((list)[1].Int64OrDie(), 40);
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
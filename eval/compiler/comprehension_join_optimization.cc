@@ -0,0 +1,700 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/comprehension_join_optimization.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "base/ast_internal/ast_impl.h"
+#include "base/builtins.h"
+#include "common/casting.h"
+#include "common/expr.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "eval/eval/attribute_trail.h"
+#include "eval/eval/comprehension_slots.h"
+#include "eval/eval/direct_expression_step.h"
+#include "eval/eval/evaluator_core.h"
+#include "internal/number.h"
+#include "internal/status_macros.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::BoolValue;
+using ::cel::Cast;
+using ::cel::ComprehensionExpr;
+using ::cel::Expr;
+using ::cel::InstanceOf;
+using ::cel::kAccumulatorVariableName;
+using ::cel::ListValue;
+using ::cel::StringValue;
+using ::cel::Value;
+using ::cel::ValueKind;
+using ::cel::ast_internal::AstImpl;
+using ::cel::internal::Number;
+
+bool IsIdent(const Expr& expr, absl::string_view name) {
+  return expr.has_ident_expr() && expr.ident_expr().name() == name;
+}
+
+bool IsAccuIdent(const Expr& expr) {
+  return IsIdent(expr, kAccumulatorVariableName);
+}
+
+bool IsConstBool(const Expr& expr, bool value) {
+  return expr.has_const_expr() && expr.const_expr().has_bool_value() &&
+         expr.const_expr().bool_value() == value;
+}
+
+// Matches the loop condition the exists/all macros expand to:
+// `@not_strictly_false(<condition>)`, with the legacy spelling accepted.
+const Expr* MatchNotStrictlyFalse(const Expr& expr) {
+  if (!expr.has_call_expr()) {
+    return nullptr;
+  }
+  const auto& call = expr.call_expr();
+  if ((call.function() != cel::builtin::kNotStrictlyFalse &&
+       call.function() != cel::builtin::kNotStrictlyFalseDeprecated) ||
+      call.has_target() || call.args().size() != 1) {
+    return nullptr;
+  }
+  return &call.args()[0];
+}
+
+// Returns true if any subexpression is an identifier with the given name.
+//
+// Deliberately ignores shadowing; candidates containing nested
+// comprehensions are rejected outright, so a conservative answer here only
+// skips the rewrite, never makes it unsound.
+bool ReferencesIdent(const Expr& expr, absl::string_view name) {
+  if (expr.has_ident_expr()) {
+    return expr.ident_expr().name() == name;
+  }
+  if (expr.has_select_expr()) {
+    return ReferencesIdent(expr.select_expr().operand(), name);
+  }
+  if (expr.has_call_expr()) {
+    const auto& call = expr.call_expr();
+    if (call.has_target() && ReferencesIdent(call.target(), name)) {
+      return true;
+    }
+    for (const Expr& arg : call.args()) {
+      if (ReferencesIdent(arg, name)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (expr.has_list_expr()) {
+    for (const auto& element : expr.list_expr().elements()) {
+      if (ReferencesIdent(element.expr(), name)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (expr.has_struct_expr()) {
+    for (const auto& field : expr.struct_expr().fields()) {
+      if (ReferencesIdent(field.value(), name)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (expr.has_map_expr()) {
+    for (const auto& entry : expr.map_expr().entries()) {
+      if (ReferencesIdent(entry.key(), name) ||
+          ReferencesIdent(entry.value(), name)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (expr.has_comprehension_expr()) {
+    const auto& comprehension = expr.comprehension_expr();
+    return (comprehension.has_iter_range() &&
+            ReferencesIdent(comprehension.iter_range(), name)) ||
+           (comprehension.has_accu_init() &&
+            ReferencesIdent(comprehension.accu_init(), name)) ||
+           (comprehension.has_loop_condition() &&
+            ReferencesIdent(comprehension.loop_condition(), name)) ||
+           (comprehension.has_loop_step() &&
+            ReferencesIdent(comprehension.loop_step(), name)) ||
+           (comprehension.has_result() &&
+            ReferencesIdent(comprehension.result(), name));
+  }
+  return false;
+}
+
+// Returns true if any subexpression is a comprehension. Used to rule out
+// identifier shadowing in ranges and keys before analyzing their free
+// variables.
+bool ContainsComprehension(const Expr& expr) {
+  if (expr.has_comprehension_expr()) {
+    return true;
+  }
+  if (expr.has_select_expr()) {
+    return ContainsComprehension(expr.select_expr().operand());
+  }
+  if (expr.has_call_expr()) {
+    const auto& call = expr.call_expr();
+    if (call.has_target() && ContainsComprehension(call.target())) {
+      return true;
+    }
+    for (const Expr& arg : call.args()) {
+      if (ContainsComprehension(arg)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (expr.has_list_expr()) {
+    for (const auto& element : expr.list_expr().elements()) {
+      if (ContainsComprehension(element.expr())) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (expr.has_struct_expr()) {
+    for (const auto& field : expr.struct_expr().fields()) {
+      if (ContainsComprehension(field.value())) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (expr.has_map_expr()) {
+    for (const auto& entry : expr.map_expr().entries()) {
+      if (ContainsComprehension(entry.key()) ||
+          ContainsComprehension(entry.value())) {
+        return true;
+      }
+    }
+    return false;
+  }
+  return false;
+}
+
+// Matches the exact comprehension shape the exists (`all_ = false`) and all
+// (`all_ = true`) macros expand to, returning the loop predicate.
+const Expr* MatchBoolMacroPredicate(const ComprehensionExpr& comprehension,
+                                    bool all) {
+  if (comprehension.iter_var().empty() ||
+      comprehension.accu_var() != kAccumulatorVariableName ||
+      !comprehension.has_iter_range() || !comprehension.has_accu_init() ||
+      !comprehension.has_loop_condition() || !comprehension.has_loop_step() ||
+      !comprehension.has_result() ||
+      !IsConstBool(comprehension.accu_init(), all) ||
+      !IsAccuIdent(comprehension.result())) {
+    return nullptr;
+  }
+  const Expr* condition = MatchNotStrictlyFalse(comprehension.loop_condition());
+  if (condition == nullptr) {
+    return nullptr;
+  }
+  if (all) {
+    if (!IsAccuIdent(*condition)) {
+      return nullptr;
+    }
+  } else {
+    // exists: `@not_strictly_false(!__result__)`.
+    if (!condition->has_call_expr() ||
+        condition->call_expr().function() != cel::builtin::kNot ||
+        condition->call_expr().has_target() ||
+        condition->call_expr().args().size() != 1 ||
+        !IsAccuIdent(condition->call_expr().args()[0])) {
+      return nullptr;
+    }
+  }
+  if (!comprehension.loop_step().has_call_expr()) {
+    return nullptr;
+  }
+  const auto& step = comprehension.loop_step().call_expr();
+  if (step.function() != (all ? cel::builtin::kAnd : cel::builtin::kOr) ||
+      step.has_target() || step.args().size() != 2 ||
+      !IsAccuIdent(step.args()[0])) {
+    return nullptr;
+  }
+  return &step.args()[1];
+}
+
+// A detected join candidate. All pointers are into the AST being planned.
+struct JoinPattern {
+  const Expr* inner;        // inner exists comprehension
+  const Expr* probe_range;  // outer iteration range
+  const Expr* build_range;  // inner iteration range
+  const Expr* build_key;    // equality side depending on the inner variable
+  const Expr* probe_key;    // equality side independent of the inner variable
+  bool outer_is_all;        // outer comprehension is all (else exists)
+};
+
+absl::optional<JoinPattern> MatchJoin(const Expr& node) {
+  if (!node.has_comprehension_expr()) {
+    return absl::nullopt;
+  }
+  const ComprehensionExpr& outer = node.comprehension_expr();
+  bool outer_is_all = true;
+  const Expr* predicate = MatchBoolMacroPredicate(outer, /*all=*/true);
+  if (predicate == nullptr) {
+    outer_is_all = false;
+    predicate = MatchBoolMacroPredicate(outer, /*all=*/false);
+  }
+  if (predicate == nullptr || !predicate->has_comprehension_expr()) {
+    return absl::nullopt;
+  }
+  const ComprehensionExpr& inner = predicate->comprehension_expr();
+  const Expr* equality = MatchBoolMacroPredicate(inner, /*all=*/false);
+  if (equality == nullptr || !equality->has_call_expr()) {
+    return absl::nullopt;
+  }
+  const auto& call = equality->call_expr();
+  if (call.function() != cel::builtin::kEqual || call.has_target() ||
+      call.args().size() != 2) {
+    return absl::nullopt;
+  }
+  absl::string_view outer_var = outer.iter_var();
+  absl::string_view inner_var = inner.iter_var();
+  if (outer_var == inner_var || outer_var == kAccumulatorVariableName) {
+    return absl::nullopt;
+  }
+  // The build range must be invariant across the outer loop and free of
+  // nested loops (which could shadow the variables inspected here).
+  if (ContainsComprehension(inner.iter_range()) ||
+      ReferencesIdent(inner.iter_range(), outer_var) ||
+      ReferencesIdent(inner.iter_range(), inner_var) ||
+      ReferencesIdent(inner.iter_range(), kAccumulatorVariableName)) {
+    return absl::nullopt;
+  }
+  // One equality side must depend on the inner variable only (the build
+  // key); the other must not mention it at all (the probe key).
+  const Expr* build_key = nullptr;
+  const Expr* probe_key = nullptr;
+  for (int i = 0; i < 2; ++i) {
+    const Expr& key = call.args()[i];
+    const Expr& other = call.args()[1 - i];
+    if (ReferencesIdent(key, inner_var) &&
+        !ReferencesIdent(key, outer_var) &&
+        !ReferencesIdent(other, inner_var)) {
+      build_key = &key;
+      probe_key = &other;
+      break;
+    }
+  }
+  if (build_key == nullptr || ContainsComprehension(*build_key) ||
+      ContainsComprehension(*probe_key) ||
+      ReferencesIdent(*build_key, kAccumulatorVariableName) ||
+      ReferencesIdent(*probe_key, kAccumulatorVariableName)) {
+    return absl::nullopt;
+  }
+  return JoinPattern{predicate,  &outer.iter_range(), &inner.iter_range(),
+                     build_key,  probe_key,           outer_is_all};
+}
+
+// Hash index over the build-side keys, mirroring the scalar domain and
+// numeric canonicalization of the standard equality overloads.
+class JoinKeyIndex {
+ public:
+  // Records `key`; returns false if the key is outside the indexed domain,
+  // in which case probes could miss genuine matches and the caller must fall
+  // back to the nested loop.
+  bool Insert(const Value& key) {
+    switch (key.kind()) {
+      case ValueKind::kBool:
+        (Cast<BoolValue>(key).NativeValue() ? has_true_ : has_false_) = true;
+        return true;
+      case ValueKind::kInt:
+        InsertNumber(Number::FromInt64(Cast<cel::IntValue>(key).NativeValue()));
+        return true;
+      case ValueKind::kUint:
+        InsertNumber(
+            Number::FromUint64(Cast<cel::UintValue>(key).NativeValue()));
+        return true;
+      case ValueKind::kDouble:
+        InsertNumber(
+            Number::FromDouble(Cast<cel::DoubleValue>(key).NativeValue()));
+        return true;
+      case ValueKind::kString:
+        strings_.insert(Cast<StringValue>(key).NativeString());
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  // Whether an indexed key equals `key`; nullopt if the probe key carries no
+  // definite equality answer (errors and unknowns) and the caller must fall
+  // back.
+  absl::optional<bool> Contains(const Value& key) const {
+    switch (key.kind()) {
+      case ValueKind::kBool:
+        return Cast<BoolValue>(key).NativeValue() ? has_true_ : has_false_;
+      case ValueKind::kInt:
+        return ContainsNumber(
+            Number::FromInt64(Cast<cel::IntValue>(key).NativeValue()));
+      case ValueKind::kUint:
+        return ContainsNumber(
+            Number::FromUint64(Cast<cel::UintValue>(key).NativeValue()));
+      case ValueKind::kDouble:
+        return ContainsNumber(
+            Number::FromDouble(Cast<cel::DoubleValue>(key).NativeValue()));
+      case ValueKind::kString: {
+        std::string scratch;
+        return strings_.contains(Cast<StringValue>(key).NativeString(scratch));
+      }
+      case ValueKind::kError:
+      case ValueKind::kUnknown:
+        return absl::nullopt;
+      default:
+        // Equality between the indexed scalar kinds and any other kind is
+        // always false.
+        return false;
+    }
+  }
+
+ private:
+  void InsertNumber(Number number) {
+    if (number.LosslessConvertibleToInt()) {
+      ints_.insert(number.AsInt());
+    } else if (number.LosslessConvertibleToUint()) {
+      uints_.insert(number.AsUint());
+    } else {
+      doubles_.insert(number.AsDouble());
+    }
+  }
+
+  bool ContainsNumber(Number number) const {
+    if (number.LosslessConvertibleToInt()) {
+      return ints_.contains(number.AsInt());
+    }
+    if (number.LosslessConvertibleToUint()) {
+      return uints_.contains(number.AsUint());
+    }
+    return doubles_.contains(number.AsDouble());
+  }
+
+  absl::flat_hash_set<std::string> strings_;
+  absl::flat_hash_set<int64_t> ints_;
+  absl::flat_hash_set<uint64_t> uints_;
+  absl::flat_hash_set<double> doubles_;
+  bool has_true_ = false;
+  bool has_false_ = false;
+};
+
+// Transparent decorator left in place of a tapped subprogram. Ownership is
+// shared with the join step, which evaluates the same program outside its
+// original position in the tree.
+class SharedDelegateStep : public DirectExpressionStep {
+ public:
+  SharedDelegateStep(int64_t expr_id,
+                     std::shared_ptr<const DirectExpressionStep> impl)
+      : DirectExpressionStep(expr_id), impl_(std::move(impl)) {}
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, cel::Value& result,
+                        AttributeTrail& attribute) const override {
+    return impl_->Evaluate(frame, result, attribute);
+  }
+
+ private:
+  std::shared_ptr<const DirectExpressionStep> impl_;
+};
+
+// Build/probe hash join over an equality-correlated nested comprehension.
+//
+// Evaluates the build range once, indexes its keys, then answers the outer
+// comprehension by probing per element. The original nested-loop program is
+// kept and evaluated instead whenever the fast path cannot reproduce its
+// result exactly: tracing or attribute tracking is active, a range is not a
+// list, or a key falls outside the indexed domain. The subprograms driven
+// here are shared with that fallback, so both paths evaluate identical
+// plans.
+class HashJoinComprehensionStep : public DirectExpressionStep {
+ public:
+  HashJoinComprehensionStep(
+      int64_t expr_id, std::unique_ptr<DirectExpressionStep> fallback,
+      std::shared_ptr<const DirectExpressionStep> probe_range,
+      std::shared_ptr<const DirectExpressionStep> build_range,
+      std::shared_ptr<const DirectExpressionStep> build_key,
+      std::shared_ptr<const DirectExpressionStep> probe_key,
+      size_t probe_iter_slot, size_t build_iter_slot, bool outer_is_all)
+      : DirectExpressionStep(expr_id),
+        fallback_(std::move(fallback)),
+        probe_range_(std::move(probe_range)),
+        build_range_(std::move(build_range)),
+        build_key_(std::move(build_key)),
+        probe_key_(std::move(probe_key)),
+        probe_iter_slot_(probe_iter_slot),
+        build_iter_slot_(build_iter_slot),
+        outer_is_all_(outer_is_all) {}
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, cel::Value& result,
+                        AttributeTrail& attribute) const override;
+
+ private:
+  absl::StatusOr<absl::optional<bool>> EvaluateJoin(
+      ExecutionFrameBase& frame) const;
+
+  std::unique_ptr<DirectExpressionStep> fallback_;
+  std::shared_ptr<const DirectExpressionStep> probe_range_;
+  std::shared_ptr<const DirectExpressionStep> build_range_;
+  std::shared_ptr<const DirectExpressionStep> build_key_;
+  std::shared_ptr<const DirectExpressionStep> probe_key_;
+  size_t probe_iter_slot_;
+  size_t build_iter_slot_;
+  bool outer_is_all_;
+};
+
+absl::Status HashJoinComprehensionStep::Evaluate(
+    ExecutionFrameBase& frame, cel::Value& result,
+    AttributeTrail& attribute) const {
+  if (frame.attribute_tracking_enabled() || frame.tracing_enabled()) {
+    return fallback_->Evaluate(frame, result, attribute);
+  }
+  CEL_ASSIGN_OR_RETURN(absl::optional<bool> outcome, EvaluateJoin(frame));
+  if (!outcome.has_value()) {
+    return fallback_->Evaluate(frame, result, attribute);
+  }
+  result = BoolValue(*outcome);
+  return absl::OkStatus();
+}
+
+absl::StatusOr<absl::optional<bool>> HashJoinComprehensionStep::EvaluateJoin(
+    ExecutionFrameBase& frame) const {
+  // The outer range is evaluated first and the build side not at all when
+  // the outer loop would not run, matching the observable evaluation order
+  // of the nested loop being replaced.
+  Value probe_range;
+  AttributeTrail range_trail;
+  CEL_RETURN_IF_ERROR(probe_range_->Evaluate(frame, probe_range, range_trail));
+  if (!InstanceOf<ListValue>(probe_range)) {
+    return absl::nullopt;
+  }
+  CEL_ASSIGN_OR_RETURN(size_t probe_size, Cast<ListValue>(probe_range).Size());
+  if (probe_size == 0) {
+    return outer_is_all_;
+  }
+
+  Value build_range;
+  CEL_RETURN_IF_ERROR(build_range_->Evaluate(frame, build_range, range_trail));
+  if (!InstanceOf<ListValue>(build_range)) {
+    return absl::nullopt;
+  }
+  auto& slots = frame.comprehension_slots();
+
+  // Build: index the inner keys once.
+  JoinKeyIndex index;
+  bool eligible = true;
+  slots.Set(build_iter_slot_);
+  ComprehensionSlots::Slot* build_slot = slots.Get(build_iter_slot_);
+  absl::Status status = Cast<ListValue>(build_range).ForEach(
+      frame.value_manager(),
+      [&](const Value& element) -> absl::StatusOr<bool> {
+        CEL_RETURN_IF_ERROR(frame.IncrementIterations());
+        build_slot->value = element;
+        build_slot->attribute = AttributeTrail();
+        Value key;
+        AttributeTrail key_trail;
+        CEL_RETURN_IF_ERROR(build_key_->Evaluate(frame, key, key_trail));
+        eligible = index.Insert(key);
+        return eligible;
+      });
+  slots.ClearSlot(build_iter_slot_);
+  CEL_RETURN_IF_ERROR(status);
+  if (!eligible) {
+    return absl::nullopt;
+  }
+
+  // Probe: one hash lookup per outer element, short circuiting the same way
+  // the macro loop condition would.
+  bool outcome = outer_is_all_;
+  slots.Set(probe_iter_slot_);
+  ComprehensionSlots::Slot* probe_slot = slots.Get(probe_iter_slot_);
+  status = Cast<ListValue>(probe_range).ForEach(
+      frame.value_manager(),
+      [&](const Value& element) -> absl::StatusOr<bool> {
+        CEL_RETURN_IF_ERROR(frame.IncrementIterations());
+        probe_slot->value = element;
+        probe_slot->attribute = AttributeTrail();
+        Value key;
+        AttributeTrail key_trail;
+        CEL_RETURN_IF_ERROR(probe_key_->Evaluate(frame, key, key_trail));
+        absl::optional<bool> hit = index.Contains(key);
+        if (!hit.has_value()) {
+          eligible = false;
+          return false;
+        }
+        if (*hit != outer_is_all_) {
+          outcome = *hit;
+          return false;
+        }
+        return true;
+      });
+  slots.ClearSlot(probe_iter_slot_);
+  CEL_RETURN_IF_ERROR(status);
+  if (!eligible) {
+    return absl::nullopt;
+  }
+  return outcome;
+}
+
+class ComprehensionJoinOptimization : public ProgramOptimizer {
+ public:
+  absl::Status OnPreVisit(PlannerContext& context, const Expr& node) override {
+    // The index equates numeric keys across int/uint/double domains, which
+    // is only the behavior of `==` under heterogeneous equality.
+    if (!context.options().enable_heterogeneous_equality) {
+      return absl::OkStatus();
+    }
+    absl::optional<JoinPattern> pattern = MatchJoin(node);
+    if (!pattern.has_value()) {
+      return absl::OkStatus();
+    }
+    auto pending = std::make_unique<PendingJoin>();
+    pending->pattern = *pattern;
+    if (!RegisterTap(pattern->probe_range, pending.get(),
+                     &PendingJoin::probe_range) ||
+        !RegisterTap(pattern->build_range, pending.get(),
+                     &PendingJoin::build_range) ||
+        !RegisterTap(pattern->build_key, pending.get(),
+                     &PendingJoin::build_key) ||
+        !RegisterTap(pattern->probe_key, pending.get(),
+                     &PendingJoin::probe_key)) {
+      // Overlapping candidate (e.g. a deeper join nested in this one)
+      // already claimed one of the nodes; keep the first.
+      ReleaseTaps(pending.get());
+      return absl::OkStatus();
+    }
+    pending_.emplace(&node, std::move(pending));
+    return absl::OkStatus();
+  }
+
+  absl::Status OnPostVisit(PlannerContext& context, const Expr& node) override {
+    if (auto it = taps_.find(&node); it != taps_.end()) {
+      Tap tap = it->second;
+      taps_.erase(it);
+      TapSubprogram(context, node, tap);
+    }
+    if (auto it = pending_.find(&node); it != pending_.end()) {
+      std::unique_ptr<PendingJoin> pending = std::move(it->second);
+      pending_.erase(it);
+      return MaybeRewrite(context, node, *pending);
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  struct PendingJoin {
+    JoinPattern pattern;
+    bool eligible = true;
+    std::shared_ptr<const DirectExpressionStep> probe_range;
+    std::shared_ptr<const DirectExpressionStep> build_range;
+    std::shared_ptr<const DirectExpressionStep> build_key;
+    std::shared_ptr<const DirectExpressionStep> probe_key;
+  };
+
+  using TapField = std::shared_ptr<const DirectExpressionStep> PendingJoin::*;
+
+  struct Tap {
+    PendingJoin* pending;
+    TapField field;
+  };
+
+  bool RegisterTap(const Expr* node, PendingJoin* pending, TapField field) {
+    return taps_.emplace(node, Tap{pending, field}).second;
+  }
+
+  void ReleaseTaps(PendingJoin* pending) {
+    for (auto it = taps_.begin(); it != taps_.end();) {
+      if (it->second.pending == pending) {
+        taps_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  // Takes ownership of the planned subprogram for `node`, sharing it between
+  // its original position (behind a transparent delegate) and the join step.
+  void TapSubprogram(PlannerContext& context, const Expr& node, Tap tap) {
+    auto* subexpression = context.program_builder().GetSubexpression(&node);
+    if (subexpression == nullptr || subexpression->IsFlattened() ||
+        !subexpression->IsRecursive()) {
+      tap.pending->eligible = false;
+      return;
+    }
+    auto program = subexpression->ExtractRecursiveProgram();
+    std::shared_ptr<const DirectExpressionStep> shared = std::move(program.step);
+    tap.pending->*tap.field = shared;
+    subexpression->set_recursive_program(
+        std::make_unique<SharedDelegateStep>(node.id(), std::move(shared)),
+        program.depth);
+  }
+
+  absl::Status MaybeRewrite(PlannerContext& context, const Expr& node,
+                            PendingJoin& pending) {
+    if (!pending.eligible || pending.probe_range == nullptr ||
+        pending.build_range == nullptr || pending.build_key == nullptr ||
+        pending.probe_key == nullptr) {
+      return absl::OkStatus();
+    }
+    auto* subexpression = context.program_builder().GetSubexpression(&node);
+    if (subexpression == nullptr || subexpression->IsFlattened() ||
+        !subexpression->IsRecursive()) {
+      return absl::OkStatus();
+    }
+    absl::optional<PlannerContext::ComprehensionSlotInfo> outer_slots =
+        context.LookupComprehensionSlots(node.id());
+    absl::optional<PlannerContext::ComprehensionSlotInfo> inner_slots =
+        context.LookupComprehensionSlots(pending.pattern.inner->id());
+    if (!outer_slots.has_value() || !inner_slots.has_value()) {
+      return absl::OkStatus();
+    }
+    auto program = subexpression->ExtractRecursiveProgram();
+    context.RecordOptimization(
+        node, "comprehension_join",
+        "rewrote equality-correlated nested comprehension as hash join");
+    subexpression->set_recursive_program(
+        std::make_unique<HashJoinComprehensionStep>(
+            node.id(), std::move(program.step), std::move(pending.probe_range),
+            std::move(pending.build_range), std::move(pending.build_key),
+            std::move(pending.probe_key), outer_slots->iter_slot,
+            inner_slots->iter_slot, pending.pattern.outer_is_all),
+        program.depth);
+    return absl::OkStatus();
+  }
+
+  absl::flat_hash_map<const Expr*, Tap> taps_;
+  absl::flat_hash_map<const Expr*, std::unique_ptr<PendingJoin>> pending_;
+};
+
+}  // namespace
+
+ProgramOptimizerFactory CreateComprehensionJoinOptimization() {
+  return [](PlannerContext& context, const AstImpl& ast) {
+    return std::make_unique<ComprehensionJoinOptimization>();
+  };
+}
+
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,46 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_COMPILER_COMPREHENSION_JOIN_OPTIMIZATION_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_COMPILER_COMPREHENSION_JOIN_OPTIMIZATION_H_
+
+#include "eval/compiler/flat_expr_builder_extensions.h"
+
+namespace google::api::expr::runtime {
+
+// Creates a program optimizer that rewrites equality-correlated nested
+// comprehensions into a build/probe hash join.
+//
+// `a.all(x, b.exists(y, y.id == x.id))` plans as a nested loop and evaluates
+// the inner comprehension once per outer element -- O(|a| * |b|) equality
+// checks. When the inner comprehension is the exists macro over a range that
+// does not depend on the outer iteration variable and its predicate is a
+// single equality with one side depending only on the inner variable, the
+// whole pattern is a join: the optimizer replaces it with a step that builds
+// a hash index over the inner keys once and probes it per outer element,
+// O(|a| + |b|).
+//
+// The rewrite applies to recursively planned subexpressions only
+// (RuntimeOptions::max_recursion_depth); stack machine plans are left
+// unchanged. The original program is retained and evaluated instead whenever
+// exactness cannot be guaranteed up front: tracing or attribute tracking is
+// active for the evaluation, a range is not a list, or a key falls outside
+// the indexed scalar domain (bool, numeric, string). Numeric keys are
+// canonicalized the same way on build and probe, so heterogeneous numeric
+// equality (`2.0` matching `2`) behaves exactly as the nested loop would.
+ProgramOptimizerFactory CreateComprehensionJoinOptimization();
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_COMPILER_COMPREHENSION_JOIN_OPTIMIZATION_H_
@@ -0,0 +1,241 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/comprehension_join_optimization.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "eval/compiler/cel_expression_builder_flat_impl.h"
+#include "eval/compiler/flat_expr_builder.h"
+#include "eval/compiler/plan_report.h"
+#include "eval/public/activation.h"
+#include "eval/public/builtin_func_registrar.h"
+#include "eval/public/cel_expression.h"
+#include "eval/public/cel_value.h"
+#include "eval/public/containers/container_backed_list_impl.h"
+#include "extensions/protobuf/ast_converters.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/function_registry.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_functions.h"
+#include "runtime/type_registry.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::internal::IsOkAndHolds;
+using ::google::api::expr::v1alpha1::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+
+// Evaluates `expression` with list variables `a` and `b` under a recursive
+// plan with the join optimization installed, returning the boolean result.
+class ComprehensionJoinOptimizationTest : public testing::Test {
+ protected:
+  absl::StatusOr<bool> Evaluate(absl::string_view expression,
+                                std::vector<CelValue> a,
+                                std::vector<CelValue> b) {
+    cel::RuntimeOptions options;
+    options.max_recursion_depth = -1;
+    CelExpressionBuilderFlatImpl builder(options);
+    builder.flat_expr_builder().AddProgramOptimizer(
+        CreateComprehensionJoinOptimization());
+    CEL_RETURN_IF_ERROR(RegisterBuiltinFunctions(builder.GetRegistry()));
+
+    CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<CelExpression> plan,
+                         builder.CreateExpression(&parsed_expr.expr(),
+                                                  &parsed_expr.source_info()));
+
+    ContainerBackedListImpl a_list(std::move(a));
+    ContainerBackedListImpl b_list(std::move(b));
+    Activation activation;
+    activation.InsertValue("a", CelValue::CreateList(&a_list));
+    activation.InsertValue("b", CelValue::CreateList(&b_list));
+
+    CEL_ASSIGN_OR_RETURN(CelValue result, plan->Evaluate(activation, &arena_));
+    if (!result.IsBool()) {
+      return absl::InternalError(result.DebugString());
+    }
+    return result.BoolOrDie();
+  }
+
+  google::protobuf::Arena arena_;
+};
+
+std::vector<CelValue> Int64List(std::vector<int64_t> values) {
+  std::vector<CelValue> result;
+  result.reserve(values.size());
+  for (int64_t value : values) {
+    result.push_back(CelValue::CreateInt64(value));
+  }
+  return result;
+}
+
+TEST_F(ComprehensionJoinOptimizationTest, ExistsJoin) {
+  constexpr absl::string_view kExpr = "a.exists(x, b.exists(y, y == x))";
+  EXPECT_THAT(Evaluate(kExpr, Int64List({1, 2, 3}), Int64List({7, 3})),
+              IsOkAndHolds(true));
+  EXPECT_THAT(Evaluate(kExpr, Int64List({1, 2, 3}), Int64List({7, 8})),
+              IsOkAndHolds(false));
+  EXPECT_THAT(Evaluate(kExpr, Int64List({}), Int64List({7, 8})),
+              IsOkAndHolds(false));
+  EXPECT_THAT(Evaluate(kExpr, Int64List({1}), Int64List({})),
+              IsOkAndHolds(false));
+}
+
+TEST_F(ComprehensionJoinOptimizationTest, AllJoin) {
+  constexpr absl::string_view kExpr = "a.all(x, b.exists(y, y == x))";
+  EXPECT_THAT(Evaluate(kExpr, Int64List({1, 2}), Int64List({2, 1, 3})),
+              IsOkAndHolds(true));
+  EXPECT_THAT(Evaluate(kExpr, Int64List({1, 2}), Int64List({1})),
+              IsOkAndHolds(false));
+  EXPECT_THAT(Evaluate(kExpr, Int64List({}), Int64List({})),
+              IsOkAndHolds(true));
+}
+
+TEST_F(ComprehensionJoinOptimizationTest, HeterogeneousNumericEquality) {
+  // 2.0 matches 2 across numeric domains, exactly as `==` would.
+  EXPECT_THAT(Evaluate("a.exists(x, b.exists(y, y == x))",
+                       {CelValue::CreateDouble(2.0)}, Int64List({2})),
+              IsOkAndHolds(true));
+  EXPECT_THAT(Evaluate("a.exists(x, b.exists(y, y == x))",
+                       {CelValue::CreateDouble(2.5)}, Int64List({2})),
+              IsOkAndHolds(false));
+}
+
+TEST_F(ComprehensionJoinOptimizationTest, MixedScalarKeys) {
+  std::vector<CelValue> b;
+  b.push_back(CelValue::CreateStringView("one"));
+  b.push_back(CelValue::CreateInt64(1));
+  EXPECT_THAT(Evaluate("a.exists(x, b.exists(y, y == x))",
+                       {CelValue::CreateStringView("one")}, std::move(b)),
+              IsOkAndHolds(true));
+}
+
+TEST_F(ComprehensionJoinOptimizationTest, NonScalarBuildKeysFallBack) {
+  // A list-valued build key is outside the indexed domain; the retained
+  // nested loop must produce the same answer.
+  ContainerBackedListImpl nested(Int64List({1}));
+  std::vector<CelValue> b;
+  b.push_back(CelValue::CreateList(&nested));
+  b.push_back(CelValue::CreateInt64(1));
+  EXPECT_THAT(Evaluate("a.exists(x, b.exists(y, y == x))", Int64List({1}),
+                       std::move(b)),
+              IsOkAndHolds(true));
+  std::vector<CelValue> b2;
+  b2.push_back(CelValue::CreateList(&nested));
+  EXPECT_THAT(Evaluate("a.exists(x, b.exists(y, y == x))", Int64List({1}),
+                       std::move(b2)),
+              IsOkAndHolds(false));
+}
+
+TEST_F(ComprehensionJoinOptimizationTest, CorrelatedRangeStillEvaluates) {
+  // The inner range depends on the outer variable, so the rewrite does not
+  // apply and the nested loop runs as planned.
+  EXPECT_THAT(Evaluate("a.exists(x, [x].exists(y, y == x))", Int64List({1}),
+                       Int64List({})),
+              IsOkAndHolds(true));
+}
+
+// Planner-level checks that the rewrite fires exactly when expected.
+class ComprehensionJoinPlanTest : public testing::Test {
+ public:
+  void SetUp() override {
+    ASSERT_OK(cel::RegisterStandardFunctions(function_registry_, options_));
+  }
+
+ protected:
+  absl::StatusOr<PlanReport> Plan(absl::string_view expression) {
+    FlatExprBuilder builder(function_registry_, type_registry_, options_);
+    builder.AddProgramOptimizer(CreateComprehensionJoinOptimization());
+    CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+    CEL_ASSIGN_OR_RETURN(auto ast,
+                         cel::extensions::CreateAstFromParsedExpr(parsed_expr));
+    PlanReport report;
+    CEL_RETURN_IF_ERROR(builder
+                            .CreateExpressionImpl(std::move(ast),
+                                                  /*issues=*/nullptr,
+                                                  builder.options(), &report)
+                            .status());
+    return report;
+  }
+
+  bool RecordedJoin(const PlanReport& report) {
+    for (const auto& optimization : report.optimizations) {
+      if (optimization.optimizer == "comprehension_join") {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  cel::RuntimeOptions options_;
+  cel::FunctionRegistry function_registry_;
+  cel::TypeRegistry type_registry_;
+};
+
+TEST_F(ComprehensionJoinPlanTest, RewritesEligiblePatterns) {
+  options_.max_recursion_depth = -1;
+  ASSERT_OK_AND_ASSIGN(PlanReport report,
+                       Plan("a.all(x, b.exists(y, y == x))"));
+  EXPECT_TRUE(RecordedJoin(report));
+
+  ASSERT_OK_AND_ASSIGN(report, Plan("a.exists(x, b.exists(y, y == x))"));
+  EXPECT_TRUE(RecordedJoin(report));
+
+  // Select-chain keys on either side of the equality.
+  ASSERT_OK_AND_ASSIGN(report,
+                       Plan("a.all(x, b.exists(y, y.claim.id == x.id))"));
+  EXPECT_TRUE(RecordedJoin(report));
+}
+
+TEST_F(ComprehensionJoinPlanTest, SkipsIneligiblePatterns) {
+  options_.max_recursion_depth = -1;
+  // Correlated inner range.
+  ASSERT_OK_AND_ASSIGN(PlanReport report,
+                       Plan("a.exists(x, x.items.exists(y, y == x.id))"));
+  EXPECT_FALSE(RecordedJoin(report));
+
+  // Not an equality predicate.
+  ASSERT_OK_AND_ASSIGN(report, Plan("a.exists(x, b.exists(y, y > x))"));
+  EXPECT_FALSE(RecordedJoin(report));
+
+  // Both equality sides touch the inner variable.
+  ASSERT_OK_AND_ASSIGN(report, Plan("a.exists(x, b.exists(y, y == y))"));
+  EXPECT_FALSE(RecordedJoin(report));
+
+  // Inner comprehension is all, not exists.
+  ASSERT_OK_AND_ASSIGN(report, Plan("a.exists(x, b.all(y, y == x))"));
+  EXPECT_FALSE(RecordedJoin(report));
+}
+
+TEST_F(ComprehensionJoinPlanTest, SkipsStackMachinePlans) {
+  // Without recursive planning there is no direct program to rewrite.
+  ASSERT_OK_AND_ASSIGN(PlanReport report,
+                       Plan("a.all(x, b.exists(y, y == x))"));
+  EXPECT_FALSE(RecordedJoin(report));
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
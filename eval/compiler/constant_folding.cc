@@ -20,22 +20,31 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/nullability.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/optional.h"
 #include "absl/types/variant.h"
 #include "base/ast_internal/ast_impl.h"
 #include "base/ast_internal/expr.h"
 #include "base/builtins.h"
 #include "base/kind.h"
 #include "base/type_provider.h"
+#include "common/casting.h"
+#include "common/native_type.h"
 #include "common/value.h"
 #include "common/value_manager.h"
 #include "eval/compiler/flat_expr_builder_extensions.h"
 #include "eval/compiler/resolver.h"
+#include "eval/eval/compiler_constant_step.h"
 #include "eval/eval/const_value_step.h"
 #include "eval/eval/evaluator_core.h"
+#include "internal/casts.h"
 #include "internal/status_macros.h"
 #include "runtime/activation.h"
+#include "runtime/activation_interface.h"
+#include "runtime/internal/constant_list_impl.h"
+#include "runtime/internal/constant_map_impl.h"
 #include "runtime/internal/convert_constant.h"
 
 namespace cel::runtime_internal {
@@ -54,7 +63,9 @@ using ::cel::ast_internal::Select;
 using ::cel::builtin::kAnd;
 using ::cel::builtin::kOr;
 using ::cel::builtin::kTernary;
+using ::cel::internal::down_cast;
 using ::cel::runtime_internal::ConvertConstant;
+using ::google::api::expr::runtime::CompilerConstantStep;
 using ::google::api::expr::runtime::CreateConstValueDirectStep;
 using ::google::api::expr::runtime::CreateConstValueStep;
 using ::google::api::expr::runtime::EvaluationListener;
@@ -70,8 +81,10 @@ using ::google::api::expr::runtime::Resolver;
 class ConstantFoldingExtension : public ProgramOptimizer {
  public:
   ConstantFoldingExtension(MemoryManagerRef memory_manager,
+                           absl::Nullable<const ActivationInterface*> pinned,
                            const TypeProvider& type_provider)
       : memory_manager_(memory_manager),
+        pinned_(pinned),
         state_(kDefaultStackLimit, kComprehensionSlotCount, type_provider,
                memory_manager_) {}
 
@@ -93,7 +106,13 @@ class ConstantFoldingExtension : public ProgramOptimizer {
   // if the comprehension variables are only used in a const way.
   static constexpr size_t kComprehensionSlotCount = 0;
 
+  // Elide a short-circuiting call whose condition folded to a constant bool,
+  // where short-circuiting fixes the outcome or the surviving branch.
+  absl::Status MaybeElideDeadBranch(PlannerContext& context, const Expr& node);
+
   MemoryManagerRef memory_manager_;
+  // Variables treated as constants when specializing, may be nullptr.
+  absl::Nullable<const ActivationInterface*> pinned_;
   Activation empty_;
   FlatExpressionEvaluatorState state_;
 
@@ -104,7 +123,16 @@ absl::Status ConstantFoldingExtension::OnPreVisit(PlannerContext& context,
                                                   const Expr& node) {
   struct IsConstVisitor {
     IsConst operator()(const Constant&) { return IsConst::kConditional; }
-    IsConst operator()(const Ident&) { return IsConst::kNonConst; }
+    IsConst operator()(const Ident& ident) {
+      // Pinned variables are constants for the purposes of specialization.
+      if (pinned != nullptr) {
+        auto found = pinned->FindVariable(value_factory, ident.name());
+        if (found.ok() && found->has_value()) {
+          return IsConst::kConditional;
+        }
+      }
+      return IsConst::kNonConst;
+    }
     IsConst operator()(const Comprehension&) {
       // Not yet supported, need to identify whether range and
       // iter vars are compatible with const folding.
@@ -159,10 +187,13 @@ absl::Status ConstantFoldingExtension::OnPreVisit(PlannerContext& context,
     }
 
     const Resolver& resolver;
+    absl::Nullable<const ActivationInterface*> pinned;
+    ValueManager& value_factory;
   };
 
-  IsConst is_const =
-      absl::visit(IsConstVisitor{context.resolver()}, node.kind());
+  IsConst is_const = absl::visit(
+      IsConstVisitor{context.resolver(), pinned_, state_.value_factory()},
+      node.kind());
   is_const_.push_back(is_const);
 
   return absl::OkStatus();
@@ -182,6 +213,9 @@ absl::Status ConstantFoldingExtension::OnPostVisit(PlannerContext& context,
     if (!is_const_.empty()) {
       is_const_.back() = IsConst::kNonConst;
     }
+    if (node.has_call_expr()) {
+      CEL_RETURN_IF_ERROR(MaybeElideDeadBranch(context, node));
+    }
     return absl::OkStatus();
   }
   ExecutionPathView subplan = context.GetSubplan(node);
@@ -195,7 +229,8 @@ absl::Status ConstantFoldingExtension::OnPostVisit(PlannerContext& context,
     CEL_ASSIGN_OR_RETURN(
         value, ConvertConstant(node.const_expr(), state_.value_factory()));
   } else {
-    ExecutionFrame frame(subplan, empty_, context.options(), state_);
+    ExecutionFrame frame(subplan, pinned_ != nullptr ? *pinned_ : empty_,
+                         context.options(), state_);
     state_.Reset();
     // Update stack size to accommodate sub expression.
     // This only results in a vector resize if the new maxsize is greater than
@@ -213,6 +248,28 @@ absl::Status ConstantFoldingExtension::OnPostVisit(PlannerContext& context,
     if (value->Is<UnknownValue>()) {
       return absl::OkStatus();
     }
+    if (node.has_list_expr()) {
+      // A folded scalar list literal is commonly a membership allowlist;
+      // rebuild it with hash-indexed Contains so `@in` is a single lookup.
+      // Falls back to the generic folded list when the elements don't
+      // qualify.
+      if (auto constant_list = cel::runtime_internal::TryMakeConstantList(
+              state_.value_factory(), value);
+          constant_list.has_value()) {
+        value = std::move(*constant_list);
+      }
+    }
+    if (node.has_map_expr()) {
+      // A folded string-keyed map literal is commonly used as a switch on a
+      // runtime key; rebuild it as a collision-free table so those lookups
+      // are a single probe. Falls back to the generic folded map when the
+      // keys don't qualify.
+      if (auto constant_map = cel::runtime_internal::TryMakeConstantMap(
+              state_.value_factory(), value);
+          constant_map.has_value()) {
+        value = std::move(*constant_map);
+      }
+    }
   }
 
   // If recursive planning enabled (recursion limit unbounded or at least 1),
@@ -221,6 +278,8 @@ absl::Status ConstantFoldingExtension::OnPostVisit(PlannerContext& context,
   // Constant folding is applied leaf to root based on the program plan so far,
   // so the planner will have an opportunity to validate that the recursion
   // limit is being followed when visiting parent nodes in the AST.
+  context.RecordOptimization(node, "constant_folding",
+                             "folded subexpression to a constant");
   if (context.options().max_recursion_depth != 0) {
     return context.ReplaceSubplan(
         node, CreateConstValueDirectStep(std::move(value), node.id()), 1);
@@ -235,6 +294,73 @@ absl::Status ConstantFoldingExtension::OnPostVisit(PlannerContext& context,
   return context.ReplaceSubplan(node, std::move(new_plan));
 }
 
+absl::Status ConstantFoldingExtension::MaybeElideDeadBranch(
+    PlannerContext& context, const Expr& node) {
+  // Only stack machine plans are rewritten here; recursive plans require
+  // dependency surgery and are left as planned.
+  if (context.options().max_recursion_depth != 0) {
+    return absl::OkStatus();
+  }
+  const Call& call = node.call_expr();
+  if (call.has_target()) {
+    return absl::OkStatus();
+  }
+  if (context.GetSubplan(node).empty()) {
+    // Already optimized out or suppressed.
+    return absl::OkStatus();
+  }
+  bool is_ternary = call.function() == kTernary;
+  if (!is_ternary && call.function() != kAnd && call.function() != kOr) {
+    return absl::OkStatus();
+  }
+  if (call.args().size() != (is_ternary ? 3 : 2)) {
+    return absl::OkStatus();
+  }
+
+  // The condition (left operand for && and ||) must have folded to a
+  // constant bool; anything else preserves runtime behavior, including
+  // errors.
+  const Expr& condition = call.args()[0];
+  ExecutionPathView condition_plan = context.GetSubplan(condition);
+  if (condition_plan.size() != 1 ||
+      condition_plan[0]->GetNativeTypeId() !=
+          NativeTypeId::For<CompilerConstantStep>()) {
+    return absl::OkStatus();
+  }
+  const Value& condition_value =
+      down_cast<const CompilerConstantStep*>(condition_plan[0].get())->value();
+  if (!InstanceOf<BoolValue>(condition_value)) {
+    return absl::OkStatus();
+  }
+  bool condition_bool = Cast<BoolValue>(condition_value).NativeValue();
+
+  if (is_ternary) {
+    // A constant condition fixes the surviving branch; the dead branch is
+    // dropped with the rest of the call.
+    const Expr& branch = call.args()[condition_bool ? 1 : 2];
+    if (context.GetSubplan(branch).empty()) {
+      return absl::OkStatus();
+    }
+    CEL_ASSIGN_OR_RETURN(ExecutionPath branch_plan,
+                         context.ExtractSubplan(branch));
+    context.RecordOptimization(node, "constant_folding",
+                               "elided dead ternary branch");
+    return context.ReplaceSubplan(node, std::move(branch_plan));
+  }
+
+  // `false && x` and `true || x` short-circuit to the condition regardless
+  // of `x`, even when `x` is an error or unknown. The other polarities
+  // depend on `x`'s type and are left alone.
+  if (condition_bool == (call.function() == kAnd)) {
+    return absl::OkStatus();
+  }
+  CEL_ASSIGN_OR_RETURN(ExecutionPath condition_subplan,
+                       context.ExtractSubplan(condition));
+  context.RecordOptimization(node, "constant_folding",
+                             "elided short-circuited operand");
+  return context.ReplaceSubplan(node, std::move(condition_subplan));
+}
+
 }  // namespace
 
 ProgramOptimizerFactory CreateConstantFoldingOptimizer(
@@ -242,7 +368,19 @@ ProgramOptimizerFactory CreateConstantFoldingOptimizer(
   return [memory_manager](PlannerContext& ctx, const AstImpl&)
              -> absl::StatusOr<std::unique_ptr<ProgramOptimizer>> {
     return std::make_unique<ConstantFoldingExtension>(
-        memory_manager, ctx.value_factory().type_provider());
+        memory_manager, /*pinned=*/nullptr,
+        ctx.value_factory().type_provider());
+  };
+}
+
+ProgramOptimizerFactory CreateConstantFoldingOptimizer(
+    MemoryManagerRef memory_manager,
+    const ActivationInterface& pinned_activation) {
+  return [memory_manager, pinned = &pinned_activation](
+             PlannerContext& ctx, const AstImpl&)
+             -> absl::StatusOr<std::unique_ptr<ProgramOptimizer>> {
+    return std::make_unique<ConstantFoldingExtension>(
+        memory_manager, pinned, ctx.value_factory().type_provider());
   };
 }
 
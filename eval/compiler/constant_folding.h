@@ -17,6 +17,7 @@
 
 #include "common/memory.h"
 #include "eval/compiler/flat_expr_builder_extensions.h"
+#include "runtime/activation_interface.h"
 
 namespace cel::runtime_internal {
 
@@ -30,6 +31,22 @@ namespace cel::runtime_internal {
 google::api::expr::runtime::ProgramOptimizerFactory
 CreateConstantFoldingOptimizer(MemoryManagerRef manager);
 
+// Create a constant folding extension that additionally specializes programs
+// against pinned variables.
+//
+// Variables bound in `pinned_activation` are treated as constants: their
+// values are folded through the plan, and `&&`, `||` and `_?_:_` calls whose
+// condition resolves to a constant bool are elided where short-circuiting
+// makes the outcome (or the surviving branch) fixed. Intended for
+// per-tenant bindings (feature flags, tiers) that never change over the life
+// of the program.
+//
+// `pinned_activation` and `manager` must outlive any programs created with
+// this extension.
+google::api::expr::runtime::ProgramOptimizerFactory
+CreateConstantFoldingOptimizer(
+    MemoryManagerRef manager, const ActivationInterface& pinned_activation);
+
 }  // namespace cel::runtime_internal
 
 #endif  // THIRD_PARTY_CEL_CPP_EVAL_COMPILER_CONSTANT_FOLDING_H_
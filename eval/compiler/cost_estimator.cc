@@ -0,0 +1,248 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/cost_estimator.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "base/ast_internal/ast_impl.h"
+#include "base/ast_internal/expr.h"
+#include "base/builtins.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::ast_internal::AstImpl;
+using ::cel::ast_internal::Expr;
+
+// Fixed per-node weights, in arbitrary cost units. The absolute scale is
+// meaningless; only ratios and the caller's limit matter.
+constexpr int64_t kConstCost = 1;
+constexpr int64_t kIdentCost = 2;
+constexpr int64_t kSelectCost = 2;
+constexpr int64_t kCallBaseCost = 4;
+constexpr int64_t kCreatePerElementCost = 2;
+constexpr int64_t kComprehensionBaseCost = 8;
+// Constant regex patterns cost proportionally to the pattern size, a proxy
+// for the compiled program size. Non-constant patterns additionally pay a
+// per-evaluation compilation charge.
+constexpr int64_t kRegexCostPerPatternChar = 2;
+constexpr int64_t kDynamicRegexCost = 256;
+
+int64_t SaturatingAdd(int64_t a, int64_t b) {
+  if (a > std::numeric_limits<int64_t>::max() - b) {
+    return std::numeric_limits<int64_t>::max();
+  }
+  return a + b;
+}
+
+int64_t SaturatingMul(int64_t a, int64_t b) {
+  if (a != 0 && b > std::numeric_limits<int64_t>::max() / a) {
+    return std::numeric_limits<int64_t>::max();
+  }
+  return a * b;
+}
+
+// Returns the dotted name of a pure ident/select chain ("request.items"),
+// or an empty string if `node` is any other shape.
+std::string SelectChainName(const Expr& node) {
+  if (node.has_ident_expr()) {
+    return node.ident_expr().name();
+  }
+  if (node.has_select_expr()) {
+    std::string operand = SelectChainName(node.select_expr().operand());
+    if (operand.empty()) {
+      return "";
+    }
+    return absl::StrCat(operand, ".", node.select_expr().field());
+  }
+  return "";
+}
+
+class CostEstimator : public ProgramOptimizer {
+ public:
+  explicit CostEstimator(const CostEstimatorOptions& options)
+      : options_(options) {}
+
+  absl::Status OnPreVisit(PlannerContext& context, const Expr& node) override {
+    path_.push_back(&node);
+    return absl::OkStatus();
+  }
+
+  absl::Status OnPostVisit(PlannerContext& context, const Expr& node) override {
+    if (path_.empty() || path_.back() != &node) {
+      return absl::InternalError("CostEstimator called out of order.");
+    }
+    path_.pop_back();
+
+    int64_t cost = NodeCost(node);
+    cost_by_id_[node.id()] = cost;
+
+    if (!path_.empty()) {
+      return absl::OkStatus();
+    }
+
+    // Root node: the whole expression has been analyzed.
+    if (options_.cost_callback) {
+      options_.cost_callback(cost);
+    }
+    if (options_.cost_limit > 0 && cost > options_.cost_limit) {
+      return absl::ResourceExhaustedError(
+          absl::StrCat("estimated expression cost ", cost,
+                       " exceeds cost limit ", options_.cost_limit));
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  // Cost of an already-visited subexpression. Zero for nodes the traversal
+  // has not reported (absent optional subexpressions).
+  int64_t ChildCost(const Expr& child) const {
+    auto it = cost_by_id_.find(child.id());
+    return it == cost_by_id_.end() ? 0 : it->second;
+  }
+
+  int64_t CallCost(const Expr& node) const {
+    const auto& call = node.call_expr();
+    int64_t cost = kCallBaseCost;
+    if (call.has_target()) {
+      cost = SaturatingAdd(cost, ChildCost(call.target()));
+    }
+    for (const auto& arg : call.args()) {
+      cost = SaturatingAdd(cost, ChildCost(arg));
+    }
+    if (call.function() == cel::builtin::kRegexMatch) {
+      // Pattern is the last argument in both the member and the free-function
+      // form.
+      if (!call.args().empty() && call.args().back().has_const_expr() &&
+          call.args().back().const_expr().has_string_value()) {
+        cost = SaturatingAdd(
+            cost, SaturatingMul(
+                      kRegexCostPerPatternChar,
+                      static_cast<int64_t>(
+                          call.args().back().const_expr().string_value().size())));
+      } else {
+        cost = SaturatingAdd(cost, kDynamicRegexCost);
+      }
+    }
+    return cost;
+  }
+
+  // Upper bound on the number of iterations a comprehension over `range` may
+  // perform.
+  int64_t IterationBound(const Expr& range) const {
+    if (range.has_list_expr()) {
+      return static_cast<int64_t>(range.list_expr().elements().size());
+    }
+    if (range.has_map_expr()) {
+      return static_cast<int64_t>(range.map_expr().entries().size());
+    }
+    std::string name = SelectChainName(range);
+    if (!name.empty()) {
+      auto it = options_.input_cardinalities.find(name);
+      if (it != options_.input_cardinalities.end()) {
+        return it->second;
+      }
+    }
+    return options_.unknown_iteration_bound;
+  }
+
+  int64_t NodeCost(const Expr& node) const {
+    if (node.has_const_expr()) {
+      return kConstCost;
+    }
+    if (node.has_ident_expr()) {
+      return kIdentCost;
+    }
+    if (node.has_select_expr()) {
+      return SaturatingAdd(ChildCost(node.select_expr().operand()),
+                           kSelectCost);
+    }
+    if (node.has_call_expr()) {
+      return CallCost(node);
+    }
+    if (node.has_list_expr()) {
+      const auto& elements = node.list_expr().elements();
+      int64_t cost =
+          SaturatingMul(kCreatePerElementCost,
+                        static_cast<int64_t>(elements.size()));
+      for (const auto& element : elements) {
+        cost = SaturatingAdd(cost, ChildCost(element.expr()));
+      }
+      return cost;
+    }
+    if (node.has_map_expr()) {
+      const auto& entries = node.map_expr().entries();
+      int64_t cost = SaturatingMul(kCreatePerElementCost,
+                                   static_cast<int64_t>(entries.size()));
+      for (const auto& entry : entries) {
+        if (entry.has_key()) {
+          cost = SaturatingAdd(cost, ChildCost(entry.key()));
+        }
+        if (entry.has_value()) {
+          cost = SaturatingAdd(cost, ChildCost(entry.value()));
+        }
+      }
+      return cost;
+    }
+    if (node.has_struct_expr()) {
+      const auto& fields = node.struct_expr().fields();
+      int64_t cost = SaturatingMul(kCreatePerElementCost,
+                                   static_cast<int64_t>(fields.size()));
+      for (const auto& field : fields) {
+        if (field.has_value()) {
+          cost = SaturatingAdd(cost, ChildCost(field.value()));
+        }
+      }
+      return cost;
+    }
+    if (node.has_comprehension_expr()) {
+      const auto& comprehension = node.comprehension_expr();
+      int64_t bound = IterationBound(comprehension.iter_range());
+      int64_t body_cost =
+          SaturatingAdd(ChildCost(comprehension.loop_condition()),
+                        ChildCost(comprehension.loop_step()));
+      int64_t cost = kComprehensionBaseCost;
+      cost = SaturatingAdd(cost, ChildCost(comprehension.iter_range()));
+      cost = SaturatingAdd(cost, ChildCost(comprehension.accu_init()));
+      cost = SaturatingAdd(cost, SaturatingMul(bound, body_cost));
+      cost = SaturatingAdd(cost, ChildCost(comprehension.result()));
+      return cost;
+    }
+    return 0;
+  }
+
+  CostEstimatorOptions options_;
+  std::vector<const Expr*> path_;
+  absl::flat_hash_map<int64_t, int64_t> cost_by_id_;
+};
+
+}  // namespace
+
+ProgramOptimizerFactory CreateCostEstimator(CostEstimatorOptions options) {
+  return [options = std::move(options)](PlannerContext&, const AstImpl&) {
+    return std::make_unique<CostEstimator>(options);
+  };
+}
+
+}  // namespace google::api::expr::runtime
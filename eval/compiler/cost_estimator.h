@@ -0,0 +1,64 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_COMPILER_COST_ESTIMATOR_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_COMPILER_COST_ESTIMATOR_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+
+namespace google::api::expr::runtime {
+
+// Options for the planning-time cost estimator extension.
+struct CostEstimatorOptions {
+  // Assumed worst-case iteration count for comprehension ranges whose size
+  // is not known statically (an identifier, a function result, etc.).
+  int64_t unknown_iteration_bound = 64;
+
+  // Declared cardinalities for named inputs, keyed by the (possibly dotted)
+  // name of the iteration range, e.g. {"request.items", 10}. Overrides
+  // `unknown_iteration_bound` when the range matches.
+  absl::flat_hash_map<std::string, int64_t> input_cardinalities;
+
+  // If greater than zero, planning fails with kResourceExhausted when the
+  // estimated cost exceeds this limit, rejecting the expression before it
+  // ever runs.
+  int64_t cost_limit = 0;
+
+  // If set, invoked with the estimated cost of each successfully analyzed
+  // expression, before the limit is enforced.
+  std::function<void(int64_t)> cost_callback;
+};
+
+// Create a new extension for the FlatExprBuilder that computes an upper-bound
+// evaluation cost for each planned expression.
+//
+// The estimate combines fixed per-node weights, comprehension iteration
+// bounds (literal range sizes, declared input cardinalities, or the
+// configured fallback), and the size of constant regex patterns passed to
+// `matches`. Costs inside a comprehension body are multiplied by the
+// iteration bound, so nested loops compound multiplicatively, and all
+// arithmetic saturates instead of overflowing.
+//
+// The estimate is an admission-control heuristic: it bounds work relative to
+// the declared inputs, it does not predict wall time.
+ProgramOptimizerFactory CreateCostEstimator(CostEstimatorOptions options);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_COMPILER_COST_ESTIMATOR_H_
@@ -0,0 +1,128 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/cost_estimator.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "eval/compiler/cel_expression_builder_flat_impl.h"
+#include "eval/compiler/flat_expr_builder.h"
+#include "eval/public/builtin_func_registrar.h"
+#include "eval/public/cel_expression.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::google::api::expr::parser::Parse;
+using cel::internal::StatusIs;
+using testing::Gt;
+using testing::HasSubstr;
+
+namespace exprpb = google::api::expr::v1alpha1;
+
+// Plans `expression` with the cost estimator installed and returns the
+// reported estimate.
+absl::StatusOr<int64_t> EstimateCost(const std::string& expression,
+                                     CostEstimatorOptions options = {}) {
+  int64_t cost = -1;
+  options.cost_callback = [&cost](int64_t estimate) { cost = estimate; };
+
+  CelExpressionBuilderFlatImpl builder;
+  builder.flat_expr_builder().AddProgramOptimizer(
+      CreateCostEstimator(std::move(options)));
+  CEL_RETURN_IF_ERROR(RegisterBuiltinFunctions(builder.GetRegistry()));
+
+  CEL_ASSIGN_OR_RETURN(exprpb::ParsedExpr expr, Parse(expression));
+  CEL_RETURN_IF_ERROR(
+      builder.CreateExpression(&expr.expr(), &expr.source_info()).status());
+  return cost;
+}
+
+TEST(CostEstimatorTest, ReportsCostForSimpleExpression) {
+  ASSERT_OK_AND_ASSIGN(int64_t cost, EstimateCost("1 + 2"));
+  EXPECT_GT(cost, 0);
+  EXPECT_LT(cost, 50);
+}
+
+TEST(CostEstimatorTest, LiteralRangeBoundsComprehension) {
+  ASSERT_OK_AND_ASSIGN(int64_t literal_cost,
+                       EstimateCost("[1, 2, 3].all(x, x > 0)"));
+  ASSERT_OK_AND_ASSIGN(int64_t unknown_cost,
+                       EstimateCost("input.all(x, x > 0)"));
+  // A three-element literal range is bounded at three iterations; an unknown
+  // range is charged the fallback bound (64 by default).
+  EXPECT_GT(unknown_cost, literal_cost);
+}
+
+TEST(CostEstimatorTest, DeclaredCardinalityBoundsComprehension) {
+  CostEstimatorOptions options;
+  options.input_cardinalities["request.items"] = 4;
+  ASSERT_OK_AND_ASSIGN(int64_t declared_cost,
+                       EstimateCost("request.items.all(x, x > 0)", options));
+  ASSERT_OK_AND_ASSIGN(int64_t fallback_cost,
+                       EstimateCost("request.items.all(x, x > 0)"));
+  EXPECT_GT(fallback_cost, declared_cost);
+}
+
+TEST(CostEstimatorTest, NestedComprehensionsCompound) {
+  ASSERT_OK_AND_ASSIGN(int64_t single_cost,
+                       EstimateCost("input.all(x, x > 0)"));
+  ASSERT_OK_AND_ASSIGN(
+      int64_t nested_cost,
+      EstimateCost("input.all(x, other.all(y, y > 0))"));
+  // The inner loop body is charged once per outer iteration.
+  EXPECT_GT(nested_cost, 32 * single_cost);
+}
+
+TEST(CostEstimatorTest, ConstantRegexPatternChargedBySize) {
+  ASSERT_OK_AND_ASSIGN(int64_t short_cost, EstimateCost("'a'.matches('a')"));
+  ASSERT_OK_AND_ASSIGN(
+      int64_t long_cost,
+      EstimateCost("'a'.matches('(a+)(b+)(c+)(d+)(e+)(f+)(g+)(h+)')"));
+  EXPECT_GT(long_cost, short_cost);
+}
+
+TEST(CostEstimatorTest, CostLimitRejectsAtPlanTime) {
+  CostEstimatorOptions options;
+  options.cost_limit = 10;
+
+  CelExpressionBuilderFlatImpl builder;
+  builder.flat_expr_builder().AddProgramOptimizer(
+      CreateCostEstimator(std::move(options)));
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+
+  ASSERT_OK_AND_ASSIGN(exprpb::ParsedExpr expr,
+                       Parse("input.all(x, x.matches('a+b+c+'))"));
+  EXPECT_THAT(
+      builder.CreateExpression(&expr.expr(), &expr.source_info()).status(),
+      StatusIs(absl::StatusCode::kResourceExhausted,
+               HasSubstr("cost limit")));
+}
+
+TEST(CostEstimatorTest, CostLimitAdmitsCheapExpression) {
+  CostEstimatorOptions options;
+  options.cost_limit = 1000;
+  ASSERT_OK_AND_ASSIGN(int64_t cost, EstimateCost("1 + 2 == 3", options));
+  EXPECT_THAT(cost, Gt(0));
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
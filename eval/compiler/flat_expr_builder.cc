@@ -50,12 +50,16 @@
 #include "common/ast.h"
 #include "common/ast_traverse.h"
 #include "common/ast_visitor.h"
+#include "common/casting.h"
 #include "common/memory.h"
+#include "common/native_type.h"
 #include "common/type.h"
 #include "common/value.h"
 #include "common/value_manager.h"
 #include "common/values/legacy_value_manager.h"
 #include "eval/compiler/flat_expr_builder_extensions.h"
+#include "eval/compiler/plan_cache.h"
+#include "eval/compiler/plan_report.h"
 #include "eval/compiler/resolver.h"
 #include "eval/eval/comprehension_step.h"
 #include "eval/eval/const_value_step.h"
@@ -71,15 +75,18 @@
 #include "eval/eval/lazy_init_step.h"
 #include "eval/eval/logic_step.h"
 #include "eval/eval/optional_or_step.h"
+#include "eval/eval/plan_arena.h"
 #include "eval/eval/select_step.h"
 #include "eval/eval/shadowable_value_step.h"
 #include "eval/eval/ternary_step.h"
 #include "eval/eval/trace_step.h"
+#include "internal/casts.h"
 #include "internal/status_macros.h"
 #include "runtime/internal/convert_constant.h"
 #include "runtime/internal/issue_collector.h"
 #include "runtime/runtime_issue.h"
 #include "runtime/runtime_options.h"
+#include "runtime/slot_activation.h"
 
 namespace google::api::expr::runtime {
 
@@ -97,6 +104,31 @@ using ::cel::runtime_internal::IssueCollector;
 
 constexpr absl::string_view kOptionalOrFn = "or";
 constexpr absl::string_view kOptionalOrValueFn = "orValue";
+constexpr absl::string_view kOptionalSelectFn = "_?._";
+
+// Equality between plan-time constant map keys, mirroring the runtime map key
+// semantics: keys of different kinds never compare equal.
+bool ConstMapKeysEqual(const cel::Value& lhs, const cel::Value& rhs) {
+  if (lhs->kind() != rhs->kind()) {
+    return false;
+  }
+  switch (lhs->kind()) {
+    case cel::ValueKind::kBool:
+      return cel::Cast<cel::BoolValue>(lhs).NativeValue() ==
+             cel::Cast<cel::BoolValue>(rhs).NativeValue();
+    case cel::ValueKind::kInt:
+      return cel::Cast<cel::IntValue>(lhs).NativeValue() ==
+             cel::Cast<cel::IntValue>(rhs).NativeValue();
+    case cel::ValueKind::kUint:
+      return cel::Cast<cel::UintValue>(lhs).NativeValue() ==
+             cel::Cast<cel::UintValue>(rhs).NativeValue();
+    case cel::ValueKind::kString:
+      return cel::Cast<cel::StringValue>(lhs).Equals(
+          cel::Cast<cel::StringValue>(rhs));
+    default:
+      return false;
+  }
+}
 
 // Forward declare to resolve circular dependency for short_circuiting visitors.
 class FlatExprVisitor;
@@ -249,6 +281,112 @@ class ExhaustiveTernaryCondVisitor : public CondVisitor {
   FlatExprVisitor* visitor_;
 };
 
+// Handler for speculatively evaluated ternaries (see
+// RuntimeOptions::speculation_executor). Instead of planning the branches
+// inline behind conditional jumps, a launch step is emitted ahead of the
+// condition, the branches are extracted as subexpressions once planned, and
+// a join step after the condition consumes the winning branch's result.
+class SpeculativeTernaryCondVisitor : public CondVisitor {
+ public:
+  explicit SpeculativeTernaryCondVisitor(FlatExprVisitor* visitor)
+      : visitor_(visitor) {}
+
+  void PreVisit(const cel::ast_internal::Expr* expr) override;
+  void PostVisitArg(int arg_num, const cel::ast_internal::Expr* expr) override {
+  }
+  void PostVisit(const cel::ast_internal::Expr* expr) override;
+
+ private:
+  FlatExprVisitor* visitor_;
+  // Owned by the program being built; the branch subexpression indices are
+  // patched in at PostVisit, like jump targets.
+  SpeculativeBranchesStep* launch_step_ = nullptr;
+};
+
+// Returns whether the given function is a standard builtin, which are all
+// free of side effects. Extension functions are conservatively assumed
+// impure since nothing in their registration says otherwise.
+bool IsPureBuiltinFunction(absl::string_view function) {
+  static const auto* kPureFunctions = new absl::flat_hash_set<absl::string_view>(
+      {cel::builtin::kEqual,        cel::builtin::kInequal,
+       cel::builtin::kLess,         cel::builtin::kLessOrEqual,
+       cel::builtin::kGreater,      cel::builtin::kGreaterOrEqual,
+       cel::builtin::kAnd,          cel::builtin::kOr,
+       cel::builtin::kNot,          cel::builtin::kNotStrictlyFalse,
+       cel::builtin::kAdd,          cel::builtin::kSubtract,
+       cel::builtin::kNeg,          cel::builtin::kMultiply,
+       cel::builtin::kDivide,       cel::builtin::kModulo,
+       cel::builtin::kRegexMatch,   cel::builtin::kStringContains,
+       cel::builtin::kStringEndsWith, cel::builtin::kStringStartsWith,
+       cel::builtin::kIn,           cel::builtin::kIndex,
+       cel::builtin::kSize,         cel::builtin::kTernary,
+       cel::builtin::kDuration,     cel::builtin::kTimestamp,
+       cel::builtin::kFullYear,     cel::builtin::kMonth,
+       cel::builtin::kDayOfYear,    cel::builtin::kDayOfMonth,
+       cel::builtin::kDate,         cel::builtin::kDayOfWeek,
+       cel::builtin::kHours,        cel::builtin::kMinutes,
+       cel::builtin::kSeconds,      cel::builtin::kMilliseconds,
+       cel::builtin::kBytes,        cel::builtin::kDouble,
+       cel::builtin::kDyn,          cel::builtin::kInt,
+       cel::builtin::kString,       cel::builtin::kType,
+       cel::builtin::kUint});
+  return kPureFunctions->contains(function);
+}
+
+// Returns whether the subtree is provably free of side effects, so that it
+// may be evaluated speculatively (possibly on another thread, possibly
+// discarded). Message construction is excluded since it goes through the
+// type provider rather than pure value operations.
+bool IsSpeculatablePure(const cel::ast_internal::Expr& expr) {
+  if (expr.has_const_expr() || expr.has_ident_expr()) {
+    return true;
+  }
+  if (expr.has_select_expr()) {
+    return IsSpeculatablePure(expr.select_expr().operand());
+  }
+  if (expr.has_call_expr()) {
+    const auto& call_expr = expr.call_expr();
+    if (!IsPureBuiltinFunction(call_expr.function())) {
+      return false;
+    }
+    if (call_expr.has_target() && !IsSpeculatablePure(call_expr.target())) {
+      return false;
+    }
+    for (const auto& arg : call_expr.args()) {
+      if (!IsSpeculatablePure(arg)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (expr.has_list_expr()) {
+    for (const auto& element : expr.list_expr().elements()) {
+      if (!IsSpeculatablePure(element.expr())) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (expr.has_map_expr()) {
+    for (const auto& entry : expr.map_expr().entries()) {
+      if (!IsSpeculatablePure(entry.key()) ||
+          !IsSpeculatablePure(entry.value())) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (expr.has_comprehension_expr()) {
+    const auto& comprehension = expr.comprehension_expr();
+    return IsSpeculatablePure(comprehension.iter_range()) &&
+           IsSpeculatablePure(comprehension.accu_init()) &&
+           IsSpeculatablePure(comprehension.loop_condition()) &&
+           IsSpeculatablePure(comprehension.loop_step()) &&
+           IsSpeculatablePure(comprehension.result());
+  }
+  return false;
+}
+
 // Returns whether this comprehension appears to be a standard map/filter
 // macro implementation. It is not exhaustive, so it is unsafe to use with
 // custom comprehensions outside of the standard macros or hand crafted ASTs.
@@ -462,6 +600,19 @@ class FlatExprVisitor : public cel::AstVisitor {
       SetProgressStatusError(
           MaybeExtractSubexpression(&expr, comprehension_stack_.back()));
     }
+
+    if (!speculative_branches_.empty()) {
+      if (auto it = speculative_branches_.find(&expr);
+          it != speculative_branches_.end() && it->second < 0) {
+        it->second = program_builder_.ExtractSubexpression(&expr);
+        if (it->second < 0) {
+          SetProgressStatusError(absl::InternalError(
+              "Failed to extract speculative ternary branch"));
+        }
+      }
+    }
+
+    RecordStackBound(expr);
   }
 
   void PostVisitConst(const cel::ast_internal::Expr& expr,
@@ -471,7 +622,7 @@ class FlatExprVisitor : public cel::AstVisitor {
     }
 
     absl::StatusOr<cel::Value> converted_value =
-        ConvertConstant(const_expr, value_factory_);
+        ConvertConstantInterned(const_expr);
 
     if (!converted_value.ok()) {
       SetProgressStatusError(converted_value.status());
@@ -489,6 +640,28 @@ class FlatExprVisitor : public cel::AstVisitor {
         CreateConstValueStep(std::move(converted_value).value(), expr.id()));
   }
 
+  // Converts an AST constant, interning string and bytes constants so that
+  // repeated literals share one backing value rather than one copy per
+  // occurrence in the plan.
+  absl::StatusOr<cel::Value> ConvertConstantInterned(
+      const cel::ast_internal::Constant& const_expr) {
+    if (!const_expr.has_string_value() && !const_expr.has_bytes_value()) {
+      return ConvertConstant(const_expr, value_factory_);
+    }
+    std::pair<bool, std::string> key(const_expr.has_bytes_value(),
+                                     const_expr.has_bytes_value()
+                                         ? const_expr.bytes_value()
+                                         : const_expr.string_value());
+    auto it = constant_pool_.find(key);
+    if (it != constant_pool_.end()) {
+      return it->second;
+    }
+    CEL_ASSIGN_OR_RETURN(cel::Value converted,
+                         ConvertConstant(const_expr, value_factory_));
+    constant_pool_.insert({std::move(key), converted});
+    return converted;
+  }
+
   struct SlotLookupResult {
     int slot;
     int subexpression;
@@ -526,6 +699,18 @@ class FlatExprVisitor : public cel::AstVisitor {
     return {-1, -1};
   }
 
+  // Records a plan error when `path` selects an undefined enumerator from a
+  // registered enum type. Returns true if an error was recorded.
+  bool FailOnUndefinedEnumValue(absl::string_view path) {
+    auto enum_type = resolver_.FindUndefinedEnumValue(path);
+    if (!enum_type.has_value()) {
+      return false;
+    }
+    SetProgressStatusError(absl::InvalidArgumentError(absl::StrCat(
+        "undefined value '", path, "' for enum '", *enum_type, "'")));
+    return true;
+  }
+
   // Ident node handler.
   // Invoked after child nodes are processed.
   void PostVisitIdent(const cel::ast_internal::Expr& expr,
@@ -563,6 +748,10 @@ class FlatExprVisitor : public cel::AstVisitor {
         namespace_stack_.clear();
         break;
       }
+      if (options_.enable_strict_enum_constant_folding &&
+          FailOnUndefinedEnumValue(qualified_path)) {
+        return;
+      }
       namespace_stack_.pop_front();
     }
 
@@ -571,9 +760,29 @@ class FlatExprVisitor : public cel::AstVisitor {
       // value.
       const_value = resolver_.FindConstant(path, expr.id());
       select_root_id = expr.id();
+      if (!const_value && options_.enable_strict_enum_constant_folding &&
+          FailOnUndefinedEnumValue(path)) {
+        return;
+      }
     }
 
     if (const_value) {
+      if (options_.enable_strict_enum_constant_folding &&
+          (*const_value).Is<cel::IntValue>()) {
+        // Strict mode: enum constants compile into plain constant steps. The
+        // value cannot be shadowed by an activation variable and evaluates
+        // without a per-evaluation lookup.
+        if (options_.max_recursion_depth != 0) {
+          SetRecursiveStep(
+              CreateConstValueDirectStep(std::move(const_value).value(),
+                                         select_root_id),
+              1);
+          return;
+        }
+        AddStep(CreateConstValueStep(std::move(const_value).value(),
+                                     select_root_id));
+        return;
+      }
       if (options_.max_recursion_depth != 0) {
         SetRecursiveStep(CreateDirectShadowableValueStep(
                              std::move(path), std::move(const_value).value(),
@@ -618,10 +827,17 @@ class FlatExprVisitor : public cel::AstVisitor {
       }
       return;
     }
+    // Activation-resolved identifier: assign a dense slot so activations
+    // built against this plan resolve the variable by array index.
+    size_t binding_slot = variable_binding_plan_->AssignSlot(ident_expr.name());
     if (options_.max_recursion_depth != 0) {
-      SetRecursiveStep(CreateDirectIdentStep(ident_expr.name(), expr.id()), 1);
+      SetRecursiveStep(
+          CreateDirectBoundIdentStep(ident_expr.name(), expr.id(),
+                                     variable_binding_plan_, binding_slot),
+          1);
     } else {
-      AddStep(CreateIdentStep(ident_expr, expr.id()));
+      AddStep(CreateBoundIdentStep(ident_expr, expr.id(),
+                                   variable_binding_plan_, binding_slot));
     }
   }
 
@@ -693,6 +909,17 @@ class FlatExprVisitor : public cel::AstVisitor {
       StringValue field =
           value_factory_.CreateUncheckedStringValue(select_expr.field());
 
+      if (!enable_optional_types_) {
+        // Fold chains of selects (a.b.c.d) into a single step so intermediate
+        // results never round-trip through the evaluator.
+        auto flattened = MaybeExtendDirectSelectPath(
+            deps[0], field, select_expr.test_only(), expr.id());
+        if (flattened != nullptr) {
+          SetRecursiveStep(std::move(flattened), *depth + 1);
+          return;
+        }
+      }
+
       SetRecursiveStep(
           CreateDirectSelectStep(std::move(deps[0]), std::move(field),
                                  select_expr.test_only(), expr.id(),
@@ -702,6 +929,31 @@ class FlatExprVisitor : public cel::AstVisitor {
       return;
     }
 
+    if (!enable_optional_types_ && select_expr.operand().has_select_expr()) {
+      // As above for the stack machine: if the operand's program ends in a
+      // flattenable select step, replace it with a combined select-path step
+      // covering the whole chain. Step counts stay consistent (pop one, add
+      // one) so jump offsets are unaffected.
+      auto* operand_subexpression =
+          program_builder_.GetSubexpression(&select_expr.operand());
+      if (operand_subexpression != nullptr &&
+          !operand_subexpression->IsFlattened() &&
+          !operand_subexpression->IsRecursive() &&
+          !operand_subexpression->elements().empty()) {
+        auto* operand_step = absl::get_if<std::unique_ptr<ExpressionStep>>(
+            &operand_subexpression->elements().back());
+        if (operand_step != nullptr && IsFlattenableSelectStep(**operand_step)) {
+          std::unique_ptr<ExpressionStep> released = std::move(*operand_step);
+          operand_subexpression->elements().pop_back();
+          AddStep(ExtendSelectPathStep(
+              std::move(released),
+              value_factory_.CreateUncheckedStringValue(select_expr.field()),
+              select_expr.test_only(), expr.id()));
+          return;
+        }
+      }
+    }
+
     AddStep(CreateSelectStep(select_expr, expr.id(),
                              options_.enable_empty_wrapper_null_unboxing,
                              value_factory_, enable_optional_types_));
@@ -726,7 +978,11 @@ class FlatExprVisitor : public cel::AstVisitor {
           this, BinaryCond::kOr, options_.short_circuiting);
     } else if (call_expr.function() == cel::builtin::kTernary) {
       if (options_.short_circuiting) {
-        cond_visitor = std::make_unique<TernaryCondVisitor>(this);
+        if (CanSpeculateTernary(expr, call_expr)) {
+          cond_visitor = std::make_unique<SpeculativeTernaryCondVisitor>(this);
+        } else {
+          cond_visitor = std::make_unique<TernaryCondVisitor>(this);
+        }
       } else {
         cond_visitor = std::make_unique<ExhaustiveTernaryCondVisitor>(this);
       }
@@ -1049,6 +1305,69 @@ class FlatExprVisitor : public cel::AstVisitor {
       return;
     }
 
+    // Special case for "_?._": when the field is a constant string, plan a
+    // fused optional-select step and fold chains of `.?` links (`a.?b.?c`)
+    // into a single step. The fused step tracks absence with a flag and
+    // constructs at most one OptionalValue per evaluation instead of boxing
+    // every intermediate link.
+    if (enable_optional_types_ && call_expr.function() == kOptionalSelectFn &&
+        !call_expr.has_target() && call_expr.args().size() == 2 &&
+        call_expr.args()[1].has_const_expr() &&
+        call_expr.args()[1].const_expr().has_string_value()) {
+      StringValue field = value_factory_.CreateUncheckedStringValue(
+          call_expr.args()[1].const_expr().string_value());
+      auto depth = RecursionEligible();
+      if (depth.has_value()) {
+        auto args = ExtractRecursiveDependencies();
+        if (args.size() != 2) {
+          SetProgressStatusError(absl::InvalidArgumentError(
+              "unexpected number of args for optional select operator"));
+          return;
+        }
+        // args[1] is the planned constant field step; the field is baked into
+        // the fused step instead.
+        auto fused =
+            MaybeExtendDirectOptionalSelectPath(args[0], field, expr.id());
+        if (fused == nullptr) {
+          fused = CreateDirectOptionalSelectPathStep(
+              std::move(args[0]), std::move(field), expr.id());
+        }
+        SetRecursiveStep(std::move(fused), *depth + 1);
+        return;
+      }
+      auto* field_subexpression =
+          program_builder_.GetSubexpression(&call_expr.args()[1]);
+      if (field_subexpression != nullptr &&
+          !field_subexpression->IsFlattened() &&
+          !field_subexpression->IsRecursive() &&
+          field_subexpression->elements().size() == 1) {
+        // Drop the constant field step; the fused step holds the field and
+        // pops only the operand.
+        field_subexpression->elements().pop_back();
+        auto* operand_subexpression =
+            program_builder_.GetSubexpression(&call_expr.args()[0]);
+        if (operand_subexpression != nullptr &&
+            !operand_subexpression->IsFlattened() &&
+            !operand_subexpression->IsRecursive() &&
+            !operand_subexpression->elements().empty()) {
+          auto* operand_step = absl::get_if<std::unique_ptr<ExpressionStep>>(
+              &operand_subexpression->elements().back());
+          if (operand_step != nullptr &&
+              IsOptionalSelectPathStep(**operand_step)) {
+            std::unique_ptr<ExpressionStep> released = std::move(*operand_step);
+            operand_subexpression->elements().pop_back();
+            AddStep(ExtendOptionalSelectPathStep(std::move(released),
+                                                 std::move(field), expr.id()));
+            return;
+          }
+        }
+        AddStep(CreateOptionalSelectPathStep(std::move(field), expr.id()));
+        return;
+      }
+      // Otherwise fall through to regular function dispatch; the constant
+      // field step is still in place, so the plan remains well formed.
+    }
+
     // Establish the search criteria for a given function.
     absl::string_view function = call_expr.function();
 
@@ -1117,6 +1436,8 @@ class FlatExprVisitor : public cel::AstVisitor {
       accu_slot = iter_slot + 1;
       slot_count = 2;
     }
+    extension_context_.RecordComprehensionSlots(expr.id(), iter_slot,
+                                                accu_slot);
     // If this is in the scope of an optimized bind accu-init, account the slots
     // to the outermost bind-init scope.
     //
@@ -1335,6 +1656,8 @@ class FlatExprVisitor : public cel::AstVisitor {
       ValidateOrError(entry.has_key(), "Map entry missing key");
       ValidateOrError(entry.has_value(), "Map entry missing value");
     }
+    absl::optional<std::vector<cel::Value>> const_keys =
+        TryPlanTimeMapKeys(map_expr);
     auto depth = RecursionEligible();
     if (depth.has_value()) {
       auto deps = ExtractRecursiveDependencies();
@@ -1343,14 +1666,60 @@ class FlatExprVisitor : public cel::AstVisitor {
             "Unexpected number of plan elements for CreateStruct expr"));
         return;
       }
+      if (const_keys.has_value()) {
+        // The keys are precomputed; keep only the value subexpressions.
+        std::vector<std::unique_ptr<DirectExpressionStep>> value_deps;
+        value_deps.reserve(map_expr.entries().size());
+        for (size_t i = 1; i < deps.size(); i += 2) {
+          value_deps.push_back(std::move(deps[i]));
+        }
+        SetRecursiveStep(
+            CreateDirectCreateConstKeyMapStep(std::move(*const_keys),
+                                              std::move(value_deps),
+                                              MakeOptionalIndicesSet(map_expr),
+                                              expr.id()),
+            *depth + 1);
+        return;
+      }
       auto step = CreateDirectCreateMapStep(
           std::move(deps), MakeOptionalIndicesSet(map_expr), expr.id());
       SetRecursiveStep(std::move(step), *depth + 1);
       return;
     }
-    AddStep(CreateCreateStructStepForMap(map_expr.entries().size(),
-                                         MakeOptionalIndicesSet(map_expr),
-                                         expr.id()));
+    AddStep(CreateCreateStructStepForMap(
+        map_expr.entries().size(), MakeOptionalIndicesSet(map_expr),
+        /*pre_validated_keys=*/const_keys.has_value(), expr.id()));
+  }
+
+  // Returns the map literal keys as plan-time constant values if every key
+  // is a constant, a valid map key kind, and distinct from all the others;
+  // nullopt otherwise. Ineligible literals keep the generic runtime path and
+  // its error behavior (including runtime duplicate key errors).
+  absl::optional<std::vector<cel::Value>> TryPlanTimeMapKeys(
+      const cel::MapExpr& map_expr) {
+    std::vector<cel::Value> keys;
+    keys.reserve(map_expr.entries().size());
+    for (const auto& entry : map_expr.entries()) {
+      if (!entry.has_key() || !entry.key().has_const_expr()) {
+        return absl::nullopt;
+      }
+      absl::StatusOr<cel::Value> converted =
+          ConvertConstantInterned(entry.key().const_expr());
+      if (!converted.ok() || !cel::CheckMapKey(*converted).ok()) {
+        return absl::nullopt;
+      }
+      keys.push_back(std::move(converted).value());
+    }
+    // Map literals are small; quadratic duplicate detection keeps this free
+    // of value hashing.
+    for (size_t i = 0; i < keys.size(); ++i) {
+      for (size_t j = i + 1; j < keys.size(); ++j) {
+        if (ConstMapKeysEqual(keys[i], keys[j])) {
+          return absl::nullopt;
+        }
+      }
+    }
+    return keys;
   }
 
   absl::Status progress_status() const { return progress_status_; }
@@ -1479,10 +1848,63 @@ class FlatExprVisitor : public cel::AstVisitor {
 
   size_t slot_count() const { return index_manager_.max_slot_count(); }
 
+  // Upper bound on the number of values simultaneously live on the value
+  // stack during one evaluation, computed bottom-up over the AST (see
+  // RecordStackBound). Used to size evaluator state instead of the step
+  // count, which overstates liveness by an order of magnitude on wide
+  // expressions.
+  size_t estimated_stack_size() const { return estimated_stack_size_; }
+
+  // Dense slot assignment for activation-resolved identifiers, built up in
+  // order of first use as ident steps are planned.
+  const std::shared_ptr<cel::VariableBindingPlan>& variable_binding_plan()
+      const {
+    return variable_binding_plan_;
+  }
+
   void AddOptimizer(std::unique_ptr<ProgramOptimizer> optimizer) {
     program_optimizers_.push_back(std::move(optimizer));
   }
 
+  // Returns whether the given ternary call should be planned for speculative
+  // branch evaluation. Requires an executor, branches the planner can prove
+  // side-effect-free, and no surrounding scope whose slots the extracted
+  // branches would need to capture (branches evaluate against their own
+  // state). Attribute tracking is excluded since branch sub-evaluations do
+  // not propagate attribute trails, and recursive planning is excluded since
+  // extraction assumes stack machine subexpressions.
+  bool CanSpeculateTernary(const cel::ast_internal::Expr& expr,
+                           const cel::ast_internal::Call& call_expr) const {
+    if (options_.speculation_executor == nullptr ||
+        options_.max_speculative_branches <= 0 ||
+        options_.max_recursion_depth != 0 ||
+        options_.unknown_processing !=
+            cel::UnknownProcessingOptions::kDisabled ||
+        options_.enable_missing_attribute_errors ||
+        !comprehension_stack_.empty()) {
+      return false;
+    }
+    if (call_expr.has_target() || call_expr.args().size() != 3) {
+      return false;
+    }
+    return IsSpeculatablePure(call_expr.args()[1]) &&
+           IsSpeculatablePure(call_expr.args()[2]);
+  }
+
+  // Registers a ternary branch to be extracted as a subexpression once it
+  // has been planned (see PostVisitExpr).
+  void MarkSpeculativeBranch(const cel::ast_internal::Expr* expr) {
+    speculative_branches_[expr] = -1;
+  }
+
+  // Returns the extracted subexpression index for a marked branch, or -1 if
+  // extraction has not happened (yet).
+  int ExtractedSpeculativeBranchIndex(
+      const cel::ast_internal::Expr* expr) const {
+    auto it = speculative_branches_.find(expr);
+    return it == speculative_branches_.end() ? -1 : it->second;
+  }
+
   // Tests the boolean predicate, and if false produces an InvalidArgumentError
   // which concatenates the error_message and any optional message_parts as the
   // error status message.
@@ -1518,6 +1940,71 @@ class FlatExprVisitor : public cel::AstVisitor {
     return resume_from_suppressed_branch_ != nullptr;
   }
 
+  // Previously recorded stack bound for a child node. Nodes outside the
+  // recorded set (e.g. synthesized defaults) occupy one slot.
+  size_t NodeStackBound(const cel::ast_internal::Expr& expr) const {
+    auto it = node_stack_bounds_.find(expr.id());
+    return it == node_stack_bounds_.end() ? 1 : it->second;
+  }
+
+  // Records an upper bound on the value stack occupancy while `expr`
+  // evaluates, from the bounds of its already-visited children. Evaluation
+  // order holds i sibling results on the stack while the (i+1)th child
+  // evaluates, so a node's bound is the max over children of (results held +
+  // child bound); every rule dominates its children, so the root's bound is
+  // the whole program's. Overestimates waste a few value slots;
+  // underestimates are absorbed by EvaluatorStack growth.
+  void RecordStackBound(const cel::ast_internal::Expr& expr) {
+    size_t bound = 1;
+    if (expr.has_select_expr()) {
+      bound = NodeStackBound(expr.select_expr().operand());
+    } else if (expr.has_call_expr()) {
+      const auto& call = expr.call_expr();
+      size_t held = 0;
+      if (call.has_target()) {
+        bound = NodeStackBound(call.target());
+        held = 1;
+      }
+      for (const auto& arg : call.args()) {
+        bound = std::max(bound, held + NodeStackBound(arg));
+        ++held;
+      }
+    } else if (expr.has_list_expr()) {
+      size_t held = 0;
+      for (const auto& element : expr.list_expr().elements()) {
+        bound = std::max(bound, held + NodeStackBound(element.expr()));
+        ++held;
+      }
+    } else if (expr.has_struct_expr()) {
+      size_t held = 0;
+      for (const auto& field : expr.struct_expr().fields()) {
+        bound = std::max(bound, held + NodeStackBound(field.value()));
+        ++held;
+      }
+    } else if (expr.has_map_expr()) {
+      size_t held = 0;
+      for (const auto& entry : expr.map_expr().entries()) {
+        bound = std::max(bound, held + NodeStackBound(entry.key()));
+        bound = std::max(bound, held + 1 + NodeStackBound(entry.value()));
+        held += 2;
+      }
+    } else if (expr.has_comprehension_expr()) {
+      const auto& comprehension = expr.comprehension_expr();
+      size_t body = std::max(
+          std::max(NodeStackBound(comprehension.iter_range()),
+                   NodeStackBound(comprehension.loop_condition())),
+          std::max(NodeStackBound(comprehension.loop_step()),
+                   NodeStackBound(comprehension.result())));
+      // An optimizable bind init is deferred into a subexpression that runs
+      // on the same stack mid-body, so it adds to the body bound rather than
+      // maxing with it; the loop machinery itself keeps a small constant
+      // number of values live.
+      bound = 3 + NodeStackBound(comprehension.accu_init()) + body;
+    }
+    node_stack_bounds_[expr.id()] = bound;
+    estimated_stack_size_ = std::max(estimated_stack_size_, bound);
+  }
+
   absl::Status MaybeExtractSubexpression(const cel::ast_internal::Expr* expr,
                                          ComprehensionStackRecord& record) {
     if (!record.is_optimizable_bind) {
@@ -1581,6 +2068,12 @@ class FlatExprVisitor : public cel::AstVisitor {
   ValueManager& value_factory_;
   absl::Status progress_status_;
 
+  // Interned string/bytes constants. Repeated literals in one program share
+  // a single value instead of one copy per occurrence; the bool in the key
+  // distinguishes bytes from string constants.
+  absl::flat_hash_map<std::pair<bool, std::string>, cel::Value>
+      constant_pool_;
+
   std::stack<
       std::pair<const cel::ast_internal::Expr*, std::unique_ptr<CondVisitor>>>
       cond_visitor_stack_;
@@ -1600,6 +2093,10 @@ class FlatExprVisitor : public cel::AstVisitor {
   const cel::RuntimeOptions& options_;
 
   std::vector<ComprehensionStackRecord> comprehension_stack_;
+  // Ternary branches planned for speculative evaluation, mapped to their
+  // extracted subexpression index (-1 until extracted).
+  absl::flat_hash_map<const cel::ast_internal::Expr*, int>
+      speculative_branches_;
   absl::flat_hash_set<const cel::ast_internal::Expr*> suppressed_branches_;
   const cel::ast_internal::Expr* resume_from_suppressed_branch_ = nullptr;
   std::vector<std::unique_ptr<ProgramOptimizer>> program_optimizers_;
@@ -1608,6 +2105,12 @@ class FlatExprVisitor : public cel::AstVisitor {
   ProgramBuilder& program_builder_;
   PlannerContext extension_context_;
   IndexManager index_manager_;
+  std::shared_ptr<cel::VariableBindingPlan> variable_binding_plan_ =
+      std::make_shared<cel::VariableBindingPlan>();
+
+  // Per-node value stack occupancy bounds; see RecordStackBound.
+  absl::flat_hash_map<int64_t, size_t> node_stack_bounds_;
+  size_t estimated_stack_size_ = 1;
 
   bool enable_optional_types_;
 };
@@ -1800,6 +2303,45 @@ void ExhaustiveTernaryCondVisitor::PostVisit(
   visitor_->AddStep(CreateTernaryStep(expr->id()));
 }
 
+void SpeculativeTernaryCondVisitor::PreVisit(
+    const cel::ast_internal::Expr* expr) {
+  if (!visitor_->ValidateOrError(
+          !expr->call_expr().has_target() &&
+              expr->call_expr().args().size() == 3,
+          "Invalid argument count for a ternary function call.")) {
+    return;
+  }
+  // The launch step precedes the condition so the branches overlap with it;
+  // its subexpression indices are patched in PostVisit once the branches
+  // have been extracted.
+  auto launch_step = CreateSpeculativeBranchesStep(expr->id());
+  launch_step_ = launch_step.get();
+  visitor_->AddStep(std::unique_ptr<ExpressionStep>(std::move(launch_step)));
+  visitor_->MarkSpeculativeBranch(&expr->call_expr().args()[1]);
+  visitor_->MarkSpeculativeBranch(&expr->call_expr().args()[2]);
+}
+
+void SpeculativeTernaryCondVisitor::PostVisit(
+    const cel::ast_internal::Expr* expr) {
+  int left_index =
+      visitor_->ExtractedSpeculativeBranchIndex(&expr->call_expr().args()[1]);
+  int right_index =
+      visitor_->ExtractedSpeculativeBranchIndex(&expr->call_expr().args()[2]);
+  if (!visitor_->ValidateOrError(
+          left_index >= 0 && right_index >= 0 && launch_step_ != nullptr,
+          "Error configuring speculative ternary: branch extraction "
+          "failed.")) {
+    return;
+  }
+  // Extracted subexpressions are flattened after the main program, which
+  // occupies index 0.
+  launch_step_->set_subexpressions(static_cast<size_t>(left_index) + 1,
+                                   static_cast<size_t>(right_index) + 1);
+  visitor_->AddStep(CreateSpeculativeTernaryStep(
+      static_cast<size_t>(left_index) + 1, static_cast<size_t>(right_index) + 1,
+      expr->id()));
+}
+
 void ComprehensionVisitor::PreVisit(const cel::ast_internal::Expr* expr) {
   if (is_trivial_) {
     visitor_->SuppressBranch(&expr->comprehension_expr().iter_range());
@@ -1904,17 +2446,163 @@ void ComprehensionVisitor::PostVisit(const cel::ast_internal::Expr* expr) {
                                             iter_slot_, accu_slot_);
 }
 
+// Returns the jump step at `index`, or nullptr if the step is not a jump.
+//
+// The steps are owned exclusively by the builder until the FlatExpression is
+// returned, so mutating their offsets during cleanup is safe despite the
+// const element type.
+JumpStepBase* AsJumpStep(ExecutionPath& path, size_t index) {
+  if (path[index]->GetNativeTypeId() !=
+      cel::NativeTypeId::For<JumpStepBase>()) {
+    return nullptr;
+  }
+  return cel::internal::down_cast<JumpStepBase*>(
+      const_cast<ExpressionStep*>(path[index].get()));
+}
+
+// Post-planning cleanup for a flattened plan: collapses chains of
+// unconditional jumps, then drops unreachable steps and compacts the path
+// with offset fixup. Shorter paths keep resident programs denser in the
+// instruction cache.
+//
+// Only jump steps advertise their targets (see JumpStepBase); comprehension
+// steps jump with offsets this pass cannot see, so plans containing them are
+// left uncompacted after chain resolution.
+void OptimizeJumps(ExecutionPath& path) {
+  size_t size = path.size();
+  bool has_jump = false;
+  bool has_opaque_jumper = false;
+  for (size_t i = 0; i < size; ++i) {
+    cel::NativeTypeId type_id = path[i]->GetNativeTypeId();
+    if (type_id == cel::NativeTypeId::For<JumpStepBase>()) {
+      has_jump = true;
+    } else if (type_id == cel::NativeTypeId::For<ComprehensionNextStep>() ||
+               type_id == cel::NativeTypeId::For<ComprehensionCondStep>()) {
+      has_opaque_jumper = true;
+    }
+  }
+  if (!has_jump) {
+    return;
+  }
+
+  // A jump at index i with offset d lands on index i + 1 + d; index `size` is
+  // the (valid) end of the plan. Malformed targets are reported as absent and
+  // left for the runtime bounds check.
+  auto target_of = [&](size_t index,
+                       const JumpStepBase* jump) -> absl::optional<size_t> {
+    if (!jump->jump_offset().has_value()) {
+      return absl::nullopt;
+    }
+    int64_t target = static_cast<int64_t>(index) + 1 + *jump->jump_offset();
+    if (target < 0 || target > static_cast<int64_t>(size)) {
+      return absl::nullopt;
+    }
+    return static_cast<size_t>(target);
+  };
+
+  // Resolve chains: a jump that lands on an unconditional jump may take that
+  // jump's target directly. Bounded by the path size to tolerate cycles.
+  for (size_t i = 0; i < size; ++i) {
+    JumpStepBase* jump = AsJumpStep(path, i);
+    if (jump == nullptr) {
+      continue;
+    }
+    absl::optional<size_t> target = target_of(i, jump);
+    if (!target.has_value()) {
+      continue;
+    }
+    size_t hops = 0;
+    while (*target < size && hops++ < size) {
+      const JumpStepBase* next = AsJumpStep(path, *target);
+      if (next == nullptr || !next->unconditional()) {
+        break;
+      }
+      absl::optional<size_t> next_target = target_of(*target, next);
+      if (!next_target.has_value()) {
+        break;
+      }
+      target = next_target;
+    }
+    jump->set_jump_offset(static_cast<int>(*target) - static_cast<int>(i) - 1);
+  }
+
+  if (has_opaque_jumper) {
+    return;
+  }
+
+  // Mark reachable steps. Control flow is sequential except for jump steps;
+  // conditional jumps both fall through and jump.
+  std::vector<bool> reachable(size, false);
+  std::vector<size_t> frontier;
+  if (size > 0) {
+    reachable[0] = true;
+    frontier.push_back(0);
+  }
+  while (!frontier.empty()) {
+    size_t i = frontier.back();
+    frontier.pop_back();
+    const JumpStepBase* jump = AsJumpStep(path, i);
+    absl::optional<size_t> target =
+        jump != nullptr ? target_of(i, jump) : absl::nullopt;
+    bool falls_through =
+        jump == nullptr || !jump->unconditional() || !target.has_value();
+    if (falls_through && i + 1 < size && !reachable[i + 1]) {
+      reachable[i + 1] = true;
+      frontier.push_back(i + 1);
+    }
+    if (target.has_value() && *target < size && !reachable[*target]) {
+      reachable[*target] = true;
+      frontier.push_back(*target);
+    }
+  }
+
+  // Compact the path, remembering original jump targets so offsets can be
+  // rewritten against the new indexes.
+  std::vector<size_t> new_index(size + 1, 0);
+  size_t kept = 0;
+  for (size_t i = 0; i < size; ++i) {
+    new_index[i] = kept;
+    if (reachable[i]) {
+      ++kept;
+    }
+  }
+  new_index[size] = kept;
+  if (kept == size) {
+    return;
+  }
+
+  ExecutionPath compacted;
+  compacted.reserve(kept);
+  for (size_t i = 0; i < size; ++i) {
+    if (!reachable[i]) {
+      continue;
+    }
+    JumpStepBase* jump = AsJumpStep(path, i);
+    if (jump != nullptr) {
+      if (absl::optional<size_t> target = target_of(i, jump);
+          target.has_value()) {
+        jump->set_jump_offset(static_cast<int>(new_index[*target]) -
+                              static_cast<int>(new_index[i]) - 1);
+      }
+    }
+    compacted.push_back(std::move(path[i]));
+  }
+  path = std::move(compacted);
+}
+
 // Flattens the expression table into the end of the mainline expression vector
 // and returns an index to the individual sub expressions.
 std::vector<ExecutionPathView> FlattenExpressionTable(
     ProgramBuilder& program_builder, ExecutionPath& main) {
   std::vector<std::pair<size_t, size_t>> ranges;
   main = program_builder.FlattenMain();
+  OptimizeJumps(main);
   ranges.push_back(std::make_pair(0, main.size()));
 
   std::vector<ExecutionPath> subexpressions =
       program_builder.FlattenSubexpressions();
   for (auto& subexpression : subexpressions) {
+    OptimizeJumps(subexpression);
     ranges.push_back(std::make_pair(main.size(), subexpression.size()));
     absl::c_move(subexpression, std::back_inserter(main));
   }
@@ -1928,27 +2616,109 @@ std::vector<ExecutionPathView> FlattenExpressionTable(
   return subexpression_indexes;
 }
 
+// Bundles a plan's step storage arena with the execution path it backs, so
+// arena-backed steps stay valid for as long as any FlatExpression shares the
+// path. The arena member is declared first: the step destructors run before
+// their storage is released.
+struct ArenaBackedPath {
+  PlanArena arena;
+  ExecutionPath path;
+};
+
+std::shared_ptr<const ExecutionPath> MakeSharedPath(PlanArena arena,
+                                                    ExecutionPath path) {
+  // Views into the path stay valid across the moves: moving the vector
+  // transfers its buffer.
+  auto bundle = std::make_shared<ArenaBackedPath>(
+      ArenaBackedPath{std::move(arena), std::move(path)});
+  const ExecutionPath* path_ptr = &bundle->path;
+  return std::shared_ptr<const ExecutionPath>(std::move(bundle), path_ptr);
+}
+
+// Fills the step listing and plan-wide totals of `report` from a flattened
+// execution path. Optimizer rewrites are recorded separately, as they happen.
+void FillPlanReportSteps(const ExecutionPath& path,
+                         size_t comprehension_slots_size,
+                         size_t value_stack_size, bool from_plan_cache,
+                         PlanReport& report) {
+  report.steps.reserve(path.size());
+  for (size_t i = 0; i < path.size(); ++i) {
+    const ExpressionStep& step = *path[i];
+    PlanReport::Step& entry = report.steps.emplace_back();
+    entry.index = i;
+    entry.expr_id = step.id();
+    entry.step_type = step.GetNativeTypeId().DebugString();
+    entry.cost = step.Cost();
+    report.estimated_cost += entry.cost;
+  }
+  report.comprehension_slot_count = comprehension_slots_size;
+  report.value_stack_size = value_stack_size;
+  report.from_plan_cache = from_plan_cache;
+}
+
 }  // namespace
 
 absl::StatusOr<FlatExpression> FlatExprBuilder::CreateExpressionImpl(
     std::unique_ptr<Ast> ast, std::vector<RuntimeIssue>* issues) const {
+  return CreateExpressionImpl(std::move(ast), issues, options_);
+}
+
+absl::StatusOr<FlatExpression> FlatExprBuilder::CreateExpressionImpl(
+    std::unique_ptr<Ast> ast, std::vector<RuntimeIssue>* issues,
+    const cel::RuntimeOptions& options) const {
+  return CreateExpressionImpl(std::move(ast), issues, options,
+                              /*report=*/nullptr);
+}
+
+absl::StatusOr<FlatExpression> FlatExprBuilder::CreateExpressionImpl(
+    std::unique_ptr<Ast> ast, std::vector<RuntimeIssue>* issues,
+    const cel::RuntimeOptions& options,
+    absl::Nullable<PlanReport*> report) const {
+  return PlanExpression(std::move(ast), issues, options, report,
+                        /*apply_program_optimizers=*/true);
+}
+
+absl::StatusOr<FlatExpression> FlatExprBuilder::CreateBaselineExpressionImpl(
+    std::unique_ptr<Ast> ast, std::vector<RuntimeIssue>* issues) const {
+  return PlanExpression(std::move(ast), issues, options_, /*report=*/nullptr,
+                        /*apply_program_optimizers=*/false);
+}
+
+absl::StatusOr<FlatExpression> FlatExprBuilder::PlanExpression(
+    std::unique_ptr<Ast> ast, std::vector<RuntimeIssue>* issues,
+    const cel::RuntimeOptions& options, absl::Nullable<PlanReport*> report,
+    bool apply_program_optimizers) const {
+  // Cached plans assume one configuration, so the cache only participates
+  // when planning with the builder's own options. Baseline (unoptimized)
+  // plans are excluded: cached plans are assumed fully optimized.
+  const bool use_plan_cache = plan_cache_ != nullptr && &options == &options_ &&
+                              apply_program_optimizers;
+
   // These objects are expected to remain scoped to one build call -- references
   // to them shouldn't be persisted in any part of the result expression.
   cel::common_internal::LegacyValueManager value_factory(
       cel::MemoryManagerRef::ReferenceCounting(),
       type_registry_.GetComposedTypeProvider());
 
-  RuntimeIssue::Severity max_severity = options_.fail_on_warnings
+  RuntimeIssue::Severity max_severity = options.fail_on_warnings
                                             ? RuntimeIssue::Severity::kWarning
                                             : RuntimeIssue::Severity::kError;
   IssueCollector issue_collector(max_severity);
   Resolver resolver(container_, function_registry_, type_registry_,
                     value_factory, type_registry_.resolveable_enums(),
-                    options_.enable_qualified_type_identifiers);
+                    options.enable_qualified_type_identifiers);
+
+  // Steps constructed during planning on this thread are pooled into this
+  // arena, keeping one program's steps contiguous in plan order. Declared
+  // before program_builder so that on error paths partially planned steps are
+  // destroyed before their storage.
+  PlanArena plan_arena;
+  absl::optional<PlanArenaScope> plan_arena_scope(absl::in_place, &plan_arena);
 
   ProgramBuilder program_builder;
-  PlannerContext extension_context(resolver, options_, value_factory,
+  PlannerContext extension_context(resolver, options, value_factory,
                                    issue_collector, program_builder);
+  extension_context.set_plan_report(report);
 
   auto& ast_impl = AstImpl::CastFromPublicAst(*ast);
 
@@ -1961,16 +2731,41 @@ absl::StatusOr<FlatExpression> FlatExprBuilder::CreateExpressionImpl(
     CEL_RETURN_IF_ERROR(transform->UpdateAst(extension_context, ast_impl));
   }
 
+  // The cache is consulted after AST transforms so rewrites (e.g. reference
+  // resolution) are reflected in the key.
+  if (use_plan_cache) {
+    if (const PlanCache::Entry* entry = plan_cache_->Lookup(ast_impl);
+        entry != nullptr) {
+      if (issues != nullptr) {
+        *issues = entry->issues;
+      }
+      if (report != nullptr) {
+        FillPlanReportSteps(*entry->path, entry->comprehension_slots_size,
+                            entry->value_stack_size,
+                            /*from_plan_cache=*/true, *report);
+      }
+      FlatExpression plan(entry->path, entry->subexpressions,
+                          entry->comprehension_slots_size,
+                          type_registry_.GetComposedTypeProvider(), options,
+                          entry->variable_binding_plan);
+      plan.set_value_stack_size(entry->value_stack_size);
+      return plan;
+    }
+  }
+
   std::vector<std::unique_ptr<ProgramOptimizer>> optimizers;
-  for (const ProgramOptimizerFactory& optimizer_factory : program_optimizers_) {
-    CEL_ASSIGN_OR_RETURN(auto optimizer,
-                         optimizer_factory(extension_context, ast_impl));
-    if (optimizer != nullptr) {
-      optimizers.push_back(std::move(optimizer));
+  if (apply_program_optimizers) {
+    for (const ProgramOptimizerFactory& optimizer_factory :
+         program_optimizers_) {
+      CEL_ASSIGN_OR_RETURN(auto optimizer,
+                           optimizer_factory(extension_context, ast_impl));
+      if (optimizer != nullptr) {
+        optimizers.push_back(std::move(optimizer));
+      }
     }
   }
 
-  FlatExprVisitor visitor(resolver, options_, std::move(optimizers),
+  FlatExprVisitor visitor(resolver, options, std::move(optimizers),
                           ast_impl.reference_map(), value_factory,
                           issue_collector, program_builder, extension_context,
                           enable_optional_types_);
@@ -1983,17 +2778,48 @@ absl::StatusOr<FlatExpression> FlatExprBuilder::CreateExpressionImpl(
     return visitor.progress_status();
   }
 
+  std::vector<RuntimeIssue> extracted_issues = issue_collector.ExtractIssues();
   if (issues != nullptr) {
-    (*issues) = issue_collector.ExtractIssues();
+    (*issues) = extracted_issues;
   }
 
   ExecutionPath execution_path;
   std::vector<ExecutionPathView> subexpressions =
       FlattenExpressionTable(program_builder, execution_path);
 
-  return FlatExpression(std::move(execution_path), std::move(subexpressions),
-                        visitor.slot_count(),
-                        type_registry_.GetComposedTypeProvider(), options_);
+  // Deactivate pooling before transferring the arena: from here on the steps
+  // and the storage backing them travel together in the shared path.
+  plan_arena_scope.reset();
+  std::shared_ptr<const ExecutionPath> shared_path =
+      MakeSharedPath(std::move(plan_arena), std::move(execution_path));
+
+  // The step count is a correct but wildly conservative stack size; prefer
+  // the planner's occupancy bound when it is tighter.
+  size_t value_stack_size =
+      std::min(shared_path->size(), visitor.estimated_stack_size());
+
+  if (report != nullptr) {
+    FillPlanReportSteps(*shared_path, visitor.slot_count(), value_stack_size,
+                        /*from_plan_cache=*/false, *report);
+  }
+
+  if (use_plan_cache) {
+    PlanCache::Entry entry;
+    entry.path = shared_path;
+    entry.subexpressions = subexpressions;
+    entry.comprehension_slots_size = visitor.slot_count();
+    entry.value_stack_size = value_stack_size;
+    entry.variable_binding_plan = visitor.variable_binding_plan();
+    entry.issues = std::move(extracted_issues);
+    plan_cache_->Insert(std::move(ast), std::move(entry));
+  }
+
+  FlatExpression plan(std::move(shared_path), std::move(subexpressions),
+                      visitor.slot_count(),
+                      type_registry_.GetComposedTypeProvider(), options,
+                      visitor.variable_binding_plan());
+  plan.set_value_stack_size(value_stack_size);
+  return plan;
 }
 
 }  // namespace google::api::expr::runtime
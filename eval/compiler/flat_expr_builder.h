@@ -22,9 +22,12 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/nullability.h"
 #include "absl/status/statusor.h"
 #include "base/ast.h"
 #include "eval/compiler/flat_expr_builder_extensions.h"
+#include "eval/compiler/plan_cache.h"
+#include "eval/compiler/plan_report.h"
 #include "eval/eval/evaluator_core.h"
 #include "eval/public/cel_type_registry.h"
 #include "runtime/function_registry.h"
@@ -79,13 +82,57 @@ class FlatExprBuilder {
       std::unique_ptr<cel::Ast> ast,
       std::vector<cel::RuntimeIssue>* issues) const;
 
+  // As above, but plans with `options` in place of the builder's configured
+  // options. Intended for per-program overrides, e.g. enabling unknown
+  // processing for the few programs that need it so the rest skip attribute
+  // trail maintenance entirely. The plan cache is bypassed on this path since
+  // cached plans assume the builder's configuration.
+  absl::StatusOr<FlatExpression> CreateExpressionImpl(
+      std::unique_ptr<cel::Ast> ast, std::vector<cel::RuntimeIssue>* issues,
+      const cel::RuntimeOptions& options) const;
+
+  // As above, additionally filling `report` (if non-null) with a structured
+  // account of the planned program: the flattened steps with expr-id
+  // provenance and cost estimates, rewrites recorded by program optimizers,
+  // and plan-wide totals. Intended for tooling; reports are not produced on
+  // the evaluation path.
+  absl::StatusOr<FlatExpression> CreateExpressionImpl(
+      std::unique_ptr<cel::Ast> ast, std::vector<cel::RuntimeIssue>* issues,
+      const cel::RuntimeOptions& options,
+      absl::Nullable<PlanReport*> report) const;
+
+  // As CreateExpressionImpl, but skips the registered program optimizers and
+  // bypasses the plan cache, trading plan quality for minimal planning
+  // latency. Registered AST transforms still run: they may be required for
+  // correctness (e.g. reference resolution). Baseline plans for tiered
+  // expressions use this; see
+  // CelExpressionBuilderFlatImpl::CreateTieredExpression.
+  absl::StatusOr<FlatExpression> CreateBaselineExpressionImpl(
+      std::unique_ptr<cel::Ast> ast,
+      std::vector<cel::RuntimeIssue>* issues) const;
+
   const cel::RuntimeOptions& options() const { return options_; }
 
   // Called by `cel::extensions::EnableOptionalTypes` to indicate that special
   // `optional_type` handling is needed.
   void enable_optional_types() { enable_optional_types_ = true; }
 
+  // Shares planned programs across CreateExpressionImpl calls through a
+  // content-addressed cache: structurally identical expressions reuse one
+  // immutable execution path instead of being planned again.
+  //
+  // The cache may be shared with other builders, but only if they are
+  // configured identically; see PlanCache.
+  void set_plan_cache(std::shared_ptr<PlanCache> plan_cache) {
+    plan_cache_ = std::move(plan_cache);
+  }
+
  private:
+  absl::StatusOr<FlatExpression> PlanExpression(
+      std::unique_ptr<cel::Ast> ast, std::vector<cel::RuntimeIssue>* issues,
+      const cel::RuntimeOptions& options, absl::Nullable<PlanReport*> report,
+      bool apply_program_optimizers) const;
+
   cel::RuntimeOptions options_;
   std::string container_;
   bool enable_optional_types_ = false;
@@ -95,6 +142,7 @@ class FlatExprBuilder {
   const cel::TypeRegistry& type_registry_;
   std::vector<std::unique_ptr<AstTransform>> ast_transforms_;
   std::vector<ProgramOptimizerFactory> program_optimizers_;
+  std::shared_ptr<PlanCache> plan_cache_;
 };
 
 }  // namespace google::api::expr::runtime
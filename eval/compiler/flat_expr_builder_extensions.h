@@ -23,7 +23,9 @@
 #define THIRD_PARTY_CEL_CPP_EVAL_COMPILER_FLAT_EXPR_BUILDER_EXTENSIONS_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -33,6 +35,7 @@
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "absl/types/variant.h"
 #include "base/ast.h"
@@ -41,6 +44,7 @@
 #include "common/native_type.h"
 #include "common/value.h"
 #include "common/value_manager.h"
+#include "eval/compiler/plan_report.h"
 #include "eval/compiler/resolver.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
@@ -380,12 +384,57 @@ class PlannerContext {
     return issue_collector_;
   }
 
+  // Sets the destination for optimizer rewrite records. May be null (the
+  // default): recording is then a no-op. Set by the builder when the caller
+  // requested a plan report.
+  void set_plan_report(absl::Nullable<PlanReport*> report) {
+    plan_report_ = report;
+  }
+
+  // Records that an optimizer rewrote the subplan for `node`. No-op unless a
+  // plan report was requested for this build.
+  void RecordOptimization(const cel::ast_internal::Expr& node,
+                          absl::string_view optimizer,
+                          absl::string_view description) {
+    if (plan_report_ != nullptr) {
+      plan_report_->optimizations.push_back(PlanReport::Optimization{
+          node.id(), std::string(optimizer), std::string(description)});
+    }
+  }
+
+  // Comprehension variable slots assigned by the planner, keyed by the
+  // comprehension expr id.
+  struct ComprehensionSlotInfo {
+    size_t iter_slot;
+    size_t accu_slot;
+  };
+
+  // Called by the planner as it reserves slots for a comprehension. Optimizers
+  // may look the assignment up to build replacement steps that cooperate with
+  // the planned comprehension variable storage.
+  void RecordComprehensionSlots(int64_t expr_id, size_t iter_slot,
+                                size_t accu_slot) {
+    comprehension_slot_info_[expr_id] =
+        ComprehensionSlotInfo{iter_slot, accu_slot};
+  }
+
+  absl::optional<ComprehensionSlotInfo> LookupComprehensionSlots(
+      int64_t expr_id) const {
+    auto it = comprehension_slot_info_.find(expr_id);
+    if (it == comprehension_slot_info_.end()) {
+      return absl::nullopt;
+    }
+    return it->second;
+  }
+
  private:
   const Resolver& resolver_;
   cel::ValueManager& value_factory_;
   const cel::RuntimeOptions& options_;
   cel::runtime_internal::IssueCollector& issue_collector_;
   ProgramBuilder& program_builder_;
+  absl::Nullable<PlanReport*> plan_report_ = nullptr;
+  absl::flat_hash_map<int64_t, ComprehensionSlotInfo> comprehension_slot_info_;
 };
 
 // Interface for Ast Transforms.
@@ -21,6 +21,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -30,6 +31,7 @@
 #include "google/protobuf/descriptor.pb.h"
 #include "google/protobuf/text_format.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_split.h"
@@ -1378,6 +1380,176 @@ TEST(FlatExprBuilderTest, ComprehensionBudget) {
                        HasSubstr("Iteration budget exceeded")));
 }
 
+TEST(FlatExprBuilderTest, SpeculativeTernaryInlineExecutor) {
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr,
+                       parser::Parse("a < 10 ? a + 1 : a - 2"));
+
+  int speculative_tasks = 0;
+  cel::RuntimeOptions options;
+  options.speculation_executor =
+      [&speculative_tasks](absl::AnyInvocable<void()> task) {
+        ++speculative_tasks;
+        std::move(task)();
+      };
+  CelExpressionBuilderFlatImpl builder(options);
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr,
+                       builder.CreateExpression(&parsed_expr.expr(),
+                                                &parsed_expr.source_info()));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  activation.InsertValue("a", CelValue::CreateInt64(5));
+  ASSERT_OK_AND_ASSIGN(CelValue result, cel_expr->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsInt64());
+  EXPECT_EQ(result.Int64OrDie(), 6);
+  // Both branches were started speculatively.
+  EXPECT_EQ(speculative_tasks, 2);
+
+  Activation false_activation;
+  false_activation.InsertValue("a", CelValue::CreateInt64(50));
+  ASSERT_OK_AND_ASSIGN(result, cel_expr->Evaluate(false_activation, &arena));
+  ASSERT_TRUE(result.IsInt64());
+  EXPECT_EQ(result.Int64OrDie(), 48);
+  EXPECT_EQ(speculative_tasks, 4);
+}
+
+TEST(FlatExprBuilderTest, SpeculativeTernaryThreadedExecutor) {
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr,
+                       parser::Parse("a < 10 ? a + 1 : a - 2"));
+
+  cel::RuntimeOptions options;
+  options.speculation_executor = [](absl::AnyInvocable<void()> task) {
+    std::thread(std::move(task)).detach();
+  };
+  CelExpressionBuilderFlatImpl builder(options);
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr,
+                       builder.CreateExpression(&parsed_expr.expr(),
+                                                &parsed_expr.source_info()));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  activation.InsertValue("a", CelValue::CreateInt64(5));
+  ASSERT_OK_AND_ASSIGN(CelValue result, cel_expr->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsInt64());
+  EXPECT_EQ(result.Int64OrDie(), 6);
+}
+
+TEST(FlatExprBuilderTest, SpeculativeTernaryErrorCondition) {
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr,
+                       parser::Parse("c ? a + 1 : a - 2"));
+
+  cel::RuntimeOptions options;
+  options.speculation_executor = [](absl::AnyInvocable<void()> task) {
+    std::move(task)();
+  };
+  CelExpressionBuilderFlatImpl builder(options);
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr,
+                       builder.CreateExpression(&parsed_expr.expr(),
+                                                &parsed_expr.source_info()));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  activation.InsertValue("a", CelValue::CreateInt64(5));
+  // "c" is unbound, so the condition produces an error, which bypasses both
+  // branches just like the jump-based plan.
+  ASSERT_OK_AND_ASSIGN(CelValue result, cel_expr->Evaluate(activation, &arena));
+  EXPECT_TRUE(result.IsError());
+}
+
+TEST(FlatExprBuilderTest, SpeculativeTernaryBudgetFallsBackSequential) {
+  ASSERT_OK_AND_ASSIGN(
+      ParsedExpr parsed_expr,
+      parser::Parse("(a < 10 ? a + 1 : a - 2) + (a > 3 ? 100 : 200)"));
+
+  int speculative_tasks = 0;
+  cel::RuntimeOptions options;
+  // Only the first ternary fits in the budget; the second falls back to
+  // sequential evaluation of the chosen branch.
+  options.max_speculative_branches = 2;
+  options.speculation_executor =
+      [&speculative_tasks](absl::AnyInvocable<void()> task) {
+        ++speculative_tasks;
+        std::move(task)();
+      };
+  CelExpressionBuilderFlatImpl builder(options);
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr,
+                       builder.CreateExpression(&parsed_expr.expr(),
+                                                &parsed_expr.source_info()));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  activation.InsertValue("a", CelValue::CreateInt64(5));
+  ASSERT_OK_AND_ASSIGN(CelValue result, cel_expr->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsInt64());
+  EXPECT_EQ(result.Int64OrDie(), 106);
+  EXPECT_EQ(speculative_tasks, 2);
+}
+
+TEST(FlatExprBuilderTest, EvaluationCostBudget) {
+  Expr expr;
+  SourceInfo source_info;
+  // [1, 2].all(x, x > 0)
+  ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(R"(
+    comprehension_expr {
+      iter_var: "k"
+      accu_var: "accu"
+      accu_init {
+        const_expr { bool_value: true }
+      }
+      loop_condition { ident_expr { name: "accu" } }
+      result { ident_expr { name: "accu" } }
+      loop_step {
+        call_expr {
+          function: "_&&_"
+          args {
+            ident_expr { name: "accu" }
+          }
+          args {
+            call_expr {
+              function: "_>_"
+              args { ident_expr { name: "k" } }
+              args { const_expr { int64_value: 0 } }
+            }
+          }
+        }
+      }
+      iter_range {
+        list_expr {
+          elements { const_expr { int64_value: 1 } }
+          elements { const_expr { int64_value: 2 } }
+        }
+      }
+    })",
+                                                  &expr));
+
+  cel::RuntimeOptions options;
+  options.evaluation_cost_budget = 10;
+  CelExpressionBuilderFlatImpl builder(options);
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr,
+                       builder.CreateExpression(&expr, &source_info));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  EXPECT_THAT(cel_expr->Evaluate(activation, &arena).status(),
+              StatusIs(absl::StatusCode::kResourceExhausted,
+                       HasSubstr("cost budget exceeded")));
+
+  // The same expression completes within a generous budget.
+  options.evaluation_cost_budget = 1000;
+  CelExpressionBuilderFlatImpl unconstrained_builder(options);
+  ASSERT_OK(RegisterBuiltinFunctions(unconstrained_builder.GetRegistry()));
+  ASSERT_OK_AND_ASSIGN(cel_expr, unconstrained_builder.CreateExpression(
+                                     &expr, &source_info));
+  ASSERT_OK_AND_ASSIGN(CelValue result, cel_expr->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsBool());
+  EXPECT_TRUE(result.BoolOrDie());
+}
+
 TEST(FlatExprBuilderTest, SimpleEnumTest) {
   TestMessage message;
   Expr expr;
@@ -0,0 +1,223 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/inlined_builtin_optimization.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "base/ast_internal/ast_impl.h"
+#include "base/ast_internal/expr.h"
+#include "base/builtins.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+#include "eval/compiler/resolver.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/inlined_builtin_step.h"
+#include "internal/status_macros.h"
+#include "runtime/runtime_options.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::ast_internal::AstImpl;
+using ::cel::ast_internal::Expr;
+
+struct InlinedBuiltin {
+  InlinedBuiltinOp op;
+  const Expr* operand;
+};
+
+// Returns the single overload id the checker resolved for the call, or an
+// empty view.
+absl::string_view ResolvedOverload(const Expr& expr, const AstImpl& ast) {
+  const auto& reference_map = ast.reference_map();
+  auto reference = reference_map.find(expr.id());
+  if (reference == reference_map.end() ||
+      reference->second.overload_id().size() != 1) {
+    return absl::string_view();
+  }
+  return reference->second.overload_id().front();
+}
+
+absl::optional<InlinedBuiltin> MatchInlinedBuiltin(const Expr& expr,
+                                                   const AstImpl& ast) {
+  if (!expr.has_call_expr()) {
+    return absl::nullopt;
+  }
+  const auto& call_expr = expr.call_expr();
+  absl::string_view overload = ResolvedOverload(expr, ast);
+  if (overload.empty()) {
+    return absl::nullopt;
+  }
+  absl::string_view function = call_expr.function();
+  const bool global_unary =
+      !call_expr.has_target() && call_expr.args().size() == 1;
+  const bool member_nullary =
+      call_expr.has_target() && call_expr.args().empty();
+
+  if (function == cel::builtin::kNot) {
+    if (global_unary && overload == "logical_not") {
+      return InlinedBuiltin{InlinedBuiltinOp::kNot, &call_expr.args()[0]};
+    }
+    return absl::nullopt;
+  }
+
+  if (function == cel::builtin::kNeg) {
+    if (global_unary && overload == "negate_int64") {
+      return InlinedBuiltin{InlinedBuiltinOp::kNegateInt64,
+                            &call_expr.args()[0]};
+    }
+    if (global_unary && overload == "negate_double") {
+      return InlinedBuiltin{InlinedBuiltinOp::kNegateDouble,
+                            &call_expr.args()[0]};
+    }
+    return absl::nullopt;
+  }
+
+  if (function == cel::builtin::kSize) {
+    // size() has global and receiver style standard overloads with distinct
+    // overload ids; both pin the operand type.
+    struct SizeOverload {
+      absl::string_view global_id;
+      absl::string_view member_id;
+      InlinedBuiltinOp op;
+    };
+    static constexpr SizeOverload kSizeOverloads[] = {
+        {"size_string", "string_size", InlinedBuiltinOp::kSizeString},
+        {"size_bytes", "bytes_size", InlinedBuiltinOp::kSizeBytes},
+        {"size_list", "list_size", InlinedBuiltinOp::kSizeList},
+        {"size_map", "map_size", InlinedBuiltinOp::kSizeMap},
+    };
+    for (const SizeOverload& size_overload : kSizeOverloads) {
+      if (global_unary && overload == size_overload.global_id) {
+        return InlinedBuiltin{size_overload.op, &call_expr.args()[0]};
+      }
+      if (member_nullary && overload == size_overload.member_id) {
+        return InlinedBuiltin{size_overload.op, &call_expr.target()};
+      }
+    }
+    return absl::nullopt;
+  }
+
+  if (function == cel::builtin::kString || function == cel::builtin::kInt ||
+      function == cel::builtin::kDouble) {
+    if (!global_unary) {
+      return absl::nullopt;
+    }
+    // Conversions whose overload id pins the operand kind. Identity
+    // conversions and the bool/timestamp/duration operands are left to
+    // regular dispatch.
+    struct ConversionOverload {
+      absl::string_view id;
+      InlinedBuiltinOp op;
+    };
+    static constexpr ConversionOverload kConversionOverloads[] = {
+        {"int64_to_string", InlinedBuiltinOp::kStringFromInt},
+        {"uint64_to_string", InlinedBuiltinOp::kStringFromUint},
+        {"double_to_string", InlinedBuiltinOp::kStringFromDouble},
+        {"string_to_int64", InlinedBuiltinOp::kIntFromString},
+        {"double_to_int64", InlinedBuiltinOp::kIntFromDouble},
+        {"uint64_to_int64", InlinedBuiltinOp::kIntFromUint},
+        {"int64_to_double", InlinedBuiltinOp::kDoubleFromInt},
+        {"uint64_to_double", InlinedBuiltinOp::kDoubleFromUint},
+        {"string_to_double", InlinedBuiltinOp::kDoubleFromString},
+    };
+    for (const ConversionOverload& conversion : kConversionOverloads) {
+      if (overload == conversion.id) {
+        return InlinedBuiltin{conversion.op, &call_expr.args()[0]};
+      }
+    }
+    return absl::nullopt;
+  }
+
+  return absl::nullopt;
+}
+
+class InlinedBuiltinOptimization : public ProgramOptimizer {
+ public:
+  explicit InlinedBuiltinOptimization(const AstImpl& ast) : ast_(ast) {}
+
+  absl::Status OnPreVisit(PlannerContext& context, const Expr& node) override {
+    return absl::OkStatus();
+  }
+
+  absl::Status OnPostVisit(PlannerContext& context, const Expr& node) override {
+    // With unknown processing the function steps also inspect the operand's
+    // attribute trail, which the inlined step does not replicate.
+    if (context.options().unknown_processing !=
+        cel::UnknownProcessingOptions::kDisabled) {
+      return absl::OkStatus();
+    }
+
+    absl::optional<InlinedBuiltin> builtin = MatchInlinedBuiltin(node, ast_);
+    if (!builtin.has_value()) {
+      return absl::OkStatus();
+    }
+
+    // string() registration is optional; when disabled regular dispatch
+    // produces an unknown-function error the inlined step must not paper
+    // over.
+    if (node.call_expr().function() == cel::builtin::kString &&
+        !context.options().enable_string_conversion) {
+      return absl::OkStatus();
+    }
+
+    // A lazily bound function registered under the builtin's name shadows
+    // the standard implementation per activation, so the call must keep
+    // regular dispatch.
+    if (!context.resolver()
+             .FindLazyOverloads(node.call_expr().function(),
+                                node.call_expr().has_target(),
+                                ArgumentsMatcher(1), node.id())
+             .empty()) {
+      return absl::OkStatus();
+    }
+
+    ProgramBuilder::Subexpression* subexpression =
+        context.program_builder().GetSubexpression(&node);
+    if (subexpression == nullptr || subexpression->IsFlattened() ||
+        subexpression->IsRecursive()) {
+      // Already modified or planned recursively; leave the function steps.
+      return absl::OkStatus();
+    }
+
+    if (context.GetSubplan(*builtin->operand).empty()) {
+      // Already optimized by another extension, nothing to do.
+      return absl::OkStatus();
+    }
+
+    CEL_ASSIGN_OR_RETURN(ExecutionPath new_plan,
+                         context.ExtractSubplan(*builtin->operand));
+    CEL_ASSIGN_OR_RETURN(new_plan.emplace_back(),
+                         CreateInlinedBuiltinStep(builtin->op, node.id()));
+
+    return context.ReplaceSubplan(node, std::move(new_plan));
+  }
+
+ private:
+  const AstImpl& ast_;
+};
+
+}  // namespace
+
+ProgramOptimizerFactory CreateInlinedBuiltinOptimization() {
+  return [](PlannerContext& context, const AstImpl& ast) {
+    return std::make_unique<InlinedBuiltinOptimization>(ast);
+  };
+}
+
+}  // namespace google::api::expr::runtime
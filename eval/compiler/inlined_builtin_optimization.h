@@ -0,0 +1,31 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_COMPILER_INLINED_BUILTIN_OPTIMIZATION_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_COMPILER_INLINED_BUILTIN_OPTIMIZATION_H_
+
+#include "eval/compiler/flat_expr_builder_extensions.h"
+
+namespace google::api::expr::runtime {
+
+// Creates a program optimizer replacing function dispatch for standard
+// unary builtins (!_, -_, size) with dedicated steps when the checker
+// resolved the call to a standard overload and the registry does not shadow
+// it with a lazily bound function. See also CreateTypedCompareOptimization
+// for the binary comparison analog.
+ProgramOptimizerFactory CreateInlinedBuiltinOptimization();
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_COMPILER_INLINED_BUILTIN_OPTIMIZATION_H_
@@ -0,0 +1,177 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests for the post-planning jump cleanup pass in FlatExprBuilder.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/native_type.h"
+#include "common/value.h"
+#include "eval/compiler/flat_expr_builder.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/jump_step.h"
+#include "extensions/protobuf/ast_converters.h"
+#include "extensions/protobuf/memory_manager.h"
+#include "internal/casts.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/function_registry.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_functions.h"
+#include "runtime/type_registry.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::BoolValue;
+using ::cel::IntValue;
+using ::cel::Value;
+using ::google::api::expr::v1alpha1::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+
+class JumpOptimizationTest : public ::testing::Test {
+ public:
+  JumpOptimizationTest()
+      : managed_value_factory_(
+            type_registry_.GetComposedTypeProvider(),
+            cel::extensions::ProtoMemoryManagerRef(&arena_)) {}
+
+  void SetUp() override {
+    ASSERT_OK(cel::RegisterStandardFunctions(function_registry_, options_));
+  }
+
+ protected:
+  absl::StatusOr<FlatExpression> Plan(absl::string_view expression) {
+    FlatExprBuilder builder(function_registry_, type_registry_, options_);
+    CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+    CEL_ASSIGN_OR_RETURN(auto ast,
+                         cel::extensions::CreateAstFromParsedExpr(parsed_expr));
+    return builder.CreateExpressionImpl(std::move(ast), nullptr);
+  }
+
+  absl::StatusOr<Value> Evaluate(const FlatExpression& plan, int64_t a) {
+    auto state = plan.MakeEvaluatorState(managed_value_factory_.get());
+    cel::Activation activation;
+    activation.InsertOrAssignValue(
+        "a", managed_value_factory_.get().CreateIntValue(a));
+    return plan.EvaluateWithCallback(activation, EvaluationListener(), state);
+  }
+
+  // Returns the number of jump steps in `path` that land on an unconditional
+  // jump. The cleanup pass retargets these, so a finished plan has none.
+  static size_t CountJumpChains(const ExecutionPath& path) {
+    size_t chains = 0;
+    for (size_t i = 0; i < path.size(); ++i) {
+      const auto* jump = AsJump(path, i);
+      if (jump == nullptr || !jump->jump_offset().has_value()) {
+        continue;
+      }
+      size_t target = i + 1 + *jump->jump_offset();
+      if (target < path.size()) {
+        const auto* target_jump = AsJump(path, target);
+        if (target_jump != nullptr && target_jump->unconditional()) {
+          ++chains;
+        }
+      }
+    }
+    return chains;
+  }
+
+  cel::RuntimeOptions options_;
+  cel::FunctionRegistry function_registry_;
+  cel::TypeRegistry type_registry_;
+  google::protobuf::Arena arena_;
+  cel::ManagedValueFactory managed_value_factory_;
+
+ private:
+  static const JumpStepBase* AsJump(const ExecutionPath& path, size_t index) {
+    if (path[index]->GetNativeTypeId() !=
+        cel::NativeTypeId::For<JumpStepBase>()) {
+      return nullptr;
+    }
+    return cel::internal::down_cast<const JumpStepBase*>(path[index].get());
+  }
+};
+
+TEST_F(JumpOptimizationTest, NestedTernariesEvaluate) {
+  ASSERT_OK_AND_ASSIGN(
+      FlatExpression plan,
+      Plan("a > 0 ? (a > 10 ? (a > 100 ? 3 : 2) : 1) : (a < -10 ? -2 : -1)"));
+
+  struct Case {
+    int64_t input;
+    int64_t expected;
+  };
+  for (const Case& c : {Case{500, 3}, Case{50, 2}, Case{5, 1}, Case{-5, -1},
+                        Case{-50, -2}}) {
+    ASSERT_OK_AND_ASSIGN(Value value, Evaluate(plan, c.input));
+    ASSERT_TRUE(value->Is<IntValue>());
+    EXPECT_EQ(value->As<IntValue>().NativeValue(), c.expected) << c.input;
+  }
+}
+
+TEST_F(JumpOptimizationTest, NestedTernariesHaveNoJumpChains) {
+  // Inner ternaries end with an unconditional jump that lands exactly on the
+  // enclosing ternary's jump-over-else; the cleanup pass retargets it.
+  ASSERT_OK_AND_ASSIGN(
+      FlatExpression plan,
+      Plan("a > 0 ? (a > 10 ? (a > 100 ? 3 : 2) : 1) : (a < -10 ? -2 : -1)"));
+  EXPECT_EQ(CountJumpChains(plan.path()), 0);
+}
+
+TEST_F(JumpOptimizationTest, ShortCircuitChainsEvaluate) {
+  ASSERT_OK_AND_ASSIGN(
+      FlatExpression plan,
+      Plan("(a > 0 && a < 10) || (a > 100 && a < 110) || a == 42"));
+  EXPECT_EQ(CountJumpChains(plan.path()), 0);
+
+  struct Case {
+    int64_t input;
+    bool expected;
+  };
+  for (const Case& c : {Case{5, true}, Case{105, true}, Case{42, true},
+                        Case{50, false}, Case{-1, false}}) {
+    ASSERT_OK_AND_ASSIGN(Value value, Evaluate(plan, c.input));
+    ASSERT_TRUE(value->Is<BoolValue>());
+    EXPECT_EQ(value->As<BoolValue>().NativeValue(), c.expected) << c.input;
+  }
+}
+
+TEST_F(JumpOptimizationTest, ComprehensionPlansStillEvaluate) {
+  // Comprehension steps jump with offsets the pass cannot see; their plans
+  // are exempt from compaction but must still evaluate correctly.
+  ASSERT_OK_AND_ASSIGN(FlatExpression plan,
+                       Plan("[1, 2, 3].exists(x, x == a) ? a * 2 : 0"));
+
+  ASSERT_OK_AND_ASSIGN(Value value, Evaluate(plan, 2));
+  ASSERT_TRUE(value->Is<IntValue>());
+  EXPECT_EQ(value->As<IntValue>().NativeValue(), 4);
+
+  ASSERT_OK_AND_ASSIGN(value, Evaluate(plan, 7));
+  ASSERT_TRUE(value->Is<IntValue>());
+  EXPECT_EQ(value->As<IntValue>().NativeValue(), 0);
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,181 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/plan_cache.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/overload.h"
+#include "absl/hash/hash.h"
+#include "absl/memory/memory.h"
+#include "absl/time/time.h"
+#include "absl/types/variant.h"
+#include "base/ast.h"
+#include "base/ast_internal/ast_impl.h"
+#include "base/ast_internal/expr.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+using ::cel::ast_internal::AstImpl;
+using ::cel::ast_internal::Constant;
+using ::cel::ast_internal::Expr;
+
+size_t HashConstant(const Constant& constant) {
+  return absl::visit(
+      absl::Overload(
+          [](absl::monostate) -> size_t { return absl::HashOf(0); },
+          [](std::nullptr_t) -> size_t { return absl::HashOf(1); },
+          [](bool value) -> size_t { return absl::HashOf(2, value); },
+          [](int64_t value) -> size_t { return absl::HashOf(3, value); },
+          [](uint64_t value) -> size_t { return absl::HashOf(4, value); },
+          [](double value) -> size_t { return absl::HashOf(5, value); },
+          [](const cel::BytesConstant& value) -> size_t {
+            return absl::HashOf(6, static_cast<const std::string&>(value));
+          },
+          [](const cel::StringConstant& value) -> size_t {
+            return absl::HashOf(7, static_cast<const std::string&>(value));
+          },
+          [](absl::Duration value) -> size_t { return absl::HashOf(8, value); },
+          [](absl::Time value) -> size_t { return absl::HashOf(9, value); }),
+      constant.kind());
+}
+
+// Structural hash of an expression subtree, including expression ids.
+// Fingerprints only select cache buckets; candidates are verified by full
+// comparison, so collisions cost time, not correctness.
+size_t HashExpr(const Expr& expr) {
+  size_t hash = absl::HashOf(expr.id(), expr.kind().index());
+  absl::visit(
+      absl::Overload(
+          [](const cel::UnspecifiedExpr&) {},
+          [&](const Constant& constant) {
+            hash = absl::HashOf(hash, HashConstant(constant));
+          },
+          [&](const cel::IdentExpr& ident) {
+            hash = absl::HashOf(hash, ident.name());
+          },
+          [&](const cel::SelectExpr& select) {
+            hash = absl::HashOf(hash, select.field(), select.test_only(),
+                                HashExpr(select.operand()));
+          },
+          [&](const cel::CallExpr& call) {
+            hash = absl::HashOf(hash, call.function(), call.has_target());
+            if (call.has_target()) {
+              hash = absl::HashOf(hash, HashExpr(call.target()));
+            }
+            for (const Expr& arg : call.args()) {
+              hash = absl::HashOf(hash, HashExpr(arg));
+            }
+          },
+          [&](const cel::ListExpr& list) {
+            for (const auto& element : list.elements()) {
+              hash = absl::HashOf(hash, element.optional(),
+                                  HashExpr(element.expr()));
+            }
+          },
+          [&](const cel::StructExpr& struct_expr) {
+            hash = absl::HashOf(hash, struct_expr.name());
+            for (const auto& field : struct_expr.fields()) {
+              hash = absl::HashOf(hash, field.id(), field.name(),
+                                  field.optional(), HashExpr(field.value()));
+            }
+          },
+          [&](const cel::MapExpr& map) {
+            for (const auto& entry : map.entries()) {
+              hash = absl::HashOf(hash, entry.id(), entry.optional(),
+                                  HashExpr(entry.key()),
+                                  HashExpr(entry.value()));
+            }
+          },
+          [&](const cel::ComprehensionExpr& comprehension) {
+            hash = absl::HashOf(
+                hash, comprehension.iter_var(), comprehension.accu_var(),
+                HashExpr(comprehension.iter_range()),
+                HashExpr(comprehension.accu_init()),
+                HashExpr(comprehension.loop_condition()),
+                HashExpr(comprehension.loop_step()),
+                HashExpr(comprehension.result()));
+          }),
+      expr.kind());
+  return hash;
+}
+
+size_t FingerprintAst(const AstImpl& ast) {
+  return absl::HashOf(HashExpr(ast.root_expr()), ast.expr_version());
+}
+
+// Everything the planner consumes must match exactly. Source info is
+// deliberately excluded: positions and macro call records only affect
+// diagnostics, not the plan, and excluding them lets the same policy text
+// match regardless of where it appeared in a larger source.
+bool AstEquals(const AstImpl& lhs, const AstImpl& rhs) {
+  return lhs.expr_version() == rhs.expr_version() &&
+         lhs.root_expr() == rhs.root_expr() &&
+         lhs.reference_map() == rhs.reference_map() &&
+         lhs.type_map() == rhs.type_map();
+}
+
+}  // namespace
+
+const PlanCache::Entry* PlanCache::Lookup(const AstImpl& ast) const {
+  size_t fingerprint = FingerprintAst(ast);
+
+  absl::MutexLock lock(&mutex_);
+  auto it = buckets_.find(fingerprint);
+  if (it == buckets_.end()) {
+    return nullptr;
+  }
+  for (const std::unique_ptr<Node>& node : it->second) {
+    if (AstEquals(*node->ast, ast)) {
+      return &node->entry;
+    }
+  }
+  return nullptr;
+}
+
+const PlanCache::Entry* PlanCache::Insert(std::unique_ptr<cel::Ast> ast,
+                                          Entry entry) {
+  auto node = std::make_unique<Node>();
+  node->ast = absl::WrapUnique(AstImpl::CastFromPublicAst(ast.release()));
+  node->entry = std::move(entry);
+  size_t fingerprint = FingerprintAst(*node->ast);
+
+  absl::MutexLock lock(&mutex_);
+  std::vector<std::unique_ptr<Node>>& bucket = buckets_[fingerprint];
+  for (const std::unique_ptr<Node>& existing : bucket) {
+    if (AstEquals(*existing->ast, *node->ast)) {
+      return &existing->entry;
+    }
+  }
+  bucket.push_back(std::move(node));
+  return &bucket.back()->entry;
+}
+
+size_t PlanCache::size() const {
+  absl::MutexLock lock(&mutex_);
+  size_t size = 0;
+  for (const auto& bucket : buckets_) {
+    size += bucket.second.size();
+  }
+  return size;
+}
+
+}  // namespace google::api::expr::runtime
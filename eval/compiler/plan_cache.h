@@ -0,0 +1,95 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_COMPILER_PLAN_CACHE_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_COMPILER_PLAN_CACHE_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "base/ast.h"
+#include "base/ast_internal/ast_impl.h"
+#include "eval/eval/evaluator_core.h"
+#include "runtime/runtime_issue.h"
+#include "runtime/slot_activation.h"
+
+namespace google::api::expr::runtime {
+
+// A content-addressed cache of planned programs.
+//
+// Installed on a FlatExprBuilder (see FlatExprBuilder::set_plan_cache), the
+// cache lets structurally identical expressions share one immutable execution
+// path across compiled programs instead of planning (and retaining) a copy
+// per program.
+//
+// Entries are keyed on the structure of the AST as it looks after AST
+// transforms have run, so a cache must only be shared among builders that are
+// configured identically (same registries, options, container, transforms and
+// program optimizers). The planner bakes configuration-dependent decisions
+// into the steps it emits; sharing a cache across differently configured
+// builders would replay plans that do not match the builder's configuration.
+//
+// Entries are never evicted and remain valid for the lifetime of the cache.
+//
+// Thread-safe.
+class PlanCache {
+ public:
+  // A retained plan. `subexpressions` are views into `*path`.
+  struct Entry {
+    std::shared_ptr<const ExecutionPath> path;
+    std::vector<ExecutionPathView> subexpressions;
+    size_t comprehension_slots_size = 0;
+    size_t value_stack_size = 0;
+    std::shared_ptr<const cel::VariableBindingPlan> variable_binding_plan;
+    // Issues reported while planning, replayed on later hits.
+    std::vector<cel::RuntimeIssue> issues;
+  };
+
+  PlanCache() = default;
+
+  PlanCache(const PlanCache&) = delete;
+  PlanCache& operator=(const PlanCache&) = delete;
+
+  // Returns the cached plan for an AST structurally identical to ast, or
+  // nullptr if none is cached.
+  const Entry* Lookup(const cel::ast_internal::AstImpl& ast) const;
+
+  // Records the plan for ast, taking ownership of the AST to verify later
+  // lookups by exact comparison. Returns the retained entry; if a plan for an
+  // identical AST was inserted concurrently, the existing entry is kept and
+  // returned instead.
+  const Entry* Insert(std::unique_ptr<cel::Ast> ast, Entry entry);
+
+  size_t size() const;
+
+ private:
+  struct Node {
+    std::unique_ptr<const cel::ast_internal::AstImpl> ast;
+    Entry entry;
+  };
+
+  mutable absl::Mutex mutex_;
+  // Buckets keyed by a structural fingerprint of the AST. Candidates within a
+  // bucket are verified by full AST comparison before being returned.
+  absl::flat_hash_map<size_t, std::vector<std::unique_ptr<Node>>> buckets_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_COMPILER_PLAN_CACHE_H_
@@ -0,0 +1,159 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/plan_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/value.h"
+#include "eval/compiler/flat_expr_builder.h"
+#include "eval/eval/evaluator_core.h"
+#include "extensions/protobuf/ast_converters.h"
+#include "extensions/protobuf/memory_manager.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/function_registry.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/runtime_issue.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_functions.h"
+#include "runtime/type_registry.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::IntValue;
+using ::cel::Value;
+using ::google::api::expr::v1alpha1::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+
+class PlanCacheTest : public ::testing::Test {
+ public:
+  PlanCacheTest()
+      : managed_value_factory_(
+            type_registry_.GetComposedTypeProvider(),
+            cel::extensions::ProtoMemoryManagerRef(&arena_)) {}
+
+  void SetUp() override {
+    ASSERT_OK(cel::RegisterStandardFunctions(function_registry_, options_));
+  }
+
+ protected:
+  absl::StatusOr<FlatExpression> Plan(
+      FlatExprBuilder& builder, absl::string_view expression,
+      std::vector<cel::RuntimeIssue>* issues = nullptr) {
+    CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+    CEL_ASSIGN_OR_RETURN(auto ast,
+                         cel::extensions::CreateAstFromParsedExpr(parsed_expr));
+    return builder.CreateExpressionImpl(std::move(ast), issues);
+  }
+
+  absl::StatusOr<Value> Evaluate(const FlatExpression& plan, int64_t a) {
+    auto state = plan.MakeEvaluatorState(managed_value_factory_.get());
+    cel::Activation activation;
+    activation.InsertOrAssignValue(
+        "a", managed_value_factory_.get().CreateIntValue(a));
+    return plan.EvaluateWithCallback(activation, EvaluationListener(), state);
+  }
+
+  cel::RuntimeOptions options_;
+  cel::FunctionRegistry function_registry_;
+  cel::TypeRegistry type_registry_;
+  google::protobuf::Arena arena_;
+  cel::ManagedValueFactory managed_value_factory_;
+};
+
+TEST_F(PlanCacheTest, IdenticalExpressionsShareOnePlan) {
+  FlatExprBuilder builder(function_registry_, type_registry_, options_);
+  auto cache = std::make_shared<PlanCache>();
+  builder.set_plan_cache(cache);
+
+  ASSERT_OK_AND_ASSIGN(FlatExpression plan1, Plan(builder, "a + a"));
+  ASSERT_OK_AND_ASSIGN(FlatExpression plan2, Plan(builder, "a + a"));
+
+  EXPECT_EQ(cache->size(), 1);
+  EXPECT_EQ(&plan1.path(), &plan2.path());
+
+  ASSERT_OK_AND_ASSIGN(Value value, Evaluate(plan2, 21));
+  ASSERT_TRUE(value->Is<IntValue>());
+  EXPECT_EQ(value->As<IntValue>().NativeValue(), 42);
+}
+
+TEST_F(PlanCacheTest, DistinctExpressionsGetDistinctPlans) {
+  FlatExprBuilder builder(function_registry_, type_registry_, options_);
+  auto cache = std::make_shared<PlanCache>();
+  builder.set_plan_cache(cache);
+
+  ASSERT_OK_AND_ASSIGN(FlatExpression plan1, Plan(builder, "a + 1"));
+  ASSERT_OK_AND_ASSIGN(FlatExpression plan2, Plan(builder, "a + 2"));
+
+  EXPECT_EQ(cache->size(), 2);
+  EXPECT_NE(&plan1.path(), &plan2.path());
+
+  ASSERT_OK_AND_ASSIGN(Value value1, Evaluate(plan1, 1));
+  ASSERT_TRUE(value1->Is<IntValue>());
+  EXPECT_EQ(value1->As<IntValue>().NativeValue(), 2);
+
+  ASSERT_OK_AND_ASSIGN(Value value2, Evaluate(plan2, 1));
+  ASSERT_TRUE(value2->Is<IntValue>());
+  EXPECT_EQ(value2->As<IntValue>().NativeValue(), 3);
+}
+
+TEST_F(PlanCacheTest, SharedAcrossIdenticallyConfiguredBuilders) {
+  auto cache = std::make_shared<PlanCache>();
+
+  FlatExprBuilder builder1(function_registry_, type_registry_, options_);
+  builder1.set_plan_cache(cache);
+  FlatExprBuilder builder2(function_registry_, type_registry_, options_);
+  builder2.set_plan_cache(cache);
+
+  ASSERT_OK_AND_ASSIGN(FlatExpression plan1, Plan(builder1, "a * a"));
+  ASSERT_OK_AND_ASSIGN(FlatExpression plan2, Plan(builder2, "a * a"));
+
+  EXPECT_EQ(cache->size(), 1);
+  EXPECT_EQ(&plan1.path(), &plan2.path());
+
+  ASSERT_OK_AND_ASSIGN(Value value, Evaluate(plan2, 6));
+  ASSERT_TRUE(value->Is<IntValue>());
+  EXPECT_EQ(value->As<IntValue>().NativeValue(), 36);
+}
+
+TEST_F(PlanCacheTest, IssuesReplayedOnCacheHit) {
+  cel::RuntimeOptions options = options_;
+  options.fail_on_warnings = false;
+  FlatExprBuilder builder(function_registry_, type_registry_, options);
+  auto cache = std::make_shared<PlanCache>();
+  builder.set_plan_cache(cache);
+
+  std::vector<cel::RuntimeIssue> first_issues;
+  ASSERT_OK(Plan(builder, "undeclared_func(a)", &first_issues).status());
+  ASSERT_FALSE(first_issues.empty());
+
+  std::vector<cel::RuntimeIssue> second_issues;
+  ASSERT_OK(Plan(builder, "undeclared_func(a)", &second_issues).status());
+  EXPECT_EQ(cache->size(), 1);
+  EXPECT_EQ(second_issues.size(), first_issues.size());
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
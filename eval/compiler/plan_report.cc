@@ -0,0 +1,42 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/plan_report.h"
+
+#include <string>
+
+#include "absl/strings/str_cat.h"
+
+namespace google::api::expr::runtime {
+
+std::string PlanReport::DebugString() const {
+  std::string out;
+  absl::StrAppend(&out, "plan: ", steps.size(),
+                  " steps, estimated cost ", estimated_cost,
+                  ", comprehension slots ", comprehension_slot_count,
+                  ", value stack ", value_stack_size,
+                  from_plan_cache ? ", from plan cache" : "", "\n");
+  for (const Step& step : steps) {
+    absl::StrAppend(&out, "  [", step.index, "] expr_id=", step.expr_id,
+                    " cost=", step.cost, " ", step.step_type, "\n");
+  }
+  for (const Optimization& optimization : optimizations) {
+    absl::StrAppend(&out, "  optimization: ", optimization.optimizer,
+                    " expr_id=", optimization.expr_id, ": ",
+                    optimization.description, "\n");
+  }
+  return out;
+}
+
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,86 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_COMPILER_PLAN_REPORT_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_COMPILER_PLAN_REPORT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace google::api::expr::runtime {
+
+// Structured account of what the planner did for one expression.
+//
+// Opt-in: populated when a report pointer is passed to
+// FlatExprBuilder::CreateExpressionImpl. Intended for offline inspection and
+// tooling (explaining why one policy plans larger or costs more than
+// another), not for the evaluation hot path.
+struct PlanReport {
+  // One step of the flattened execution path, in execution order.
+  struct Step {
+    // Position in the flattened execution path.
+    size_t index;
+    // Id of the AST node the step was planned for. Synthetic steps (e.g.
+    // jumps inserted for short-circuiting) inherit the id of the node they
+    // were planned under.
+    int64_t expr_id;
+    // Runtime type name of the step implementation, e.g.
+    // "google::api::expr::runtime::(anonymous namespace)::ConstValueStep".
+    // Best effort: steps that don't override GetNativeTypeId report "".
+    std::string step_type;
+    // The step's static cost estimate, in the same units used by the
+    // per-evaluation cost budget (see RuntimeOptions::max_evaluation_cost).
+    int64_t cost;
+  };
+
+  // One rewrite applied during planning, recorded by a ProgramOptimizer
+  // through PlannerContext::RecordOptimization.
+  struct Optimization {
+    // Id of the AST node the rewrite was anchored to.
+    int64_t expr_id;
+    // Name of the optimizer that applied the rewrite, e.g.
+    // "constant_folding".
+    std::string optimizer;
+    // Human-readable description of the rewrite.
+    std::string description;
+  };
+
+  std::vector<Step> steps;
+  std::vector<Optimization> optimizations;
+
+  // Number of comprehension slots the planned program reserves.
+  size_t comprehension_slot_count = 0;
+
+  // Number of value stack elements evaluator state is sized for: the
+  // planner's bound on maximum stack occupancy, capped by the step count.
+  size_t value_stack_size = 0;
+
+  // Sum of the per-step cost estimates; a static upper bound on the cost of
+  // one evaluation (short-circuiting may execute fewer steps).
+  int64_t estimated_cost = 0;
+
+  // True if the plan was served from the builder's PlanCache. Cached plans
+  // report their steps and totals, but optimizer rewrites were recorded when
+  // the plan was first built and are not replayed on cache hits.
+  bool from_plan_cache = false;
+
+  // Renders the report as a multi-line human-readable listing.
+  std::string DebugString() const;
+};
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_COMPILER_PLAN_REPORT_H_
@@ -0,0 +1,157 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/plan_report.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "common/value.h"
+#include "eval/compiler/constant_folding.h"
+#include "eval/compiler/flat_expr_builder.h"
+#include "eval/compiler/plan_cache.h"
+#include "eval/eval/evaluator_core.h"
+#include "extensions/protobuf/ast_converters.h"
+#include "extensions/protobuf/memory_manager.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/function_registry.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/runtime_issue.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_functions.h"
+#include "runtime/type_registry.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::google::api::expr::v1alpha1::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+
+class PlanReportTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    ASSERT_OK(cel::RegisterStandardFunctions(function_registry_, options_));
+  }
+
+ protected:
+  absl::StatusOr<FlatExpression> Plan(FlatExprBuilder& builder,
+                                      absl::string_view expression,
+                                      PlanReport& report) {
+    CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+    CEL_ASSIGN_OR_RETURN(auto ast,
+                         cel::extensions::CreateAstFromParsedExpr(parsed_expr));
+    return builder.CreateExpressionImpl(std::move(ast), /*issues=*/nullptr,
+                                        builder.options(), &report);
+  }
+
+  cel::RuntimeOptions options_;
+  cel::FunctionRegistry function_registry_;
+  cel::TypeRegistry type_registry_;
+  google::protobuf::Arena arena_;
+};
+
+TEST_F(PlanReportTest, ReportsStepsWithProvenanceAndTotals) {
+  FlatExprBuilder builder(function_registry_, type_registry_, options_);
+
+  PlanReport report;
+  ASSERT_OK_AND_ASSIGN(FlatExpression plan, Plan(builder, "a + b", report));
+
+  ASSERT_EQ(report.steps.size(), plan.path().size());
+  int64_t total = 0;
+  for (size_t i = 0; i < report.steps.size(); ++i) {
+    EXPECT_EQ(report.steps[i].index, i);
+    EXPECT_EQ(report.steps[i].expr_id, plan.path()[i]->id());
+    total += report.steps[i].cost;
+  }
+  EXPECT_EQ(report.estimated_cost, total);
+  EXPECT_FALSE(report.from_plan_cache);
+  EXPECT_FALSE(report.DebugString().empty());
+}
+
+TEST_F(PlanReportTest, RecordsConstantFoldingRewrites) {
+  FlatExprBuilder builder(function_registry_, type_registry_, options_);
+  builder.AddProgramOptimizer(
+      cel::runtime_internal::CreateConstantFoldingOptimizer(
+          cel::extensions::ProtoMemoryManagerRef(&arena_)));
+
+  PlanReport report;
+  ASSERT_OK_AND_ASSIGN(FlatExpression plan, Plan(builder, "1 + 2 + a", report));
+
+  ASSERT_FALSE(report.optimizations.empty());
+  EXPECT_EQ(report.optimizations[0].optimizer, "constant_folding");
+  EXPECT_TRUE(
+      absl::StrContains(report.DebugString(), "constant_folding"));
+}
+
+TEST_F(PlanReportTest, CacheHitsAreMarked) {
+  FlatExprBuilder builder(function_registry_, type_registry_, options_);
+  builder.set_plan_cache(std::make_shared<PlanCache>());
+
+  PlanReport first;
+  ASSERT_OK_AND_ASSIGN(FlatExpression plan1, Plan(builder, "a + a", first));
+  EXPECT_FALSE(first.from_plan_cache);
+
+  PlanReport second;
+  ASSERT_OK_AND_ASSIGN(FlatExpression plan2, Plan(builder, "a + a", second));
+  EXPECT_TRUE(second.from_plan_cache);
+  EXPECT_EQ(second.steps.size(), first.steps.size());
+  EXPECT_EQ(second.estimated_cost, first.estimated_cost);
+  EXPECT_EQ(second.value_stack_size, first.value_stack_size);
+}
+
+TEST_F(PlanReportTest, ReportsPlannerStackBound) {
+  FlatExprBuilder builder(function_registry_, type_registry_, options_);
+
+  // A left-deep arithmetic chain holds at most two intermediate values at
+  // once, however long it grows; the stack is sized to that bound, not the
+  // step count.
+  std::string expression = "a";
+  for (int i = 0; i < 50; ++i) {
+    absl::StrAppend(&expression, " + a");
+  }
+  PlanReport report;
+  ASSERT_OK_AND_ASSIGN(FlatExpression plan, Plan(builder, expression, report));
+
+  EXPECT_EQ(report.value_stack_size, plan.value_stack_size());
+  EXPECT_GT(plan.path().size(), 50);
+  EXPECT_LE(report.value_stack_size, 4);
+
+  // The tightly sized state still evaluates the whole chain.
+  cel::ManagedValueFactory value_factory(
+      type_registry_.GetComposedTypeProvider(),
+      cel::extensions::ProtoMemoryManagerRef(&arena_));
+  auto state = plan.MakeEvaluatorState(value_factory.get());
+  cel::Activation activation;
+  activation.InsertOrAssignValue("a", value_factory.get().CreateIntValue(1));
+  ASSERT_OK_AND_ASSIGN(
+      cel::Value result,
+      plan.EvaluateWithCallback(activation, EvaluationListener(), state));
+  EXPECT_EQ(result->As<cel::IntValue>().NativeValue(), 51);
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
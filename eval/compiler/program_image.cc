@@ -0,0 +1,154 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/program_image.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "google/api/expr/v1alpha1/checked.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "runtime/runtime_options.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+// 'CELP' in little-endian byte order.
+constexpr uint32_t kImageMagic = 0x504C4543;
+constexpr uint32_t kImageVersion = 1;
+
+struct ImageHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t options_fingerprint;
+};
+
+// FNV-1a, used instead of absl::Hash to get a fingerprint that is stable
+// across processes.
+uint64_t FnvMix(uint64_t state, uint64_t value) {
+  constexpr uint64_t kPrime = 0x100000001b3;
+  for (int i = 0; i < 8; ++i) {
+    state = (state ^ (value & 0xff)) * kPrime;
+    value >>= 8;
+  }
+  return state;
+}
+
+uint64_t FnvMix(uint64_t state, absl::string_view value) {
+  constexpr uint64_t kPrime = 0x100000001b3;
+  for (char c : value) {
+    state = (state ^ static_cast<uint8_t>(c)) * kPrime;
+  }
+  return state;
+}
+
+void AppendLittleEndian(std::string& out, uint64_t value, size_t bytes) {
+  for (size_t i = 0; i < bytes; ++i) {
+    out.push_back(static_cast<char>(value & 0xff));
+    value >>= 8;
+  }
+}
+
+uint64_t ReadLittleEndian(absl::string_view data, size_t bytes) {
+  uint64_t value = 0;
+  for (size_t i = bytes; i > 0; --i) {
+    value = (value << 8) | static_cast<uint8_t>(data[i - 1]);
+  }
+  return value;
+}
+
+}  // namespace
+
+uint64_t RuntimeOptionsFingerprint(const cel::RuntimeOptions& options) {
+  constexpr uint64_t kOffsetBasis = 0xcbf29ce484222325;
+  uint64_t state = kOffsetBasis;
+  state = FnvMix(state, options.container);
+  state = FnvMix(state, static_cast<uint64_t>(options.unknown_processing));
+  uint64_t flags = 0;
+  flags = (flags << 1) | (options.enable_missing_attribute_errors ? 1 : 0);
+  flags = (flags << 1) |
+          (options.enable_timestamp_duration_overflow_errors ? 1 : 0);
+  flags = (flags << 1) | (options.short_circuiting ? 1 : 0);
+  flags = (flags << 1) | (options.enable_comprehension ? 1 : 0);
+  flags = (flags << 1) | (options.enable_comprehension_list_append ? 1 : 0);
+  flags = (flags << 1) | (options.enable_regex ? 1 : 0);
+  flags = (flags << 1) | (options.enable_string_conversion ? 1 : 0);
+  flags = (flags << 1) | (options.enable_string_concat ? 1 : 0);
+  flags = (flags << 1) | (options.enable_list_concat ? 1 : 0);
+  flags = (flags << 1) | (options.enable_list_contains ? 1 : 0);
+  flags = (flags << 1) | (options.fail_on_warnings ? 1 : 0);
+  flags = (flags << 1) | (options.enable_qualified_type_identifiers ? 1 : 0);
+  flags = (flags << 1) | (options.enable_heterogeneous_equality ? 1 : 0);
+  flags = (flags << 1) | (options.enable_empty_wrapper_null_unboxing ? 1 : 0);
+  flags = (flags << 1) | (options.enable_lazy_bind_initialization ? 1 : 0);
+  state = FnvMix(state, flags);
+  state = FnvMix(state, static_cast<uint64_t>(options.regex_max_program_size));
+  state = FnvMix(state,
+                 static_cast<uint64_t>(options.comprehension_max_iterations));
+  state = FnvMix(state, static_cast<uint64_t>(options.max_recursion_depth));
+  return state;
+}
+
+absl::StatusOr<std::string> SerializeProgramImage(
+    const google::api::expr::v1alpha1::CheckedExpr& expr,
+    const cel::RuntimeOptions& options) {
+  std::string image;
+  image.reserve(sizeof(ImageHeader) + expr.ByteSizeLong());
+  AppendLittleEndian(image, kImageMagic, sizeof(uint32_t));
+  AppendLittleEndian(image, kImageVersion, sizeof(uint32_t));
+  AppendLittleEndian(image, RuntimeOptionsFingerprint(options),
+                     sizeof(uint64_t));
+  if (!expr.AppendToString(&image)) {
+    return absl::InternalError("failed to serialize checked expression");
+  }
+  return image;
+}
+
+absl::StatusOr<google::api::expr::v1alpha1::CheckedExpr> LoadProgramImage(
+    absl::string_view data, const cel::RuntimeOptions& options) {
+  if (data.size() < sizeof(ImageHeader)) {
+    return absl::InvalidArgumentError("program image truncated");
+  }
+  if (ReadLittleEndian(data, sizeof(uint32_t)) != kImageMagic) {
+    return absl::InvalidArgumentError("program image magic mismatch");
+  }
+  uint64_t version =
+      ReadLittleEndian(data.substr(sizeof(uint32_t)), sizeof(uint32_t));
+  if (version != kImageVersion) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("unsupported program image version: ", version));
+  }
+  uint64_t fingerprint =
+      ReadLittleEndian(data.substr(2 * sizeof(uint32_t)), sizeof(uint64_t));
+  if (fingerprint != RuntimeOptionsFingerprint(options)) {
+    return absl::FailedPreconditionError(
+        "program image was built with different runtime options");
+  }
+  absl::string_view payload = data.substr(sizeof(ImageHeader));
+  google::api::expr::v1alpha1::CheckedExpr expr;
+  if (!expr.ParseFromArray(payload.data(),
+                           static_cast<int>(payload.size()))) {
+    return absl::InvalidArgumentError(
+        "failed to parse checked expression from program image");
+  }
+  return expr;
+}
+
+}  // namespace google::api::expr::runtime
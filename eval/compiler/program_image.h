@@ -0,0 +1,56 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_COMPILER_PROGRAM_IMAGE_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_COMPILER_PROGRAM_IMAGE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "google/api/expr/v1alpha1/checked.pb.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "runtime/runtime_options.h"
+
+namespace google::api::expr::runtime {
+
+// A versioned binary container for distributing pre-checked CEL programs.
+//
+// A planned ExecutionPath holds polymorphic step objects and bound function
+// pointers, so it cannot be relocated between processes. The image instead
+// captures everything that feeds the planner: the checked expression together
+// with a fingerprint of the runtime options it was compiled against. Loading
+// validates the version and fingerprint, then hands the expression straight
+// to the expression builder, skipping parsing and type checking on the warm
+// path. The input may alias a memory-mapped file.
+
+// Returns a stable fingerprint of the options fields that affect planning.
+// The fingerprint is stable across processes and binary versions, unlike
+// absl::Hash.
+uint64_t RuntimeOptionsFingerprint(const cel::RuntimeOptions& options);
+
+// Serializes `expr` into an image bound to `options`.
+absl::StatusOr<std::string> SerializeProgramImage(
+    const google::api::expr::v1alpha1::CheckedExpr& expr,
+    const cel::RuntimeOptions& options);
+
+// Parses an image previously produced by SerializeProgramImage, verifying
+// that it was built against options with the same fingerprint. `data` may
+// alias a memory-mapped file; it is only read during the call.
+absl::StatusOr<google::api::expr::v1alpha1::CheckedExpr> LoadProgramImage(
+    absl::string_view data, const cel::RuntimeOptions& options);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_COMPILER_PROGRAM_IMAGE_H_
@@ -0,0 +1,84 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/program_image.h"
+
+#include <string>
+
+#include "google/api/expr/v1alpha1/checked.pb.h"
+#include "absl/status/status.h"
+#include "internal/testing.h"
+#include "runtime/runtime_options.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+using ::google::api::expr::v1alpha1::CheckedExpr;
+using cel::internal::StatusIs;
+
+CheckedExpr MakeExpr() {
+  CheckedExpr expr;
+  expr.mutable_expr()->mutable_const_expr()->set_int64_value(42);
+  expr.mutable_expr()->set_id(1);
+  return expr;
+}
+
+TEST(ProgramImageTest, RoundTrip) {
+  cel::RuntimeOptions options;
+  ASSERT_OK_AND_ASSIGN(std::string image,
+                       SerializeProgramImage(MakeExpr(), options));
+
+  ASSERT_OK_AND_ASSIGN(CheckedExpr expr, LoadProgramImage(image, options));
+  EXPECT_EQ(expr.expr().const_expr().int64_value(), 42);
+}
+
+TEST(ProgramImageTest, OptionsFingerprintMismatch) {
+  cel::RuntimeOptions options;
+  ASSERT_OK_AND_ASSIGN(std::string image,
+                       SerializeProgramImage(MakeExpr(), options));
+
+  options.enable_comprehension = false;
+  EXPECT_THAT(LoadProgramImage(image, options),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST(ProgramImageTest, Truncated) {
+  cel::RuntimeOptions options;
+  EXPECT_THAT(LoadProgramImage("CEL", options),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ProgramImageTest, MagicMismatch) {
+  cel::RuntimeOptions options;
+  ASSERT_OK_AND_ASSIGN(std::string image,
+                       SerializeProgramImage(MakeExpr(), options));
+  image[0] = 'X';
+  EXPECT_THAT(LoadProgramImage(image, options),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ProgramImageTest, FingerprintStable) {
+  cel::RuntimeOptions options;
+  EXPECT_EQ(RuntimeOptionsFingerprint(options),
+            RuntimeOptionsFingerprint(options));
+  cel::RuntimeOptions other;
+  other.container = "google.protobuf";
+  EXPECT_NE(RuntimeOptionsFingerprint(options),
+            RuntimeOptionsFingerprint(other));
+}
+
+}  // namespace
+
+}  // namespace google::api::expr::runtime
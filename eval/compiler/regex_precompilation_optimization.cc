@@ -38,6 +38,7 @@
 #include "eval/eval/regex_match_step.h"
 #include "internal/casts.h"
 #include "internal/status_macros.h"
+#include "runtime/internal/regex_program_cache.h"
 #include "re2/re2.h"
 
 namespace google::api::expr::runtime {
@@ -87,8 +88,10 @@ bool IsFunctionOverload(const Expr& expr, absl::string_view function,
 }
 
 // Abstraction for deduplicating regular expressions over the course of a single
-// create expression call. Should not be used during evaluation. Uses
-// std::shared_ptr and std::weak_ptr.
+// create expression call. Should not be used during evaluation.
+//
+// Delegates to the process-wide interning cache so that identical patterns
+// across separately planned expressions share one compiled program.
 class RegexProgramBuilder final {
  public:
   explicit RegexProgramBuilder(int max_program_size)
@@ -96,28 +99,12 @@ class RegexProgramBuilder final {
 
   absl::StatusOr<std::shared_ptr<const RE2>> BuildRegexProgram(
       std::string pattern) {
-    auto existing = programs_.find(pattern);
-    if (existing != programs_.end()) {
-      if (auto program = existing->second.lock(); program) {
-        return program;
-      }
-      programs_.erase(existing);
-    }
-    auto program = std::make_shared<RE2>(pattern);
-    if (max_program_size_ > 0 && program->ProgramSize() > max_program_size_) {
-      return absl::InvalidArgumentError("exceeded RE2 max program size");
-    }
-    if (!program->ok()) {
-      return absl::InvalidArgumentError(
-          "invalid_argument unsupported RE2 pattern for matches");
-    }
-    programs_.insert({std::move(pattern), program});
-    return program;
+    return cel::runtime_internal::RegexProgramCache::Global().GetOrCompile(
+        pattern, max_program_size_);
   }
 
  private:
   const int max_program_size_;
-  absl::flat_hash_map<std::string, std::weak_ptr<const RE2>> programs_;
 };
 
 class RegexPrecompilationOptimization : public ProgramOptimizer {
@@ -217,6 +204,8 @@ class RegexPrecompilationOptimization : public ProgramOptimizer {
       absl::Nonnull<ProgramBuilder::Subexpression*> subexpression,
       const Expr& call, const Expr& subject,
       std::shared_ptr<const RE2> regex_program) {
+    context.RecordOptimization(call, "regex_precompilation",
+                               "precompiled constant matches() pattern");
     if (subexpression->IsRecursive()) {
       return RewriteRecursivePlan(subexpression, call, subject,
                                   std::move(regex_program));
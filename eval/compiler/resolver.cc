@@ -14,6 +14,7 @@
 
 #include "eval/compiler/resolver.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -137,6 +138,31 @@ absl::optional<cel::Value> Resolver::FindConstant(absl::string_view name,
   return absl::nullopt;
 }
 
+absl::optional<std::string> Resolver::FindUndefinedEnumValue(
+    absl::string_view name) const {
+  size_t pos = name.rfind('.');
+  if (pos == absl::string_view::npos || pos + 1 >= name.size()) {
+    return absl::nullopt;
+  }
+  // If the parent path names a registered enum type under any namespace
+  // prefix, the trailing segment is expected to be one of its enumerators.
+  absl::string_view parent = name.substr(0, pos);
+  absl::string_view leaf = name.substr(pos + 1);
+  for (const auto& candidate : FullyQualifiedNames(parent)) {
+    auto entry = resolveable_enums_.find(candidate);
+    if (entry == resolveable_enums_.end()) {
+      continue;
+    }
+    for (const auto& enumerator : entry->second.enumerators) {
+      if (enumerator.name == leaf) {
+        return absl::nullopt;
+      }
+    }
+    return candidate;
+  }
+  return absl::nullopt;
+}
+
 std::vector<cel::FunctionOverloadReference> Resolver::FindOverloads(
     absl::string_view name, bool receiver_style,
     const std::vector<cel::Kind>& types, int64_t expr_id) const {
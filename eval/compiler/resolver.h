@@ -65,6 +65,13 @@ class Resolver {
   absl::optional<cel::Value> FindConstant(absl::string_view name,
                                           int64_t expr_id) const;
 
+  // Returns the fully qualified name of a registered enum type when `name`
+  // selects an undefined enumerator from it, otherwise nullopt. Intended for
+  // use after FindConstant fails, so strict enum folding can fail planning
+  // fast instead of deferring to a per-evaluation identifier lookup.
+  absl::optional<std::string> FindUndefinedEnumValue(
+      absl::string_view name) const;
+
   absl::StatusOr<absl::optional<std::pair<std::string, cel::Type>>> FindType(
       absl::string_view name, int64_t expr_id) const;
 
@@ -126,6 +126,26 @@ TEST_F(ResolverTest, TestFindConstantEnum) {
   EXPECT_THAT((*enum_value).As<IntValue>().NativeValue(), Eq(2L));
 }
 
+TEST_F(ResolverTest, TestFindUndefinedEnumValue) {
+  CelFunctionRegistry func_registry;
+  type_registry_.Register(TestMessage::TestEnum_descriptor());
+
+  Resolver resolver("google.api.expr.runtime.TestMessage",
+                    func_registry.InternalGetRegistry(),
+                    type_registry_.InternalGetModernRegistry(), value_factory_,
+                    type_registry_.resolveable_enums());
+
+  auto enum_type = resolver.FindUndefinedEnumValue("TestEnum.MISSING");
+  ASSERT_TRUE(enum_type.has_value());
+  EXPECT_THAT(*enum_type, Eq("google.api.expr.runtime.TestMessage.TestEnum"));
+
+  // Defined enumerators and non-enum paths are not reported.
+  EXPECT_FALSE(
+      resolver.FindUndefinedEnumValue("TestEnum.TEST_ENUM_1").has_value());
+  EXPECT_FALSE(resolver.FindUndefinedEnumValue("SomeType.FIELD").has_value());
+  EXPECT_FALSE(resolver.FindUndefinedEnumValue("unqualified").has_value());
+}
+
 TEST_F(ResolverTest, TestFindConstantUnqualifiedType) {
   CelFunctionRegistry func_registry;
   Resolver resolver("cel", func_registry.InternalGetRegistry(),
@@ -0,0 +1,110 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/step_fusion_optimization.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "base/ast_internal/ast_impl.h"
+#include "base/ast_internal/expr.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/fused_step.h"
+#include "internal/status_macros.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::ast_internal::AstImpl;
+using ::cel::ast_internal::Expr;
+
+// Returns the number of nodes in a pure ident/select access chain rooted at
+// `node`, or -1 if the chain contains any other expression kind.
+int AccessChainLength(const Expr& node) {
+  if (node.has_ident_expr()) {
+    return 1;
+  }
+  if (node.has_select_expr()) {
+    int operand_length = AccessChainLength(node.select_expr().operand());
+    return operand_length < 0 ? -1 : operand_length + 1;
+  }
+  return -1;
+}
+
+class StepFusionOptimization : public ProgramOptimizer {
+ public:
+  absl::Status OnPreVisit(PlannerContext& context, const Expr& node) override {
+    path_.push_back(&node);
+    return absl::OkStatus();
+  }
+
+  absl::Status OnPostVisit(PlannerContext& context, const Expr& node) override {
+    if (path_.empty() || path_.back() != &node) {
+      return absl::InternalError("StepFusionOptimization called out of order.");
+    }
+    path_.pop_back();
+
+    // Only fuse at the top of an access chain; inner segments are part of the
+    // outer chain's plan.
+    if (!path_.empty() && path_.back()->has_select_expr() &&
+        &path_.back()->select_expr().operand() == &node) {
+      return absl::OkStatus();
+    }
+
+    int chain_length = AccessChainLength(node);
+    if (chain_length < 2) {
+      return absl::OkStatus();
+    }
+
+    ProgramBuilder::Subexpression* subexpression =
+        context.program_builder().GetSubexpression(&node);
+    if (subexpression == nullptr || subexpression->IsFlattened() ||
+        subexpression->IsRecursive()) {
+      // Already modified by another extension or planned recursively; the
+      // recursive plan has no per-step dispatch to save.
+      return absl::OkStatus();
+    }
+
+    // The chain only qualifies when the planner emitted exactly one jump-free
+    // step per segment. Fewer steps means part of the chain resolved to a
+    // qualified identifier or enum constant; more means some other extension
+    // rewrote the plan.
+    ExecutionPathView subplan = context.GetSubplan(node);
+    if (subplan.size() != static_cast<size_t>(chain_length)) {
+      return absl::OkStatus();
+    }
+
+    CEL_ASSIGN_OR_RETURN(ExecutionPath chain_plan,
+                         context.ExtractSubplan(node));
+    ExecutionPath new_plan;
+    new_plan.push_back(CreateFusedStep(std::move(chain_plan), node.id()));
+    return context.ReplaceSubplan(node, std::move(new_plan));
+  }
+
+ private:
+  std::vector<const Expr*> path_;
+};
+
+}  // namespace
+
+ProgramOptimizerFactory CreateStepFusionExtension() {
+  return [](PlannerContext& context, const AstImpl& ast) {
+    return std::make_unique<StepFusionOptimization>();
+  };
+}
+
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,115 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/step_fusion_optimization.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "eval/compiler/cel_expression_builder_flat_impl.h"
+#include "eval/compiler/flat_expr_builder.h"
+#include "eval/public/activation.h"
+#include "eval/public/builtin_func_registrar.h"
+#include "eval/public/cel_expression.h"
+#include "eval/public/cel_options.h"
+#include "eval/public/cel_value.h"
+#include "eval/public/containers/container_backed_map_impl.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::google::api::expr::parser::Parse;
+using cel::internal::IsOkAndHolds;
+
+namespace exprpb = google::api::expr::v1alpha1;
+
+class StepFusionExtensionTest : public testing::Test {
+ public:
+  StepFusionExtensionTest() {
+    builder_.flat_expr_builder().AddProgramOptimizer(
+        CreateStepFusionExtension());
+  }
+
+  void SetUp() override {
+    ASSERT_OK(RegisterBuiltinFunctions(builder_.GetRegistry(), options_));
+
+    // request.auth.claims == "admin"
+    std::vector<std::pair<CelValue, CelValue>> claims = {
+        {CelValue::CreateStringView("claims"),
+         CelValue::CreateStringView("admin")}};
+    ASSERT_OK_AND_ASSIGN(auth_map_, CreateContainerBackedMap(claims));
+    std::vector<std::pair<CelValue, CelValue>> request = {
+        {CelValue::CreateStringView("auth"),
+         CelValue::CreateMap(auth_map_.get())}};
+    ASSERT_OK_AND_ASSIGN(request_map_, CreateContainerBackedMap(request));
+  }
+
+ protected:
+  absl::StatusOr<bool> Evaluate(const std::string& expression) {
+    CEL_ASSIGN_OR_RETURN(exprpb::ParsedExpr expr, Parse(expression));
+    CEL_ASSIGN_OR_RETURN(
+        std::unique_ptr<CelExpression> plan,
+        builder_.CreateExpression(&expr.expr(), &expr.source_info()));
+
+    Activation activation;
+    google::protobuf::Arena arena;
+    activation.InsertValue("request", CelValue::CreateMap(request_map_.get()));
+
+    CEL_ASSIGN_OR_RETURN(CelValue result, plan->Evaluate(activation, &arena));
+    if (!result.IsBool()) {
+      return absl::InternalError(result.DebugString());
+    }
+    return result.BoolOrDie();
+  }
+
+  CelExpressionBuilderFlatImpl builder_;
+  InterpreterOptions options_;
+  std::unique_ptr<CelMap> auth_map_;
+  std::unique_ptr<CelMap> request_map_;
+};
+
+TEST_F(StepFusionExtensionTest, FusesSelectChain) {
+  EXPECT_THAT(Evaluate("request.auth.claims == 'admin'"), IsOkAndHolds(true));
+  EXPECT_THAT(Evaluate("request.auth.claims == 'viewer'"), IsOkAndHolds(false));
+}
+
+TEST_F(StepFusionExtensionTest, SingleIdentNotFusedStillCorrect) {
+  EXPECT_THAT(Evaluate("request == request"), IsOkAndHolds(true));
+}
+
+TEST_F(StepFusionExtensionTest, TestOnlySelectChain) {
+  EXPECT_THAT(Evaluate("has(request.auth)"), IsOkAndHolds(true));
+  EXPECT_THAT(Evaluate("has(request.missing)"), IsOkAndHolds(false));
+}
+
+TEST_F(StepFusionExtensionTest, ShortCircuitAroundFusedChains) {
+  EXPECT_THAT(
+      Evaluate("request.auth.claims == 'admin' || request.missing.x == 1"),
+      IsOkAndHolds(true));
+}
+
+TEST_F(StepFusionExtensionTest, ChainAsCallArgument) {
+  EXPECT_THAT(Evaluate("size(request.auth.claims) == 5"), IsOkAndHolds(true));
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,189 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/string_concat_optimization.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "base/ast_internal/ast_impl.h"
+#include "base/ast_internal/expr.h"
+#include "base/builtins.h"
+#include "common/native_type.h"
+#include "common/value.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+#include "eval/eval/compiler_constant_step.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/string_concat_step.h"
+#include "internal/casts.h"
+#include "internal/status_macros.h"
+#include "runtime/runtime_options.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::InstanceOf;
+using ::cel::NativeTypeId;
+using ::cel::StringValue;
+using ::cel::Value;
+using ::cel::ast_internal::AstImpl;
+using ::cel::ast_internal::Expr;
+using ::cel::ast_internal::Reference;
+using ::cel::internal::down_cast;
+
+using ReferenceMap = absl::flat_hash_map<int64_t, Reference>;
+
+// Minimum number of operands before the n-ary join beats pairwise steps.
+constexpr size_t kMinOperands = 3;
+
+bool IsAddCall(const Expr& expr) {
+  return expr.has_call_expr() && !expr.call_expr().has_target() &&
+         expr.call_expr().function() == cel::builtin::kAdd &&
+         expr.call_expr().args().size() == 2;
+}
+
+// Whether the given `_+_` node is known to be (checked) or may be assumed to
+// be (parse-only) the string concatenation overload.
+bool IsStringAdd(const Expr& expr, const ReferenceMap& reference_map) {
+  if (reference_map.empty()) {
+    // Parse-only; the caller additionally requires a string constant anchor.
+    return true;
+  }
+  auto reference = reference_map.find(expr.id());
+  return reference != reference_map.end() &&
+         reference->second.overload_id().size() == 1 &&
+         reference->second.overload_id().front() == "add_string";
+}
+
+class StringConcatOptimization : public ProgramOptimizer {
+ public:
+  explicit StringConcatOptimization(const ReferenceMap& reference_map)
+      : reference_map_(reference_map) {}
+
+  absl::Status OnPreVisit(PlannerContext& context, const Expr& node) override {
+    path_.push_back(&node);
+    return absl::OkStatus();
+  }
+
+  absl::Status OnPostVisit(PlannerContext& context, const Expr& node) override {
+    if (path_.empty() || path_.back() != &node) {
+      return absl::InternalError(
+          "StringConcatOptimization called out of order.");
+    }
+    path_.pop_back();
+
+    // With unknown processing the pairwise function steps also inspect the
+    // operands' attribute trails, which the join step does not replicate.
+    if (context.options().unknown_processing !=
+        cel::UnknownProcessingOptions::kDisabled) {
+      return absl::OkStatus();
+    }
+
+    // Only rewrite at the root of a + chain: inner + nodes are handled as
+    // part of the chain.
+    if (!IsAddCall(node) || (!path_.empty() && IsAddCall(*path_.back()))) {
+      return absl::OkStatus();
+    }
+
+    std::vector<const Expr*> operands;
+    if (!CollectOperands(node, operands) || operands.size() < kMinOperands) {
+      return absl::OkStatus();
+    }
+
+    // Without checker references, require a leading string constant: it
+    // forces the pairwise fold to be string-typed from the first operand on,
+    // so the join step can reproduce the fold's behavior exactly.
+    if (reference_map_.empty() &&
+        !IsConstantString(context, *operands.front())) {
+      return absl::OkStatus();
+    }
+
+    ProgramBuilder::Subexpression* subexpression =
+        context.program_builder().GetSubexpression(&node);
+    if (subexpression == nullptr || subexpression->IsFlattened() ||
+        subexpression->IsRecursive()) {
+      // Already modified or planned recursively; leave the pairwise steps.
+      return absl::OkStatus();
+    }
+
+    for (const Expr* operand : operands) {
+      if (context.GetSubplan(*operand).empty()) {
+        // This subexpression was already optimized, nothing to do.
+        return absl::OkStatus();
+      }
+    }
+
+    ExecutionPath new_plan;
+    for (const Expr* operand : operands) {
+      CEL_ASSIGN_OR_RETURN(ExecutionPath operand_plan,
+                           context.ExtractSubplan(*operand));
+      for (auto& step : operand_plan) {
+        new_plan.push_back(std::move(step));
+      }
+    }
+    CEL_ASSIGN_OR_RETURN(new_plan.emplace_back(),
+                         CreateStringConcatStep(operands.size(), node.id()));
+
+    return context.ReplaceSubplan(node, std::move(new_plan));
+  }
+
+ private:
+  bool CollectOperands(const Expr& node,
+                       std::vector<const Expr*>& operands) const {
+    if (IsAddCall(node)) {
+      if (!IsStringAdd(node, reference_map_)) {
+        return false;
+      }
+      return CollectOperands(node.call_expr().args()[0], operands) &&
+             CollectOperands(node.call_expr().args()[1], operands);
+    }
+    operands.push_back(&node);
+    return true;
+  }
+
+  bool IsConstantString(PlannerContext& context, const Expr& expr) const {
+    if (expr.has_const_expr() && expr.const_expr().has_string_value()) {
+      return true;
+    }
+
+    ExecutionPathView plan = context.GetSubplan(expr);
+    if (plan.size() == 1 &&
+        plan[0]->GetNativeTypeId() ==
+            NativeTypeId::For<CompilerConstantStep>()) {
+      const Value& constant =
+          down_cast<const CompilerConstantStep*>(plan[0].get())->value();
+      return InstanceOf<StringValue>(constant);
+    }
+
+    return false;
+  }
+
+  const ReferenceMap& reference_map_;
+  std::vector<const Expr*> path_;
+};
+
+}  // namespace
+
+ProgramOptimizerFactory CreateStringConcatOptimization() {
+  return [](PlannerContext& context, const AstImpl& ast) {
+    return std::make_unique<StringConcatOptimization>(ast.reference_map());
+  };
+}
+
+}  // namespace google::api::expr::runtime
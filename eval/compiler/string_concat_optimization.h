@@ -0,0 +1,35 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_COMPILER_STRING_CONCAT_OPTIMIZATION_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_COMPILER_STRING_CONCAT_OPTIMIZATION_H_
+
+#include "eval/compiler/flat_expr_builder_extensions.h"
+
+namespace google::api::expr::runtime {
+
+// Creates a program optimizer that collapses chains of string concatenation
+// (`a + b + c + ...`) into a single n-ary join step. The join computes the
+// total size up front and allocates the result once instead of producing an
+// intermediate string per pairwise `_+_` call.
+//
+// For checked expressions, every `_+_` in the chain must resolve to the
+// add_string overload. For parse-only expressions the chain must start with a
+// string constant, which forces the pairwise fold to be string-typed
+// throughout.
+ProgramOptimizerFactory CreateStringConcatOptimization();
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_COMPILER_STRING_CONCAT_OPTIMIZATION_H_
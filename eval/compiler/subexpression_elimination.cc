@@ -0,0 +1,579 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/subexpression_elimination.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/hash/hash.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "base/ast_internal/ast_impl.h"
+#include "base/builtins.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+using ::cel::ast_internal::AstImpl;
+using ::cel::ast_internal::Expr;
+
+// Aliases use a leading '@' so they can never collide with identifiers in the
+// source expression.
+constexpr absl::string_view kAliasPrefix = "@cse";
+// Cross-program aliases resolve through the activation rather than a bind
+// slot, so they use a distinct prefix. No dots: the identifier must stay a
+// single unqualified name.
+constexpr absl::string_view kSharedAliasPrefix = "@shared_cse";
+// Iteration variable name the planner recognizes for cel.bind style
+// comprehensions (see IsBind in flat_expr_builder.cc).
+constexpr absl::string_view kUnusedIterVar = "#unused";
+
+bool IsIndexCall(const Expr& expr) {
+  return expr.has_call_expr() && !expr.call_expr().has_target() &&
+         expr.call_expr().function() == cel::builtin::kIndex &&
+         expr.call_expr().args().size() == 2;
+}
+
+// True if the subtree is built solely from identifiers, constants, field
+// selections and index operations.
+bool IsChain(const Expr& expr) {
+  if (expr.has_ident_expr() || expr.has_const_expr()) {
+    return true;
+  }
+  if (expr.has_select_expr()) {
+    return expr.select_expr().has_operand() &&
+           IsChain(expr.select_expr().operand());
+  }
+  if (IsIndexCall(expr)) {
+    return IsChain(expr.call_expr().args()[0]) &&
+           IsChain(expr.call_expr().args()[1]);
+  }
+  return false;
+}
+
+// Structural hash of a chain, ignoring expression ids. Constant values only
+// contribute their alternative; buckets are verified with ChainEquals.
+size_t HashChain(const Expr& expr) {
+  if (expr.has_ident_expr()) {
+    return absl::HashOf(0, expr.ident_expr().name());
+  }
+  if (expr.has_const_expr()) {
+    return absl::HashOf(1, expr.const_expr().kind().index());
+  }
+  if (expr.has_select_expr()) {
+    return absl::HashOf(2, expr.select_expr().field(),
+                        expr.select_expr().test_only(),
+                        HashChain(expr.select_expr().operand()));
+  }
+  return absl::HashOf(3, HashChain(expr.call_expr().args()[0]),
+                      HashChain(expr.call_expr().args()[1]));
+}
+
+// Structural equality ignoring expression ids. `rhs` must be a chain; `lhs`
+// may be an arbitrary subtree and fails fast on the first mismatch.
+bool ChainEquals(const Expr& lhs, const Expr& rhs) {
+  if (rhs.has_ident_expr()) {
+    return lhs.has_ident_expr() &&
+           lhs.ident_expr().name() == rhs.ident_expr().name();
+  }
+  if (rhs.has_const_expr()) {
+    return lhs.has_const_expr() && lhs.const_expr() == rhs.const_expr();
+  }
+  if (rhs.has_select_expr()) {
+    return lhs.has_select_expr() &&
+           lhs.select_expr().field() == rhs.select_expr().field() &&
+           lhs.select_expr().test_only() == rhs.select_expr().test_only() &&
+           lhs.select_expr().has_operand() &&
+           ChainEquals(lhs.select_expr().operand(),
+                       rhs.select_expr().operand());
+  }
+  return IsIndexCall(lhs) &&
+         ChainEquals(lhs.call_expr().args()[0], rhs.call_expr().args()[0]) &&
+         ChainEquals(lhs.call_expr().args()[1], rhs.call_expr().args()[1]);
+}
+
+int ChainSize(const Expr& expr) {
+  if (expr.has_select_expr()) {
+    return 1 + ChainSize(expr.select_expr().operand());
+  }
+  if (expr.has_call_expr()) {
+    return 1 + ChainSize(expr.call_expr().args()[0]) +
+           ChainSize(expr.call_expr().args()[1]);
+  }
+  return 1;
+}
+
+void CollectChainIdents(const Expr& expr,
+                        absl::flat_hash_set<std::string>& idents) {
+  if (expr.has_ident_expr()) {
+    idents.insert(expr.ident_expr().name());
+  } else if (expr.has_select_expr()) {
+    CollectChainIdents(expr.select_expr().operand(), idents);
+  } else if (expr.has_call_expr()) {
+    CollectChainIdents(expr.call_expr().args()[0], idents);
+    CollectChainIdents(expr.call_expr().args()[1], idents);
+  }
+}
+
+struct Candidate {
+  // Points into the AST; valid until the candidate's own rewrite pass moves
+  // the first matching occurrence into `init`.
+  const Expr* exemplar;
+  int occurrences;
+  int size;
+  absl::flat_hash_set<std::string> idents;
+  std::string alias;
+  absl::optional<Expr> init;
+  // Number of distinct programs the chain occurs in. Always 1 for the
+  // single-program transform.
+  int programs = 1;
+  int last_program = 0;
+
+  const Expr& Template() const {
+    return init.has_value() ? *init : *exemplar;
+  }
+};
+
+// Tracks comprehension variables in scope during a traversal. A chain may
+// only be counted or replaced where none of its identifiers are bound by an
+// enclosing comprehension, since those change value per iteration.
+class ScopeTracker {
+ public:
+  void Push(absl::string_view name) { bound_.push_back(name); }
+  void Pop() { bound_.pop_back(); }
+
+  bool AnyBound(const absl::flat_hash_set<std::string>& idents) const {
+    for (absl::string_view name : bound_) {
+      if (idents.contains(name)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  std::vector<absl::string_view> bound_;
+};
+
+// First pass: counts scope-eligible occurrences of maximal chains (chains not
+// embedded in a longer chain).
+class CandidateCollector {
+ public:
+  void Walk(const Expr& expr) {
+    if (IsChain(expr)) {
+      // Bare identifiers and constants are not worth hoisting; chains are
+      // closed under their own node kinds, so there is nothing further to
+      // collect inside.
+      if (expr.has_select_expr() || IsIndexCall(expr)) {
+        Record(expr);
+      }
+      return;
+    }
+    if (expr.has_select_expr()) {
+      if (expr.select_expr().has_operand()) {
+        Walk(expr.select_expr().operand());
+      }
+    } else if (expr.has_call_expr()) {
+      const auto& call = expr.call_expr();
+      if (call.has_target()) {
+        Walk(call.target());
+      }
+      for (const Expr& arg : call.args()) {
+        Walk(arg);
+      }
+    } else if (expr.has_list_expr()) {
+      for (const auto& element : expr.list_expr().elements()) {
+        if (element.has_expr()) {
+          Walk(element.expr());
+        }
+      }
+    } else if (expr.has_struct_expr()) {
+      for (const auto& field : expr.struct_expr().fields()) {
+        if (field.has_value()) {
+          Walk(field.value());
+        }
+      }
+    } else if (expr.has_map_expr()) {
+      for (const auto& entry : expr.map_expr().entries()) {
+        if (entry.has_key()) {
+          Walk(entry.key());
+        }
+        if (entry.has_value()) {
+          Walk(entry.value());
+        }
+      }
+    } else if (expr.has_comprehension_expr()) {
+      const auto& comprehension = expr.comprehension_expr();
+      if (comprehension.has_iter_range()) {
+        Walk(comprehension.iter_range());
+      }
+      if (comprehension.has_accu_init()) {
+        Walk(comprehension.accu_init());
+      }
+      scope_.Push(comprehension.accu_var());
+      if (comprehension.has_result()) {
+        Walk(comprehension.result());
+      }
+      scope_.Push(comprehension.iter_var());
+      if (comprehension.has_loop_condition()) {
+        Walk(comprehension.loop_condition());
+      }
+      if (comprehension.has_loop_step()) {
+        Walk(comprehension.loop_step());
+      }
+      scope_.Pop();
+      scope_.Pop();
+    }
+  }
+
+  std::vector<Candidate>& candidates() { return candidates_; }
+
+  // Marks subsequent walks as belonging to program `index`, for
+  // per-candidate program counts in the cross-program transform.
+  void BeginProgram(int index) { current_program_ = index; }
+
+ private:
+  void Record(const Expr& expr) {
+    absl::flat_hash_set<std::string> idents;
+    CollectChainIdents(expr, idents);
+    if (scope_.AnyBound(idents)) {
+      return;
+    }
+    size_t hash = HashChain(expr);
+    for (int index : buckets_[hash]) {
+      Candidate& candidate = candidates_[index];
+      if (ChainEquals(expr, *candidate.exemplar)) {
+        ++candidate.occurrences;
+        if (candidate.last_program != current_program_) {
+          ++candidate.programs;
+          candidate.last_program = current_program_;
+        }
+        return;
+      }
+    }
+    buckets_[hash].push_back(static_cast<int>(candidates_.size()));
+    candidates_.push_back(Candidate{&expr, 1, ChainSize(expr),
+                                    std::move(idents), std::string(),
+                                    absl::nullopt});
+    candidates_.back().last_program = current_program_;
+  }
+
+  ScopeTracker scope_;
+  absl::flat_hash_map<size_t, std::vector<int>> buckets_;
+  std::vector<Candidate> candidates_;
+  int current_program_ = 0;
+};
+
+// Second pass (run once per selected candidate): replaces every
+// scope-eligible match with a reference to the candidate's alias. The first
+// match is moved into `candidate.init` to later become the alias
+// initializer, preserving its original expression ids and any associated
+// type or reference metadata.
+class OccurrenceRewriter {
+ public:
+  OccurrenceRewriter(Candidate& candidate, int64_t& next_id)
+      : candidate_(candidate), next_id_(next_id) {}
+
+  void Rewrite(Expr& expr) {
+    if (TryReplace(expr)) {
+      return;
+    }
+    if (expr.has_select_expr()) {
+      if (expr.select_expr().has_operand()) {
+        Rewrite(expr.mutable_select_expr().mutable_operand());
+      }
+    } else if (expr.has_call_expr()) {
+      auto& call = expr.mutable_call_expr();
+      if (call.has_target()) {
+        Rewrite(call.mutable_target());
+      }
+      for (Expr& arg : call.mutable_args()) {
+        Rewrite(arg);
+      }
+    } else if (expr.has_list_expr()) {
+      for (auto& element : expr.mutable_list_expr().mutable_elements()) {
+        if (element.has_expr()) {
+          Rewrite(element.mutable_expr());
+        }
+      }
+    } else if (expr.has_struct_expr()) {
+      for (auto& field : expr.mutable_struct_expr().mutable_fields()) {
+        if (field.has_value()) {
+          Rewrite(field.mutable_value());
+        }
+      }
+    } else if (expr.has_map_expr()) {
+      for (auto& entry : expr.mutable_map_expr().mutable_entries()) {
+        if (entry.has_key()) {
+          Rewrite(entry.mutable_key());
+        }
+        if (entry.has_value()) {
+          Rewrite(entry.mutable_value());
+        }
+      }
+    } else if (expr.has_comprehension_expr()) {
+      auto& comprehension = expr.mutable_comprehension_expr();
+      if (comprehension.has_iter_range()) {
+        Rewrite(comprehension.mutable_iter_range());
+      }
+      if (comprehension.has_accu_init()) {
+        Rewrite(comprehension.mutable_accu_init());
+      }
+      scope_.Push(comprehension.accu_var());
+      if (comprehension.has_result()) {
+        Rewrite(comprehension.mutable_result());
+      }
+      scope_.Push(comprehension.iter_var());
+      if (comprehension.has_loop_condition()) {
+        Rewrite(comprehension.mutable_loop_condition());
+      }
+      if (comprehension.has_loop_step()) {
+        Rewrite(comprehension.mutable_loop_step());
+      }
+      scope_.Pop();
+      scope_.Pop();
+    }
+  }
+
+ private:
+  bool TryReplace(Expr& expr) {
+    if (!ChainEquals(expr, candidate_.Template()) ||
+        scope_.AnyBound(candidate_.idents)) {
+      return false;
+    }
+    if (!candidate_.init.has_value()) {
+      candidate_.init.emplace(std::move(expr));
+    }
+    Expr replacement;
+    replacement.set_id(next_id_++);
+    replacement.mutable_ident_expr().set_name(candidate_.alias);
+    expr = std::move(replacement);
+    return true;
+  }
+
+  Candidate& candidate_;
+  int64_t& next_id_;
+  ScopeTracker scope_;
+};
+
+int64_t MaxExprId(const Expr& expr) {
+  int64_t max_id = expr.id();
+  if (expr.has_select_expr()) {
+    if (expr.select_expr().has_operand()) {
+      max_id = std::max(max_id, MaxExprId(expr.select_expr().operand()));
+    }
+  } else if (expr.has_call_expr()) {
+    const auto& call = expr.call_expr();
+    if (call.has_target()) {
+      max_id = std::max(max_id, MaxExprId(call.target()));
+    }
+    for (const Expr& arg : call.args()) {
+      max_id = std::max(max_id, MaxExprId(arg));
+    }
+  } else if (expr.has_list_expr()) {
+    for (const auto& element : expr.list_expr().elements()) {
+      if (element.has_expr()) {
+        max_id = std::max(max_id, MaxExprId(element.expr()));
+      }
+    }
+  } else if (expr.has_struct_expr()) {
+    for (const auto& field : expr.struct_expr().fields()) {
+      max_id = std::max(max_id, field.id());
+      if (field.has_value()) {
+        max_id = std::max(max_id, MaxExprId(field.value()));
+      }
+    }
+  } else if (expr.has_map_expr()) {
+    for (const auto& entry : expr.map_expr().entries()) {
+      max_id = std::max(max_id, entry.id());
+      if (entry.has_key()) {
+        max_id = std::max(max_id, MaxExprId(entry.key()));
+      }
+      if (entry.has_value()) {
+        max_id = std::max(max_id, MaxExprId(entry.value()));
+      }
+    }
+  } else if (expr.has_comprehension_expr()) {
+    const auto& comprehension = expr.comprehension_expr();
+    if (comprehension.has_iter_range()) {
+      max_id = std::max(max_id, MaxExprId(comprehension.iter_range()));
+    }
+    if (comprehension.has_accu_init()) {
+      max_id = std::max(max_id, MaxExprId(comprehension.accu_init()));
+    }
+    if (comprehension.has_loop_condition()) {
+      max_id = std::max(max_id, MaxExprId(comprehension.loop_condition()));
+    }
+    if (comprehension.has_loop_step()) {
+      max_id = std::max(max_id, MaxExprId(comprehension.loop_step()));
+    }
+    if (comprehension.has_result()) {
+      max_id = std::max(max_id, MaxExprId(comprehension.result()));
+    }
+  }
+  return max_id;
+}
+
+// Wraps `root` in a bind-style comprehension that the planner lowers to a
+// lazily initialized slot (see lazy_init_step.h).
+Expr MakeBind(std::string alias, Expr init, Expr root, int64_t& next_id) {
+  Expr bind;
+  bind.set_id(next_id++);
+  auto& comprehension = bind.mutable_comprehension_expr();
+  comprehension.set_iter_var(kUnusedIterVar);
+  Expr iter_range;
+  iter_range.set_id(next_id++);
+  iter_range.mutable_list_expr();
+  comprehension.set_iter_range(std::move(iter_range));
+  comprehension.set_accu_var(std::move(alias));
+  comprehension.set_accu_init(std::move(init));
+  Expr loop_condition;
+  loop_condition.set_id(next_id++);
+  loop_condition.mutable_const_expr().set_bool_value(false);
+  comprehension.set_loop_condition(std::move(loop_condition));
+  Expr loop_step;
+  loop_step.set_id(next_id++);
+  loop_step.mutable_ident_expr().set_name(comprehension.accu_var());
+  comprehension.set_loop_step(std::move(loop_step));
+  comprehension.set_result(std::move(root));
+  return bind;
+}
+
+class SubexpressionEliminationExtension : public AstTransform {
+ public:
+  absl::Status UpdateAst(PlannerContext& context,
+                         AstImpl& ast) const override {
+    return EliminateCommonSubexpressions(ast).status();
+  }
+};
+
+}  // namespace
+
+absl::StatusOr<bool> EliminateCommonSubexpressions(AstImpl& ast) {
+  CandidateCollector collector;
+  collector.Walk(ast.root_expr());
+
+  std::vector<Candidate*> selected;
+  for (Candidate& candidate : collector.candidates()) {
+    if (candidate.occurrences >= 2) {
+      selected.push_back(&candidate);
+    }
+  }
+  if (selected.empty()) {
+    return false;
+  }
+  // Rewrite innermost (smallest) chains first so that chains sharing a
+  // repeated prefix stay structurally identical after the prefix is hoisted;
+  // later (larger) candidates then match and may reference earlier aliases.
+  std::stable_sort(selected.begin(), selected.end(),
+                   [](const Candidate* lhs, const Candidate* rhs) {
+                     return lhs->size < rhs->size;
+                   });
+
+  int64_t next_id = MaxExprId(ast.root_expr()) + 1;
+  int alias_index = 0;
+  for (Candidate* candidate : selected) {
+    candidate->alias = absl::StrCat(kAliasPrefix, alias_index++);
+    OccurrenceRewriter rewriter(*candidate, next_id);
+    rewriter.Rewrite(ast.root_expr());
+  }
+
+  // Wrap the rewritten expression in one bind per alias, innermost bind for
+  // the largest chain, so larger initializers may reference the aliases of
+  // the smaller chains they contain. Binds initialize lazily, so unused
+  // aliases (e.g. on a short-circuited branch) are never evaluated.
+  Expr root = std::move(ast.root_expr());
+  for (auto it = selected.rbegin(); it != selected.rend(); ++it) {
+    Candidate* candidate = *it;
+    if (!candidate->init.has_value()) {
+      continue;
+    }
+    root = MakeBind(std::move(candidate->alias),
+                    std::move(*candidate->init), std::move(root), next_id);
+  }
+  ast.root_expr() = std::move(root);
+  return true;
+}
+
+std::unique_ptr<AstTransform> NewSubexpressionEliminationExtension() {
+  return std::make_unique<SubexpressionEliminationExtension>();
+}
+
+absl::StatusOr<std::vector<CrossProgramSubexpression>>
+ExtractCrossProgramSubexpressions(
+    absl::Span<cel::ast_internal::AstImpl* const> asts) {
+  CandidateCollector collector;
+  for (size_t i = 0; i < asts.size(); ++i) {
+    collector.BeginProgram(static_cast<int>(i));
+    collector.Walk(asts[i]->root_expr());
+  }
+
+  std::vector<Candidate*> selected;
+  for (Candidate& candidate : collector.candidates()) {
+    // Chains repeated within one program are left to the single-program
+    // transform; only chains shared between programs are worth hoisting to
+    // the session level.
+    if (candidate.programs >= 2) {
+      selected.push_back(&candidate);
+    }
+  }
+  if (selected.empty()) {
+    return std::vector<CrossProgramSubexpression>();
+  }
+  // Smallest chains first, for the same reason as the single-program
+  // transform: chains sharing a hoisted prefix stay structurally identical,
+  // and larger initializers may reference the aliases of the smaller chains
+  // they contain.
+  std::stable_sort(selected.begin(), selected.end(),
+                   [](const Candidate* lhs, const Candidate* rhs) {
+                     return lhs->size < rhs->size;
+                   });
+
+  // Expression ids are scoped per AST; fresh ids for the replacement
+  // identifiers must be unique within their own AST only.
+  std::vector<int64_t> next_ids;
+  next_ids.reserve(asts.size());
+  for (const AstImpl* ast : asts) {
+    next_ids.push_back(MaxExprId(ast->root_expr()) + 1);
+  }
+
+  std::vector<CrossProgramSubexpression> shared;
+  shared.reserve(selected.size());
+  int alias_index = 0;
+  for (Candidate* candidate : selected) {
+    candidate->alias = absl::StrCat(kSharedAliasPrefix, alias_index++);
+    for (size_t i = 0; i < asts.size(); ++i) {
+      OccurrenceRewriter rewriter(*candidate, next_ids[i]);
+      rewriter.Rewrite(asts[i]->root_expr());
+    }
+    shared.push_back(CrossProgramSubexpression{std::move(candidate->alias),
+                                               std::move(*candidate->init)});
+  }
+  return shared;
+}
+
+}  // namespace google::api::expr::runtime
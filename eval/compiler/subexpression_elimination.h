@@ -0,0 +1,74 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_COMPILER_SUBEXPRESSION_ELIMINATION_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_COMPILER_SUBEXPRESSION_ELIMINATION_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "base/ast_internal/ast_impl.h"
+#include "base/ast_internal/expr.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+
+namespace google::api::expr::runtime {
+
+// Hoists syntactically identical attribute-style subexpressions (chains of
+// field selections and index operations rooted at an identifier, e.g.
+// `request.auth.claims["groups"]`) that occur more than once into hidden
+// cel.bind-style aliases, and rewrites the occurrences into references to the
+// alias. The planner lowers the aliases onto lazily initialized comprehension
+// slots, so each hoisted subexpression is planned and evaluated at most once
+// per evaluation regardless of how often it occurs.
+//
+// Occurrences that refer to comprehension variables are left untouched, as
+// their value changes per iteration. Subexpressions containing function calls
+// other than the index operator are not considered, since user functions may
+// have observable side effects.
+//
+// Returns true if any subexpressions were hoisted.
+absl::StatusOr<bool> EliminateCommonSubexpressions(
+    cel::ast_internal::AstImpl& ast);
+
+// Returns the above as an AstTransform, for use with
+// FlatExprBuilder::AddAstTransform. If reference resolution is in use it
+// should be registered before this transform.
+std::unique_ptr<AstTransform> NewSubexpressionEliminationExtension();
+
+// A subexpression hoisted out of a group of expressions by
+// ExtractCrossProgramSubexpressions. Rewritten occurrences reference `alias`
+// as a free identifier; `init` is the hoisted chain, suitable for compilation
+// as a standalone expression. Initializers may reference the aliases of
+// entries earlier in the returned vector, never later ones.
+struct CrossProgramSubexpression {
+  std::string alias;
+  cel::ast_internal::Expr init;
+};
+
+// Cross-program variant of EliminateCommonSubexpressions. Attribute chains
+// occurring in at least two of `asts` are rewritten, in every AST, into
+// references to a fresh free identifier, and returned so the caller can
+// evaluate each chain once and bind the result for all programs (see
+// cel::MultiProgramSession). The same scope and side-effect restrictions as
+// the single-program transform apply.
+absl::StatusOr<std::vector<CrossProgramSubexpression>>
+ExtractCrossProgramSubexpressions(
+    absl::Span<cel::ast_internal::AstImpl* const> asts);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_COMPILER_SUBEXPRESSION_ELIMINATION_H_
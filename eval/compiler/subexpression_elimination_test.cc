@@ -0,0 +1,152 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/subexpression_elimination.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/log/absl_check.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
+#include "base/ast_internal/ast_impl.h"
+#include "base/ast_internal/expr.h"
+#include "extensions/protobuf/ast_converters.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::ast_internal::AstImpl;
+using ::cel::ast_internal::Expr;
+using ::google::api::expr::parser::Parse;
+using cel::internal::IsOkAndHolds;
+
+std::unique_ptr<AstImpl> ParseToAst(absl::string_view expression) {
+  auto parsed_expr = Parse(expression);
+  ABSL_CHECK_OK(parsed_expr.status());
+  auto ast = cel::extensions::CreateAstFromParsedExpr(*parsed_expr);
+  ABSL_CHECK_OK(ast.status());
+  return absl::WrapUnique(
+      AstImpl::CastFromPublicAst(ast->release()));
+}
+
+int CountIdents(const Expr& expr, absl::string_view name) {
+  int count = 0;
+  if (expr.has_ident_expr() && expr.ident_expr().name() == name) {
+    ++count;
+  }
+  if (expr.has_select_expr()) {
+    count += CountIdents(expr.select_expr().operand(), name);
+  } else if (expr.has_call_expr()) {
+    if (expr.call_expr().has_target()) {
+      count += CountIdents(expr.call_expr().target(), name);
+    }
+    for (const Expr& arg : expr.call_expr().args()) {
+      count += CountIdents(arg, name);
+    }
+  } else if (expr.has_list_expr()) {
+    for (const auto& element : expr.list_expr().elements()) {
+      count += CountIdents(element.expr(), name);
+    }
+  } else if (expr.has_comprehension_expr()) {
+    const auto& comprehension = expr.comprehension_expr();
+    count += CountIdents(comprehension.iter_range(), name);
+    count += CountIdents(comprehension.accu_init(), name);
+    count += CountIdents(comprehension.loop_condition(), name);
+    count += CountIdents(comprehension.loop_step(), name);
+    count += CountIdents(comprehension.result(), name);
+  }
+  return count;
+}
+
+TEST(SubexpressionEliminationTest, HoistsRepeatedSelectChain) {
+  auto ast = ParseToAst("a.b.c == 1 || a.b.c == 2");
+
+  EXPECT_THAT(EliminateCommonSubexpressions(*ast), IsOkAndHolds(true));
+
+  const Expr& root = ast->root_expr();
+  ASSERT_TRUE(root.has_comprehension_expr());
+  const auto& bind = root.comprehension_expr();
+  EXPECT_EQ(bind.accu_var(), "@cse0");
+  EXPECT_EQ(bind.iter_var(), "#unused");
+  EXPECT_TRUE(bind.iter_range().has_list_expr());
+  EXPECT_TRUE(bind.iter_range().list_expr().elements().empty());
+  ASSERT_TRUE(bind.accu_init().has_select_expr());
+  EXPECT_EQ(bind.accu_init().select_expr().field(), "c");
+  // Both occurrences in the original expression load the alias.
+  EXPECT_EQ(CountIdents(bind.result(), "@cse0"), 2);
+  EXPECT_EQ(CountIdents(bind.result(), "a"), 0);
+}
+
+TEST(SubexpressionEliminationTest, HoistsRepeatedIndexChain) {
+  auto ast = ParseToAst(R"cel(a["k"].f == a["k"].f)cel");
+
+  EXPECT_THAT(EliminateCommonSubexpressions(*ast), IsOkAndHolds(true));
+
+  const Expr& root = ast->root_expr();
+  ASSERT_TRUE(root.has_comprehension_expr());
+  EXPECT_EQ(CountIdents(root.comprehension_expr().result(), "@cse0"), 2);
+}
+
+TEST(SubexpressionEliminationTest, NoRepeatsLeavesAstUntouched) {
+  auto ast = ParseToAst("a.b + c.d");
+
+  EXPECT_THAT(EliminateCommonSubexpressions(*ast), IsOkAndHolds(false));
+  EXPECT_FALSE(ast->root_expr().has_comprehension_expr());
+}
+
+TEST(SubexpressionEliminationTest, SkipsComprehensionVariables) {
+  auto ast = ParseToAst("[1, 2].map(x, x.b.c + x.b.c)");
+
+  // `x.b.c` changes per iteration and must not be hoisted.
+  EXPECT_THAT(EliminateCommonSubexpressions(*ast), IsOkAndHolds(false));
+}
+
+TEST(SubexpressionEliminationTest, HoistsIntoComprehensionBody) {
+  auto ast = ParseToAst("a.b.c + [1, 2].map(x, a.b.c)[0]");
+
+  EXPECT_THAT(EliminateCommonSubexpressions(*ast), IsOkAndHolds(true));
+
+  const Expr& root = ast->root_expr();
+  ASSERT_TRUE(root.has_comprehension_expr());
+  EXPECT_EQ(CountIdents(root.comprehension_expr().result(), "@cse0"), 2);
+  EXPECT_EQ(CountIdents(root.comprehension_expr().result(), "a"), 0);
+}
+
+TEST(SubexpressionEliminationTest, OnlyMaximalChainHoisted) {
+  auto ast = ParseToAst("a.b.c + a.b.d + a.b.c");
+
+  EXPECT_THAT(EliminateCommonSubexpressions(*ast), IsOkAndHolds(true));
+
+  // Only `a.b.c` repeats as a full chain; `a.b` alone is never hoisted.
+  const Expr& root = ast->root_expr();
+  ASSERT_TRUE(root.has_comprehension_expr());
+  EXPECT_FALSE(root.comprehension_expr().result().has_comprehension_expr());
+  EXPECT_EQ(CountIdents(root.comprehension_expr().result(), "@cse0"), 2);
+  // `a.b.d` keeps its direct access path.
+  EXPECT_EQ(CountIdents(root.comprehension_expr().result(), "a"), 1);
+}
+
+TEST(SubexpressionEliminationTest, BareIdentsNotHoisted) {
+  auto ast = ParseToAst("a + a + a");
+
+  EXPECT_THAT(EliminateCommonSubexpressions(*ast), IsOkAndHolds(false));
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
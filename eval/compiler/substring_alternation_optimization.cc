@@ -0,0 +1,272 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/substring_alternation_optimization.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "base/ast_internal/ast_impl.h"
+#include "base/ast_internal/expr.h"
+#include "base/builtins.h"
+#include "common/native_type.h"
+#include "common/value.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+#include "eval/eval/compiler_constant_step.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/substring_set_match_step.h"
+#include "internal/casts.h"
+#include "internal/status_macros.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::Cast;
+using ::cel::InstanceOf;
+using ::cel::NativeTypeId;
+using ::cel::StringValue;
+using ::cel::Value;
+using ::cel::ast_internal::AstImpl;
+using ::cel::ast_internal::Expr;
+using ::cel::ast_internal::Reference;
+using ::cel::internal::down_cast;
+
+using ReferenceMap = absl::flat_hash_map<int64_t, Reference>;
+
+// Minimum number of disjuncts before the automaton scan beats separate
+// steps; pairs are cheap enough through the regular string functions.
+constexpr size_t kMinLiterals = 3;
+
+bool IsFunctionOverload(const Expr& expr, absl::string_view function,
+                        absl::string_view overload, size_t arity,
+                        const ReferenceMap& reference_map) {
+  if (!expr.has_call_expr()) {
+    return false;
+  }
+  const auto& call_expr = expr.call_expr();
+  if (call_expr.function() != function) {
+    return false;
+  }
+  if (call_expr.args().size() + (call_expr.has_target() ? 1 : 0) != arity) {
+    return false;
+  }
+
+  // If parse-only and opted in to the optimization, assume this is the
+  // intended overload. This will still only change the evaluation plan if the
+  // subjects and literals qualify.
+  if (reference_map.empty()) {
+    return true;
+  }
+
+  auto reference = reference_map.find(expr.id());
+  if (reference != reference_map.end() &&
+      reference->second.overload_id().size() == 1 &&
+      reference->second.overload_id().front() == overload) {
+    return true;
+  }
+  return false;
+}
+
+bool IsOrCall(const Expr& expr) {
+  return expr.has_call_expr() && !expr.call_expr().has_target() &&
+         expr.call_expr().function() == cel::builtin::kOr &&
+         expr.call_expr().args().size() == 2;
+}
+
+const Expr& MatchSubject(const Expr& call) {
+  return call.call_expr().has_target() ? call.call_expr().target()
+                                       : call.call_expr().args().front();
+}
+
+// Linearizes an ident or select chain (`a.b.c`) into a dotted path so that
+// subjects of separate disjuncts can be compared structurally. Returns
+// nullopt for any other expression shape; those may have side effects or
+// short-circuit-observable behavior, so the rewrite does not apply.
+absl::optional<std::string> SubjectPath(const Expr& expr) {
+  if (expr.has_ident_expr()) {
+    return expr.ident_expr().name();
+  }
+  if (expr.has_select_expr() && !expr.select_expr().test_only()) {
+    auto base = SubjectPath(expr.select_expr().operand());
+    if (!base.has_value()) {
+      return absl::nullopt;
+    }
+    return absl::StrCat(*base, ".", expr.select_expr().field());
+  }
+  return absl::nullopt;
+}
+
+class SubstringAlternationOptimization : public ProgramOptimizer {
+ public:
+  explicit SubstringAlternationOptimization(const ReferenceMap& reference_map)
+      : reference_map_(reference_map) {}
+
+  absl::Status OnPreVisit(PlannerContext& context, const Expr& node) override {
+    path_.push_back(&node);
+    return absl::OkStatus();
+  }
+
+  absl::Status OnPostVisit(PlannerContext& context, const Expr& node) override {
+    if (path_.empty() || path_.back() != &node) {
+      return absl::InternalError(
+          "SubstringAlternationOptimization called out of order.");
+    }
+    path_.pop_back();
+
+    // Only rewrite at the root of an || chain: inner || nodes are handled as
+    // part of the chain.
+    if (!IsOrCall(node) || (!path_.empty() && IsOrCall(*path_.back()))) {
+      return absl::OkStatus();
+    }
+
+    // All disjuncts must call the same function; the mode of the combined
+    // scan is decided by the first disjunct. Chains mixing contains() and
+    // startsWith() are left to normal evaluation.
+    absl::optional<SubstringSetMatchMode> mode = ChainMode(node);
+    if (!mode.has_value()) {
+      return absl::OkStatus();
+    }
+
+    std::vector<const Expr*> calls;
+    if (!CollectCalls(node, *mode, calls) || calls.size() < kMinLiterals) {
+      return absl::OkStatus();
+    }
+
+    // All disjuncts must scan the same subject.
+    absl::optional<std::string> subject_path =
+        SubjectPath(MatchSubject(*calls.front()));
+    if (!subject_path.has_value()) {
+      return absl::OkStatus();
+    }
+    for (const Expr* call : calls) {
+      if (SubjectPath(MatchSubject(*call)) != subject_path) {
+        return absl::OkStatus();
+      }
+    }
+
+    ProgramBuilder::Subexpression* subexpression =
+        context.program_builder().GetSubexpression(&node);
+    if (subexpression == nullptr || subexpression->IsFlattened() ||
+        subexpression->IsRecursive()) {
+      // Already modified or planned recursively.
+      return absl::OkStatus();
+    }
+
+    std::vector<std::string> literals;
+    literals.reserve(calls.size());
+    for (const Expr* call : calls) {
+      absl::optional<std::string> literal =
+          GetConstantString(context, call->call_expr().args().back());
+      if (!literal.has_value()) {
+        return absl::OkStatus();
+      }
+      literals.push_back(*std::move(literal));
+    }
+
+    const Expr& subject_expr = MatchSubject(*calls.front());
+    if (context.GetSubplan(subject_expr).empty()) {
+      // This subexpression was already optimized, nothing to do.
+      return absl::OkStatus();
+    }
+
+    CEL_ASSIGN_OR_RETURN(ExecutionPath new_plan,
+                         context.ExtractSubplan(subject_expr));
+    CEL_ASSIGN_OR_RETURN(
+        new_plan.emplace_back(),
+        CreateSubstringSetMatchStep(std::move(literals), *mode, node.id()));
+
+    return context.ReplaceSubplan(node, std::move(new_plan));
+  }
+
+ private:
+  // Determines the match mode from the leftmost disjunct, or nullopt if it is
+  // neither recognized string function.
+  absl::optional<SubstringSetMatchMode> ChainMode(const Expr& node) const {
+    if (IsOrCall(node)) {
+      return ChainMode(node.call_expr().args()[0]);
+    }
+    if (IsFunctionOverload(node, cel::builtin::kStringContains,
+                           "contains_string", 2, reference_map_)) {
+      return SubstringSetMatchMode::kContains;
+    }
+    if (IsFunctionOverload(node, cel::builtin::kStringStartsWith,
+                           "starts_with_string", 2, reference_map_)) {
+      return SubstringSetMatchMode::kStartsWith;
+    }
+    return absl::nullopt;
+  }
+
+  bool CollectCalls(const Expr& node, SubstringSetMatchMode mode,
+                    std::vector<const Expr*>& calls) const {
+    if (IsOrCall(node)) {
+      return CollectCalls(node.call_expr().args()[0], mode, calls) &&
+             CollectCalls(node.call_expr().args()[1], mode, calls);
+    }
+    absl::string_view function = mode == SubstringSetMatchMode::kContains
+                                     ? cel::builtin::kStringContains
+                                     : cel::builtin::kStringStartsWith;
+    absl::string_view overload = mode == SubstringSetMatchMode::kContains
+                                     ? "contains_string"
+                                     : "starts_with_string";
+    if (IsFunctionOverload(node, function, overload, 2, reference_map_)) {
+      calls.push_back(&node);
+      return true;
+    }
+    return false;
+  }
+
+  absl::optional<std::string> GetConstantString(PlannerContext& context,
+                                                const Expr& literal_expr) const {
+    if (literal_expr.has_const_expr() &&
+        literal_expr.const_expr().has_string_value()) {
+      return literal_expr.const_expr().string_value();
+    }
+
+    ExecutionPathView literal_plan = context.GetSubplan(literal_expr);
+    if (literal_plan.size() == 1 &&
+        literal_plan[0]->GetNativeTypeId() ==
+            NativeTypeId::For<CompilerConstantStep>()) {
+      const Value& constant =
+          down_cast<const CompilerConstantStep*>(literal_plan[0].get())
+              ->value();
+      if (InstanceOf<StringValue>(constant)) {
+        return Cast<StringValue>(constant).ToString();
+      }
+    }
+
+    return absl::nullopt;
+  }
+
+  const ReferenceMap& reference_map_;
+  std::vector<const Expr*> path_;
+};
+
+}  // namespace
+
+ProgramOptimizerFactory CreateSubstringAlternationExtension() {
+  return [](PlannerContext& context, const AstImpl& ast) {
+    return std::make_unique<SubstringAlternationOptimization>(
+        ast.reference_map());
+  };
+}
+
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,30 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_COMPILER_SUBSTRING_ALTERNATION_OPTIMIZATION_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_COMPILER_SUBSTRING_ALTERNATION_OPTIMIZATION_H_
+
+#include "eval/compiler/flat_expr_builder_extensions.h"
+
+namespace google::api::expr::runtime {
+
+// Create a new extension for the FlatExprBuilder that lowers disjunctions of
+// standard 'contains' or 'startsWith' calls with constant literals on the
+// same operand (`x.contains(s1) || x.contains(s2) || ...`) into a single
+// Aho-Corasick scan of the subject, instead of one scan per literal.
+ProgramOptimizerFactory CreateSubstringAlternationExtension();
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_COMPILER_SUBSTRING_ALTERNATION_OPTIMIZATION_H_
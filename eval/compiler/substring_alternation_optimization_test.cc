@@ -0,0 +1,190 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/substring_alternation_optimization.h"
+
+#include <memory>
+#include <string>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "eval/compiler/cel_expression_builder_flat_impl.h"
+#include "eval/compiler/flat_expr_builder.h"
+#include "eval/public/activation.h"
+#include "eval/public/builtin_func_registrar.h"
+#include "eval/public/cel_expression.h"
+#include "eval/public/cel_options.h"
+#include "eval/public/cel_value.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::google::api::expr::parser::Parse;
+using cel::internal::IsOkAndHolds;
+
+namespace exprpb = google::api::expr::v1alpha1;
+
+class SubstringAlternationExtensionTest : public testing::Test {
+ public:
+  SubstringAlternationExtensionTest() {
+    builder_.flat_expr_builder().AddProgramOptimizer(
+        CreateSubstringAlternationExtension());
+  }
+
+  void SetUp() override {
+    ASSERT_OK(RegisterBuiltinFunctions(builder_.GetRegistry(), options_));
+  }
+
+ protected:
+  absl::StatusOr<bool> Evaluate(const std::string& expression,
+                                const std::string& input) {
+    CEL_ASSIGN_OR_RETURN(exprpb::ParsedExpr expr, Parse(expression));
+    CEL_ASSIGN_OR_RETURN(
+        std::unique_ptr<CelExpression> plan,
+        builder_.CreateExpression(&expr.expr(), &expr.source_info()));
+
+    Activation activation;
+    google::protobuf::Arena arena;
+    activation.InsertValue("input", CelValue::CreateStringView(input));
+
+    CEL_ASSIGN_OR_RETURN(CelValue result, plan->Evaluate(activation, &arena));
+    if (!result.IsBool()) {
+      return absl::InternalError(result.DebugString());
+    }
+    return result.BoolOrDie();
+  }
+
+  CelExpressionBuilderFlatImpl builder_;
+  InterpreterOptions options_;
+};
+
+TEST_F(SubstringAlternationExtensionTest, RewritesDisjunctionOfContains) {
+  const std::string expression =
+      "input.contains('foo') || input.contains('bar') || "
+      "input.contains('baz')";
+
+  EXPECT_THAT(Evaluate(expression, "embargo"), IsOkAndHolds(true));
+  EXPECT_THAT(Evaluate(expression, "rebazzle"), IsOkAndHolds(true));
+  EXPECT_THAT(Evaluate(expression, "quux"), IsOkAndHolds(false));
+}
+
+TEST_F(SubstringAlternationExtensionTest, OverlappingLiterals) {
+  // Literals sharing prefixes and suffixes exercise the automaton's failure
+  // transitions.
+  const std::string expression =
+      "input.contains('abcd') || input.contains('bcf') || "
+      "input.contains('cde')";
+
+  EXPECT_THAT(Evaluate(expression, "xabcfy"), IsOkAndHolds(true));
+  EXPECT_THAT(Evaluate(expression, "xxcdey"), IsOkAndHolds(true));
+  EXPECT_THAT(Evaluate(expression, "xabcex"), IsOkAndHolds(false));
+}
+
+TEST_F(SubstringAlternationExtensionTest, RewritesDisjunctionOfStartsWith) {
+  const std::string expression =
+      "input.startsWith('http:') || input.startsWith('https:') || "
+      "input.startsWith('ftp:')";
+
+  EXPECT_THAT(Evaluate(expression, "https://example.com"), IsOkAndHolds(true));
+  EXPECT_THAT(Evaluate(expression, "ftp://example.com"), IsOkAndHolds(true));
+  EXPECT_THAT(Evaluate(expression, "gopher://example.com"),
+              IsOkAndHolds(false));
+  // startsWith must not match in the middle of the subject.
+  EXPECT_THAT(Evaluate(expression, "see https://example.com"),
+              IsOkAndHolds(false));
+}
+
+TEST_F(SubstringAlternationExtensionTest, GlobalOverloadStyle) {
+  const std::string expression =
+      "contains(input, 'foo') || contains(input, 'bar') || "
+      "contains(input, 'baz')";
+
+  EXPECT_THAT(Evaluate(expression, "barely"), IsOkAndHolds(true));
+  EXPECT_THAT(Evaluate(expression, "quux"), IsOkAndHolds(false));
+}
+
+TEST_F(SubstringAlternationExtensionTest, EmptyLiteralMatchesEverything) {
+  const std::string expression =
+      "input.contains('foo') || input.contains('') || input.contains('baz')";
+
+  EXPECT_THAT(Evaluate(expression, ""), IsOkAndHolds(true));
+  EXPECT_THAT(Evaluate(expression, "quux"), IsOkAndHolds(true));
+}
+
+TEST_F(SubstringAlternationExtensionTest,
+       MixedFunctionsNotRewrittenStillCorrect) {
+  const std::string expression =
+      "input.contains('foo') || input.startsWith('bar') || "
+      "input.contains('baz')";
+
+  EXPECT_THAT(Evaluate(expression, "barn"), IsOkAndHolds(true));
+  EXPECT_THAT(Evaluate(expression, "xbarn"), IsOkAndHolds(false));
+}
+
+TEST_F(SubstringAlternationExtensionTest,
+       MixedSubjectsNotRewrittenStillCorrect) {
+  Activation activation;
+  google::protobuf::Arena arena;
+
+  ASSERT_OK_AND_ASSIGN(
+      exprpb::ParsedExpr expr,
+      Parse("input.contains('foo') || other.contains('bar') || "
+            "input.contains('baz')"));
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CelExpression> plan,
+      builder_.CreateExpression(&expr.expr(), &expr.source_info()));
+
+  activation.InsertValue("input", CelValue::CreateStringView("quux"));
+  activation.InsertValue("other", CelValue::CreateStringView("barely"));
+
+  ASSERT_OK_AND_ASSIGN(CelValue result, plan->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsBool());
+  EXPECT_TRUE(result.BoolOrDie());
+}
+
+TEST_F(SubstringAlternationExtensionTest,
+       NonConstLiteralNotRewrittenStillCorrect) {
+  Activation activation;
+  google::protobuf::Arena arena;
+
+  ASSERT_OK_AND_ASSIGN(
+      exprpb::ParsedExpr expr,
+      Parse("input.contains('foo') || input.contains(other) || "
+            "input.contains('baz')"));
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CelExpression> plan,
+      builder_.CreateExpression(&expr.expr(), &expr.source_info()));
+
+  activation.InsertValue("input", CelValue::CreateStringView("quux"));
+  activation.InsertValue("other", CelValue::CreateStringView("uu"));
+
+  ASSERT_OK_AND_ASSIGN(CelValue result, plan->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsBool());
+  EXPECT_TRUE(result.BoolOrDie());
+}
+
+TEST_F(SubstringAlternationExtensionTest, PairLeftToStringFunctions) {
+  const std::string expression =
+      "input.contains('foo') || input.contains('bar')";
+
+  EXPECT_THAT(Evaluate(expression, "barely"), IsOkAndHolds(true));
+  EXPECT_THAT(Evaluate(expression, "quux"), IsOkAndHolds(false));
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
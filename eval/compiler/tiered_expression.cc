@@ -0,0 +1,140 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/tiered_expression.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "eval/public/base_activation.h"
+#include "eval/public/cel_expression.h"
+#include "eval/public/cel_value.h"
+#include "internal/casts.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+// Pins the program an evaluation was initialized against, so a promotion
+// between InitializeState and Evaluate never pairs state with a different
+// program shape.
+class TieredEvaluationState final : public CelEvaluationState {
+ public:
+  TieredEvaluationState(std::shared_ptr<const CelExpression> expression,
+                        std::unique_ptr<CelEvaluationState> state)
+      : expression_(std::move(expression)), state_(std::move(state)) {}
+
+  const CelExpression& expression() const { return *expression_; }
+
+  CelEvaluationState* state() { return state_.get(); }
+
+ private:
+  std::shared_ptr<const CelExpression> expression_;
+  std::unique_ptr<CelEvaluationState> state_;
+};
+
+}  // namespace
+
+TieredCelExpression::TieredCelExpression(
+    std::unique_ptr<CelExpression> baseline, Replanner replan,
+    const TieredExpressionOptions& options)
+    : shared_(std::make_shared<Shared>()),
+      promotion_threshold_(options.promotion_threshold),
+      executor_(options.executor) {
+  shared_->current = std::move(baseline);
+  shared_->replan = std::move(replan);
+}
+
+std::unique_ptr<CelEvaluationState> TieredCelExpression::InitializeState(
+    google::protobuf::Arena* arena) const {
+  std::shared_ptr<const CelExpression> snapshot = Snapshot();
+  std::unique_ptr<CelEvaluationState> state = snapshot->InitializeState(arena);
+  return std::make_unique<TieredEvaluationState>(std::move(snapshot),
+                                                 std::move(state));
+}
+
+absl::StatusOr<CelValue> TieredCelExpression::Evaluate(
+    const BaseActivation& activation, CelEvaluationState* state) const {
+  auto& tiered_state = cel::internal::down_cast<TieredEvaluationState&>(*state);
+  absl::StatusOr<CelValue> result =
+      tiered_state.expression().Evaluate(activation, tiered_state.state());
+  CountEvaluation();
+  return result;
+}
+
+absl::StatusOr<CelValue> TieredCelExpression::Trace(
+    const BaseActivation& activation, CelEvaluationState* state,
+    CelEvaluationListener callback) const {
+  auto& tiered_state = cel::internal::down_cast<TieredEvaluationState&>(*state);
+  absl::StatusOr<CelValue> result = tiered_state.expression().Trace(
+      activation, tiered_state.state(), std::move(callback));
+  CountEvaluation();
+  return result;
+}
+
+bool TieredCelExpression::promoted() const {
+  absl::MutexLock lock(&shared_->mutex);
+  return shared_->promoted;
+}
+
+absl::Status TieredCelExpression::promotion_status() const {
+  absl::MutexLock lock(&shared_->mutex);
+  return shared_->promotion_status;
+}
+
+std::shared_ptr<const CelExpression> TieredCelExpression::Snapshot() const {
+  absl::MutexLock lock(&shared_->mutex);
+  return shared_->current;
+}
+
+void TieredCelExpression::CountEvaluation() const {
+  int64_t count = evaluation_count_.fetch_add(1, std::memory_order_relaxed) + 1;
+  // fetch_add hands out each count exactly once, so only the evaluation that
+  // crosses the threshold schedules the re-plan.
+  if (count != promotion_threshold_) {
+    return;
+  }
+  // The task owns the shared block (not `this`), so the expression being
+  // destroyed with a re-plan still in flight only wastes the re-plan.
+  auto task = [shared = shared_]() {
+    Replanner replan;
+    {
+      absl::MutexLock lock(&shared->mutex);
+      replan = std::move(shared->replan);
+    }
+    absl::StatusOr<std::unique_ptr<CelExpression>> optimized =
+        std::move(replan)();
+    absl::MutexLock lock(&shared->mutex);
+    if (!optimized.ok()) {
+      shared->promotion_status = std::move(optimized).status();
+      return;
+    }
+    shared->current = std::move(optimized).value();
+    shared->promoted = true;
+  };
+  if (executor_ != nullptr) {
+    executor_(std::move(task));
+  } else {
+    std::move(task)();
+  }
+}
+
+}  // namespace google::api::expr::runtime
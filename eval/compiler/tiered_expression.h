@@ -0,0 +1,141 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_COMPILER_TIERED_EXPRESSION_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_COMPILER_TIERED_EXPRESSION_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "eval/public/base_activation.h"
+#include "eval/public/cel_expression.h"
+#include "eval/public/cel_value.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+
+// Options controlling tiered planning; see
+// CelExpressionBuilderFlatImpl::CreateTieredExpression.
+struct TieredExpressionOptions {
+  // Number of completed evaluations after which the optimized re-plan is
+  // triggered. Values <= 0 disable tiering (the expression is planned fully
+  // optimized up front).
+  int64_t promotion_threshold = 64;
+
+  // Executor the re-plan runs on. Must run each submitted task exactly once,
+  // possibly inline. When null, the re-plan runs inline on the evaluation
+  // that crosses the threshold.
+  std::function<void(absl::AnyInvocable<void()>)> executor;
+};
+
+// A CelExpression that starts out as a cheaply planned baseline program and
+// re-plans itself with the builder's full optimizer set once it has proven
+// hot, then atomically swaps the optimized program in under running callers.
+// This gives optimized hot programs without paying full planning cost for the
+// many programs that only run a handful of times.
+//
+// Evaluations pin the program they started with: a swap never changes a
+// program mid-evaluation, and evaluation state is bound to the program it was
+// initialized against. Promotion happens at most once; if the re-plan fails,
+// the baseline program continues to serve and the failure is available from
+// promotion_status().
+//
+// Thread-compatible to the same degree as the wrapped programs. When a
+// non-null executor is supplied, the re-plan may run concurrently with
+// evaluations; the planning callback (and anything it references, notably the
+// originating builder) must remain valid until the re-plan completes.
+class TieredCelExpression final : public CelExpression {
+ public:
+  // Produces the optimized replacement program. Invoked at most once, after
+  // the promotion threshold is crossed.
+  using Replanner =
+      absl::AnyInvocable<absl::StatusOr<std::unique_ptr<CelExpression>>()>;
+
+  TieredCelExpression(std::unique_ptr<CelExpression> baseline,
+                      Replanner replan, const TieredExpressionOptions& options);
+
+  // Move-only in principle, but held behind unique_ptr in practice; the
+  // shared block referenced by in-flight re-plans makes moves unsafe.
+  TieredCelExpression(const TieredCelExpression&) = delete;
+  TieredCelExpression& operator=(const TieredCelExpression&) = delete;
+
+  // Implement CelExpression.
+  std::unique_ptr<CelEvaluationState> InitializeState(
+      google::protobuf::Arena* arena) const override;
+
+  absl::StatusOr<CelValue> Evaluate(const BaseActivation& activation,
+                                    google::protobuf::Arena* arena) const override {
+    return Evaluate(activation, InitializeState(arena).get());
+  }
+
+  absl::StatusOr<CelValue> Evaluate(const BaseActivation& activation,
+                                    CelEvaluationState* state) const override;
+
+  absl::StatusOr<CelValue> Trace(
+      const BaseActivation& activation, google::protobuf::Arena* arena,
+      CelEvaluationListener callback) const override {
+    return Trace(activation, InitializeState(arena).get(),
+                 std::move(callback));
+  }
+
+  absl::StatusOr<CelValue> Trace(const BaseActivation& activation,
+                                 CelEvaluationState* state,
+                                 CelEvaluationListener callback) const override;
+
+  // True once the optimized program has been swapped in.
+  bool promoted() const;
+
+  // Status of the attempted promotion: OK both before promotion has been
+  // attempted and after it succeeded, otherwise the re-plan error.
+  absl::Status promotion_status() const;
+
+  // Number of completed evaluations so far.
+  int64_t evaluation_count() const {
+    return evaluation_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // State shared with in-flight re-plan tasks, so a task outliving this
+  // expression only writes into a block nobody reads.
+  struct Shared {
+    mutable absl::Mutex mutex;
+    std::shared_ptr<const CelExpression> current ABSL_GUARDED_BY(mutex);
+    Replanner replan ABSL_GUARDED_BY(mutex);
+    bool promoted ABSL_GUARDED_BY(mutex) = false;
+    absl::Status promotion_status ABSL_GUARDED_BY(mutex);
+  };
+
+  std::shared_ptr<const CelExpression> Snapshot() const;
+
+  // Called after each completed evaluation; triggers the re-plan exactly once
+  // when the threshold is crossed.
+  void CountEvaluation() const;
+
+  std::shared_ptr<Shared> shared_;
+  const int64_t promotion_threshold_;
+  const std::function<void(absl::AnyInvocable<void()>)> executor_;
+  mutable std::atomic<int64_t> evaluation_count_{0};
+};
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_COMPILER_TIERED_EXPRESSION_H_
@@ -0,0 +1,199 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "eval/compiler/tiered_expression.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/checked.pb.h"
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "eval/compiler/cel_expression_builder_flat_impl.h"
+#include "eval/compiler/constant_folding.h"
+#include "eval/public/activation.h"
+#include "eval/public/builtin_func_registrar.h"
+#include "eval/public/cel_expression.h"
+#include "eval/public/cel_value.h"
+#include "eval/public/testing/matchers.h"
+#include "extensions/protobuf/memory_manager.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/runtime_options.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+using ::google::api::expr::v1alpha1::CheckedExpr;
+using ::google::api::expr::parser::Parse;
+using testing::HasSubstr;
+using cel::internal::StatusIs;
+
+CheckedExpr ParseToChecked(absl::string_view expression) {
+  auto parsed = Parse(expression);
+  ABSL_CHECK_OK(parsed.status());
+  CheckedExpr checked_expr;
+  *checked_expr.mutable_expr() = parsed->expr();
+  *checked_expr.mutable_source_info() = parsed->source_info();
+  return checked_expr;
+}
+
+std::unique_ptr<CelExpressionBuilderFlatImpl> MakeBuilder() {
+  cel::RuntimeOptions options;
+  auto builder = std::make_unique<CelExpressionBuilderFlatImpl>(options);
+  ABSL_CHECK_OK(RegisterBuiltinFunctions(builder->GetRegistry()));
+  return builder;
+}
+
+TEST(TieredExpressionTest, BaselineEvaluates) {
+  auto builder = MakeBuilder();
+  CheckedExpr checked_expr = ParseToChecked("1 + 2 + 3");
+
+  TieredExpressionOptions options;
+  options.promotion_threshold = 100;
+  ASSERT_OK_AND_ASSIGN(
+      auto expression,
+      builder->CreateTieredExpression(&checked_expr, options));
+
+  auto* tiered = dynamic_cast<TieredCelExpression*>(expression.get());
+  ASSERT_NE(tiered, nullptr);
+  EXPECT_FALSE(tiered->promoted());
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  ASSERT_OK_AND_ASSIGN(CelValue result,
+                       expression->Evaluate(activation, &arena));
+  EXPECT_THAT(result, test::IsCelInt64(6));
+  EXPECT_EQ(tiered->evaluation_count(), 1);
+}
+
+TEST(TieredExpressionTest, PromotesAfterThreshold) {
+  google::protobuf::Arena arena;
+  auto builder = MakeBuilder();
+  // Register an optimizer so the optimized program differs from the baseline.
+  builder->flat_expr_builder().AddProgramOptimizer(
+      cel::runtime_internal::CreateConstantFoldingOptimizer(
+          cel::extensions::ProtoMemoryManagerRef(&arena)));
+  CheckedExpr checked_expr = ParseToChecked("1 + 2 + 3");
+
+  TieredExpressionOptions options;
+  options.promotion_threshold = 3;
+  ASSERT_OK_AND_ASSIGN(
+      auto expression,
+      builder->CreateTieredExpression(&checked_expr, options));
+  auto* tiered = dynamic_cast<TieredCelExpression*>(expression.get());
+  ASSERT_NE(tiered, nullptr);
+
+  Activation activation;
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_OK_AND_ASSIGN(CelValue result,
+                         expression->Evaluate(activation, &arena));
+    EXPECT_THAT(result, test::IsCelInt64(6));
+  }
+
+  EXPECT_TRUE(tiered->promoted());
+  EXPECT_OK(tiered->promotion_status());
+  EXPECT_EQ(tiered->evaluation_count(), 5);
+}
+
+TEST(TieredExpressionTest, FailedReplanKeepsBaseline) {
+  auto builder = MakeBuilder();
+  CheckedExpr checked_expr = ParseToChecked("2 * 21");
+
+  // Build directly so the re-plan can be forced to fail.
+  TieredExpressionOptions options;
+  options.promotion_threshold = 1;
+  ASSERT_OK_AND_ASSIGN(auto baseline,
+                       builder->CreateExpression(&checked_expr));
+  auto expression = std::make_unique<TieredCelExpression>(
+      std::move(baseline),
+      []() -> absl::StatusOr<std::unique_ptr<CelExpression>> {
+        return absl::InternalError("re-plan failed");
+      },
+      options);
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK_AND_ASSIGN(CelValue result,
+                         expression->Evaluate(activation, &arena));
+    EXPECT_THAT(result, test::IsCelInt64(42));
+  }
+
+  EXPECT_FALSE(expression->promoted());
+  EXPECT_THAT(expression->promotion_status(),
+              StatusIs(absl::StatusCode::kInternal, HasSubstr("re-plan")));
+}
+
+TEST(TieredExpressionTest, ExecutorRunsReplan) {
+  auto builder = MakeBuilder();
+  CheckedExpr checked_expr = ParseToChecked("'a' + 'b'");
+
+  std::vector<absl::AnyInvocable<void()>> tasks;
+  TieredExpressionOptions options;
+  options.promotion_threshold = 1;
+  options.executor = [&tasks](absl::AnyInvocable<void()> task) {
+    tasks.push_back(std::move(task));
+  };
+  ASSERT_OK_AND_ASSIGN(
+      auto expression,
+      builder->CreateTieredExpression(&checked_expr, options));
+  auto* tiered = dynamic_cast<TieredCelExpression*>(expression.get());
+  ASSERT_NE(tiered, nullptr);
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  ASSERT_OK_AND_ASSIGN(CelValue result,
+                       expression->Evaluate(activation, &arena));
+  EXPECT_THAT(result, test::IsCelString("ab"));
+
+  // The re-plan was submitted but has not run yet.
+  ASSERT_EQ(tasks.size(), 1);
+  EXPECT_FALSE(tiered->promoted());
+
+  std::move(tasks[0])();
+  EXPECT_TRUE(tiered->promoted());
+  ASSERT_OK_AND_ASSIGN(result, expression->Evaluate(activation, &arena));
+  EXPECT_THAT(result, test::IsCelString("ab"));
+}
+
+TEST(TieredExpressionTest, NonPositiveThresholdFallsBack) {
+  auto builder = MakeBuilder();
+  CheckedExpr checked_expr = ParseToChecked("1 < 2");
+
+  TieredExpressionOptions options;
+  options.promotion_threshold = 0;
+  ASSERT_OK_AND_ASSIGN(
+      auto expression,
+      builder->CreateTieredExpression(&checked_expr, options));
+  // Tiering disabled: the result is a plain fully planned expression.
+  EXPECT_EQ(dynamic_cast<TieredCelExpression*>(expression.get()), nullptr);
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  ASSERT_OK_AND_ASSIGN(CelValue result,
+                       expression->Evaluate(activation, &arena));
+  EXPECT_THAT(result, test::IsCelBool(true));
+}
+
+}  // namespace
+
+}  // namespace google::api::expr::runtime
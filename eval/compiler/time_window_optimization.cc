@@ -0,0 +1,153 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/time_window_optimization.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "base/ast_internal/ast_impl.h"
+#include "base/ast_internal/expr.h"
+#include "base/builtins.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/time_window_step.h"
+#include "internal/status_macros.h"
+#include "runtime/runtime_options.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::ast_internal::AstImpl;
+using ::cel::ast_internal::Expr;
+using ::cel::ast_internal::Reference;
+
+using ReferenceMap = absl::flat_hash_map<int64_t, Reference>;
+
+bool IsCallOverload(const Expr& expr, absl::string_view function,
+                    absl::string_view overload,
+                    const ReferenceMap& reference_map) {
+  if (!expr.has_call_expr()) {
+    return false;
+  }
+  const auto& call_expr = expr.call_expr();
+  if (call_expr.function() != function || call_expr.has_target() ||
+      call_expr.args().size() != 2) {
+    return false;
+  }
+  auto reference = reference_map.find(expr.id());
+  return reference != reference_map.end() &&
+         reference->second.overload_id().size() == 1 &&
+         reference->second.overload_id().front() == overload;
+}
+
+// Maps a comparison node to its fused operator when the checker resolved it
+// to the duration overload.
+absl::optional<TimeWindowOp> MatchComparison(
+    const Expr& expr, const ReferenceMap& reference_map) {
+  if (IsCallOverload(expr, cel::builtin::kLess, "less_duration",
+                     reference_map)) {
+    return TimeWindowOp::kLess;
+  }
+  if (IsCallOverload(expr, cel::builtin::kLessOrEqual, "less_equals_duration",
+                     reference_map)) {
+    return TimeWindowOp::kLessEqual;
+  }
+  if (IsCallOverload(expr, cel::builtin::kGreater, "greater_duration",
+                     reference_map)) {
+    return TimeWindowOp::kGreater;
+  }
+  if (IsCallOverload(expr, cel::builtin::kGreaterOrEqual,
+                     "greater_equals_duration", reference_map)) {
+    return TimeWindowOp::kGreaterEqual;
+  }
+  return absl::nullopt;
+}
+
+class TimeWindowOptimization : public ProgramOptimizer {
+ public:
+  explicit TimeWindowOptimization(const ReferenceMap& reference_map)
+      : reference_map_(reference_map) {}
+
+  absl::Status OnPreVisit(PlannerContext& context, const Expr& node) override {
+    return absl::OkStatus();
+  }
+
+  absl::Status OnPostVisit(PlannerContext& context, const Expr& node) override {
+    // With unknown processing the function steps also inspect the operands'
+    // attribute trails, which the fused step does not replicate.
+    if (context.options().unknown_processing !=
+        cel::UnknownProcessingOptions::kDisabled) {
+      return absl::OkStatus();
+    }
+
+    absl::optional<TimeWindowOp> op = MatchComparison(node, reference_map_);
+    if (!op.has_value()) {
+      return absl::OkStatus();
+    }
+    const Expr& subtraction = node.call_expr().args()[0];
+    if (!IsCallOverload(subtraction, cel::builtin::kSubtract,
+                        "subtract_timestamp_timestamp", reference_map_)) {
+      return absl::OkStatus();
+    }
+    const Expr& t1 = subtraction.call_expr().args()[0];
+    const Expr& t2 = subtraction.call_expr().args()[1];
+    const Expr& window = node.call_expr().args()[1];
+
+    ProgramBuilder::Subexpression* subexpression =
+        context.program_builder().GetSubexpression(&node);
+    if (subexpression == nullptr || subexpression->IsFlattened() ||
+        subexpression->IsRecursive()) {
+      // Already modified or planned recursively; leave the function steps.
+      return absl::OkStatus();
+    }
+
+    if (context.GetSubplan(t1).empty() || context.GetSubplan(t2).empty() ||
+        context.GetSubplan(window).empty()) {
+      // Already optimized by another extension, nothing to do.
+      return absl::OkStatus();
+    }
+
+    ExecutionPath new_plan;
+    for (const Expr* operand : {&t1, &t2, &window}) {
+      CEL_ASSIGN_OR_RETURN(ExecutionPath operand_plan,
+                           context.ExtractSubplan(*operand));
+      for (auto& step : operand_plan) {
+        new_plan.push_back(std::move(step));
+      }
+    }
+    CEL_ASSIGN_OR_RETURN(new_plan.emplace_back(),
+                         CreateTimeWindowStep(*op, node.id()));
+
+    return context.ReplaceSubplan(node, std::move(new_plan));
+  }
+
+ private:
+  const ReferenceMap& reference_map_;
+};
+
+}  // namespace
+
+ProgramOptimizerFactory CreateTimeWindowOptimization() {
+  return [](PlannerContext& context, const AstImpl& ast) {
+    return std::make_unique<TimeWindowOptimization>(ast.reference_map());
+  };
+}
+
+}  // namespace google::api::expr::runtime
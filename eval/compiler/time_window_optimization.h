@@ -0,0 +1,34 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_COMPILER_TIME_WINDOW_OPTIMIZATION_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_COMPILER_TIME_WINDOW_OPTIMIZATION_H_
+
+#include "eval/compiler/flat_expr_builder_extensions.h"
+
+namespace google::api::expr::runtime {
+
+// Create a new extension that fuses time window checks.
+//
+// Comparisons of the shape `(t1 - t2) op d`, where the checker proved `t1`
+// and `t2` to be timestamps and `d` a duration, are planned as one fused
+// step on the native time representations with a single range check,
+// replacing the checked subtraction and the separately dispatched
+// comparison. Only applies to checked expressions: the operators involved
+// are heavily overloaded, so parse-only expressions are left alone.
+ProgramOptimizerFactory CreateTimeWindowOptimization();
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_COMPILER_TIME_WINDOW_OPTIMIZATION_H_
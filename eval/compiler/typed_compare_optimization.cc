@@ -0,0 +1,223 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/typed_compare_optimization.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "base/ast_internal/ast_impl.h"
+#include "base/ast_internal/expr.h"
+#include "base/builtins.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/typed_compare_step.h"
+#include "internal/status_macros.h"
+#include "runtime/runtime_options.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::ast_internal::AstImpl;
+using ::cel::ast_internal::Expr;
+using ::cel::ast_internal::PrimitiveType;
+using ::cel::ast_internal::Type;
+
+struct TypedCompare {
+  TypedCompareOp op;
+  TypedCompareType type;
+};
+
+// Returns the single overload id the checker resolved for a two-argument
+// call to `function`, or an empty view.
+absl::string_view ResolvedOverload(const Expr& expr, const AstImpl& ast) {
+  const auto& reference_map = ast.reference_map();
+  auto reference = reference_map.find(expr.id());
+  if (reference == reference_map.end() ||
+      reference->second.overload_id().size() != 1) {
+    return absl::string_view();
+  }
+  return reference->second.overload_id().front();
+}
+
+absl::optional<TypedCompareType> PinnedPrimitiveType(const Type& type) {
+  if (!type.has_primitive()) {
+    return absl::nullopt;
+  }
+  switch (type.primitive()) {
+    case PrimitiveType::kBool:
+      return TypedCompareType::kBool;
+    case PrimitiveType::kInt64:
+      return TypedCompareType::kInt64;
+    case PrimitiveType::kUint64:
+      return TypedCompareType::kUint64;
+    case PrimitiveType::kDouble:
+      return TypedCompareType::kDouble;
+    default:
+      return absl::nullopt;
+  }
+}
+
+// Matches an ordering overload id of the shape `<prefix><type>`, e.g.
+// "less_equals_int64".
+absl::optional<TypedCompareType> MatchOrderingOverload(
+    absl::string_view overload, absl::string_view prefix) {
+  if (overload.size() <= prefix.size() ||
+      overload.substr(0, prefix.size()) != prefix) {
+    return absl::nullopt;
+  }
+  absl::string_view suffix = overload.substr(prefix.size());
+  if (suffix == "int64") {
+    return TypedCompareType::kInt64;
+  }
+  if (suffix == "uint64") {
+    return TypedCompareType::kUint64;
+  }
+  if (suffix == "double") {
+    return TypedCompareType::kDouble;
+  }
+  return absl::nullopt;
+}
+
+absl::optional<TypedCompare> MatchComparison(const Expr& expr,
+                                             const AstImpl& ast) {
+  if (!expr.has_call_expr()) {
+    return absl::nullopt;
+  }
+  const auto& call_expr = expr.call_expr();
+  if (call_expr.has_target() || call_expr.args().size() != 2) {
+    return absl::nullopt;
+  }
+  absl::string_view function = call_expr.function();
+  absl::string_view overload = ResolvedOverload(expr, ast);
+  if (overload.empty()) {
+    return absl::nullopt;
+  }
+
+  // The equality overload ids are not type specific, so equality is pinned
+  // by the deduced operand types instead.
+  if (function == cel::builtin::kEqual || function == cel::builtin::kInequal) {
+    bool equal = function == cel::builtin::kEqual;
+    if (overload != (equal ? "equals" : "not_equals")) {
+      return absl::nullopt;
+    }
+    absl::optional<TypedCompareType> lhs =
+        PinnedPrimitiveType(ast.GetType(call_expr.args()[0].id()));
+    absl::optional<TypedCompareType> rhs =
+        PinnedPrimitiveType(ast.GetType(call_expr.args()[1].id()));
+    if (!lhs.has_value() || !rhs.has_value() || *lhs != *rhs) {
+      return absl::nullopt;
+    }
+    return TypedCompare{
+        equal ? TypedCompareOp::kEqual : TypedCompareOp::kNotEqual, *lhs};
+  }
+
+  // The ordering overload ids pin the operand type directly.
+  struct Ordering {
+    absl::string_view function;
+    absl::string_view prefix;
+    TypedCompareOp op;
+  };
+  static constexpr Ordering kOrderings[] = {
+      {cel::builtin::kLess, "less_", TypedCompareOp::kLess},
+      {cel::builtin::kLessOrEqual, "less_equals_", TypedCompareOp::kLessEqual},
+      {cel::builtin::kGreater, "greater_", TypedCompareOp::kGreater},
+      {cel::builtin::kGreaterOrEqual, "greater_equals_",
+       TypedCompareOp::kGreaterEqual},
+  };
+  for (const Ordering& ordering : kOrderings) {
+    if (function != ordering.function) {
+      continue;
+    }
+    absl::optional<TypedCompareType> type =
+        MatchOrderingOverload(overload, ordering.prefix);
+    if (!type.has_value()) {
+      return absl::nullopt;
+    }
+    return TypedCompare{ordering.op, *type};
+  }
+  return absl::nullopt;
+}
+
+class TypedCompareOptimization : public ProgramOptimizer {
+ public:
+  explicit TypedCompareOptimization(const AstImpl& ast) : ast_(ast) {}
+
+  absl::Status OnPreVisit(PlannerContext& context, const Expr& node) override {
+    return absl::OkStatus();
+  }
+
+  absl::Status OnPostVisit(PlannerContext& context, const Expr& node) override {
+    // With unknown processing the function steps also inspect the operands'
+    // attribute trails, which the fused step does not replicate. The fused
+    // step's fallback for mistyped activations follows the heterogeneous
+    // comparison semantics, so homogeneous configurations are left alone.
+    if (context.options().unknown_processing !=
+            cel::UnknownProcessingOptions::kDisabled ||
+        !context.options().enable_heterogeneous_equality) {
+      return absl::OkStatus();
+    }
+
+    absl::optional<TypedCompare> compare = MatchComparison(node, ast_);
+    if (!compare.has_value()) {
+      return absl::OkStatus();
+    }
+    const Expr& lhs = node.call_expr().args()[0];
+    const Expr& rhs = node.call_expr().args()[1];
+
+    ProgramBuilder::Subexpression* subexpression =
+        context.program_builder().GetSubexpression(&node);
+    if (subexpression == nullptr || subexpression->IsFlattened() ||
+        subexpression->IsRecursive()) {
+      // Already modified or planned recursively; leave the function steps.
+      return absl::OkStatus();
+    }
+
+    if (context.GetSubplan(lhs).empty() || context.GetSubplan(rhs).empty()) {
+      // Already optimized by another extension, nothing to do.
+      return absl::OkStatus();
+    }
+
+    ExecutionPath new_plan;
+    for (const Expr* operand : {&lhs, &rhs}) {
+      CEL_ASSIGN_OR_RETURN(ExecutionPath operand_plan,
+                           context.ExtractSubplan(*operand));
+      for (auto& step : operand_plan) {
+        new_plan.push_back(std::move(step));
+      }
+    }
+    CEL_ASSIGN_OR_RETURN(
+        new_plan.emplace_back(),
+        CreateTypedCompareStep(compare->op, compare->type, node.id()));
+
+    return context.ReplaceSubplan(node, std::move(new_plan));
+  }
+
+ private:
+  const AstImpl& ast_;
+};
+
+}  // namespace
+
+ProgramOptimizerFactory CreateTypedCompareOptimization() {
+  return [](PlannerContext& context, const AstImpl& ast) {
+    return std::make_unique<TypedCompareOptimization>(ast);
+  };
+}
+
+}  // namespace google::api::expr::runtime
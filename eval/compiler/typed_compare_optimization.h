@@ -0,0 +1,36 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_COMPILER_TYPED_COMPARE_OPTIMIZATION_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_COMPILER_TYPED_COMPARE_OPTIMIZATION_H_
+
+#include "eval/compiler/flat_expr_builder_extensions.h"
+
+namespace google::api::expr::runtime {
+
+// Create a new extension that plans type-pinned comparison steps.
+//
+// When the checker proved both operands of `==`, `!=`, `<`, `<=`, `>` or
+// `>=` to be the same primitive type (bool, int, uint or double for
+// equality; int, uint or double for orderings), the call is planned as a
+// direct primitive comparison instead of a function dispatch, skipping
+// overload resolution and the heterogeneous numeric conversion. Only
+// applies to checked expressions and requires heterogeneous equality, whose
+// semantics the fused step reproduces if an activation binds a value of an
+// unexpected type.
+ProgramOptimizerFactory CreateTypedCompareOptimization();
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_COMPILER_TYPED_COMPARE_OPTIMIZATION_H_
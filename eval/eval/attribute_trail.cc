@@ -2,27 +2,57 @@
 
 #include <algorithm>
 #include <iterator>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/base/call_once.h"
 #include "base/attribute.h"
 
 namespace google::api::expr::runtime {
 
+AttributeTrail::Node::Node(cel::Attribute attribute)
+    : attribute(std::move(attribute)) {}
+
+AttributeTrail::Node::Node(std::shared_ptr<const Node> parent,
+                           cel::AttributeQualifier qualifier)
+    : parent(std::move(parent)), qualifier(std::move(qualifier)) {}
+
+const cel::Attribute& AttributeTrail::Node::Materialize() const {
+  absl::call_once(once, [this]() {
+    if (attribute.has_value()) {
+      // Root segment, or constructed directly from a full attribute.
+      return;
+    }
+    // Walk back to the root, collecting the qualifiers appended after it.
+    std::vector<const cel::AttributeQualifier*> segments;
+    const Node* node = this;
+    while (node->qualifier.has_value()) {
+      segments.push_back(&*node->qualifier);
+      node = node->parent.get();
+    }
+    const cel::Attribute& root = *node->attribute;
+
+    std::vector<cel::AttributeQualifier> qualifiers;
+    qualifiers.reserve(root.qualifier_path().size() + segments.size());
+    std::copy(root.qualifier_path().begin(), root.qualifier_path().end(),
+              std::back_inserter(qualifiers));
+    for (auto it = segments.rbegin(); it != segments.rend(); ++it) {
+      qualifiers.push_back(**it);
+    }
+    attribute.emplace(std::string(root.variable_name()),
+                      std::move(qualifiers));
+  });
+  return *attribute;
+}
+
 // Creates AttributeTrail with attribute path incremented by "qualifier".
 AttributeTrail AttributeTrail::Step(cel::AttributeQualifier qualifier) const {
   // Cannot continue void trail
   if (empty()) return AttributeTrail();
 
-  std::vector<cel::AttributeQualifier> qualifiers;
-  qualifiers.reserve(attribute_->qualifier_path().size() + 1);
-  std::copy_n(attribute_->qualifier_path().begin(),
-              attribute_->qualifier_path().size(),
-              std::back_inserter(qualifiers));
-  qualifiers.push_back(std::move(qualifier));
-  return AttributeTrail(cel::Attribute(std::string(attribute_->variable_name()),
-                                       std::move(qualifiers)));
+  return AttributeTrail(std::make_shared<Node>(node_, std::move(qualifier)));
 }
 
 }  // namespace google::api::expr::runtime
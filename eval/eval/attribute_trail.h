@@ -1,11 +1,12 @@
 #ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_ATTRIBUTE_TRAIL_H_
 #define THIRD_PARTY_CEL_CPP_EVAL_EVAL_ATTRIBUTE_TRAIL_H_
 
+#include <memory>
 #include <string>
 #include <utility>
 
+#include "absl/base/call_once.h"
 #include "absl/types/optional.h"
-#include "absl/utility/utility.h"
 #include "base/attribute.h"
 
 namespace google::api::expr::runtime {
@@ -13,21 +14,26 @@ namespace google::api::expr::runtime {
 // AttributeTrail reflects current attribute path.
 // It is functionally similar to cel::Attribute, yet intended to have better
 // complexity on attribute path increment operations.
-// TODO Current AttributeTrail implementation is equivalent to
-// cel::Attribute - improve it.
+//
+// Trails share structure: `Step` appends a single segment referencing the
+// existing trail instead of copying the whole qualifier path, so pushes and
+// copies of trails are constant time regardless of path depth. The full
+// cel::Attribute is materialized once on first access and cached.
+//
 // Intended to be used in conjunction with cel::Value, describing the attribute
 // value originated from.
 // Empty AttributeTrail denotes object with attribute path not defined
 // or supported.
 class AttributeTrail {
  public:
-  AttributeTrail() : attribute_(absl::nullopt) {}
+  AttributeTrail() = default;
 
   explicit AttributeTrail(std::string variable_name)
-      : attribute_(absl::in_place, std::move(variable_name)) {}
+      : node_(std::make_shared<Node>(
+            cel::Attribute(std::move(variable_name)))) {}
 
   explicit AttributeTrail(cel::Attribute attribute)
-      : attribute_(std::move(attribute)) {}
+      : node_(std::make_shared<Node>(std::move(attribute))) {}
 
   AttributeTrail(const AttributeTrail&) = default;
   AttributeTrail& operator=(const AttributeTrail&) = default;
@@ -43,12 +49,30 @@ class AttributeTrail {
   }
 
   // Returns CelAttribute that corresponds to content of AttributeTrail.
-  const cel::Attribute& attribute() const { return attribute_.value(); }
+  // Must not be called on an empty trail.
+  const cel::Attribute& attribute() const { return node_->Materialize(); }
 
-  bool empty() const { return !attribute_.has_value(); }
+  bool empty() const { return node_ == nullptr; }
 
  private:
-  absl::optional<cel::Attribute> attribute_;
+  // One segment of a trail. Roots hold a fully formed attribute; stepped
+  // segments hold the appended qualifier and a link to their parent.
+  struct Node {
+    explicit Node(cel::Attribute attribute);
+    Node(std::shared_ptr<const Node> parent, cel::AttributeQualifier qualifier);
+
+    const cel::Attribute& Materialize() const;
+
+    const std::shared_ptr<const Node> parent;
+    const absl::optional<cel::AttributeQualifier> qualifier;
+    mutable absl::once_flag once;
+    mutable absl::optional<cel::Attribute> attribute;
+  };
+
+  explicit AttributeTrail(std::shared_ptr<const Node> node)
+      : node_(std::move(node)) {}
+
+  std::shared_ptr<const Node> node_;
 };
 
 }  // namespace google::api::expr::runtime
@@ -28,4 +28,42 @@ TEST(AttributeTrailTest, AttributeTrailStep) {
             CelAttribute("ident", {CreateCelAttributeQualifier(step_value)}));
 }
 
+TEST(AttributeTrailTest, AttributeTrailStepChain) {
+  std::string step1 = "step1";
+  std::string step2 = "step2";
+  std::string step3 = "step3";
+
+  AttributeTrail prefix = AttributeTrail("ident").Step(&step1);
+  AttributeTrail trail = prefix.Step(&step2).Step(&step3);
+
+  // Extending a trail must not affect copies of its prefixes.
+  ASSERT_EQ(prefix.attribute(),
+            CelAttribute("ident", {CreateCelAttributeQualifier(
+                                      CelValue::CreateString(&step1))}));
+  ASSERT_EQ(trail.attribute(),
+            CelAttribute("ident",
+                         {CreateCelAttributeQualifier(
+                              CelValue::CreateString(&step1)),
+                          CreateCelAttributeQualifier(
+                              CelValue::CreateString(&step2)),
+                          CreateCelAttributeQualifier(
+                              CelValue::CreateString(&step3))}));
+  // Repeated access returns the cached materialization.
+  ASSERT_EQ(&trail.attribute(), &trail.attribute());
+}
+
+TEST(AttributeTrailTest, AttributeTrailStepFromFullAttribute) {
+  std::string step = "step";
+  CelValue step_value = CelValue::CreateString(&step);
+
+  AttributeTrail trail =
+      AttributeTrail(CelAttribute("ident", {CreateCelAttributeQualifier(
+                                               step_value)}))
+          .Step(&step);
+
+  ASSERT_EQ(trail.attribute(),
+            CelAttribute("ident", {CreateCelAttributeQualifier(step_value),
+                                   CreateCelAttributeQualifier(step_value)}));
+}
+
 }  // namespace google::api::expr::runtime
@@ -12,7 +12,6 @@
 #include "base/function_descriptor.h"
 #include "base/function_result.h"
 #include "base/function_result_set.h"
-#include "base/internal/unknown_set.h"
 #include "common/value.h"
 #include "eval/eval/attribute_trail.h"
 #include "eval/internal/errors.h"
@@ -28,20 +27,41 @@ using ::cel::FunctionResultSet;
 using ::cel::InstanceOf;
 using ::cel::UnknownValue;
 using ::cel::Value;
-using ::cel::base_internal::UnknownSet;
 
 using Accumulator = AttributeUtility::Accumulator;
 
+namespace {
+
+bool MatchesUnknownPattern(const cel::AttributePattern& pattern,
+                           const cel::Attribute& attribute, bool use_partial) {
+  auto current_match = pattern.IsMatch(attribute);
+  return current_match == cel::AttributePattern::MatchType::FULL ||
+         (use_partial &&
+          current_match == cel::AttributePattern::MatchType::PARTIAL);
+}
+
+}  // namespace
+
 bool AttributeUtility::CheckForMissingAttribute(
     const AttributeTrail& trail) const {
   if (trail.empty()) {
     return false;
   }
 
+  // (b/161297249) Preserving existing behavior for now, will add a streamz
+  // for partial match, follow up with tightening up which fields are exposed
+  // to the condition (w/ ajay and jim)
+  if (missing_index_ != nullptr) {
+    for (const auto* pattern :
+         missing_index_->PatternsForRoot(trail.attribute().variable_name())) {
+      if (pattern->IsMatch(trail.attribute()) ==
+          cel::AttributePattern::MatchType::FULL) {
+        return true;
+      }
+    }
+    return false;
+  }
   for (const auto& pattern : missing_attribute_patterns_) {
-    // (b/161297249) Preserving existing behavior for now, will add a streamz
-    // for partial match, follow up with tightening up which fields are exposed
-    // to the condition (w/ ajay and jim)
     if (pattern.IsMatch(trail.attribute()) ==
         cel::AttributePattern::MatchType::FULL) {
       return true;
@@ -56,11 +76,17 @@ bool AttributeUtility::CheckForUnknown(const AttributeTrail& trail,
   if (trail.empty()) {
     return false;
   }
+  if (unknown_index_ != nullptr) {
+    for (const auto* pattern :
+         unknown_index_->PatternsForRoot(trail.attribute().variable_name())) {
+      if (MatchesUnknownPattern(*pattern, trail.attribute(), use_partial)) {
+        return true;
+      }
+    }
+    return false;
+  }
   for (const auto& pattern : unknown_patterns_) {
-    auto current_match = pattern.IsMatch(trail.attribute());
-    if (current_match == cel::AttributePattern::MatchType::FULL ||
-        (use_partial &&
-         current_match == cel::AttributePattern::MatchType::PARTIAL)) {
+    if (MatchesUnknownPattern(pattern, trail.attribute(), use_partial)) {
       return true;
     }
   }
@@ -75,26 +101,39 @@ absl::optional<UnknownValue> AttributeUtility::MergeUnknowns(
     absl::Span<const cel::Value> args) const {
   // Empty unknown value may be used as a sentinel in some tests so need to
   // distinguish unset (nullopt) and empty(engaged empty value).
-  absl::optional<UnknownSet> result_set;
+  //
+  // A single unknown argument is forwarded as-is (the handle already shares
+  // its sets), so the common single-unknown merge is constant time. Multiple
+  // unknowns are unioned once into a fresh set, rather than rebuilding the
+  // intermediate result per argument.
+  absl::optional<UnknownValue> first;
+  absl::optional<AttributeSet> attributes;
+  absl::optional<FunctionResultSet> function_results;
 
   for (const auto& value : args) {
     if (!value->Is<cel::UnknownValue>()) continue;
-    if (!result_set.has_value()) {
-      result_set.emplace();
+    UnknownValue current = value.As<cel::UnknownValue>();
+    if (!first.has_value()) {
+      first = std::move(current);
+      continue;
     }
-    const auto& current_set = value.As<cel::UnknownValue>();
-
-    cel::base_internal::UnknownSetAccess::Add(
-        *result_set, UnknownSet(current_set.attribute_set(),
-                                current_set.function_result_set()));
+    if (!attributes.has_value()) {
+      attributes.emplace(first->attribute_set());
+      function_results.emplace(first->function_result_set());
+    }
+    attributes->Add(current.attribute_set());
+    function_results->Add(current.function_result_set());
   }
 
-  if (!result_set.has_value()) {
+  if (!first.has_value()) {
     return absl::nullopt;
   }
+  if (!attributes.has_value()) {
+    return first;
+  }
 
-  return value_factory_.CreateUnknownValue(
-      result_set->unknown_attributes(), result_set->unknown_function_results());
+  return value_factory_.CreateUnknownValue(std::move(*attributes),
+                                           std::move(*function_results));
 }
 
 UnknownValue AttributeUtility::MergeUnknownValues(
@@ -139,31 +178,26 @@ AttributeSet AttributeUtility::CheckForUnknowns(
 absl::optional<UnknownValue> AttributeUtility::IdentifyAndMergeUnknowns(
     absl::Span<const cel::Value> args, absl::Span<const AttributeTrail> attrs,
     bool use_partial) const {
-  absl::optional<UnknownSet> result_set;
-
   // Identify new unknowns by attribute patterns.
   cel::AttributeSet attr_set = CheckForUnknowns(attrs, use_partial);
-  if (!attr_set.empty()) {
-    result_set.emplace(std::move(attr_set));
-  }
 
   // merge down existing unknown sets
   absl::optional<UnknownValue> arg_unknowns = MergeUnknowns(args);
 
-  if (!result_set.has_value()) {
+  if (attr_set.empty()) {
     // No new unknowns so no need to check for presence of existing unknowns --
     // just forward.
     return arg_unknowns;
   }
 
+  FunctionResultSet function_results;
   if (arg_unknowns.has_value()) {
-    cel::base_internal::UnknownSetAccess::Add(
-        *result_set, UnknownSet((*arg_unknowns).attribute_set(),
-                                (*arg_unknowns).function_result_set()));
+    attr_set.Add(arg_unknowns->attribute_set());
+    function_results.Add(arg_unknowns->function_result_set());
   }
 
-  return value_factory_.CreateUnknownValue(
-      result_set->unknown_attributes(), result_set->unknown_function_results());
+  return value_factory_.CreateUnknownValue(std::move(attr_set),
+                                           std::move(function_results));
 }
 
 UnknownValue AttributeUtility::CreateUnknownSet(cel::Attribute attr) const {
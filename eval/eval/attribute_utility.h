@@ -1,9 +1,14 @@
 #ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_UNKNOWNS_UTILITY_H_
 #define THIRD_PARTY_CEL_CPP_EVAL_EVAL_UNKNOWNS_UTILITY_H_
 
+#include <cstddef>
+
+#include "absl/base/nullability.h"
 #include "absl/status/statusor.h"
+#include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "base/attribute.h"
+#include "base/attribute_pattern_index.h"
 #include "base/attribute_set.h"
 #include "base/function_descriptor.h"
 #include "base/function_result_set.h"
@@ -57,9 +62,40 @@ class AttributeUtility {
       absl::Span<const cel::AttributePattern> unknown_patterns,
       absl::Span<const cel::AttributePattern> missing_attribute_patterns,
       cel::ValueManager& value_factory)
+      : AttributeUtility(unknown_patterns, missing_attribute_patterns,
+                         /*unknown_index=*/nullptr, /*missing_index=*/nullptr,
+                         value_factory) {}
+
+  // As above, with optional prebuilt pattern indexes shared by the caller
+  // (e.g. built once by the activation when its patterns were bound).
+  AttributeUtility(
+      absl::Span<const cel::AttributePattern> unknown_patterns,
+      absl::Span<const cel::AttributePattern> missing_attribute_patterns,
+      absl::Nullable<const cel::AttributePatternIndex*> unknown_index,
+      absl::Nullable<const cel::AttributePatternIndex*> missing_index,
+      cel::ValueManager& value_factory)
       : unknown_patterns_(unknown_patterns),
         missing_attribute_patterns_(missing_attribute_patterns),
-        value_factory_(value_factory) {}
+        unknown_index_(unknown_index),
+        missing_index_(missing_index),
+        value_factory_(value_factory) {
+    // Without a shared index, large pattern sets are bucketed by root
+    // variable up front so each attribute-tracked access only scans the
+    // patterns that can possibly match; small sets are cheaper to scan
+    // directly.
+    if (unknown_index_ == nullptr &&
+        unknown_patterns_.size() >
+            cel::AttributePatternIndex::kDirectScanThreshold) {
+      owned_unknown_index_.emplace(unknown_patterns_);
+      unknown_index_ = &*owned_unknown_index_;
+    }
+    if (missing_index_ == nullptr &&
+        missing_attribute_patterns_.size() >
+            cel::AttributePatternIndex::kDirectScanThreshold) {
+      owned_missing_index_.emplace(missing_attribute_patterns_);
+      missing_index_ = &*owned_missing_index_;
+    }
+  }
 
   AttributeUtility(const AttributeUtility&) = delete;
   AttributeUtility& operator=(const AttributeUtility&) = delete;
@@ -134,6 +170,12 @@ class AttributeUtility {
 
   absl::Span<const cel::AttributePattern> unknown_patterns_;
   absl::Span<const cel::AttributePattern> missing_attribute_patterns_;
+  // Indexes built here when no shared one was supplied; the *_index_
+  // pointers are the single lookup path either way.
+  absl::optional<cel::AttributePatternIndex> owned_unknown_index_;
+  absl::optional<cel::AttributePatternIndex> owned_missing_index_;
+  absl::Nullable<const cel::AttributePatternIndex*> unknown_index_ = nullptr;
+  absl::Nullable<const cel::AttributePatternIndex*> missing_index_ = nullptr;
   cel::ValueManager& value_factory_;
 };
 
@@ -2,6 +2,7 @@
 
 #include <vector>
 
+#include "absl/strings/str_cat.h"
 #include "base/attribute_set.h"
 #include "base/type_provider.h"
 #include "common/type_factory.h"
@@ -75,6 +76,35 @@ TEST_F(AttributeUtilityTest, UnknownsUtilityCheckUnknowns) {
   }
 }
 
+TEST_F(AttributeUtilityTest, UnknownsUtilityCheckUnknownsIndexed) {
+  // More patterns than the direct-scan threshold, so matching goes through
+  // the per-variable index.
+  std::vector<CelAttributePattern> unknown_patterns;
+  for (int i = 0; i < 8; ++i) {
+    unknown_patterns.push_back(
+        CelAttributePattern(absl::StrCat("unknown", i),
+                            {CreateCelAttributeQualifierPattern(
+                                CelValue::CreateInt64(i))}));
+  }
+
+  std::vector<CelAttributePattern> missing_attribute_patterns;
+
+  AttributeUtility utility(unknown_patterns, missing_attribute_patterns,
+                           value_factory_);
+
+  AttributeTrail trail("unknown3");
+  ASSERT_FALSE(utility.CheckForUnknown(trail, false));
+  ASSERT_TRUE(utility.CheckForUnknown(trail, true));
+  ASSERT_TRUE(utility.CheckForUnknown(
+      trail.Step(CreateCelAttributeQualifier(CelValue::CreateInt64(3))),
+      false));
+  ASSERT_FALSE(utility.CheckForUnknown(
+      trail.Step(CreateCelAttributeQualifier(CelValue::CreateInt64(4))),
+      false));
+
+  ASSERT_FALSE(utility.CheckForUnknown(AttributeTrail("other"), true));
+}
+
 TEST_F(AttributeUtilityTest, UnknownsUtilityMergeUnknownsFromValues) {
   std::vector<CelAttributePattern> unknown_patterns;
 
@@ -105,6 +135,38 @@ TEST_F(AttributeUtilityTest, UnknownsUtilityMergeUnknownsFromValues) {
                   Eq(), std::vector<CelAttribute>{attribute0, attribute1}));
 }
 
+TEST_F(AttributeUtilityTest, UnknownsUtilityMergeSingleUnknownForwarded) {
+  std::vector<CelAttributePattern> unknown_patterns;
+  std::vector<CelAttributePattern> missing_attribute_patterns;
+
+  CelAttribute attribute0("unknown0", {});
+
+  AttributeUtility utility(unknown_patterns, missing_attribute_patterns,
+                           value_factory_);
+
+  UnknownValue unknown_set0 =
+      value_factory_.CreateUnknownValue(AttributeSet({attribute0}));
+
+  // A single unknown among the arguments is forwarded without rebuilding.
+  std::vector<cel::Value> values = {
+      value_factory_.CreateBoolValue(true),
+      unknown_set0,
+      value_factory_.CreateIntValue(1),
+  };
+
+  absl::optional<UnknownValue> unknown_set = utility.MergeUnknowns(values);
+  ASSERT_TRUE(unknown_set.has_value());
+  EXPECT_THAT((*unknown_set).attribute_set(),
+              UnorderedPointwise(Eq(), std::vector<CelAttribute>{attribute0}));
+
+  // An engaged but empty unknown is preserved as engaged (sentinel behavior).
+  UnknownValue empty_unknown = value_factory_.CreateUnknownValue();
+  std::vector<cel::Value> sentinel_values = {empty_unknown};
+  absl::optional<UnknownValue> sentinel = utility.MergeUnknowns(sentinel_values);
+  ASSERT_TRUE(sentinel.has_value());
+  EXPECT_TRUE(sentinel->attribute_set().empty());
+}
+
 TEST_F(AttributeUtilityTest, UnknownsUtilityCheckForUnknownsFromAttributes) {
   std::vector<CelAttributePattern> unknown_patterns = {
       CelAttributePattern("unknown0",
@@ -171,4 +233,17 @@ TEST_F(AttributeUtilityTest, CreateUnknownSet) {
   EXPECT_EQ(elem, "destination.ip");
 }
 
+TEST_F(AttributeUtilityTest, EmptyAccumulatorBuildsEmptyUnknown) {
+  std::vector<CelAttributePattern> empty_patterns;
+  AttributeUtility utility(empty_patterns, empty_patterns, value_factory_);
+
+  // An empty unknown is still an engaged UnknownValue (some callers use it as
+  // a sentinel); it shares the empty-set singletons instead of allocating.
+  auto accumulator = utility.CreateAccumulator();
+  ASSERT_TRUE(accumulator.IsEmpty());
+  UnknownValue unknown = std::move(accumulator).Build();
+  EXPECT_THAT(unknown.attribute_set(), SizeIs(0));
+  EXPECT_THAT(unknown.function_result_set(), SizeIs(0));
+}
+
 }  // namespace google::api::expr::runtime
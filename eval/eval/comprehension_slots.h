@@ -16,6 +16,7 @@
 #define THIRD_PARTY_CEL_CPP_EVAL_EVAL_COMPREHENSION_SLOTS_H_
 
 #include <cstddef>
+#include <deque>
 #include <utility>
 #include <vector>
 
@@ -33,6 +34,17 @@ namespace google::api::expr::runtime {
 // This is used instead of looking up the variable identifier by name in a
 // runtime stack.
 //
+// Slot storage can also be stacked: PushFrame carves a fresh range of slots
+// out of the same buffer and makes indices relative to it, so nested
+// evaluations on one thread (a custom function calling back into CEL) reuse
+// a single high-water allocation instead of a slot vector per nesting
+// level. Frames are strictly LIFO.
+//
+// Slot addresses are stable: growing the buffer for a nested frame never
+// moves existing slots, so steps may cache a Slot* across subexpression
+// evaluation (e.g. the comprehension loop body) even when that evaluation
+// re-enters CEL and pushes frames on the shared per-thread instance.
+//
 // Callers must handle range checking.
 class ComprehensionSlots {
  public:
@@ -48,6 +60,14 @@ class ComprehensionSlots {
     return *instance;
   }
 
+  // Shared per-thread instance backing frame-stacked slot storage (see
+  // PushFrame). Callers must pair every PushFrame with a PopFrame before
+  // returning control to the enclosing evaluation.
+  static ComprehensionSlots& GetThreadLocalInstance() {
+    static thread_local ComprehensionSlots instance(0);
+    return instance;
+  }
+
   explicit ComprehensionSlots(size_t size) : size_(size), slots_(size) {}
 
   // Move only
@@ -59,25 +79,51 @@ class ComprehensionSlots {
   // Return ptr to slot at index.
   // If not set, returns nullptr.
   Slot* Get(size_t index) {
-    ABSL_DCHECK_LT(index, slots_.size());
-    auto& slot = slots_[index];
+    ABSL_DCHECK_LT(index, size_);
+    auto& slot = slots_[base_ + index];
     if (!slot.has_value()) return nullptr;
     return &slot.value();
   }
 
-  void Reset() {
-    slots_.clear();
-    slots_.resize(size_);
+  void Reset() { ClearFrame(); }
+
+  // Rebind the current frame to a new slot count, retaining allocated
+  // storage where possible.
+  void Resize(size_t size) {
+    size_ = size;
+    EnsureFrameStorage();
+    ClearFrame();
+  }
+
+  // Pushes a frame of `count` slots on top of the current ones. Slot indices
+  // are relative to the innermost frame; storage is retained at its high
+  // water mark across frames.
+  void PushFrame(size_t count) {
+    frames_.push_back(FrameMark{base_, size_});
+    base_ += size_;
+    size_ = count;
+    EnsureFrameStorage();
+    ClearFrame();
+  }
+
+  // Pops the innermost frame, releasing its values and exposing the
+  // enclosing frame again.
+  void PopFrame() {
+    ABSL_DCHECK(!frames_.empty());
+    ClearFrame();
+    base_ = frames_.back().base;
+    size_ = frames_.back().size;
+    frames_.pop_back();
   }
 
   void ClearSlot(size_t index) {
-    ABSL_DCHECK_LT(index, slots_.size());
-    slots_[index] = absl::nullopt;
+    ABSL_DCHECK_LT(index, size_);
+    slots_[base_ + index] = absl::nullopt;
   }
 
   void Set(size_t index) {
-    ABSL_DCHECK_LT(index, slots_.size());
-    slots_[index].emplace();
+    ABSL_DCHECK_LT(index, size_);
+    slots_[base_ + index].emplace();
   }
 
   void Set(size_t index, cel::Value value) {
@@ -85,15 +131,38 @@ class ComprehensionSlots {
   }
 
   void Set(size_t index, cel::Value value, AttributeTrail attribute) {
-    ABSL_DCHECK_LT(index, slots_.size());
-    slots_[index] = Slot{std::move(value), std::move(attribute)};
+    ABSL_DCHECK_LT(index, size_);
+    slots_[base_ + index] = Slot{std::move(value), std::move(attribute)};
   }
 
-  size_t size() const { return slots_.size(); }
+  // Slot count of the current frame.
+  size_t size() const { return size_; }
 
  private:
+  struct FrameMark {
+    size_t base;
+    size_t size;
+  };
+
+  void EnsureFrameStorage() {
+    if (slots_.size() < base_ + size_) {
+      slots_.resize(base_ + size_);
+    }
+  }
+
+  void ClearFrame() {
+    for (size_t i = base_; i < base_ + size_; ++i) {
+      slots_[i] = absl::nullopt;
+    }
+  }
+
+  size_t base_ = 0;
   size_t size_;
-  std::vector<absl::optional<Slot>> slots_;
+  // Deque rather than vector: EnsureFrameStorage grows the buffer while
+  // enclosing frames may hold Slot* into it, and deque growth at the end
+  // leaves existing elements in place.
+  std::deque<absl::optional<Slot>> slots_;
+  std::vector<FrameMark> frames_;
 };
 
 }  // namespace google::api::expr::runtime
@@ -86,4 +86,94 @@ TEST(ComprehensionSlots, Basic) {
   EXPECT_TRUE(slot3 == nullptr);
 }
 
+TEST(ComprehensionSlots, FramesIndexRelativeToInnermost) {
+  cel::common_internal::LegacyValueManager factory(
+      MemoryManagerRef::ReferenceCounting(), TypeProvider::Builtin());
+
+  ComprehensionSlots slots(2);
+  slots.Set(0, factory.CreateUncheckedStringValue("outer"));
+
+  slots.PushFrame(3);
+  EXPECT_EQ(slots.size(), 3);
+  // Fresh frame: index 0 no longer refers to the outer slot.
+  EXPECT_EQ(slots.Get(0), nullptr);
+
+  slots.Set(0, factory.CreateUncheckedStringValue("inner"));
+  auto* inner0 = slots.Get(0);
+  ASSERT_TRUE(inner0 != nullptr);
+  EXPECT_THAT(inner0->value, Truly([](const Value& v) {
+                return v->Is<StringValue>() &&
+                       v->As<StringValue>().ToString() == "inner";
+              }));
+
+  slots.PopFrame();
+  EXPECT_EQ(slots.size(), 2);
+  auto* outer0 = slots.Get(0);
+  ASSERT_TRUE(outer0 != nullptr);
+  EXPECT_THAT(outer0->value, Truly([](const Value& v) {
+                return v->Is<StringValue>() &&
+                       v->As<StringValue>().ToString() == "outer";
+              }));
+}
+
+TEST(ComprehensionSlots, FrameResetIsFrameScoped) {
+  cel::common_internal::LegacyValueManager factory(
+      MemoryManagerRef::ReferenceCounting(), TypeProvider::Builtin());
+
+  ComprehensionSlots slots(1);
+  slots.Set(0, factory.CreateUncheckedStringValue("outer"));
+
+  slots.PushFrame(2);
+  slots.Set(1, factory.CreateUncheckedStringValue("inner"));
+  slots.Reset();
+  EXPECT_EQ(slots.Get(1), nullptr);
+  slots.PopFrame();
+
+  // Resetting the inner frame must not disturb the enclosing one.
+  EXPECT_TRUE(slots.Get(0) != nullptr);
+}
+
+TEST(ComprehensionSlots, SlotPointersStableAcrossFrameGrowth) {
+  cel::common_internal::LegacyValueManager factory(
+      MemoryManagerRef::ReferenceCounting(), TypeProvider::Builtin());
+
+  ComprehensionSlots slots(2);
+  slots.Set(0, factory.CreateUncheckedStringValue("outer"));
+  ComprehensionSlots::Slot* outer0 = slots.Get(0);
+  ASSERT_TRUE(outer0 != nullptr);
+
+  // A nested evaluation growing the buffer well past any initial capacity
+  // must not move the enclosing frame's slots: comprehension steps cache
+  // Slot* across the loop body, which may re-enter CEL and push frames.
+  slots.PushFrame(1024);
+  EXPECT_THAT(outer0->value, Truly([](const Value& v) {
+                return v->Is<StringValue>() &&
+                       v->As<StringValue>().ToString() == "outer";
+              }));
+  slots.PopFrame();
+
+  EXPECT_EQ(slots.Get(0), outer0);
+  EXPECT_THAT(outer0->value, Truly([](const Value& v) {
+                return v->Is<StringValue>() &&
+                       v->As<StringValue>().ToString() == "outer";
+              }));
+}
+
+TEST(ComprehensionSlots, NestedFramesReuseStorage) {
+  ComprehensionSlots slots(0);
+
+  slots.PushFrame(2);
+  slots.PushFrame(4);
+  EXPECT_EQ(slots.size(), 4);
+  slots.PopFrame();
+  slots.PopFrame();
+
+  // Storage is retained at its high-water mark; a repeat push of the same
+  // shape finds cleared slots.
+  slots.PushFrame(2);
+  EXPECT_EQ(slots.Get(0), nullptr);
+  EXPECT_EQ(slots.Get(1), nullptr);
+  slots.PopFrame();
+}
+
 }  // namespace google::api::expr::runtime
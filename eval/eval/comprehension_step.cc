@@ -1,5 +1,6 @@
 #include "eval/eval/comprehension_step.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -15,13 +16,16 @@
 #include "common/casting.h"
 #include "common/value.h"
 #include "common/value_kind.h"
+#include "common/native_type.h"
 #include "eval/eval/attribute_trail.h"
+#include "eval/eval/compiler_constant_step.h"
 #include "eval/eval/comprehension_slots.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 #include "eval/eval/expression_step_base.h"
 #include "eval/internal/errors.h"
 #include "eval/public/cel_attribute.h"
+#include "internal/casts.h"
 #include "internal/status_macros.h"
 #include "runtime/internal/mutable_list_impl.h"
 
@@ -39,6 +43,10 @@ using ::cel::Value;
 using ::cel::runtime_internal::CreateNoMatchingOverloadError;
 using ::cel::runtime_internal::MutableListValue;
 
+// Number of iteration-range elements ComprehensionNextStep buffers per
+// ListValue::GetChunk call (see ExecutionFrame::IterationChunk).
+constexpr size_t kIterationChunkSize = 64;
+
 class ComprehensionFinish : public ExpressionStepBase {
  public:
   ComprehensionFinish(size_t accu_slot, int64_t expr_id);
@@ -60,7 +68,9 @@ absl::Status ComprehensionFinish::Evaluate(ExecutionFrame* frame) const {
   if (!frame->value_stack().HasEnough(3)) {
     return absl::Status(absl::StatusCode::kInternal, "Value stack underflow");
   }
-  Value result = frame->value_stack().Peek();
+  // Move rather than copy: the result is popped immediately below, so a copy
+  // would only add a reference count increment/decrement pair.
+  Value result = std::move(frame->value_stack().Peek());
   frame->value_stack().Pop(3);
   if (frame->enable_comprehension_list_append() &&
       MutableListValue::Is(result)) {
@@ -134,6 +144,23 @@ absl::Status ComprehensionInitStep::Evaluate(ExecutionFrame* frame) const {
   return absl::OkStatus();
 }
 
+// Returns true if the step is statically known to produce the constant 'true'.
+//
+// The map and filter macros expand to comprehensions whose loop condition is
+// the literal 'true'; for those shapes the per-element condition evaluation is
+// pure overhead and can be skipped without changing semantics.
+bool IsConstantTrueStep(const DirectExpressionStep* step) {
+  if (step == nullptr ||
+      step->GetNativeTypeId() !=
+          cel::NativeTypeId::For<DirectCompilerConstantStep>()) {
+    return false;
+  }
+  const Value& value =
+      cel::internal::down_cast<const DirectCompilerConstantStep*>(step)
+          ->value();
+  return InstanceOf<BoolValue>(value) && Cast<BoolValue>(value).NativeValue();
+}
+
 class ComprehensionDirectStep : public DirectExpressionStep {
  public:
   explicit ComprehensionDirectStep(
@@ -152,7 +179,8 @@ class ComprehensionDirectStep : public DirectExpressionStep {
         loop_step_(std::move(loop_step)),
         condition_(std::move(condition_step)),
         result_step_(std::move(result_step)),
-        shortcircuiting_(shortcircuiting) {}
+        shortcircuiting_(shortcircuiting),
+        condition_is_const_true_(IsConstantTrueStep(condition_.get())) {}
   absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
                         AttributeTrail& trail) const override;
 
@@ -166,6 +194,8 @@ class ComprehensionDirectStep : public DirectExpressionStep {
   std::unique_ptr<DirectExpressionStep> result_step_;
 
   bool shortcircuiting_;
+  // True if the loop condition is the constant 'true' (map/filter shapes).
+  bool condition_is_const_true_;
 };
 
 absl::Status ComprehensionDirectStep::Evaluate(ExecutionFrameBase& frame,
@@ -183,7 +213,7 @@ absl::Status ComprehensionDirectStep::Evaluate(ExecutionFrameBase& frame,
   switch (range.kind()) {
     case cel::ValueKind::kError:
     case cel::ValueKind::kUnknown:
-      result = range;
+      result = std::move(range);
       return absl::OkStatus();
       break;
     default:
@@ -200,6 +230,13 @@ absl::Status ComprehensionDirectStep::Evaluate(ExecutionFrameBase& frame,
   AttributeTrail accu_init_attr;
   CEL_RETURN_IF_ERROR(accu_init_->Evaluate(frame, accu_init, accu_init_attr));
 
+  // For list-building comprehensions the range size bounds the result size;
+  // reserving up front avoids regrowing the accumulator while appending.
+  if (MutableListValue::Is(accu_init)) {
+    CEL_ASSIGN_OR_RETURN(size_t range_size, range_list.Size());
+    MutableListValue::Cast(accu_init).Reserve(range_size);
+  }
+
   frame.comprehension_slots().Set(accu_slot_, std::move(accu_init),
                                   accu_init_attr);
   ComprehensionSlots::Slot* accu_slot =
@@ -218,24 +255,27 @@ absl::Status ComprehensionDirectStep::Evaluate(ExecutionFrameBase& frame,
       frame.value_manager(),
       [&](size_t index, const Value& v) -> absl::StatusOr<bool> {
         CEL_RETURN_IF_ERROR(frame.IncrementIterations());
-        // Evaluate loop condition first.
-        CEL_RETURN_IF_ERROR(
-            condition_->Evaluate(frame, condition, condition_attr));
-
-        if (condition.kind() == cel::ValueKind::kError ||
-            condition.kind() == cel::ValueKind::kUnknown) {
-          result = std::move(condition);
-          should_skip_result = true;
-          return false;
-        }
-        if (condition.kind() != cel::ValueKind::kBool) {
-          result = frame.value_manager().CreateErrorValue(
-              CreateNoMatchingOverloadError("<loop_condition>"));
-          should_skip_result = true;
-          return false;
-        }
-        if (shortcircuiting_ && !Cast<BoolValue>(condition).NativeValue()) {
-          return false;
+        // Evaluate loop condition first, unless it is statically 'true', in
+        // which case it can neither fail nor break the loop.
+        if (!condition_is_const_true_) {
+          CEL_RETURN_IF_ERROR(
+              condition_->Evaluate(frame, condition, condition_attr));
+
+          if (condition.kind() == cel::ValueKind::kError ||
+              condition.kind() == cel::ValueKind::kUnknown) {
+            result = std::move(condition);
+            should_skip_result = true;
+            return false;
+          }
+          if (condition.kind() != cel::ValueKind::kBool) {
+            result = frame.value_manager().CreateErrorValue(
+                CreateNoMatchingOverloadError("<loop_condition>"));
+            should_skip_result = true;
+            return false;
+          }
+          if (shortcircuiting_ && !Cast<BoolValue>(condition).NativeValue()) {
+            return false;
+          }
         }
 
         iter_slot->value = v;
@@ -336,10 +376,13 @@ absl::Status ComprehensionNextStep::Evaluate(ExecutionFrame* frame) const {
   if (!frame->value_stack().HasEnough(kStackSize)) {
     return absl::Status(absl::StatusCode::kInternal, "Value stack underflow");
   }
-  absl::Span<const Value> state = frame->value_stack().GetSpan(kStackSize);
+  // Mutable access: every state value is either popped or overwritten before
+  // this step returns, so consuming them by move elides the reference count
+  // traffic that copies would incur once per loop iteration.
+  absl::Span<Value> state = frame->value_stack().GetMutableSpan(kStackSize);
 
   // Get range from the stack.
-  const cel::Value& iter_range = state[POS_ITER_RANGE];
+  Value& iter_range = state[POS_ITER_RANGE];
   if (!iter_range->Is<cel::ListValue>()) {
     if (iter_range->Is<cel::ErrorValue>() ||
         iter_range->Is<cel::UnknownValue>()) {
@@ -364,7 +407,10 @@ absl::Status ComprehensionNextStep::Evaluate(ExecutionFrame* frame) const {
 
   int64_t next_index = Cast<IntValue>(current_index_value).NativeValue() + 1;
 
-  frame->comprehension_slots().Set(accu_slot_, state[POS_LOOP_STEP_ACCU]);
+  // The loop step value is popped before this step returns; moving it into
+  // the accumulator slot transfers ownership instead of re-counting it.
+  frame->comprehension_slots().Set(accu_slot_,
+                                   std::move(state[POS_LOOP_STEP_ACCU]));
 
   CEL_ASSIGN_OR_RETURN(auto iter_range_list_size, iter_range_list.Size());
 
@@ -390,9 +436,32 @@ absl::Status ComprehensionNextStep::Evaluate(ExecutionFrame* frame) const {
     current_value =
         frame->attribute_utility().CreateUnknownSet(iter_trail.attribute());
   } else {
-    CEL_ASSIGN_OR_RETURN(current_value,
-                         iter_range_list.Get(frame->value_factory(),
-                                             static_cast<size_t>(next_index)));
+    // Elements are pulled from the range in chunks, so the loop pays one
+    // ListValue dispatch per run of kIterationChunkSize elements instead of
+    // one per element. Iteration zero resets the chunk, so a previous loop
+    // that exited early cannot leak buffered elements into a later
+    // comprehension reusing this slot.
+    const size_t index = static_cast<size_t>(next_index);
+    ExecutionFrame::IterationChunk& chunk = frame->iteration_chunk(iter_slot_);
+    if (index == 0 || index < chunk.begin ||
+        index >= chunk.begin + chunk.values.size()) {
+      chunk.begin = index;
+      chunk.values.resize(
+          std::min<size_t>(kIterationChunkSize, iter_range_list_size - index));
+      CEL_ASSIGN_OR_RETURN(
+          const size_t fetched,
+          iter_range_list.GetChunk(frame->value_factory(), index,
+                                   absl::MakeSpan(chunk.values)));
+      chunk.values.resize(fetched);
+    }
+    if (index >= chunk.begin && index < chunk.begin + chunk.values.size()) {
+      current_value = std::move(chunk.values[index - chunk.begin]);
+    } else {
+      // The chunk fetch came up short (e.g. a paged range reporting a
+      // shorter resident run); fall back to a single-element read.
+      CEL_ASSIGN_OR_RETURN(
+          current_value, iter_range_list.Get(frame->value_factory(), index));
+    }
   }
 
   // pop loop step
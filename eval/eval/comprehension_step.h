@@ -6,6 +6,7 @@
 #include <memory>
 
 #include "absl/status/status.h"
+#include "common/native_type.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 #include "eval/eval/expression_step_base.h"
@@ -19,6 +20,13 @@ class ComprehensionNextStep : public ExpressionStepBase {
   void set_jump_offset(int offset);
   void set_error_jump_offset(int offset);
 
+  // Identifies this step as one that jumps with offsets the post-planning
+  // jump cleanup pass cannot see; the pass must not move steps in plans
+  // containing it.
+  cel::NativeTypeId GetNativeTypeId() const override {
+    return cel::NativeTypeId::For<ComprehensionNextStep>();
+  }
+
   absl::Status Evaluate(ExecutionFrame* frame) const override;
 
  private:
@@ -36,6 +44,11 @@ class ComprehensionCondStep : public ExpressionStepBase {
   void set_jump_offset(int offset);
   void set_error_jump_offset(int offset);
 
+  // See ComprehensionNextStep::GetNativeTypeId.
+  cel::NativeTypeId GetNativeTypeId() const override {
+    return cel::NativeTypeId::For<ComprehensionCondStep>();
+  }
+
   absl::Status Evaluate(ExecutionFrame* frame) const override;
 
  private:
@@ -18,6 +18,7 @@
 #include "common/value_kind.h"
 #include "eval/eval/attribute_trail.h"
 #include "eval/eval/attribute_utility.h"
+#include "eval/eval/compiler_constant_step.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 #include "eval/eval/expression_step_base.h"
@@ -217,10 +218,14 @@ void LookupInContainer(const Value& container, const Value& key,
   }
 }
 
+// `cached_qualifier`, if non-null, is the plan-time precomputed qualifier for
+// a constant key, saving the per-access conversion (including string
+// materialization) when attribute tracking is enabled.
 void PerformLookup(ExecutionFrameBase& frame, const Value& container,
                    const Value& key, const AttributeTrail& container_trail,
                    bool enable_optional_types, Value& result,
-                   AttributeTrail& trail) {
+                   AttributeTrail& trail,
+                   const AttributeQualifier* cached_qualifier = nullptr) {
   if (frame.unknown_processing_enabled()) {
     AttributeUtility::Accumulator unknowns =
         frame.attribute_utility().CreateAccumulator();
@@ -232,7 +237,9 @@ void PerformLookup(ExecutionFrameBase& frame, const Value& container,
       return;
     }
 
-    trail = container_trail.Step(AttributeQualifierFromValue(key));
+    trail = container_trail.Step(cached_qualifier != nullptr
+                                     ? *cached_qualifier
+                                     : AttributeQualifierFromValue(key));
 
     if (frame.attribute_utility().CheckForUnknownExact(trail)) {
       result = frame.attribute_utility().CreateUnknownSet(trail.attribute());
@@ -317,7 +324,18 @@ class DirectContainerAccessStep : public DirectExpressionStep {
       : DirectExpressionStep(expr_id),
         container_step_(std::move(container_step)),
         key_step_(std::move(key_step)),
-        enable_optional_types_(enable_optional_types) {}
+        enable_optional_types_(enable_optional_types) {
+    // When the key is a compile-time constant its attribute qualifier can be
+    // built once at plan time instead of rebuilt on every access.
+    if (key_step_ != nullptr &&
+        key_step_->GetNativeTypeId() ==
+            cel::NativeTypeId::For<DirectCompilerConstantStep>()) {
+      constant_qualifier_ = AttributeQualifierFromValue(
+          cel::internal::down_cast<const DirectCompilerConstantStep*>(
+              key_step_.get())
+              ->value());
+    }
+  }
 
   absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
                         AttributeTrail& trail) const override;
@@ -326,6 +344,7 @@ class DirectContainerAccessStep : public DirectExpressionStep {
   std::unique_ptr<DirectExpressionStep> container_step_;
   std::unique_ptr<DirectExpressionStep> key_step_;
   bool enable_optional_types_;
+  absl::optional<AttributeQualifier> constant_qualifier_;
 };
 
 absl::Status DirectContainerAccessStep::Evaluate(ExecutionFrameBase& frame,
@@ -341,7 +360,9 @@ absl::Status DirectContainerAccessStep::Evaluate(ExecutionFrameBase& frame,
   CEL_RETURN_IF_ERROR(key_step_->Evaluate(frame, key, key_trail));
 
   PerformLookup(frame, container, key, container_trail, enable_optional_types_,
-                result, trail);
+                result, trail,
+                constant_qualifier_.has_value() ? &*constant_qualifier_
+                                                : nullptr);
 
   return absl::OkStatus();
 }
@@ -43,6 +43,9 @@ class CreateListStep : public ExpressionStepBase {
 
   absl::Status Evaluate(ExecutionFrame* frame) const override;
 
+  // Builds a list, doing per-element work.
+  int64_t Cost() const override { return 1 + list_size_; }
+
  private:
   int list_size_;
   absl::flat_hash_set<int32_t> optional_indices_;
@@ -61,12 +64,12 @@ absl::Status CreateListStep::Evaluate(ExecutionFrame* frame) const {
 
   auto args = frame->value_stack().GetSpan(list_size_);
 
-  cel::Value result;
   for (const auto& arg : args) {
     if (arg->Is<cel::ErrorValue>()) {
-      result = arg;
-      frame->value_stack().Pop(list_size_);
-      frame->value_stack().Push(std::move(result));
+      // The forwarded error is copied out before the fused pop destroys the
+      // arguments it came from.
+      cel::Value result = arg;
+      frame->value_stack().PopAndPush(list_size_, std::move(result));
       return absl::OkStatus();
     }
   }
@@ -77,8 +80,8 @@ absl::Status CreateListStep::Evaluate(ExecutionFrame* frame) const {
             args, frame->value_stack().GetAttributeSpan(list_size_),
             /*use_partial=*/true);
     if (unknown_set.has_value()) {
-      frame->value_stack().Pop(list_size_);
-      frame->value_stack().Push(std::move(unknown_set).value());
+      frame->value_stack().PopAndPush(list_size_,
+                                      std::move(unknown_set).value());
       return absl::OkStatus();
     }
   }
@@ -211,6 +214,19 @@ absl::Status MutableListStep::Evaluate(ExecutionFrame* frame) const {
                        frame->value_manager().NewListValueBuilder(
                            frame->value_manager().GetDynListType()));
 
+  // This step is only planned as the accumulator initializer of a
+  // list-building comprehension, so the (already coerced) iteration range is
+  // below the loop index on the stack. Its size bounds the result size;
+  // reserving up front avoids regrowing while appending.
+  if (frame->value_stack().HasEnough(2)) {
+    const Value& iter_range = frame->value_stack().GetSpan(2)[0];
+    if (iter_range->Is<cel::ListValue>()) {
+      CEL_ASSIGN_OR_RETURN(size_t size,
+                           Cast<cel::ListValue>(iter_range).Size());
+      builder->Reserve(size);
+    }
+  }
+
   frame->value_stack().Push(cel::OpaqueValue{
       frame->value_manager().GetMemoryManager().MakeShared<MutableListValue>(
           std::move(builder))});
@@ -51,18 +51,28 @@ using ::cel::Value;
 class CreateStructStepForMap final : public ExpressionStepBase {
  public:
   CreateStructStepForMap(int64_t expr_id, size_t entry_count,
-                         absl::flat_hash_set<int32_t> optional_indices)
+                         absl::flat_hash_set<int32_t> optional_indices,
+                         bool pre_validated_keys)
       : ExpressionStepBase(expr_id),
         entry_count_(entry_count),
-        optional_indices_(std::move(optional_indices)) {}
+        optional_indices_(std::move(optional_indices)),
+        pre_validated_keys_(pre_validated_keys) {}
 
   absl::Status Evaluate(ExecutionFrame* frame) const override;
 
+  // Builds a map, doing per-entry work (key check and insert).
+  int64_t Cost() const override {
+    return 1 + 2 * static_cast<int64_t>(entry_count_);
+  }
+
  private:
   absl::StatusOr<Value> DoEvaluate(ExecutionFrame* frame) const;
 
   size_t entry_count_;
   absl::flat_hash_set<int32_t> optional_indices_;
+  // True if the planner proved every key a valid, duplicate-free map key
+  // constant, allowing the per-entry key check to be skipped.
+  bool pre_validated_keys_;
 };
 
 
@@ -85,7 +95,9 @@ absl::StatusOr<Value> CreateStructStepForMap::DoEvaluate(
 
   for (size_t i = 0; i < entry_count_; i += 1) {
     auto& map_key = args[2 * i];
-    CEL_RETURN_IF_ERROR(cel::CheckMapKey(map_key));
+    if (!pre_validated_keys_) {
+      CEL_RETURN_IF_ERROR(cel::CheckMapKey(map_key));
+    }
     auto& map_value = args[(2 * i) + 1];
     if (optional_indices_.contains(static_cast<int32_t>(i))) {
       if (auto optional_map_value = cel::As<cel::OptionalValue>(map_value);
@@ -234,8 +246,120 @@ absl::Status DirectCreateMapStep::Evaluate(
   return absl::OkStatus();
 }
 
+// Variant of DirectCreateMapStep for map literals whose keys are all
+// plan-time constants. The planner converted, validated and duplicate-checked
+// the keys once; only the value subexpressions are evaluated here and paired
+// with the precomputed keys positionally.
+class DirectCreateConstKeyMapStep : public DirectExpressionStep {
+ public:
+  DirectCreateConstKeyMapStep(
+      std::vector<Value> keys,
+      std::vector<std::unique_ptr<DirectExpressionStep>> value_deps,
+      absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id)
+      : DirectExpressionStep(expr_id),
+        keys_(std::move(keys)),
+        deps_(std::move(value_deps)),
+        optional_indices_(std::move(optional_indices)) {}
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
+                        AttributeTrail& attribute_trail) const override;
+
+  absl::optional<std::vector<const DirectExpressionStep*>> GetDependencies()
+      const override {
+    std::vector<const DirectExpressionStep*> dependencies;
+    dependencies.reserve(deps_.size());
+    for (const auto& dep : deps_) {
+      dependencies.push_back(dep.get());
+    }
+    return dependencies;
+  }
+
+ private:
+  std::vector<Value> keys_;
+  std::vector<std::unique_ptr<DirectExpressionStep>> deps_;
+  absl::flat_hash_set<int32_t> optional_indices_;
+};
+
+absl::Status DirectCreateConstKeyMapStep::Evaluate(
+    ExecutionFrameBase& frame, Value& result,
+    AttributeTrail& attribute_trail) const {
+  Value value;
+  AttributeTrail tmp_attr;
+  auto unknowns = frame.attribute_utility().CreateAccumulator();
+
+  CEL_ASSIGN_OR_RETURN(auto builder,
+                       frame.value_manager().NewMapValueBuilder(
+                           frame.value_manager().GetDynDynMapType()));
+  builder->Reserve(keys_.size());
+
+  for (size_t i = 0; i < keys_.size(); i += 1) {
+    CEL_RETURN_IF_ERROR(deps_[i]->Evaluate(frame, value, tmp_attr));
+
+    if (InstanceOf<ErrorValue>(value)) {
+      result = value;
+      return absl::OkStatus();
+    }
+
+    if (frame.unknown_processing_enabled()) {
+      if (InstanceOf<UnknownValue>(value)) {
+        unknowns.Add(Cast<UnknownValue>(value));
+      } else if (frame.attribute_utility().CheckForUnknownPartial(tmp_attr)) {
+        unknowns.Add(tmp_attr);
+      }
+    }
+
+    // Preserve the stack machine behavior of forwarding unknowns before
+    // errors.
+    if (!unknowns.IsEmpty()) {
+      continue;
+    }
+
+    if (optional_indices_.contains(static_cast<int32_t>(i))) {
+      if (auto optional_map_value =
+              cel::As<cel::OptionalValue>(static_cast<const Value&>(value));
+          optional_map_value) {
+        if (!optional_map_value->HasValue()) {
+          continue;
+        }
+        auto key_status =
+            builder->Put(keys_[i], optional_map_value->Value());
+        if (!key_status.ok()) {
+          result = frame.value_manager().CreateErrorValue(key_status);
+          return absl::OkStatus();
+        }
+        continue;
+      }
+      return cel::TypeConversionError(value.DebugString(), "optional_type")
+          .NativeValue();
+    }
+
+    auto put_status = builder->Put(keys_[i], std::move(value));
+    if (!put_status.ok()) {
+      result = frame.value_manager().CreateErrorValue(put_status);
+      return absl::OkStatus();
+    }
+  }
+
+  if (!unknowns.IsEmpty()) {
+    result = std::move(unknowns).Build();
+    return absl::OkStatus();
+  }
+
+  result = std::move(*builder).Build();
+  return absl::OkStatus();
+}
+
 }  // namespace
 
+std::unique_ptr<DirectExpressionStep> CreateDirectCreateConstKeyMapStep(
+    std::vector<cel::Value> keys,
+    std::vector<std::unique_ptr<DirectExpressionStep>> value_deps,
+    absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id) {
+  return std::make_unique<DirectCreateConstKeyMapStep>(
+      std::move(keys), std::move(value_deps), std::move(optional_indices),
+      expr_id);
+}
+
 std::unique_ptr<DirectExpressionStep> CreateDirectCreateMapStep(
     std::vector<std::unique_ptr<DirectExpressionStep>> deps,
     absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id) {
@@ -245,10 +369,17 @@ std::unique_ptr<DirectExpressionStep> CreateDirectCreateMapStep(
 
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateCreateStructStepForMap(
     size_t entry_count, absl::flat_hash_set<int32_t> optional_indices,
-    int64_t expr_id) {
+    bool pre_validated_keys, int64_t expr_id) {
   // Make map-creating step.
-  return std::make_unique<CreateStructStepForMap>(expr_id, entry_count,
-                                                  std::move(optional_indices));
+  return std::make_unique<CreateStructStepForMap>(
+      expr_id, entry_count, std::move(optional_indices), pre_validated_keys);
+}
+
+absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateCreateStructStepForMap(
+    size_t entry_count, absl::flat_hash_set<int32_t> optional_indices,
+    int64_t expr_id) {
+  return CreateCreateStructStepForMap(entry_count, std::move(optional_indices),
+                                      /*pre_validated_keys=*/false, expr_id);
 }
 
 }  // namespace google::api::expr::runtime
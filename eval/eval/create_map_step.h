@@ -22,6 +22,7 @@
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
+#include "common/value.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 
@@ -35,7 +36,25 @@ std::unique_ptr<DirectExpressionStep> CreateDirectCreateMapStep(
     std::vector<std::unique_ptr<DirectExpressionStep>> deps,
     absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id);
 
+// Creates an expression step that evaluates a create map expression whose
+// keys are all plan-time constants.
+//
+// The planner converts, validates and duplicate-checks the keys once at plan
+// time; the step only evaluates the value subexpressions (`value_deps`) and
+// pairs them with `keys` positionally.
+std::unique_ptr<DirectExpressionStep> CreateDirectCreateConstKeyMapStep(
+    std::vector<cel::Value> keys,
+    std::vector<std::unique_ptr<DirectExpressionStep>> value_deps,
+    absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id);
+
 // Creates an `ExpressionStep` which performs `CreateStruct` for a map.
+//
+// If `pre_validated_keys` is true, the planner has already verified that all
+// keys are valid map key constants with no duplicates, and the per-entry key
+// checks are skipped at evaluation time.
+absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateCreateStructStepForMap(
+    size_t entry_count, absl::flat_hash_set<int32_t> optional_indices,
+    bool pre_validated_keys, int64_t expr_id);
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateCreateStructStepForMap(
     size_t entry_count, absl::flat_hash_set<int32_t> optional_indices,
     int64_t expr_id);
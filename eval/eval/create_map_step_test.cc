@@ -231,6 +231,49 @@ TEST_P(CreateMapStepTest, TestCreateStringMap) {
   EXPECT_EQ(lookup1->Int64OrDie(), 1);
 }
 
+// Test the specialized step for map literals whose keys were precomputed at
+// plan time: only value subexpressions are evaluated.
+TEST(CreateMapStepTest, TestConstKeyMapRecursiveProgram) {
+  Arena arena;
+  Activation activation;
+  activation.InsertValue("value0", CelValue::CreateInt64(10));
+  activation.InsertValue("value1", CelValue::CreateInt64(20));
+
+  std::vector<cel::Value> keys;
+  keys.push_back(cel::IntValue(1));
+  keys.push_back(cel::IntValue(2));
+
+  std::vector<std::unique_ptr<DirectExpressionStep>> value_deps;
+  value_deps.push_back(CreateDirectIdentStep("value0", -1));
+  value_deps.push_back(CreateDirectIdentStep("value1", -1));
+
+  ExecutionPath path;
+  path.push_back(std::make_unique<WrappedDirectStep>(
+      CreateDirectCreateConstKeyMapStep(std::move(keys), std::move(value_deps),
+                                        {}, -1),
+      -1));
+
+  cel::RuntimeOptions options;
+  CelExpressionFlatImpl cel_expr(
+      FlatExpression(std::move(path), /*comprehension_slot_count=*/0,
+                     TypeProvider::Builtin(), options));
+  ASSERT_OK_AND_ASSIGN(CelValue result, cel_expr.Evaluate(activation, &arena));
+
+  ASSERT_TRUE(result.IsMap());
+  const CelMap* cel_map = result.MapOrDie();
+  ASSERT_EQ(cel_map->size(), 2);
+
+  auto lookup0 = cel_map->Get(&arena, CelValue::CreateInt64(1));
+  ASSERT_TRUE(lookup0.has_value());
+  ASSERT_TRUE(lookup0->IsInt64());
+  EXPECT_EQ(lookup0->Int64OrDie(), 10);
+
+  auto lookup1 = cel_map->Get(&arena, CelValue::CreateInt64(2));
+  ASSERT_TRUE(lookup1.has_value());
+  ASSERT_TRUE(lookup1->IsInt64());
+  EXPECT_EQ(lookup1->Int64OrDie(), 20);
+}
+
 INSTANTIATE_TEST_SUITE_P(CreateMapStep, CreateMapStepTest,
                          testing::Combine(testing::Bool(), testing::Bool()));
 
@@ -60,6 +60,11 @@ class CreateStructStepForStruct final : public ExpressionStepBase {
 
   absl::Status Evaluate(ExecutionFrame* frame) const override;
 
+  // Builds a message, doing per-field work.
+  int64_t Cost() const override {
+    return 1 + static_cast<int64_t>(entries_.size());
+  }
+
  private:
   absl::StatusOr<Value> DoEvaluate(ExecutionFrame* frame) const;
 
@@ -14,6 +14,7 @@
 #ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_DIRECT_EXPRESSION_STEP_H_
 #define THIRD_PARTY_CEL_CPP_EVAL_EVAL_DIRECT_EXPRESSION_STEP_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <utility>
@@ -25,6 +26,7 @@
 #include "common/value.h"
 #include "eval/eval/attribute_trail.h"
 #include "eval/eval/evaluator_core.h"
+#include "eval/eval/plan_arena.h"
 
 namespace google::api::expr::runtime {
 
@@ -43,6 +45,18 @@ class DirectExpressionStep {
 
   virtual ~DirectExpressionStep() = default;
 
+  // Pooled into the active plan arena alongside the stack machine steps; see
+  // ExpressionStep::operator new.
+  static void* operator new(size_t size) {
+    return plan_arena_internal::AllocateStep(size);
+  }
+  static void operator delete(void* ptr) noexcept {
+    plan_arena_internal::DeallocateStep(ptr);
+  }
+  static void operator delete(void* ptr, size_t) noexcept {
+    plan_arena_internal::DeallocateStep(ptr);
+  }
+
   int64_t expr_id() const { return expr_id_; }
   bool comes_from_ast() const { return expr_id_ >= 0; }
 
@@ -0,0 +1,70 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/evaluation_arena.h"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+google::protobuf::ArenaOptions MakeArenaOptions(char* block, size_t block_size) {
+  google::protobuf::ArenaOptions options;
+  options.initial_block = block;
+  options.initial_block_size = block_size;
+  return options;
+}
+
+// Bound on retained arenas per thread; beyond this depth of nested
+// evaluation, arenas are simply heap allocated and freed.
+constexpr size_t kMaxPooledArenas = 8;
+
+std::vector<std::unique_ptr<EvaluationArena>>& GetFreeList() {
+  static thread_local std::vector<std::unique_ptr<EvaluationArena>> free_list;
+  return free_list;
+}
+
+}  // namespace
+
+EvaluationArena::EvaluationArena(size_t block_size)
+    : block_(std::make_unique<char[]>(block_size)),
+      arena_(MakeArenaOptions(block_.get(), block_size)) {}
+
+PooledEvaluationArena::PooledEvaluationArena() {
+  auto& free_list = GetFreeList();
+  if (!free_list.empty()) {
+    arena_ = std::move(free_list.back());
+    free_list.pop_back();
+  } else {
+    arena_ = std::make_unique<EvaluationArena>();
+  }
+}
+
+PooledEvaluationArena::~PooledEvaluationArena() {
+  auto& free_list = GetFreeList();
+  if (free_list.size() < kMaxPooledArenas) {
+    // Reset eagerly so pooled arenas do not pin evaluation results between
+    // checkouts.
+    arena_->Reset();
+    free_list.push_back(std::move(arena_));
+  }
+}
+
+}  // namespace google::api::expr::runtime
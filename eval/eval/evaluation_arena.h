@@ -0,0 +1,88 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATION_ARENA_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATION_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+
+#include "common/memory.h"
+#include "extensions/protobuf/memory_manager.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+
+// Reusable bump allocation region for per-evaluation values.
+//
+// cel::MemoryManager supports exactly two strategies -- reference counting
+// and pooling backed by google::protobuf::Arena -- and is a concrete type,
+// so a third allocator cannot be plugged in behind MemoryManagerRef. This
+// instead reuses the pooling strategy with an arena built over a single
+// preallocated block owned by this object: per-evaluation allocations bump
+// within the block, Reset() makes the whole block available again without a
+// round trip through malloc, and only evaluations that outgrow the block
+// fall back to ordinary arena block allocation. Values that need
+// destructors are handled by the arena cleanup list, as with any pooling
+// memory manager.
+class EvaluationArena {
+ public:
+  static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+  explicit EvaluationArena(size_t block_size = kDefaultBlockSize);
+
+  EvaluationArena(const EvaluationArena&) = delete;
+  EvaluationArena& operator=(const EvaluationArena&) = delete;
+
+  // Runs destructors for values from the previous evaluation and resets the
+  // bump pointer. The initial block is retained for reuse; any overflow
+  // blocks are returned.
+  void Reset() { arena_.Reset(); }
+
+  google::protobuf::Arena* arena() { return &arena_; }
+
+  // Memory manager view of the arena, e.g. for MakeEvaluatorState. Values
+  // allocated through it are only valid until the next Reset().
+  cel::MemoryManagerRef memory_manager() {
+    return cel::extensions::ProtoMemoryManagerRef(&arena_);
+  }
+
+ private:
+  std::unique_ptr<char[]> block_;
+  google::protobuf::Arena arena_;
+};
+
+// RAII handle to a thread-local pool of EvaluationArena, following the
+// PooledEvaluatorState pattern (eval/eval/evaluator_state_pool.h): arenas are
+// checked out for the lifetime of the handle and reset when returned, so
+// steady-state evaluation reuses warmed blocks instead of allocating.
+class PooledEvaluationArena {
+ public:
+  PooledEvaluationArena();
+
+  PooledEvaluationArena(const PooledEvaluationArena&) = delete;
+  PooledEvaluationArena& operator=(const PooledEvaluationArena&) = delete;
+
+  // Resets the arena and returns it to the thread-local pool.
+  ~PooledEvaluationArena();
+
+  EvaluationArena& get() { return *arena_; }
+
+ private:
+  std::unique_ptr<EvaluationArena> arena_;
+};
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATION_ARENA_H_
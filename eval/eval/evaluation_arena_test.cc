@@ -0,0 +1,104 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/evaluation_arena.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "eval/compiler/cel_expression_builder_flat_impl.h"
+#include "eval/public/activation.h"
+#include "eval/public/builtin_func_registrar.h"
+#include "eval/public/cel_expression.h"
+#include "eval/public/cel_value.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::google::api::expr::parser::Parse;
+
+TEST(EvaluationArenaTest, SmallAllocationsStayInInitialBlock) {
+  EvaluationArena arena;
+  uint64_t baseline = arena.arena()->SpaceAllocated();
+
+  for (int i = 0; i < 100; ++i) {
+    google::protobuf::Arena::Create<std::string>(arena.arena(),
+                                       "some evaluation scratch");
+  }
+  // Bump allocation within the preallocated block; no new blocks.
+  EXPECT_EQ(arena.arena()->SpaceAllocated(), baseline);
+}
+
+TEST(EvaluationArenaTest, ResetRecyclesBlock) {
+  EvaluationArena arena;
+  uint64_t baseline = arena.arena()->SpaceAllocated();
+
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 100; ++i) {
+      google::protobuf::Arena::Create<std::string>(arena.arena(), "scratch");
+    }
+    arena.Reset();
+  }
+  EXPECT_EQ(arena.arena()->SpaceAllocated(), baseline);
+  EXPECT_EQ(arena.arena()->SpaceUsed(), 0);
+}
+
+TEST(EvaluationArenaTest, EvaluatesThroughResetCycles) {
+  CelExpressionBuilderFlatImpl builder;
+  ASSERT_OK(RegisterBuiltinFunctions(builder.GetRegistry()));
+  ASSERT_OK_AND_ASSIGN(auto parsed, Parse("'prefix_' + suffix"));
+  ASSERT_OK_AND_ASSIGN(
+      auto plan,
+      builder.CreateExpression(&parsed.expr(), &parsed.source_info()));
+
+  EvaluationArena arena;
+  for (int i = 0; i < 3; ++i) {
+    Activation activation;
+    std::string suffix = "value";
+    activation.InsertValue("suffix", CelValue::CreateString(&suffix));
+    ASSERT_OK_AND_ASSIGN(CelValue result,
+                         plan->Evaluate(activation, arena.arena()));
+    ASSERT_TRUE(result.IsString());
+    EXPECT_EQ(result.StringOrDie().value(), "prefix_value");
+    arena.Reset();
+  }
+}
+
+TEST(EvaluationArenaTest, PooledArenaIsReusedOnSameThread) {
+  EvaluationArena* first;
+  {
+    PooledEvaluationArena pooled;
+    first = &pooled.get();
+    google::protobuf::Arena::Create<std::string>(pooled.get().arena(), "scratch");
+  }
+  {
+    PooledEvaluationArena pooled;
+    EXPECT_EQ(&pooled.get(), first);
+    // Returned arenas come back reset.
+    EXPECT_EQ(pooled.get().arena()->SpaceUsed(), 0);
+  }
+}
+
+TEST(EvaluationArenaTest, NestedCheckoutsGetDistinctArenas) {
+  PooledEvaluationArena outer;
+  PooledEvaluationArena inner;
+  EXPECT_NE(&outer.get(), &inner.get());
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,201 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/evaluation_profile_export.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_replace.h"
+#include "absl/types/span.h"
+#include "base/ast_internal/ast_impl.h"
+#include "base/ast_internal/expr.h"
+#include "common/native_type.h"
+#include "common/source.h"
+#include "eval/eval/evaluation_profiler.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+using ::cel::ast_internal::AstImpl;
+using ::cel::ast_internal::Expr;
+
+// Node and parent lookup by expression id, built with one walk over the AST.
+// The root expression has no entry in `parents`.
+struct AstIndex {
+  absl::flat_hash_map<int64_t, const Expr*> nodes;
+  absl::flat_hash_map<int64_t, int64_t> parents;
+};
+
+void IndexExpr(const Expr& expr, AstIndex& index) {
+  index.nodes.emplace(expr.id(), &expr);
+  auto index_child = [&](const Expr& child) {
+    index.parents.emplace(child.id(), expr.id());
+    IndexExpr(child, index);
+  };
+  if (expr.has_select_expr()) {
+    if (expr.select_expr().has_operand()) {
+      index_child(expr.select_expr().operand());
+    }
+  } else if (expr.has_call_expr()) {
+    const auto& call = expr.call_expr();
+    if (call.has_target()) {
+      index_child(call.target());
+    }
+    for (const Expr& arg : call.args()) {
+      index_child(arg);
+    }
+  } else if (expr.has_list_expr()) {
+    for (const auto& element : expr.list_expr().elements()) {
+      if (element.has_expr()) {
+        index_child(element.expr());
+      }
+    }
+  } else if (expr.has_struct_expr()) {
+    for (const auto& field : expr.struct_expr().fields()) {
+      if (field.has_value()) {
+        index_child(field.value());
+      }
+    }
+  } else if (expr.has_map_expr()) {
+    for (const auto& entry : expr.map_expr().entries()) {
+      if (entry.has_key()) {
+        index_child(entry.key());
+      }
+      if (entry.has_value()) {
+        index_child(entry.value());
+      }
+    }
+  } else if (expr.has_comprehension_expr()) {
+    const auto& comprehension = expr.comprehension_expr();
+    if (comprehension.has_iter_range()) {
+      index_child(comprehension.iter_range());
+    }
+    if (comprehension.has_accu_init()) {
+      index_child(comprehension.accu_init());
+    }
+    if (comprehension.has_loop_condition()) {
+      index_child(comprehension.loop_condition());
+    }
+    if (comprehension.has_loop_step()) {
+      index_child(comprehension.loop_step());
+    }
+    if (comprehension.has_result()) {
+      index_child(comprehension.result());
+    }
+  }
+}
+
+// Collapsed stack format reserves ';' as the frame separator and the last
+// ' ' as the weight separator, so neither may appear inside a frame.
+std::string SanitizeFrame(std::string frame) {
+  return absl::StrReplaceAll(std::move(frame),
+                             {{";", "_"}, {" ", "_"}, {"\n", "_"}});
+}
+
+// Short human-readable label for a node, mirroring how the expression reads
+// in source: identifier and function names verbatim, `.field` for selects.
+std::string NodeLabel(const Expr& expr) {
+  if (expr.has_const_expr()) {
+    return "const";
+  }
+  if (expr.has_ident_expr()) {
+    return expr.ident_expr().name();
+  }
+  if (expr.has_select_expr()) {
+    return absl::StrCat(".", expr.select_expr().field());
+  }
+  if (expr.has_call_expr()) {
+    return absl::StrCat(expr.call_expr().function(), "()");
+  }
+  if (expr.has_list_expr()) {
+    return "list";
+  }
+  if (expr.has_struct_expr()) {
+    return expr.struct_expr().name();
+  }
+  if (expr.has_map_expr()) {
+    return "map";
+  }
+  if (expr.has_comprehension_expr()) {
+    return "comprehension";
+  }
+  return "expr";
+}
+
+std::string Frame(const Expr& expr, const AstImpl& ast,
+                  absl::Nullable<const cel::Source*> source) {
+  std::string frame = absl::StrCat(NodeLabel(expr), "#", expr.id());
+  if (source != nullptr) {
+    const auto& positions = ast.source_info().positions();
+    if (auto it = positions.find(expr.id()); it != positions.end()) {
+      if (auto location = source->GetLocation(it->second);
+          location.has_value()) {
+        absl::StrAppend(&frame, "@", location->line, ":", location->column);
+      }
+    }
+  }
+  return SanitizeFrame(std::move(frame));
+}
+
+}  // namespace
+
+std::string ExportProfileAsFoldedStacks(
+    absl::Span<const EvaluationProfiler::ProfileEntry> entries,
+    const AstImpl& ast, absl::Nullable<const cel::Source*> source) {
+  AstIndex index;
+  IndexExpr(ast.root_expr(), index);
+
+  // Step types sanitize to identical frames when RTTI is unavailable, so
+  // weights are aggregated per folded stack rather than assumed unique.
+  absl::flat_hash_map<std::string, int64_t> weights;
+  for (const EvaluationProfiler::ProfileEntry& entry : entries) {
+    std::vector<std::string> frames;
+    auto node = index.nodes.find(entry.expr_id);
+    if (node == index.nodes.end()) {
+      frames.push_back(SanitizeFrame(absl::StrCat("expr#", entry.expr_id)));
+    } else {
+      for (int64_t id = entry.expr_id;;) {
+        frames.push_back(Frame(*index.nodes.at(id), ast, source));
+        auto parent = index.parents.find(id);
+        if (parent == index.parents.end()) {
+          break;
+        }
+        id = parent->second;
+      }
+      std::reverse(frames.begin(), frames.end());
+    }
+    frames.push_back(SanitizeFrame(entry.step_type.DebugString()));
+    weights[absl::StrJoin(frames, ";")] += entry.total_nanos;
+  }
+
+  std::vector<std::pair<std::string, int64_t>> lines(weights.begin(),
+                                                     weights.end());
+  std::sort(lines.begin(), lines.end());
+  std::string result;
+  for (const auto& [stack, nanos] : lines) {
+    absl::StrAppend(&result, stack, " ", nanos, "\n");
+  }
+  return result;
+}
+
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,49 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATION_PROFILE_EXPORT_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATION_PROFILE_EXPORT_H_
+
+#include <string>
+
+#include "absl/base/nullability.h"
+#include "absl/types/span.h"
+#include "base/ast_internal/ast_impl.h"
+#include "common/source.h"
+#include "eval/eval/evaluation_profiler.h"
+
+namespace google::api::expr::runtime {
+
+// Converts aggregated profiler entries into collapsed ("folded") stack
+// format: one line per sampled program location, semicolon-separated frames
+// followed by the sample weight in nanoseconds. The output can be fed
+// directly to standard flamegraph tooling that accepts collapsed stacks.
+//
+// Frames are synthesized from the AST structure: the chain of nodes from the
+// root expression down to the sampled expression, each labeled
+// `<label>#<expr id>` where the label names the node (identifier or function
+// name, `.field` for selects, and so on). When `source` is provided and the
+// AST records a parse position for the node, `@<line>:<column>` is appended
+// for source attribution. A final frame names the evaluation step type, so
+// multiple steps planned for one expression remain distinguishable. Samples
+// whose expression id does not occur in `ast` — e.g. steps synthesized by
+// plan optimizers — fold into a single `expr#<id>` frame.
+std::string ExportProfileAsFoldedStacks(
+    absl::Span<const EvaluationProfiler::ProfileEntry> entries,
+    const cel::ast_internal::AstImpl& ast,
+    absl::Nullable<const cel::Source*> source = nullptr);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATION_PROFILE_EXPORT_H_
@@ -0,0 +1,107 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/evaluation_profile_export.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/ast_internal/ast_impl.h"
+#include "base/ast_internal/expr.h"
+#include "common/native_type.h"
+#include "common/source.h"
+#include "eval/eval/evaluation_profiler.h"
+#include "internal/testing.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::ast_internal::AstImpl;
+using ::cel::ast_internal::Expr;
+using ::cel::ast_internal::SourceInfo;
+using testing::HasSubstr;
+using testing::Not;
+
+struct FakeStep {};
+
+// Builds the AST for `a + 1` with explicit ids and parse positions:
+// the call `_+_` is id 1 at offset 2, `a` is id 2 at offset 0, and the
+// constant is id 3 at offset 4.
+AstImpl MakeTestAst() {
+  Expr root;
+  root.set_id(1);
+  auto& call = root.mutable_call_expr();
+  call.set_function("_+_");
+  auto& lhs = call.add_args();
+  lhs.set_id(2);
+  lhs.mutable_ident_expr().set_name("a");
+  auto& rhs = call.add_args();
+  rhs.set_id(3);
+  rhs.mutable_const_expr().set_int_value(1);
+
+  SourceInfo source_info;
+  source_info.set_positions({{1, 2}, {2, 0}, {3, 4}});
+  return AstImpl(std::move(root), std::move(source_info));
+}
+
+TEST(EvaluationProfileExport, FoldsStacksWithSourceAttribution) {
+  AstImpl ast = MakeTestAst();
+  ASSERT_OK_AND_ASSIGN(auto source, cel::NewSource("a + 1"));
+
+  std::vector<EvaluationProfiler::ProfileEntry> entries = {
+      {/*expr_id=*/2, cel::NativeTypeId::For<FakeStep>(), /*sample_count=*/3,
+       /*total_nanos=*/300},
+      {/*expr_id=*/1, cel::NativeTypeId::For<FakeStep>(), /*sample_count=*/1,
+       /*total_nanos=*/100},
+  };
+
+  std::string folded =
+      ExportProfileAsFoldedStacks(entries, ast, source.get());
+
+  // The identifier's stack nests under the call frame, both with line and
+  // column attribution, and each line carries its weight in nanoseconds.
+  EXPECT_THAT(folded, HasSubstr("_+_()#1@1:2;a#2@1:0;"));
+  EXPECT_THAT(folded, HasSubstr(" 300\n"));
+  EXPECT_THAT(folded, HasSubstr(" 100\n"));
+}
+
+TEST(EvaluationProfileExport, OmitsLocationsWithoutSource) {
+  AstImpl ast = MakeTestAst();
+
+  std::vector<EvaluationProfiler::ProfileEntry> entries = {
+      {/*expr_id=*/2, cel::NativeTypeId::For<FakeStep>(), /*sample_count=*/1,
+       /*total_nanos=*/50}};
+
+  std::string folded = ExportProfileAsFoldedStacks(entries, ast);
+
+  EXPECT_THAT(folded, HasSubstr("_+_()#1;a#2;"));
+  EXPECT_THAT(folded, Not(HasSubstr("@")));
+}
+
+TEST(EvaluationProfileExport, UnknownExprIdFoldsToSyntheticFrame) {
+  AstImpl ast = MakeTestAst();
+
+  std::vector<EvaluationProfiler::ProfileEntry> entries = {
+      {/*expr_id=*/99, cel::NativeTypeId::For<FakeStep>(), /*sample_count=*/1,
+       /*total_nanos=*/25}};
+
+  std::string folded = ExportProfileAsFoldedStacks(entries, ast);
+
+  EXPECT_THAT(folded, HasSubstr("expr#99;"));
+  EXPECT_THAT(folded, HasSubstr(" 25\n"));
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
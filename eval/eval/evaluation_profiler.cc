@@ -0,0 +1,133 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/evaluation_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/absl_check.h"
+#include "absl/synchronization/mutex.h"
+#include "common/native_type.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+// Bounded sample storage per thread; the oldest sample is overwritten once
+// the ring is full.
+constexpr size_t kRingCapacity = 4096;
+
+struct ThreadSamples {
+  absl::Mutex mu;
+  // Filled in insertion order until capacity, then treated as a ring with
+  // `next` as the overwrite cursor. The mutex is only contended when
+  // Collect() runs; the recording path otherwise acquires it uncontended,
+  // and only on sampled dispatches.
+  std::vector<EvaluationProfiler::Sample> ring ABSL_GUARDED_BY(mu);
+  size_t next ABSL_GUARDED_BY(mu) = 0;
+};
+
+struct SampleRegistry {
+  absl::Mutex mu;
+  std::vector<ThreadSamples*> threads ABSL_GUARDED_BY(mu);
+};
+
+SampleRegistry& GlobalRegistry() {
+  static SampleRegistry* registry = new SampleRegistry();
+  return *registry;
+}
+
+// Returns the calling thread's sample buffer, registering it on first use.
+// Buffers are intentionally never unregistered: they must outlive the thread
+// so that Collect() can drain samples from threads that have since exited,
+// and the leak is bounded by the number of threads that ever evaluated with
+// sampling enabled.
+ThreadSamples& LocalSamples() {
+  static thread_local ThreadSamples* samples = []() {
+    auto* thread_samples = new ThreadSamples();
+    SampleRegistry& registry = GlobalRegistry();
+    absl::MutexLock lock(&registry.mu);
+    registry.threads.push_back(thread_samples);
+    return thread_samples;
+  }();
+  return *samples;
+}
+
+}  // namespace
+
+ABSL_CONST_INIT std::atomic<int64_t> EvaluationProfiler::sample_period_{0};
+ABSL_CONST_INIT thread_local int64_t EvaluationProfiler::countdown_ = 1;
+
+void EvaluationProfiler::Enable(int64_t sample_period) {
+  ABSL_DCHECK_GE(sample_period, 1);
+  sample_period_.store(sample_period, std::memory_order_relaxed);
+}
+
+void EvaluationProfiler::Disable() {
+  sample_period_.store(0, std::memory_order_relaxed);
+}
+
+void EvaluationProfiler::Record(int64_t expr_id, cel::NativeTypeId step_type,
+                                int64_t elapsed_nanos) {
+  ThreadSamples& samples = LocalSamples();
+  absl::MutexLock lock(&samples.mu);
+  if (samples.ring.size() < kRingCapacity) {
+    samples.ring.push_back(Sample{expr_id, step_type, elapsed_nanos});
+    return;
+  }
+  samples.ring[samples.next] = Sample{expr_id, step_type, elapsed_nanos};
+  samples.next = (samples.next + 1) % kRingCapacity;
+}
+
+std::vector<EvaluationProfiler::ProfileEntry> EvaluationProfiler::Collect() {
+  absl::flat_hash_map<std::pair<int64_t, cel::NativeTypeId>,
+                      std::pair<int64_t, int64_t>>
+      totals;
+
+  SampleRegistry& registry = GlobalRegistry();
+  {
+    absl::MutexLock lock(&registry.mu);
+    for (ThreadSamples* samples : registry.threads) {
+      absl::MutexLock thread_lock(&samples->mu);
+      for (const Sample& sample : samples->ring) {
+        auto& total = totals[{sample.expr_id, sample.step_type}];
+        ++total.first;
+        total.second += sample.elapsed_nanos;
+      }
+      samples->ring.clear();
+      samples->next = 0;
+    }
+  }
+
+  std::vector<ProfileEntry> result;
+  result.reserve(totals.size());
+  for (const auto& entry : totals) {
+    result.push_back(ProfileEntry{entry.first.first, entry.first.second,
+                                  entry.second.first, entry.second.second});
+  }
+  std::sort(result.begin(), result.end(),
+            [](const ProfileEntry& lhs, const ProfileEntry& rhs) {
+              return lhs.total_nanos > rhs.total_nanos;
+            });
+  return result;
+}
+
+}  // namespace google::api::expr::runtime
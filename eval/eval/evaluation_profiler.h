@@ -0,0 +1,104 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATION_PROFILER_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATION_PROFILER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/base/optimization.h"
+#include "common/native_type.h"
+
+namespace google::api::expr::runtime {
+
+// Process-wide sampling profiler for the stack machine dispatch loop.
+//
+// Unlike the instrumentation extension (eval/compiler/instrumentation.h),
+// which plans an extra step and a callback after every instrumented
+// subexpression, the profiler samples: when enabled, one out of every
+// `sample_period` dispatched steps is timed and recorded as (expression id,
+// step native type, elapsed nanoseconds) in a per-thread ring buffer. The
+// untimed dispatches pay only an atomic load and a thread-local decrement,
+// so a suitably large period keeps the overhead low enough for production.
+//
+// Sampling applies to untraced evaluation only; traced evaluation already
+// invokes a per-step listener, which dwarfs the profiler's overhead.
+//
+// The per-thread ring buffers hold a bounded number of samples and overwrite
+// the oldest entry when full, so an idle Collect() caller loses old samples
+// rather than growing memory without bound.
+class EvaluationProfiler final {
+ public:
+  // A single timed dispatch.
+  struct Sample final {
+    int64_t expr_id;
+    cel::NativeTypeId step_type;
+    int64_t elapsed_nanos;
+  };
+
+  // Aggregated samples for one (expression id, step type) pair.
+  struct ProfileEntry final {
+    int64_t expr_id;
+    cel::NativeTypeId step_type;
+    int64_t sample_count;
+    int64_t total_nanos;
+  };
+
+  EvaluationProfiler() = delete;
+
+  // Enables sampling: one out of every `sample_period` dispatched steps is
+  // timed and recorded. `sample_period` must be >= 1 (1 times every step,
+  // which is only suitable for tests). Affects all evaluations in the
+  // process.
+  static void Enable(int64_t sample_period);
+
+  // Disables sampling. Samples already collected remain available to
+  // Collect().
+  static void Disable();
+
+  // True if sampling is enabled. Cheap enough to check once per dispatch.
+  static bool IsEnabled() {
+    return sample_period_.load(std::memory_order_relaxed) > 0;
+  }
+
+  // Countdown check for the dispatch loop: returns true when the current
+  // dispatch should be timed and recorded.
+  static bool ShouldSample() {
+    if (ABSL_PREDICT_TRUE(--countdown_ > 0)) {
+      return false;
+    }
+    countdown_ = sample_period_.load(std::memory_order_relaxed);
+    return countdown_ > 0;
+  }
+
+  // Records a timed dispatch into the calling thread's ring buffer,
+  // overwriting the oldest sample if the buffer is full.
+  static void Record(int64_t expr_id, cel::NativeTypeId step_type,
+                     int64_t elapsed_nanos);
+
+  // Drains the ring buffers of all threads and returns totals keyed by
+  // (expression id, step type), ordered by descending total time.
+  static std::vector<ProfileEntry> Collect();
+
+ private:
+  ABSL_CONST_INIT static std::atomic<int64_t> sample_period_;
+  ABSL_CONST_INIT static thread_local int64_t countdown_;
+};
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATION_PROFILER_H_
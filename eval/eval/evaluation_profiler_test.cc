@@ -0,0 +1,140 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/evaluation_profiler.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "base/type_provider.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/internal/interop.h"
+#include "extensions/protobuf/memory_manager.h"
+#include "internal/testing.h"
+#include "runtime/activation.h"
+#include "runtime/runtime_options.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::IntValue;
+using ::cel::TypeProvider;
+using ::cel::extensions::ProtoMemoryManagerRef;
+using ::cel::interop_internal::CreateIntValue;
+
+// Pushes int64_t(0) on top of value stack.
+class FakeConstExpressionStep : public ExpressionStep {
+ public:
+  explicit FakeConstExpressionStep(int64_t id) : ExpressionStep(id, true) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    frame->value_stack().Push(CreateIntValue(0));
+    return absl::OkStatus();
+  }
+};
+
+// Increments the argument on top of the stack.
+class FakeIncrementExpressionStep : public ExpressionStep {
+ public:
+  explicit FakeIncrementExpressionStep(int64_t id) : ExpressionStep(id, true) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    int64_t val = frame->value_stack().Peek().As<IntValue>().NativeValue();
+    frame->value_stack().Pop(1);
+    frame->value_stack().Push(CreateIntValue(val + 1));
+    return absl::OkStatus();
+  }
+};
+
+class EvaluationProfilerTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    // Drain samples left behind by other tests in this binary.
+    EvaluationProfiler::Collect();
+  }
+
+  void TearDown() override { EvaluationProfiler::Disable(); }
+
+  absl::StatusOr<cel::Value> Evaluate(ExecutionPathView path) {
+    google::protobuf::Arena arena;
+    cel::Activation activation;
+    cel::RuntimeOptions options;
+    FlatExpressionEvaluatorState state(path.size(),
+                                       /*comprehension_slot_count=*/0,
+                                       TypeProvider::Builtin(),
+                                       ProtoMemoryManagerRef(&arena));
+    ExecutionFrame frame(path, activation, options, state);
+    return frame.Evaluate();
+  }
+};
+
+TEST_F(EvaluationProfilerTest, RecordsEverySampledStep) {
+  ExecutionPath path;
+  path.push_back(std::make_unique<FakeConstExpressionStep>(1));
+  path.push_back(std::make_unique<FakeIncrementExpressionStep>(2));
+  path.push_back(std::make_unique<FakeIncrementExpressionStep>(3));
+
+  EvaluationProfiler::Enable(/*sample_period=*/1);
+  ASSERT_OK_AND_ASSIGN(auto result, Evaluate(path));
+  EvaluationProfiler::Disable();
+
+  EXPECT_EQ(result.As<IntValue>().NativeValue(), 2);
+
+  auto profile = EvaluationProfiler::Collect();
+  ASSERT_EQ(profile.size(), 3);
+  int64_t total_samples = 0;
+  for (const auto& entry : profile) {
+    EXPECT_GE(entry.expr_id, 1);
+    EXPECT_LE(entry.expr_id, 3);
+    EXPECT_GE(entry.total_nanos, 0);
+    total_samples += entry.sample_count;
+  }
+  EXPECT_EQ(total_samples, 3);
+}
+
+TEST_F(EvaluationProfilerTest, SamplePeriodSkipsDispatches) {
+  ExecutionPath path;
+  path.push_back(std::make_unique<FakeConstExpressionStep>(1));
+  for (int64_t id = 2; id <= 9; ++id) {
+    path.push_back(std::make_unique<FakeIncrementExpressionStep>(id));
+  }
+
+  EvaluationProfiler::Enable(/*sample_period=*/4);
+  ASSERT_OK(Evaluate(path).status());
+  EvaluationProfiler::Disable();
+
+  int64_t total_samples = 0;
+  for (const auto& entry : EvaluationProfiler::Collect()) {
+    total_samples += entry.sample_count;
+  }
+  // 9 dispatches at one sample per 4: at most 3 samples (the countdown may
+  // carry over from a prior evaluation on this thread), never all 9.
+  EXPECT_GE(total_samples, 1);
+  EXPECT_LE(total_samples, 3);
+}
+
+TEST_F(EvaluationProfilerTest, DisabledRecordsNothing) {
+  ExecutionPath path;
+  path.push_back(std::make_unique<FakeConstExpressionStep>(1));
+
+  ASSERT_OK(Evaluate(path).status());
+
+  EXPECT_TRUE(EvaluationProfiler::Collect().empty());
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
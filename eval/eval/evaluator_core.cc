@@ -14,9 +14,12 @@
 
 #include "eval/eval/evaluator_core.h"
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <memory>
+#include <string>
 #include <utility>
 
 #include "absl/base/optimization.h"
@@ -25,12 +28,17 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
 #include "absl/types/optional.h"
 #include "absl/utility/utility.h"
 #include "base/type_provider.h"
 #include "common/memory.h"
 #include "common/value.h"
 #include "common/value_manager.h"
+#include "eval/eval/evaluation_profiler.h"
+#include "internal/status_macros.h"
 #include "runtime/activation_interface.h"
 #include "runtime/managed_value_factory.h"
 
@@ -43,7 +51,8 @@ FlatExpressionEvaluatorState::FlatExpressionEvaluatorState(
     : value_stack_(value_stack_size),
       comprehension_slots_(comprehension_slot_count),
       managed_value_factory_(absl::in_place, type_provider, memory_manager),
-      value_factory_(&managed_value_factory_->get()) {}
+      value_factory_(&managed_value_factory_->get()),
+      type_provider_(&type_provider) {}
 
 FlatExpressionEvaluatorState::FlatExpressionEvaluatorState(
     size_t value_stack_size, size_t comprehension_slot_count,
@@ -55,16 +64,87 @@ FlatExpressionEvaluatorState::FlatExpressionEvaluatorState(
 
 void FlatExpressionEvaluatorState::Reset() {
   value_stack_.Clear();
-  comprehension_slots_.Reset();
+  comprehension_slots().Reset();
+  stats_ = EvaluationStats();
+  if (allocation_report_.has_value()) {
+    allocation_report_.emplace();
+  }
+}
+
+void FlatExpressionEvaluatorState::Rebind(size_t value_stack_size,
+                                          size_t comprehension_slot_count,
+                                          cel::ValueManager& value_factory) {
+  value_stack_.Clear();
+  value_stack_.SetMaxSize(value_stack_size);
+  borrowed_slots_ = nullptr;
+  comprehension_slots_.Resize(comprehension_slot_count);
+  managed_value_factory_.reset();
+  value_factory_ = &value_factory;
+  type_provider_ = nullptr;
+  stats_ = EvaluationStats();
+  allocation_report_.reset();
+}
+
+absl::StatusOr<bool> ExecutionFrameBase::ResolveVariable(
+    absl::string_view name, cel::Value& result) {
+  const auto& ambient = options_->ambient_variables;
+  if (ABSL_PREDICT_TRUE(ambient.empty())) {
+    return activation_->FindVariable(*value_manager_, name, result);
+  }
+
+  if (!ambient_values_initialized_) {
+    ambient_values_.reserve(ambient.size());
+    for (const std::string& ambient_name : ambient) {
+      ambient_values_.push_back(AmbientValue{ambient_name});
+    }
+    ambient_values_initialized_ = true;
+  }
+
+  for (AmbientValue& entry : ambient_values_) {
+    if (entry.name != name) {
+      continue;
+    }
+    if (!entry.resolved) {
+      CEL_ASSIGN_OR_RETURN(
+          entry.found,
+          activation_->FindVariable(*value_manager_, name, entry.value));
+      entry.resolved = true;
+    }
+    if (entry.found) {
+      result = entry.value;
+    }
+    return entry.found;
+  }
+
+  return activation_->FindVariable(*value_manager_, name, result);
 }
 
-const ExpressionStep* ExecutionFrame::Next() {
+bool ExecutionFrameBase::CheckDeadlineSlow() {
+  deadline_check_countdown_ = kDeadlineCheckInterval;
+  return absl::Now() < deadline_;
+}
+
+void ExecutionFrame::AccountAllocations(int64_t next_expr_id) {
+  const int64_t space_used =
+      static_cast<int64_t>(tracked_arena_->SpaceUsed());
+  const int64_t delta = space_used - last_space_used_;
+  if (delta > 0 && pending_expr_id_ != kNoPendingExprId) {
+    AllocationReport& report = *state_.allocation_report();
+    report.bytes_by_expr_id[pending_expr_id_] += delta;
+    report.total_bytes += delta;
+  }
+  last_space_used_ = space_used;
+  pending_expr_id_ = next_expr_id;
+}
+
+const ExpressionStep* ExecutionFrame::NextSlow() {
   while (true) {
     const size_t end_pos = execution_path_.size();
 
-    if (ABSL_PREDICT_TRUE(pc_ < end_pos)) {
+    if (pc_ < end_pos) {
       const auto* step = execution_path_[pc_++].get();
       ABSL_ASSUME(step != nullptr);
+      AccountDispatch(*step);
       return step;
     }
     if (ABSL_PREDICT_TRUE(pc_ == end_pos)) {
@@ -87,6 +167,18 @@ const ExpressionStep* ExecutionFrame::Next() {
 
 namespace {
 
+absl::Status CostBudgetExceededError() {
+  return absl::ResourceExhaustedError("Evaluation cost budget exceeded");
+}
+
+absl::Status EvaluationDeadlineExceededError() {
+  return absl::DeadlineExceededError("Evaluation deadline exceeded");
+}
+
+absl::Status MemoryLimitExceededError() {
+  return absl::ResourceExhaustedError("Evaluation memory limit exceeded");
+}
+
 // This class abuses the fact that `absl::Status` is trivially destructible when
 // `absl::Status::ok()` is `true`. If the implementation of `absl::Status` every
 // changes, LSan and ASan should catch it. We cannot deal with the cost of extra
@@ -122,24 +214,91 @@ class EvaluationStatus final {
 
 }  // namespace
 
-absl::StatusOr<cel::Value> ExecutionFrame::Evaluate(
-    EvaluationListener& listener) {
+absl::StatusOr<absl::optional<cel::Value>>
+ExecutionFrame::EvaluateUntilSuspension(EvaluationListener& listener) {
   const size_t initial_stack_size = value_stack().size();
 
   if (!listener) {
-    for (const ExpressionStep* expr = Next();
-         ABSL_PREDICT_TRUE(expr != nullptr); expr = Next()) {
-      if (EvaluationStatus status(expr->Evaluate(this)); !status.ok()) {
-        return std::move(status).Consume();
+    if (ABSL_PREDICT_FALSE(EvaluationProfiler::IsEnabled())) {
+      for (const ExpressionStep* expr = Next();
+           ABSL_PREDICT_TRUE(expr != nullptr); expr = Next()) {
+        if (ABSL_PREDICT_FALSE(cost_budget_enabled()) &&
+            ABSL_PREDICT_FALSE(!ChargeStepCost(*expr))) {
+          return CostBudgetExceededError();
+        }
+        if (ABSL_PREDICT_FALSE(deadline_enabled()) &&
+            ABSL_PREDICT_FALSE(!CheckDeadline())) {
+          return EvaluationDeadlineExceededError();
+        }
+        if (ABSL_PREDICT_FALSE(memory_limit_enabled()) &&
+            ABSL_PREDICT_FALSE(!CheckMemoryLimit())) {
+          return MemoryLimitExceededError();
+        }
+        if (ABSL_PREDICT_FALSE(EvaluationProfiler::ShouldSample())) {
+          const int64_t start_nanos = absl::GetCurrentTimeNanos();
+          if (EvaluationStatus status(expr->Evaluate(this)); !status.ok()) {
+            return std::move(status).Consume();
+          }
+          EvaluationProfiler::Record(expr->id(), expr->GetNativeTypeId(),
+                                     absl::GetCurrentTimeNanos() - start_nanos);
+        } else {
+          if (EvaluationStatus status(expr->Evaluate(this)); !status.ok()) {
+            return std::move(status).Consume();
+          }
+        }
+        if (ABSL_PREDICT_FALSE(async_evaluation_enabled_) &&
+            has_pending_async_call()) {
+          return absl::optional<cel::Value>();
+        }
+      }
+    } else {
+      for (const ExpressionStep* expr = Next();
+           ABSL_PREDICT_TRUE(expr != nullptr); expr = Next()) {
+        if (ABSL_PREDICT_FALSE(cost_budget_enabled()) &&
+            ABSL_PREDICT_FALSE(!ChargeStepCost(*expr))) {
+          return CostBudgetExceededError();
+        }
+        if (ABSL_PREDICT_FALSE(deadline_enabled()) &&
+            ABSL_PREDICT_FALSE(!CheckDeadline())) {
+          return EvaluationDeadlineExceededError();
+        }
+        if (ABSL_PREDICT_FALSE(memory_limit_enabled()) &&
+            ABSL_PREDICT_FALSE(!CheckMemoryLimit())) {
+          return MemoryLimitExceededError();
+        }
+        if (EvaluationStatus status(expr->Evaluate(this)); !status.ok()) {
+          return std::move(status).Consume();
+        }
+        if (ABSL_PREDICT_FALSE(async_evaluation_enabled_) &&
+            has_pending_async_call()) {
+          return absl::optional<cel::Value>();
+        }
       }
     }
   } else {
     for (const ExpressionStep* expr = Next();
          ABSL_PREDICT_TRUE(expr != nullptr); expr = Next()) {
+      if (ABSL_PREDICT_FALSE(cost_budget_enabled()) &&
+          ABSL_PREDICT_FALSE(!ChargeStepCost(*expr))) {
+        return CostBudgetExceededError();
+      }
+      if (ABSL_PREDICT_FALSE(deadline_enabled()) &&
+          ABSL_PREDICT_FALSE(!CheckDeadline())) {
+        return EvaluationDeadlineExceededError();
+      }
+      if (ABSL_PREDICT_FALSE(memory_limit_enabled()) &&
+          ABSL_PREDICT_FALSE(!CheckMemoryLimit())) {
+        return MemoryLimitExceededError();
+      }
       if (EvaluationStatus status(expr->Evaluate(this)); !status.ok()) {
         return std::move(status).Consume();
       }
 
+      if (ABSL_PREDICT_FALSE(async_evaluation_enabled_) &&
+          has_pending_async_call()) {
+        return absl::optional<cel::Value>();
+      }
+
       if (pc_ == 0 || !expr->comes_from_ast()) {
         // Skip if we just started a Call or if the step doesn't map to an
         // AST id.
@@ -167,20 +326,155 @@ absl::StatusOr<cel::Value> ExecutionFrame::Evaluate(
         ", actual=", final_stack_size));
   }
 
+  // Fold in the final result push, which Next() never observes, and the
+  // counters that only become final once the loop exits.
+  EvaluationStats& stats = state_.stats();
+  if (final_stack_size > stats.max_stack_depth) {
+    stats.max_stack_depth = final_stack_size;
+  }
+  stats.comprehension_iterations = iterations_;
+  stats.values_produced =
+      static_cast<int64_t>(value_stack().total_pushes());
+
+  if (ABSL_PREDICT_FALSE(tracked_arena_ != nullptr)) {
+    // Charge the final step, whose allocations Next() never samples.
+    AccountAllocations(kNoPendingExprId);
+  }
+
   cel::Value value = std::move(value_stack().Peek());
   value_stack().Pop(1);
-  return value;
+  return absl::optional<cel::Value>(std::move(value));
+}
+
+// State and rendezvous for one speculatively evaluated branch. The task owns
+// its evaluator state; the launching frame blocks on done before consuming
+// result (or before its own destruction, so the task never outlives the
+// activation).
+struct SpeculativeBranch {
+  SpeculativeBranch(size_t value_stack_size, size_t comprehension_slot_count,
+                    const cel::TypeProvider& type_provider,
+                    cel::MemoryManagerRef memory_manager)
+      : state(value_stack_size, comprehension_slot_count, type_provider,
+              memory_manager) {}
+
+  FlatExpressionEvaluatorState state;
+  absl::Notification done;
+  absl::StatusOr<cel::Value> result =
+      absl::InternalError("speculative branch did not produce a result");
+};
+
+ExecutionFrame::~ExecutionFrame() {
+  while (has_speculative_branches()) {
+    DiscardSpeculativeBranches();
+  }
+}
+
+void ExecutionFrame::LaunchSpeculativeBranches(
+    size_t left_subexpression_index, size_t right_subexpression_index) {
+  const auto& executor = options().speculation_executor;
+  const cel::TypeProvider* type_provider = state_.type_provider();
+  if (executor == nullptr || type_provider == nullptr ||
+      speculation_remaining_ < 2) {
+    return;
+  }
+  speculation_remaining_ -= 2;
+
+  auto launch = [&](size_t index) -> std::shared_ptr<SpeculativeBranch> {
+    ABSL_DCHECK_LT(index, subexpressions_.size());
+    // The branch may call further extracted subexpressions (e.g. lazily
+    // evaluated bindings), so its stack is sized for the whole program, not
+    // just the branch view.
+    auto branch = std::make_shared<SpeculativeBranch>(
+        value_stack().max_size(), comprehension_slots().size(),
+        *type_provider, state_.memory_manager());
+    executor([branch, subexpressions = subexpressions_, index,
+              activation = activation_, options = options_]() {
+      ExecutionFrame frame(subexpressions, *activation, *options,
+                           branch->state);
+      frame.execution_path_ = subexpressions[index];
+      branch->result = frame.Evaluate();
+      branch->done.Notify();
+    });
+    return branch;
+  };
+
+  auto left = launch(left_subexpression_index);
+  auto right = launch(right_subexpression_index);
+  speculative_branches_.emplace_back(std::move(left), std::move(right));
+}
+
+absl::StatusOr<cel::Value> ExecutionFrame::AwaitSpeculativeBranch(
+    bool take_left) {
+  ABSL_DCHECK(has_speculative_branches());
+  auto pair = std::move(speculative_branches_.back());
+  speculative_branches_.pop_back();
+  SpeculativeBranch& winner = take_left ? *pair.first : *pair.second;
+  SpeculativeBranch& loser = take_left ? *pair.second : *pair.first;
+  winner.done.WaitForNotification();
+  absl::StatusOr<cel::Value> result = std::move(winner.result);
+  // There is no cooperative cancellation; the losing branch runs to
+  // completion and its result (or error) is discarded, as it would never
+  // have been evaluated sequentially.
+  loser.done.WaitForNotification();
+  return result;
+}
+
+void ExecutionFrame::DiscardSpeculativeBranches() {
+  ABSL_DCHECK(has_speculative_branches());
+  auto pair = std::move(speculative_branches_.back());
+  speculative_branches_.pop_back();
+  pair.first->done.WaitForNotification();
+  pair.second->done.WaitForNotification();
+}
+
+absl::Status ExecutionFrame::EvaluateSubexpressionInline(
+    size_t subexpression_index) {
+  ABSL_DCHECK_LT(subexpression_index, subexpressions_.size());
+  EvaluationListener listener;
+  if (callback_) {
+    listener = [this](int64_t expr_id, const cel::Value& value,
+                      cel::ValueManager& factory) {
+      return callback_(expr_id, value, factory);
+    };
+  }
+  ExecutionFrame frame(subexpressions_, activation(), options(), state_,
+                       std::move(listener));
+  frame.execution_path_ = subexpressions_[subexpression_index];
+  absl::StatusOr<cel::Value> result = frame.Evaluate();
+  if (!result.ok()) {
+    return result.status();
+  }
+  value_stack().Push(std::move(*result));
+  return absl::OkStatus();
+}
+
+absl::StatusOr<cel::Value> ExecutionFrame::Evaluate(
+    EvaluationListener& listener) {
+  absl::StatusOr<absl::optional<cel::Value>> result =
+      EvaluateUntilSuspension(listener);
+  if (!result.ok()) {
+    return result.status();
+  }
+  if (ABSL_PREDICT_FALSE(!result->has_value())) {
+    // Steps only suspend when async evaluation is enabled, which implies an
+    // asynchronous driver (see FlatExpression::EvaluateAsynchronously).
+    return absl::InternalError(
+        "evaluation suspended without an asynchronous driver");
+  }
+  return std::move(**result);
 }
 
 FlatExpressionEvaluatorState FlatExpression::MakeEvaluatorState(
     cel::MemoryManagerRef manager) const {
-  return FlatExpressionEvaluatorState(path_.size(), comprehension_slots_size_,
+  return FlatExpressionEvaluatorState(value_stack_size_,
+                                      comprehension_slots_size_,
                                       type_provider_, manager);
 }
 
 FlatExpressionEvaluatorState FlatExpression::MakeEvaluatorState(
     cel::ValueManager& value_factory) const {
-  return FlatExpressionEvaluatorState(path_.size(), comprehension_slots_size_,
+  return FlatExpressionEvaluatorState(value_stack_size_,
+                                      comprehension_slots_size_,
                                       value_factory);
 }
 
@@ -195,6 +489,117 @@ absl::StatusOr<cel::Value> FlatExpression::EvaluateWithCallback(
   return frame.Evaluate(frame.callback());
 }
 
+namespace {
+
+// Drives one asynchronous evaluation: runs the execution frame until it
+// suspends on an asynchronous call, starts the call, and resumes on whichever
+// thread completes it. Self-owned; deletes itself after invoking on_done.
+class AsyncEvaluationDriver final {
+ public:
+  AsyncEvaluationDriver(absl::Span<const ExecutionPathView> subexpressions,
+                        const cel::ActivationInterface& activation,
+                        const cel::RuntimeOptions& options,
+                        FlatExpressionEvaluatorState& state,
+                        EvaluationListener listener,
+                        FlatExpression::AsyncEvaluationDone on_done)
+      : frame_(subexpressions, activation, options, state,
+               std::move(listener)),
+        on_done_(std::move(on_done)) {
+    frame_.enable_async_evaluation();
+  }
+
+  // Runs the frame until completion or until an asynchronous call is left in
+  // flight, in which case the call's completion thread takes over.
+  void Drive() {
+    while (true) {
+      absl::StatusOr<absl::optional<cel::Value>> result =
+          frame_.EvaluateUntilSuspension(frame_.callback());
+      if (!result.ok()) {
+        Finish(result.status());
+        return;
+      }
+      if (result->has_value()) {
+        Finish(std::move(**result));
+        return;
+      }
+
+      ExecutionFrame::PendingAsyncCall call = frame_.TakePendingAsyncCall();
+
+      // Handshake deciding which thread continues: the done callback stores
+      // the result, then whoever flips the flag second resumes evaluation.
+      // This keeps inline completions on the calling thread without
+      // recursing, and hands deferred completions to the completing thread.
+      auto handoff = std::make_shared<Handoff>();
+      handoff->on_resume = std::move(call.on_resume);
+      std::move(call.start)(
+          [this, handoff](absl::StatusOr<cel::Value> value) mutable {
+            handoff->result.emplace(std::move(value));
+            if (handoff->flag.exchange(true, std::memory_order_acq_rel)) {
+              // Drive() already returned; resume on this thread.
+              Resume(std::move(handoff));
+            }
+          });
+      if (!handoff->flag.exchange(true, std::memory_order_acq_rel)) {
+        // The call is still in flight; its completion resumes evaluation.
+        return;
+      }
+      // The call completed inline; apply the result and keep driving.
+      if (!ApplyResult(*handoff)) {
+        return;
+      }
+    }
+  }
+
+ private:
+  struct Handoff {
+    std::atomic<bool> flag{false};
+    absl::optional<absl::StatusOr<cel::Value>> result;
+    absl::AnyInvocable<absl::Status(ExecutionFrame&,
+                                    absl::StatusOr<cel::Value>) &&>
+        on_resume;
+  };
+
+  // Applies a completed call's result to the frame. Returns false if the
+  // evaluation was finished (with an error) in the process.
+  bool ApplyResult(Handoff& handoff) {
+    if (absl::Status status =
+            std::move(handoff.on_resume)(frame_, std::move(*handoff.result));
+        !status.ok()) {
+      Finish(std::move(status));
+      return false;
+    }
+    return true;
+  }
+
+  void Resume(std::shared_ptr<Handoff> handoff) {
+    if (ApplyResult(*handoff)) {
+      Drive();
+    }
+  }
+
+  void Finish(absl::StatusOr<cel::Value> result) {
+    FlatExpression::AsyncEvaluationDone on_done = std::move(on_done_);
+    delete this;
+    std::move(on_done)(std::move(result));
+  }
+
+  ExecutionFrame frame_;
+  FlatExpression::AsyncEvaluationDone on_done_;
+};
+
+}  // namespace
+
+void FlatExpression::EvaluateAsynchronously(
+    const cel::ActivationInterface& activation, EvaluationListener listener,
+    FlatExpressionEvaluatorState& state, AsyncEvaluationDone on_done) const {
+  state.Reset();
+
+  auto* driver =
+      new AsyncEvaluationDriver(subexpressions_, activation, options_, state,
+                                std::move(listener), std::move(on_done));
+  driver->Drive();
+}
+
 cel::ManagedValueFactory FlatExpression::MakeValueFactory(
     cel::MemoryManagerRef memory_manager) const {
   return cel::ManagedValueFactory(type_provider_, memory_manager);
@@ -23,13 +23,20 @@
 #include <vector>
 
 #include "absl/base/nullability.h"
+#include "absl/base/optimization.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
+#include "base/async_function.h"
 #include "base/type_provider.h"
 #include "common/memory.h"
 #include "common/native_type.h"
@@ -40,10 +47,13 @@
 #include "eval/eval/attribute_utility.h"
 #include "eval/eval/comprehension_slots.h"
 #include "eval/eval/evaluator_stack.h"
+#include "eval/eval/plan_arena.h"
 #include "runtime/activation_interface.h"
 #include "runtime/managed_value_factory.h"
+#include "runtime/slot_activation.h"
 #include "runtime/runtime.h"
 #include "runtime/runtime_options.h"
+#include "google/protobuf/arena.h"
 
 namespace google::api::expr::runtime {
 
@@ -63,6 +73,19 @@ class ExpressionStep {
 
   virtual ~ExpressionStep() = default;
 
+  // Steps constructed inside a PlanArenaScope are pooled into that plan's
+  // arena so one program's steps are contiguous in memory; otherwise these
+  // fall back to the global heap. See eval/eval/plan_arena.h.
+  static void* operator new(size_t size) {
+    return plan_arena_internal::AllocateStep(size);
+  }
+  static void operator delete(void* ptr) noexcept {
+    plan_arena_internal::DeallocateStep(ptr);
+  }
+  static void operator delete(void* ptr, size_t) noexcept {
+    plan_arena_internal::DeallocateStep(ptr);
+  }
+
   // Performs actual evaluation.
   // Values are passed between Expression objects via EvaluatorStack, which is
   // supplied with context.
@@ -90,6 +113,12 @@ class ExpressionStep {
     return cel::NativeTypeId();
   }
 
+  // Relative cost charged against RuntimeOptions::evaluation_cost_budget each
+  // time this step is dispatched. Steps that do significantly more work per
+  // dispatch (function calls, container construction) override this. Only
+  // consulted when the budget is enabled.
+  virtual int64_t Cost() const { return 1; }
+
  private:
   const int64_t id_;
   const bool comes_from_ast_;
@@ -99,6 +128,53 @@ using ExecutionPath = std::vector<std::unique_ptr<const ExpressionStep>>;
 using ExecutionPathView =
     absl::Span<const std::unique_ptr<const ExpressionStep>>;
 
+// Lightweight counters accumulated by the stack machine during a single
+// evaluation with plain increments (no tracing callbacks). Reset together
+// with the evaluator state, so they describe the most recent evaluation and
+// can be read after Evaluate() returns, e.g. to export per-program cost
+// metrics from a serving layer.
+struct EvaluationStats {
+  // Number of steps dispatched.
+  int64_t dispatch_count = 0;
+  // High-water mark of the value stack.
+  size_t max_stack_depth = 0;
+  // Comprehension iterations performed. Always zero when
+  // RuntimeOptions::comprehension_max_iterations is 0, since iteration
+  // accounting is disabled along with the budget.
+  int64_t comprehension_iterations = 0;
+  // Number of values materialized on the value stack (each step result is
+  // pushed exactly once).
+  int64_t values_produced = 0;
+  // Total step cost charged (see ExpressionStep::Cost()). Always zero when
+  // RuntimeOptions::evaluation_cost_budget is 0, since cost accounting is
+  // disabled along with the budget.
+  int64_t cost_consumed = 0;
+};
+
+// Heap attribution by expression id for the most recent evaluation using a
+// state, collected when FlatExpressionEvaluatorState::EnableAllocationTracking
+// was called.
+//
+// Attribution works by sampling the pooling arena's SpaceUsed() between
+// dispatched steps: growth observed at a sample is charged to the expression
+// id of the step dispatched since the previous sample. Arena space is never
+// returned mid-evaluation, so the deltas are monotone and sum to the arena
+// growth over the whole evaluation. Values allocated by a step but only
+// consumed later (e.g. list elements accumulated by a comprehension) are
+// charged to the allocating step, which is the attribution one wants when
+// hunting for the subexpression that bloats memory.
+//
+// Only arena-backed (pooling) memory managers can be observed this way;
+// with a reference-counting memory manager no report is collected.
+struct AllocationReport {
+  // Arena bytes attributed to each expression id. An entry is present only
+  // for ids whose steps were observed to allocate; id 0 collects steps
+  // without an AST id (e.g. jumps).
+  absl::flat_hash_map<int64_t, int64_t> bytes_by_expr_id;
+  // Sum of all attributed bytes.
+  int64_t total_bytes = 0;
+};
+
 // Class that wraps the state that needs to be allocated for expression
 // evaluation. This can be reused to save on allocations.
 class FlatExpressionEvaluatorState {
@@ -114,14 +190,39 @@ class FlatExpressionEvaluatorState {
 
   void Reset();
 
+  // Rebind this state to a new program shape and value factory, retaining
+  // allocated storage (value stack, comprehension slots) where possible.
+  // Used by pooled states that are shared across programs.
+  void Rebind(size_t value_stack_size, size_t comprehension_slot_count,
+              cel::ValueManager& value_factory);
+
   EvaluatorStack& value_stack() { return value_stack_; }
 
-  ComprehensionSlots& comprehension_slots() { return comprehension_slots_; }
+  ComprehensionSlots& comprehension_slots() {
+    return borrowed_slots_ != nullptr ? *borrowed_slots_
+                                      : comprehension_slots_;
+  }
+
+  // Redirects comprehension slot access to an externally owned instance,
+  // typically a frame pushed on the shared per-thread buffer (see
+  // ComprehensionSlots::PushFrame). The caller owns `slots` and must keep it
+  // alive (and its frame pushed) for as long as this state uses it; pass
+  // nullptr to return to the state's own storage.
+  void BorrowComprehensionSlots(ComprehensionSlots* slots) {
+    borrowed_slots_ = slots;
+  }
 
   cel::MemoryManagerRef memory_manager() {
     return value_factory_->GetMemoryManager();
   }
 
+  // Type provider this state was created against, or nullptr for states
+  // constructed around an existing value factory. Needed to mint additional
+  // thread-local states for speculative branch evaluation.
+  absl::Nullable<const cel::TypeProvider*> type_provider() const {
+    return type_provider_;
+  }
+
   cel::TypeFactory& type_factory() { return *value_factory_; }
 
   cel::TypeManager& type_manager() { return *value_factory_; }
@@ -130,31 +231,86 @@ class FlatExpressionEvaluatorState {
 
   cel::ValueManager& value_manager() { return *value_factory_; }
 
+  // Counters describing the most recent (or in-progress) evaluation using
+  // this state.
+  EvaluationStats& stats() { return stats_; }
+  const EvaluationStats& stats() const { return stats_; }
+
+  // Enables heap attribution by expression id for subsequent evaluations
+  // using this state (see AllocationReport). Sampling the arena once per
+  // dispatch is comparatively expensive, so this is meant for offline
+  // analysis rather than production serving; when never enabled the cost is
+  // a single predicted-false branch per dispatch. Reset() clears collected
+  // attribution but keeps tracking enabled; Rebind() disables it.
+  void EnableAllocationTracking() { allocation_report_.emplace(); }
+
+  // Heap attribution collected by the most recent (or in-progress)
+  // evaluation, or nullptr if EnableAllocationTracking was not called. Empty
+  // when the memory manager is not arena-backed.
+  absl::Nullable<AllocationReport*> allocation_report() {
+    return allocation_report_.has_value() ? &*allocation_report_ : nullptr;
+  }
+  absl::Nullable<const AllocationReport*> allocation_report() const {
+    return allocation_report_.has_value() ? &*allocation_report_ : nullptr;
+  }
+
  private:
   EvaluatorStack value_stack_;
   ComprehensionSlots comprehension_slots_;
+  ComprehensionSlots* borrowed_slots_ = nullptr;
+  EvaluationStats stats_;
+  absl::optional<AllocationReport> allocation_report_;
   absl::optional<cel::ManagedValueFactory> managed_value_factory_;
   cel::ValueManager* value_factory_;
+  absl::Nullable<const cel::TypeProvider*> type_provider_ = nullptr;
 };
 
+// A speculatively launched branch evaluation (see
+// ExecutionFrame::LaunchSpeculativeBranches). Defined in the implementation
+// file; callers only pass around ownership.
+struct SpeculativeBranch;
+
 // Context needed for evaluation. This is sufficient for supporting
 // recursive evaluation, but stack machine programs require an
 // ExecutionFrame instance for managing a heap-backed stack.
 class ExecutionFrameBase {
  public:
+  // Number of dispatched steps (or comprehension iterations) between
+  // wall-clock reads when an evaluation deadline is set
+  // (RuntimeOptions::evaluation_timeout).
+  static constexpr int kDeadlineCheckInterval = 64;
+
   // Overload for test usages.
   ExecutionFrameBase(const cel::ActivationInterface& activation,
                      const cel::RuntimeOptions& options,
                      cel::ValueManager& value_manager)
       : activation_(&activation),
         callback_(),
+        tracing_enabled_(false),
         options_(&options),
+        attribute_tracking_enabled_(AttributeTrackingEnabled(options)),
+        missing_attribute_errors_enabled_(
+            options.enable_missing_attribute_errors),
+        unknown_processing_enabled_(
+            options.unknown_processing !=
+            cel::UnknownProcessingOptions::kDisabled),
+        unknown_function_results_enabled_(
+            options.unknown_processing ==
+            cel::UnknownProcessingOptions::kAttributeAndFunction),
         value_manager_(&value_manager),
         attribute_utility_(activation.GetUnknownAttributes(),
-                           activation.GetMissingAttributes(), value_manager),
+                           activation.GetMissingAttributes(),
+                           activation.GetUnknownAttributesIndex(),
+                           activation.GetMissingAttributesIndex(),
+                           value_manager),
         slots_(&ComprehensionSlots::GetEmptyInstance()),
         max_iterations_(options.comprehension_max_iterations),
-        iterations_(0) {}
+        iterations_(0),
+        deadline_enabled_(options.evaluation_timeout > absl::ZeroDuration()),
+        deadline_(deadline_enabled_
+                      ? absl::Now() + options.evaluation_timeout
+                      : absl::InfiniteFuture()),
+        deadline_check_countdown_(kDeadlineCheckInterval) {}
 
   ExecutionFrameBase(const cel::ActivationInterface& activation,
                      EvaluationListener callback,
@@ -163,18 +319,42 @@ class ExecutionFrameBase {
                      ComprehensionSlots& slots)
       : activation_(&activation),
         callback_(std::move(callback)),
+        tracing_enabled_(static_cast<bool>(callback_)),
         options_(&options),
+        attribute_tracking_enabled_(AttributeTrackingEnabled(options)),
+        missing_attribute_errors_enabled_(
+            options.enable_missing_attribute_errors),
+        unknown_processing_enabled_(
+            options.unknown_processing !=
+            cel::UnknownProcessingOptions::kDisabled),
+        unknown_function_results_enabled_(
+            options.unknown_processing ==
+            cel::UnknownProcessingOptions::kAttributeAndFunction),
         value_manager_(&value_manager),
         attribute_utility_(activation.GetUnknownAttributes(),
-                           activation.GetMissingAttributes(), value_manager),
+                           activation.GetMissingAttributes(),
+                           activation.GetUnknownAttributesIndex(),
+                           activation.GetMissingAttributesIndex(),
+                           value_manager),
         slots_(&slots),
         max_iterations_(options.comprehension_max_iterations),
-        iterations_(0) {}
+        iterations_(0),
+        deadline_enabled_(options.evaluation_timeout > absl::ZeroDuration()),
+        deadline_(deadline_enabled_
+                      ? absl::Now() + options.evaluation_timeout
+                      : absl::InfiniteFuture()),
+        deadline_check_countdown_(kDeadlineCheckInterval) {}
 
   const cel::ActivationInterface& activation() const { return *activation_; }
 
   EvaluationListener& callback() { return callback_; }
 
+  // True if a listener was installed for this evaluation. Computed once at
+  // frame construction so per-node tracing decorators (see
+  // eval/eval/trace_step.h) pay a single predicted branch, not a listener
+  // inspection, when tracing is off.
+  bool tracing_enabled() const { return tracing_enabled_; }
+
   const cel::RuntimeOptions& options() const { return *options_; }
 
   cel::ValueManager& value_manager() { return *value_manager_; }
@@ -183,31 +363,60 @@ class ExecutionFrameBase {
     return attribute_utility_;
   }
 
+  // The attribute tracking flags are derived from the options once at frame
+  // construction, like tracing_enabled(): steps consult them on nearly every
+  // dispatch, and a member load with a predicted branch is cheaper than
+  // re-deriving the answer from RuntimeOptions through a pointer each time.
   bool attribute_tracking_enabled() const {
-    return options_->unknown_processing !=
-               cel::UnknownProcessingOptions::kDisabled ||
-           options_->enable_missing_attribute_errors;
+    return attribute_tracking_enabled_;
   }
 
   bool missing_attribute_errors_enabled() const {
-    return options_->enable_missing_attribute_errors;
+    return missing_attribute_errors_enabled_;
   }
 
   bool unknown_processing_enabled() const {
-    return options_->unknown_processing !=
-           cel::UnknownProcessingOptions::kDisabled;
+    return unknown_processing_enabled_;
   }
 
   bool unknown_function_results_enabled() const {
-    return options_->unknown_processing ==
-           cel::UnknownProcessingOptions::kAttributeAndFunction;
+    return unknown_function_results_enabled_;
   }
 
   ComprehensionSlots& comprehension_slots() { return *slots_; }
 
+  // Resolves a variable through the activation, consulting the
+  // per-evaluation snapshot of ambient variables
+  // (RuntimeOptions::ambient_variables) first.
+  //
+  // The first reference to an ambient variable in an evaluation resolves
+  // through the activation as usual; the result — including absence — is
+  // pinned for the remainder of the evaluation, so repeated references see
+  // a consistent value and activation value providers (e.g. a clock read
+  // behind `now`) run at most once per evaluation.
+  absl::StatusOr<bool> ResolveVariable(absl::string_view name,
+                                       cel::Value& result);
+
+  // True if RuntimeOptions::evaluation_timeout is set for this evaluation.
+  bool deadline_enabled() const { return deadline_enabled_; }
+
+  // Cooperative deadline check, amortized over kDeadlineCheckInterval calls:
+  // most calls only decrement a countdown, and the clock is read when it
+  // reaches zero. Returns false once the deadline has passed. Only
+  // meaningful when deadline_enabled().
+  bool CheckDeadline() {
+    if (ABSL_PREDICT_TRUE(--deadline_check_countdown_ > 0)) {
+      return true;
+    }
+    return CheckDeadlineSlow();
+  }
+
   // Increment iterations and return an error if the iteration budget is
   // exceeded
   absl::Status IncrementIterations() {
+    if (ABSL_PREDICT_FALSE(deadline_enabled_) && !CheckDeadline()) {
+      return absl::DeadlineExceededError("Evaluation deadline exceeded");
+    }
     if (max_iterations_ == 0) {
       return absl::OkStatus();
     }
@@ -220,14 +429,43 @@ class ExecutionFrameBase {
   }
 
  protected:
+  // Per-evaluation snapshot entry for one ambient variable. `name` points
+  // into RuntimeOptions::ambient_variables, which outlives the frame.
+  struct AmbientValue {
+    absl::string_view name;
+    bool resolved = false;
+    bool found = false;
+    cel::Value value;
+  };
+
+  static bool AttributeTrackingEnabled(const cel::RuntimeOptions& options) {
+    return options.unknown_processing !=
+               cel::UnknownProcessingOptions::kDisabled ||
+           options.enable_missing_attribute_errors;
+  }
+
   absl::Nonnull<const cel::ActivationInterface*> activation_;
   EvaluationListener callback_;
+  const bool tracing_enabled_;
   absl::Nonnull<const cel::RuntimeOptions*> options_;
+  const bool attribute_tracking_enabled_;
+  const bool missing_attribute_errors_enabled_;
+  const bool unknown_processing_enabled_;
+  const bool unknown_function_results_enabled_;
   absl::Nonnull<cel::ValueManager*> value_manager_;
   AttributeUtility attribute_utility_;
   absl::Nonnull<ComprehensionSlots*> slots_;
   const int max_iterations_;
   int iterations_;
+  const bool deadline_enabled_;
+  const absl::Time deadline_;
+  int deadline_check_countdown_;
+  absl::InlinedVector<AmbientValue, 2> ambient_values_;
+  bool ambient_values_initialized_ = false;
+
+ private:
+  // Slow path of CheckDeadline(): resets the countdown and reads the clock.
+  bool CheckDeadlineSlow();
 };
 
 // ExecutionFrame manages the context needed for expression evaluation.
@@ -249,7 +487,15 @@ class ExecutionFrame : public ExecutionFrameBase {
         pc_(0UL),
         execution_path_(flat),
         state_(state),
-        subexpressions_() {}
+        subexpressions_(),
+        cost_budget_enabled_(options.evaluation_cost_budget > 0),
+        cost_remaining_(options.evaluation_cost_budget),
+        speculation_remaining_(options.speculation_executor == nullptr
+                                   ? 0
+                                   : options.max_speculative_branches) {
+    InitAllocationTracking();
+    InitMemoryLimit(options);
+  }
 
   ExecutionFrame(absl::Span<const ExecutionPathView> subexpressions,
                  const cel::ActivationInterface& activation,
@@ -261,18 +507,123 @@ class ExecutionFrame : public ExecutionFrameBase {
         pc_(0UL),
         execution_path_(subexpressions[0]),
         state_(state),
-        subexpressions_(subexpressions) {
+        subexpressions_(subexpressions),
+        cost_budget_enabled_(options.evaluation_cost_budget > 0),
+        cost_remaining_(options.evaluation_cost_budget),
+        speculation_remaining_(options.speculation_executor == nullptr
+                                   ? 0
+                                   : options.max_speculative_branches) {
     ABSL_DCHECK(!subexpressions.empty());
+    InitAllocationTracking();
+    InitMemoryLimit(options);
   }
 
+  // Awaits any speculative branches still outstanding, e.g. after an aborted
+  // evaluation, since they reference the activation and options.
+  ~ExecutionFrame();
+
   // Returns next expression to evaluate.
-  const ExpressionStep* Next();
+  //
+  // The in-bounds program counter increment is inlined so that the dispatch
+  // loop pays only the virtual call per step; returning from subexpression
+  // frames and running off the end of the path are handled out of line.
+  const ExpressionStep* Next() {
+    if (ABSL_PREDICT_TRUE(pc_ < execution_path_.size())) {
+      const auto* step = execution_path_[pc_++].get();
+      ABSL_ASSUME(step != nullptr);
+      AccountDispatch(*step);
+      return step;
+    }
+    return NextSlow();
+  }
 
   // Evaluate the execution frame to completion.
   absl::StatusOr<cel::Value> Evaluate(EvaluationListener& listener);
   // Evaluate the execution frame to completion.
   absl::StatusOr<cel::Value> Evaluate() { return Evaluate(callback()); }
 
+  // Evaluate the execution frame until it completes or suspends for an
+  // asynchronous call (see SuspendForAsyncCall). Returns nullopt when
+  // suspended; the pending call must then be taken and started by an
+  // asynchronous driver, which re-enters this method once the call's result
+  // has been applied. Suspension only occurs when async evaluation is
+  // enabled.
+  absl::StatusOr<absl::optional<cel::Value>> EvaluateUntilSuspension(
+      EvaluationListener& listener);
+
+  // An asynchronous call the frame has suspended on.
+  struct PendingAsyncCall {
+    // Starts the call. Invoked exactly once by the asynchronous driver after
+    // the frame is quiescent; the done callback may run inline or later from
+    // another thread.
+    absl::AnyInvocable<void(cel::AsyncFunction::DoneCallback) &&> start;
+    // Applies the completed call's result to the frame (result conversion
+    // and value stack update), mirroring what the suspending step does
+    // inline in the synchronous case. Run with the frame quiescent; a non-OK
+    // status aborts the evaluation.
+    absl::AnyInvocable<absl::Status(ExecutionFrame&,
+                                    absl::StatusOr<cel::Value>) &&>
+        on_resume;
+  };
+
+  // True if an asynchronous driver is running this frame, allowing steps to
+  // suspend instead of blocking on asynchronous functions.
+  bool async_evaluation_enabled() const { return async_evaluation_enabled_; }
+
+  // Enables suspension for asynchronous calls. Called by the asynchronous
+  // evaluation driver before the first step runs.
+  void enable_async_evaluation() { async_evaluation_enabled_ = true; }
+
+  bool has_pending_async_call() const {
+    return pending_async_call_.has_value();
+  }
+
+  // Records the asynchronous call to suspend on. The calling step must leave
+  // the value stack untouched (the call's on_resume updates it on
+  // completion). Requires async evaluation to be enabled and no other call
+  // pending.
+  void SuspendForAsyncCall(PendingAsyncCall call) {
+    ABSL_DCHECK(async_evaluation_enabled_);
+    ABSL_DCHECK(!pending_async_call_.has_value());
+    pending_async_call_.emplace(std::move(call));
+  }
+
+  // Relinquishes the pending asynchronous call to the driver.
+  PendingAsyncCall TakePendingAsyncCall() {
+    ABSL_DCHECK(pending_async_call_.has_value());
+    PendingAsyncCall call = std::move(*pending_async_call_);
+    pending_async_call_.reset();
+    return call;
+  }
+
+  // Starts speculative evaluation of two branch subexpressions on the
+  // configured speculation executor (see
+  // RuntimeOptions::speculation_executor), each against its own evaluator
+  // state. No-op when speculation is unavailable (no executor, no type
+  // provider on the state, or the per-evaluation budget is exhausted); the
+  // matching ternary join then falls back to sequential evaluation.
+  void LaunchSpeculativeBranches(size_t left_subexpression_index,
+                                 size_t right_subexpression_index);
+
+  // True if a speculative branch pair is outstanding. Launches and joins
+  // nest, so the innermost outstanding pair is always the one to consume.
+  bool has_speculative_branches() const {
+    return !speculative_branches_.empty();
+  }
+
+  // Blocks for the winning branch of the innermost outstanding pair and
+  // returns its result; the losing branch is awaited and discarded.
+  absl::StatusOr<cel::Value> AwaitSpeculativeBranch(bool take_left);
+
+  // Awaits and discards both branches of the innermost outstanding pair,
+  // e.g. when the condition evaluated to an error.
+  void DiscardSpeculativeBranches();
+
+  // Evaluates the given subexpression inline on this frame's state, pushing
+  // its result onto the value stack. Sequential fallback for ternary joins
+  // whose branches were not speculatively launched.
+  absl::Status EvaluateSubexpressionInline(size_t subexpression_index);
+
   // Intended for use in builtin shortcutting operations.
   //
   // Offset applies after normal pc increment. For example, JumpTo(0) is a
@@ -333,6 +684,23 @@ class ExecutionFrame : public ExecutionFrameBase {
     return options().enable_comprehension_list_append;
   }
 
+  // Buffered run of iteration-range elements for an in-flight comprehension
+  // loop, keyed by the loop's iterator slot (unique among simultaneously
+  // active comprehensions). Lets ComprehensionNextStep fetch range elements
+  // in chunks (one ListValue::GetChunk dispatch per run) instead of one
+  // virtual call per element. The consuming step resets the chunk at
+  // iteration zero, so a later comprehension reusing the slot cannot observe
+  // stale elements.
+  struct IterationChunk {
+    // Iteration-range index of values[0].
+    size_t begin = 0;
+    std::vector<cel::Value> values;
+  };
+
+  IterationChunk& iteration_chunk(size_t iter_slot) {
+    return iteration_chunks_[iter_slot];
+  }
+
   cel::MemoryManagerRef memory_manager() { return state_.memory_manager(); }
 
   cel::TypeFactory& type_factory() { return state_.type_factory(); }
@@ -346,7 +714,88 @@ class ExecutionFrame : public ExecutionFrameBase {
     return *activation_;
   }
 
+  // True if RuntimeOptions::evaluation_cost_budget is enabled for this
+  // evaluation.
+  bool cost_budget_enabled() const { return cost_budget_enabled_; }
+
+  // Charges the step's cost against the evaluation budget, returning false
+  // once the budget is exhausted. Only called when the budget is enabled.
+  bool ChargeStepCost(const ExpressionStep& step) {
+    const int64_t cost = step.Cost();
+    state_.stats().cost_consumed += cost;
+    cost_remaining_ -= cost;
+    return cost_remaining_ >= 0;
+  }
+
+  // True if RuntimeOptions::evaluation_memory_limit_bytes is enforced for
+  // this evaluation: the limit is set and the memory manager is
+  // arena-backed.
+  bool memory_limit_enabled() const { return memory_limit_arena_ != nullptr; }
+
+  // Returns false once arena block space allocated since the start of the
+  // evaluation exceeds the limit. Block granularity keeps the check to a
+  // walk of the arena's block list, with no per-object accounting. Only
+  // called when memory_limit_enabled().
+  bool CheckMemoryLimit() const {
+    return static_cast<int64_t>(memory_limit_arena_->SpaceAllocated()) <=
+           memory_limit_threshold_;
+  }
+
  private:
+  // Slow path of Next(): pops subexpression frames until a step is available
+  // or the outermost path is exhausted.
+  const ExpressionStep* NextSlow();
+
+  // Per-dispatch stats accounting, called once per step returned by Next().
+  // The stack depth observed here is the depth before the step runs; the
+  // final result push is folded in when Evaluate() completes.
+  void AccountDispatch(const ExpressionStep& step) {
+    EvaluationStats& stats = state_.stats();
+    ++stats.dispatch_count;
+    const size_t depth = state_.value_stack().size();
+    if (depth > stats.max_stack_depth) {
+      stats.max_stack_depth = depth;
+    }
+    if (ABSL_PREDICT_FALSE(tracked_arena_ != nullptr)) {
+      AccountAllocations(step.id());
+    }
+  }
+
+  // Begins arena sampling if the state has allocation tracking enabled and
+  // the memory manager is arena-backed (see AllocationReport).
+  void InitAllocationTracking() {
+    if (ABSL_PREDICT_TRUE(state_.allocation_report() == nullptr)) {
+      return;
+    }
+    tracked_arena_ = state_.memory_manager().arena();
+    if (tracked_arena_ != nullptr) {
+      last_space_used_ = static_cast<int64_t>(tracked_arena_->SpaceUsed());
+    }
+  }
+
+  // Charges arena growth since the previous sample to the previously
+  // dispatched step and remembers `next_expr_id` for the next sample. Pass
+  // kNoPendingExprId when no further step will run (end of evaluation).
+  void AccountAllocations(int64_t next_expr_id);
+
+  // Captures the arena baseline for the per-evaluation memory limit (see
+  // RuntimeOptions::evaluation_memory_limit_bytes). Only arena-backed memory
+  // managers can be bounded this way; otherwise the limit stays disabled for
+  // this evaluation.
+  void InitMemoryLimit(const cel::RuntimeOptions& options) {
+    if (ABSL_PREDICT_TRUE(options.evaluation_memory_limit_bytes <= 0)) {
+      return;
+    }
+    memory_limit_arena_ = state_.memory_manager().arena();
+    if (memory_limit_arena_ != nullptr) {
+      memory_limit_threshold_ =
+          static_cast<int64_t>(memory_limit_arena_->SpaceAllocated()) +
+          options.evaluation_memory_limit_bytes;
+    }
+  }
+
+  static constexpr int64_t kNoPendingExprId = -1;
+
   struct SubFrame {
     size_t return_pc;
     size_t slot_index;
@@ -358,7 +807,25 @@ class ExecutionFrame : public ExecutionFrameBase {
   ExecutionPathView execution_path_;
   FlatExpressionEvaluatorState& state_;
   absl::Span<const ExecutionPathView> subexpressions_;
+  const bool cost_budget_enabled_;
+  int64_t cost_remaining_;
+  // Arena sampled for allocation tracking, or nullptr when tracking is
+  // disabled or the memory manager is not arena-backed.
+  absl::Nullable<google::protobuf::Arena*> tracked_arena_ = nullptr;
+  // Arena checked against the per-evaluation memory limit, or nullptr when
+  // the limit is disabled or the memory manager is not arena-backed.
+  absl::Nullable<google::protobuf::Arena*> memory_limit_arena_ = nullptr;
+  int64_t memory_limit_threshold_ = 0;
+  int64_t last_space_used_ = 0;
+  int64_t pending_expr_id_ = kNoPendingExprId;
+  bool async_evaluation_enabled_ = false;
+  absl::optional<PendingAsyncCall> pending_async_call_;
+  int speculation_remaining_;
+  std::vector<std::pair<std::shared_ptr<SpeculativeBranch>,
+                        std::shared_ptr<SpeculativeBranch>>>
+      speculative_branches_;
   std::vector<SubFrame> call_stack_;
+  absl::flat_hash_map<size_t, IterationChunk> iteration_chunks_;
 };
 
 // A flattened representation of the input CEL AST.
@@ -370,9 +837,10 @@ class FlatExpression {
   FlatExpression(ExecutionPath path, size_t comprehension_slots_size,
                  const cel::TypeProvider& type_provider,
                  const cel::RuntimeOptions& options)
-      : path_(std::move(path)),
-        subexpressions_({path_}),
+      : path_(std::make_shared<const ExecutionPath>(std::move(path))),
+        subexpressions_({*path_}),
         comprehension_slots_size_(comprehension_slots_size),
+        value_stack_size_(path_->size()),
         type_provider_(type_provider),
         options_(options) {}
 
@@ -380,12 +848,34 @@ class FlatExpression {
                  std::vector<ExecutionPathView> subexpressions,
                  size_t comprehension_slots_size,
                  const cel::TypeProvider& type_provider,
-                 const cel::RuntimeOptions& options)
+                 const cel::RuntimeOptions& options,
+                 std::shared_ptr<const cel::VariableBindingPlan>
+                     variable_binding_plan = nullptr)
+      : path_(std::make_shared<const ExecutionPath>(std::move(path))),
+        subexpressions_(std::move(subexpressions)),
+        comprehension_slots_size_(comprehension_slots_size),
+        value_stack_size_(path_->size()),
+        type_provider_(type_provider),
+        options_(options),
+        variable_binding_plan_(std::move(variable_binding_plan)) {}
+
+  // Constructs an expression over an execution path shared with other
+  // expression instances (e.g. from the builder's plan cache). subexpressions
+  // must be views into *path.
+  FlatExpression(std::shared_ptr<const ExecutionPath> path,
+                 std::vector<ExecutionPathView> subexpressions,
+                 size_t comprehension_slots_size,
+                 const cel::TypeProvider& type_provider,
+                 const cel::RuntimeOptions& options,
+                 std::shared_ptr<const cel::VariableBindingPlan>
+                     variable_binding_plan = nullptr)
       : path_(std::move(path)),
         subexpressions_(std::move(subexpressions)),
         comprehension_slots_size_(comprehension_slots_size),
+        value_stack_size_(path_->size()),
         type_provider_(type_provider),
-        options_(options) {}
+        options_(options),
+        variable_binding_plan_(std::move(variable_binding_plan)) {}
 
   // Move-only
   FlatExpression(FlatExpression&&) = default;
@@ -410,10 +900,29 @@ class FlatExpression {
       const cel::ActivationInterface& activation, EvaluationListener listener,
       FlatExpressionEvaluatorState& state) const;
 
+  // Receives the final result of an asynchronous evaluation. Invoked exactly
+  // once, possibly inline from EvaluateAsynchronously.
+  using AsyncEvaluationDone =
+      absl::AnyInvocable<void(absl::StatusOr<cel::Value>) &&>;
+
+  // Evaluate the expression without parking the calling thread on
+  // asynchronous extension functions (cel::AsyncFunction), so one thread can
+  // drive many in-flight evaluations.
+  //
+  // Evaluation runs on the calling thread until the first asynchronous call
+  // is left in flight, then continues on whichever thread completes each
+  // call. Synchronous functions and wholly synchronous expressions complete
+  // inline. activation and state must remain valid, and state must not be
+  // used for another evaluation, until on_done has been invoked.
+  void EvaluateAsynchronously(const cel::ActivationInterface& activation,
+                              EvaluationListener listener,
+                              FlatExpressionEvaluatorState& state,
+                              AsyncEvaluationDone on_done) const;
+
   cel::ManagedValueFactory MakeValueFactory(
       cel::MemoryManagerRef memory_manager) const;
 
-  const ExecutionPath& path() const { return path_; }
+  const ExecutionPath& path() const { return *path_; }
 
   absl::Span<const ExecutionPathView> subexpressions() const {
     return subexpressions_;
@@ -423,12 +932,32 @@ class FlatExpression {
 
   size_t comprehension_slots_size() const { return comprehension_slots_size_; }
 
+  // Number of value stack elements evaluator state is sized for. Defaults to
+  // the step count, a trivially sufficient bound; the planner overrides it
+  // with its estimate of the maximum number of simultaneously live values so
+  // pooled evaluator states are not sized to the whole program. The stack
+  // grows on demand, so a too-small value costs a reallocation, not
+  // correctness.
+  size_t value_stack_size() const { return value_stack_size_; }
+
+  void set_value_stack_size(size_t size) { value_stack_size_ = size; }
+
+  // Slot assignment for the identifiers this expression references, or
+  // nullptr for expressions planned without one. Callers construct a
+  // cel::SlotActivation from this plan to resolve variables by array index.
+  const std::shared_ptr<const cel::VariableBindingPlan>& variable_binding_plan()
+      const {
+    return variable_binding_plan_;
+  }
+
  private:
-  ExecutionPath path_;
+  std::shared_ptr<const ExecutionPath> path_;
   std::vector<ExecutionPathView> subexpressions_;
   size_t comprehension_slots_size_;
+  size_t value_stack_size_;
   const cel::TypeProvider& type_provider_;
   cel::RuntimeOptions options_;
+  std::shared_ptr<const cel::VariableBindingPlan> variable_binding_plan_;
 };
 
 }  // namespace google::api::expr::runtime
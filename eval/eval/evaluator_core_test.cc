@@ -4,7 +4,14 @@
 #include <utility>
 
 #include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "absl/types/optional.h"
+#include "base/async_function.h"
 #include "base/type_provider.h"
+#include "common/memory.h"
+#include "common/value.h"
 #include "eval/compiler/cel_expression_builder_flat_impl.h"
 #include "eval/eval/cel_expression_flat_impl.h"
 #include "eval/internal/interop.h"
@@ -24,8 +31,10 @@ using ::cel::extensions::ProtoMemoryManagerRef;
 using ::cel::interop_internal::CreateIntValue;
 using ::google::api::expr::v1alpha1::Expr;
 using ::google::api::expr::runtime::RegisterBuiltinFunctions;
+using cel::internal::StatusIs;
 using testing::_;
 using testing::Eq;
+using testing::HasSubstr;
 
 // Fake expression implementation
 // Pushes int64_t(0) on top of value stack.
@@ -83,6 +92,272 @@ TEST(EvaluatorCoreTest, ExecutionFrameNext) {
   EXPECT_THAT(frame.Next(), Eq(nullptr));
 }
 
+TEST(EvaluatorCoreTest, EvaluationStats) {
+  ExecutionPath path;
+  google::protobuf::Arena arena;
+  auto manager = ProtoMemoryManagerRef(&arena);
+  path.push_back(std::make_unique<const FakeConstExpressionStep>());
+  path.push_back(std::make_unique<const FakeIncrementExpressionStep>());
+  path.push_back(std::make_unique<const FakeIncrementExpressionStep>());
+
+  cel::RuntimeOptions options;
+  cel::Activation activation;
+  FlatExpressionEvaluatorState state(path.size(),
+                                     /*comprehension_slot_count=*/0,
+                                     TypeProvider::Builtin(), manager);
+  ExecutionFrame frame(path, activation, options, state);
+
+  ASSERT_OK(frame.Evaluate().status());
+
+  const EvaluationStats& stats = state.stats();
+  EXPECT_EQ(stats.dispatch_count, 3);
+  EXPECT_EQ(stats.max_stack_depth, 1);
+  // Each step pushes exactly one result.
+  EXPECT_EQ(stats.values_produced, 3);
+  EXPECT_EQ(stats.comprehension_iterations, 0);
+  // Cost accounting is disabled along with the budget.
+  EXPECT_EQ(stats.cost_consumed, 0);
+}
+
+// Fake expression implementation that allocates arena memory.
+// Pushes int64_t(0) on top of value stack.
+class FakeAllocatingExpressionStep : public ExpressionStep {
+ public:
+  explicit FakeAllocatingExpressionStep(int64_t id)
+      : ExpressionStep(id, true) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    void* allocation = frame->memory_manager().Allocate(1024, 8);
+    EXPECT_NE(allocation, nullptr);
+    frame->value_stack().Push(CreateIntValue(0));
+    return absl::OkStatus();
+  }
+};
+
+TEST(EvaluatorCoreTest, AllocationReportAttributesArenaBytes) {
+  ExecutionPath path;
+  google::protobuf::Arena arena;
+  auto manager = ProtoMemoryManagerRef(&arena);
+  path.push_back(std::make_unique<const FakeAllocatingExpressionStep>(7));
+  path.push_back(std::make_unique<const FakeIncrementExpressionStep>());
+
+  cel::RuntimeOptions options;
+  cel::Activation activation;
+  FlatExpressionEvaluatorState state(path.size(),
+                                     /*comprehension_slot_count=*/0,
+                                     TypeProvider::Builtin(), manager);
+  state.EnableAllocationTracking();
+  ExecutionFrame frame(path, activation, options, state);
+
+  ASSERT_OK(frame.Evaluate().status());
+
+  const AllocationReport* report = state.allocation_report();
+  ASSERT_NE(report, nullptr);
+  auto it = report->bytes_by_expr_id.find(7);
+  ASSERT_NE(it, report->bytes_by_expr_id.end());
+  EXPECT_GE(it->second, 1024);
+  EXPECT_GE(report->total_bytes, it->second);
+}
+
+TEST(EvaluatorCoreTest, AllocationReportAbsentWhenNotEnabled) {
+  ExecutionPath path;
+  google::protobuf::Arena arena;
+  auto manager = ProtoMemoryManagerRef(&arena);
+  path.push_back(std::make_unique<const FakeAllocatingExpressionStep>(7));
+
+  cel::RuntimeOptions options;
+  cel::Activation activation;
+  FlatExpressionEvaluatorState state(path.size(),
+                                     /*comprehension_slot_count=*/0,
+                                     TypeProvider::Builtin(), manager);
+  ExecutionFrame frame(path, activation, options, state);
+
+  ASSERT_OK(frame.Evaluate().status());
+
+  EXPECT_EQ(state.allocation_report(), nullptr);
+}
+
+// Fake expression implementation with a non-default dispatch cost.
+// Pushes int64_t(0) on top of value stack.
+class FakeExpensiveExpressionStep : public ExpressionStep {
+ public:
+  FakeExpensiveExpressionStep() : ExpressionStep(0, true) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    frame->value_stack().Push(CreateIntValue(0));
+    return absl::OkStatus();
+  }
+
+  int64_t Cost() const override { return 5; }
+};
+
+TEST(EvaluatorCoreTest, CostBudgetExceeded) {
+  ExecutionPath path;
+  google::protobuf::Arena arena;
+  auto manager = ProtoMemoryManagerRef(&arena);
+  path.push_back(std::make_unique<const FakeConstExpressionStep>());
+  path.push_back(std::make_unique<const FakeIncrementExpressionStep>());
+  path.push_back(std::make_unique<const FakeIncrementExpressionStep>());
+
+  cel::RuntimeOptions options;
+  options.evaluation_cost_budget = 2;
+  cel::Activation activation;
+  FlatExpressionEvaluatorState state(path.size(),
+                                     /*comprehension_slot_count=*/0,
+                                     TypeProvider::Builtin(), manager);
+  ExecutionFrame frame(path, activation, options, state);
+
+  EXPECT_THAT(frame.Evaluate().status(),
+              StatusIs(absl::StatusCode::kResourceExhausted,
+                       HasSubstr("cost budget exceeded")));
+}
+
+TEST(EvaluatorCoreTest, CostBudgetSufficient) {
+  ExecutionPath path;
+  google::protobuf::Arena arena;
+  auto manager = ProtoMemoryManagerRef(&arena);
+  path.push_back(std::make_unique<const FakeConstExpressionStep>());
+  path.push_back(std::make_unique<const FakeIncrementExpressionStep>());
+  path.push_back(std::make_unique<const FakeIncrementExpressionStep>());
+
+  cel::RuntimeOptions options;
+  options.evaluation_cost_budget = 3;
+  cel::Activation activation;
+  FlatExpressionEvaluatorState state(path.size(),
+                                     /*comprehension_slot_count=*/0,
+                                     TypeProvider::Builtin(), manager);
+  ExecutionFrame frame(path, activation, options, state);
+
+  ASSERT_OK(frame.Evaluate().status());
+  EXPECT_EQ(state.stats().cost_consumed, 3);
+}
+
+TEST(EvaluatorCoreTest, CostBudgetChargesStepWeights) {
+  ExecutionPath path;
+  google::protobuf::Arena arena;
+  auto manager = ProtoMemoryManagerRef(&arena);
+  path.push_back(std::make_unique<const FakeExpensiveExpressionStep>());
+
+  cel::RuntimeOptions options;
+  options.evaluation_cost_budget = 4;
+  cel::Activation activation;
+  FlatExpressionEvaluatorState state(path.size(),
+                                     /*comprehension_slot_count=*/0,
+                                     TypeProvider::Builtin(), manager);
+  ExecutionFrame frame(path, activation, options, state);
+
+  EXPECT_THAT(frame.Evaluate().status(),
+              StatusIs(absl::StatusCode::kResourceExhausted,
+                       HasSubstr("cost budget exceeded")));
+
+  FlatExpressionEvaluatorState state2(path.size(),
+                                      /*comprehension_slot_count=*/0,
+                                      TypeProvider::Builtin(), manager);
+  options.evaluation_cost_budget = 5;
+  ExecutionFrame frame2(path, activation, options, state2);
+  ASSERT_OK(frame2.Evaluate().status());
+  EXPECT_EQ(state2.stats().cost_consumed, 5);
+}
+
+TEST(EvaluatorCoreTest, MemoryLimitExceeded) {
+  ExecutionPath path;
+  google::protobuf::Arena arena;
+  auto manager = ProtoMemoryManagerRef(&arena);
+  path.push_back(std::make_unique<const FakeAllocatingExpressionStep>(7));
+  path.push_back(std::make_unique<const FakeIncrementExpressionStep>());
+
+  cel::RuntimeOptions options;
+  options.evaluation_memory_limit_bytes = 512;
+  cel::Activation activation;
+  FlatExpressionEvaluatorState state(path.size(),
+                                     /*comprehension_slot_count=*/0,
+                                     TypeProvider::Builtin(), manager);
+  ExecutionFrame frame(path, activation, options, state);
+
+  EXPECT_THAT(frame.Evaluate().status(),
+              StatusIs(absl::StatusCode::kResourceExhausted,
+                       HasSubstr("memory limit exceeded")));
+}
+
+TEST(EvaluatorCoreTest, MemoryLimitSufficient) {
+  ExecutionPath path;
+  google::protobuf::Arena arena;
+  auto manager = ProtoMemoryManagerRef(&arena);
+  path.push_back(std::make_unique<const FakeAllocatingExpressionStep>(7));
+  path.push_back(std::make_unique<const FakeIncrementExpressionStep>());
+
+  cel::RuntimeOptions options;
+  // Block granularity: the limit must accommodate whole arena blocks, not
+  // just the bytes the step requests.
+  options.evaluation_memory_limit_bytes = 1 << 20;
+  cel::Activation activation;
+  FlatExpressionEvaluatorState state(path.size(),
+                                     /*comprehension_slot_count=*/0,
+                                     TypeProvider::Builtin(), manager);
+  ExecutionFrame frame(path, activation, options, state);
+
+  ASSERT_OK(frame.Evaluate().status());
+}
+
+TEST(EvaluatorCoreTest, MemoryLimitNotEnforcedWithoutArena) {
+  ExecutionPath path;
+  path.push_back(std::make_unique<const FakeConstExpressionStep>());
+  path.push_back(std::make_unique<const FakeIncrementExpressionStep>());
+
+  cel::RuntimeOptions options;
+  options.evaluation_memory_limit_bytes = 1;
+  cel::Activation activation;
+  FlatExpressionEvaluatorState state(
+      path.size(), /*comprehension_slot_count=*/0, TypeProvider::Builtin(),
+      cel::MemoryManagerRef::ReferenceCounting());
+  ExecutionFrame frame(path, activation, options, state);
+
+  ASSERT_OK(frame.Evaluate().status());
+}
+
+TEST(EvaluatorCoreTest, EvaluationDeadlineExceeded) {
+  ExecutionPath path;
+  google::protobuf::Arena arena;
+  auto manager = ProtoMemoryManagerRef(&arena);
+  path.push_back(std::make_unique<const FakeConstExpressionStep>());
+  // Enough steps to guarantee at least one amortized clock read.
+  for (int i = 0; i < ExecutionFrameBase::kDeadlineCheckInterval + 1; ++i) {
+    path.push_back(std::make_unique<const FakeIncrementExpressionStep>());
+  }
+
+  cel::RuntimeOptions options;
+  options.evaluation_timeout = absl::Nanoseconds(1);
+  cel::Activation activation;
+  FlatExpressionEvaluatorState state(path.size(),
+                                     /*comprehension_slot_count=*/0,
+                                     TypeProvider::Builtin(), manager);
+  ExecutionFrame frame(path, activation, options, state);
+
+  EXPECT_THAT(frame.Evaluate().status(),
+              StatusIs(absl::StatusCode::kDeadlineExceeded,
+                       HasSubstr("deadline exceeded")));
+}
+
+TEST(EvaluatorCoreTest, EvaluationDeadlineSufficient) {
+  ExecutionPath path;
+  google::protobuf::Arena arena;
+  auto manager = ProtoMemoryManagerRef(&arena);
+  path.push_back(std::make_unique<const FakeConstExpressionStep>());
+  for (int i = 0; i < ExecutionFrameBase::kDeadlineCheckInterval + 1; ++i) {
+    path.push_back(std::make_unique<const FakeIncrementExpressionStep>());
+  }
+
+  cel::RuntimeOptions options;
+  options.evaluation_timeout = absl::Hours(1);
+  cel::Activation activation;
+  FlatExpressionEvaluatorState state(path.size(),
+                                     /*comprehension_slot_count=*/0,
+                                     TypeProvider::Builtin(), manager);
+  ExecutionFrame frame(path, activation, options, state);
+
+  ASSERT_OK(frame.Evaluate().status());
+}
+
 TEST(EvaluatorCoreTest, SimpleEvaluatorTest) {
   ExecutionPath path;
   auto const_step = std::make_unique<FakeConstExpressionStep>();
@@ -107,6 +382,99 @@ TEST(EvaluatorCoreTest, SimpleEvaluatorTest) {
   EXPECT_THAT(value.Int64OrDie(), Eq(2));
 }
 
+// Fake asynchronous step. Under async evaluation it suspends the frame; the
+// call completes inline with int64_t(5) unless a stash is provided, in which
+// case the done callback is parked there for the test to run later.
+class FakeSuspendingExpressionStep : public ExpressionStep {
+ public:
+  explicit FakeSuspendingExpressionStep(
+      cel::AsyncFunction::DoneCallback* stash = nullptr)
+      : ExpressionStep(0, true), stash_(stash) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    if (!frame->async_evaluation_enabled()) {
+      frame->value_stack().Push(CreateIntValue(5));
+      return absl::OkStatus();
+    }
+    ExecutionFrame::PendingAsyncCall call;
+    call.start = [stash = stash_](cel::AsyncFunction::DoneCallback done) {
+      if (stash != nullptr) {
+        *stash = std::move(done);
+        return;
+      }
+      std::move(done)(CreateIntValue(5));
+    };
+    call.on_resume = [](ExecutionFrame& frame,
+                        absl::StatusOr<cel::Value> result) -> absl::Status {
+      if (!result.ok()) {
+        return result.status();
+      }
+      frame.value_stack().Push(std::move(*result));
+      return absl::OkStatus();
+    };
+    frame->SuspendForAsyncCall(std::move(call));
+    return absl::OkStatus();
+  }
+
+ private:
+  cel::AsyncFunction::DoneCallback* stash_;
+};
+
+TEST(EvaluatorCoreTest, AsyncEvaluationInlineCompletion) {
+  ExecutionPath path;
+  path.push_back(std::make_unique<const FakeSuspendingExpressionStep>());
+  path.push_back(std::make_unique<const FakeIncrementExpressionStep>());
+
+  FlatExpression expr(std::move(path), 0, TypeProvider::Builtin(),
+                      cel::RuntimeOptions{});
+
+  google::protobuf::Arena arena;
+  auto state = expr.MakeEvaluatorState(ProtoMemoryManagerRef(&arena));
+  cel::Activation activation;
+
+  absl::optional<absl::StatusOr<cel::Value>> result;
+  expr.EvaluateAsynchronously(activation, EvaluationListener(), state,
+                              [&result](absl::StatusOr<cel::Value> value) {
+                                result.emplace(std::move(value));
+                              });
+
+  // The call completed inline, so the evaluation already finished.
+  ASSERT_TRUE(result.has_value());
+  ASSERT_OK(result->status());
+  ASSERT_TRUE((*result)->Is<IntValue>());
+  EXPECT_EQ((*result)->As<IntValue>().NativeValue(), 6);
+}
+
+TEST(EvaluatorCoreTest, AsyncEvaluationDeferredCompletion) {
+  cel::AsyncFunction::DoneCallback stash;
+  ExecutionPath path;
+  path.push_back(std::make_unique<const FakeSuspendingExpressionStep>(&stash));
+  path.push_back(std::make_unique<const FakeIncrementExpressionStep>());
+
+  FlatExpression expr(std::move(path), 0, TypeProvider::Builtin(),
+                      cel::RuntimeOptions{});
+
+  google::protobuf::Arena arena;
+  auto state = expr.MakeEvaluatorState(ProtoMemoryManagerRef(&arena));
+  cel::Activation activation;
+
+  absl::optional<absl::StatusOr<cel::Value>> result;
+  expr.EvaluateAsynchronously(activation, EvaluationListener(), state,
+                              [&result](absl::StatusOr<cel::Value> value) {
+                                result.emplace(std::move(value));
+                              });
+
+  // Suspended on the in-flight call: no result yet.
+  ASSERT_FALSE(result.has_value());
+
+  // Completing the call resumes and finishes the evaluation.
+  std::move(stash)(CreateIntValue(7));
+  ASSERT_TRUE(result.has_value());
+  ASSERT_OK(result->status());
+  ASSERT_TRUE((*result)->Is<IntValue>());
+  EXPECT_EQ((*result)->As<IntValue>().NativeValue(), 8);
+}
+
 class MockTraceCallback {
  public:
   MOCK_METHOD(void, Call,
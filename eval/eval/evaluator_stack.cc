@@ -1,11 +1,78 @@
 #include "eval/eval/evaluator_stack.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "eval/eval/attribute_trail.h"
+
 namespace google::api::expr::runtime {
 
+namespace {
+
+constexpr size_t AlignUp(size_t size, size_t align) {
+  return (size + align - 1) & ~(align - 1);
+}
+
+constexpr size_t kStackAlign =
+    std::max(alignof(cel::Value), alignof(AttributeTrail));
+
+}  // namespace
+
+EvaluatorStack::~EvaluatorStack() {
+  Clear();
+  Deallocate();
+}
+
 void EvaluatorStack::Clear() {
-  stack_.clear();
-  attribute_stack_.clear();
-  current_size_ = 0;
+  while (current_size_ > 0) {
+    --current_size_;
+    values_[current_size_].~Value();
+    attributes_[current_size_].~AttributeTrail();
+  }
+  total_pushes_ = 0;
+}
+
+void EvaluatorStack::Grow(size_t new_capacity) {
+  const size_t values_bytes =
+      AlignUp(new_capacity * sizeof(cel::Value), alignof(AttributeTrail));
+  const size_t attributes_bytes = AlignUp(
+      new_capacity * sizeof(AttributeTrail), alignof(cel::ValueKind));
+  const size_t total_bytes =
+      values_bytes + attributes_bytes + new_capacity * sizeof(cel::ValueKind);
+  void* data = ::operator new(total_bytes, std::align_val_t{kStackAlign});
+  cel::Value* values = static_cast<cel::Value*>(data);
+  AttributeTrail* attributes = reinterpret_cast<AttributeTrail*>(
+      static_cast<unsigned char*>(data) + values_bytes);
+  cel::ValueKind* kinds = reinterpret_cast<cel::ValueKind*>(
+      static_cast<unsigned char*>(data) + values_bytes + attributes_bytes);
+  for (size_t i = 0; i < current_size_; ++i) {
+    ::new (static_cast<void*>(values + i)) cel::Value(std::move(values_[i]));
+    values_[i].~Value();
+    ::new (static_cast<void*>(attributes + i))
+        AttributeTrail(std::move(attributes_[i]));
+    attributes_[i].~AttributeTrail();
+  }
+  if (current_size_ > 0) {
+    std::memcpy(kinds, kinds_, current_size_ * sizeof(cel::ValueKind));
+  }
+  Deallocate();
+  values_ = values;
+  attributes_ = attributes;
+  kinds_ = kinds;
+  data_ = data;
+  capacity_ = new_capacity;
+}
+
+void EvaluatorStack::Deallocate() {
+  if (data_ != nullptr) {
+    ::operator delete(data_, std::align_val_t{kStackAlign});
+    data_ = nullptr;
+  }
 }
 
 }  // namespace google::api::expr::runtime
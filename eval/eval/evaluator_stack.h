@@ -2,20 +2,37 @@
 #define THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATOR_STACK_H_
 
 #include <cstddef>
+#include <new>
 #include <utility>
-#include <vector>
 
 #include "absl/base/optimization.h"
+#include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/types/span.h"
 #include "common/value.h"
+#include "common/value_kind.h"
 #include "eval/eval/attribute_trail.h"
 
 namespace google::api::expr::runtime {
 
 // CelValue stack.
-// Implementation is based on vector to allow passing parameters from
-// stack as Span<>.
+// Values and their attribute trails are kept in a single allocation with a
+// single shared size, so that pushes and pops update one counter instead of
+// maintaining two parallel vectors. Values are stored contiguously to allow
+// passing parameters from the stack as Span<>.
+//
+// A parallel one-byte-per-entry lane records each entry's ValueKind so that
+// steps which only dispatch on kind (argument matching, bool / error tests)
+// scan a dense array instead of pulling whole Value objects through cache.
+// The lane is refreshed on Push and on the replace branch of PopAndPush;
+// entries mutated in place through GetMutableSpan or the mutable Peek must be
+// popped or replaced before kinds are read again, which all current steps do.
+//
+// Accessors document "checking is caller's responsibility": every step
+// guards its dispatch with one HasEnough() (returning a status on
+// underflow), and plans built by FlatExprBuilder maintain stack discipline
+// by construction, so the accessors only re-validate in debug builds
+// (ABSL_DCHECK) rather than branching again per call in release.
 class EvaluatorStack {
  public:
   explicit EvaluatorStack(size_t max_size)
@@ -23,18 +40,31 @@ class EvaluatorStack {
     Reserve(max_size);
   }
 
+  EvaluatorStack(const EvaluatorStack&) = delete;
+  EvaluatorStack& operator=(const EvaluatorStack&) = delete;
+
+  ~EvaluatorStack();
+
   // Return the current stack size.
   size_t size() const { return current_size_; }
 
   // Return the maximum size of the stack.
   size_t max_size() const { return max_size_; }
 
+  // Return the allocated capacity, which may exceed max_size() when the
+  // stack has been rebound to a smaller program since it last grew.
+  size_t capacity() const { return capacity_; }
+
   // Returns true if stack is empty.
   bool empty() const { return current_size_ == 0; }
 
   // Attributes stack size.
   size_t attribute_size() const { return current_size_; }
 
+  // Cumulative number of values materialized on the stack (via Push or the
+  // replace branch of PopAndPush) since construction or the last Clear().
+  size_t total_pushes() const { return total_pushes_; }
+
   // Check that stack has enough elements.
   bool HasEnough(size_t size) const { return current_size_ >= size; }
 
@@ -45,65 +75,84 @@ class EvaluatorStack {
   // Checking that stack has enough elements is caller's responsibility.
   // Please note that calls to Push may invalidate returned Span object.
   absl::Span<const cel::Value> GetSpan(size_t size) const {
-    if (ABSL_PREDICT_FALSE(!HasEnough(size))) {
-      ABSL_LOG(FATAL) << "Requested span size (" << size
-                      << ") exceeds current stack size: " << current_size_;
-    }
-    return absl::Span<const cel::Value>(stack_.data() + current_size_ - size,
-                                        size);
+    ABSL_DCHECK(HasEnough(size))
+        << "Requested span size (" << size
+        << ") exceeds current stack size: " << current_size_;
+    return absl::Span<const cel::Value>(values_ + current_size_ - size, size);
+  }
+
+  // Gets the last size elements of the stack with mutable access.
+  // Intended for steps that consume their arguments: moving out of the span
+  // avoids copying reference-counted values the caller is about to pop.
+  // Checking that stack has enough elements is caller's responsibility.
+  // Please note that calls to Push may invalidate returned Span object.
+  absl::Span<cel::Value> GetMutableSpan(size_t size) {
+    ABSL_DCHECK(HasEnough(size))
+        << "Requested span size (" << size
+        << ") exceeds current stack size: " << current_size_;
+    return absl::Span<cel::Value>(values_ + current_size_ - size, size);
   }
 
   // Gets the last size attribute trails of the stack.
   // Checking that stack has enough elements is caller's responsibility.
   // Please note that calls to Push may invalidate returned Span object.
   absl::Span<const AttributeTrail> GetAttributeSpan(size_t size) const {
-    if (ABSL_PREDICT_FALSE(!HasEnough(size))) {
-      ABSL_LOG(FATAL) << "Requested span size (" << size
-                      << ") exceeds current stack size: " << current_size_;
-    }
+    ABSL_DCHECK(HasEnough(size))
+        << "Requested span size (" << size
+        << ") exceeds current stack size: " << current_size_;
     return absl::Span<const AttributeTrail>(
-        attribute_stack_.data() + current_size_ - size, size);
+        attributes_ + current_size_ - size, size);
+  }
+
+  // Gets the kinds of the last size elements of the stack.
+  // Checking that stack has enough elements is caller's responsibility.
+  // Please note that calls to Push may invalidate returned Span object.
+  absl::Span<const cel::ValueKind> GetKindSpan(size_t size) const {
+    ABSL_DCHECK(HasEnough(size))
+        << "Requested span size (" << size
+        << ") exceeds current stack size: " << current_size_;
+    return absl::Span<const cel::ValueKind>(kinds_ + current_size_ - size,
+                                            size);
+  }
+
+  // Peeks the kind of the last element of the stack.
+  // Checking that stack is not empty is caller's responsibility.
+  cel::ValueKind PeekKind() const {
+    ABSL_DCHECK(!empty()) << "Peeking on empty EvaluatorStack";
+    return kinds_[current_size_ - 1];
   }
 
   // Peeks the last element of the stack.
   // Checking that stack is not empty is caller's responsibility.
   cel::Value& Peek() {
-    if (ABSL_PREDICT_FALSE(empty())) {
-      ABSL_LOG(FATAL) << "Peeking on empty EvaluatorStack";
-    }
-    return stack_[current_size_ - 1];
+    ABSL_DCHECK(!empty()) << "Peeking on empty EvaluatorStack";
+    return values_[current_size_ - 1];
   }
 
   // Peeks the last element of the stack.
   // Checking that stack is not empty is caller's responsibility.
   const cel::Value& Peek() const {
-    if (ABSL_PREDICT_FALSE(empty())) {
-      ABSL_LOG(FATAL) << "Peeking on empty EvaluatorStack";
-    }
-    return stack_[current_size_ - 1];
+    ABSL_DCHECK(!empty()) << "Peeking on empty EvaluatorStack";
+    return values_[current_size_ - 1];
   }
 
   // Peeks the last element of the attribute stack.
   // Checking that stack is not empty is caller's responsibility.
   const AttributeTrail& PeekAttribute() const {
-    if (ABSL_PREDICT_FALSE(empty())) {
-      ABSL_LOG(FATAL) << "Peeking on empty EvaluatorStack";
-    }
-    return attribute_stack_[current_size_ - 1];
+    ABSL_DCHECK(!empty()) << "Peeking on empty EvaluatorStack";
+    return attributes_[current_size_ - 1];
   }
 
   // Clears the last size elements of the stack.
   // Checking that stack has enough elements is caller's responsibility.
   void Pop(size_t size) {
-    if (ABSL_PREDICT_FALSE(!HasEnough(size))) {
-      ABSL_LOG(FATAL) << "Trying to pop more elements (" << size
-                      << ") than the current stack size: " << current_size_;
-    }
-    while (size > 0) {
-      stack_.pop_back();
-      attribute_stack_.pop_back();
-      current_size_--;
-      size--;
+    ABSL_DCHECK(HasEnough(size))
+        << "Trying to pop more elements (" << size
+        << ") than the current stack size: " << current_size_;
+    while (size-- > 0) {
+      --current_size_;
+      values_[current_size_].~Value();
+      attributes_[current_size_].~AttributeTrail();
     }
   }
 
@@ -111,12 +160,17 @@ class EvaluatorStack {
   void Push(cel::Value value) { Push(std::move(value), AttributeTrail()); }
 
   void Push(cel::Value value, AttributeTrail attribute) {
-    if (ABSL_PREDICT_FALSE(current_size_ >= max_size())) {
+    if (ABSL_PREDICT_FALSE(current_size_ >= capacity_)) {
       ABSL_LOG(ERROR) << "No room to push more elements on to EvaluatorStack";
+      Grow(capacity_ == 0 ? 1 : capacity_ * 2);
     }
-    stack_.push_back(std::move(value));
-    attribute_stack_.push_back(std::move(attribute));
-    current_size_++;
+    ::new (static_cast<void*>(values_ + current_size_))
+        cel::Value(std::move(value));
+    ::new (static_cast<void*>(attributes_ + current_size_))
+        AttributeTrail(std::move(attribute));
+    kinds_[current_size_] = values_[current_size_].kind();
+    ++current_size_;
+    ++total_pushes_;
   }
 
   void PopAndPush(size_t size, cel::Value value, AttributeTrail attribute) {
@@ -125,8 +179,10 @@ class EvaluatorStack {
       return;
     }
     Pop(size - 1);
-    stack_[current_size_ - 1] = std::move(value);
-    attribute_stack_[current_size_ - 1] = std::move(attribute);
+    values_[current_size_ - 1] = std::move(value);
+    attributes_[current_size_ - 1] = std::move(attribute);
+    kinds_[current_size_ - 1] = values_[current_size_ - 1].kind();
+    ++total_pushes_;
   }
 
   // Replace element on the top of the stack.
@@ -154,14 +210,25 @@ class EvaluatorStack {
  private:
   // Preallocate stack.
   void Reserve(size_t size) {
-    stack_.reserve(size);
-    attribute_stack_.reserve(size);
+    if (size > capacity_) {
+      Grow(size);
+    }
   }
 
-  std::vector<cel::Value> stack_;
-  std::vector<AttributeTrail> attribute_stack_;
+  // Reallocate the backing storage, moving any live elements.
+  void Grow(size_t new_capacity);
+
+  // Release the backing storage without destroying live elements.
+  void Deallocate();
+
+  cel::Value* values_ = nullptr;
+  AttributeTrail* attributes_ = nullptr;
+  cel::ValueKind* kinds_ = nullptr;
+  void* data_ = nullptr;
   size_t max_size_;
   size_t current_size_;
+  size_t capacity_ = 0;
+  size_t total_pushes_ = 0;
 };
 
 }  // namespace google::api::expr::runtime
@@ -1,10 +1,13 @@
 #include "eval/eval/evaluator_stack.h"
 
+#include <utility>
+
 #include "base/attribute.h"
 #include "base/type_provider.h"
 #include "common/type_factory.h"
 #include "common/type_manager.h"
 #include "common/value.h"
+#include "common/value_kind.h"
 #include "common/value_manager.h"
 #include "common/values/legacy_value_manager.h"
 #include "extensions/protobuf/memory_manager.h"
@@ -72,6 +75,50 @@ TEST(EvaluatorStackTest, StackBalanced) {
   ASSERT_EQ(stack.size(), stack.attribute_size());
 }
 
+TEST(EvaluatorStackTest, GetMutableSpanAllowsMovingArguments) {
+  google::protobuf::Arena arena;
+  auto manager = ProtoMemoryManagerRef(&arena);
+  cel::common_internal::LegacyValueManager value_factory(
+      manager, TypeProvider::Builtin());
+  EvaluatorStack stack(10);
+
+  stack.Push(value_factory.CreateIntValue(1));
+  stack.Push(value_factory.CreateIntValue(2));
+  stack.Push(value_factory.CreateIntValue(3));
+
+  auto args = stack.GetMutableSpan(2);
+  cel::Value moved = std::move(args[1]);
+  ASSERT_EQ(moved.As<cel::IntValue>().NativeValue(), 3);
+
+  stack.PopAndPush(2, std::move(moved));
+  ASSERT_EQ(stack.size(), 2);
+  ASSERT_EQ(stack.Peek().As<cel::IntValue>().NativeValue(), 3);
+}
+
+TEST(EvaluatorStackTest, KindLaneTracksPushAndReplace) {
+  google::protobuf::Arena arena;
+  auto manager = ProtoMemoryManagerRef(&arena);
+  cel::common_internal::LegacyValueManager value_factory(
+      manager, TypeProvider::Builtin());
+  EvaluatorStack stack(10);
+
+  stack.Push(value_factory.CreateIntValue(1));
+  stack.Push(value_factory.CreateBoolValue(true));
+  ASSERT_EQ(stack.PeekKind(), cel::ValueKind::kBool);
+
+  auto kinds = stack.GetKindSpan(2);
+  ASSERT_EQ(kinds[0], cel::ValueKind::kInt);
+  ASSERT_EQ(kinds[1], cel::ValueKind::kBool);
+
+  stack.PopAndPush(2, value_factory.CreateUncheckedStringValue("abc"));
+  ASSERT_EQ(stack.size(), 1);
+  ASSERT_EQ(stack.PeekKind(), cel::ValueKind::kString);
+
+  stack.Pop(1);
+  stack.Push(value_factory.CreateDoubleValue(1.0));
+  ASSERT_EQ(stack.PeekKind(), cel::ValueKind::kDouble);
+}
+
 TEST(EvaluatorStackTest, Clear) {
   google::protobuf::Arena arena;
   auto manager = ProtoMemoryManagerRef(&arena);
@@ -0,0 +1,149 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/evaluator_state_pool.h"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "common/value_manager.h"
+#include "eval/eval/comprehension_slots.h"
+#include "eval/eval/evaluator_core.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+// Bound on retained states per thread; beyond this depth of nested
+// evaluation, states spill to the shared overflow shards below.
+constexpr size_t kMaxPooledStates = 8;
+
+std::vector<std::unique_ptr<FlatExpressionEvaluatorState>>& GetFreeList() {
+  static thread_local std::vector<std::unique_ptr<FlatExpressionEvaluatorState>>
+      free_list;
+  return free_list;
+}
+
+// Shared overflow behind the per-thread lists, sharded by state size class.
+//
+// The per-thread lists give steady-state evaluation core-resident reuse with
+// no synchronization at all; the overflow catches the two cases they cannot:
+// bursty traffic spinning up fresh threads (which would otherwise construct
+// states cold) and deep nesting releasing more states than a thread retains
+// (which would otherwise free and reallocate them). Shards are classed by
+// value stack capacity so a small program never checks out a state pinning a
+// large stack allocation, and each class has its own mutex so threads
+// releasing differently sized states do not contend.
+constexpr size_t kSizeClassLimits[] = {16, 64, 256};
+constexpr size_t kNumSizeClasses = 4;
+// Bound on retained states per class; the overflow holds at most
+// kNumSizeClasses * kMaxOverflowPerClass states process-wide.
+constexpr size_t kMaxOverflowPerClass = 32;
+
+size_t SizeClassFor(size_t value_stack_size) {
+  for (size_t size_class = 0; size_class < kNumSizeClasses - 1; ++size_class) {
+    if (value_stack_size <= kSizeClassLimits[size_class]) {
+      return size_class;
+    }
+  }
+  return kNumSizeClasses - 1;
+}
+
+struct OverflowShard {
+  absl::Mutex mutex;
+  std::vector<std::unique_ptr<FlatExpressionEvaluatorState>> states
+      ABSL_GUARDED_BY(mutex);
+};
+
+OverflowShard& GetOverflowShard(size_t size_class) {
+  static absl::NoDestructor<std::array<OverflowShard, kNumSizeClasses>> shards;
+  return (*shards)[size_class];
+}
+
+std::unique_ptr<FlatExpressionEvaluatorState> TakeFromOverflow(
+    size_t value_stack_size) {
+  OverflowShard& shard = GetOverflowShard(SizeClassFor(value_stack_size));
+  absl::MutexLock lock(&shard.mutex);
+  if (shard.states.empty()) {
+    return nullptr;
+  }
+  std::unique_ptr<FlatExpressionEvaluatorState> state =
+      std::move(shard.states.back());
+  shard.states.pop_back();
+  return state;
+}
+
+void ReturnToOverflow(std::unique_ptr<FlatExpressionEvaluatorState> state) {
+  // Class by retained capacity rather than last-bound size, so a state that
+  // grew for a large program stays discoverable by (and only by) requests of
+  // that magnitude.
+  OverflowShard& shard =
+      GetOverflowShard(SizeClassFor(state->value_stack().capacity()));
+  absl::MutexLock lock(&shard.mutex);
+  if (shard.states.size() < kMaxOverflowPerClass) {
+    shard.states.push_back(std::move(state));
+  }
+  // Otherwise the state is freed when `state` goes out of scope.
+}
+
+}  // namespace
+
+PooledEvaluatorState::PooledEvaluatorState(size_t value_stack_size,
+                                          size_t comprehension_slot_count,
+                                          cel::ValueManager& value_factory) {
+  auto& free_list = GetFreeList();
+  if (!free_list.empty()) {
+    state_ = std::move(free_list.back());
+    free_list.pop_back();
+  } else {
+    state_ = TakeFromOverflow(value_stack_size);
+  }
+  if (state_ != nullptr) {
+    state_->Rebind(value_stack_size, /*comprehension_slot_count=*/0,
+                   value_factory);
+  } else {
+    state_ = std::make_unique<FlatExpressionEvaluatorState>(
+        value_stack_size, /*comprehension_slot_count=*/0, value_factory);
+  }
+  // Comprehension slots live as a frame on the shared per-thread buffer
+  // rather than in the state itself, so nested evaluations stack frames on
+  // one high-water allocation. The frame is LIFO by construction: handles
+  // are scoped, and the enclosing evaluation is suspended while this one
+  // runs.
+  ComprehensionSlots& shared = ComprehensionSlots::GetThreadLocalInstance();
+  shared.PushFrame(comprehension_slot_count);
+  state_->BorrowComprehensionSlots(&shared);
+}
+
+PooledEvaluatorState::~PooledEvaluatorState() {
+  state_->BorrowComprehensionSlots(nullptr);
+  ComprehensionSlots::GetThreadLocalInstance().PopFrame();
+  auto& free_list = GetFreeList();
+  // Drop values eagerly so pooled states do not pin value factory memory
+  // between evaluations.
+  state_->Reset();
+  if (free_list.size() < kMaxPooledStates) {
+    free_list.push_back(std::move(state_));
+  } else {
+    ReturnToOverflow(std::move(state_));
+  }
+}
+
+}  // namespace google::api::expr::runtime
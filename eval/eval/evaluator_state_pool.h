@@ -0,0 +1,67 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATOR_STATE_POOL_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATOR_STATE_POOL_H_
+
+#include <cstddef>
+#include <memory>
+
+#include "common/value_manager.h"
+#include "eval/eval/evaluator_core.h"
+
+namespace google::api::expr::runtime {
+
+// RAII handle to a pooled FlatExpressionEvaluatorState.
+//
+// Steady-state evaluation reuses value stack and comprehension slot storage
+// retained on the current thread instead of allocating fresh vectors per
+// evaluation. States are checked out for the lifetime of the handle, so
+// nested evaluations on the same thread (e.g. an extension function that
+// itself evaluates a program) each get their own state. Comprehension slots
+// for pooled states are stacked as frames on one shared per-thread buffer
+// (ComprehensionSlots::PushFrame), so nesting depth grows a single
+// high-water allocation rather than one slot vector per level.
+//
+// Behind the per-thread lists sits a bounded process-wide overflow, sharded
+// by state size class, so freshly started threads under bursty traffic warm
+// up from states released elsewhere instead of constructing them cold.
+class PooledEvaluatorState {
+ public:
+  PooledEvaluatorState(size_t value_stack_size,
+                       size_t comprehension_slot_count,
+                       cel::ValueManager& value_factory);
+
+  // Convenience overload deriving the shape from a planned expression.
+  PooledEvaluatorState(const FlatExpression& expression,
+                       cel::ValueManager& value_factory)
+      : PooledEvaluatorState(expression.value_stack_size(),
+                             expression.comprehension_slots_size(),
+                             value_factory) {}
+
+  PooledEvaluatorState(const PooledEvaluatorState&) = delete;
+  PooledEvaluatorState& operator=(const PooledEvaluatorState&) = delete;
+
+  // Returns the state to the thread-local pool.
+  ~PooledEvaluatorState();
+
+  FlatExpressionEvaluatorState& get() { return *state_; }
+
+ private:
+  std::unique_ptr<FlatExpressionEvaluatorState> state_;
+};
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATOR_STATE_POOL_H_
@@ -0,0 +1,151 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/evaluator_state_pool.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "base/type_provider.h"
+#include "common/values/legacy_value_manager.h"
+#include "extensions/protobuf/memory_manager.h"
+#include "internal/testing.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+using ::cel::TypeProvider;
+using ::cel::extensions::ProtoMemoryManagerRef;
+
+TEST(EvaluatorStatePoolTest, ReusesStateOnSameThread) {
+  google::protobuf::Arena arena;
+  auto manager = ProtoMemoryManagerRef(&arena);
+  cel::common_internal::LegacyValueManager value_factory(
+      manager, TypeProvider::Builtin());
+
+  FlatExpressionEvaluatorState* first;
+  {
+    PooledEvaluatorState state(/*value_stack_size=*/4,
+                               /*comprehension_slot_count=*/1, value_factory);
+    first = &state.get();
+    EXPECT_EQ(state.get().value_stack().max_size(), 4);
+    EXPECT_EQ(state.get().comprehension_slots().size(), 1);
+  }
+  {
+    PooledEvaluatorState state(/*value_stack_size=*/8,
+                               /*comprehension_slot_count=*/2, value_factory);
+    EXPECT_EQ(&state.get(), first);
+    EXPECT_EQ(state.get().value_stack().max_size(), 8);
+    EXPECT_EQ(state.get().comprehension_slots().size(), 2);
+  }
+}
+
+TEST(EvaluatorStatePoolTest, NestedCheckoutsAreDistinct) {
+  google::protobuf::Arena arena;
+  auto manager = ProtoMemoryManagerRef(&arena);
+  cel::common_internal::LegacyValueManager value_factory(
+      manager, TypeProvider::Builtin());
+
+  PooledEvaluatorState outer(/*value_stack_size=*/4,
+                             /*comprehension_slot_count=*/0, value_factory);
+  PooledEvaluatorState inner(/*value_stack_size=*/4,
+                             /*comprehension_slot_count=*/0, value_factory);
+  EXPECT_NE(&outer.get(), &inner.get());
+}
+
+TEST(EvaluatorStatePoolTest, NestedCheckoutsStackSlotFrames) {
+  google::protobuf::Arena arena;
+  auto manager = ProtoMemoryManagerRef(&arena);
+  cel::common_internal::LegacyValueManager value_factory(
+      manager, TypeProvider::Builtin());
+
+  PooledEvaluatorState outer(/*value_stack_size=*/4,
+                             /*comprehension_slot_count=*/2, value_factory);
+  outer.get().comprehension_slots().Set(0, value_factory.CreateIntValue(1));
+  {
+    PooledEvaluatorState inner(/*value_stack_size=*/4,
+                               /*comprehension_slot_count=*/1, value_factory);
+    // Both states index into the shared per-thread buffer, each through its
+    // own frame.
+    EXPECT_EQ(&outer.get().comprehension_slots(),
+              &inner.get().comprehension_slots());
+    EXPECT_EQ(inner.get().comprehension_slots().size(), 1);
+    EXPECT_EQ(inner.get().comprehension_slots().Get(0), nullptr);
+    inner.get().comprehension_slots().Set(0, value_factory.CreateIntValue(9));
+  }
+  // Popping the inner frame restores the outer one, values intact.
+  EXPECT_EQ(outer.get().comprehension_slots().size(), 2);
+  EXPECT_TRUE(outer.get().comprehension_slots().Get(0) != nullptr);
+}
+
+TEST(EvaluatorStatePoolTest, OverflowRetainsStatesBeyondThreadBound) {
+  google::protobuf::Arena arena;
+  auto manager = ProtoMemoryManagerRef(&arena);
+  cel::common_internal::LegacyValueManager value_factory(
+      manager, TypeProvider::Builtin());
+
+  // Nest deeper than the per-thread retention bound (8). The states released
+  // past the bound spill to the shared overflow instead of being freed, so a
+  // later burst of the same depth reuses every one of them.
+  constexpr int kDepth = 12;
+  std::vector<const FlatExpressionEvaluatorState*> seen;
+  {
+    std::vector<std::unique_ptr<PooledEvaluatorState>> states;
+    for (int i = 0; i < kDepth; ++i) {
+      states.push_back(std::make_unique<PooledEvaluatorState>(
+          /*value_stack_size=*/4, /*comprehension_slot_count=*/0,
+          value_factory));
+      seen.push_back(&states.back()->get());
+    }
+  }
+  {
+    std::vector<std::unique_ptr<PooledEvaluatorState>> states;
+    for (int i = 0; i < kDepth; ++i) {
+      states.push_back(std::make_unique<PooledEvaluatorState>(
+          /*value_stack_size=*/4, /*comprehension_slot_count=*/0,
+          value_factory));
+      // Each checked-out state is one seen in the first burst, whether it
+      // came from the per-thread list or the overflow.
+      EXPECT_NE(std::find(seen.begin(), seen.end(), &states.back()->get()),
+                seen.end())
+          << i;
+    }
+  }
+}
+
+TEST(EvaluatorStatePoolTest, ReboundStateIsClean) {
+  google::protobuf::Arena arena;
+  auto manager = ProtoMemoryManagerRef(&arena);
+  cel::common_internal::LegacyValueManager value_factory(
+      manager, TypeProvider::Builtin());
+
+  {
+    PooledEvaluatorState state(/*value_stack_size=*/4,
+                               /*comprehension_slot_count=*/1, value_factory);
+    state.get().value_stack().Push(value_factory.CreateIntValue(1));
+    state.get().comprehension_slots().Set(0, value_factory.CreateIntValue(2));
+  }
+  {
+    PooledEvaluatorState state(/*value_stack_size=*/4,
+                               /*comprehension_slot_count=*/1, value_factory);
+    EXPECT_TRUE(state.get().value_stack().empty());
+    EXPECT_EQ(state.get().comprehension_slots().Get(0), nullptr);
+  }
+}
+
+}  // namespace
+
+}  // namespace google::api::expr::runtime
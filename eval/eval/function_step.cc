@@ -1,6 +1,6 @@
 #include "eval/eval/function_step.h"
 
-#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -8,6 +8,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/optimization.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -16,11 +17,13 @@
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "base/ast_internal/expr.h"
+#include "base/async_function.h"
 #include "base/function.h"
 #include "base/function_descriptor.h"
 #include "base/kind.h"
 #include "common/casting.h"
 #include "common/value.h"
+#include "common/value_kind.h"
 #include "eval/eval/attribute_trail.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
@@ -40,15 +43,29 @@ using ::cel::FunctionEvaluationContext;
 
 using ::cel::UnknownValue;
 using ::cel::Value;
+using ::cel::ValueKind;
 using ::cel::ValueKindToKind;
 
+// Argument kinds for values materialized outside the value stack (partial
+// unknown replacements, recursive plan arguments). The stack-machine path
+// reads the stack's dense kind lane instead of rebuilding this.
+absl::InlinedVector<ValueKind, 4> ArgumentKinds(
+    absl::Span<const cel::Value> arguments) {
+  absl::InlinedVector<ValueKind, 4> kinds;
+  kinds.reserve(arguments.size());
+  for (const cel::Value& argument : arguments) {
+    kinds.push_back(argument->kind());
+  }
+  return kinds;
+}
+
 // Determine if the overload should be considered. Overloads that can consume
 // errors or unknown sets must be allowed as a non-strict function.
 bool ShouldAcceptOverload(const cel::FunctionDescriptor& descriptor,
-                          absl::Span<const cel::Value> arguments) {
-  for (size_t i = 0; i < arguments.size(); i++) {
-    if (arguments[i]->Is<cel::UnknownValue>() ||
-        arguments[i]->Is<cel::ErrorValue>()) {
+                          absl::Span<const ValueKind> argument_kinds) {
+  for (size_t i = 0; i < argument_kinds.size(); i++) {
+    if (argument_kinds[i] == ValueKind::kUnknown ||
+        argument_kinds[i] == ValueKind::kError) {
       return !descriptor.is_strict();
     }
   }
@@ -56,17 +73,16 @@ bool ShouldAcceptOverload(const cel::FunctionDescriptor& descriptor,
 }
 
 bool ArgumentKindsMatch(const cel::FunctionDescriptor& descriptor,
-                        absl::Span<const cel::Value> arguments) {
+                        absl::Span<const ValueKind> argument_kinds) {
   auto types_size = descriptor.types().size();
 
-  if (types_size != arguments.size()) {
+  if (types_size != argument_kinds.size()) {
     return false;
   }
 
   for (size_t i = 0; i < types_size; i++) {
-    const auto& arg = arguments[i];
     cel::Kind param_kind = descriptor.types()[i];
-    if (arg->kind() != param_kind && param_kind != cel::Kind::kAny) {
+    if (argument_kinds[i] != param_kind && param_kind != cel::Kind::kAny) {
       return false;
     }
   }
@@ -144,6 +160,82 @@ bool IsUnknownFunctionResultError(const Value& result) {
 // resolve to a single function implementation and a descriptor or none.
 using ResolveResult = absl::optional<cel::FunctionOverloadReference>;
 
+// Adaptive inline cache for overload resolution at dyn-typed call sites.
+//
+// Plans built from unchecked ASTs keep every registered overload as a
+// candidate and scan them all on each call. The argument kinds observed at a
+// given call site are almost always stable, so once the same kind signature
+// resolves to the same overload kSpecializationThreshold times in a row, the
+// resolved index is installed behind a guard on the packed signature and the
+// scan is skipped. A guard mismatch (deoptimization) falls back to the
+// generic scan and may later re-specialize for the new signature.
+//
+// Only successful unique resolutions are recorded, and the candidate list is
+// immutable for the life of the plan, so a guard hit always yields exactly
+// the overload the generic scan would have picked -- including never masking
+// the ambiguous-overload error, which is only reachable through signatures
+// that were never recorded. State lives in single atomic words updated with
+// relaxed ordering; a stale read only costs one generic scan.
+class OverloadInlineCache {
+ public:
+  // Signatures pack one byte per argument; limiting the arity keeps the
+  // packed signature and overload index together in one 64-bit word.
+  static constexpr size_t kMaxArgs = 5;
+  static constexpr uint32_t kSpecializationThreshold = 4;
+
+  // Packs the runtime argument kinds into a nonzero signature, or returns 0
+  // if the call shape does not fit in the cache.
+  static uint64_t Signature(absl::Span<const ValueKind> argument_kinds) {
+    if (argument_kinds.size() > kMaxArgs) {
+      return 0;
+    }
+    uint64_t signature = 1;
+    for (ValueKind kind : argument_kinds) {
+      signature = (signature << 8) |
+                  (static_cast<uint64_t>(ValueKindToKind(kind)) + 1);
+    }
+    return signature;
+  }
+
+  // Returns the specialized overload index if the guard matches.
+  absl::optional<size_t> Lookup(uint64_t signature) const {
+    uint64_t entry = specialized_.load(std::memory_order_relaxed);
+    if (signature != 0 && (entry >> 16) == signature) {
+      return entry & 0xffff;
+    }
+    return absl::nullopt;
+  }
+
+  // Records a successful unique resolution, installing the specialization
+  // once the same signature has been seen kSpecializationThreshold times in
+  // a row.
+  void Record(uint64_t signature, size_t index) const {
+    if (signature == 0 || index > 0xffff) {
+      return;
+    }
+    uint64_t pending = pending_.load(std::memory_order_relaxed);
+    if ((pending & kSignatureMask) != signature) {
+      pending_.store(signature | (uint64_t{1} << 56),
+                     std::memory_order_relaxed);
+      return;
+    }
+    uint32_t count = static_cast<uint32_t>(pending >> 56);
+    if (count + 1 >= kSpecializationThreshold) {
+      specialized_.store((signature << 16) | index, std::memory_order_relaxed);
+    } else {
+      pending_.store(signature | (uint64_t{count + 1} << 56),
+                     std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  // Signatures occupy at most 1 + 8 * kMaxArgs = 41 bits.
+  static constexpr uint64_t kSignatureMask = (uint64_t{1} << 56) - 1;
+
+  mutable std::atomic<uint64_t> specialized_{0};
+  mutable std::atomic<uint64_t> pending_{0};
+};
+
 // Implementation of ExpressionStep that finds suitable CelFunction overload and
 // invokes it. Abstract base class standardizes behavior between lazy and eager
 // function bindings. Derived classes provide ResolveFunction behavior.
@@ -158,6 +250,9 @@ class AbstractFunctionStep : public ExpressionStepBase {
 
   absl::Status Evaluate(ExecutionFrame* frame) const override;
 
+  // Overload resolution plus an extension function invocation per dispatch.
+  int64_t Cost() const override { return 4; }
+
   // Handles overload resolution and updating result appropriately.
   // Shouldn't update frame state.
   //
@@ -167,8 +262,11 @@ class AbstractFunctionStep : public ExpressionStepBase {
   // cel::ErrorValue.
   absl::StatusOr<Value> DoEvaluate(ExecutionFrame* frame) const;
 
+  // Resolution dispatches on argument kinds only, so implementations take the
+  // dense kind span rather than the argument values.
   virtual absl::StatusOr<ResolveResult> ResolveFunction(
-      absl::Span<const cel::Value> args, const ExecutionFrame* frame) const = 0;
+      absl::Span<const ValueKind> arg_kinds,
+      const ExecutionFrame* frame) const = 0;
 
  protected:
   std::string name_;
@@ -191,6 +289,43 @@ inline absl::StatusOr<Value> Invoke(
   return result;
 }
 
+// Hands an asynchronous overload to the execution frame: the frame's driver
+// starts the call once this step has returned and the frame is quiescent,
+// and the result is applied to the value stack when the call completes.
+void SuspendInvoke(const cel::AsyncFunction& async_function,
+                   const cel::FunctionOverloadReference& overload,
+                   int64_t expr_id, size_t num_arguments,
+                   absl::Span<const cel::Value> input_args,
+                   ExecutionFrame* frame) {
+  // Arguments are copied: preprocessed unknown arguments are otherwise scoped
+  // to this step, and the value stack is only updated on resume.
+  std::vector<cel::Value> args(input_args.begin(), input_args.end());
+
+  ExecutionFrame::PendingAsyncCall call;
+  call.start = [&async_function, args,
+                value_manager = &frame->value_manager()](
+                   cel::AsyncFunction::DoneCallback done) {
+    FunctionEvaluationContext context(*value_manager);
+    async_function.InvokeAsync(context, args, std::move(done));
+  };
+  call.on_resume = [descriptor = &overload.descriptor, expr_id, num_arguments,
+                    args](ExecutionFrame& frame,
+                          absl::StatusOr<cel::Value> result) -> absl::Status {
+    if (!result.ok()) {
+      return result.status();
+    }
+    cel::Value value = std::move(*result);
+    if (frame.unknown_function_results_enabled() &&
+        IsUnknownFunctionResultError(value)) {
+      value = frame.attribute_utility().CreateUnknownSet(*descriptor, expr_id,
+                                                         args);
+    }
+    frame.value_stack().PopAndPush(num_arguments, std::move(value));
+    return absl::OkStatus();
+  };
+  frame->SuspendForAsyncCall(std::move(call));
+}
+
 Value NoOverloadResult(absl::string_view name,
                        absl::Span<const cel::Value> args,
                        ExecutionFrameBase& frame) {
@@ -225,23 +360,41 @@ absl::StatusOr<Value> AbstractFunctionStep::DoEvaluate(
     ExecutionFrame* frame) const {
   // Create Span object that contains input arguments to the function.
   auto input_args = frame->value_stack().GetSpan(num_arguments_);
+  // Kinds come from the stack's dense kind lane; resolution and overload
+  // acceptance checks then scan it without touching the argument values.
+  absl::Span<const ValueKind> arg_kinds =
+      frame->value_stack().GetKindSpan(num_arguments_);
 
   std::vector<cel::Value> unknowns_args;
+  absl::InlinedVector<ValueKind, 4> unknowns_kinds;
   // Preprocess args. If an argument is partially unknown, convert it to an
   // unknown attribute set.
   if (frame->enable_unknowns()) {
     auto input_attrs = frame->value_stack().GetAttributeSpan(num_arguments_);
     unknowns_args = CheckForPartialUnknowns(frame, input_args, input_attrs);
     input_args = absl::MakeConstSpan(unknowns_args);
+    unknowns_kinds = ArgumentKinds(input_args);
+    arg_kinds = absl::MakeConstSpan(unknowns_kinds);
   }
 
   // Derived class resolves to a single function overload or none.
   CEL_ASSIGN_OR_RETURN(ResolveResult matched_function,
-                       ResolveFunction(input_args, frame));
+                       ResolveFunction(arg_kinds, frame));
 
   // Overload found and is allowed to consume the arguments.
   if (matched_function.has_value() &&
-      ShouldAcceptOverload(matched_function->descriptor, input_args)) {
+      ShouldAcceptOverload(matched_function->descriptor, arg_kinds)) {
+    if (ABSL_PREDICT_FALSE(frame->async_evaluation_enabled())) {
+      if (const cel::AsyncFunction* async_function =
+              matched_function->implementation.AsAsyncFunction();
+          async_function != nullptr) {
+        SuspendInvoke(*async_function, *matched_function, id(),
+                      num_arguments_, input_args, frame);
+        // Placeholder result; the suspending frame defers the stack update
+        // to the call's completion.
+        return cel::Value();
+      }
+    }
     return Invoke(*matched_function, id(), input_args, *frame);
   }
 
@@ -258,56 +411,74 @@ absl::Status AbstractFunctionStep::Evaluate(ExecutionFrame* frame) const {
   // reasonably be handled as a cel error will appear in the result value.
   CEL_ASSIGN_OR_RETURN(auto result, DoEvaluate(frame));
 
+  if (ABSL_PREDICT_FALSE(frame->has_pending_async_call())) {
+    // Suspended; the value stack is updated when the call completes.
+    return absl::OkStatus();
+  }
+
   frame->value_stack().PopAndPush(num_arguments_, std::move(result));
 
   return absl::OkStatus();
 }
 
 absl::StatusOr<ResolveResult> ResolveStatic(
-    absl::Span<const cel::Value> input_args,
-    absl::Span<const cel::FunctionOverloadReference> overloads) {
+    absl::Span<const ValueKind> arg_kinds,
+    absl::Span<const cel::FunctionOverloadReference> overloads,
+    const OverloadInlineCache& cache) {
+  uint64_t signature = OverloadInlineCache::Signature(arg_kinds);
+  if (absl::optional<size_t> specialized = cache.Lookup(signature);
+      specialized.has_value()) {
+    return ResolveResult(overloads[*specialized]);
+  }
+
   ResolveResult result = absl::nullopt;
+  size_t matched_index = 0;
 
-  for (const auto& overload : overloads) {
-    if (ArgumentKindsMatch(overload.descriptor, input_args)) {
+  for (size_t i = 0; i < overloads.size(); ++i) {
+    if (ArgumentKindsMatch(overloads[i].descriptor, arg_kinds)) {
       // More than one overload matches our arguments.
       if (result.has_value()) {
         return absl::Status(absl::StatusCode::kInternal,
                             "Cannot resolve overloads");
       }
 
-      result.emplace(overload);
+      result.emplace(overloads[i]);
+      matched_index = i;
     }
   }
+  if (result.has_value()) {
+    cache.Record(signature, matched_index);
+  }
   return result;
 }
 
 absl::StatusOr<ResolveResult> ResolveLazy(
-    absl::Span<const cel::Value> input_args, absl::string_view name,
+    absl::Span<const ValueKind> arg_kinds, absl::string_view name,
     bool receiver_style,
     absl::Span<const cel::FunctionRegistry::LazyOverload> providers,
     const ExecutionFrameBase& frame) {
   ResolveResult result = absl::nullopt;
 
-  std::vector<cel::Kind> arg_types(input_args.size());
-
-  std::transform(
-      input_args.begin(), input_args.end(), arg_types.begin(),
-      [](const cel::Value& value) { return ValueKindToKind(value->kind()); });
-
-  cel::FunctionDescriptor matcher{name, receiver_style, arg_types};
+  // Inline buffer for the call signature; building a FunctionDescriptor
+  // matcher here would heap-allocate its type list on every call.
+  absl::InlinedVector<cel::Kind, 4> arg_types;
+  arg_types.reserve(arg_kinds.size());
+  for (ValueKind kind : arg_kinds) {
+    arg_types.push_back(ValueKindToKind(kind));
+  }
 
   const cel::ActivationInterface& activation = frame.activation();
   for (auto provider : providers) {
     // The LazyFunctionStep has so far only resolved by function shape, check
     // that the runtime argument kinds agree with the specific descriptor for
     // the provider candidates.
-    if (!ArgumentKindsMatch(provider.descriptor, input_args)) {
+    if (!ArgumentKindsMatch(provider.descriptor, arg_kinds)) {
       continue;
     }
 
     CEL_ASSIGN_OR_RETURN(auto overload,
-                         provider.provider.GetFunction(matcher, activation));
+                         provider.provider.GetFunction(name, receiver_style,
+                                                       arg_types, activation));
     if (overload.has_value()) {
       // More than one overload matches our arguments.
       if (result.has_value()) {
@@ -330,13 +501,39 @@ class EagerFunctionStep : public AbstractFunctionStep {
         overloads_(std::move(overloads)) {}
 
   absl::StatusOr<ResolveResult> ResolveFunction(
-      absl::Span<const cel::Value> input_args,
+      absl::Span<const ValueKind> arg_kinds,
       const ExecutionFrame* frame) const override {
-    return ResolveStatic(input_args, overloads_);
+    return ResolveStatic(arg_kinds, overloads_, inline_cache_);
   }
 
  private:
   std::vector<cel::FunctionOverloadReference> overloads_;
+  OverloadInlineCache inline_cache_;
+};
+
+// Specialization of EagerFunctionStep for calls the type checker resolved to
+// exactly one overload. Resolution degenerates to a single kind check (still
+// needed so errors and unknowns in arguments follow the no-overload path)
+// with no candidate scan or ambiguity bookkeeping per call.
+class SingleOverloadEagerFunctionStep : public AbstractFunctionStep {
+ public:
+  SingleOverloadEagerFunctionStep(cel::FunctionOverloadReference overload,
+                                  const std::string& name, size_t num_args,
+                                  int64_t expr_id)
+      : AbstractFunctionStep(name, num_args, expr_id),
+        overload_(std::move(overload)) {}
+
+  absl::StatusOr<ResolveResult> ResolveFunction(
+      absl::Span<const ValueKind> arg_kinds,
+      const ExecutionFrame* frame) const override {
+    if (ArgumentKindsMatch(overload_.descriptor, arg_kinds)) {
+      return ResolveResult(overload_);
+    }
+    return ResolveResult(absl::nullopt);
+  }
+
+ private:
+  cel::FunctionOverloadReference overload_;
 };
 
 class LazyFunctionStep : public AbstractFunctionStep {
@@ -352,7 +549,7 @@ class LazyFunctionStep : public AbstractFunctionStep {
         providers_(std::move(providers)) {}
 
   absl::StatusOr<ResolveResult> ResolveFunction(
-      absl::Span<const cel::Value> input_args,
+      absl::Span<const ValueKind> arg_kinds,
       const ExecutionFrame* frame) const override;
 
  private:
@@ -361,9 +558,8 @@ class LazyFunctionStep : public AbstractFunctionStep {
 };
 
 absl::StatusOr<ResolveResult> LazyFunctionStep::ResolveFunction(
-    absl::Span<const cel::Value> input_args,
-    const ExecutionFrame* frame) const {
-  return ResolveLazy(input_args, name_, receiver_style_, providers_, *frame);
+    absl::Span<const ValueKind> arg_kinds, const ExecutionFrame* frame) const {
+  return ResolveLazy(arg_kinds, name_, receiver_style_, providers_, *frame);
 }
 
 class StaticResolver {
@@ -371,13 +567,32 @@ class StaticResolver {
   explicit StaticResolver(std::vector<cel::FunctionOverloadReference> overloads)
       : overloads_(std::move(overloads)) {}
 
-  absl::StatusOr<ResolveResult> Resolve(ExecutionFrameBase& frame,
-                                        absl::Span<const Value> input) const {
-    return ResolveStatic(input, overloads_);
+  absl::StatusOr<ResolveResult> Resolve(
+      ExecutionFrameBase& frame, absl::Span<const ValueKind> arg_kinds) const {
+    return ResolveStatic(arg_kinds, overloads_, inline_cache_);
   }
 
  private:
   std::vector<cel::FunctionOverloadReference> overloads_;
+  OverloadInlineCache inline_cache_;
+};
+
+// Counterpart of SingleOverloadEagerFunctionStep for the recursive plan.
+class SingleStaticResolver {
+ public:
+  explicit SingleStaticResolver(cel::FunctionOverloadReference overload)
+      : overload_(std::move(overload)) {}
+
+  absl::StatusOr<ResolveResult> Resolve(
+      ExecutionFrameBase& frame, absl::Span<const ValueKind> arg_kinds) const {
+    if (ArgumentKindsMatch(overload_.descriptor, arg_kinds)) {
+      return ResolveResult(overload_);
+    }
+    return ResolveResult(absl::nullopt);
+  }
+
+ private:
+  cel::FunctionOverloadReference overload_;
 };
 
 class LazyResolver {
@@ -389,9 +604,9 @@ class LazyResolver {
         name_(std::move(name)),
         receiver_style_(receiver_style) {}
 
-  absl::StatusOr<ResolveResult> Resolve(ExecutionFrameBase& frame,
-                                        absl::Span<const Value> input) const {
-    return ResolveLazy(input, name_, receiver_style_, providers_, frame);
+  absl::StatusOr<ResolveResult> Resolve(
+      ExecutionFrameBase& frame, absl::Span<const ValueKind> arg_kinds) const {
+    return ResolveLazy(arg_kinds, name_, receiver_style_, providers_, frame);
   }
 
  private:
@@ -435,11 +650,13 @@ class DirectFunctionStepImpl : public DirectExpressionStep {
       }
     }
 
+    absl::InlinedVector<ValueKind, 4> arg_kinds = ArgumentKinds(args);
+
     CEL_ASSIGN_OR_RETURN(ResolveResult resolved_function,
-                         resolver_.Resolve(frame, args));
+                         resolver_.Resolve(frame, arg_kinds));
 
     if (resolved_function.has_value() &&
-        ShouldAcceptOverload(resolved_function->descriptor, args)) {
+        ShouldAcceptOverload(resolved_function->descriptor, arg_kinds)) {
       CEL_ASSIGN_OR_RETURN(result,
                            Invoke(*resolved_function, expr_id_, args, frame));
 
@@ -479,6 +696,11 @@ std::unique_ptr<DirectExpressionStep> CreateDirectFunctionStep(
     int64_t expr_id, const cel::ast_internal::Call& call,
     std::vector<std::unique_ptr<DirectExpressionStep>> deps,
     std::vector<cel::FunctionOverloadReference> overloads) {
+  if (overloads.size() == 1) {
+    return std::make_unique<DirectFunctionStepImpl<SingleStaticResolver>>(
+        expr_id, call.function(), std::move(deps),
+        SingleStaticResolver(std::move(overloads[0])));
+  }
   return std::make_unique<DirectFunctionStepImpl<StaticResolver>>(
       expr_id, call.function(), std::move(deps),
       StaticResolver(std::move(overloads)));
@@ -509,6 +731,10 @@ absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateFunctionStep(
   bool receiver_style = call_expr.has_target();
   size_t num_args = call_expr.args().size() + (receiver_style ? 1 : 0);
   const std::string& name = call_expr.function();
+  if (overloads.size() == 1) {
+    return std::make_unique<SingleOverloadEagerFunctionStep>(
+        std::move(overloads[0]), name, num_args, expr_id);
+  }
   return std::make_unique<EagerFunctionStep>(std::move(overloads), name,
                                              num_args, expr_id);
 }
@@ -516,6 +516,56 @@ TEST_P(FunctionStepTest, LazyFunctionOverloadingTest) {
   EXPECT_TRUE(value.BoolOrDie());
 }
 
+// Repeated evaluation with stable argument kinds specializes the dispatch
+// through the overload inline cache; a kind change afterwards must deoptimize
+// back to generic resolution and pick the other overload.
+TEST_P(FunctionStepTest, OverloadInlineCacheSpecializesAndDeoptimizes) {
+  CelFunctionRegistry registry;
+  ASSERT_OK(registry.Register(PortableUnaryFunctionAdapter<int64_t, int64_t>::Create(
+      "KindId", false, [](google::protobuf::Arena*, int64_t) -> int64_t { return 1; })));
+  ASSERT_OK(
+      registry.Register(PortableUnaryFunctionAdapter<int64_t, uint64_t>::Create(
+          "KindId", false,
+          [](google::protobuf::Arena*, uint64_t) -> int64_t { return 2; })));
+
+  cel::ast_internal::Ident ident;
+  ident.set_name("x");
+  cel::ast_internal::Call call;
+  call.mutable_args().emplace_back();
+  call.set_function("KindId");
+
+  ExecutionPath path;
+  ASSERT_OK_AND_ASSIGN(auto step0, CreateIdentStep(ident, GetExprId()));
+  ASSERT_OK_AND_ASSIGN(auto step1, MakeTestFunctionStep(call, registry));
+  path.push_back(std::move(step0));
+  path.push_back(std::move(step1));
+
+  std::unique_ptr<CelExpressionFlatImpl> impl = GetExpression(std::move(path));
+
+  google::protobuf::Arena arena;
+
+  // Enough evaluations with int arguments to install the specialization.
+  Activation int_activation;
+  int_activation.InsertValue("x", CelValue::CreateInt64(42));
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_OK_AND_ASSIGN(CelValue value,
+                         impl->Evaluate(int_activation, &arena));
+    ASSERT_TRUE(value.IsInt64());
+    EXPECT_THAT(value.Int64OrDie(), Eq(1));
+  }
+
+  // A different argument kind misses the guard and resolves generically.
+  Activation uint_activation;
+  uint_activation.InsertValue("x", CelValue::CreateUint64(42));
+  ASSERT_OK_AND_ASSIGN(CelValue value, impl->Evaluate(uint_activation, &arena));
+  ASSERT_TRUE(value.IsInt64());
+  EXPECT_THAT(value.Int64OrDie(), Eq(2));
+
+  ASSERT_OK_AND_ASSIGN(value, impl->Evaluate(int_activation, &arena));
+  ASSERT_TRUE(value.IsInt64());
+  EXPECT_THAT(value.Int64OrDie(), Eq(1));
+}
+
 // Test situation when no overloads match input arguments during evaluation
 // and at least one of arguments is error.
 TEST_P(FunctionStepTest,
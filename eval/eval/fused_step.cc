@@ -0,0 +1,39 @@
+#include "eval/eval/fused_step.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/expression_step_base.h"
+#include "internal/status_macros.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+class FusedStep final : public ExpressionStepBase {
+ public:
+  FusedStep(ExecutionPath steps, int64_t expr_id)
+      : ExpressionStepBase(expr_id), steps_(std::move(steps)) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    for (const auto& step : steps_) {
+      CEL_RETURN_IF_ERROR(step->Evaluate(frame));
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  ExecutionPath steps_;
+};
+
+}  // namespace
+
+std::unique_ptr<ExpressionStep> CreateFusedStep(ExecutionPath steps,
+                                                int64_t expr_id) {
+  return std::make_unique<FusedStep>(std::move(steps), expr_id);
+}
+
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,25 @@
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_FUSED_STEP_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_FUSED_STEP_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "eval/eval/evaluator_core.h"
+
+namespace google::api::expr::runtime {
+
+// Factory method for a step that evaluates a straight-line sequence of inner
+// steps in a single dispatch from the evaluator loop.
+//
+// The inner steps must be jump free: they may only manipulate the value stack
+// and evaluator state, never the program counter. Plans produced for ident and
+// select expressions qualify; logic, ternary, and comprehension steps do not.
+//
+// The fused step reports `expr_id` as its AST id, so per-step tracing observes
+// one callback for the whole sequence.
+std::unique_ptr<ExpressionStep> CreateFusedStep(ExecutionPath steps,
+                                                int64_t expr_id);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_FUSED_STEP_H_
@@ -20,6 +20,7 @@
 #include "eval/eval/expression_step_base.h"
 #include "eval/internal/errors.h"
 #include "internal/status_macros.h"
+#include "runtime/slot_activation.h"
 
 namespace google::api::expr::runtime {
 
@@ -30,17 +31,26 @@ using ::cel::runtime_internal::CreateError;
 
 class IdentStep : public ExpressionStepBase {
  public:
-  IdentStep(absl::string_view name, int64_t expr_id)
-      : ExpressionStepBase(expr_id), name_(name) {}
+  IdentStep(absl::string_view name, int64_t expr_id,
+            std::shared_ptr<const cel::VariableBindingPlan> plan = nullptr,
+            size_t slot = 0)
+      : ExpressionStepBase(expr_id),
+        name_(name),
+        plan_(std::move(plan)),
+        slot_(slot) {}
 
   absl::Status Evaluate(ExecutionFrame* frame) const override;
 
  private:
   std::string name_;
+  std::shared_ptr<const cel::VariableBindingPlan> plan_;
+  size_t slot_;
 };
 
 absl::Status LookupIdent(const std::string& name, ExecutionFrameBase& frame,
-                         Value& result, AttributeTrail& attribute) {
+                         Value& result, AttributeTrail& attribute,
+                         const cel::VariableBindingPlan* plan = nullptr,
+                         size_t slot = 0) {
   if (frame.attribute_tracking_enabled()) {
     attribute = AttributeTrail(name);
     if (frame.missing_attribute_errors_enabled() &&
@@ -58,8 +68,24 @@ absl::Status LookupIdent(const std::string& name, ExecutionFrameBase& frame,
     }
   }
 
-  CEL_ASSIGN_OR_RETURN(auto found, frame.activation().FindVariable(
-                                       frame.value_manager(), name, result));
+  // Fast path: an activation built against the same binding plan stores the
+  // variable at a precomputed slot, so resolution is an array read instead
+  // of a hash lookup per access.
+  if (plan != nullptr) {
+    if (const cel::SlotActivation* slots =
+            frame.activation().AsSlotActivation();
+        slots != nullptr && &slots->plan() == plan) {
+      if (const Value* value = slots->GetSlot(slot); value != nullptr) {
+        result = *value;
+        return absl::OkStatus();
+      }
+      result = frame.value_manager().CreateErrorValue(CreateError(absl::StrCat(
+          "No value with name \"", name, "\" found in Activation")));
+      return absl::OkStatus();
+    }
+  }
+
+  CEL_ASSIGN_OR_RETURN(auto found, frame.ResolveVariable(name, result));
 
   if (found) {
     return absl::OkStatus();
@@ -75,7 +101,8 @@ absl::Status IdentStep::Evaluate(ExecutionFrame* frame) const {
   Value value;
   AttributeTrail attribute;
 
-  CEL_RETURN_IF_ERROR(LookupIdent(name_, *frame, value, attribute));
+  CEL_RETURN_IF_ERROR(
+      LookupIdent(name_, *frame, value, attribute, plan_.get(), slot_));
 
   frame->value_stack().Push(std::move(value), std::move(attribute));
 
@@ -114,16 +141,24 @@ class SlotStep : public ExpressionStepBase {
 
 class DirectIdentStep : public DirectExpressionStep {
  public:
-  DirectIdentStep(absl::string_view name, int64_t expr_id)
-      : DirectExpressionStep(expr_id), name_(name) {}
+  DirectIdentStep(absl::string_view name, int64_t expr_id,
+                  std::shared_ptr<const cel::VariableBindingPlan> plan =
+                      nullptr,
+                  size_t slot = 0)
+      : DirectExpressionStep(expr_id),
+        name_(name),
+        plan_(std::move(plan)),
+        slot_(slot) {}
 
   absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
                         AttributeTrail& attribute) const override {
-    return LookupIdent(name_, frame, result, attribute);
+    return LookupIdent(name_, frame, result, attribute, plan_.get(), slot_);
   }
 
  private:
   std::string name_;
+  std::shared_ptr<const cel::VariableBindingPlan> plan_;
+  size_t slot_;
 };
 
 class DirectSlotStep : public DirectExpressionStep {
@@ -157,6 +192,13 @@ std::unique_ptr<DirectExpressionStep> CreateDirectIdentStep(
   return std::make_unique<DirectIdentStep>(identifier, expr_id);
 }
 
+std::unique_ptr<DirectExpressionStep> CreateDirectBoundIdentStep(
+    absl::string_view identifier, int64_t expr_id,
+    std::shared_ptr<const cel::VariableBindingPlan> plan, size_t slot) {
+  return std::make_unique<DirectIdentStep>(identifier, expr_id,
+                                           std::move(plan), slot);
+}
+
 std::unique_ptr<DirectExpressionStep> CreateDirectSlotIdentStep(
     absl::string_view identifier, size_t slot_index, int64_t expr_id) {
   return std::make_unique<DirectSlotStep>(std::string(identifier), slot_index,
@@ -168,6 +210,13 @@ absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateIdentStep(
   return std::make_unique<IdentStep>(ident_expr.name(), expr_id);
 }
 
+absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateBoundIdentStep(
+    const cel::ast_internal::Ident& ident_expr, int64_t expr_id,
+    std::shared_ptr<const cel::VariableBindingPlan> plan, size_t slot) {
+  return std::make_unique<IdentStep>(ident_expr.name(), expr_id,
+                                     std::move(plan), slot);
+}
+
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateIdentStepForSlot(
     const cel::ast_internal::Ident& ident_expr, size_t slot_index,
     int64_t expr_id) {
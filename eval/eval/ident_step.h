@@ -1,6 +1,7 @@
 #ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_IDENT_STEP_H_
 #define THIRD_PARTY_CEL_CPP_EVAL_EVAL_IDENT_STEP_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 
@@ -9,12 +10,22 @@
 #include "base/ast_internal/expr.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
+#include "runtime/slot_activation.h"
 
 namespace google::api::expr::runtime {
 
 std::unique_ptr<DirectExpressionStep> CreateDirectIdentStep(
     absl::string_view identifier, int64_t expr_id);
 
+// Identifier step bound to a slot in the given variable binding plan.
+//
+// When evaluated against a SlotActivation built from the same plan, the
+// variable is read directly from the activation's slot array; any other
+// activation falls back to lookup by name.
+std::unique_ptr<DirectExpressionStep> CreateDirectBoundIdentStep(
+    absl::string_view identifier, int64_t expr_id,
+    std::shared_ptr<const cel::VariableBindingPlan> plan, size_t slot);
+
 std::unique_ptr<DirectExpressionStep> CreateDirectSlotIdentStep(
     absl::string_view identifier, size_t slot_index, int64_t expr_id);
 
@@ -22,6 +33,11 @@ std::unique_ptr<DirectExpressionStep> CreateDirectSlotIdentStep(
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateIdentStep(
     const cel::ast_internal::Ident& ident, int64_t expr_id);
 
+// Stack machine variant of CreateDirectBoundIdentStep.
+absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateBoundIdentStep(
+    const cel::ast_internal::Ident& ident, int64_t expr_id,
+    std::shared_ptr<const cel::VariableBindingPlan> plan, size_t slot);
+
 // Factory method for identifier that has been assigned to a slot.
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateIdentStepForSlot(
     const cel::ast_internal::Ident& ident_expr, size_t slot_index,
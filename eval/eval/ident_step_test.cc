@@ -6,6 +6,10 @@
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "base/attribute.h"
 #include "base/type_provider.h"
 #include "common/memory.h"
 #include "common/value.h"
@@ -14,10 +18,14 @@
 #include "eval/eval/evaluator_core.h"
 #include "eval/public/activation.h"
 #include "eval/public/cel_attribute.h"
+#include "common/value_manager.h"
 #include "internal/testing.h"
 #include "runtime/activation.h"
+#include "runtime/activation_interface.h"
+#include "runtime/function_overload_reference.h"
 #include "runtime/managed_value_factory.h"
 #include "runtime/runtime_options.h"
+#include "runtime/slot_activation.h"
 
 namespace google::api::expr::runtime {
 
@@ -301,6 +309,199 @@ TEST(DirectIdentStepTest, NotFound) {
                        HasSubstr("\"var1\" found in Activation")));
 }
 
+TEST(BoundIdentStepTest, ResolvesFromSlotActivation) {
+  ManagedValueFactory value_factory(TypeProvider::Builtin(),
+                                    MemoryManagerRef::ReferenceCounting());
+  auto plan = std::make_shared<cel::VariableBindingPlan>();
+  size_t slot = plan->AssignSlot("var1");
+
+  cel::SlotActivation activation(plan);
+  activation.BindSlot(slot, IntValue(42));
+
+  RuntimeOptions options;
+  ExecutionFrameBase frame(activation, options, value_factory.get());
+  Value result;
+  AttributeTrail trail;
+
+  auto step = CreateDirectBoundIdentStep("var1", -1, plan, slot);
+
+  ASSERT_OK(step->Evaluate(frame, result, trail));
+
+  ASSERT_TRUE(InstanceOf<IntValue>(result));
+  EXPECT_THAT(Cast<IntValue>(result).NativeValue(), Eq(42));
+}
+
+TEST(BoundIdentStepTest, UnboundSlotBehavesAsAbsent) {
+  ManagedValueFactory value_factory(TypeProvider::Builtin(),
+                                    MemoryManagerRef::ReferenceCounting());
+  auto plan = std::make_shared<cel::VariableBindingPlan>();
+  size_t slot = plan->AssignSlot("var1");
+
+  cel::SlotActivation activation(plan);
+
+  RuntimeOptions options;
+  ExecutionFrameBase frame(activation, options, value_factory.get());
+  Value result;
+  AttributeTrail trail;
+
+  auto step = CreateDirectBoundIdentStep("var1", -1, plan, slot);
+
+  ASSERT_OK(step->Evaluate(frame, result, trail));
+
+  ASSERT_TRUE(InstanceOf<ErrorValue>(result));
+  EXPECT_THAT(Cast<ErrorValue>(result).NativeValue(),
+              StatusIs(absl::StatusCode::kUnknown,
+                       HasSubstr("\"var1\" found in Activation")));
+}
+
+TEST(BoundIdentStepTest, FallsBackToNameLookupForOtherActivations) {
+  ManagedValueFactory value_factory(TypeProvider::Builtin(),
+                                    MemoryManagerRef::ReferenceCounting());
+  auto plan = std::make_shared<cel::VariableBindingPlan>();
+  size_t slot = plan->AssignSlot("var1");
+
+  cel::Activation activation;
+  activation.InsertOrAssignValue("var1", IntValue(42));
+
+  RuntimeOptions options;
+  ExecutionFrameBase frame(activation, options, value_factory.get());
+  Value result;
+  AttributeTrail trail;
+
+  auto step = CreateDirectBoundIdentStep("var1", -1, plan, slot);
+
+  ASSERT_OK(step->Evaluate(frame, result, trail));
+
+  ASSERT_TRUE(InstanceOf<IntValue>(result));
+  EXPECT_THAT(Cast<IntValue>(result).NativeValue(), Eq(42));
+}
+
+TEST(BoundIdentStepTest, MismatchedPlanFallsBackToNameLookup) {
+  ManagedValueFactory value_factory(TypeProvider::Builtin(),
+                                    MemoryManagerRef::ReferenceCounting());
+  auto planned_against = std::make_shared<cel::VariableBindingPlan>();
+  size_t slot = planned_against->AssignSlot("var1");
+
+  // Activation built against a different plan with a different layout.
+  auto other_plan = std::make_shared<cel::VariableBindingPlan>();
+  other_plan->AssignSlot("unrelated");
+  other_plan->AssignSlot("var1");
+  cel::SlotActivation activation(other_plan);
+  ASSERT_TRUE(activation.Bind("var1", IntValue(42)));
+
+  RuntimeOptions options;
+  ExecutionFrameBase frame(activation, options, value_factory.get());
+  Value result;
+  AttributeTrail trail;
+
+  auto step = CreateDirectBoundIdentStep("var1", -1, planned_against, slot);
+
+  ASSERT_OK(step->Evaluate(frame, result, trail));
+
+  ASSERT_TRUE(InstanceOf<IntValue>(result));
+  EXPECT_THAT(Cast<IntValue>(result).NativeValue(), Eq(42));
+}
+
+// Activation that produces a fresh value on every lookup, simulating a
+// non-memoizing provider (e.g. one reading the clock for `now`).
+class FreshValueActivation : public cel::ActivationInterface {
+ public:
+  absl::StatusOr<bool> FindVariable(cel::ValueManager& factory,
+                                    absl::string_view name,
+                                    Value& result) const override {
+    ++lookups;
+    if (name != "now") {
+      return false;
+    }
+    result = IntValue(lookups);
+    return true;
+  }
+  using cel::ActivationInterface::FindVariable;
+
+  std::vector<cel::FunctionOverloadReference> FindFunctionOverloads(
+      absl::string_view name) const override {
+    return {};
+  }
+
+  absl::Span<const cel::AttributePattern> GetUnknownAttributes()
+      const override {
+    return {};
+  }
+
+  absl::Span<const cel::AttributePattern> GetMissingAttributes()
+      const override {
+    return {};
+  }
+
+  mutable int lookups = 0;
+};
+
+TEST(AmbientIdentStepTest, AmbientVariableSnapshottedOncePerEvaluation) {
+  ManagedValueFactory value_factory(TypeProvider::Builtin(),
+                                    MemoryManagerRef::ReferenceCounting());
+  FreshValueActivation activation;
+  RuntimeOptions options;
+  options.ambient_variables = {"now"};
+
+  ExecutionFrameBase frame(activation, options, value_factory.get());
+  Value first;
+  Value second;
+  AttributeTrail trail;
+
+  auto step = CreateDirectIdentStep("now", -1);
+
+  ASSERT_OK(step->Evaluate(frame, first, trail));
+  ASSERT_OK(step->Evaluate(frame, second, trail));
+
+  // Both references see the snapshot taken by the first one.
+  EXPECT_EQ(activation.lookups, 1);
+  ASSERT_TRUE(InstanceOf<IntValue>(first));
+  ASSERT_TRUE(InstanceOf<IntValue>(second));
+  EXPECT_THAT(Cast<IntValue>(second).NativeValue(),
+              Eq(Cast<IntValue>(first).NativeValue()));
+}
+
+TEST(AmbientIdentStepTest, NonAmbientVariableResolvedEachTime) {
+  ManagedValueFactory value_factory(TypeProvider::Builtin(),
+                                    MemoryManagerRef::ReferenceCounting());
+  FreshValueActivation activation;
+  RuntimeOptions options;
+
+  ExecutionFrameBase frame(activation, options, value_factory.get());
+  Value first;
+  Value second;
+  AttributeTrail trail;
+
+  auto step = CreateDirectIdentStep("now", -1);
+
+  ASSERT_OK(step->Evaluate(frame, first, trail));
+  ASSERT_OK(step->Evaluate(frame, second, trail));
+
+  EXPECT_EQ(activation.lookups, 2);
+}
+
+TEST(AmbientIdentStepTest, AbsentAmbientVariablePinned) {
+  ManagedValueFactory value_factory(TypeProvider::Builtin(),
+                                    MemoryManagerRef::ReferenceCounting());
+  FreshValueActivation activation;
+  RuntimeOptions options;
+  options.ambient_variables = {"unbound"};
+
+  ExecutionFrameBase frame(activation, options, value_factory.get());
+  Value result;
+  AttributeTrail trail;
+
+  auto step = CreateDirectIdentStep("unbound", -1);
+
+  ASSERT_OK(step->Evaluate(frame, result, trail));
+  ASSERT_TRUE(InstanceOf<ErrorValue>(result));
+  ASSERT_OK(step->Evaluate(frame, result, trail));
+  ASSERT_TRUE(InstanceOf<ErrorValue>(result));
+
+  // Absence is pinned too; the activation is only consulted once.
+  EXPECT_EQ(activation.lookups, 1);
+}
+
 }  // namespace
 
 }  // namespace google::api::expr::runtime
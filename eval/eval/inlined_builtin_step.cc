@@ -0,0 +1,262 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/inlined_builtin_step.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "base/builtins.h"
+#include "common/casting.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/expression_step_base.h"
+#include "internal/overflow.h"
+#include "internal/status_macros.h"
+#include "runtime/internal/errors.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+using ::cel::BoolValue;
+using ::cel::BytesValue;
+using ::cel::Cast;
+using ::cel::DoubleValue;
+using ::cel::ErrorValue;
+using ::cel::InstanceOf;
+using ::cel::IntValue;
+using ::cel::ListValue;
+using ::cel::MapValue;
+using ::cel::StringValue;
+using ::cel::UintValue;
+using ::cel::Value;
+using ::cel::ValueKind;
+
+absl::string_view FunctionName(InlinedBuiltinOp op) {
+  switch (op) {
+    case InlinedBuiltinOp::kNot:
+      return cel::builtin::kNot;
+    case InlinedBuiltinOp::kNegateInt64:
+    case InlinedBuiltinOp::kNegateDouble:
+      return cel::builtin::kNeg;
+    case InlinedBuiltinOp::kSizeString:
+    case InlinedBuiltinOp::kSizeBytes:
+    case InlinedBuiltinOp::kSizeList:
+    case InlinedBuiltinOp::kSizeMap:
+      return cel::builtin::kSize;
+    case InlinedBuiltinOp::kStringFromInt:
+    case InlinedBuiltinOp::kStringFromUint:
+    case InlinedBuiltinOp::kStringFromDouble:
+      return cel::builtin::kString;
+    case InlinedBuiltinOp::kIntFromString:
+    case InlinedBuiltinOp::kIntFromDouble:
+    case InlinedBuiltinOp::kIntFromUint:
+      return cel::builtin::kInt;
+    case InlinedBuiltinOp::kDoubleFromInt:
+    case InlinedBuiltinOp::kDoubleFromUint:
+    case InlinedBuiltinOp::kDoubleFromString:
+      return cel::builtin::kDouble;
+  }
+  return "";
+}
+
+ValueKind ExpectedKind(InlinedBuiltinOp op) {
+  switch (op) {
+    case InlinedBuiltinOp::kNot:
+      return ValueKind::kBool;
+    case InlinedBuiltinOp::kNegateInt64:
+      return ValueKind::kInt;
+    case InlinedBuiltinOp::kNegateDouble:
+      return ValueKind::kDouble;
+    case InlinedBuiltinOp::kSizeString:
+      return ValueKind::kString;
+    case InlinedBuiltinOp::kSizeBytes:
+      return ValueKind::kBytes;
+    case InlinedBuiltinOp::kSizeList:
+      return ValueKind::kList;
+    case InlinedBuiltinOp::kSizeMap:
+      return ValueKind::kMap;
+    case InlinedBuiltinOp::kStringFromInt:
+    case InlinedBuiltinOp::kDoubleFromInt:
+      return ValueKind::kInt;
+    case InlinedBuiltinOp::kStringFromUint:
+    case InlinedBuiltinOp::kIntFromUint:
+    case InlinedBuiltinOp::kDoubleFromUint:
+      return ValueKind::kUint;
+    case InlinedBuiltinOp::kStringFromDouble:
+    case InlinedBuiltinOp::kIntFromDouble:
+      return ValueKind::kDouble;
+    case InlinedBuiltinOp::kIntFromString:
+    case InlinedBuiltinOp::kDoubleFromString:
+      return ValueKind::kString;
+  }
+  return ValueKind::kError;
+}
+
+// Mirrors the legacy type naming used by function steps when reporting a
+// failed overload resolution. int -> int64, uint -> uint64.
+std::string LegacyKindName(const Value& value) {
+  absl::string_view name = cel::ValueKindToString(value.kind());
+  if (name == "int" || name == "uint") {
+    return absl::StrCat(name, "64");
+  }
+  return std::string(name);
+}
+
+class InlinedBuiltinStep final : public ExpressionStepBase {
+ public:
+  InlinedBuiltinStep(int64_t expr_id, InlinedBuiltinOp op)
+      : ExpressionStepBase(expr_id, /*comes_from_ast=*/true), op_(op) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override;
+
+ private:
+  absl::StatusOr<Value> Apply(ExecutionFrame* frame, const Value& arg) const;
+
+  const InlinedBuiltinOp op_;
+};
+
+absl::StatusOr<Value> InlinedBuiltinStep::Apply(ExecutionFrame* frame,
+                                                const Value& arg) const {
+  switch (op_) {
+    case InlinedBuiltinOp::kNot:
+      return frame->value_factory().CreateBoolValue(
+          !Cast<BoolValue>(arg).NativeValue());
+    case InlinedBuiltinOp::kNegateInt64: {
+      int64_t negated;
+      if (cel::internal::NegationOverflow(Cast<IntValue>(arg).NativeValue(),
+                                          &negated)) {
+        return frame->value_factory().CreateErrorValue(
+            cel::internal::IntegerOverflowError());
+      }
+      return frame->value_factory().CreateIntValue(negated);
+    }
+    case InlinedBuiltinOp::kNegateDouble:
+      return frame->value_factory().CreateDoubleValue(
+          -Cast<DoubleValue>(arg).NativeValue());
+    case InlinedBuiltinOp::kSizeString:
+      return frame->value_factory().CreateIntValue(
+          Cast<StringValue>(arg).Size());
+    case InlinedBuiltinOp::kSizeBytes:
+      return frame->value_factory().CreateIntValue(
+          Cast<BytesValue>(arg).Size());
+    case InlinedBuiltinOp::kSizeList: {
+      CEL_ASSIGN_OR_RETURN(size_t size, Cast<ListValue>(arg).Size());
+      return frame->value_factory().CreateIntValue(
+          static_cast<int64_t>(size));
+    }
+    case InlinedBuiltinOp::kSizeMap: {
+      CEL_ASSIGN_OR_RETURN(size_t size, Cast<MapValue>(arg).Size());
+      return frame->value_factory().CreateIntValue(
+          static_cast<int64_t>(size));
+    }
+    // The conversion cases replicate the semantics (including formatting and
+    // error messages) of runtime/standard/type_conversion_functions.cc.
+    case InlinedBuiltinOp::kStringFromInt:
+      return frame->value_factory().CreateUncheckedStringValue(
+          absl::StrCat(Cast<IntValue>(arg).NativeValue()));
+    case InlinedBuiltinOp::kStringFromUint:
+      return frame->value_factory().CreateUncheckedStringValue(
+          absl::StrCat(Cast<UintValue>(arg).NativeValue()));
+    case InlinedBuiltinOp::kStringFromDouble:
+      return frame->value_factory().CreateUncheckedStringValue(
+          absl::StrCat(Cast<DoubleValue>(arg).NativeValue()));
+    case InlinedBuiltinOp::kIntFromString: {
+      int64_t result;
+      if (!absl::SimpleAtoi(Cast<StringValue>(arg).ToString(), &result)) {
+        return frame->value_factory().CreateErrorValue(
+            absl::InvalidArgumentError("cannot convert string to int"));
+      }
+      return frame->value_factory().CreateIntValue(result);
+    }
+    case InlinedBuiltinOp::kIntFromDouble: {
+      auto conv = cel::internal::CheckedDoubleToInt64(
+          Cast<DoubleValue>(arg).NativeValue());
+      if (!conv.ok()) {
+        return frame->value_factory().CreateErrorValue(conv.status());
+      }
+      return frame->value_factory().CreateIntValue(*conv);
+    }
+    case InlinedBuiltinOp::kIntFromUint: {
+      auto conv = cel::internal::CheckedUint64ToInt64(
+          Cast<UintValue>(arg).NativeValue());
+      if (!conv.ok()) {
+        return frame->value_factory().CreateErrorValue(conv.status());
+      }
+      return frame->value_factory().CreateIntValue(*conv);
+    }
+    case InlinedBuiltinOp::kDoubleFromInt:
+      return frame->value_factory().CreateDoubleValue(
+          static_cast<double>(Cast<IntValue>(arg).NativeValue()));
+    case InlinedBuiltinOp::kDoubleFromUint:
+      return frame->value_factory().CreateDoubleValue(
+          static_cast<double>(Cast<UintValue>(arg).NativeValue()));
+    case InlinedBuiltinOp::kDoubleFromString: {
+      double result;
+      if (!absl::SimpleAtod(Cast<StringValue>(arg).ToString(), &result)) {
+        return frame->value_factory().CreateErrorValue(
+            absl::InvalidArgumentError("cannot convert string to double"));
+      }
+      return frame->value_factory().CreateDoubleValue(result);
+    }
+  }
+  return absl::InternalError("unsupported inlined builtin");
+}
+
+absl::Status InlinedBuiltinStep::Evaluate(ExecutionFrame* frame) const {
+  if (!frame->value_stack().HasEnough(1)) {
+    return absl::Status(absl::StatusCode::kInternal,
+                        "Insufficient arguments supplied for inlined builtin");
+  }
+  const Value& arg = frame->value_stack().Peek();
+
+  // Errors pass through, matching the strict function dispatch this step
+  // replaces.
+  if (InstanceOf<ErrorValue>(arg)) {
+    return absl::OkStatus();
+  }
+
+  if (arg.kind() != ExpectedKind(op_)) {
+    // The checker pinned the operand type, but an activation may still bind
+    // a differently typed value; report it as the unfused dispatch would.
+    Value result = frame->value_factory().CreateErrorValue(
+        cel::runtime_internal::CreateNoMatchingOverloadError(
+            absl::StrCat(FunctionName(op_), "(", LegacyKindName(arg), ")")));
+    frame->value_stack().PopAndPush(std::move(result));
+    return absl::OkStatus();
+  }
+
+  CEL_ASSIGN_OR_RETURN(Value result, Apply(frame, arg));
+  frame->value_stack().PopAndPush(std::move(result));
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateInlinedBuiltinStep(
+    InlinedBuiltinOp op, int64_t expr_id) {
+  return std::make_unique<InlinedBuiltinStep>(expr_id, op);
+}
+
+}  // namespace google::api::expr::runtime
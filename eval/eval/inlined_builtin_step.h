@@ -0,0 +1,56 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_INLINED_BUILTIN_STEP_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_INLINED_BUILTIN_STEP_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "absl/status/statusor.h"
+#include "eval/eval/evaluator_core.h"
+
+namespace google::api::expr::runtime {
+
+// Unary standard builtin pinned by the type checker's overload resolution.
+enum class InlinedBuiltinOp {
+  kNot,           // !_ on bool
+  kNegateInt64,   // -_ on int
+  kNegateDouble,  // -_ on double
+  kSizeString,    // size() on string, in code points
+  kSizeBytes,     // size() on bytes
+  kSizeList,      // size() on list
+  kSizeMap,       // size() on map
+  kStringFromInt,     // string() on int
+  kStringFromUint,    // string() on uint
+  kStringFromDouble,  // string() on double
+  kIntFromString,     // int() on string
+  kIntFromDouble,     // int() on double, checked
+  kIntFromUint,       // int() on uint, checked
+  kDoubleFromInt,     // double() on int
+  kDoubleFromUint,    // double() on uint
+  kDoubleFromString,  // double() on string
+};
+
+// Creates a step evaluating a standard unary builtin directly instead of
+// resolving and dispatching a function overload. The operand is expected on
+// the stack. If the operand does not have the proven type at runtime (a
+// mistyped activation), the step reports a missing overload like the
+// unfused dispatch would.
+absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateInlinedBuiltinStep(
+    InlinedBuiltinOp op, int64_t expr_id);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_INLINED_BUILTIN_STEP_H_
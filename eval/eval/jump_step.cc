@@ -40,6 +40,8 @@ class JumpStep : public JumpStepBase {
   JumpStep(absl::optional<int> jump_offset, int64_t expr_id)
       : JumpStepBase(jump_offset, expr_id) {}
 
+  bool unconditional() const override { return true; }
+
   absl::Status Evaluate(ExecutionFrame* frame) const override {
     return Jump(frame);
   }
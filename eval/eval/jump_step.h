@@ -20,6 +20,7 @@
 #include "google/api/expr/v1alpha1/syntax.pb.h"
 #include "absl/status/statusor.h"
 #include "absl/types/optional.h"
+#include "common/native_type.h"
 #include "eval/eval/evaluator_core.h"
 #include "eval/eval/expression_step_base.h"
 
@@ -32,6 +33,22 @@ class JumpStepBase : public ExpressionStepBase {
 
   void set_jump_offset(int offset) { jump_offset_ = offset; }
 
+  // The relative jump offset, if set. The jump target is the index of the
+  // step following this one plus the offset. Exposed for the post-planning
+  // jump cleanup pass.
+  absl::optional<int> jump_offset() const { return jump_offset_; }
+
+  // True if this step always jumps rather than conditionally falling
+  // through. Post-planning cleanup may retarget other jumps through, and
+  // remove, unconditional jumps.
+  virtual bool unconditional() const { return false; }
+
+  // All jump steps share a native type id so the post-planning cleanup pass
+  // can recognize them in a finished plan.
+  cel::NativeTypeId GetNativeTypeId() const override {
+    return cel::NativeTypeId::For<JumpStepBase>();
+  }
+
   absl::Status Jump(ExecutionFrame* frame) const {
     if (!jump_offset_.has_value()) {
       return absl::Status(absl::StatusCode::kInternal, "Jump offset not set");
@@ -5,6 +5,8 @@
 #include <memory>
 #include <utility>
 
+#include "absl/base/attributes.h"
+#include "absl/base/optimization.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/types/optional.h"
@@ -112,7 +114,7 @@ absl::Status ExhaustiveDirectLogicStep::Evaluate(
   CEL_RETURN_IF_ERROR(rhs_->Evaluate(frame, rhs_result, attribute_trail));
 
   ValueKind rhs_kind = rhs_result.kind();
-  if (lhs_kind == ValueKind::kBool) {
+  if (ABSL_PREDICT_TRUE(lhs_kind == ValueKind::kBool)) {
     bool lhs_bool = Cast<BoolValue>(result).NativeValue();
     if ((op_type_ == OpType::kOr && lhs_bool) ||
         (op_type_ == OpType::kAnd && !lhs_bool)) {
@@ -120,7 +122,7 @@ absl::Status ExhaustiveDirectLogicStep::Evaluate(
     }
   }
 
-  if (rhs_kind == ValueKind::kBool) {
+  if (ABSL_PREDICT_TRUE(rhs_kind == ValueKind::kBool)) {
     bool rhs_bool = Cast<BoolValue>(rhs_result).NativeValue();
     if ((op_type_ == OpType::kOr && rhs_bool) ||
         (op_type_ == OpType::kAnd && !rhs_bool)) {
@@ -128,6 +130,12 @@ absl::Status ExhaustiveDirectLogicStep::Evaluate(
       attribute_trail = std::move(rhs_attr);
       return absl::OkStatus();
     }
+    if (ABSL_PREDICT_TRUE(lhs_kind == ValueKind::kBool)) {
+      // Neither operand is the short-circuit value, so both hold the
+      // operator's identity; the lhs already in `result` is the answer. This
+      // keeps the well-typed path clear of the unknown/error handling below.
+      return absl::OkStatus();
+    }
   }
 
   return ReturnLogicResult(frame, op_type_, result, rhs_result, attribute_trail,
@@ -157,7 +165,7 @@ absl::Status DirectLogicStep::Evaluate(ExecutionFrameBase& frame, Value& result,
                                        AttributeTrail& attribute_trail) const {
   CEL_RETURN_IF_ERROR(lhs_->Evaluate(frame, result, attribute_trail));
   ValueKind lhs_kind = result.kind();
-  if (lhs_kind == ValueKind::kBool) {
+  if (ABSL_PREDICT_TRUE(lhs_kind == ValueKind::kBool)) {
     bool lhs_bool = Cast<BoolValue>(result).NativeValue();
     if ((op_type_ == OpType::kOr && lhs_bool) ||
         (op_type_ == OpType::kAnd && !lhs_bool)) {
@@ -172,7 +180,7 @@ absl::Status DirectLogicStep::Evaluate(ExecutionFrameBase& frame, Value& result,
 
   ValueKind rhs_kind = rhs_result.kind();
 
-  if (rhs_kind == ValueKind::kBool) {
+  if (ABSL_PREDICT_TRUE(rhs_kind == ValueKind::kBool)) {
     bool rhs_bool = Cast<BoolValue>(rhs_result).NativeValue();
     if ((op_type_ == OpType::kOr && rhs_bool) ||
         (op_type_ == OpType::kAnd && !rhs_bool)) {
@@ -180,6 +188,12 @@ absl::Status DirectLogicStep::Evaluate(ExecutionFrameBase& frame, Value& result,
       attribute_trail = std::move(rhs_attr);
       return absl::OkStatus();
     }
+    if (ABSL_PREDICT_TRUE(lhs_kind == ValueKind::kBool)) {
+      // The lhs did not short-circuit above and the rhs holds the operator's
+      // identity, so the lhs already in `result` is the answer. This keeps
+      // the well-typed path clear of the unknown/error handling below.
+      return absl::OkStatus();
+    }
   }
 
   return ReturnLogicResult(frame, op_type_, result, rhs_result, attribute_trail,
@@ -197,13 +211,13 @@ class LogicalOpStep : public ExpressionStepBase {
   absl::Status Evaluate(ExecutionFrame* frame) const override;
 
  private:
-  void Calculate(ExecutionFrame* frame, absl::Span<const Value> args,
-                 Value& result) const {
+  void Calculate(ExecutionFrame* frame, absl::Span<const ValueKind> kinds,
+                 absl::Span<Value> args, Value& result) const {
     bool bool_args[2];
     bool has_bool_args[2];
 
     for (size_t i = 0; i < args.size(); i++) {
-      has_bool_args[i] = args[i]->Is<BoolValue>();
+      has_bool_args[i] = ABSL_PREDICT_TRUE(kinds[i] == ValueKind::kBool);
       if (has_bool_args[i]) {
         bool_args[i] = args[i].As<BoolValue>().NativeValue();
         if (bool_args[i] == shortcircuit_) {
@@ -213,7 +227,10 @@ class LogicalOpStep : public ExpressionStepBase {
       }
     }
 
-    if (has_bool_args[0] && has_bool_args[1]) {
+    // Both operands are bool in any well-typed evaluation; the
+    // unknown/error handling is kept out of line so it does not dilute this
+    // path.
+    if (ABSL_PREDICT_TRUE(has_bool_args[0] && has_bool_args[1])) {
       switch (op_type_) {
         case OpType::kAnd:
           result = BoolValue{bool_args[0] && bool_args[1]};
@@ -224,6 +241,14 @@ class LogicalOpStep : public ExpressionStepBase {
       }
     }
 
+    CalculateSlow(frame, kinds, args, result);
+  }
+
+  // Non-bool operands: unknowns, forwarded errors and mistyped arguments.
+  ABSL_ATTRIBUTE_NOINLINE void CalculateSlow(ExecutionFrame* frame,
+                                             absl::Span<const ValueKind> kinds,
+                                             absl::Span<Value> args,
+                                             Value& result) const {
     // As opposed to regular function, logical operation treat Unknowns with
     // higher precedence than error. This is due to the fact that after Unknown
     // is resolved to actual value, it may short-circuit and thus hide the
@@ -238,11 +263,11 @@ class LogicalOpStep : public ExpressionStepBase {
       }
     }
 
-    if (args[0]->Is<cel::ErrorValue>()) {
-      result = args[0];
+    if (kinds[0] == ValueKind::kError) {
+      result = std::move(args[0]);
       return;
-    } else if (args[1]->Is<cel::ErrorValue>()) {
-      result = args[1];
+    } else if (kinds[1] == ValueKind::kError) {
+      result = std::move(args[1]);
       return;
     }
 
@@ -264,9 +289,13 @@ absl::Status LogicalOpStep::Evaluate(ExecutionFrame* frame) const {
   }
 
   // Create Span object that contains input arguments to the function.
-  auto args = frame->value_stack().GetSpan(2);
+  // Mutable access lets forwarded error values be moved instead of copied.
+  // Kinds come from the stack's dense kind lane, so classifying the
+  // arguments does not pull the full value objects through cache.
+  auto kinds = frame->value_stack().GetKindSpan(2);
+  auto args = frame->value_stack().GetMutableSpan(2);
   Value result;
-  Calculate(frame, args, result);
+  Calculate(frame, kinds, args, result);
   frame->value_stack().PopAndPush(args.size(), std::move(result));
 
   return absl::OkStatus();
@@ -0,0 +1,84 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/map_entry_streaming.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "common/expr.h"
+#include "common/value.h"
+#include "eval/eval/evaluator_core.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+// Per-evaluation listener state. Keys evaluate immediately before their
+// entry's value, so a single pending slot per entry is enough to pair them.
+struct StreamingState {
+  absl::flat_hash_map<int64_t, size_t> key_ids;
+  absl::flat_hash_map<int64_t, size_t> value_ids;
+  std::vector<cel::Value> pending_keys;
+  MapEntryCallback callback;
+};
+
+}  // namespace
+
+absl::StatusOr<EvaluationListener> MakeMapEntryStreamingListener(
+    const cel::Expr& root, MapEntryCallback callback) {
+  if (!root.has_map_expr()) {
+    return absl::InvalidArgumentError(
+        "map entry streaming requires a map literal at the top of the "
+        "expression");
+  }
+  const auto& entries = root.map_expr().entries();
+  auto state = std::make_unique<StreamingState>();
+  state->pending_keys.resize(entries.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const cel::MapExprEntry& entry = entries[i];
+    if (entry.optional()) {
+      // An optional entry may be absent from the result, so completion of
+      // its value subexpression does not imply a map entry.
+      return absl::InvalidArgumentError(
+          "map entry streaming does not support optional map entries");
+    }
+    state->key_ids[entry.key().id()] = i;
+    state->value_ids[entry.value().id()] = i;
+  }
+  state->callback = std::move(callback);
+  return EvaluationListener(
+      [state = std::move(state)](int64_t expr_id, const cel::Value& value,
+                                 cel::ValueManager&) -> absl::Status {
+        auto key_it = state->key_ids.find(expr_id);
+        if (key_it != state->key_ids.end()) {
+          state->pending_keys[key_it->second] = value;
+          return absl::OkStatus();
+        }
+        auto value_it = state->value_ids.find(expr_id);
+        if (value_it != state->value_ids.end()) {
+          return state->callback(value_it->second,
+                                 state->pending_keys[value_it->second], value);
+        }
+        return absl::OkStatus();
+      });
+}
+
+}  // namespace google::api::expr::runtime
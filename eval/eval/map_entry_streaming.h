@@ -0,0 +1,57 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_MAP_ENTRY_STREAMING_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_MAP_ENTRY_STREAMING_H_
+
+#include <cstddef>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "common/expr.h"
+#include "common/value.h"
+#include "eval/eval/evaluator_core.h"
+
+namespace google::api::expr::runtime {
+
+// Receives completed top-level map entries during evaluation. `index` is the
+// position of the entry in the map literal; the value may be an error if the
+// entry's subexpression failed. Returning a non-ok status stops evaluation
+// and forwards the error, like any EvaluationListener.
+using MapEntryCallback = absl::AnyInvocable<absl::Status(
+    size_t index, const cel::Value& key, const cel::Value& value)>;
+
+// Returns an EvaluationListener that invokes `callback` each time a
+// top-level map entry of `root` finishes evaluating, in entry order, before
+// the enclosing map is assembled. Expressions whose result is a map of
+// independently useful values (e.g. a map of policy verdicts) can surface
+// early entries to the caller while later, slower entries are still being
+// computed. Pass the result to FlatExpression::EvaluateWithCallback; the
+// final map is still returned as usual.
+//
+// `root` must be the map literal at the top of the planned expression;
+// returns InvalidArgumentError if it is not a map literal or uses optional
+// entries. Entry ids are captured at construction, so `root` need not
+// outlive the listener. Recursive plans only invoke listeners when built
+// with enable_recursive_tracing.
+//
+// The listener carries per-evaluation state: it may be reused sequentially
+// but not by concurrent evaluations.
+absl::StatusOr<EvaluationListener> MakeMapEntryStreamingListener(
+    const cel::Expr& root, MapEntryCallback callback);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_MAP_ENTRY_STREAMING_H_
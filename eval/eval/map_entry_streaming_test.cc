@@ -0,0 +1,178 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/map_entry_streaming.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "base/ast_internal/ast_impl.h"
+#include "common/expr.h"
+#include "common/value.h"
+#include "eval/compiler/flat_expr_builder.h"
+#include "eval/eval/evaluator_core.h"
+#include "extensions/protobuf/ast_converters.h"
+#include "extensions/protobuf/memory_manager.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/function_registry.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_functions.h"
+#include "runtime/type_registry.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::Value;
+using ::cel::internal::IsOkAndHolds;
+using ::cel::internal::StatusIs;
+using ::google::api::expr::v1alpha1::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+
+struct StreamedEntry {
+  size_t index;
+  std::string key;
+  Value value;
+};
+
+class MapEntryStreamingTest : public ::testing::Test {
+ public:
+  MapEntryStreamingTest()
+      : managed_value_factory_(
+            type_registry_.GetComposedTypeProvider(),
+            cel::extensions::ProtoMemoryManagerRef(&arena_)) {}
+
+  void SetUp() override {
+    ASSERT_OK(cel::RegisterStandardFunctions(function_registry_, options_));
+  }
+
+ protected:
+  // Plans `expression` and builds a streaming listener over its root; the
+  // listener is consumed by the next Evaluate call.
+  absl::StatusOr<FlatExpression> Plan(absl::string_view expression,
+                                      MapEntryCallback callback) {
+    FlatExprBuilder builder(function_registry_, type_registry_, options_);
+    CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+    CEL_ASSIGN_OR_RETURN(auto ast,
+                         cel::extensions::CreateAstFromParsedExpr(parsed_expr));
+    CEL_ASSIGN_OR_RETURN(
+        listener_,
+        MakeMapEntryStreamingListener(
+            cel::ast_internal::AstImpl::CastFromPublicAst(*ast).root_expr(),
+            std::move(callback)));
+    return builder.CreateExpressionImpl(std::move(ast), nullptr);
+  }
+
+  absl::StatusOr<Value> Evaluate(const FlatExpression& plan, int64_t x) {
+    auto state = plan.MakeEvaluatorState(managed_value_factory_.get());
+    cel::Activation activation;
+    activation.InsertOrAssignValue(
+        "x", managed_value_factory_.get().CreateIntValue(x));
+    return plan.EvaluateWithCallback(activation, std::move(listener_), state);
+  }
+
+  // Appends streamed entries to `log`, stringifying keys.
+  static MapEntryCallback Logger(std::vector<StreamedEntry>* log) {
+    return [log](size_t index, const Value& key,
+                 const Value& value) -> absl::Status {
+      log->push_back(StreamedEntry{index, key.DebugString(), value});
+      return absl::OkStatus();
+    };
+  }
+
+  cel::TypeRegistry type_registry_;
+  cel::FunctionRegistry function_registry_;
+  cel::RuntimeOptions options_;
+  google::protobuf::Arena arena_;
+  cel::ManagedValueFactory managed_value_factory_;
+  EvaluationListener listener_;
+};
+
+TEST_F(MapEntryStreamingTest, StreamsEntriesInOrder) {
+  std::vector<StreamedEntry> log;
+  ASSERT_OK_AND_ASSIGN(FlatExpression plan,
+                       Plan("{'a': 1 + 2, 'b': x, 'c': 'done'}", Logger(&log)));
+  ASSERT_OK_AND_ASSIGN(Value result, Evaluate(plan, 7));
+
+  ASSERT_EQ(log.size(), 3);
+  EXPECT_EQ(log[0].index, 0);
+  EXPECT_EQ(log[0].key, "\"a\"");
+  ASSERT_TRUE(log[0].value->Is<cel::IntValue>());
+  EXPECT_EQ(log[0].value->As<cel::IntValue>().NativeValue(), 3);
+  EXPECT_EQ(log[1].index, 1);
+  EXPECT_EQ(log[1].key, "\"b\"");
+  EXPECT_EQ(log[1].value->As<cel::IntValue>().NativeValue(), 7);
+  EXPECT_EQ(log[2].index, 2);
+  EXPECT_EQ(log[2].key, "\"c\"");
+
+  // The complete map is still produced.
+  ASSERT_TRUE(result->Is<cel::MapValue>());
+  EXPECT_THAT(result->As<cel::MapValue>().Size(), IsOkAndHolds(3));
+}
+
+TEST_F(MapEntryStreamingTest, ComputedKeysStreamed) {
+  std::vector<StreamedEntry> log;
+  ASSERT_OK_AND_ASSIGN(FlatExpression plan, Plan("{x + 1: 'v'}", Logger(&log)));
+  ASSERT_OK(Evaluate(plan, 41).status());
+
+  ASSERT_EQ(log.size(), 1);
+  EXPECT_EQ(log[0].key, "42");
+}
+
+TEST_F(MapEntryStreamingTest, ErrorEntriesStreamed) {
+  std::vector<StreamedEntry> log;
+  ASSERT_OK_AND_ASSIGN(FlatExpression plan,
+                       Plan("{'a': x / 0, 'b': x}", Logger(&log)));
+  ASSERT_OK(Evaluate(plan, 1).status());
+
+  ASSERT_GE(log.size(), 1);
+  EXPECT_EQ(log[0].index, 0);
+  EXPECT_TRUE(log[0].value->Is<cel::ErrorValue>());
+}
+
+TEST_F(MapEntryStreamingTest, CallbackErrorStopsEvaluation) {
+  ASSERT_OK_AND_ASSIGN(
+      FlatExpression plan,
+      Plan("{'a': 1, 'b': 2}",
+           [](size_t, const Value&, const Value&) -> absl::Status {
+             return absl::CancelledError("stop after first verdict");
+           }));
+  EXPECT_THAT(Evaluate(plan, 0).status(),
+              StatusIs(absl::StatusCode::kCancelled));
+}
+
+TEST_F(MapEntryStreamingTest, RejectsNonMapRoot) {
+  cel::Expr root;
+  root.mutable_const_expr()->set_int64_value(1);
+  EXPECT_THAT(MakeMapEntryStreamingListener(
+                  root, [](size_t, const Value&, const Value&) {
+                    return absl::OkStatus();
+                  })
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
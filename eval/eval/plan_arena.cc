@@ -0,0 +1,103 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "eval/eval/plan_arena.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "internal/new.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+// Arena active for step allocation on this thread, or nullptr for the global
+// heap. Managed exclusively by PlanArenaScope.
+thread_local PlanArena* current_plan_arena = nullptr;
+
+// Size of the per-allocation header written by AllocateStep. One
+// max-aligned word keeps the step object itself max-aligned.
+constexpr size_t kStepHeaderSize = alignof(std::max_align_t);
+
+static_assert(kStepHeaderSize >= sizeof(uintptr_t),
+              "step header must hold the storage tag");
+
+constexpr uintptr_t kArenaBacked = 1;
+constexpr uintptr_t kHeapBacked = 0;
+
+size_t AlignUp(size_t size) {
+  return (size + kStepHeaderSize - 1) & ~(kStepHeaderSize - 1);
+}
+
+}  // namespace
+
+PlanArena::~PlanArena() {
+  for (void* block : blocks_) {
+    cel::internal::Delete(block);
+  }
+}
+
+void* PlanArena::Allocate(size_t size) {
+  size = AlignUp(size);
+  if (size > remaining_) {
+    size_t block_size = std::max(size, kBlockSize);
+    char* block = static_cast<char*>(cel::internal::New(block_size));
+    blocks_.push_back(block);
+    next_ = block;
+    remaining_ = block_size;
+  }
+  char* result = next_;
+  next_ += size;
+  remaining_ -= size;
+  return result;
+}
+
+PlanArenaScope::PlanArenaScope(PlanArena* arena)
+    : previous_(current_plan_arena) {
+  current_plan_arena = arena;
+}
+
+PlanArenaScope::~PlanArenaScope() { current_plan_arena = previous_; }
+
+namespace plan_arena_internal {
+
+void* AllocateStep(size_t size) {
+  char* storage;
+  uintptr_t tag;
+  if (PlanArena* arena = current_plan_arena; arena != nullptr) {
+    storage = static_cast<char*>(arena->Allocate(size + kStepHeaderSize));
+    tag = kArenaBacked;
+  } else {
+    storage = static_cast<char*>(cel::internal::New(size + kStepHeaderSize));
+    tag = kHeapBacked;
+  }
+  *reinterpret_cast<uintptr_t*>(storage) = tag;
+  return storage + kStepHeaderSize;
+}
+
+void DeallocateStep(void* ptr) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  char* storage = static_cast<char*>(ptr) - kStepHeaderSize;
+  if (*reinterpret_cast<uintptr_t*>(storage) == kHeapBacked) {
+    cel::internal::Delete(storage);
+  }
+  // Arena-backed storage is reclaimed when the owning PlanArena is destroyed.
+}
+
+}  // namespace plan_arena_internal
+
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,98 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_PLAN_ARENA_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_PLAN_ARENA_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace google::api::expr::runtime {
+
+// Bump allocator owning the storage for the expression step objects of one
+// planned program.
+//
+// A plan is a vector of individually heap-allocated polymorphic steps; for
+// large expressions those allocations are scattered across the heap, so the
+// dispatch loop chases pointers into unrelated cache lines and each program
+// pays per-step malloc metadata. Allocating all steps for one program from a
+// single arena in plan order makes consecutive steps adjacent in memory and
+// collapses the per-step allocations into a handful of block allocations.
+//
+// The arena owns storage only: steps are still destroyed individually through
+// their unique_ptr owners, whose operator delete is a no-op for arena-backed
+// storage (see ExpressionStep::operator new). The arena must therefore
+// outlive every step allocated from it; FlatExprBuilder moves it into the
+// same shared ownership block as the ExecutionPath it backs.
+class PlanArena {
+ public:
+  // Default block size. Allocations larger than this get a dedicated block.
+  static constexpr size_t kBlockSize = 16 * 1024;
+
+  PlanArena() = default;
+
+  PlanArena(PlanArena&& other) noexcept
+      : blocks_(std::move(other.blocks_)),
+        next_(std::exchange(other.next_, nullptr)),
+        remaining_(std::exchange(other.remaining_, 0)) {
+    other.blocks_.clear();
+  }
+
+  PlanArena& operator=(PlanArena&&) = delete;
+
+  ~PlanArena();
+
+  // Returns `size` bytes aligned to alignof(std::max_align_t). The storage is
+  // released when the arena is destroyed.
+  void* Allocate(size_t size);
+
+ private:
+  std::vector<void*> blocks_;
+  char* next_ = nullptr;
+  size_t remaining_ = 0;
+};
+
+// While in scope, expression step objects constructed on this thread are
+// allocated from `arena` instead of the global heap (see
+// ExpressionStep::operator new). Scopes nest; destruction restores the
+// previously active arena, so concurrent planning on other threads is
+// unaffected.
+class PlanArenaScope {
+ public:
+  explicit PlanArenaScope(PlanArena* arena);
+
+  PlanArenaScope(const PlanArenaScope&) = delete;
+  PlanArenaScope& operator=(const PlanArenaScope&) = delete;
+
+  ~PlanArenaScope();
+
+ private:
+  PlanArena* previous_;
+};
+
+namespace plan_arena_internal {
+
+// Allocation functions behind the class-scope operator new / delete of
+// ExpressionStep and DirectExpressionStep. Each allocation is preceded by a
+// max-aligned header word recording whether the storage came from the
+// thread's active PlanArena, so deallocation of steps created outside a
+// PlanArenaScope (tests, ad hoc construction) takes the global heap path.
+void* AllocateStep(size_t size);
+void DeallocateStep(void* ptr) noexcept;
+
+}  // namespace plan_arena_internal
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_PLAN_ARENA_H_
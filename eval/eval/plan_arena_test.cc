@@ -0,0 +1,117 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "eval/eval/plan_arena.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "eval/eval/evaluator_core.h"
+#include "internal/testing.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+class NoopStep : public ExpressionStep {
+ public:
+  NoopStep() : ExpressionStep(/*id=*/0, /*comes_from_ast=*/false) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    return absl::OkStatus();
+  }
+};
+
+TEST(PlanArenaTest, PooledStepsAreContiguous) {
+  PlanArena arena;
+  PlanArenaScope scope(&arena);
+
+  auto step1 = std::make_unique<NoopStep>();
+  auto step2 = std::make_unique<NoopStep>();
+
+  // Consecutive pooled allocations come from the same block in order, so the
+  // second step starts within one aligned step-size of the first.
+  auto addr1 = reinterpret_cast<uintptr_t>(step1.get());
+  auto addr2 = reinterpret_cast<uintptr_t>(step2.get());
+  EXPECT_LT(addr1, addr2);
+  EXPECT_LE(addr2 - addr1, 2 * (sizeof(NoopStep) + alignof(std::max_align_t)));
+}
+
+TEST(PlanArenaTest, StepsOutliveTheScope) {
+  PlanArena arena;
+  std::unique_ptr<NoopStep> step;
+  {
+    PlanArenaScope scope(&arena);
+    step = std::make_unique<NoopStep>();
+  }
+  // The scope only controls where new steps are allocated; existing steps
+  // stay valid until the arena is destroyed.
+  ExecutionFrame* frame = nullptr;
+  EXPECT_TRUE(step->Evaluate(frame).ok());
+  step.reset();
+}
+
+TEST(PlanArenaTest, HeapFallbackWithoutScope) {
+  // Steps constructed outside any scope use the global heap; destruction must
+  // release the storage normally.
+  auto step = std::make_unique<NoopStep>();
+  EXPECT_NE(step, nullptr);
+  step.reset();
+}
+
+TEST(PlanArenaTest, ScopesNest) {
+  PlanArena outer_arena;
+  PlanArena inner_arena;
+  PlanArenaScope outer(&outer_arena);
+  std::unique_ptr<NoopStep> outer_step;
+  {
+    PlanArenaScope inner(&inner_arena);
+    auto inner_step = std::make_unique<NoopStep>();
+    EXPECT_NE(inner_step, nullptr);
+  }
+  // Destruction of the inner scope restores the outer arena.
+  outer_step = std::make_unique<NoopStep>();
+  EXPECT_NE(outer_step, nullptr);
+}
+
+TEST(PlanArenaTest, LargeAllocationGetsDedicatedBlock) {
+  PlanArena arena;
+  void* small = arena.Allocate(64);
+  void* large = arena.Allocate(4 * PlanArena::kBlockSize);
+  void* next_small = arena.Allocate(64);
+  EXPECT_NE(small, nullptr);
+  EXPECT_NE(large, nullptr);
+  EXPECT_NE(next_small, nullptr);
+}
+
+TEST(PlanArenaTest, ArenaIsMovable) {
+  PlanArena arena;
+  std::unique_ptr<NoopStep> step;
+  {
+    PlanArenaScope scope(&arena);
+    step = std::make_unique<NoopStep>();
+  }
+  PlanArena moved = std::move(arena);
+  // Storage ownership transferred with the move; the step stays valid until
+  // `moved` is destroyed.
+  ExecutionFrame* frame = nullptr;
+  EXPECT_TRUE(step->Evaluate(frame).ok());
+  step.reset();
+}
+
+}  // namespace
+
+}  // namespace google::api::expr::runtime
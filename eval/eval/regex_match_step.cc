@@ -83,8 +83,8 @@ class RegexMatchStep final : public ExpressionStepBase {
     }
     bool match =
         subject.As<cel::StringValue>().NativeValue(MatchesVisitor{*re2_});
-    frame->value_stack().Pop(kNumRegexMatchArguments);
-    frame->value_stack().Push(frame->value_factory().CreateBoolValue(match));
+    frame->value_stack().PopAndPush(
+        kNumRegexMatchArguments, frame->value_factory().CreateBoolValue(match));
     return absl::OkStatus();
   }
 
@@ -0,0 +1,143 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/regex_set_match_step.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "common/casting.h"
+#include "common/value.h"
+#include "eval/eval/attribute_trail.h"
+#include "eval/eval/direct_expression_step.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/expression_step_base.h"
+#include "internal/status_macros.h"
+#include "re2/set.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+using ::cel::BoolValue;
+using ::cel::Cast;
+using ::cel::ErrorValue;
+using ::cel::InstanceOf;
+using ::cel::StringValue;
+using ::cel::UnknownValue;
+using ::cel::Value;
+
+inline constexpr int kNumRegexSetMatchArguments = 1;
+inline constexpr size_t kRegexSetMatchStepSubject = 0;
+
+struct MatchesAnyVisitor final {
+  const RE2::Set& set;
+
+  bool operator()(const absl::Cord& value) const {
+    if (auto flat = value.TryFlat(); flat.has_value()) {
+      return set.Match(*flat, nullptr);
+    }
+    return set.Match(static_cast<std::string>(value), nullptr);
+  }
+
+  bool operator()(absl::string_view value) const {
+    return set.Match(value, nullptr);
+  }
+};
+
+class RegexSetMatchStep final : public ExpressionStepBase {
+ public:
+  RegexSetMatchStep(int64_t expr_id, std::shared_ptr<const RE2::Set> regex_set)
+      : ExpressionStepBase(expr_id, /*comes_from_ast=*/true),
+        regex_set_(std::move(regex_set)) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    if (!frame->value_stack().HasEnough(kNumRegexSetMatchArguments)) {
+      return absl::Status(absl::StatusCode::kInternal,
+                          "Insufficient arguments supplied for regular "
+                          "expression match");
+    }
+    auto input_args = frame->value_stack().GetSpan(kNumRegexSetMatchArguments);
+    const auto& subject = input_args[kRegexSetMatchStepSubject];
+    if (!subject->Is<cel::StringValue>()) {
+      return absl::Status(absl::StatusCode::kInternal,
+                          "First argument for regular "
+                          "expression match must be a string");
+    }
+    bool match = subject.As<cel::StringValue>().NativeValue(
+        MatchesAnyVisitor{*regex_set_});
+    frame->value_stack().PopAndPush(
+        kNumRegexSetMatchArguments,
+        frame->value_factory().CreateBoolValue(match));
+    return absl::OkStatus();
+  }
+
+ private:
+  const std::shared_ptr<const RE2::Set> regex_set_;
+};
+
+class RegexSetMatchDirectStep final : public DirectExpressionStep {
+ public:
+  RegexSetMatchDirectStep(int64_t expr_id,
+                          std::unique_ptr<DirectExpressionStep> subject,
+                          std::shared_ptr<const RE2::Set> regex_set)
+      : DirectExpressionStep(expr_id),
+        subject_(std::move(subject)),
+        regex_set_(std::move(regex_set)) {}
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
+                        AttributeTrail& attribute) const override {
+    AttributeTrail subject_attr;
+    CEL_RETURN_IF_ERROR(subject_->Evaluate(frame, result, subject_attr));
+    if (InstanceOf<ErrorValue>(result) ||
+        cel::InstanceOf<UnknownValue>(result)) {
+      return absl::OkStatus();
+    }
+
+    if (!InstanceOf<StringValue>(result)) {
+      return absl::Status(absl::StatusCode::kInternal,
+                          "First argument for regular "
+                          "expression match must be a string");
+    }
+    bool match =
+        Cast<StringValue>(result).NativeValue(MatchesAnyVisitor{*regex_set_});
+    result = BoolValue(match);
+    return absl::OkStatus();
+  }
+
+ private:
+  std::unique_ptr<DirectExpressionStep> subject_;
+  const std::shared_ptr<const RE2::Set> regex_set_;
+};
+
+}  // namespace
+
+std::unique_ptr<DirectExpressionStep> CreateDirectRegexSetMatchStep(
+    int64_t expr_id, std::unique_ptr<DirectExpressionStep> subject,
+    std::shared_ptr<const RE2::Set> regex_set) {
+  return std::make_unique<RegexSetMatchDirectStep>(expr_id, std::move(subject),
+                                                   std::move(regex_set));
+}
+
+absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateRegexSetMatchStep(
+    std::shared_ptr<const RE2::Set> regex_set, int64_t expr_id) {
+  return std::make_unique<RegexSetMatchStep>(expr_id, std::move(regex_set));
+}
+
+}  // namespace google::api::expr::runtime
@@ -4,7 +4,9 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -117,6 +119,21 @@ class SelectStep : public ExpressionStepBase {
 
   absl::Status Evaluate(ExecutionFrame* frame) const override;
 
+  cel::NativeTypeId GetNativeTypeId() const override {
+    return cel::NativeTypeId::For<SelectStep>();
+  }
+
+  // True if this step may be absorbed into a flattened select path; presence
+  // tests and optional-type handling only make sense on the last link of a
+  // chain.
+  bool flattenable() const {
+    return !test_field_presence_ && !enable_optional_types_;
+  }
+
+  const StringValue& field_value() const { return field_value_; }
+
+  ProtoWrapperTypeOptions unboxing_option() const { return unboxing_option_; }
+
  private:
   absl::Status PerformTestOnlySelect(ExecutionFrame* frame,
                                      const Value& arg) const;
@@ -308,6 +325,20 @@ class DirectSelectStep : public DirectExpressionStep {
                              : ProtoWrapperTypeOptions::kUnsetProtoDefault),
         enable_optional_types_(enable_optional_types) {}
 
+  cel::NativeTypeId GetNativeTypeId() const override {
+    return cel::NativeTypeId::For<DirectSelectStep>();
+  }
+
+  bool flattenable() const { return !test_only_ && !enable_optional_types_; }
+
+  const StringValue& field_value() const { return field_value_; }
+
+  ProtoWrapperTypeOptions unboxing_option() const { return unboxing_option_; }
+
+  std::unique_ptr<DirectExpressionStep> ReleaseOperand() {
+    return std::move(operand_);
+  }
+
   absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
                         AttributeTrail& attribute) const override {
     CEL_RETURN_IF_ERROR(operand_->Evaluate(frame, result, attribute));
@@ -472,6 +503,378 @@ absl::Status DirectSelectStep::PerformSelect(ExecutionFrameBase& frame,
   }
 }
 
+// One link of a flattened select chain, in both forms the field access APIs
+// want.
+struct PathField {
+  cel::StringValue value;
+  std::string name;
+};
+
+// Flattened `a.b.c.d` select chain: applies the whole qualifier path in one
+// step, so intermediate results never round-trip through the value stack and
+// per-link step dispatch. Semantics per link mirror SelectStep, minus the
+// optional-type handling (the planner only flattens when optional types are
+// disabled).
+class SelectPathStep : public ExpressionStepBase {
+ public:
+  SelectPathStep(std::vector<PathField> fields, bool test_only, int64_t expr_id,
+                 ProtoWrapperTypeOptions unboxing_option)
+      : ExpressionStepBase(expr_id),
+        fields_(std::move(fields)),
+        test_only_(test_only),
+        unboxing_option_(unboxing_option) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override;
+
+  cel::NativeTypeId GetNativeTypeId() const override {
+    return cel::NativeTypeId::For<SelectPathStep>();
+  }
+
+  bool test_only() const { return test_only_; }
+
+  ProtoWrapperTypeOptions unboxing_option() const { return unboxing_option_; }
+
+  std::vector<PathField> ReleaseFields() { return std::move(fields_); }
+
+ private:
+  std::vector<PathField> fields_;
+  bool test_only_;
+  ProtoWrapperTypeOptions unboxing_option_;
+};
+
+absl::Status SelectPathStep::Evaluate(ExecutionFrame* frame) const {
+  if (!frame->value_stack().HasEnough(1)) {
+    return absl::Status(absl::StatusCode::kInternal,
+                        "No arguments supplied for Select-type expression");
+  }
+
+  Value result = frame->value_stack().Peek();
+  AttributeTrail trail = frame->value_stack().PeekAttribute();
+
+  const bool tracking =
+      frame->enable_unknowns() || frame->enable_missing_attribute_errors();
+
+  for (size_t i = 0; i < fields_.size(); ++i) {
+    const PathField& field = fields_[i];
+    const bool last = i + 1 == fields_.size();
+
+    if (InstanceOf<UnknownValue>(result) || InstanceOf<ErrorValue>(result)) {
+      // Bubble up unknowns and errors.
+      break;
+    }
+
+    if (tracking) {
+      trail = trail.Step(&field.name);
+    }
+
+    if (result->Is<NullValue>()) {
+      result = frame->value_factory().CreateErrorValue(
+          cel::runtime_internal::CreateError("Message is NULL"));
+      break;
+    }
+
+    if (!(result->Is<MapValue>() || result->Is<StructValue>())) {
+      result =
+          frame->value_factory().CreateErrorValue(InvalidSelectTargetError());
+      break;
+    }
+
+    if (tracking) {
+      absl::optional<Value> marked = CheckForMarkedAttributes(trail, *frame);
+      if (marked.has_value()) {
+        result = std::move(marked).value();
+        break;
+      }
+    }
+
+    if (last && test_only_) {
+      if (result->Is<MapValue>()) {
+        TestOnlySelect(result.As<MapValue>(), field.value,
+                       frame->value_factory(), result);
+      } else {
+        TestOnlySelect(result.As<StructValue>(), field.name,
+                       frame->value_factory(), result);
+      }
+      break;
+    }
+
+    if (result->Is<StructValue>()) {
+      StructValue struct_value = result.As<StructValue>();
+      CEL_RETURN_IF_ERROR(struct_value.GetFieldByName(
+          frame->value_factory(), field.name, result, unboxing_option_));
+    } else {
+      MapValue map_value = result.As<MapValue>();
+      CEL_RETURN_IF_ERROR(
+          map_value.Get(frame->value_factory(), field.value, result));
+    }
+  }
+
+  frame->value_stack().PopAndPush(std::move(result), std::move(trail));
+  return absl::OkStatus();
+}
+
+// Recursive-plan form of the flattened select chain; per-link semantics
+// mirror DirectSelectStep, minus optional-type handling.
+class DirectSelectPathStep : public DirectExpressionStep {
+ public:
+  DirectSelectPathStep(int64_t expr_id,
+                       std::unique_ptr<DirectExpressionStep> operand,
+                       std::vector<PathField> fields, bool test_only,
+                       ProtoWrapperTypeOptions unboxing_option)
+      : DirectExpressionStep(expr_id),
+        operand_(std::move(operand)),
+        fields_(std::move(fields)),
+        test_only_(test_only),
+        unboxing_option_(unboxing_option) {}
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
+                        AttributeTrail& attribute) const override;
+
+  cel::NativeTypeId GetNativeTypeId() const override {
+    return cel::NativeTypeId::For<DirectSelectPathStep>();
+  }
+
+  bool test_only() const { return test_only_; }
+
+  ProtoWrapperTypeOptions unboxing_option() const { return unboxing_option_; }
+
+  std::unique_ptr<DirectExpressionStep> ReleaseOperand() {
+    return std::move(operand_);
+  }
+
+  std::vector<PathField> ReleaseFields() { return std::move(fields_); }
+
+ private:
+  std::unique_ptr<DirectExpressionStep> operand_;
+  std::vector<PathField> fields_;
+  bool test_only_;
+  ProtoWrapperTypeOptions unboxing_option_;
+};
+
+absl::Status DirectSelectPathStep::Evaluate(ExecutionFrameBase& frame,
+                                            Value& result,
+                                            AttributeTrail& attribute) const {
+  CEL_RETURN_IF_ERROR(operand_->Evaluate(frame, result, attribute));
+
+  for (size_t i = 0; i < fields_.size(); ++i) {
+    const PathField& field = fields_[i];
+    const bool last = i + 1 == fields_.size();
+
+    if (InstanceOf<ErrorValue>(result) || InstanceOf<UnknownValue>(result)) {
+      // Just forward.
+      return absl::OkStatus();
+    }
+
+    if (frame.attribute_tracking_enabled()) {
+      attribute = attribute.Step(&field.name);
+      absl::optional<Value> value = CheckForMarkedAttributes(attribute, frame);
+      if (value.has_value()) {
+        result = std::move(value).value();
+        return absl::OkStatus();
+      }
+    }
+
+    switch (result.kind()) {
+      case ValueKind::kStruct:
+      case ValueKind::kMap:
+        break;
+      case ValueKind::kNull:
+        result = frame.value_manager().CreateErrorValue(
+            cel::runtime_internal::CreateError("Message is NULL"));
+        return absl::OkStatus();
+      default:
+        result =
+            frame.value_manager().CreateErrorValue(InvalidSelectTargetError());
+        return absl::OkStatus();
+    }
+
+    if (last && test_only_) {
+      if (result.kind() == ValueKind::kMap) {
+        TestOnlySelect(Cast<MapValue>(result), field.value,
+                       frame.value_manager(), result);
+      } else {
+        TestOnlySelect(Cast<StructValue>(result), field.name,
+                       frame.value_manager(), result);
+      }
+      return absl::OkStatus();
+    }
+
+    if (result.kind() == ValueKind::kStruct) {
+      StructValue struct_value = Cast<StructValue>(result);
+      CEL_RETURN_IF_ERROR(struct_value.GetFieldByName(
+          frame.value_manager(), field.name, result, unboxing_option_));
+    } else {
+      MapValue map_value = Cast<MapValue>(result);
+      CEL_RETURN_IF_ERROR(
+          map_value.Get(frame.value_manager(), field.value, result));
+    }
+  }
+
+  return absl::OkStatus();
+}
+
+PathField MakePathField(cel::StringValue field) {
+  std::string name = field.ToString();
+  return PathField{std::move(field), std::move(name)};
+}
+
+// Applies a fused `.?field` chain (`a.?b.?c`) to `result` in place.
+//
+// `result` holds the chain operand on entry and the chain result on exit.
+// Absence is tracked with a flag instead of materializing an OptionalValue
+// per link, so the result is boxed exactly once when it escapes the chain.
+// Per-link semantics mirror the registered `_?._` overloads; attribute
+// handling follows the select steps (per-link trail stepping and marked
+// attribute checks).
+absl::Status EvaluateOptionalSelectPath(const std::vector<PathField>& fields,
+                                        ExecutionFrameBase& frame,
+                                        Value& result,
+                                        AttributeTrail& attribute) {
+  bool absent = false;
+  for (size_t i = 0; i < fields.size(); ++i) {
+    const PathField& field = fields[i];
+
+    if (!absent &&
+        (InstanceOf<ErrorValue>(result) || InstanceOf<UnknownValue>(result))) {
+      // Just forward.
+      return absl::OkStatus();
+    }
+
+    if (frame.attribute_tracking_enabled()) {
+      attribute = attribute.Step(&field.name);
+      absl::optional<Value> value = CheckForMarkedAttributes(attribute, frame);
+      if (value.has_value()) {
+        result = std::move(value).value();
+        return absl::OkStatus();
+      }
+    }
+
+    if (absent) {
+      // Short-circuit: nothing to select from, but keep stepping the trail
+      // so marked attributes later in the path are still honored.
+      continue;
+    }
+
+    // An optional chain operand is traversed into, mirroring the
+    // `_?._(optional, string)` overload. Later links always see unwrapped
+    // values.
+    if (i == 0 && cel::NativeTypeId::Of(result) ==
+                      cel::NativeTypeId::For<cel::OptionalValueInterface>()) {
+      const auto* optional_arg =
+          cel::internal::down_cast<const cel::OptionalValueInterface*>(
+              cel::Cast<cel::OpaqueValue>(result).operator->());
+      if (!optional_arg->HasValue()) {
+        absent = true;
+        continue;
+      }
+      result = optional_arg->Value();
+    }
+
+    switch (result.kind()) {
+      case ValueKind::kStruct: {
+        StructValue struct_value = Cast<StructValue>(result);
+        CEL_ASSIGN_OR_RETURN(bool has_field,
+                             struct_value.HasFieldByName(field.name));
+        if (!has_field) {
+          absent = true;
+          continue;
+        }
+        CEL_RETURN_IF_ERROR(struct_value.GetFieldByName(frame.value_manager(),
+                                                        field.name, result));
+        break;
+      }
+      case ValueKind::kMap: {
+        MapValue map_value = Cast<MapValue>(result);
+        CEL_ASSIGN_OR_RETURN(bool found,
+                             map_value.Find(frame.value_manager(), field.value,
+                                            result));
+        if (!found) {
+          absent = true;
+        }
+        break;
+      }
+      default:
+        // Same error the registered `_?._` overloads produce for unsupported
+        // operand types.
+        result = ErrorValue(
+            cel::runtime_internal::CreateNoMatchingOverloadError("_?._"));
+        return absl::OkStatus();
+    }
+  }
+
+  if (absent) {
+    result = OptionalValue::None();
+  } else {
+    result = OptionalValue::Of(frame.value_manager().GetMemoryManager(),
+                               std::move(result));
+  }
+  return absl::OkStatus();
+}
+
+// Fused `.?field` chain for the stack machine: pops the operand and applies
+// every link in one step, boxing at most one OptionalValue per evaluation.
+class OptionalSelectPathStep : public ExpressionStepBase {
+ public:
+  OptionalSelectPathStep(std::vector<PathField> fields, int64_t expr_id)
+      : ExpressionStepBase(expr_id), fields_(std::move(fields)) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    if (!frame->value_stack().HasEnough(1)) {
+      return absl::Status(absl::StatusCode::kInternal,
+                          "No arguments supplied for Select-type expression");
+    }
+
+    Value result = frame->value_stack().Peek();
+    AttributeTrail trail = frame->value_stack().PeekAttribute();
+
+    CEL_RETURN_IF_ERROR(
+        EvaluateOptionalSelectPath(fields_, *frame, result, trail));
+
+    frame->value_stack().PopAndPush(std::move(result), std::move(trail));
+    return absl::OkStatus();
+  }
+
+  cel::NativeTypeId GetNativeTypeId() const override {
+    return cel::NativeTypeId::For<OptionalSelectPathStep>();
+  }
+
+  std::vector<PathField> ReleaseFields() { return std::move(fields_); }
+
+ private:
+  std::vector<PathField> fields_;
+};
+
+// Recursive-plan form of the fused `.?field` chain.
+class DirectOptionalSelectPathStep : public DirectExpressionStep {
+ public:
+  DirectOptionalSelectPathStep(int64_t expr_id,
+                               std::unique_ptr<DirectExpressionStep> operand,
+                               std::vector<PathField> fields)
+      : DirectExpressionStep(expr_id),
+        operand_(std::move(operand)),
+        fields_(std::move(fields)) {}
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
+                        AttributeTrail& attribute) const override {
+    CEL_RETURN_IF_ERROR(operand_->Evaluate(frame, result, attribute));
+    return EvaluateOptionalSelectPath(fields_, frame, result, attribute);
+  }
+
+  cel::NativeTypeId GetNativeTypeId() const override {
+    return cel::NativeTypeId::For<DirectOptionalSelectPathStep>();
+  }
+
+  std::unique_ptr<DirectExpressionStep> ReleaseOperand() {
+    return std::move(operand_);
+  }
+
+  std::vector<PathField> ReleaseFields() { return std::move(fields_); }
+
+ private:
+  std::unique_ptr<DirectExpressionStep> operand_;
+  std::vector<PathField> fields_;
+};
+
 }  // namespace
 
 std::unique_ptr<DirectExpressionStep> CreateDirectSelectStep(
@@ -494,4 +897,117 @@ absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateSelectStep(
       enable_optional_types);
 }
 
+bool IsFlattenableSelectStep(const ExpressionStep& step) {
+  if (step.GetNativeTypeId() == cel::NativeTypeId::For<SelectStep>()) {
+    return cel::internal::down_cast<const SelectStep&>(step).flattenable();
+  }
+  if (step.GetNativeTypeId() == cel::NativeTypeId::For<SelectPathStep>()) {
+    return !cel::internal::down_cast<const SelectPathStep&>(step).test_only();
+  }
+  return false;
+}
+
+std::unique_ptr<ExpressionStep> ExtendSelectPathStep(
+    std::unique_ptr<ExpressionStep> operand_step, cel::StringValue field,
+    bool test_only, int64_t expr_id) {
+  ABSL_DCHECK(IsFlattenableSelectStep(*operand_step));
+  std::vector<PathField> fields;
+  ProtoWrapperTypeOptions unboxing_option;
+  if (operand_step->GetNativeTypeId() ==
+      cel::NativeTypeId::For<SelectStep>()) {
+    auto& select = cel::internal::down_cast<SelectStep&>(*operand_step);
+    unboxing_option = select.unboxing_option();
+    fields.push_back(MakePathField(select.field_value()));
+  } else {
+    auto& path = cel::internal::down_cast<SelectPathStep&>(*operand_step);
+    unboxing_option = path.unboxing_option();
+    fields = path.ReleaseFields();
+  }
+  fields.push_back(MakePathField(std::move(field)));
+  return std::make_unique<SelectPathStep>(std::move(fields), test_only,
+                                          expr_id, unboxing_option);
+}
+
+std::unique_ptr<DirectExpressionStep> MaybeExtendDirectSelectPath(
+    std::unique_ptr<DirectExpressionStep>& operand, cel::StringValue field,
+    bool test_only, int64_t expr_id) {
+  const cel::NativeTypeId operand_type = operand->GetNativeTypeId();
+  std::vector<PathField> fields;
+  std::unique_ptr<DirectExpressionStep> base;
+  ProtoWrapperTypeOptions unboxing_option;
+  if (operand_type == cel::NativeTypeId::For<DirectSelectStep>()) {
+    auto& select = cel::internal::down_cast<DirectSelectStep&>(*operand);
+    if (!select.flattenable()) {
+      return nullptr;
+    }
+    unboxing_option = select.unboxing_option();
+    fields.push_back(MakePathField(select.field_value()));
+    base = select.ReleaseOperand();
+  } else if (operand_type ==
+             cel::NativeTypeId::For<DirectSelectPathStep>()) {
+    auto& path = cel::internal::down_cast<DirectSelectPathStep&>(*operand);
+    if (path.test_only()) {
+      return nullptr;
+    }
+    unboxing_option = path.unboxing_option();
+    fields = path.ReleaseFields();
+    base = path.ReleaseOperand();
+  } else {
+    return nullptr;
+  }
+  operand.reset();
+  fields.push_back(MakePathField(std::move(field)));
+  return std::make_unique<DirectSelectPathStep>(expr_id, std::move(base),
+                                                std::move(fields), test_only,
+                                                unboxing_option);
+}
+
+std::unique_ptr<ExpressionStep> CreateOptionalSelectPathStep(
+    cel::StringValue field, int64_t expr_id) {
+  std::vector<PathField> fields;
+  fields.push_back(MakePathField(std::move(field)));
+  return std::make_unique<OptionalSelectPathStep>(std::move(fields), expr_id);
+}
+
+bool IsOptionalSelectPathStep(const ExpressionStep& step) {
+  return step.GetNativeTypeId() ==
+         cel::NativeTypeId::For<OptionalSelectPathStep>();
+}
+
+std::unique_ptr<ExpressionStep> ExtendOptionalSelectPathStep(
+    std::unique_ptr<ExpressionStep> operand_step, cel::StringValue field,
+    int64_t expr_id) {
+  ABSL_DCHECK(IsOptionalSelectPathStep(*operand_step));
+  auto& path =
+      cel::internal::down_cast<OptionalSelectPathStep&>(*operand_step);
+  std::vector<PathField> fields = path.ReleaseFields();
+  fields.push_back(MakePathField(std::move(field)));
+  return std::make_unique<OptionalSelectPathStep>(std::move(fields), expr_id);
+}
+
+std::unique_ptr<DirectExpressionStep> CreateDirectOptionalSelectPathStep(
+    std::unique_ptr<DirectExpressionStep> operand, cel::StringValue field,
+    int64_t expr_id) {
+  std::vector<PathField> fields;
+  fields.push_back(MakePathField(std::move(field)));
+  return std::make_unique<DirectOptionalSelectPathStep>(
+      expr_id, std::move(operand), std::move(fields));
+}
+
+std::unique_ptr<DirectExpressionStep> MaybeExtendDirectOptionalSelectPath(
+    std::unique_ptr<DirectExpressionStep>& operand, cel::StringValue field,
+    int64_t expr_id) {
+  if (operand->GetNativeTypeId() !=
+      cel::NativeTypeId::For<DirectOptionalSelectPathStep>()) {
+    return nullptr;
+  }
+  auto& path = cel::internal::down_cast<DirectOptionalSelectPathStep&>(*operand);
+  std::vector<PathField> fields = path.ReleaseFields();
+  std::unique_ptr<DirectExpressionStep> base = path.ReleaseOperand();
+  operand.reset();
+  fields.push_back(MakePathField(std::move(field)));
+  return std::make_unique<DirectOptionalSelectPathStep>(
+      expr_id, std::move(base), std::move(fields));
+}
+
 }  // namespace google::api::expr::runtime
@@ -25,6 +25,57 @@ absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateSelectStep(
     bool enable_wrapper_type_null_unboxing, cel::ValueManager& value_factory,
     bool enable_optional_types = false);
 
+// True if `step` is a select (or flattened select-path) step planned without
+// a presence test or optional-type handling. Such steps can be absorbed into
+// a longer flattened select path by the planner.
+bool IsFlattenableSelectStep(const ExpressionStep& step);
+
+// Combines `operand_step` (which must satisfy IsFlattenableSelectStep) with
+// one more field access, returning a single step that applies the whole
+// qualifier path `a.b.c.d` without materializing intermediate results on the
+// value stack.
+std::unique_ptr<ExpressionStep> ExtendSelectPathStep(
+    std::unique_ptr<ExpressionStep> operand_step, cel::StringValue field,
+    bool test_only, int64_t expr_id);
+
+// As above for recursive plans: if `operand` is a flattenable direct select
+// step, returns a combined select-path step (consuming `operand`); otherwise
+// returns nullptr and leaves `operand` untouched.
+std::unique_ptr<DirectExpressionStep> MaybeExtendDirectSelectPath(
+    std::unique_ptr<DirectExpressionStep>& operand, cel::StringValue field,
+    bool test_only, int64_t expr_id);
+
+// Factory method for a fused optional-select (`_?._` with a constant string
+// field) step for the stack machine. The step pops the chain operand and
+// applies `field`; chains like `a.?b.?c` grow one link at a time via
+// ExtendOptionalSelectPathStep. Absence is tracked internally with a flag, so
+// at most one OptionalValue is constructed per evaluation -- when the result
+// escapes the chain -- instead of one per link.
+std::unique_ptr<ExpressionStep> CreateOptionalSelectPathStep(
+    cel::StringValue field, int64_t expr_id);
+
+// True if `step` is a fused optional-select path step that can absorb another
+// `.?field` link.
+bool IsOptionalSelectPathStep(const ExpressionStep& step);
+
+// Combines `operand_step` (which must satisfy IsOptionalSelectPathStep) with
+// one more optional field access.
+std::unique_ptr<ExpressionStep> ExtendOptionalSelectPathStep(
+    std::unique_ptr<ExpressionStep> operand_step, cel::StringValue field,
+    int64_t expr_id);
+
+// As above for recursive plans.
+std::unique_ptr<DirectExpressionStep> CreateDirectOptionalSelectPathStep(
+    std::unique_ptr<DirectExpressionStep> operand, cel::StringValue field,
+    int64_t expr_id);
+
+// If `operand` is a fused optional-select path step, returns a combined step
+// with `field` appended (consuming `operand`); otherwise returns nullptr and
+// leaves `operand` untouched.
+std::unique_ptr<DirectExpressionStep> MaybeExtendDirectOptionalSelectPath(
+    std::unique_ptr<DirectExpressionStep>& operand, cel::StringValue field,
+    int64_t expr_id);
+
 }  // namespace google::api::expr::runtime
 
 #endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_SELECT_STEP_H_
@@ -1540,6 +1540,244 @@ TEST_F(DirectSelectStepTest, ForwardErrorValue) {
               StatusIs(absl::StatusCode::kInternal, HasSubstr("test1")));
 }
 
+class SelectPathStepTest : public SelectStepTest {
+ public:
+  // Helper method. Creates a container backed map, keeping it alive for the
+  // duration of the test.
+  CelValue MakeMap(std::vector<std::pair<CelValue, CelValue>> key_values) {
+    auto map = CreateContainerBackedMap(
+                   absl::Span<std::pair<CelValue, CelValue>>(key_values))
+                   .value();
+    CelValue result = CelValue::CreateMap(map.get());
+    maps_.push_back(std::move(map));
+    return result;
+  }
+
+  // Helper method. Plans target.<fields[0]>...<fields[n-1]> as an ident step
+  // followed by a single flattened select path step and runs it.
+  absl::StatusOr<CelValue> RunChain(
+      CelValue target, const std::vector<std::string>& fields, bool test_last,
+      RunExpressionOptions options,
+      std::vector<CelAttributePattern> unknown_patterns = {}) {
+    ExecutionPath path;
+
+    Expr ident_expr;
+    auto& ident = ident_expr.mutable_ident_expr();
+    ident.set_name("target");
+    CEL_ASSIGN_OR_RETURN(auto ident_step, CreateIdentStep(ident, 1));
+    path.push_back(std::move(ident_step));
+
+    Expr select_parent;
+    auto& select = select_parent.mutable_select_expr();
+    select.set_field(fields[0]);
+    select.set_test_only(fields.size() == 1 && test_last);
+    CEL_ASSIGN_OR_RETURN(
+        std::unique_ptr<ExpressionStep> select_step,
+        CreateSelectStep(select, 2, options.enable_wrapper_type_null_unboxing,
+                         value_factory_));
+    for (size_t i = 1; i < fields.size(); ++i) {
+      select_step = ExtendSelectPathStep(
+          std::move(select_step),
+          value_factory_.CreateUncheckedStringValue(fields[i]),
+          /*test_only=*/i + 1 == fields.size() && test_last,
+          /*expr_id=*/static_cast<int64_t>(i) + 2);
+    }
+    path.push_back(std::move(select_step));
+
+    cel::RuntimeOptions runtime_options;
+    if (options.enable_unknowns) {
+      runtime_options.unknown_processing =
+          cel::UnknownProcessingOptions::kAttributeOnly;
+    }
+    CelExpressionFlatImpl cel_expr(
+        FlatExpression(std::move(path), /*comprehension_slot_count=*/0,
+                       TypeProvider::Builtin(), runtime_options));
+    Activation activation;
+    activation.InsertValue("target", target);
+    activation.set_unknown_attribute_patterns(std::move(unknown_patterns));
+
+    return cel_expr.Evaluate(activation, &arena_);
+  }
+
+ private:
+  std::vector<std::unique_ptr<CelMap>> maps_;
+};
+
+TEST_F(SelectPathStepTest, FlattenedChainSelectsThroughNestedMaps) {
+  CelValue inner =
+      MakeMap({{CelValue::CreateStringView("c"), CelValue::CreateInt64(42)}});
+  CelValue middle = MakeMap({{CelValue::CreateStringView("b"), inner}});
+  CelValue target = MakeMap({{CelValue::CreateStringView("a"), middle}});
+  RunExpressionOptions options;
+
+  ASSERT_OK_AND_ASSIGN(CelValue result,
+                       RunChain(target, {"a", "b", "c"},
+                                /*test_last=*/false, options));
+
+  ASSERT_TRUE(result.IsInt64());
+  EXPECT_EQ(result.Int64OrDie(), 42);
+}
+
+TEST_F(SelectPathStepTest, FlattenedChainPresenceTest) {
+  CelValue inner =
+      MakeMap({{CelValue::CreateStringView("c"), CelValue::CreateInt64(42)}});
+  CelValue middle = MakeMap({{CelValue::CreateStringView("b"), inner}});
+  CelValue target = MakeMap({{CelValue::CreateStringView("a"), middle}});
+  RunExpressionOptions options;
+
+  ASSERT_OK_AND_ASSIGN(CelValue result, RunChain(target, {"a", "b", "c"},
+                                                 /*test_last=*/true, options));
+  ASSERT_TRUE(result.IsBool());
+  EXPECT_TRUE(result.BoolOrDie());
+
+  ASSERT_OK_AND_ASSIGN(result, RunChain(target, {"a", "b", "missing"},
+                                        /*test_last=*/true, options));
+  ASSERT_TRUE(result.IsBool());
+  EXPECT_FALSE(result.BoolOrDie());
+}
+
+TEST_F(SelectPathStepTest, FlattenedChainNullIntermediate) {
+  CelValue target =
+      MakeMap({{CelValue::CreateStringView("a"), CelValue::CreateNull()}});
+  RunExpressionOptions options;
+
+  ASSERT_OK_AND_ASSIGN(CelValue result, RunChain(target, {"a", "b"},
+                                                 /*test_last=*/false, options));
+
+  ASSERT_TRUE(result.IsError());
+  EXPECT_THAT(*result.ErrorOrDie(),
+              StatusIs(absl::StatusCode::kUnknown,
+                       HasSubstr("Message is NULL")));
+}
+
+TEST_F(SelectPathStepTest, FlattenedChainIdentifiesUnknowns) {
+  CelValue inner =
+      MakeMap({{CelValue::CreateStringView("c"), CelValue::CreateInt64(42)}});
+  CelValue middle = MakeMap({{CelValue::CreateStringView("b"), inner}});
+  CelValue target = MakeMap({{CelValue::CreateStringView("a"), middle}});
+  RunExpressionOptions options;
+  options.enable_unknowns = true;
+
+  std::vector<CelAttributePattern> unknown_patterns;
+  unknown_patterns.push_back(CelAttributePattern(
+      "target", {CreateCelAttributeQualifierPattern(
+                     CelValue::CreateStringView("a")),
+                 CreateCelAttributeQualifierPattern(
+                     CelValue::CreateStringView("b"))}));
+
+  ASSERT_OK_AND_ASSIGN(
+      CelValue result,
+      RunChain(target, {"a", "b", "c"}, /*test_last=*/false, options,
+               std::move(unknown_patterns)));
+
+  ASSERT_TRUE(result.IsUnknownSet());
+}
+
+TEST_F(DirectSelectStepTest, MaybeExtendDirectSelectPathCombinesChain) {
+  cel::Activation activation;
+  RuntimeOptions options;
+
+  ASSERT_OK_AND_ASSIGN(auto inner_builder,
+                       value_manager_.get().NewMapValueBuilder(
+                           value_manager_.get().GetDynDynMapType()));
+  ASSERT_OK(inner_builder->Put(
+      value_manager_.get().CreateUncheckedStringValue("c"), IntValue(42)));
+  ASSERT_OK_AND_ASSIGN(auto middle_builder,
+                       value_manager_.get().NewMapValueBuilder(
+                           value_manager_.get().GetDynDynMapType()));
+  ASSERT_OK(middle_builder->Put(
+      value_manager_.get().CreateUncheckedStringValue("b"),
+      std::move(*inner_builder).Build()));
+  ASSERT_OK_AND_ASSIGN(auto outer_builder,
+                       value_manager_.get().NewMapValueBuilder(
+                           value_manager_.get().GetDynDynMapType()));
+  ASSERT_OK(outer_builder->Put(
+      value_manager_.get().CreateUncheckedStringValue("a"),
+      std::move(*middle_builder).Build()));
+  activation.InsertOrAssignValue("map_val", std::move(*outer_builder).Build());
+
+  std::unique_ptr<DirectExpressionStep> step = CreateDirectSelectStep(
+      CreateDirectIdentStep("map_val", -1),
+      value_manager_.get().CreateUncheckedStringValue("a"),
+      /*test_only=*/false, -1,
+      /*enable_wrapper_type_null_unboxing=*/true);
+
+  std::unique_ptr<DirectExpressionStep> extended = MaybeExtendDirectSelectPath(
+      step, value_manager_.get().CreateUncheckedStringValue("b"),
+      /*test_only=*/false, -1);
+  ASSERT_NE(extended, nullptr);
+  EXPECT_EQ(step, nullptr);
+
+  std::unique_ptr<DirectExpressionStep> full = MaybeExtendDirectSelectPath(
+      extended, value_manager_.get().CreateUncheckedStringValue("c"),
+      /*test_only=*/false, -1);
+  ASSERT_NE(full, nullptr);
+  EXPECT_EQ(extended, nullptr);
+
+  ExecutionFrameBase frame(activation, options, value_manager_.get());
+
+  Value result;
+  AttributeTrail attr;
+  ASSERT_OK(full->Evaluate(frame, result, attr));
+
+  ASSERT_TRUE(InstanceOf<IntValue>(result));
+  EXPECT_EQ(Cast<IntValue>(result).NativeValue(), 42);
+}
+
+TEST_F(DirectSelectStepTest, MaybeExtendDirectSelectPathRejectsNonSelect) {
+  std::unique_ptr<DirectExpressionStep> ident =
+      CreateDirectIdentStep("map_val", -1);
+
+  EXPECT_EQ(MaybeExtendDirectSelectPath(
+                ident, value_manager_.get().CreateUncheckedStringValue("a"),
+                /*test_only=*/false, -1),
+            nullptr);
+  // The operand is left intact on failure.
+  EXPECT_NE(ident, nullptr);
+}
+
+TEST_F(DirectSelectStepTest, FlattenedPathIdentifiesUnknowns) {
+  cel::Activation activation;
+  RuntimeOptions options;
+  options.unknown_processing = cel::UnknownProcessingOptions::kAttributeOnly;
+
+  ASSERT_OK_AND_ASSIGN(auto inner_builder,
+                       value_manager_.get().NewMapValueBuilder(
+                           value_manager_.get().GetDynDynMapType()));
+  ASSERT_OK(inner_builder->Put(
+      value_manager_.get().CreateUncheckedStringValue("b"), IntValue(1)));
+  ASSERT_OK_AND_ASSIGN(auto outer_builder,
+                       value_manager_.get().NewMapValueBuilder(
+                           value_manager_.get().GetDynDynMapType()));
+  ASSERT_OK(outer_builder->Put(
+      value_manager_.get().CreateUncheckedStringValue("a"),
+      std::move(*inner_builder).Build()));
+  activation.InsertOrAssignValue("map_val", std::move(*outer_builder).Build());
+  activation.SetUnknownPatterns({cel::AttributePattern(
+      "map_val", {cel::AttributeQualifierPattern::OfString("a"),
+                  cel::AttributeQualifierPattern::OfString("b")})});
+
+  std::unique_ptr<DirectExpressionStep> step = CreateDirectSelectStep(
+      CreateDirectIdentStep("map_val", -1),
+      value_manager_.get().CreateUncheckedStringValue("a"),
+      /*test_only=*/false, -1,
+      /*enable_wrapper_type_null_unboxing=*/true);
+  std::unique_ptr<DirectExpressionStep> full = MaybeExtendDirectSelectPath(
+      step, value_manager_.get().CreateUncheckedStringValue("b"),
+      /*test_only=*/false, -1);
+  ASSERT_NE(full, nullptr);
+
+  ExecutionFrameBase frame(activation, options, value_manager_.get());
+
+  Value result;
+  AttributeTrail attr;
+  ASSERT_OK(full->Evaluate(frame, result, attr));
+
+  ASSERT_TRUE(InstanceOf<UnknownValue>(result));
+  EXPECT_THAT(AttributeStrings(Cast<UnknownValue>(result)),
+              UnorderedElementsAre("map_val.a.b"));
+}
+
 TEST_F(DirectSelectStepTest, ForwardUnknownOperand) {
   cel::Activation activation;
   RuntimeOptions options;
@@ -0,0 +1,145 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/string_concat_step.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "base/builtins.h"
+#include "common/casting.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/expression_step_base.h"
+#include "runtime/internal/errors.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+using ::cel::Cast;
+using ::cel::ErrorValue;
+using ::cel::InstanceOf;
+using ::cel::StringValue;
+using ::cel::Value;
+
+// Mirrors the legacy type naming used by function steps when reporting a
+// failed overload resolution. int -> int64, uint -> uint64.
+std::string LegacyKindName(const Value& value) {
+  absl::string_view name = cel::ValueKindToString(value.kind());
+  if (name == "int" || name == "uint") {
+    return absl::StrCat(name, "64");
+  }
+  return std::string(name);
+}
+
+struct AppendToStringVisitor final {
+  std::string& out;
+
+  void operator()(absl::string_view value) const {
+    out.append(value.data(), value.size());
+  }
+
+  void operator()(const absl::Cord& value) const {
+    absl::AppendCordToString(value, &out);
+  }
+};
+
+class StringConcatStep final : public ExpressionStepBase {
+ public:
+  StringConcatStep(int64_t expr_id, size_t count)
+      : ExpressionStepBase(expr_id, /*comes_from_ast=*/true), count_(count) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override;
+
+ private:
+  // Reproduces the no-matching-overload error the pairwise fold would have
+  // produced when folding args[index] into the (string) accumulation of
+  // everything to its left.
+  Value NoMatchingOverload(ExecutionFrame* frame, absl::Span<const Value> args,
+                           size_t index) const;
+
+  const size_t count_;
+};
+
+Value StringConcatStep::NoMatchingOverload(ExecutionFrame* frame,
+                                           absl::Span<const Value> args,
+                                           size_t index) const {
+  std::string lhs =
+      index == 0 ? LegacyKindName(args[0]) : std::string("string");
+  size_t rhs = index == 0 ? 1 : index;
+  return frame->value_factory().CreateErrorValue(
+      cel::runtime_internal::CreateNoMatchingOverloadError(
+          absl::StrCat(cel::builtin::kAdd, "(", lhs, ", ",
+                       LegacyKindName(args[rhs]), ")")));
+}
+
+absl::Status StringConcatStep::Evaluate(ExecutionFrame* frame) const {
+  if (!frame->value_stack().HasEnough(count_)) {
+    return absl::Status(absl::StatusCode::kInternal,
+                        "Insufficient arguments supplied for string "
+                        "concatenation");
+  }
+  absl::Span<const Value> args = frame->value_stack().GetSpan(count_);
+
+  // The leftmost erroring operand wins, matching the left fold of pairwise
+  // function steps this step replaces.
+  for (const Value& arg : args) {
+    if (InstanceOf<ErrorValue>(arg)) {
+      Value result = arg;
+      frame->value_stack().PopAndPush(count_, std::move(result));
+      return absl::OkStatus();
+    }
+  }
+
+  // Size the result once before copying any fragments.
+  size_t total_size = 0;
+  for (size_t i = 0; i < args.size(); ++i) {
+    if (!InstanceOf<StringValue>(args[i])) {
+      Value result = NoMatchingOverload(frame, args, i);
+      frame->value_stack().PopAndPush(count_, std::move(result));
+      return absl::OkStatus();
+    }
+    total_size += Cast<StringValue>(args[i]).Size();
+  }
+
+  std::string joined;
+  joined.reserve(total_size);
+  for (const Value& arg : args) {
+    Cast<StringValue>(arg).NativeValue(AppendToStringVisitor{joined});
+  }
+  Value result =
+      frame->value_factory().CreateUncheckedStringValue(std::move(joined));
+  frame->value_stack().PopAndPush(count_, std::move(result));
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateStringConcatStep(
+    size_t count, int64_t expr_id) {
+  return std::make_unique<StringConcatStep>(expr_id, count);
+}
+
+}  // namespace google::api::expr::runtime
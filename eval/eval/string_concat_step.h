@@ -0,0 +1,40 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_STRING_CONCAT_STEP_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_STRING_CONCAT_STEP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "absl/status/statusor.h"
+#include "eval/eval/evaluator_core.h"
+
+namespace google::api::expr::runtime {
+
+// Creates a step that pops `count` operands of a flattened `_+_` string
+// concatenation chain and pushes their join, sizing the result buffer once
+// instead of allocating an intermediate string per pairwise concatenation.
+//
+// The planner only emits this step for chains it has proven (or, for
+// parse-only expressions, anchored with a leading string constant) to be
+// string concatenations; operands of other kinds produce the same
+// no-matching-overload error the pairwise fold would have produced.
+absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateStringConcatStep(
+    size_t count, int64_t expr_id);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_STRING_CONCAT_STEP_H_
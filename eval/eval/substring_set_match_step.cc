@@ -0,0 +1,243 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/substring_set_match_step.h"
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "common/casting.h"
+#include "common/value.h"
+#include "eval/eval/attribute_trail.h"
+#include "eval/eval/direct_expression_step.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/expression_step_base.h"
+#include "internal/status_macros.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+using ::cel::BoolValue;
+using ::cel::Cast;
+using ::cel::ErrorValue;
+using ::cel::InstanceOf;
+using ::cel::StringValue;
+using ::cel::UnknownValue;
+using ::cel::Value;
+
+inline constexpr int kNumSubstringSetMatchArguments = 1;
+inline constexpr size_t kSubstringSetMatchStepSubject = 0;
+
+// Aho-Corasick automaton over the literal set.
+//
+// For kContains the failure function is resolved into dense per-node
+// transition tables at build time, so matching is one table load per subject
+// byte with no backtracking. For kStartsWith the automaton is the bare trie:
+// the walk stops at the first missing edge, and a terminal node means some
+// literal is a prefix of the subject.
+class SubstringSetMatcher {
+ public:
+  SubstringSetMatcher(std::vector<std::string> patterns,
+                      SubstringSetMatchMode mode)
+      : mode_(mode) {
+    nodes_.emplace_back();
+    for (const std::string& pattern : patterns) {
+      int32_t state = 0;
+      for (char c : pattern) {
+        auto b = static_cast<unsigned char>(c);
+        if (nodes_[state].next[b] < 0) {
+          nodes_[state].next[b] = static_cast<int32_t>(nodes_.size());
+          nodes_.emplace_back();
+        }
+        state = nodes_[state].next[b];
+      }
+      // An empty literal terminates the root and matches every subject.
+      nodes_[state].terminal = true;
+    }
+    if (mode_ == SubstringSetMatchMode::kContains) {
+      ResolveFailureLinks();
+    }
+  }
+
+  bool Match(absl::string_view subject) const {
+    if (nodes_[0].terminal) {
+      return true;
+    }
+    int32_t state = 0;
+    for (char c : subject) {
+      state = nodes_[state].next[static_cast<unsigned char>(c)];
+      if (state < 0) {
+        // Only reachable in kStartsWith mode: no literal shares this prefix.
+        return false;
+      }
+      if (nodes_[state].terminal) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  struct Node {
+    Node() { next.fill(-1); }
+
+    std::array<int32_t, 256> next;
+    bool terminal = false;
+  };
+
+  // Standard breadth-first construction: each missing edge is redirected to
+  // where the longest proper suffix of the path would lead, and terminal
+  // marks are propagated along the suffix links.
+  void ResolveFailureLinks() {
+    std::vector<int32_t> fail(nodes_.size(), 0);
+    std::deque<int32_t> queue;
+    for (int b = 0; b < 256; ++b) {
+      int32_t child = nodes_[0].next[b];
+      if (child < 0) {
+        nodes_[0].next[b] = 0;
+      } else {
+        fail[child] = 0;
+        queue.push_back(child);
+      }
+    }
+    while (!queue.empty()) {
+      int32_t state = queue.front();
+      queue.pop_front();
+      nodes_[state].terminal =
+          nodes_[state].terminal || nodes_[fail[state]].terminal;
+      for (int b = 0; b < 256; ++b) {
+        int32_t child = nodes_[state].next[b];
+        if (child < 0) {
+          nodes_[state].next[b] = nodes_[fail[state]].next[b];
+        } else {
+          fail[child] = nodes_[fail[state]].next[b];
+          queue.push_back(child);
+        }
+      }
+    }
+  }
+
+  std::vector<Node> nodes_;
+  SubstringSetMatchMode mode_;
+};
+
+struct MatchesAnyVisitor final {
+  const SubstringSetMatcher& matcher;
+
+  bool operator()(const absl::Cord& value) const {
+    if (auto flat = value.TryFlat(); flat.has_value()) {
+      return matcher.Match(*flat);
+    }
+    return matcher.Match(static_cast<std::string>(value));
+  }
+
+  bool operator()(absl::string_view value) const {
+    return matcher.Match(value);
+  }
+};
+
+class SubstringSetMatchStep final : public ExpressionStepBase {
+ public:
+  SubstringSetMatchStep(int64_t expr_id, std::vector<std::string> patterns,
+                        SubstringSetMatchMode mode)
+      : ExpressionStepBase(expr_id, /*comes_from_ast=*/true),
+        matcher_(std::move(patterns), mode) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    if (!frame->value_stack().HasEnough(kNumSubstringSetMatchArguments)) {
+      return absl::Status(absl::StatusCode::kInternal,
+                          "Insufficient arguments supplied for substring "
+                          "set match");
+    }
+    auto input_args =
+        frame->value_stack().GetSpan(kNumSubstringSetMatchArguments);
+    const auto& subject = input_args[kSubstringSetMatchStepSubject];
+    if (!subject->Is<cel::StringValue>()) {
+      return absl::Status(absl::StatusCode::kInternal,
+                          "First argument for substring "
+                          "set match must be a string");
+    }
+    bool match =
+        subject.As<cel::StringValue>().NativeValue(MatchesAnyVisitor{matcher_});
+    frame->value_stack().PopAndPush(
+        kNumSubstringSetMatchArguments,
+        frame->value_factory().CreateBoolValue(match));
+    return absl::OkStatus();
+  }
+
+ private:
+  const SubstringSetMatcher matcher_;
+};
+
+class SubstringSetMatchDirectStep final : public DirectExpressionStep {
+ public:
+  SubstringSetMatchDirectStep(int64_t expr_id,
+                              std::unique_ptr<DirectExpressionStep> subject,
+                              std::vector<std::string> patterns,
+                              SubstringSetMatchMode mode)
+      : DirectExpressionStep(expr_id),
+        subject_(std::move(subject)),
+        matcher_(std::move(patterns), mode) {}
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
+                        AttributeTrail& attribute) const override {
+    AttributeTrail subject_attr;
+    CEL_RETURN_IF_ERROR(subject_->Evaluate(frame, result, subject_attr));
+    if (InstanceOf<ErrorValue>(result) ||
+        cel::InstanceOf<UnknownValue>(result)) {
+      return absl::OkStatus();
+    }
+
+    if (!InstanceOf<StringValue>(result)) {
+      return absl::Status(absl::StatusCode::kInternal,
+                          "First argument for substring "
+                          "set match must be a string");
+    }
+    bool match =
+        Cast<StringValue>(result).NativeValue(MatchesAnyVisitor{matcher_});
+    result = BoolValue(match);
+    return absl::OkStatus();
+  }
+
+ private:
+  std::unique_ptr<DirectExpressionStep> subject_;
+  const SubstringSetMatcher matcher_;
+};
+
+}  // namespace
+
+std::unique_ptr<DirectExpressionStep> CreateDirectSubstringSetMatchStep(
+    int64_t expr_id, std::unique_ptr<DirectExpressionStep> subject,
+    std::vector<std::string> patterns, SubstringSetMatchMode mode) {
+  return std::make_unique<SubstringSetMatchDirectStep>(
+      expr_id, std::move(subject), std::move(patterns), mode);
+}
+
+absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateSubstringSetMatchStep(
+    std::vector<std::string> patterns, SubstringSetMatchMode mode,
+    int64_t expr_id) {
+  return std::make_unique<SubstringSetMatchStep>(expr_id, std::move(patterns),
+                                                 mode);
+}
+
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,53 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_SUBSTRING_SET_MATCH_STEP_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_SUBSTRING_SET_MATCH_STEP_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "eval/eval/direct_expression_step.h"
+#include "eval/eval/evaluator_core.h"
+
+namespace google::api::expr::runtime {
+
+// Steps evaluating a disjunction of contains() or startsWith() calls with
+// constant literals against one subject as a single scan of the subject.
+// The literals are compiled into an Aho-Corasick automaton at plan time, so
+// the subject is traversed once regardless of how many literals are tested.
+
+// Which string function the lowered disjuncts called. All disjuncts must
+// have called the same function.
+enum class SubstringSetMatchMode {
+  // Any literal occurs anywhere in the subject.
+  kContains,
+  // Any literal is a prefix of the subject.
+  kStartsWith,
+};
+
+std::unique_ptr<DirectExpressionStep> CreateDirectSubstringSetMatchStep(
+    int64_t expr_id, std::unique_ptr<DirectExpressionStep> subject,
+    std::vector<std::string> patterns, SubstringSetMatchMode mode);
+
+absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateSubstringSetMatchStep(
+    std::vector<std::string> patterns, SubstringSetMatchMode mode,
+    int64_t expr_id);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_SUBSTRING_SET_MATCH_STEP_H_
@@ -5,6 +5,7 @@
 #include <memory>
 #include <utility>
 
+#include "absl/base/optimization.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "base/builtins.h"
@@ -58,6 +59,20 @@ class ExhaustiveDirectTernaryStep : public DirectExpressionStep {
     CEL_RETURN_IF_ERROR(left_->Evaluate(frame, lhs, lhs_attr));
     CEL_RETURN_IF_ERROR(right_->Evaluate(frame, rhs, rhs_attr));
 
+    // A bool condition is by far the common case (the type checker only
+    // admits bool), so the error/unknown handling stays off the predicted
+    // path.
+    if (ABSL_PREDICT_TRUE(InstanceOf<BoolValue>(condition))) {
+      if (Cast<BoolValue>(condition).NativeValue()) {
+        result = std::move(lhs);
+        attribute = std::move(lhs_attr);
+      } else {
+        result = std::move(rhs);
+        attribute = std::move(rhs_attr);
+      }
+      return absl::OkStatus();
+    }
+
     if (InstanceOf<ErrorValue>(condition) ||
         InstanceOf<UnknownValue>(condition)) {
       result = std::move(condition);
@@ -65,19 +80,8 @@ class ExhaustiveDirectTernaryStep : public DirectExpressionStep {
       return absl::OkStatus();
     }
 
-    if (!InstanceOf<BoolValue>(condition)) {
-      result = frame.value_manager().CreateErrorValue(
-          CreateNoMatchingOverloadError(kTernary));
-      return absl::OkStatus();
-    }
-
-    if (Cast<BoolValue>(condition).NativeValue()) {
-      result = std::move(lhs);
-      attribute = std::move(lhs_attr);
-    } else {
-      result = std::move(rhs);
-      attribute = std::move(rhs_attr);
-    }
+    result = frame.value_manager().CreateErrorValue(
+        CreateNoMatchingOverloadError(kTernary));
     return absl::OkStatus();
   }
 
@@ -106,6 +110,16 @@ class ShortcircuitingDirectTernaryStep : public DirectExpressionStep {
 
     CEL_RETURN_IF_ERROR(condition_->Evaluate(frame, condition, condition_attr));
 
+    // A bool condition is by far the common case (the type checker only
+    // admits bool), so the error/unknown handling stays off the predicted
+    // path.
+    if (ABSL_PREDICT_TRUE(InstanceOf<BoolValue>(condition))) {
+      if (Cast<BoolValue>(condition).NativeValue()) {
+        return left_->Evaluate(frame, result, attribute);
+      }
+      return right_->Evaluate(frame, result, attribute);
+    }
+
     if (InstanceOf<ErrorValue>(condition) ||
         InstanceOf<UnknownValue>(condition)) {
       result = std::move(condition);
@@ -113,16 +127,9 @@ class ShortcircuitingDirectTernaryStep : public DirectExpressionStep {
       return absl::OkStatus();
     }
 
-    if (!InstanceOf<BoolValue>(condition)) {
-      result = frame.value_manager().CreateErrorValue(
-          CreateNoMatchingOverloadError(kTernary));
-      return absl::OkStatus();
-    }
-
-    if (Cast<BoolValue>(condition).NativeValue()) {
-      return left_->Evaluate(frame, result, attribute);
-    }
-    return right_->Evaluate(frame, result, attribute);
+    result = frame.value_manager().CreateErrorValue(
+        CreateNoMatchingOverloadError(kTernary));
+    return absl::OkStatus();
   }
 
  private:
@@ -146,9 +153,23 @@ absl::Status TernaryStep::Evaluate(ExecutionFrame* frame) const {
   }
 
   // Create Span object that contains input arguments to the function.
-  auto args = frame->value_stack().GetSpan(3);
+  // Mutable access lets the chosen branch be moved off the stack instead of
+  // copied; the arguments are popped below either way.
+  auto args = frame->value_stack().GetMutableSpan(3);
 
   const auto& condition = args[kTernaryStepCondition];
+
+  // A bool condition is by far the common case (the type checker only admits
+  // bool), so it is decided with a single predicted test and the
+  // error/unknown handling stays off the hot path.
+  if (ABSL_PREDICT_TRUE(condition->Is<cel::BoolValue>())) {
+    cel::Value result = condition.As<cel::BoolValue>().NativeValue()
+                            ? std::move(args[kTernaryStepTrue])
+                            : std::move(args[kTernaryStepFalse]);
+    frame->value_stack().PopAndPush(args.size(), std::move(result));
+    return absl::OkStatus();
+  }
+
   // As opposed to regular functions, ternary treats unknowns or errors on the
   // condition (arg0) as blocking. If we get an error or unknown then we
   // ignore the other arguments and forward the condition as the result.
@@ -165,23 +186,82 @@ absl::Status TernaryStep::Evaluate(ExecutionFrame* frame) const {
     return absl::OkStatus();
   }
 
-  cel::Value result;
-  if (!condition->Is<cel::BoolValue>()) {
-    result = frame->value_factory().CreateErrorValue(
-        CreateNoMatchingOverloadError(kTernary));
-  } else if (condition.As<cel::BoolValue>().NativeValue()) {
-    result = args[kTernaryStepTrue];
-  } else {
-    result = args[kTernaryStepFalse];
+  frame->value_stack().PopAndPush(
+      args.size(), frame->value_factory().CreateErrorValue(
+                       CreateNoMatchingOverloadError(kTernary)));
+
+  return absl::OkStatus();
+}
+
+// Join step for a speculatively evaluated ternary (see
+// SpeculativeBranchesStep). The branches are not inline in the program, so
+// unlike TernaryStep only the condition is on the stack.
+class SpeculativeTernaryStep final : public ExpressionStepBase {
+ public:
+  SpeculativeTernaryStep(size_t left_subexpression_index,
+                         size_t right_subexpression_index, int64_t expr_id)
+      : ExpressionStepBase(expr_id),
+        left_subexpression_index_(left_subexpression_index),
+        right_subexpression_index_(right_subexpression_index) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override;
+
+  // The join performs the work of the chosen branch (awaited or inline).
+  int64_t Cost() const override { return 2; }
+
+ private:
+  size_t left_subexpression_index_;
+  size_t right_subexpression_index_;
+};
+
+absl::Status SpeculativeTernaryStep::Evaluate(ExecutionFrame* frame) const {
+  if (!frame->value_stack().HasEnough(1)) {
+    return absl::Status(absl::StatusCode::kInternal, "Value stack underflow");
   }
 
-  frame->value_stack().PopAndPush(args.size(), std::move(result));
+  const cel::Value& condition = frame->value_stack().Peek();
 
-  return absl::OkStatus();
+  if (ABSL_PREDICT_FALSE(!condition->Is<cel::BoolValue>())) {
+    if (frame->has_speculative_branches()) {
+      frame->DiscardSpeculativeBranches();
+    }
+    // Like the jump-based plan, an unknown or error condition bypasses both
+    // branches and is forwarded as the result.
+    if ((frame->enable_unknowns() && condition->Is<cel::UnknownValue>()) ||
+        condition->Is<cel::ErrorValue>()) {
+      return absl::OkStatus();
+    }
+    frame->value_stack().PopAndPush(frame->value_factory().CreateErrorValue(
+        CreateNoMatchingOverloadError(kTernary)));
+    return absl::OkStatus();
+  }
+
+  const bool take_left = condition.As<cel::BoolValue>().NativeValue();
+
+  if (frame->has_speculative_branches()) {
+    CEL_ASSIGN_OR_RETURN(cel::Value result,
+                         frame->AwaitSpeculativeBranch(take_left));
+    // Fused: the branch result replaces the condition in place.
+    frame->value_stack().PopAndPush(std::move(result));
+    return absl::OkStatus();
+  }
+
+  // Speculation was unavailable at launch; evaluate the chosen branch
+  // sequentially. The condition is popped first so the branch's result lands
+  // in its slot.
+  frame->value_stack().Pop(1);
+  return frame->EvaluateSubexpressionInline(
+      take_left ? left_subexpression_index_ : right_subexpression_index_);
 }
 
 }  // namespace
 
+absl::Status SpeculativeBranchesStep::Evaluate(ExecutionFrame* frame) const {
+  frame->LaunchSpeculativeBranches(left_subexpression_index_,
+                                   right_subexpression_index_);
+  return absl::OkStatus();
+}
+
 // Factory method for ternary (_?_:_) recursive execution step
 std::unique_ptr<DirectExpressionStep> CreateDirectTernaryStep(
     std::unique_ptr<DirectExpressionStep> condition,
@@ -202,4 +282,16 @@ absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateTernaryStep(
   return std::make_unique<TernaryStep>(expr_id);
 }
 
+std::unique_ptr<SpeculativeBranchesStep> CreateSpeculativeBranchesStep(
+    int64_t expr_id) {
+  return std::make_unique<SpeculativeBranchesStep>(expr_id);
+}
+
+std::unique_ptr<ExpressionStep> CreateSpeculativeTernaryStep(
+    size_t left_subexpression_index, size_t right_subexpression_index,
+    int64_t expr_id) {
+  return std::make_unique<SpeculativeTernaryStep>(
+      left_subexpression_index, right_subexpression_index, expr_id);
+}
+
 }  // namespace google::api::expr::runtime
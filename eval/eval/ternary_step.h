@@ -1,12 +1,15 @@
 #ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_TERNARY_STEP_H_
 #define THIRD_PARTY_CEL_CPP_EVAL_EVAL_TERNARY_STEP_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
+#include "eval/eval/expression_step_base.h"
 
 namespace google::api::expr::runtime {
 
@@ -21,6 +24,42 @@ std::unique_ptr<DirectExpressionStep> CreateDirectTernaryStep(
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateTernaryStep(
     int64_t expr_id);
 
+// Starts speculative evaluation of the ternary branch subexpressions before
+// the condition runs (see RuntimeOptions::speculation_executor). Planned
+// ahead of the condition, so the branch subexpression indices are patched in
+// once the branches have been planned and extracted, like jump targets.
+class SpeculativeBranchesStep final : public ExpressionStepBase {
+ public:
+  explicit SpeculativeBranchesStep(int64_t expr_id)
+      : ExpressionStepBase(expr_id, /*comes_from_ast=*/false) {}
+
+  void set_subexpressions(size_t left_subexpression_index,
+                          size_t right_subexpression_index) {
+    left_subexpression_index_ = left_subexpression_index;
+    right_subexpression_index_ = right_subexpression_index;
+  }
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override;
+
+ private:
+  size_t left_subexpression_index_ = 0;
+  size_t right_subexpression_index_ = 0;
+};
+
+// Factory method for the speculative branch launch step. The returned step's
+// subexpression indices must be patched via set_subexpressions before the
+// plan is finalized.
+std::unique_ptr<SpeculativeBranchesStep> CreateSpeculativeBranchesStep(
+    int64_t expr_id);
+
+// Factory method for the join step of a speculatively evaluated ternary.
+// Consumes the condition from the stack and the branch pair launched by the
+// matching SpeculativeBranchesStep, falling back to inline evaluation of the
+// chosen branch subexpression when speculation was unavailable.
+std::unique_ptr<ExpressionStep> CreateSpeculativeTernaryStep(
+    size_t left_subexpression_index, size_t right_subexpression_index,
+    int64_t expr_id);
+
 }  // namespace google::api::expr::runtime
 
 #endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_TERNARY_STEP_H_
@@ -0,0 +1,49 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_TIME_WINDOW_STEP_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_TIME_WINDOW_STEP_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "absl/status/statusor.h"
+#include "eval/eval/evaluator_core.h"
+
+namespace google::api::expr::runtime {
+
+// Comparison operator of a fused time window check.
+enum class TimeWindowOp {
+  kLess,
+  kLessEqual,
+  kGreater,
+  kGreaterEqual,
+};
+
+// Creates a step implementing `(t1 - t2) op d` for timestamps `t1`, `t2` and
+// duration `d` as one fused operation.
+//
+// The step consumes three values from the stack (t1, t2, d) and pushes the
+// comparison result. The subtraction and comparison are performed on the
+// native time representations with a single range check, instead of a
+// checked subtraction materializing an intermediate duration value followed
+// by a separate dispatched comparison. Inputs whose difference overflows the
+// int64 nanosecond range produce the same error as the checked subtraction
+// would have.
+absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateTimeWindowStep(
+    TimeWindowOp op, int64_t expr_id);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_TIME_WINDOW_STEP_H_
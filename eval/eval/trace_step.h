@@ -18,6 +18,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/optimization.h"
 #include "absl/status/status.h"
 #include "absl/types/optional.h"
 #include "common/native_type.h"
@@ -31,6 +32,12 @@ namespace google::api::expr::runtime {
 // A decorator that implements tracing for recursively evaluated CEL
 // expressions.
 //
+// Whether to invoke the listener is a per-evaluation decision made at frame
+// construction, so a single plan built with tracing enabled serves both
+// traced and untraced evaluations: with no listener installed each node adds
+// only a predicted branch. There is no need to keep a separate untraced copy
+// of the plan resident.
+//
 // Allows inspection for extensions to extract the wrapped expression.
 class TraceStep : public DirectExpressionStep {
  public:
@@ -39,10 +46,10 @@ class TraceStep : public DirectExpressionStep {
 
   absl::Status Evaluate(ExecutionFrameBase& frame, cel::Value& result,
                         AttributeTrail& trail) const override {
-    CEL_RETURN_IF_ERROR(expression_->Evaluate(frame, result, trail));
-    if (!frame.callback()) {
-      return absl::OkStatus();
+    if (ABSL_PREDICT_TRUE(!frame.tracing_enabled())) {
+      return expression_->Evaluate(frame, result, trail);
     }
+    CEL_RETURN_IF_ERROR(expression_->Evaluate(frame, result, trail));
     return frame.callback()(expression_->expr_id(), result,
                             frame.value_manager());
   }
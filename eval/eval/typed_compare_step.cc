@@ -0,0 +1,219 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/typed_compare_step.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "base/builtins.h"
+#include "common/casting.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/expression_step_base.h"
+#include "internal/number.h"
+#include "runtime/internal/errors.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+using ::cel::BoolValue;
+using ::cel::Cast;
+using ::cel::DoubleValue;
+using ::cel::ErrorValue;
+using ::cel::InstanceOf;
+using ::cel::IntValue;
+using ::cel::UintValue;
+using ::cel::Value;
+using ::cel::ValueKind;
+using ::cel::internal::Number;
+
+absl::string_view OpName(TypedCompareOp op) {
+  switch (op) {
+    case TypedCompareOp::kEqual:
+      return cel::builtin::kEqual;
+    case TypedCompareOp::kNotEqual:
+      return cel::builtin::kInequal;
+    case TypedCompareOp::kLess:
+      return cel::builtin::kLess;
+    case TypedCompareOp::kLessEqual:
+      return cel::builtin::kLessOrEqual;
+    case TypedCompareOp::kGreater:
+      return cel::builtin::kGreater;
+    case TypedCompareOp::kGreaterEqual:
+      return cel::builtin::kGreaterOrEqual;
+  }
+  return "";
+}
+
+ValueKind ExpectedKind(TypedCompareType type) {
+  switch (type) {
+    case TypedCompareType::kBool:
+      return ValueKind::kBool;
+    case TypedCompareType::kInt64:
+      return ValueKind::kInt;
+    case TypedCompareType::kUint64:
+      return ValueKind::kUint;
+    case TypedCompareType::kDouble:
+      return ValueKind::kDouble;
+  }
+  return ValueKind::kError;
+}
+
+// Mirrors the legacy type naming used by function steps when reporting a
+// failed overload resolution. int -> int64, uint -> uint64.
+std::string LegacyKindName(const Value& value) {
+  absl::string_view name = cel::ValueKindToString(value.kind());
+  if (name == "int" || name == "uint") {
+    return absl::StrCat(name, "64");
+  }
+  return std::string(name);
+}
+
+template <typename T>
+bool ApplyCompare(TypedCompareOp op, const T& lhs, const T& rhs) {
+  switch (op) {
+    case TypedCompareOp::kEqual:
+      return lhs == rhs;
+    case TypedCompareOp::kNotEqual:
+      return lhs != rhs;
+    case TypedCompareOp::kLess:
+      return lhs < rhs;
+    case TypedCompareOp::kLessEqual:
+      return lhs <= rhs;
+    case TypedCompareOp::kGreater:
+      return lhs > rhs;
+    case TypedCompareOp::kGreaterEqual:
+      return lhs >= rhs;
+  }
+  return false;
+}
+
+absl::optional<Number> NumberFromValue(const Value& value) {
+  switch (value.kind()) {
+    case ValueKind::kInt:
+      return Number::FromInt64(Cast<IntValue>(value).NativeValue());
+    case ValueKind::kUint:
+      return Number::FromUint64(Cast<UintValue>(value).NativeValue());
+    case ValueKind::kDouble:
+      return Number::FromDouble(Cast<DoubleValue>(value).NativeValue());
+    default:
+      return absl::nullopt;
+  }
+}
+
+class TypedCompareStep final : public ExpressionStepBase {
+ public:
+  TypedCompareStep(int64_t expr_id, TypedCompareOp op, TypedCompareType type)
+      : ExpressionStepBase(expr_id, /*comes_from_ast=*/true),
+        op_(op),
+        type_(type) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override;
+
+ private:
+  bool ComparePinned(const Value& lhs, const Value& rhs) const {
+    switch (type_) {
+      case TypedCompareType::kBool:
+        return ApplyCompare(op_, Cast<BoolValue>(lhs).NativeValue(),
+                            Cast<BoolValue>(rhs).NativeValue());
+      case TypedCompareType::kInt64:
+        return ApplyCompare(op_, Cast<IntValue>(lhs).NativeValue(),
+                            Cast<IntValue>(rhs).NativeValue());
+      case TypedCompareType::kUint64:
+        return ApplyCompare(op_, Cast<UintValue>(lhs).NativeValue(),
+                            Cast<UintValue>(rhs).NativeValue());
+      case TypedCompareType::kDouble:
+        return ApplyCompare(op_, Cast<DoubleValue>(lhs).NativeValue(),
+                            Cast<DoubleValue>(rhs).NativeValue());
+    }
+    return false;
+  }
+
+  const TypedCompareOp op_;
+  const TypedCompareType type_;
+};
+
+absl::Status TypedCompareStep::Evaluate(ExecutionFrame* frame) const {
+  if (!frame->value_stack().HasEnough(2)) {
+    return absl::Status(absl::StatusCode::kInternal,
+                        "Insufficient arguments supplied for typed "
+                        "comparison");
+  }
+  absl::Span<const Value> args = frame->value_stack().GetSpan(2);
+
+  // The leftmost erroring operand wins, matching the function step this
+  // step replaces.
+  for (const Value& arg : args) {
+    if (InstanceOf<ErrorValue>(arg)) {
+      Value result = arg;
+      frame->value_stack().PopAndPush(2, std::move(result));
+      return absl::OkStatus();
+    }
+  }
+
+  ValueKind expected = ExpectedKind(type_);
+  if (args[0].kind() == expected && args[1].kind() == expected) {
+    Value result =
+        frame->value_factory().CreateBoolValue(ComparePinned(args[0], args[1]));
+    frame->value_stack().PopAndPush(2, std::move(result));
+    return absl::OkStatus();
+  }
+
+  // The checker pinned the operand types, but an activation may still bind
+  // a differently typed value. Reproduce the heterogeneous comparison
+  // semantics this step replaces: numeric operands compare by value, and
+  // differently typed operands are unequal. Anything else is reported as a
+  // missing overload, like the unfused dispatch would for an ordering.
+  absl::optional<Number> lhs = NumberFromValue(args[0]);
+  absl::optional<Number> rhs = NumberFromValue(args[1]);
+  if (lhs.has_value() && rhs.has_value()) {
+    Value result =
+        frame->value_factory().CreateBoolValue(ApplyCompare(op_, *lhs, *rhs));
+    frame->value_stack().PopAndPush(2, std::move(result));
+    return absl::OkStatus();
+  }
+  if ((op_ == TypedCompareOp::kEqual || op_ == TypedCompareOp::kNotEqual) &&
+      args[0].kind() != args[1].kind()) {
+    Value result = frame->value_factory().CreateBoolValue(
+        op_ == TypedCompareOp::kNotEqual);
+    frame->value_stack().PopAndPush(2, std::move(result));
+    return absl::OkStatus();
+  }
+  Value result = frame->value_factory().CreateErrorValue(
+      cel::runtime_internal::CreateNoMatchingOverloadError(
+          absl::StrCat(OpName(op_), "(", LegacyKindName(args[0]), ", ",
+                       LegacyKindName(args[1]), ")")));
+  frame->value_stack().PopAndPush(2, std::move(result));
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateTypedCompareStep(
+    TypedCompareOp op, TypedCompareType type, int64_t expr_id) {
+  return std::make_unique<TypedCompareStep>(expr_id, op, type);
+}
+
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,55 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_TYPED_COMPARE_STEP_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_TYPED_COMPARE_STEP_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "absl/status/statusor.h"
+#include "eval/eval/evaluator_core.h"
+
+namespace google::api::expr::runtime {
+
+// Comparison operator pinned by the type checker.
+enum class TypedCompareOp {
+  kEqual,
+  kNotEqual,
+  kLess,
+  kLessEqual,
+  kGreater,
+  kGreaterEqual,
+};
+
+// Primitive operand type proven by the type checker.
+enum class TypedCompareType {
+  kBool,
+  kInt64,
+  kUint64,
+  kDouble,
+};
+
+// Creates a step evaluating a comparison whose operand types the checker
+// proved, performing a direct primitive comparison instead of resolving and
+// dispatching a function overload. The two operands are expected on the
+// stack. If an operand does not have the proven type at runtime (a
+// mistyped activation), the step falls back to the semantics of the
+// heterogeneous comparison functions it replaces.
+absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateTypedCompareStep(
+    TypedCompareOp op, TypedCompareType type, int64_t expr_id);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_TYPED_COMPARE_STEP_H_
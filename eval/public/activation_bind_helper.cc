@@ -1,6 +1,13 @@
 #include "eval/public/activation_bind_helper.h"
 
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "eval/public/containers/field_access.h"
 #include "eval/public/containers/field_backed_list_impl.h"
 #include "eval/public/containers/field_backed_map_impl.h"
@@ -33,6 +40,27 @@ absl::Status CreateValueFromField(const google::protobuf::Message* msg,
   }
 }
 
+absl::Status BindFieldToActivation(const Message* message,
+                                   const FieldDescriptor* field_desc,
+                                   Arena* arena, Activation* activation,
+                                   ProtoUnsetFieldOptions options) {
+  if (options == ProtoUnsetFieldOptions::kSkip) {
+    if (!field_desc->is_repeated() &&
+        !message->GetReflection()->HasField(*message, field_desc)) {
+      return absl::OkStatus();
+    }
+  }
+
+  CelValue value;
+  auto status = CreateValueFromField(message, field_desc, arena, &value);
+  if (!status.ok()) {
+    return status;
+  }
+
+  activation->InsertValue(field_desc->name(), value);
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 absl::Status BindProtoToActivation(const Message* message, Arena* arena,
@@ -47,24 +75,72 @@ absl::Status BindProtoToActivation(const Message* message, Arena* arena,
 
   // TODO: Improve the utilities to bind dynamic values as well.
   const Descriptor* desc = message->GetDescriptor();
-  const google::protobuf::Reflection* reflection = message->GetReflection();
   for (int i = 0; i < desc->field_count(); i++) {
-    CelValue value;
-    const FieldDescriptor* field_desc = desc->field(i);
-
-    if (options == ProtoUnsetFieldOptions::kSkip) {
-      if (!field_desc->is_repeated() &&
-          !reflection->HasField(*message, field_desc)) {
-        continue;
-      }
+    auto status = BindFieldToActivation(message, desc->field(i), arena,
+                                        activation, options);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  return absl::OkStatus();
+}
+
+absl::StatusOr<ProtoFieldBindingPlan> ProtoFieldBindingPlan::Create(
+    const Descriptor* descriptor,
+    const google::api::expr::v1alpha1::CheckedExpr& checked_expr) {
+  if (descriptor == nullptr) {
+    return absl::InvalidArgumentError(
+        "descriptor must not be null for ProtoFieldBindingPlan.");
+  }
+
+  std::vector<const FieldDescriptor*> fields;
+  for (const auto& entry : checked_expr.reference_map()) {
+    const auto& reference = entry.second;
+    if (!reference.overload_id().empty()) {
+      // Function reference.
+      continue;
+    }
+    // Only the root segment of a qualified reference can name a bound field.
+    absl::string_view name = reference.name();
+    name = name.substr(0, name.find('.'));
+    const FieldDescriptor* field_desc =
+        descriptor->FindFieldByName(std::string(name));
+    if (field_desc != nullptr) {
+      fields.push_back(field_desc);
     }
+  }
+
+  // Field number order, so binding touches the message sequentially.
+  std::sort(fields.begin(), fields.end(),
+            [](const FieldDescriptor* lhs, const FieldDescriptor* rhs) {
+              return lhs->number() < rhs->number();
+            });
+  fields.erase(std::unique(fields.begin(), fields.end()), fields.end());
+
+  return ProtoFieldBindingPlan(descriptor, std::move(fields));
+}
 
-    auto status = CreateValueFromField(message, field_desc, arena, &value);
+absl::Status ProtoFieldBindingPlan::BindProtoToActivation(
+    const Message* message, Arena* arena, Activation* activation,
+    ProtoUnsetFieldOptions options) const {
+  if (arena == nullptr) {
+    return absl::InvalidArgumentError(
+        "arena must not be null for BindProtoToActivation.");
+  }
+  if (message->GetDescriptor() != descriptor_) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("message of type '", message->GetDescriptor()->full_name(),
+                     "' does not match binding plan for '",
+                     descriptor_->full_name(), "'."));
+  }
+
+  for (const FieldDescriptor* field_desc : fields_) {
+    auto status =
+        BindFieldToActivation(message, field_desc, arena, activation, options);
     if (!status.ok()) {
       return status;
     }
-
-    activation->InsertValue(field_desc->name(), value);
   }
 
   return absl::OkStatus();
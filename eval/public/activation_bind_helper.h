@@ -1,7 +1,13 @@
 #ifndef THIRD_PARTY_CEL_CPP_EVAL_PUBLIC_ACTIVATION_BIND_HELPER_H_
 #define THIRD_PARTY_CEL_CPP_EVAL_PUBLIC_ACTIVATION_BIND_HELPER_H_
 
+#include <utility>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/checked.pb.h"
+#include "absl/status/statusor.h"
 #include "eval/public/activation.h"
+#include "google/protobuf/descriptor.h"
 
 namespace google {
 namespace api {
@@ -52,6 +58,61 @@ absl::Status BindProtoToActivation(
     Activation* activation,
     ProtoUnsetFieldOptions options = ProtoUnsetFieldOptions::kSkip);
 
+// Precomputed variant of BindProtoToActivation for checked expressions.
+//
+// BindProtoToActivation walks every field of the message on every call, even
+// though a given expression typically reads only a few of them. Create()
+// consults the checked expression's reference map once to determine which
+// top-level fields the program can actually resolve, so repeated binds of
+// messages of the same type perform a single reflection pass over exactly
+// those fields, in field number order.
+//
+// The plan holds field descriptors, so it must not outlive the descriptor
+// pool that produced |descriptor|. Binding a message of a different
+// descriptor is an error.
+//
+// Example, reusing one plan across many evaluations:
+//
+//   CEL_ASSIGN_OR_RETURN(auto plan, ProtoFieldBindingPlan::Create(
+//       Person::descriptor(), checked_expr));
+//   for (const Person& person : persons) {
+//     Activation activation;
+//     CEL_RETURN_IF_ERROR(
+//         plan.BindProtoToActivation(&person, &arena, &activation));
+//     // ... evaluate ...
+//   }
+class ProtoFieldBindingPlan {
+ public:
+  // Computes the referenced fields of |descriptor| from the reference map of
+  // |checked_expr|. References that do not name a field of the message (e.g.
+  // function references or variables bound elsewhere) are ignored.
+  static absl::StatusOr<ProtoFieldBindingPlan> Create(
+      const google::protobuf::Descriptor* descriptor,
+      const google::api::expr::v1alpha1::CheckedExpr& checked_expr);
+
+  // Binds the planned fields of |message| to |activation|, with the same
+  // per-field semantics as BindProtoToActivation. |message| must be of the
+  // descriptor the plan was created for and |arena| must be non-null.
+  absl::Status BindProtoToActivation(
+      const google::protobuf::Message* message, google::protobuf::Arena* arena,
+      Activation* activation,
+      ProtoUnsetFieldOptions options = ProtoUnsetFieldOptions::kSkip) const;
+
+  // The fields the plan binds, ordered by field number.
+  const std::vector<const google::protobuf::FieldDescriptor*>& fields() const {
+    return fields_;
+  }
+
+ private:
+  ProtoFieldBindingPlan(
+      const google::protobuf::Descriptor* descriptor,
+      std::vector<const google::protobuf::FieldDescriptor*> fields)
+      : descriptor_(descriptor), fields_(std::move(fields)) {}
+
+  const google::protobuf::Descriptor* descriptor_;
+  std::vector<const google::protobuf::FieldDescriptor*> fields_;
+};
+
 }  // namespace runtime
 }  // namespace expr
 }  // namespace api
@@ -1,5 +1,6 @@
 #include "eval/public/activation_bind_helper.h"
 
+#include "google/api/expr/v1alpha1/checked.pb.h"
 #include "absl/status/status.h"
 #include "eval/public/activation.h"
 #include "eval/testutil/test_message.pb.h"
@@ -138,6 +139,71 @@ TEST(ActivationBindHelperTest, RejectsNullArena) {
                 "arena must not be null for BindProtoToActivation."));
 }
 
+TEST(ActivationBindHelperTest, BindingPlanBindsOnlyReferencedFields) {
+  google::api::expr::v1alpha1::CheckedExpr checked_expr;
+  (*checked_expr.mutable_reference_map())[1].set_name("int32_value");
+  // Function references do not name fields and are ignored.
+  auto& function_reference = (*checked_expr.mutable_reference_map())[2];
+  function_reference.set_name("size");
+  function_reference.add_overload_id("size_string");
+
+  ASSERT_OK_AND_ASSIGN(
+      auto plan,
+      ProtoFieldBindingPlan::Create(TestMessage::descriptor(), checked_expr));
+
+  TestMessage message;
+  message.set_int32_value(42);
+  message.set_bool_value(true);
+
+  google::protobuf::Arena arena;
+
+  Activation activation;
+
+  ASSERT_OK(plan.BindProtoToActivation(&message, &arena, &activation));
+
+  auto result = activation.FindValue("int32_value", &arena);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->Int64OrDie(), 42);
+
+  EXPECT_FALSE(activation.FindValue("bool_value", &arena).has_value());
+}
+
+TEST(ActivationBindHelperTest, BindingPlanOrdersFieldsByNumber) {
+  google::api::expr::v1alpha1::CheckedExpr checked_expr;
+  (*checked_expr.mutable_reference_map())[1].set_name("bool_value");
+  (*checked_expr.mutable_reference_map())[2].set_name("int32_value");
+  // Qualified references resolve through their root segment; duplicates of a
+  // root collapse to one field.
+  (*checked_expr.mutable_reference_map())[3].set_name(
+      "message_value.int32_value");
+  (*checked_expr.mutable_reference_map())[4].set_name("message_value");
+
+  ASSERT_OK_AND_ASSIGN(
+      auto plan,
+      ProtoFieldBindingPlan::Create(TestMessage::descriptor(), checked_expr));
+
+  ASSERT_EQ(plan.fields().size(), 3);
+  EXPECT_EQ(plan.fields()[0]->name(), "int32_value");
+  EXPECT_EQ(plan.fields()[1]->name(), "bool_value");
+  EXPECT_EQ(plan.fields()[2]->name(), "message_value");
+}
+
+TEST(ActivationBindHelperTest, BindingPlanRejectsMismatchedMessage) {
+  google::api::expr::v1alpha1::CheckedExpr checked_expr;
+  (*checked_expr.mutable_reference_map())[1].set_name("int32_value");
+
+  ASSERT_OK_AND_ASSIGN(
+      auto plan,
+      ProtoFieldBindingPlan::Create(TestMessage::descriptor(), checked_expr));
+
+  google::protobuf::Arena arena;
+
+  Activation activation;
+
+  EXPECT_FALSE(plan.BindProtoToActivation(&checked_expr, &arena, &activation)
+                   .ok());
+}
+
 }  // namespace
 
 }  // namespace runtime
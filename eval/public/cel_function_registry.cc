@@ -83,20 +83,63 @@ absl::Status CelFunctionRegistry::RegisterAll(
   return absl::OkStatus();
 }
 
+void CelFunctionRegistry::Freeze() {
+  if (frozen_) {
+    return;
+  }
+  modern_registry_.Finalize();
+
+  // Adopt any wrappers already created on demand so pointers handed out
+  // before freezing remain the ones returned afterwards.
+  {
+    absl::MutexLock lock(&mu_);
+    frozen_functions_ = std::move(functions_);
+    functions_.clear();
+  }
+
+  for (const auto& [name, descriptors] : modern_registry_.ListFunctions()) {
+    for (const cel::FunctionDescriptor* descriptor : descriptors) {
+      for (cel::FunctionOverloadReference overload :
+           modern_registry_.FindStaticOverloads(
+               name, descriptor->receiver_style(), descriptor->types())) {
+        std::unique_ptr<CelFunction>& legacy_impl =
+            frozen_functions_[&overload.implementation];
+        if (legacy_impl == nullptr) {
+          legacy_impl = std::make_unique<ProxyToModernCelFunction>(
+              overload.descriptor, overload.implementation);
+        }
+      }
+    }
+  }
+  frozen_ = true;
+}
+
 std::vector<const CelFunction*> CelFunctionRegistry::FindOverloads(
     absl::string_view name, bool receiver_style,
     const std::vector<CelValue::Type>& types) const {
   std::vector<cel::FunctionOverloadReference> matched_funcs =
       modern_registry_.FindStaticOverloads(name, receiver_style, types);
 
+  std::vector<const CelFunction*> results;
+  results.reserve(matched_funcs.size());
+
+  if (frozen_) {
+    // The wrapper table is complete and immutable once frozen: serve lookups
+    // without synchronization.
+    for (cel::FunctionOverloadReference entry : matched_funcs) {
+      auto it = frozen_functions_.find(&entry.implementation);
+      if (it != frozen_functions_.end()) {
+        results.push_back(it->second.get());
+      }
+    }
+    return results;
+  }
+
   // For backwards compatibility, lazily initialize a legacy CEL function
   // if required.
   // The registry should remain add-only until migration to the new type is
   // complete, so this should work whether the function was introduced via
   // the modern registry or the old registry wrapping a modern instance.
-  std::vector<const CelFunction*> results;
-  results.reserve(matched_funcs.size());
-
   {
     absl::MutexLock lock(&mu_);
     for (cel::FunctionOverloadReference entry : matched_funcs) {
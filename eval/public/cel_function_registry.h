@@ -58,6 +58,16 @@ class CelFunctionRegistry {
   absl::Status RegisterAll(std::initializer_list<Registrar> registrars,
                            const InterpreterOptions& opts);
 
+  // Freezes the registry once registration is complete.
+  //
+  // Finalizes the backing modern registry (further registration fails with
+  // FAILED_PRECONDITION) and eagerly materializes the legacy CelFunction
+  // wrappers that FindOverloads otherwise creates on demand under a mutex, so
+  // subsequent lookups read immutable storage without synchronization.
+  // Wrappers handed out before freezing stay valid and continue to be
+  // returned. Idempotent; must not race with concurrent lookups.
+  void Freeze();
+
   // Register a lazily provided function. This overload uses a default provider
   // that delegates to the activation at evaluation time.
   absl::Status RegisterLazyFunction(const CelFunctionDescriptor& descriptor) {
@@ -139,6 +149,12 @@ class CelFunctionRegistry {
   mutable absl::flat_hash_map<const cel::Function*,
                               std::unique_ptr<CelFunction>>
       functions_ ABSL_GUARDED_BY(mu_);
+
+  // Wrapper table precomputed by Freeze. Immutable afterwards, so lookups
+  // read it without taking `mu_`.
+  bool frozen_ = false;
+  absl::flat_hash_map<const cel::Function*, std::unique_ptr<CelFunction>>
+      frozen_functions_;
 };
 
 }  // namespace google::api::expr::runtime
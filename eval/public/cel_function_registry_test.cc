@@ -86,6 +86,34 @@ TEST(CelFunctionRegistryTest, FindStaticOverloadsReturns) {
       << "Expected single ConstFunction()";
 }
 
+TEST(CelFunctionRegistryTest, FreezeServesPrecomputedWrappers) {
+  CelFunctionRegistry registry;
+  CelFunctionDescriptor desc = ConstCelFunction::MakeDescriptor();
+  ASSERT_OK(registry.Register(desc, std::make_unique<ConstCelFunction>(desc)));
+
+  // Wrappers created before freezing keep their identity afterwards.
+  std::vector<const CelFunction*> before =
+      registry.FindOverloads("ConstFunction", false, {});
+  ASSERT_THAT(before, SizeIs(1));
+
+  registry.Freeze();
+
+  std::vector<const CelFunction*> after =
+      registry.FindOverloads("ConstFunction", false, {});
+  ASSERT_THAT(after, SizeIs(1));
+  EXPECT_EQ(after[0], before[0]);
+  EXPECT_EQ(after[0]->descriptor().name(), "ConstFunction");
+}
+
+TEST(CelFunctionRegistryTest, FreezeRejectsLateRegistration) {
+  CelFunctionRegistry registry;
+  registry.Freeze();
+
+  CelFunctionDescriptor desc = ConstCelFunction::MakeDescriptor();
+  EXPECT_THAT(registry.Register(desc, std::make_unique<ConstCelFunction>(desc)),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
 TEST(CelFunctionRegistryTest, ListFunctions) {
   CelFunctionDescriptor lazy_function_desc{"LazyFunction", false, {}};
   CelFunctionRegistry registry;
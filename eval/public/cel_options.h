@@ -17,6 +17,8 @@
 #ifndef THIRD_PARTY_CEL_CPP_EVAL_PUBLIC_CEL_OPTIONS_H_
 #define THIRD_PARTY_CEL_CPP_EVAL_PUBLIC_CEL_OPTIONS_H_
 
+#include <cstdint>
+
 #include "absl/base/attributes.h"
 #include "runtime/runtime_options.h"
 #include "google/protobuf/arena.h"
@@ -180,8 +182,12 @@ struct InterpreterOptions {
 
   // Enable tracing support for recursively planned programs.
   //
-  // Unlike the stack machine implementation, supporting tracing can affect
-  // performance whether or not tracing is requested for a given evaluation.
+  // Unlike the stack machine implementation, supporting tracing wraps each
+  // planned subexpression in a trace decorator, so it slightly grows the plan
+  // and adds a predicted branch per node whether or not tracing is requested
+  // for a given evaluation. Whether the listener is invoked is decided once
+  // per evaluation, so a single plan built with this option serves both
+  // traced and untraced evaluations.
   bool enable_recursive_tracing = false;
 
   // Use legacy containers for lists and maps when possible.
@@ -192,6 +198,12 @@ struct InterpreterOptions {
   //
   // Default is true for the legacy options type.
   bool use_legacy_container_builders = true;
+
+  // Set maximum total evaluation cost per evaluation. Each dispatched
+  // execution step charges its relative cost against the budget, and
+  // evaluation aborts with a kResourceExhausted error once it is exhausted.
+  // Use value 0 to disable the budget.
+  int64_t evaluation_cost_budget = 0;
 };
 // LINT.ThenChange(//depot/google3/runtime/runtime_options.h)
 
@@ -551,6 +551,16 @@ class CelList {
   // Default empty check. Can be overridden in subclass for performance.
   virtual bool empty() const { return size() == 0; }
 
+  // Optional membership fast path for the @in operator. Implementations
+  // backed by typed storage may answer directly without materializing each
+  // element as a CelValue. Returning nullopt (the default) falls back to
+  // elementwise heterogeneous equality; an override must preserve those
+  // semantics when it does answer.
+  virtual absl::optional<bool> ContainsValue(const CelValue& value) const {
+    static_cast<void>(value);
+    return absl::nullopt;
+  }
+
   virtual ~CelList() {}
 
  private:
@@ -14,11 +14,46 @@
 
 #include "eval/public/containers/internal_field_backed_list_impl.h"
 
+#include <cstdint>
+
+#include "absl/types/optional.h"
+#include "eval/public/cel_number.h"
 #include "eval/public/cel_value.h"
 #include "eval/public/structs/field_access_impl.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/reflection.h"
 
 namespace google::api::expr::runtime::internal {
 
+namespace {
+
+// Scans the typed backing storage of a scalar repeated field for an element
+// numerically equal to `value`. `to_number` lifts an element into the
+// numeric comparison domain shared with heterogeneous equality, so the scan
+// returns the same answer the generic elementwise path would.
+template <typename T, typename ToNumber>
+absl::optional<bool> ScanRepeatedField(
+    const google::protobuf::Reflection* reflection,
+    const google::protobuf::Message* message,
+    const google::protobuf::FieldDescriptor* descriptor, const CelValue& value,
+    ToNumber to_number) {
+  absl::optional<CelNumber> probe = GetNumberFromCelValue(value);
+  if (!probe.has_value()) {
+    // Equality between a non-numeric value and numeric elements is
+    // undefined, which membership treats as false.
+    return false;
+  }
+  for (T element : reflection->GetRepeatedFieldRef<T>(*message, descriptor)) {
+    if (to_number(element) == *probe) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
 int FieldBackedListImpl::size() const {
   return reflection_->FieldSize(*message_, descriptor_);
 }
@@ -33,4 +68,53 @@ CelValue FieldBackedListImpl::operator[](int index) const {
   return *result;
 }
 
+absl::optional<bool> FieldBackedListImpl::ContainsValue(
+    const CelValue& value) const {
+  using google::protobuf::FieldDescriptor;
+  switch (descriptor_->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_BOOL: {
+      bool probe;
+      if (!value.GetValue(&probe)) {
+        // Equality between bool and any other type is undefined, which
+        // membership treats as false.
+        return false;
+      }
+      for (bool element :
+           reflection_->GetRepeatedFieldRef<bool>(*message_, descriptor_)) {
+        if (element == probe) {
+          return true;
+        }
+      }
+      return false;
+    }
+    case FieldDescriptor::CPPTYPE_INT32:
+      return ScanRepeatedField<int32_t>(
+          reflection_, message_, descriptor_, value,
+          [](int32_t element) { return CelNumber::FromInt64(element); });
+    case FieldDescriptor::CPPTYPE_INT64:
+      return ScanRepeatedField<int64_t>(
+          reflection_, message_, descriptor_, value,
+          [](int64_t element) { return CelNumber::FromInt64(element); });
+    case FieldDescriptor::CPPTYPE_UINT32:
+      return ScanRepeatedField<uint32_t>(
+          reflection_, message_, descriptor_, value,
+          [](uint32_t element) { return CelNumber::FromUint64(element); });
+    case FieldDescriptor::CPPTYPE_UINT64:
+      return ScanRepeatedField<uint64_t>(
+          reflection_, message_, descriptor_, value,
+          [](uint64_t element) { return CelNumber::FromUint64(element); });
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      return ScanRepeatedField<float>(
+          reflection_, message_, descriptor_, value,
+          [](float element) { return CelNumber::FromDouble(element); });
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      return ScanRepeatedField<double>(
+          reflection_, message_, descriptor_, value,
+          [](double element) { return CelNumber::FromDouble(element); });
+    default:
+      // Strings, enums and messages keep the generic elementwise path.
+      return absl::nullopt;
+  }
+}
+
 }  // namespace google::api::expr::runtime::internal
@@ -17,6 +17,7 @@
 
 #include <utility>
 
+#include "absl/types/optional.h"
 #include "eval/public/cel_value.h"
 #include "eval/public/structs/protobuf_value_factory.h"
 
@@ -46,6 +47,11 @@ class FieldBackedListImpl : public CelList {
   // List element access operator.
   CelValue operator[](int index) const override;
 
+  // Membership fast path: scalar repeated fields are scanned directly over
+  // the typed backing storage instead of materializing each element as a
+  // CelValue. Other field types fall back to the generic elementwise path.
+  absl::optional<bool> ContainsValue(const CelValue& value) const override;
+
  private:
   const google::protobuf::Message* message_;
   const google::protobuf::FieldDescriptor* descriptor_;
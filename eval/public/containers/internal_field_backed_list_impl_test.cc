@@ -249,5 +249,58 @@ TEST(FieldBackedListImplTest, EnumDatatypeTest) {
   EXPECT_THAT((*cel_list)[1].Int64OrDie(), Eq(TestMessage::TEST_ENUM_2));
 }
 
+TEST(FieldBackedListImplTest, ContainsValueInt64Test) {
+  TestMessage message;
+  message.add_int64_list(1);
+  message.add_int64_list(2);
+
+  google::protobuf::Arena arena;
+
+  auto cel_list = CreateList(&message, "int64_list", &arena);
+
+  EXPECT_THAT(cel_list->ContainsValue(CelValue::CreateInt64(2)),
+              testing::Optional(true));
+  EXPECT_THAT(cel_list->ContainsValue(CelValue::CreateInt64(3)),
+              testing::Optional(false));
+  // Heterogeneous numeric equality applies.
+  EXPECT_THAT(cel_list->ContainsValue(CelValue::CreateDouble(2.0)),
+              testing::Optional(true));
+  EXPECT_THAT(cel_list->ContainsValue(CelValue::CreateUint64(1)),
+              testing::Optional(true));
+  EXPECT_THAT(cel_list->ContainsValue(CelValue::CreateDouble(2.5)),
+              testing::Optional(false));
+  // Equality with a non-numeric probe is undefined, so membership is false.
+  EXPECT_THAT(cel_list->ContainsValue(CelValue::CreateBool(true)),
+              testing::Optional(false));
+}
+
+TEST(FieldBackedListImplTest, ContainsValueBoolTest) {
+  TestMessage message;
+  message.add_bool_list(true);
+
+  google::protobuf::Arena arena;
+
+  auto cel_list = CreateList(&message, "bool_list", &arena);
+
+  EXPECT_THAT(cel_list->ContainsValue(CelValue::CreateBool(true)),
+              testing::Optional(true));
+  EXPECT_THAT(cel_list->ContainsValue(CelValue::CreateBool(false)),
+              testing::Optional(false));
+  EXPECT_THAT(cel_list->ContainsValue(CelValue::CreateInt64(1)),
+              testing::Optional(false));
+}
+
+TEST(FieldBackedListImplTest, ContainsValueFallsBackForStringsTest) {
+  TestMessage message;
+  message.add_string_list("a");
+
+  google::protobuf::Arena arena;
+
+  auto cel_list = CreateList(&message, "string_list", &arena);
+
+  EXPECT_EQ(cel_list->ContainsValue(CelValue::CreateStringView("a")),
+            absl::nullopt);
+}
+
 }  // namespace
 }  // namespace google::api::expr::runtime::internal
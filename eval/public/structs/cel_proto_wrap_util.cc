@@ -16,6 +16,7 @@
 
 #include <math.h>
 
+#include <array>
 #include <cstdint>
 #include <limits>
 #include <memory>
@@ -490,7 +491,14 @@ class ValueManager {
   }
 
   CelValue ValueFromMessage(const BytesValue* wrapper) {
-    // BytesValue stores value as Cord
+    // BytesValue stores value as Cord. When the cord is flat the result can
+    // alias the wrapper message, which the caller already guarantees outlives
+    // the evaluation (the same contract as string field access); otherwise
+    // fall back to a contiguous copy on the arena.
+    if (absl::optional<absl::string_view> flat = wrapper->value().TryFlat();
+        flat.has_value()) {
+      return CelValue::CreateBytesView(*flat);
+    }
     return CelValue::CreateBytes(
         Arena::Create<std::string>(arena_, std::string(wrapper->value())));
   }
@@ -602,41 +610,52 @@ class ValueFromMessageMaker {
   static absl::optional<CelValue> CreateValue(
       const google::protobuf::Message* message, const ProtobufValueFactory& factory,
       Arena* arena) {
-    switch (message->GetDescriptor()->well_known_type()) {
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_DOUBLEVALUE:
-        return CreateWellknownTypeValue<DoubleValue>(message, factory, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_FLOATVALUE:
-        return CreateWellknownTypeValue<FloatValue>(message, factory, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_INT64VALUE:
-        return CreateWellknownTypeValue<Int64Value>(message, factory, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_UINT64VALUE:
-        return CreateWellknownTypeValue<UInt64Value>(message, factory, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_INT32VALUE:
-        return CreateWellknownTypeValue<Int32Value>(message, factory, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_UINT32VALUE:
-        return CreateWellknownTypeValue<UInt32Value>(message, factory, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_STRINGVALUE:
-        return CreateWellknownTypeValue<StringValue>(message, factory, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_BYTESVALUE:
-        return CreateWellknownTypeValue<BytesValue>(message, factory, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_BOOLVALUE:
-        return CreateWellknownTypeValue<BoolValue>(message, factory, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_ANY:
-        return CreateWellknownTypeValue<Any>(message, factory, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_DURATION:
-        return CreateWellknownTypeValue<Duration>(message, factory, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_TIMESTAMP:
-        return CreateWellknownTypeValue<Timestamp>(message, factory, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_VALUE:
-        return CreateWellknownTypeValue<Value>(message, factory, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_LISTVALUE:
-        return CreateWellknownTypeValue<ListValue>(message, factory, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_STRUCT:
-        return CreateWellknownTypeValue<Struct>(message, factory, arena);
-      // WELLKNOWNTYPE_FIELDMASK has no special CelValue type
-      default:
-        return absl::nullopt;
+    // Compile-time table keyed by the descriptor's well-known-type
+    // classification (computed once per descriptor by protobuf), mapping to
+    // monomorphic converters. Entries without a special CelValue type
+    // (including WELLKNOWNTYPE_FIELDMASK) stay null.
+    using WellKnownConverter = CelValue (*)(const google::protobuf::Message*,
+                                            const ProtobufValueFactory&, Arena*);
+    static constexpr std::array<WellKnownConverter, 32> kConverters = [] {
+      std::array<WellKnownConverter, 32> table{};
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_DOUBLEVALUE] =
+          &CreateWellknownTypeValue<DoubleValue>;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_FLOATVALUE] =
+          &CreateWellknownTypeValue<FloatValue>;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_INT64VALUE] =
+          &CreateWellknownTypeValue<Int64Value>;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_UINT64VALUE] =
+          &CreateWellknownTypeValue<UInt64Value>;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_INT32VALUE] =
+          &CreateWellknownTypeValue<Int32Value>;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_UINT32VALUE] =
+          &CreateWellknownTypeValue<UInt32Value>;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_STRINGVALUE] =
+          &CreateWellknownTypeValue<StringValue>;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_BYTESVALUE] =
+          &CreateWellknownTypeValue<BytesValue>;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_BOOLVALUE] =
+          &CreateWellknownTypeValue<BoolValue>;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_ANY] =
+          &CreateWellknownTypeValue<Any>;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_DURATION] =
+          &CreateWellknownTypeValue<Duration>;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_TIMESTAMP] =
+          &CreateWellknownTypeValue<Timestamp>;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_VALUE] =
+          &CreateWellknownTypeValue<Value>;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_LISTVALUE] =
+          &CreateWellknownTypeValue<ListValue>;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_STRUCT] =
+          &CreateWellknownTypeValue<Struct>;
+      return table;
+    }();
+    const auto wkt = message->GetDescriptor()->well_known_type();
+    if (static_cast<size_t>(wkt) >= kConverters.size() ||
+        kConverters[wkt] == nullptr) {
+      return absl::nullopt;
     }
+    return kConverters[wkt](message, factory, arena);
   }
 
   // Non-copyable, non-assignable
@@ -1385,88 +1404,53 @@ class MessageFromValueMaker {
                                            google::protobuf::MessageFactory* factory,
                                            const CelValue& value,
                                            Arena* arena) {
-    switch (descriptor->well_known_type()) {
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_DOUBLEVALUE:
-        if (IsAlreadyWrapped(descriptor->well_known_type(), value)) {
-          return nullptr;
-        }
-        return DoubleFromValue(factory->GetPrototype(descriptor), value, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_FLOATVALUE:
-        if (IsAlreadyWrapped(descriptor->well_known_type(), value)) {
-          return nullptr;
-        }
-        return FloatFromValue(factory->GetPrototype(descriptor), value, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_INT64VALUE:
-        if (IsAlreadyWrapped(descriptor->well_known_type(), value)) {
-          return nullptr;
-        }
-        return Int64FromValue(factory->GetPrototype(descriptor), value, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_UINT64VALUE:
-        if (IsAlreadyWrapped(descriptor->well_known_type(), value)) {
-          return nullptr;
-        }
-        return UInt64FromValue(factory->GetPrototype(descriptor), value, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_INT32VALUE:
-        if (IsAlreadyWrapped(descriptor->well_known_type(), value)) {
-          return nullptr;
-        }
-        return Int32FromValue(factory->GetPrototype(descriptor), value, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_UINT32VALUE:
-        if (IsAlreadyWrapped(descriptor->well_known_type(), value)) {
-          return nullptr;
-        }
-        return UInt32FromValue(factory->GetPrototype(descriptor), value, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_STRINGVALUE:
-        if (IsAlreadyWrapped(descriptor->well_known_type(), value)) {
-          return nullptr;
-        }
-        return StringFromValue(factory->GetPrototype(descriptor), value, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_BYTESVALUE:
-        if (IsAlreadyWrapped(descriptor->well_known_type(), value)) {
-          return nullptr;
-        }
-        return BytesFromValue(factory->GetPrototype(descriptor), value, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_BOOLVALUE:
-        if (IsAlreadyWrapped(descriptor->well_known_type(), value)) {
-          return nullptr;
-        }
-        return BoolFromValue(factory->GetPrototype(descriptor), value, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_ANY:
-        if (IsAlreadyWrapped(descriptor->well_known_type(), value)) {
-          return nullptr;
-        }
-        return AnyFromValue(factory->GetPrototype(descriptor), value, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_DURATION:
-        if (IsAlreadyWrapped(descriptor->well_known_type(), value)) {
-          return nullptr;
-        }
-        return DurationFromValue(factory->GetPrototype(descriptor), value,
-                                 arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_TIMESTAMP:
-        if (IsAlreadyWrapped(descriptor->well_known_type(), value)) {
-          return nullptr;
-        }
-        return TimestampFromValue(factory->GetPrototype(descriptor), value,
-                                  arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_VALUE:
-        if (IsAlreadyWrapped(descriptor->well_known_type(), value)) {
-          return nullptr;
-        }
-        return ValueFromValue(factory->GetPrototype(descriptor), value, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_LISTVALUE:
-        if (IsAlreadyWrapped(descriptor->well_known_type(), value)) {
-          return nullptr;
-        }
-        return ListFromValue(factory->GetPrototype(descriptor), value, arena);
-      case google::protobuf::Descriptor::WELLKNOWNTYPE_STRUCT:
-        if (IsAlreadyWrapped(descriptor->well_known_type(), value)) {
-          return nullptr;
-        }
-        return StructFromValue(factory->GetPrototype(descriptor), value, arena);
-      // WELLKNOWNTYPE_FIELDMASK has no special CelValue type
-      default:
-        return nullptr;
+    // Compile-time table keyed by the descriptor's well-known-type
+    // classification; mirrors ValueFromMessageMaker::CreateValue.
+    // WELLKNOWNTYPE_FIELDMASK has no special CelValue type.
+    using WrapConverter = google::protobuf::Message* (*)(const google::protobuf::Message*,
+                                               const CelValue&, Arena*);
+    static constexpr std::array<WrapConverter, 32> kConverters = [] {
+      std::array<WrapConverter, 32> table{};
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_DOUBLEVALUE] =
+          &DoubleFromValue;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_FLOATVALUE] =
+          &FloatFromValue;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_INT64VALUE] =
+          &Int64FromValue;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_UINT64VALUE] =
+          &UInt64FromValue;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_INT32VALUE] =
+          &Int32FromValue;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_UINT32VALUE] =
+          &UInt32FromValue;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_STRINGVALUE] =
+          &StringFromValue;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_BYTESVALUE] =
+          &BytesFromValue;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_BOOLVALUE] =
+          &BoolFromValue;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_ANY] = &AnyFromValue;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_DURATION] =
+          &DurationFromValue;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_TIMESTAMP] =
+          &TimestampFromValue;
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_VALUE] =
+          static_cast<WrapConverter>(&ValueFromValue);
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_LISTVALUE] =
+          static_cast<WrapConverter>(&ListFromValue);
+      table[google::protobuf::Descriptor::WELLKNOWNTYPE_STRUCT] =
+          static_cast<WrapConverter>(&StructFromValue);
+      return table;
+    }();
+    const auto wkt = descriptor->well_known_type();
+    if (static_cast<size_t>(wkt) >= kConverters.size() ||
+        kConverters[wkt] == nullptr) {
+      return nullptr;
+    }
+    if (IsAlreadyWrapped(wkt, value)) {
+      return nullptr;
     }
+    return kConverters[wkt](factory->GetPrototype(descriptor), value, arena);
   }
 };
 
@@ -0,0 +1,36 @@
+#include "eval/public/structs/lazy_proto_value_producer.h"
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "eval/public/cel_value.h"
+#include "eval/public/structs/cel_proto_wrapper.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/message.h"
+
+namespace google::api::expr::runtime {
+
+CelValue LazyProtoValueProducer::Produce(google::protobuf::Arena* arena) {
+  google::protobuf::MessageFactory* factory = factory_;
+  if (factory == nullptr) {
+    factory = google::protobuf::MessageFactory::generated_factory();
+  }
+  const google::protobuf::Message* prototype = factory->GetPrototype(descriptor_);
+  if (prototype == nullptr) {
+    return CreateErrorValue(
+        arena,
+        absl::StrCat("could not create prototype for message type: ",
+                     descriptor_->full_name()),
+        absl::StatusCode::kInvalidArgument);
+  }
+  google::protobuf::Message* message = prototype->New(arena);
+  if (!message->ParseFromCord(serialized_)) {
+    return CreateErrorValue(
+        arena,
+        absl::StrCat("failed to parse serialized message of type: ",
+                     descriptor_->full_name()),
+        absl::StatusCode::kInvalidArgument);
+  }
+  return CelProtoWrapper::CreateMessage(message, arena);
+}
+
+}  // namespace google::api::expr::runtime
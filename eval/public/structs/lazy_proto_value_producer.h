@@ -0,0 +1,47 @@
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_PUBLIC_STRUCTS_LAZY_PROTO_VALUE_PRODUCER_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_PUBLIC_STRUCTS_LAZY_PROTO_VALUE_PRODUCER_H_
+
+#include "absl/strings/cord.h"
+#include "eval/public/cel_value.h"
+#include "eval/public/cel_value_producer.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace google::api::expr::runtime {
+
+// CelValueProducer that defers deserializing a protobuf message until the
+// bound variable is first read by an evaluation.
+//
+// Many callers bind messages that a given expression never touches; parsing
+// them up front is wasted work on the ingest path. Binding this producer via
+// Activation::InsertValueProducer keeps the serialized bytes around instead,
+// and the Activation's value cache guarantees the parse happens at most once
+// per activation (ClearCachedValues resets this).
+//
+// The descriptor and factory must outlive the producer. If `factory` is
+// null, the generated message factory is used; pass a DynamicMessageFactory
+// to bind messages known only through a runtime descriptor pool.
+//
+// If the payload fails to parse, reads of the variable yield a CelError
+// rather than failing at bind time.
+class LazyProtoValueProducer : public CelValueProducer {
+ public:
+  LazyProtoValueProducer(absl::Cord serialized,
+                         const google::protobuf::Descriptor* descriptor,
+                         google::protobuf::MessageFactory* factory = nullptr)
+      : serialized_(std::move(serialized)),
+        descriptor_(descriptor),
+        factory_(factory) {}
+
+  CelValue Produce(google::protobuf::Arena* arena) override;
+
+ private:
+  absl::Cord serialized_;
+  const google::protobuf::Descriptor* descriptor_;
+  google::protobuf::MessageFactory* factory_;
+};
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_PUBLIC_STRUCTS_LAZY_PROTO_VALUE_PRODUCER_H_
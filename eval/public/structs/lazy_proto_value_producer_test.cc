@@ -0,0 +1,49 @@
+#include "eval/public/structs/lazy_proto_value_producer.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/strings/cord.h"
+#include "eval/public/activation.h"
+#include "eval/public/cel_value.h"
+#include "eval/testutil/test_message.pb.h"
+#include "internal/testing.h"
+#include "testutil/util.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+TEST(LazyProtoValueProducerTest, ParsesOnFirstAccess) {
+  TestMessage message;
+  message.set_int64_value(12);
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  activation.InsertValueProducer(
+      "msg", std::make_unique<LazyProtoValueProducer>(
+                 absl::Cord(message.SerializeAsString()),
+                 TestMessage::descriptor()));
+
+  auto value = activation.FindValue("msg", &arena);
+  ASSERT_TRUE(value.has_value());
+  ASSERT_TRUE(value->IsMessage());
+  EXPECT_THAT(value->MessageOrDie(), testutil::EqualsProto(message));
+}
+
+TEST(LazyProtoValueProducerTest, MalformedPayloadYieldsError) {
+  google::protobuf::Arena arena;
+  Activation activation;
+  activation.InsertValueProducer(
+      "msg", std::make_unique<LazyProtoValueProducer>(
+                 absl::Cord("not a serialized message"),
+                 TestMessage::descriptor()));
+
+  auto value = activation.FindValue("msg", &arena);
+  ASSERT_TRUE(value.has_value());
+  EXPECT_TRUE(value->IsError());
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
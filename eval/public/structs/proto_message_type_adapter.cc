@@ -14,20 +14,25 @@
 
 #include "eval/public/structs/proto_message_type_adapter.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "google/protobuf/util/message_differencer.h"
 #include "absl/base/no_destructor.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/absl_check.h"
+#include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "base/attribute.h"
@@ -87,13 +92,319 @@ inline absl::StatusOr<google::protobuf::Message*> UnwrapMessage(
   return static_cast<google::protobuf::Message*>(value.message_ptr());
 }
 
+// Per-message-type field access table, compiled once from the descriptor.
+//
+// Looking up a field through the table skips the per-access
+// Descriptor::FindFieldByName and extension fallback, and classifies the
+// access strategy (map, repeated or singular) up front so the hot read and
+// write paths do not re-derive it from the descriptor. For map fields the
+// key and value fields of the synthetic entry message are resolved once as
+// well, so setting a map field does no descriptor lookups at all.
+// Descriptors are immortal in practice (owned by pools that outlive
+// evaluation), so tables are cached for the process lifetime keyed by
+// descriptor identity.
+class FieldAccessTable final {
+ public:
+  enum class Strategy { kMap, kRepeated, kSingular };
+
+  struct Entry {
+    const FieldDescriptor* field;
+    Strategy strategy;
+    // Key and value fields of the map entry message for map fields, nullptr
+    // otherwise.
+    const FieldDescriptor* map_key;
+    const FieldDescriptor* map_value;
+  };
+
+  static const FieldAccessTable& GetOrCreate(
+      const google::protobuf::Descriptor* descriptor) {
+    // A policy typically touches the same few message types 10-30 times per
+    // evaluation, so repeated lookups are resolved from a small thread-local
+    // memo without taking the shared-map mutex. Tables are never evicted, so
+    // the memoized pointers stay valid for the process lifetime.
+    struct Memo {
+      const google::protobuf::Descriptor* descriptor;
+      const FieldAccessTable* table;
+    };
+    static constexpr size_t kMemoSize = 4;
+    static thread_local Memo memo[kMemoSize] = {};
+    static thread_local size_t memo_next = 0;
+    for (const Memo& cached : memo) {
+      if (cached.descriptor == descriptor) {
+        return *cached.table;
+      }
+    }
+    const FieldAccessTable& table = GetOrCreateSlow(descriptor);
+    memo[memo_next] = {descriptor, &table};
+    memo_next = (memo_next + 1) % kMemoSize;
+    return table;
+  }
+
+  // Returns the entry for the field or nullptr if the message type does not
+  // define it. Extensions are resolved by the caller's reflection fallback.
+  const Entry* Find(absl::string_view field_name) const {
+    auto it = fields_.find(field_name);
+    if (it == fields_.end()) {
+      return nullptr;
+    }
+    return &it->second;
+  }
+
+  // Returns the entry for the field number or nullptr if the message type
+  // does not define it.
+  const Entry* FindByNumber(int64_t field_number) const {
+    auto it = fields_by_number_.find(field_number);
+    if (it == fields_by_number_.end()) {
+      return nullptr;
+    }
+    return &it->second;
+  }
+
+  // All fields in declaration order, for whole-message operations such as
+  // equality.
+  const std::vector<const FieldDescriptor*>& fields() const {
+    return ordered_fields_;
+  }
+
+  // True when field-by-field comparison over fields() is equivalent to
+  // MessageDifferencer::Equals for this message type: no map fields (which
+  // compare by key, not entry order), no Any fields (which compare by
+  // unpacked contents) and no extension ranges (extensions are not in
+  // fields()).
+  bool supports_compiled_equality() const {
+    return supports_compiled_equality_;
+  }
+
+ private:
+  static const FieldAccessTable& GetOrCreateSlow(
+      const google::protobuf::Descriptor* descriptor) {
+    static absl::NoDestructor<absl::Mutex> mu;
+    static absl::NoDestructor<absl::flat_hash_map<
+        const google::protobuf::Descriptor*, std::unique_ptr<FieldAccessTable>>>
+        tables;
+    {
+      absl::ReaderMutexLock lock(&*mu);
+      if (auto it = tables->find(descriptor); it != tables->end()) {
+        return *it->second;
+      }
+    }
+    auto table = absl::WrapUnique(new FieldAccessTable(descriptor));
+    absl::MutexLock lock(&*mu);
+    return *tables->try_emplace(descriptor, std::move(table)).first->second;
+  }
+
+  explicit FieldAccessTable(const google::protobuf::Descriptor* descriptor) {
+    constexpr int kKeyField = 1;
+    constexpr int kValueField = 2;
+    fields_.reserve(descriptor->field_count());
+    fields_by_number_.reserve(descriptor->field_count());
+    ordered_fields_.reserve(descriptor->field_count());
+    supports_compiled_equality_ = descriptor->extension_range_count() == 0;
+    for (int i = 0; i < descriptor->field_count(); ++i) {
+      const FieldDescriptor* field = descriptor->field(i);
+      Strategy strategy = field->is_map()        ? Strategy::kMap
+                          : field->is_repeated() ? Strategy::kRepeated
+                                                 : Strategy::kSingular;
+      if (strategy == Strategy::kMap ||
+          (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
+           field->message_type()->well_known_type() ==
+               google::protobuf::Descriptor::WELLKNOWNTYPE_ANY)) {
+        // Maps compare by key rather than entry order, and the differencer
+        // compares Any fields by their unpacked contents.
+        supports_compiled_equality_ = false;
+      }
+      const FieldDescriptor* map_key = nullptr;
+      const FieldDescriptor* map_value = nullptr;
+      if (strategy == Strategy::kMap) {
+        const google::protobuf::Descriptor* entry_descriptor =
+            field->message_type();
+        if (entry_descriptor != nullptr) {
+          map_key = entry_descriptor->FindFieldByNumber(kKeyField);
+          map_value = entry_descriptor->FindFieldByNumber(kValueField);
+        }
+      }
+      Entry entry{field, strategy, map_key, map_value};
+      // Keys alias the field names owned by the (immortal) descriptor.
+      fields_.try_emplace(absl::string_view(field->name()), entry);
+      fields_by_number_.try_emplace(field->number(), entry);
+      ordered_fields_.push_back(field);
+    }
+  }
+
+  absl::flat_hash_map<absl::string_view, Entry> fields_;
+  absl::flat_hash_map<int64_t, Entry> fields_by_number_;
+  std::vector<const FieldDescriptor*> ordered_fields_;
+  bool supports_compiled_equality_ = false;
+};
+
+bool CompiledMessageEquals(const Message& m1, const Message& m2);
+
+bool SingularFieldEquals(const Reflection* reflection1,
+                         const Reflection* reflection2, const Message& m1,
+                         const Message& m2, const FieldDescriptor* field) {
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      return reflection1->GetInt32(m1, field) ==
+             reflection2->GetInt32(m2, field);
+    case FieldDescriptor::CPPTYPE_INT64:
+      return reflection1->GetInt64(m1, field) ==
+             reflection2->GetInt64(m2, field);
+    case FieldDescriptor::CPPTYPE_UINT32:
+      return reflection1->GetUInt32(m1, field) ==
+             reflection2->GetUInt32(m2, field);
+    case FieldDescriptor::CPPTYPE_UINT64:
+      return reflection1->GetUInt64(m1, field) ==
+             reflection2->GetUInt64(m2, field);
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      return reflection1->GetDouble(m1, field) ==
+             reflection2->GetDouble(m2, field);
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      return reflection1->GetFloat(m1, field) ==
+             reflection2->GetFloat(m2, field);
+    case FieldDescriptor::CPPTYPE_BOOL:
+      return reflection1->GetBool(m1, field) ==
+             reflection2->GetBool(m2, field);
+    case FieldDescriptor::CPPTYPE_ENUM:
+      return reflection1->GetEnumValue(m1, field) ==
+             reflection2->GetEnumValue(m2, field);
+    case FieldDescriptor::CPPTYPE_STRING: {
+      std::string scratch1;
+      std::string scratch2;
+      return reflection1->GetStringReference(m1, field, &scratch1) ==
+             reflection2->GetStringReference(m2, field, &scratch2);
+    }
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      return CompiledMessageEquals(reflection1->GetMessage(m1, field),
+                                   reflection2->GetMessage(m2, field));
+  }
+  return false;
+}
+
+bool RepeatedFieldEquals(const Reflection* reflection1,
+                         const Reflection* reflection2, const Message& m1,
+                         const Message& m2, const FieldDescriptor* field) {
+  const int size = reflection1->FieldSize(m1, field);
+  if (size != reflection2->FieldSize(m2, field)) {
+    return false;
+  }
+  for (int i = 0; i < size; ++i) {
+    switch (field->cpp_type()) {
+      case FieldDescriptor::CPPTYPE_INT32:
+        if (reflection1->GetRepeatedInt32(m1, field, i) !=
+            reflection2->GetRepeatedInt32(m2, field, i)) {
+          return false;
+        }
+        break;
+      case FieldDescriptor::CPPTYPE_INT64:
+        if (reflection1->GetRepeatedInt64(m1, field, i) !=
+            reflection2->GetRepeatedInt64(m2, field, i)) {
+          return false;
+        }
+        break;
+      case FieldDescriptor::CPPTYPE_UINT32:
+        if (reflection1->GetRepeatedUInt32(m1, field, i) !=
+            reflection2->GetRepeatedUInt32(m2, field, i)) {
+          return false;
+        }
+        break;
+      case FieldDescriptor::CPPTYPE_UINT64:
+        if (reflection1->GetRepeatedUInt64(m1, field, i) !=
+            reflection2->GetRepeatedUInt64(m2, field, i)) {
+          return false;
+        }
+        break;
+      case FieldDescriptor::CPPTYPE_DOUBLE:
+        if (reflection1->GetRepeatedDouble(m1, field, i) !=
+            reflection2->GetRepeatedDouble(m2, field, i)) {
+          return false;
+        }
+        break;
+      case FieldDescriptor::CPPTYPE_FLOAT:
+        if (reflection1->GetRepeatedFloat(m1, field, i) !=
+            reflection2->GetRepeatedFloat(m2, field, i)) {
+          return false;
+        }
+        break;
+      case FieldDescriptor::CPPTYPE_BOOL:
+        if (reflection1->GetRepeatedBool(m1, field, i) !=
+            reflection2->GetRepeatedBool(m2, field, i)) {
+          return false;
+        }
+        break;
+      case FieldDescriptor::CPPTYPE_ENUM:
+        if (reflection1->GetRepeatedEnumValue(m1, field, i) !=
+            reflection2->GetRepeatedEnumValue(m2, field, i)) {
+          return false;
+        }
+        break;
+      case FieldDescriptor::CPPTYPE_STRING: {
+        std::string scratch1;
+        std::string scratch2;
+        if (reflection1->GetRepeatedStringReference(m1, field, i, &scratch1) !=
+            reflection2->GetRepeatedStringReference(m2, field, i, &scratch2)) {
+          return false;
+        }
+        break;
+      }
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        if (!CompiledMessageEquals(
+                reflection1->GetRepeatedMessage(m1, field, i),
+                reflection2->GetRepeatedMessage(m2, field, i))) {
+          return false;
+        }
+        break;
+    }
+  }
+  return true;
+}
+
+// Field-by-field equality driven by the compiled field table, equivalent to
+// MessageDifferencer::Equals but without its per-comparison setup and
+// field-walk machinery. Types the table cannot represent faithfully (map
+// fields compare by key, extensions are outside the table) and messages
+// carrying unknown fields fall back to the differencer; assumes both
+// messages share a descriptor.
+bool CompiledMessageEquals(const Message& m1, const Message& m2) {
+  const Reflection* reflection1 = m1.GetReflection();
+  const Reflection* reflection2 = m2.GetReflection();
+  const FieldAccessTable& table =
+      FieldAccessTable::GetOrCreate(m1.GetDescriptor());
+  if (reflection1 == nullptr || reflection2 == nullptr ||
+      !table.supports_compiled_equality() ||
+      !reflection1->GetUnknownFields(m1).empty() ||
+      !reflection2->GetUnknownFields(m2).empty()) {
+    return google::protobuf::util::MessageDifferencer::Equals(m1, m2);
+  }
+  for (const FieldDescriptor* field : table.fields()) {
+    if (field->is_repeated()) {
+      if (!RepeatedFieldEquals(reflection1, reflection2, m1, m2, field)) {
+        return false;
+      }
+    } else if (field->has_presence()) {
+      const bool has = reflection1->HasField(m1, field);
+      if (has != reflection2->HasField(m2, field)) {
+        return false;
+      }
+      if (has &&
+          !SingularFieldEquals(reflection1, reflection2, m1, m2, field)) {
+        return false;
+      }
+    } else if (!SingularFieldEquals(reflection1, reflection2, m1, m2, field)) {
+      // Implicit-presence scalars read as their default when unset, so a
+      // plain value comparison suffices.
+      return false;
+    }
+  }
+  return true;
+}
+
 bool ProtoEquals(const google::protobuf::Message& m1, const google::protobuf::Message& m2) {
   // Equality behavior is undefined for message differencer if input messages
   // have different descriptors. For CEL just return false.
   if (m1.GetDescriptor() != m2.GetDescriptor()) {
     return false;
   }
-  return google::protobuf::util::MessageDifferencer::Equals(m1, m2);
+  return CompiledMessageEquals(m1, m2);
 }
 
 // Implements CEL's notion of field presence for protobuf.
@@ -126,9 +437,24 @@ absl::StatusOr<bool> HasFieldImpl(const google::protobuf::Message* message,
                                   absl::string_view field_name) {
   ABSL_ASSERT(descriptor == message->GetDescriptor());
   const Reflection* reflection = message->GetReflection();
-  const FieldDescriptor* field_desc = descriptor->FindFieldByName(field_name);
-  if (field_desc == nullptr && reflection != nullptr) {
-    // Search to see whether the field name is referring to an extension.
+  const FieldAccessTable::Entry* entry =
+      FieldAccessTable::GetOrCreate(descriptor).Find(field_name);
+  if (entry != nullptr) {
+    if (reflection == nullptr) {
+      return absl::FailedPreconditionError(
+          "google::protobuf::Reflection unavailble in CEL field access.");
+    }
+    if (entry->strategy != FieldAccessTable::Strategy::kSingular) {
+      // Map and list fields are 'present' when non-empty; repeated fields
+      // don't participate in standard proto presence testing.
+      return reflection->FieldSize(*message, entry->field) != 0;
+    }
+    return reflection->HasField(*message, entry->field);
+  }
+
+  // Search to see whether the field name is referring to an extension.
+  const FieldDescriptor* field_desc = nullptr;
+  if (reflection != nullptr) {
     field_desc = reflection->FindKnownExtensionByName(field_name);
   }
   if (field_desc == nullptr) {
@@ -173,8 +499,30 @@ absl::StatusOr<CelValue> GetFieldImpl(const google::protobuf::Message* message,
                                       cel::MemoryManagerRef memory_manager) {
   ABSL_ASSERT(descriptor == message->GetDescriptor());
   const Reflection* reflection = message->GetReflection();
-  const FieldDescriptor* field_desc = descriptor->FindFieldByName(field_name);
-  if (field_desc == nullptr && reflection != nullptr) {
+  google::protobuf::Arena* arena = ProtoMemoryManagerArena(memory_manager);
+
+  const FieldAccessTable::Entry* entry =
+      FieldAccessTable::GetOrCreate(descriptor).Find(field_name);
+  if (entry != nullptr) {
+    switch (entry->strategy) {
+      case FieldAccessTable::Strategy::kMap:
+        return CelValue::CreateMap(
+            google::protobuf::Arena::Create<internal::FieldBackedMapImpl>(
+                arena, message, entry->field, &MessageCelValueFactory, arena));
+      case FieldAccessTable::Strategy::kRepeated:
+        return CelValue::CreateList(
+            google::protobuf::Arena::Create<internal::FieldBackedListImpl>(
+                arena, message, entry->field, &MessageCelValueFactory, arena));
+      case FieldAccessTable::Strategy::kSingular:
+        return internal::CreateValueFromSingleField(message, entry->field,
+                                                    unboxing_option,
+                                                    &MessageCelValueFactory,
+                                                    arena);
+    }
+  }
+
+  const FieldDescriptor* field_desc = nullptr;
+  if (reflection != nullptr) {
     std::string ext_name(field_name);
     field_desc = reflection->FindKnownExtensionByName(ext_name);
   }
@@ -182,8 +530,6 @@ absl::StatusOr<CelValue> GetFieldImpl(const google::protobuf::Message* message,
     return CreateNoSuchFieldError(memory_manager, field_name);
   }
 
-  google::protobuf::Arena* arena = ProtoMemoryManagerArena(memory_manager);
-
   return CreateCelValueFromField(message, field_desc, unboxing_option, arena);
 }
 
@@ -518,7 +864,9 @@ ProtoMessageTypeAdapter::NewInstance(
 }
 
 bool ProtoMessageTypeAdapter::DefinesField(absl::string_view field_name) const {
-  return descriptor_->FindFieldByName(field_name) != nullptr;
+  // Routed through the field table so that plan-time field checks also warm
+  // the table used by the evaluation-time setters.
+  return FieldAccessTable::GetOrCreate(descriptor_).Find(field_name) != nullptr;
 }
 
 absl::StatusOr<bool> ProtoMessageTypeAdapter::HasField(
@@ -555,22 +903,23 @@ absl::Status ProtoMessageTypeAdapter::SetField(
     const google::protobuf::FieldDescriptor* field, const CelValue& value,
     google::protobuf::Arena* arena, google::protobuf::Message* message) const {
   if (field->is_map()) {
-    constexpr int kKeyField = 1;
-    constexpr int kValueField = 2;
-
     const CelMap* cel_map;
     CEL_RETURN_IF_ERROR(ValidateSetFieldOp(
         value.GetValue<const CelMap*>(&cel_map) && cel_map != nullptr,
         field->name(), "value is not CelMap"));
 
-    auto entry_descriptor = field->message_type();
+    // The entry key and value fields were resolved when the containing
+    // message's table was compiled.
+    const FieldAccessTable::Entry* entry =
+        FieldAccessTable::GetOrCreate(field->containing_type())
+            .FindByNumber(field->number());
 
     CEL_RETURN_IF_ERROR(
-        ValidateSetFieldOp(entry_descriptor != nullptr, field->name(),
+        ValidateSetFieldOp(entry != nullptr, field->name(),
                            "failed to find map entry descriptor"));
-    auto key_field_descriptor = entry_descriptor->FindFieldByNumber(kKeyField);
-    auto value_field_descriptor =
-        entry_descriptor->FindFieldByNumber(kValueField);
+
+    const FieldDescriptor* key_field_descriptor = entry->map_key;
+    const FieldDescriptor* value_field_descriptor = entry->map_value;
 
     CEL_RETURN_IF_ERROR(
         ValidateSetFieldOp(key_field_descriptor != nullptr, field->name(),
@@ -622,12 +971,12 @@ absl::Status ProtoMessageTypeAdapter::SetField(
   CEL_ASSIGN_OR_RETURN(google::protobuf::Message * mutable_message,
                        UnwrapMessage(instance, "SetField"));
 
-  const google::protobuf::FieldDescriptor* field_descriptor =
-      descriptor_->FindFieldByName(field_name);
+  const FieldAccessTable::Entry* entry =
+      FieldAccessTable::GetOrCreate(descriptor_).Find(field_name);
   CEL_RETURN_IF_ERROR(
-      ValidateSetFieldOp(field_descriptor != nullptr, field_name, "not found"));
+      ValidateSetFieldOp(entry != nullptr, field_name, "not found"));
 
-  return SetField(field_descriptor, value, arena, mutable_message);
+  return SetField(entry->field, value, arena, mutable_message);
 }
 
 absl::Status ProtoMessageTypeAdapter::SetFieldByNumber(
@@ -641,12 +990,13 @@ absl::Status ProtoMessageTypeAdapter::SetFieldByNumber(
   CEL_ASSIGN_OR_RETURN(google::protobuf::Message * mutable_message,
                        UnwrapMessage(instance, "SetField"));
 
-  const google::protobuf::FieldDescriptor* field_descriptor =
-      descriptor_->FindFieldByNumber(field_number);
-  CEL_RETURN_IF_ERROR(ValidateSetFieldOp(
-      field_descriptor != nullptr, absl::StrCat(field_number), "not found"));
+  const FieldAccessTable::Entry* entry =
+      FieldAccessTable::GetOrCreate(descriptor_).FindByNumber(field_number);
+  CEL_RETURN_IF_ERROR(ValidateSetFieldOp(entry != nullptr,
+                                         absl::StrCat(field_number),
+                                         "not found"));
 
-  return SetField(field_descriptor, value, arena, mutable_message);
+  return SetField(entry->field, value, arena, mutable_message);
 }
 
 absl::StatusOr<CelValue> ProtoMessageTypeAdapter::AdaptFromWellKnownType(
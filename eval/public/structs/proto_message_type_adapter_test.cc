@@ -335,6 +335,44 @@ TEST_P(ProtoMessageTypeAccessorTest, IsEqualToSameTypeInequal) {
   EXPECT_FALSE(accessor.IsEqualTo(value2, value));
 }
 
+TEST_P(ProtoMessageTypeAccessorTest, IsEqualToRepeatedFields) {
+  const LegacyTypeAccessApis& accessor = GetAccessApis();
+
+  TestMessage example;
+  example.add_int64_list(1);
+  example.add_int64_list(2);
+  example.add_string_list("a");
+  TestMessage example2 = example;
+
+  MessageWrapper value(&example, nullptr);
+  MessageWrapper value2(&example2, nullptr);
+
+  EXPECT_TRUE(accessor.IsEqualTo(value, value2));
+
+  example2.set_int64_list(1, 3);
+  EXPECT_FALSE(accessor.IsEqualTo(value, value2));
+}
+
+TEST_P(ProtoMessageTypeAccessorTest, IsEqualToMapFields) {
+  const LegacyTypeAccessApis& accessor = GetAccessApis();
+
+  TestMessage example;
+  (*example.mutable_string_int32_map())["a"] = 1;
+  (*example.mutable_string_int32_map())["b"] = 2;
+  TestMessage example2;
+  // Map equality is key-based and must not depend on insertion order.
+  (*example2.mutable_string_int32_map())["b"] = 2;
+  (*example2.mutable_string_int32_map())["a"] = 1;
+
+  MessageWrapper value(&example, nullptr);
+  MessageWrapper value2(&example2, nullptr);
+
+  EXPECT_TRUE(accessor.IsEqualTo(value, value2));
+
+  (*example2.mutable_string_int32_map())["a"] = 3;
+  EXPECT_FALSE(accessor.IsEqualTo(value, value2));
+}
+
 TEST_P(ProtoMessageTypeAccessorTest, IsEqualToDifferentTypeInequal) {
   const LegacyTypeAccessApis& accessor = GetAccessApis();
 
@@ -15,9 +15,13 @@
 #include "eval/public/structs/protobuf_descriptor_type_provider.h"
 
 #include <memory>
+#include <string>
 #include <utility>
 
 #include "google/protobuf/descriptor.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "eval/public/structs/proto_message_type_adapter.h"
 
@@ -67,4 +71,66 @@ const ProtoMessageTypeAdapter* ProtobufDescriptorProvider::GetTypeAdapter(
   type_cache_[name] = std::move(type_provider);
   return result;
 }
+
+absl::optional<const LegacyAnyPackingApis*>
+ProtobufDescriptorProvider::ProvideLegacyAnyPackingApis(
+    absl::string_view name) const {
+  if (descriptor_pool_->FindMessageTypeByName(name) == nullptr) {
+    return absl::nullopt;
+  }
+  return &any_packing_apis_;
+}
+
+const google::protobuf::Message* ProtobufDescriptorProvider::GetAnyPrototype(
+    absl::string_view type_url) const {
+  {
+    absl::MutexLock lock(&mu_);
+    auto it = any_prototype_cache_.find(type_url);
+    if (it != any_prototype_cache_.end()) {
+      return it->second;
+    }
+  }
+  // Resolve outside the lock; descriptor pool and message factory lookups
+  // are independently thread-safe.
+  const google::protobuf::Message* prototype = nullptr;
+  if (auto pos = type_url.find_last_of('/'); pos != absl::string_view::npos) {
+    const google::protobuf::Descriptor* descriptor =
+        descriptor_pool_->FindMessageTypeByName(type_url.substr(pos + 1));
+    if (descriptor != nullptr) {
+      prototype = message_factory_->GetPrototype(descriptor);
+    }
+  }
+  absl::MutexLock lock(&mu_);
+  return any_prototype_cache_.insert({std::string(type_url), prototype})
+      .first->second;
+}
+
+absl::StatusOr<google::protobuf::MessageLite*>
+ProtobufDescriptorProvider::DescriptorPoolAnyPackingApis::Unpack(
+    const google::protobuf::Any& any_message, google::protobuf::Arena* arena) const {
+  const google::protobuf::Message* prototype =
+      provider_->GetAnyPrototype(any_message.type_url());
+  if (prototype == nullptr) {
+    return absl::NotFoundError(absl::StrCat(
+        "no descriptor found for Any type URL: ", any_message.type_url()));
+  }
+  google::protobuf::Message* nested_message = prototype->New(arena);
+  if (!nested_message->ParseFromString(any_message.value())) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "failed to unpack Any of type: ", any_message.type_url()));
+  }
+  return nested_message;
+}
+
+absl::Status ProtobufDescriptorProvider::DescriptorPoolAnyPackingApis::Pack(
+    const google::protobuf::MessageLite* message,
+    google::protobuf::Any& any_message) const {
+  any_message.set_type_url(
+      absl::StrCat("type.googleapis.com/", message->GetTypeName()));
+  if (!message->SerializeToString(any_message.mutable_value())) {
+    return absl::InternalError(absl::StrCat(
+        "failed to serialize message into Any: ", message->GetTypeName()));
+  }
+  return absl::OkStatus();
+}
 }  // namespace google::api::expr::runtime
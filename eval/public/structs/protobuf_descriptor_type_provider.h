@@ -19,12 +19,16 @@
 #include <string>
 #include <utility>
 
+#include "google/protobuf/any.pb.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
+#include "eval/public/structs/legacy_any_packing.h"
 #include "eval/public/structs/legacy_type_provider.h"
 #include "eval/public/structs/proto_message_type_adapter.h"
 
@@ -44,7 +48,39 @@ class ProtobufDescriptorProvider : public LegacyTypeProvider {
   absl::optional<const LegacyTypeInfoApis*> ProvideLegacyTypeInfo(
       absl::string_view name) const override;
 
+  // Packing apis backed by the registered descriptor pool and message
+  // factory, using the type-URL prototype index below. Provided for any
+  // type resolvable in the pool.
+  absl::optional<const LegacyAnyPackingApis*> ProvideLegacyAnyPackingApis(
+      absl::string_view name) const override;
+
+  // Returns the message prototype for a `google.protobuf.Any` type URL
+  // (e.g. "type.googleapis.com/google.protobuf.Int64Value"), or nullptr if
+  // the URL is malformed or the type is not in the registered pool.
+  //
+  // Resolutions (including misses) are cached keyed by the full URL, so
+  // repeated unpacking of the same type costs one hash lookup instead of a
+  // descriptor pool search per occurrence.
+  const google::protobuf::Message* GetAnyPrototype(absl::string_view type_url) const;
+
  private:
+  class DescriptorPoolAnyPackingApis final : public LegacyAnyPackingApis {
+   public:
+    explicit DescriptorPoolAnyPackingApis(
+        const ProtobufDescriptorProvider* provider)
+        : provider_(provider) {}
+
+    absl::StatusOr<google::protobuf::MessageLite*> Unpack(
+        const google::protobuf::Any& any_message,
+        google::protobuf::Arena* arena) const override;
+
+    absl::Status Pack(const google::protobuf::MessageLite* message,
+                      google::protobuf::Any& any_message) const override;
+
+   private:
+    const ProtobufDescriptorProvider* provider_;
+  };
+
   // Create a new type instance if found in the registered descriptor pool.
   // Otherwise, returns nullptr.
   std::unique_ptr<ProtoMessageTypeAdapter> CreateTypeAdapter(
@@ -57,6 +93,11 @@ class ProtobufDescriptorProvider : public LegacyTypeProvider {
   mutable absl::flat_hash_map<std::string,
                               std::unique_ptr<ProtoMessageTypeAdapter>>
       type_cache_ ABSL_GUARDED_BY(mu_);
+  // Type-URL -> prototype index for Any unpacking. The URL string is
+  // interned as the map key; misses are cached as nullptr.
+  mutable absl::flat_hash_map<std::string, const google::protobuf::Message*>
+      any_prototype_cache_ ABSL_GUARDED_BY(mu_);
+  DescriptorPoolAnyPackingApis any_packing_apis_{this};
   mutable absl::Mutex mu_;
 };
 
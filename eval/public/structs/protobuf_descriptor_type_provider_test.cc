@@ -16,7 +16,9 @@
 
 #include <optional>
 
+#include "google/protobuf/any.pb.h"
 #include "google/protobuf/wrappers.pb.h"
+#include "absl/status/status.h"
 #include "eval/public/cel_value.h"
 #include "eval/public/structs/legacy_type_info_apis.h"
 #include "eval/public/testing/matchers.h"
@@ -91,5 +93,70 @@ TEST(ProtobufDescriptorProvider, NotFound) {
   ASSERT_FALSE(type_info.has_value());
 }
 
+TEST(ProtobufDescriptorProvider, GetAnyPrototypeIndexesByTypeUrl) {
+  ProtobufDescriptorProvider provider(
+      google::protobuf::DescriptorPool::generated_pool(),
+      google::protobuf::MessageFactory::generated_factory());
+
+  const google::protobuf::Message* prototype = provider.GetAnyPrototype(
+      "type.googleapis.com/google.protobuf.Int64Value");
+  ASSERT_TRUE(prototype != nullptr);
+  EXPECT_EQ(prototype->GetDescriptor()->full_name(),
+            "google.protobuf.Int64Value");
+
+  // Repeated lookups hit the cache and return the same prototype.
+  EXPECT_EQ(provider.GetAnyPrototype(
+                "type.googleapis.com/google.protobuf.Int64Value"),
+            prototype);
+
+  EXPECT_EQ(provider.GetAnyPrototype("type.googleapis.com/UnknownType"),
+            nullptr);
+  // Malformed URL (no '/' separator).
+  EXPECT_EQ(provider.GetAnyPrototype("google.protobuf.Int64Value"), nullptr);
+}
+
+TEST(ProtobufDescriptorProvider, AnyPackingApisRoundTrip) {
+  ProtobufDescriptorProvider provider(
+      google::protobuf::DescriptorPool::generated_pool(),
+      google::protobuf::MessageFactory::generated_factory());
+  google::protobuf::Arena arena;
+
+  auto any_apis =
+      provider.ProvideLegacyAnyPackingApis("google.protobuf.Int64Value");
+  ASSERT_TRUE(any_apis.has_value());
+  EXPECT_FALSE(provider.ProvideLegacyAnyPackingApis("UnknownType").has_value());
+
+  google::protobuf::Int64Value original;
+  original.set_value(42);
+  google::protobuf::Any packed;
+  ASSERT_OK((*any_apis)->Pack(&original, packed));
+  EXPECT_EQ(packed.type_url(),
+            "type.googleapis.com/google.protobuf.Int64Value");
+
+  ASSERT_OK_AND_ASSIGN(google::protobuf::MessageLite * unpacked,
+                       (*any_apis)->Unpack(packed, &arena));
+  auto* unpacked_message =
+      google::protobuf::DynamicCastToGenerated<google::protobuf::Int64Value>(
+          static_cast<google::protobuf::Message*>(unpacked));
+  ASSERT_TRUE(unpacked_message != nullptr);
+  EXPECT_EQ(unpacked_message->value(), 42);
+}
+
+TEST(ProtobufDescriptorProvider, UnpackUnknownTypeUrlFails) {
+  ProtobufDescriptorProvider provider(
+      google::protobuf::DescriptorPool::generated_pool(),
+      google::protobuf::MessageFactory::generated_factory());
+  google::protobuf::Arena arena;
+
+  auto any_apis =
+      provider.ProvideLegacyAnyPackingApis("google.protobuf.Int64Value");
+  ASSERT_TRUE(any_apis.has_value());
+
+  google::protobuf::Any packed;
+  packed.set_type_url("type.googleapis.com/UnknownType");
+  EXPECT_THAT((*any_apis)->Unpack(packed, &arena).status(),
+              cel::internal::StatusIs(absl::StatusCode::kNotFound));
+}
+
 }  // namespace
 }  // namespace google::api::expr::runtime
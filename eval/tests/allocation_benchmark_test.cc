@@ -45,6 +45,8 @@ namespace {
 using ::google::api::expr::v1alpha1::ParsedExpr;
 using ::google::api::expr::parser::Parse;
 using testing::HasSubstr;
+using cel::internal::AllocationCounter;
+using cel::internal::ReportArenaBytesPerIteration;
 using cel::internal::StatusIs;
 
 // Evaluates cel expression:
@@ -102,6 +104,7 @@ static void BM_StrCatSharedArena(benchmark::State& state) {
     ASSERT_TRUE(result.GetValue(&holder));
     ASSERT_EQ(holder.value().length(), 1 << len);
   }
+  ReportArenaBytesPerIteration(state, arena.SpaceUsed());
 }
 
 // Expression grows exponentially.
@@ -119,6 +122,10 @@ static void BM_AllocateString(benchmark::State& state) {
                        builder->CreateExpression(&parsed_expr.expr(),
                                                  &parsed_expr.source_info()));
 
+  // Budgets here are deliberate ceilings: they are meant to catch gross
+  // regressions (an accidental copy per element, a dropped arena), not to
+  // pin the exact allocation count of the current implementation.
+  AllocationCounter counter(state, /*max_allocs_per_iteration=*/20);
   for (auto _ : state) {
     Activation activation;
     ASSERT_OK_AND_ASSIGN(CelValue result,
@@ -127,6 +134,7 @@ static void BM_AllocateString(benchmark::State& state) {
     ASSERT_TRUE(result.GetValue(&holder));
     ASSERT_EQ(holder.value(), "11");
   }
+  ReportArenaBytesPerIteration(state, arena.SpaceUsed());
 }
 BENCHMARK(BM_AllocateString);
 
@@ -141,6 +149,7 @@ static void BM_AllocateError(benchmark::State& state) {
                        builder->CreateExpression(&parsed_expr.expr(),
                                                  &parsed_expr.source_info()));
 
+  AllocationCounter counter(state, /*max_allocs_per_iteration=*/20);
   for (auto _ : state) {
     Activation activation;
     ASSERT_OK_AND_ASSIGN(CelValue result,
@@ -150,6 +159,7 @@ static void BM_AllocateError(benchmark::State& state) {
     ASSERT_THAT(*value, StatusIs(absl::StatusCode::kInvalidArgument,
                                  HasSubstr("divide by zero")));
   }
+  ReportArenaBytesPerIteration(state, arena.SpaceUsed());
 }
 BENCHMARK(BM_AllocateError);
 
@@ -164,12 +174,14 @@ static void BM_AllocateMap(benchmark::State& state) {
                        builder->CreateExpression(&parsed_expr.expr(),
                                                  &parsed_expr.source_info()));
 
+  AllocationCounter counter(state, /*max_allocs_per_iteration=*/60);
   for (auto _ : state) {
     Activation activation;
     ASSERT_OK_AND_ASSIGN(CelValue result,
                          cel_expr->Evaluate(activation, &arena));
     ASSERT_TRUE(result.IsMap());
   }
+  ReportArenaBytesPerIteration(state, arena.SpaceUsed());
 }
 
 BENCHMARK(BM_AllocateMap);
@@ -188,12 +200,14 @@ static void BM_AllocateMessage(benchmark::State& state) {
                        builder->CreateExpression(&parsed_expr.expr(),
                                                  &parsed_expr.source_info()));
 
+  AllocationCounter counter(state, /*max_allocs_per_iteration=*/60);
   for (auto _ : state) {
     Activation activation;
     ASSERT_OK_AND_ASSIGN(CelValue result,
                          cel_expr->Evaluate(activation, &arena));
     ASSERT_TRUE(result.IsMessage());
   }
+  ReportArenaBytesPerIteration(state, arena.SpaceUsed());
 }
 
 BENCHMARK(BM_AllocateMessage);
@@ -228,12 +242,14 @@ static void BM_AllocateLargeMessage(benchmark::State& state) {
                        builder->CreateExpression(&parsed_expr.expr(),
                                                  &parsed_expr.source_info()));
 
+  AllocationCounter counter(state, /*max_allocs_per_iteration=*/300);
   for (auto _ : state) {
     Activation activation;
     ASSERT_OK_AND_ASSIGN(CelValue result,
                          cel_expr->Evaluate(activation, &arena));
     ASSERT_TRUE(result.IsMessage());
   }
+  ReportArenaBytesPerIteration(state, arena.SpaceUsed());
 }
 
 BENCHMARK(BM_AllocateLargeMessage);
@@ -249,12 +265,14 @@ static void BM_AllocateList(benchmark::State& state) {
                        builder->CreateExpression(&parsed_expr.expr(),
                                                  &parsed_expr.source_info()));
 
+  AllocationCounter counter(state, /*max_allocs_per_iteration=*/60);
   for (auto _ : state) {
     Activation activation;
     ASSERT_OK_AND_ASSIGN(CelValue result,
                          cel_expr->Evaluate(activation, &arena));
     ASSERT_TRUE(result.IsList());
   }
+  ReportArenaBytesPerIteration(state, arena.SpaceUsed());
 }
 BENCHMARK(BM_AllocateList);
 
@@ -301,6 +301,51 @@ static void BM_EvalString_Trace(benchmark::State& state) {
 // nature of the proto to native type conversion.
 BENCHMARK(BM_EvalString_Trace)->Range(1, 10000);
 
+// Benchmark test
+// Evaluates cel expression:
+// 'x ? 1 : x ? 1 : .... : 0'
+// With x bound to false every condition is evaluated, exercising the ternary
+// step's condition dispatch at each level.
+static void BM_Ternary(benchmark::State& state) {
+  google::protobuf::Arena arena;
+  RuntimeOptions options = GetOptions();
+  auto runtime = StandardRuntimeOrDie(options);
+
+  int len = state.range(0);
+
+  Expr root_expr;
+  Expr* cur_expr = &root_expr;
+
+  for (int i = 0; i < len; i++) {
+    Expr::Call* call = cur_expr->mutable_call_expr();
+    call->set_function("_?_:_");
+    call->add_args()->mutable_ident_expr()->set_name("x");
+    call->add_args()->mutable_const_expr()->set_int64_value(1);
+    cur_expr = call->add_args();
+  }
+
+  cur_expr->mutable_const_expr()->set_int64_value(0);
+
+  ASSERT_OK_AND_ASSIGN(auto cel_expr, ProtobufRuntimeAdapter::CreateProgram(
+                                          *runtime, root_expr));
+
+  Activation activation;
+  ManagedValueFactory value_factory(runtime->GetTypeProvider(),
+                                    GetMemoryManagerForBenchmark(&arena));
+  activation.InsertOrAssignValue("x", BoolValue(false));
+
+  for (auto _ : state) {
+    ASSERT_OK_AND_ASSIGN(cel::Value result,
+                         cel_expr->Evaluate(activation, value_factory.get()));
+    ASSERT_TRUE(InstanceOf<IntValue>(result));
+    ASSERT_TRUE(Cast<IntValue>(result) == 0);
+  }
+}
+
+// A number higher than 10k leads to a stack overflow due to the recursive
+// nature of the proto to native type conversion.
+BENCHMARK(BM_Ternary)->Range(1, 10000);
+
 const char kIP[] = "10.0.1.2";
 const char kPath[] = "/admin/edit";
 const char kToken[] = "admin";
@@ -17,6 +17,7 @@
 #include <cmath>
 #include <cstdint>
 #include <limits>
+#include <utility>
 
 #include "absl/base/casts.h"
 #include "absl/base/optimization.h"
@@ -24,11 +25,13 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "common/casting.h"
 #include "common/value.h"
 #include "eval/public/cel_function_registry.h"
 #include "eval/public/cel_number.h"
 #include "eval/public/cel_options.h"
+#include "internal/overflow.h"
 #include "internal/status_macros.h"
 #include "runtime/function_adapter.h"
 #include "runtime/function_registry.h"
@@ -93,27 +96,29 @@ Value Min(ValueManager&, T v1, U v2) {
 
 absl::StatusOr<Value> MinList(ValueManager& value_manager,
                               const ListValue& values) {
-  CEL_ASSIGN_OR_RETURN(auto iterator, values.NewIterator(value_manager));
-  if (!iterator->HasNext()) {
+  // ForEach costs one dispatch per element where the iterator protocol costs
+  // a HasNext/Next pair, which adds up for reduction-sized lists.
+  absl::optional<CelNumber> min;
+  absl::Status invalid = absl::OkStatus();
+  CEL_RETURN_IF_ERROR(values.ForEach(
+      value_manager,
+      [&min, &invalid](const Value& value) -> absl::StatusOr<bool> {
+        absl::StatusOr<CelNumber> other = ValueToNumber(value, kMathMin);
+        if (!other.ok()) {
+          invalid = other.status();
+          return false;
+        }
+        min = min.has_value() ? MinNumber(*min, *other) : *other;
+        return true;
+      }));
+  if (!invalid.ok()) {
+    return ErrorValue{std::move(invalid)};
+  }
+  if (!min.has_value()) {
     return ErrorValue(
         absl::InvalidArgumentError("math.@min argument must not be empty"));
   }
-  Value value;
-  CEL_RETURN_IF_ERROR(iterator->Next(value_manager, value));
-  absl::StatusOr<CelNumber> current = ValueToNumber(value, kMathMin);
-  if (!current.ok()) {
-    return ErrorValue{current.status()};
-  }
-  CelNumber min = *current;
-  while (iterator->HasNext()) {
-    CEL_RETURN_IF_ERROR(iterator->Next(value_manager, value));
-    absl::StatusOr<CelNumber> other = ValueToNumber(value, kMathMin);
-    if (!other.ok()) {
-      return ErrorValue{other.status()};
-    }
-    min = MinNumber(min, *other);
-  }
-  return NumberToValue(min);
+  return NumberToValue(*min);
 }
 
 CelNumber MaxNumber(CelNumber v1, CelNumber v2) {
@@ -134,27 +139,94 @@ Value Max(ValueManager&, T v1, U v2) {
 
 absl::StatusOr<Value> MaxList(ValueManager& value_manager,
                               const ListValue& values) {
-  CEL_ASSIGN_OR_RETURN(auto iterator, values.NewIterator(value_manager));
-  if (!iterator->HasNext()) {
+  absl::optional<CelNumber> max;
+  absl::Status invalid = absl::OkStatus();
+  CEL_RETURN_IF_ERROR(values.ForEach(
+      value_manager,
+      [&max, &invalid](const Value& value) -> absl::StatusOr<bool> {
+        absl::StatusOr<CelNumber> other = ValueToNumber(value, kMathMax);
+        if (!other.ok()) {
+          invalid = other.status();
+          return false;
+        }
+        max = max.has_value() ? MaxNumber(*max, *other) : *other;
+        return true;
+      }));
+  if (!invalid.ok()) {
+    return ErrorValue{std::move(invalid)};
+  }
+  if (!max.has_value()) {
     return ErrorValue(
         absl::InvalidArgumentError("math.@max argument must not be empty"));
   }
-  Value value;
-  CEL_RETURN_IF_ERROR(iterator->Next(value_manager, value));
-  absl::StatusOr<CelNumber> current = ValueToNumber(value, kMathMax);
-  if (!current.ok()) {
-    return ErrorValue{current.status()};
+  return NumberToValue(*max);
+}
+
+// Reduces a numeric list to its sum with CEL arithmetic semantics: int and
+// uint sums are overflow-checked, double sums follow IEEE 754. Elements must
+// all be the same numeric kind -- mixing kinds would force a silent precision
+// choice, so it is reported as an error instead. An empty list sums to 0.
+absl::StatusOr<Value> SumList(ValueManager& value_manager,
+                              const ListValue& values) {
+  absl::optional<ValueKind> kind;
+  int64_t int_sum = 0;
+  uint64_t uint_sum = 0;
+  double double_sum = 0.0;
+  absl::Status invalid = absl::OkStatus();
+  CEL_RETURN_IF_ERROR(values.ForEach(
+      value_manager,
+      [&](const Value& value) -> absl::StatusOr<bool> {
+        if (kind.has_value() && value.kind() != *kind) {
+          invalid = absl::InvalidArgumentError(
+              "math.sum arguments must all be the same numeric type");
+          return false;
+        }
+        switch (value.kind()) {
+          case ValueKind::kInt: {
+            absl::StatusOr<int64_t> sum = internal::CheckedAdd(
+                int_sum, Cast<IntValue>(value).NativeValue());
+            if (!sum.ok()) {
+              invalid = sum.status();
+              return false;
+            }
+            int_sum = *sum;
+            break;
+          }
+          case ValueKind::kUint: {
+            absl::StatusOr<uint64_t> sum = internal::CheckedAdd(
+                uint_sum, Cast<UintValue>(value).NativeValue());
+            if (!sum.ok()) {
+              invalid = sum.status();
+              return false;
+            }
+            uint_sum = *sum;
+            break;
+          }
+          case ValueKind::kDouble:
+            double_sum += Cast<DoubleValue>(value).NativeValue();
+            break;
+          default:
+            invalid =
+                absl::InvalidArgumentError("math.sum arguments must be numeric");
+            return false;
+        }
+        kind = value.kind();
+        return true;
+      }));
+  if (!invalid.ok()) {
+    return ErrorValue{std::move(invalid)};
+  }
+  if (!kind.has_value()) {
+    return IntValue{0};
   }
-  CelNumber min = *current;
-  while (iterator->HasNext()) {
-    CEL_RETURN_IF_ERROR(iterator->Next(value_manager, value));
-    absl::StatusOr<CelNumber> other = ValueToNumber(value, kMathMax);
-    if (!other.ok()) {
-      return ErrorValue{other.status()};
-    }
-    min = MaxNumber(min, *other);
+  switch (*kind) {
+    case ValueKind::kUint:
+      return UintValue{uint_sum};
+    case ValueKind::kDouble:
+      return DoubleValue{double_sum};
+    default:
+      return IntValue{int_sum};
   }
-  return NumberToValue(min);
 }
 
 template <typename T, typename U>
@@ -375,6 +447,12 @@ absl::Status RegisterMathExtensionFunctions(FunctionRegistry& registry,
       UnaryFunctionAdapter<absl::StatusOr<Value>, ListValue>::WrapFunction(
           MaxList)));
 
+  CEL_RETURN_IF_ERROR(registry.Register(
+      UnaryFunctionAdapter<absl::StatusOr<Value>, ListValue>::CreateDescriptor(
+          "math.sum", /*receiver_style=*/false),
+      UnaryFunctionAdapter<absl::StatusOr<Value>, ListValue>::WrapFunction(
+          SumList)));
+
   CEL_RETURN_IF_ERROR(registry.Register(
       UnaryFunctionAdapter<double, double>::CreateDescriptor(
           "math.ceil", /*receiver_style=*/false),
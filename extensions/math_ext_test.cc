@@ -14,6 +14,8 @@
 
 #include "extensions/math_ext.h"
 
+#include <cstdint>
+#include <limits>
 #include <memory>
 
 #include "google/api/expr/v1alpha1/syntax.pb.h"
@@ -81,6 +83,10 @@ TestCase MaxCase(CelValue list, CelValue result) {
   return TestCase{kMathMax, list, absl::nullopt, result};
 }
 
+TestCase SumCase(CelValue list, CelValue result) {
+  return TestCase{"math.sum", list, absl::nullopt, result};
+}
+
 struct MacroTestCase {
   absl::string_view expr;
   absl::string_view err = "";
@@ -275,6 +281,49 @@ TEST(MathExtTest, MinMaxList) {
   ExpectResult(MaxCase(CelValue::CreateList(&bad_middle_item), err_value));
 }
 
+TEST(MathExtTest, SumList) {
+  ContainerBackedListImpl int_list({CelValue::CreateInt64(1),
+                                    CelValue::CreateInt64(2),
+                                    CelValue::CreateInt64(3)});
+  ExpectResult(
+      SumCase(CelValue::CreateList(&int_list), CelValue::CreateInt64(6)));
+
+  ContainerBackedListImpl uint_list(
+      {CelValue::CreateUint64(2u), CelValue::CreateUint64(40u)});
+  ExpectResult(
+      SumCase(CelValue::CreateList(&uint_list), CelValue::CreateUint64(42u)));
+
+  ContainerBackedListImpl double_list(
+      {CelValue::CreateDouble(1.5), CelValue::CreateDouble(-0.5)});
+  ExpectResult(
+      SumCase(CelValue::CreateList(&double_list), CelValue::CreateDouble(1.0)));
+
+  ContainerBackedListImpl empty_list({});
+  ExpectResult(
+      SumCase(CelValue::CreateList(&empty_list), CelValue::CreateInt64(0)));
+
+  absl::Status mixed_err = absl::InvalidArgumentError(
+      "arguments must all be the same numeric type");
+  CelValue err_value = CelValue::CreateError(&mixed_err);
+  ContainerBackedListImpl mixed_list(
+      {CelValue::CreateInt64(1), CelValue::CreateUint64(2u)});
+  ExpectResult(SumCase(CelValue::CreateList(&mixed_list), err_value));
+
+  absl::Status bad_arg_err =
+      absl::InvalidArgumentError("arguments must be numeric");
+  err_value = CelValue::CreateError(&bad_arg_err);
+  ContainerBackedListImpl bad_item_list(
+      {CelValue::CreateInt64(1), CelValue::CreateBool(true)});
+  ExpectResult(SumCase(CelValue::CreateList(&bad_item_list), err_value));
+
+  absl::Status overflow_err = absl::OutOfRangeError("integer overflow");
+  err_value = CelValue::CreateError(&overflow_err);
+  ContainerBackedListImpl overflow_list(
+      {CelValue::CreateInt64(std::numeric_limits<int64_t>::max()),
+       CelValue::CreateInt64(1)});
+  ExpectResult(SumCase(CelValue::CreateList(&overflow_list), err_value));
+}
+
 using MathExtMacroParamsTest = testing::TestWithParam<MacroTestCase>;
 TEST_P(MathExtMacroParamsTest, MacroTests) {
   const MacroTestCase& test_case = GetParam();
@@ -0,0 +1,316 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EXTENSIONS_NATIVE_STRUCT_H_
+#define THIRD_PARTY_CEL_CPP_EXTENSIONS_NATIVE_STRUCT_H_
+
+// Reflection-lite binding for plain C++ structs.
+//
+// A NativeStructDescriptor describes the fields of a POD-like struct with
+// member pointers, letting CEL select directly from a borrowed instance
+// without converting it to a protobuf message or a per-request map:
+//
+//   struct Order {
+//     int64_t id;
+//     double total;
+//     std::string customer;
+//   };
+//
+//   const auto* kOrderDescriptor = new auto(
+//       NativeStructDescriptorBuilder<Order>("com.example.Order")
+//           .AddField("id", &Order::id)
+//           .AddField("total", &Order::total)
+//           .AddField("customer", &Order::customer)
+//           .Build());
+//
+//   Value order = MakeNativeStructValue(value_manager, *kOrderDescriptor,
+//                                       order_instance);
+//
+// Field values are materialized lazily, one field per select, by reading
+// through the compiled member pointer. The descriptor and the bound instance
+// are borrowed: both must outlive the resulting value and any evaluation
+// results derived from it, which is the natural arrangement when the
+// instance is request state and the descriptor is a process-lifetime
+// constant.
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "common/memory.h"
+#include "common/native_type.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "internal/status_macros.h"
+#include "runtime/runtime_options.h"
+
+namespace cel::extensions {
+
+template <typename T>
+class NativeStructDescriptor;
+
+template <typename T>
+class NativeStructDescriptorBuilder;
+
+template <typename T>
+StructValue MakeNativeStructValue(
+    ValueManager& value_manager,
+    const NativeStructDescriptor<T>& descriptor ABSL_ATTRIBUTE_LIFETIME_BOUND,
+    const T& instance ABSL_ATTRIBUTE_LIFETIME_BOUND);
+
+namespace native_struct_internal {
+
+// Converts a supported member type to the corresponding CEL value.
+template <typename U>
+absl::Status ConvertNativeField(ValueManager& value_manager, const U& value,
+                                Value& result) {
+  if constexpr (std::is_same_v<U, bool>) {
+    result = BoolValue(value);
+  } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+    result = IntValue(static_cast<int64_t>(value));
+  } else if constexpr (std::is_integral_v<U> && std::is_unsigned_v<U>) {
+    result = UintValue(static_cast<uint64_t>(value));
+  } else if constexpr (std::is_floating_point_v<U>) {
+    result = DoubleValue(static_cast<double>(value));
+  } else if constexpr (std::is_same_v<U, std::string> ||
+                       std::is_same_v<U, absl::string_view>) {
+    CEL_ASSIGN_OR_RETURN(result, value_manager.CreateStringValue(value));
+  } else if constexpr (std::is_same_v<U, absl::Duration>) {
+    CEL_ASSIGN_OR_RETURN(result, value_manager.CreateDurationValue(value));
+  } else if constexpr (std::is_same_v<U, absl::Time>) {
+    CEL_ASSIGN_OR_RETURN(result, value_manager.CreateTimestampValue(value));
+  } else {
+    static_assert(sizeof(U) == 0,
+                  "unsupported native field type; nested structs require the "
+                  "AddField overload taking a nested descriptor");
+  }
+  return absl::OkStatus();
+}
+
+template <typename T>
+struct NativeStructField {
+  std::string name;
+  std::function<absl::Status(ValueManager&, const T&, Value&)> get;
+};
+
+}  // namespace native_struct_internal
+
+// Immutable description of how CEL reads the fields of `T`. Build once
+// (typically at startup) with NativeStructDescriptorBuilder and share across
+// all values bound against it.
+//
+// Fields are assigned numbers in declaration order starting at 1, for use
+// with the by-number struct access APIs.
+template <typename T>
+class NativeStructDescriptor final {
+ public:
+  using Field = native_struct_internal::NativeStructField<T>;
+
+  absl::string_view type_name() const ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return type_name_;
+  }
+
+  const std::vector<Field>& fields() const ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return fields_;
+  }
+
+  const Field* FindField(absl::string_view name) const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    auto it = index_.find(name);
+    return it == index_.end() ? nullptr : &fields_[it->second];
+  }
+
+  const Field* FindFieldByNumber(int64_t number) const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    if (number < 1 || static_cast<size_t>(number) > fields_.size()) {
+      return nullptr;
+    }
+    return &fields_[static_cast<size_t>(number) - 1];
+  }
+
+ private:
+  friend class NativeStructDescriptorBuilder<T>;
+
+  NativeStructDescriptor(std::string type_name, std::vector<Field> fields)
+      : type_name_(std::move(type_name)), fields_(std::move(fields)) {
+    index_.reserve(fields_.size());
+    for (size_t i = 0; i < fields_.size(); ++i) {
+      index_.insert({fields_[i].name, i});
+    }
+  }
+
+  std::string type_name_;
+  std::vector<Field> fields_;
+  absl::flat_hash_map<absl::string_view, size_t> index_;
+};
+
+template <typename T>
+class NativeStructDescriptorBuilder final {
+ public:
+  using Field = native_struct_internal::NativeStructField<T>;
+
+  explicit NativeStructDescriptorBuilder(std::string type_name)
+      : type_name_(std::move(type_name)) {}
+
+  // Describes a field of a directly supported type: bool, signed and unsigned
+  // integers, floating point, std::string, absl::Duration or absl::Time.
+  // Field names must be unique.
+  template <typename U>
+  NativeStructDescriptorBuilder& AddField(absl::string_view name, U T::*field) {
+    fields_.push_back(Field{
+        std::string(name),
+        [field](ValueManager& value_manager, const T& instance,
+                Value& result) -> absl::Status {
+          return native_struct_internal::ConvertNativeField(
+              value_manager, instance.*field, result);
+        }});
+    return *this;
+  }
+
+  // Describes a nested struct field bound through its own descriptor. The
+  // nested descriptor must outlive the descriptor being built.
+  template <typename U>
+  NativeStructDescriptorBuilder& AddField(
+      absl::string_view name, U T::*field,
+      const NativeStructDescriptor<U>& nested ABSL_ATTRIBUTE_LIFETIME_BOUND) {
+    fields_.push_back(Field{
+        std::string(name),
+        [field, nested = &nested](ValueManager& value_manager,
+                                  const T& instance,
+                                  Value& result) -> absl::Status {
+          result = MakeNativeStructValue(value_manager, *nested,
+                                         instance.*field);
+          return absl::OkStatus();
+        }});
+    return *this;
+  }
+
+  NativeStructDescriptor<T> Build() && {
+    return NativeStructDescriptor<T>(std::move(type_name_),
+                                     std::move(fields_));
+  }
+
+ private:
+  std::string type_name_;
+  std::vector<Field> fields_;
+};
+
+namespace native_struct_internal {
+
+template <typename T>
+class NativeStructValue final : public ParsedStructValueInterface {
+ public:
+  NativeStructValue(const NativeStructDescriptor<T>* descriptor,
+                    const T* instance)
+      : descriptor_(descriptor), instance_(instance) {}
+
+  absl::string_view GetTypeName() const override {
+    return descriptor_->type_name();
+  }
+
+  std::string DebugString() const override {
+    return std::string(descriptor_->type_name());
+  }
+
+  // Presence of native fields is not modeled; a described struct always has
+  // all of its fields.
+  bool IsZeroValue() const override { return false; }
+
+  absl::Status GetFieldByName(
+      ValueManager& value_manager, absl::string_view name, Value& result,
+      ProtoWrapperTypeOptions unboxing_options) const override {
+    const auto* field = descriptor_->FindField(name);
+    if (field == nullptr) {
+      result = NoSuchFieldError(name);
+      return absl::OkStatus();
+    }
+    return field->get(value_manager, *instance_, result);
+  }
+
+  absl::Status GetFieldByNumber(
+      ValueManager& value_manager, int64_t number, Value& result,
+      ProtoWrapperTypeOptions unboxing_options) const override {
+    const auto* field = descriptor_->FindFieldByNumber(number);
+    if (field == nullptr) {
+      result = NoSuchFieldError(absl::StrCat(number));
+      return absl::OkStatus();
+    }
+    return field->get(value_manager, *instance_, result);
+  }
+
+  absl::StatusOr<bool> HasFieldByName(absl::string_view name) const override {
+    if (descriptor_->FindField(name) == nullptr) {
+      return NoSuchFieldError(name).NativeValue();
+    }
+    return true;
+  }
+
+  absl::StatusOr<bool> HasFieldByNumber(int64_t number) const override {
+    if (descriptor_->FindFieldByNumber(number) == nullptr) {
+      return NoSuchFieldError(absl::StrCat(number)).NativeValue();
+    }
+    return true;
+  }
+
+  absl::Status ForEachField(ValueManager& value_manager,
+                            ForEachFieldCallback callback) const override {
+    for (const auto& field : descriptor_->fields()) {
+      Value value;
+      CEL_RETURN_IF_ERROR(field.get(value_manager, *instance_, value));
+      CEL_ASSIGN_OR_RETURN(bool ok, callback(field.name, value));
+      if (!ok) {
+        break;
+      }
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<NativeStructValue<T>>();
+  }
+
+  const NativeStructDescriptor<T>* descriptor_;
+  const T* instance_;
+};
+
+}  // namespace native_struct_internal
+
+// Binds `instance` as a CEL struct value described by `descriptor`. Both are
+// borrowed; the caller must keep them alive for as long as the returned value
+// (or anything derived from it) may be used.
+template <typename T>
+StructValue MakeNativeStructValue(
+    ValueManager& value_manager,
+    const NativeStructDescriptor<T>& descriptor ABSL_ATTRIBUTE_LIFETIME_BOUND,
+    const T& instance ABSL_ATTRIBUTE_LIFETIME_BOUND) {
+  return ParsedStructValue(
+      value_manager.GetMemoryManager()
+          .MakeShared<native_struct_internal::NativeStructValue<T>>(
+              &descriptor, &instance));
+}
+
+}  // namespace cel::extensions
+
+#endif  // THIRD_PARTY_CEL_CPP_EXTENSIONS_NATIVE_STRUCT_H_
@@ -0,0 +1,214 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "extensions/native_struct.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "base/type_provider.h"
+#include "common/casting.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+
+namespace cel::extensions {
+namespace {
+
+using ::google::api::expr::v1alpha1::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+using testing::ElementsAre;
+using testing::HasSubstr;
+using cel::internal::IsOkAndHolds;
+using cel::internal::StatusIs;
+
+struct Address {
+  std::string city;
+  std::string country;
+};
+
+struct Order {
+  int64_t id;
+  bool priority;
+  uint64_t flags;
+  double total;
+  std::string customer;
+  Address address;
+};
+
+const NativeStructDescriptor<Address>& AddressDescriptor() {
+  static const auto* descriptor = new auto(
+      NativeStructDescriptorBuilder<Address>("com.example.Address")
+          .AddField("city", &Address::city)
+          .AddField("country", &Address::country)
+          .Build());
+  return *descriptor;
+}
+
+const NativeStructDescriptor<Order>& OrderDescriptor() {
+  static const auto* descriptor = new auto(
+      NativeStructDescriptorBuilder<Order>("com.example.Order")
+          .AddField("id", &Order::id)
+          .AddField("priority", &Order::priority)
+          .AddField("flags", &Order::flags)
+          .AddField("total", &Order::total)
+          .AddField("customer", &Order::customer)
+          .AddField("address", &Order::address, AddressDescriptor())
+          .Build());
+  return *descriptor;
+}
+
+Order MakeTestOrder() {
+  return Order{/*id=*/7, /*priority=*/true, /*flags=*/3u, /*total=*/125.5,
+               /*customer=*/"alice",
+               /*address=*/{/*city=*/"London", /*country=*/"UK"}};
+}
+
+class NativeStructTest : public testing::Test {
+ protected:
+  NativeStructTest()
+      : value_factory_(TypeProvider::Builtin(),
+                       MemoryManagerRef::ReferenceCounting()) {}
+
+  ValueManager& value_manager() { return value_factory_.get(); }
+
+  ManagedValueFactory value_factory_;
+};
+
+TEST_F(NativeStructTest, GetFieldByNameConvertsPrimitives) {
+  Order order = MakeTestOrder();
+  StructValue value =
+      MakeNativeStructValue(value_manager(), OrderDescriptor(), order);
+
+  EXPECT_EQ(value.GetTypeName(), "com.example.Order");
+
+  Value field;
+  ASSERT_OK(value.GetFieldByName(value_manager(), "id", field));
+  EXPECT_EQ(Cast<IntValue>(field).NativeValue(), 7);
+  ASSERT_OK(value.GetFieldByName(value_manager(), "priority", field));
+  EXPECT_TRUE(Cast<BoolValue>(field).NativeValue());
+  ASSERT_OK(value.GetFieldByName(value_manager(), "flags", field));
+  EXPECT_EQ(Cast<UintValue>(field).NativeValue(), 3u);
+  ASSERT_OK(value.GetFieldByName(value_manager(), "total", field));
+  EXPECT_EQ(Cast<DoubleValue>(field).NativeValue(), 125.5);
+  ASSERT_OK(value.GetFieldByName(value_manager(), "customer", field));
+  EXPECT_EQ(Cast<StringValue>(field).ToString(), "alice");
+}
+
+TEST_F(NativeStructTest, UnknownFieldIsNoSuchFieldError) {
+  Order order = MakeTestOrder();
+  StructValue value =
+      MakeNativeStructValue(value_manager(), OrderDescriptor(), order);
+
+  Value field;
+  ASSERT_OK(value.GetFieldByName(value_manager(), "missing", field));
+  ASSERT_TRUE(InstanceOf<ErrorValue>(field));
+  EXPECT_THAT(Cast<ErrorValue>(field).NativeValue(),
+              StatusIs(absl::StatusCode::kNotFound, HasSubstr("missing")));
+}
+
+TEST_F(NativeStructTest, HasFieldByName) {
+  Order order = MakeTestOrder();
+  StructValue value =
+      MakeNativeStructValue(value_manager(), OrderDescriptor(), order);
+
+  EXPECT_THAT(value.HasFieldByName("customer"), IsOkAndHolds(true));
+  EXPECT_THAT(value.HasFieldByName("missing"),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST_F(NativeStructTest, GetFieldByNumberFollowsDeclarationOrder) {
+  Order order = MakeTestOrder();
+  StructValue value =
+      MakeNativeStructValue(value_manager(), OrderDescriptor(), order);
+
+  Value field;
+  ASSERT_OK(value.GetFieldByNumber(value_manager(), 1, field));
+  EXPECT_EQ(Cast<IntValue>(field).NativeValue(), 7);
+  ASSERT_OK(value.GetFieldByNumber(value_manager(), 5, field));
+  EXPECT_EQ(Cast<StringValue>(field).ToString(), "alice");
+  ASSERT_OK(value.GetFieldByNumber(value_manager(), 7, field));
+  ASSERT_TRUE(InstanceOf<ErrorValue>(field));
+}
+
+TEST_F(NativeStructTest, NestedStructSelect) {
+  Order order = MakeTestOrder();
+  StructValue value =
+      MakeNativeStructValue(value_manager(), OrderDescriptor(), order);
+
+  Value address;
+  ASSERT_OK(value.GetFieldByName(value_manager(), "address", address));
+  ASSERT_TRUE(InstanceOf<StructValue>(address));
+
+  Value city;
+  ASSERT_OK(Cast<StructValue>(address).GetFieldByName(value_manager(), "city",
+                                                      city));
+  EXPECT_EQ(Cast<StringValue>(city).ToString(), "London");
+}
+
+TEST_F(NativeStructTest, ForEachFieldEnumeratesDeclarationOrder) {
+  Order order = MakeTestOrder();
+  StructValue value =
+      MakeNativeStructValue(value_manager(), OrderDescriptor(), order);
+
+  std::vector<std::string> names;
+  ASSERT_OK(value.ForEachField(
+      value_manager(),
+      [&](absl::string_view name, const Value&) -> absl::StatusOr<bool> {
+        names.push_back(std::string(name));
+        return true;
+      }));
+  EXPECT_THAT(names, ElementsAre("id", "priority", "flags", "total",
+                                 "customer", "address"));
+}
+
+TEST_F(NativeStructTest, EvaluatesThroughProgram) {
+  RuntimeOptions options;
+  ASSERT_OK_AND_ASSIGN(RuntimeBuilder builder,
+                       CreateStandardRuntimeBuilder(options));
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+  ASSERT_OK_AND_ASSIGN(
+      ParsedExpr parsed_expr,
+      Parse("o.priority && o.total > 100.0 && o.address.city == 'London'"));
+  ASSERT_OK_AND_ASSIGN(
+      auto program, ProtobufRuntimeAdapter::CreateProgram(*runtime, parsed_expr));
+
+  Order order = MakeTestOrder();
+  Activation activation;
+  activation.InsertOrAssignValue(
+      "o", MakeNativeStructValue(value_manager(), OrderDescriptor(), order));
+
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       program->Evaluate(activation, value_manager()));
+  ASSERT_TRUE(InstanceOf<BoolValue>(result));
+  EXPECT_TRUE(Cast<BoolValue>(result).NativeValue());
+}
+
+}  // namespace
+}  // namespace cel::extensions
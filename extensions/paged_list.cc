@@ -0,0 +1,172 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "extensions/paged_list.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "common/json.h"
+#include "common/memory.h"
+#include "common/native_type.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "internal/status_macros.h"
+
+namespace cel::extensions {
+
+namespace {
+
+class PagedListValue final : public ParsedListValueInterface {
+ public:
+  explicit PagedListValue(ListPageFetcher fetcher)
+      : fetcher_(std::move(fetcher)) {}
+
+  std::string DebugString() const override {
+    return absl::StrCat("[<paged list: ", known_size_, " fetched>]");
+  }
+
+  bool IsEmpty() const override { return Size() == 0; }
+
+  // Reports the element count fetched so far, pulling the next page once
+  // every fetched element has been consumed. This is what lets the
+  // comprehension loop's size probe drive paging.
+  size_t Size() const override {
+    if (!exhausted_ && fetch_status_.ok() && served_ == known_size_) {
+      FetchNextPage();
+    }
+    return known_size_;
+  }
+
+  absl::StatusOr<JsonArray> ConvertToJsonArray(
+      AnyToJsonConverter&) const override {
+    return absl::FailedPreconditionError(
+        "paged list cannot be converted to JSON; only the current page is "
+        "resident");
+  }
+
+  absl::StatusOr<absl::Nonnull<ValueIteratorPtr>> NewIterator(
+      ValueManager& value_manager) const override {
+    return std::make_unique<PagedIterator>(*this, value_manager);
+  }
+
+  absl::Status ForEach(ValueManager& value_manager,
+                       ForEachWithIndexCallback callback) const override {
+    for (size_t index = 0;; ++index) {
+      if (index >= Size()) {
+        break;
+      }
+      Value element;
+      CEL_RETURN_IF_ERROR(GetImpl(value_manager, index, element));
+      CEL_ASSIGN_OR_RETURN(bool ok, callback(index, element));
+      if (!ok) {
+        break;
+      }
+    }
+    return fetch_status_;
+  }
+
+ protected:
+  absl::Status GetImpl(ValueManager&, size_t index,
+                       Value& result) const override {
+    if (index < page_begin_) {
+      return absl::FailedPreconditionError(absl::StrCat(
+          "paged list element ", index,
+          " is no longer resident; paged lists support a single forward "
+          "pass"));
+    }
+    while (index >= known_size_ && !exhausted_ && fetch_status_.ok()) {
+      FetchNextPage();
+    }
+    CEL_RETURN_IF_ERROR(fetch_status_);
+    if (index >= known_size_) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("paged list index out of range: ", index));
+    }
+    result = page_[index - page_begin_];
+    if (index >= served_) {
+      served_ = index + 1;
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  // Unlike the default interface iterator, which snapshots the size on
+  // construction, this one re-probes Size() so advancing pulls new pages.
+  class PagedIterator final : public ValueIterator {
+   public:
+    PagedIterator(const PagedListValue& list, ValueManager& value_manager)
+        : list_(list), value_manager_(value_manager) {}
+
+    bool HasNext() override {
+      // On a fetch failure, report one more element so Next surfaces the
+      // error instead of silently truncating the list.
+      return index_ < list_.Size() || !list_.fetch_status_.ok();
+    }
+
+    absl::Status Next(ValueManager&, Value& result) override {
+      return list_.GetImpl(value_manager_, index_++, result);
+    }
+
+   private:
+    const PagedListValue& list_;
+    ValueManager& value_manager_;
+    size_t index_ = 0;
+  };
+
+  NativeTypeId GetNativeTypeId() const noexcept override {
+    return NativeTypeId::For<PagedListValue>();
+  }
+
+  void FetchNextPage() const {
+    auto page = fetcher_(known_size_);
+    if (!page.ok()) {
+      fetch_status_ = std::move(page).status();
+      exhausted_ = true;
+      return;
+    }
+    page_begin_ = known_size_;
+    page_ = std::move(page->elements);
+    known_size_ += page_.size();
+    // An empty page ends the list even if the fetcher claims more; this
+    // guards against an infinite size probe loop.
+    exhausted_ = !page->has_more || page_.empty();
+  }
+
+  mutable ListPageFetcher fetcher_;
+  mutable std::vector<Value> page_;
+  mutable size_t page_begin_ = 0;
+  mutable size_t known_size_ = 0;
+  mutable size_t served_ = 0;
+  mutable bool exhausted_ = false;
+  mutable absl::Status fetch_status_ = absl::OkStatus();
+};
+
+}  // namespace
+
+ListValue MakePagedListValue(ValueManager& value_manager,
+                             ListPageFetcher fetcher) {
+  return ParsedListValue(
+      value_manager.GetMemoryManager().MakeShared<PagedListValue>(
+          std::move(fetcher)));
+}
+
+}  // namespace cel::extensions
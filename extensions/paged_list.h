@@ -0,0 +1,61 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EXTENSIONS_PAGED_LIST_H_
+#define THIRD_PARTY_CEL_CPP_EXTENSIONS_PAGED_LIST_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/status/statusor.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+
+namespace cel::extensions {
+
+// One fetched page of list elements.
+struct ListPage {
+  std::vector<Value> elements;
+  // True if more pages may follow. An empty page ends the list regardless.
+  bool has_more = false;
+};
+
+// Fetches the page starting at element `offset`. Pages are requested
+// strictly in order: `offset` is always the index just past the last
+// fetched element. The fetcher may block (e.g. on I/O); it is never called
+// again once a page reports `has_more == false`, a page is empty, or it
+// returns an error.
+using ListPageFetcher =
+    absl::AnyInvocable<absl::StatusOr<ListPage>(size_t offset)>;
+
+// Creates a `list` value whose elements are produced page by page from
+// `fetcher`, keeping only the current page resident.
+//
+// The comprehension loop (`exists`, `filter`, ...) probes the size and then
+// reads elements in order, so a single comprehension streams the whole
+// dataset with bounded memory and stops fetching as soon as it
+// short-circuits. The size is revealed incrementally: `Size()` reports the
+// elements fetched so far, pulling the next page once all of them have been
+// consumed.
+//
+// Consequently the value supports one forward pass only. Reading an element
+// from an evicted page, converting the list to JSON, or iterating it a
+// second time fails with `FAILED_PRECONDITION`.
+ListValue MakePagedListValue(ValueManager& value_manager,
+                             ListPageFetcher fetcher);
+
+}  // namespace cel::extensions
+
+#endif  // THIRD_PARTY_CEL_CPP_EXTENSIONS_PAGED_LIST_H_
@@ -0,0 +1,165 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "extensions/paged_list.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "base/type_provider.h"
+#include "common/casting.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+
+namespace cel::extensions {
+namespace {
+
+using ::cel::extensions::ProtobufRuntimeAdapter;
+using ::google::api::expr::v1alpha1::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+using cel::internal::StatusIs;
+
+class PagedListTest : public testing::Test {
+ public:
+  PagedListTest()
+      : value_factory_(TypeProvider::Builtin(),
+                       MemoryManagerRef::ReferenceCounting()) {}
+
+ protected:
+  ValueManager& value_manager() { return value_factory_.get(); }
+
+  // Pages of `page_size` ints 0..total-1, counting fetcher invocations.
+  ListValue MakeCountingList(int64_t total, size_t page_size,
+                             size_t& fetch_count) {
+    return MakePagedListValue(
+        value_manager(),
+        [total, page_size, &fetch_count](
+            size_t offset) -> absl::StatusOr<ListPage> {
+          ++fetch_count;
+          ListPage page;
+          for (size_t i = offset;
+               i < offset + page_size && i < static_cast<size_t>(total); ++i) {
+            page.elements.push_back(IntValue(static_cast<int64_t>(i)));
+          }
+          page.has_more = offset + page.elements.size() <
+                          static_cast<size_t>(total);
+          return page;
+        });
+  }
+
+  ManagedValueFactory value_factory_;
+};
+
+TEST_F(PagedListTest, ForEachDrainsAllPages) {
+  size_t fetch_count = 0;
+  ListValue list = MakeCountingList(5, 2, fetch_count);
+
+  std::vector<int64_t> seen;
+  ASSERT_OK(list.ForEach(value_manager(),
+                         [&seen](const Value& element) -> absl::StatusOr<bool> {
+                           seen.push_back(Cast<IntValue>(element).NativeValue());
+                           return true;
+                         }));
+  EXPECT_THAT(seen, testing::ElementsAre(0, 1, 2, 3, 4));
+  EXPECT_EQ(fetch_count, 3);
+}
+
+TEST_F(PagedListTest, IteratorPullsPagesOnDemand) {
+  size_t fetch_count = 0;
+  ListValue list = MakeCountingList(4, 2, fetch_count);
+
+  ASSERT_OK_AND_ASSIGN(auto iterator, list.NewIterator(value_manager()));
+  std::vector<int64_t> seen;
+  while (iterator->HasNext()) {
+    ASSERT_OK_AND_ASSIGN(Value element, iterator->Next(value_manager()));
+    seen.push_back(Cast<IntValue>(element).NativeValue());
+  }
+  EXPECT_THAT(seen, testing::ElementsAre(0, 1, 2, 3));
+}
+
+TEST_F(PagedListTest, EvictedPageIsNotReadable) {
+  size_t fetch_count = 0;
+  ListValue list = MakeCountingList(6, 2, fetch_count);
+
+  Value element;
+  ASSERT_OK(list.Get(value_manager(), 0, element));
+  ASSERT_OK(list.Get(value_manager(), 1, element));
+  ASSERT_OK(list.Get(value_manager(), 2, element));
+  // Index 0 lived on the first, now evicted page.
+  EXPECT_THAT(list.Get(value_manager(), 0, element),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST_F(PagedListTest, FetchErrorSurfaces) {
+  ListValue list = MakePagedListValue(
+      value_manager(), [](size_t offset) -> absl::StatusOr<ListPage> {
+        if (offset == 0) {
+          ListPage page;
+          page.elements.push_back(IntValue(1));
+          page.has_more = true;
+          return page;
+        }
+        return absl::UnavailableError("backend gone");
+      });
+
+  ASSERT_OK_AND_ASSIGN(auto iterator, list.NewIterator(value_manager()));
+  ASSERT_TRUE(iterator->HasNext());
+  ASSERT_OK(iterator->Next(value_manager()).status());
+  ASSERT_TRUE(iterator->HasNext());
+  EXPECT_THAT(iterator->Next(value_manager()).status(),
+              StatusIs(absl::StatusCode::kUnavailable));
+}
+
+TEST_F(PagedListTest, ComprehensionShortCircuitStopsFetching) {
+  RuntimeOptions options;
+  ASSERT_OK_AND_ASSIGN(RuntimeBuilder builder,
+                       CreateStandardRuntimeBuilder(options));
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr,
+                       Parse("pages.exists(x, x == 3)"));
+  ASSERT_OK_AND_ASSIGN(
+      auto program, ProtobufRuntimeAdapter::CreateProgram(*runtime, parsed_expr));
+
+  size_t fetch_count = 0;
+  Activation activation;
+  activation.InsertOrAssignValue("pages",
+                                 MakeCountingList(1000, 2, fetch_count));
+
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       program->Evaluate(activation, value_manager()));
+  ASSERT_TRUE(InstanceOf<BoolValue>(result));
+  EXPECT_TRUE(Cast<BoolValue>(result).NativeValue());
+  // Element 3 lives on the second page of two; the remaining 498 pages were
+  // never fetched.
+  EXPECT_EQ(fetch_count, 2);
+}
+
+}  // namespace
+}  // namespace cel::extensions
@@ -14,6 +14,7 @@
 
 #include "extensions/protobuf/ast_converters.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -28,8 +29,10 @@
 #include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/functional/overload.h"
+#include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "absl/types/variant.h"
 #include "base/ast.h"
@@ -39,6 +42,8 @@
 #include "extensions/protobuf/internal/ast.h"
 #include "internal/proto_time_encoding.h"
 #include "internal/status_macros.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 
 namespace cel::extensions {
 namespace internal {
@@ -737,4 +742,173 @@ absl::StatusOr<google::api::expr::v1alpha1::CheckedExpr> CreateCheckedExprFromAs
   return checked_expr;
 }
 
+namespace {
+
+Expr CopyExpr(const Expr& expr);
+
+std::unique_ptr<Expr> CopyExprPtr(const Expr& expr) {
+  return std::make_unique<Expr>(CopyExpr(expr));
+}
+
+// Structurally copies an expression. `Expr` deliberately deletes its copy
+// operations to keep accidental AST copies out of the parser and planner, so
+// the cache copies node-by-node.
+Expr CopyExpr(const Expr& expr) {
+  Expr copy;
+  copy.set_id(expr.id());
+  absl::visit(
+      absl::Overload(
+          [](const UnspecifiedExpr&) {},
+          [&](const Constant& constant) { copy.set_const_expr(constant); },
+          [&](const Ident& ident) {
+            copy.mutable_ident_expr().set_name(ident.name());
+          },
+          [&](const Select& select) {
+            auto& select_copy = copy.mutable_select_expr();
+            if (select.has_operand()) {
+              select_copy.set_operand(CopyExprPtr(select.operand()));
+            }
+            select_copy.set_field(select.field());
+            select_copy.set_test_only(select.test_only());
+          },
+          [&](const Call& call) {
+            auto& call_copy = copy.mutable_call_expr();
+            call_copy.set_function(call.function());
+            if (call.has_target()) {
+              call_copy.set_target(CopyExprPtr(call.target()));
+            }
+            call_copy.mutable_args().reserve(call.args().size());
+            for (const Expr& arg : call.args()) {
+              call_copy.mutable_args().push_back(CopyExpr(arg));
+            }
+          },
+          [&](const CreateList& list_expr) {
+            auto& list_copy = copy.mutable_list_expr();
+            list_copy.mutable_elements().reserve(list_expr.elements().size());
+            for (const ListExprElement& element : list_expr.elements()) {
+              auto& element_copy = list_copy.add_elements();
+              if (element.has_expr()) {
+                element_copy.set_expr(CopyExpr(element.expr()));
+              }
+              element_copy.set_optional(element.optional());
+            }
+          },
+          [&](const CreateStruct& struct_expr) {
+            auto& struct_copy = copy.mutable_struct_expr();
+            struct_copy.set_name(struct_expr.name());
+            struct_copy.mutable_fields().reserve(struct_expr.fields().size());
+            for (const StructExprField& field : struct_expr.fields()) {
+              auto& field_copy = struct_copy.add_fields();
+              field_copy.set_id(field.id());
+              field_copy.set_name(field.name());
+              if (field.has_value()) {
+                field_copy.set_value(CopyExpr(field.value()));
+              }
+              field_copy.set_optional(field.optional());
+            }
+          },
+          [&](const MapExpr& map_expr) {
+            auto& map_copy = copy.mutable_map_expr();
+            map_copy.mutable_entries().reserve(map_expr.entries().size());
+            for (const MapExprEntry& entry : map_expr.entries()) {
+              auto& entry_copy = map_copy.add_entries();
+              entry_copy.set_id(entry.id());
+              if (entry.has_key()) {
+                entry_copy.set_key(CopyExpr(entry.key()));
+              }
+              if (entry.has_value()) {
+                entry_copy.set_value(CopyExpr(entry.value()));
+              }
+              entry_copy.set_optional(entry.optional());
+            }
+          },
+          [&](const Comprehension& comprehension) {
+            auto& comprehension_copy = copy.mutable_comprehension_expr();
+            comprehension_copy.set_iter_var(comprehension.iter_var());
+            if (comprehension.has_iter_range()) {
+              comprehension_copy.set_iter_range(
+                  CopyExprPtr(comprehension.iter_range()));
+            }
+            comprehension_copy.set_accu_var(comprehension.accu_var());
+            if (comprehension.has_accu_init()) {
+              comprehension_copy.set_accu_init(
+                  CopyExprPtr(comprehension.accu_init()));
+            }
+            if (comprehension.has_loop_condition()) {
+              comprehension_copy.set_loop_condition(
+                  CopyExprPtr(comprehension.loop_condition()));
+            }
+            if (comprehension.has_loop_step()) {
+              comprehension_copy.set_loop_step(
+                  CopyExprPtr(comprehension.loop_step()));
+            }
+            if (comprehension.has_result()) {
+              comprehension_copy.set_result(
+                  CopyExprPtr(comprehension.result()));
+            }
+          }),
+      expr.kind());
+  return copy;
+}
+
+// `SourceInfo` is move-only through its macro call expressions; everything
+// else is copyable directly.
+SourceInfo CopySourceInfo(const SourceInfo& source_info) {
+  absl::flat_hash_map<int64_t, Expr> macro_calls;
+  macro_calls.reserve(source_info.macro_calls().size());
+  for (const auto& macro_call : source_info.macro_calls()) {
+    macro_calls.emplace(macro_call.first, CopyExpr(macro_call.second));
+  }
+  return SourceInfo(source_info.syntax_version(), source_info.location(),
+                    source_info.line_offsets(), source_info.positions(),
+                    std::move(macro_calls), source_info.extensions());
+}
+
+std::unique_ptr<Ast> CopyAst(const AstImpl& ast) {
+  return std::make_unique<AstImpl>(
+      CopyExpr(ast.root_expr()), CopySourceInfo(ast.source_info()),
+      ast.reference_map(), ast.type_map(), std::string(ast.expr_version()));
+}
+
+std::string FingerprintCheckedExpr(const CheckedExprPb& checked_expr) {
+  std::string fingerprint;
+  google::protobuf::io::StringOutputStream stream(&fingerprint);
+  google::protobuf::io::CodedOutputStream output(&stream);
+  // Map field serialization order is unspecified by default; deterministic
+  // serialization keeps equal messages producing equal keys.
+  output.SetSerializationDeterministic(true);
+  checked_expr.SerializePartialToCodedStream(&output);
+  output.Trim();
+  return fingerprint;
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<Ast>>
+CheckedExprAstCache::CreateAstFromCheckedExpr(
+    const CheckedExprPb& checked_expr) {
+  std::string fingerprint = FingerprintCheckedExpr(checked_expr);
+  {
+    absl::MutexLock lock(&mutex_);
+    if (auto it = entries_.find(fingerprint); it != entries_.end()) {
+      return CopyAst(*it->second);
+    }
+  }
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<Ast> ast,
+                       cel::extensions::CreateAstFromCheckedExpr(checked_expr));
+  std::unique_ptr<const AstImpl> entry =
+      absl::WrapUnique(AstImpl::CastFromPublicAst(ast.release()));
+  std::unique_ptr<Ast> result = CopyAst(*entry);
+  absl::MutexLock lock(&mutex_);
+  // A concurrent conversion of the same expression may have inserted first;
+  // the existing entry wins and the duplicate is discarded.
+  entries_.emplace(std::move(fingerprint), std::move(entry));
+  return result;
+}
+
+size_t CheckedExprAstCache::size() const {
+  absl::MutexLock lock(&mutex_);
+  return entries_.size();
+}
+
 }  // namespace cel::extensions
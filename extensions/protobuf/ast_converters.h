@@ -15,12 +15,18 @@
 #ifndef THIRD_PARTY_CEL_CPP_EXTENSIONS_PROTOBUF_AST_CONVERTERS_H_
 #define THIRD_PARTY_CEL_CPP_EXTENSIONS_PROTOBUF_AST_CONVERTERS_H_
 
+#include <cstddef>
 #include <memory>
+#include <string>
 
 #include "google/api/expr/v1alpha1/checked.pb.h"
 #include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "base/ast.h"
+#include "base/ast_internal/ast_impl.h"
 #include "base/ast_internal/expr.h"
 
 namespace cel::extensions {
@@ -63,6 +69,41 @@ absl::StatusOr<std::unique_ptr<Ast>> CreateAstFromCheckedExpr(
 absl::StatusOr<google::api::expr::v1alpha1::CheckedExpr> CreateCheckedExprFromAst(
     const Ast& ast);
 
+// Memoizing wrapper around `CreateAstFromCheckedExpr`.
+//
+// Conversions are keyed by the deterministically serialized form of the
+// checked expression, so repeated loads of an unchanged expression copy a
+// cached native AST instead of re-walking the protobuf representation.
+// Copying preserves the usual contract that every returned AST is uniquely
+// owned and may be mutated freely (for example by planner optimizers).
+//
+// Entries live for the lifetime of the cache. Callers loading an unbounded
+// set of distinct expressions should scope the cache to a batch of loads
+// rather than holding one for the process lifetime.
+//
+// This class is thread-safe.
+class CheckedExprAstCache {
+ public:
+  CheckedExprAstCache() = default;
+
+  CheckedExprAstCache(const CheckedExprAstCache&) = delete;
+  CheckedExprAstCache& operator=(const CheckedExprAstCache&) = delete;
+
+  // Equivalent to the free function `CreateAstFromCheckedExpr`, consulting
+  // and populating the cache.
+  absl::StatusOr<std::unique_ptr<Ast>> CreateAstFromCheckedExpr(
+      const google::api::expr::v1alpha1::CheckedExpr& checked_expr);
+
+  // Returns the number of cached conversions.
+  size_t size() const;
+
+ private:
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<std::string,
+                      std::unique_ptr<const ast_internal::AstImpl>>
+      entries_ ABSL_GUARDED_BY(mutex_);
+};
+
 }  // namespace cel::extensions
 
 #endif  // THIRD_PARTY_CEL_CPP_EXTENSIONS_PROTOBUF_AST_CONVERTERS_H_
@@ -817,6 +817,33 @@ TEST_P(ConversionRoundTripTest, CheckedExprCopyable) {
               IsOkAndHolds(EqualsProto(checked_expr)));
 }
 
+TEST_P(ConversionRoundTripTest, CachedCheckedExprCopyable) {
+  ASSERT_OK_AND_ASSIGN(ParsedExprPb parsed_expr,
+                       Parse(GetParam().expr, "<input>", options_));
+
+  CheckedExprPb checked_expr;
+  *checked_expr.mutable_expr() = parsed_expr.expr();
+  *checked_expr.mutable_source_info() = parsed_expr.source_info();
+
+  int64_t root_id = checked_expr.expr().id();
+  (*checked_expr.mutable_reference_map())[root_id].add_overload_id("_==_");
+  (*checked_expr.mutable_type_map())[root_id].set_primitive(TypePb::BOOL);
+
+  CheckedExprAstCache cache;
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Ast> ast,
+                       cache.CreateAstFromCheckedExpr(checked_expr));
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Ast> cached_ast,
+                       cache.CreateAstFromCheckedExpr(checked_expr));
+  EXPECT_EQ(cache.size(), 1);
+
+  EXPECT_THAT(
+      CreateCheckedExprFromAst(ast_internal::AstImpl::CastFromPublicAst(*ast)),
+      IsOkAndHolds(EqualsProto(checked_expr)));
+  EXPECT_THAT(CreateCheckedExprFromAst(
+                  ast_internal::AstImpl::CastFromPublicAst(*cached_ast)),
+              IsOkAndHolds(EqualsProto(checked_expr)));
+}
+
 INSTANTIATE_TEST_SUITE_P(
     ExpressionCases, ConversionRoundTripTest,
     testing::ValuesIn<ConversionRoundTripCase>(
@@ -836,6 +863,52 @@ INSTANTIATE_TEST_SUITE_P(
          {R"cel({?"abc": {}[?1]}.?abc.orValue(42) == 42)cel"},
          {R"cel([1, 2, ?optional.none()].size() == 2)cel"}}));
 
+TEST(CheckedExprAstCacheTest, DistinguishesExpressions) {
+  CheckedExprPb checked_expr;
+  checked_expr.mutable_expr()->set_id(1);
+  checked_expr.mutable_expr()->mutable_ident_expr()->set_name("a");
+
+  CheckedExprPb other_checked_expr = checked_expr;
+  other_checked_expr.mutable_expr()->mutable_ident_expr()->set_name("b");
+
+  CheckedExprAstCache cache;
+  ASSERT_OK(cache.CreateAstFromCheckedExpr(checked_expr).status());
+  ASSERT_OK(cache.CreateAstFromCheckedExpr(other_checked_expr).status());
+  EXPECT_EQ(cache.size(), 2);
+}
+
+TEST(CheckedExprAstCacheTest, ReturnedAstsAreIndependent) {
+  CheckedExprPb checked_expr;
+  checked_expr.mutable_expr()->set_id(1);
+  checked_expr.mutable_expr()->mutable_ident_expr()->set_name("a");
+
+  CheckedExprAstCache cache;
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Ast> ast,
+                       cache.CreateAstFromCheckedExpr(checked_expr));
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Ast> other_ast,
+                       cache.CreateAstFromCheckedExpr(checked_expr));
+
+  // Mutating one returned AST must not leak into the cache or into other
+  // returned ASTs.
+  ast_internal::AstImpl::CastFromPublicAst(*ast)
+      .root_expr()
+      .mutable_ident_expr()
+      .set_name("mutated");
+
+  EXPECT_EQ(ast_internal::AstImpl::CastFromPublicAst(*other_ast)
+                .root_expr()
+                .ident_expr()
+                .name(),
+            "a");
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Ast> third_ast,
+                       cache.CreateAstFromCheckedExpr(checked_expr));
+  EXPECT_EQ(ast_internal::AstImpl::CastFromPublicAst(*third_ast)
+                .root_expr()
+                .ident_expr()
+                .name(),
+            "a");
+}
+
 TEST(ExtensionConversionRoundTripTest, RoundTrip) {
   ParsedExprPb parsed_expr;
   ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(
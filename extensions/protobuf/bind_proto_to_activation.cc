@@ -14,10 +14,18 @@
 
 #include "extensions/protobuf/bind_proto_to_activation.h"
 
+#include <memory>
 #include <utility>
+#include <vector>
 
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "common/value.h"
 #include "internal/status_macros.h"
 #include "runtime/activation.h"
@@ -29,56 +37,124 @@ namespace {
 
 using ::google::protobuf::Descriptor;
 
-absl::StatusOr<bool> ShouldBindField(
-    const google::protobuf::FieldDescriptor* field_desc, const StructValue& struct_value,
-    BindProtoUnsetFieldBehavior unset_field_behavior,
-    ValueManager& value_manager) {
-  if (unset_field_behavior == BindProtoUnsetFieldBehavior::kBindDefaultValue ||
-      field_desc->is_repeated()) {
-    return true;
-  }
-  return struct_value.HasFieldByNumber(field_desc->number());
-}
+// One field of a compiled binding plan: everything the binding loop needs,
+// resolved from the FieldDescriptor once per descriptor instead of per call.
+struct PlannedField {
+  // Name the field binds under; views the descriptor's storage.
+  absl::string_view name;
+  int number;
+  // Repeated fields always bind (an unset repeated field is an empty list),
+  // so they skip the presence check regardless of unset field behavior.
+  bool always_bind;
+  // google.protobuf.Any fields bind NullValue when unset, which requires a
+  // presence check even under kBindDefaultValue.
+  bool unset_any_check;
+};
+
+// Field walk for one descriptor, compiled on first use.
+struct BindingPlan {
+  std::vector<PlannedField> fields;
+};
+
+// Returns the binding plan for `descriptor`, compiling and caching it on
+// first use. Plans are keyed by descriptor identity and kept for the process
+// lifetime; context message descriptors come from pool-lifetime descriptors
+// in practice, so the cache stays small and entries never go stale.
+const BindingPlan& GetBindingPlan(const Descriptor& descriptor) {
+  static absl::NoDestructor<absl::Mutex> mutex;
+  static absl::NoDestructor<
+      absl::flat_hash_map<const Descriptor*, std::unique_ptr<BindingPlan>>>
+      plans ABSL_GUARDED_BY(*mutex);
 
-absl::StatusOr<Value> GetFieldValue(const google::protobuf::FieldDescriptor* field_desc,
-                                    const StructValue& struct_value,
-                                    ValueManager& value_manager) {
-  // Special case unset any.
-  if (field_desc->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE &&
-      field_desc->message_type()->well_known_type() ==
-          Descriptor::WELLKNOWNTYPE_ANY) {
-    CEL_ASSIGN_OR_RETURN(bool present,
-                         struct_value.HasFieldByNumber(field_desc->number()));
-    if (!present) {
-      return NullValue();
+  {
+    absl::MutexLock lock(&*mutex);
+    auto it = plans->find(&descriptor);
+    if (it != plans->end()) {
+      return *it->second;
     }
   }
 
-  return struct_value.GetFieldByNumber(value_manager, field_desc->number());
-}
+  auto plan = std::make_unique<BindingPlan>();
+  plan->fields.reserve(descriptor.field_count());
+  for (int i = 0; i < descriptor.field_count(); i++) {
+    const google::protobuf::FieldDescriptor* field_desc = descriptor.field(i);
+    PlannedField& field = plan->fields.emplace_back();
+    field.name = field_desc->name();
+    field.number = field_desc->number();
+    field.always_bind = field_desc->is_repeated();
+    field.unset_any_check =
+        !field_desc->is_repeated() &&
+        field_desc->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE &&
+        field_desc->message_type()->well_known_type() ==
+            Descriptor::WELLKNOWNTYPE_ANY;
+  }
 
-}  // namespace
+  absl::MutexLock lock(&*mutex);
+  // Insert does nothing if another thread compiled the plan first.
+  return *plans->try_emplace(&descriptor, std::move(plan)).first->second;
+}
 
-absl::Status BindProtoToActivation(
+absl::Status BindProtoToActivationImpl(
     const Descriptor& descriptor, const StructValue& struct_value,
     ValueManager& value_manager, Activation& activation,
-    BindProtoUnsetFieldBehavior unset_field_behavior) {
-  for (int i = 0; i < descriptor.field_count(); i++) {
-    const google::protobuf::FieldDescriptor* field_desc = descriptor.field(i);
-    CEL_ASSIGN_OR_RETURN(bool should_bind,
-                         ShouldBindField(field_desc, struct_value,
-                                         unset_field_behavior, value_manager));
-    if (!should_bind) {
+    BindProtoUnsetFieldBehavior unset_field_behavior,
+    const absl::flat_hash_set<std::string>* referenced_fields) {
+  const BindingPlan& plan = GetBindingPlan(descriptor);
+  const bool bind_default =
+      unset_field_behavior == BindProtoUnsetFieldBehavior::kBindDefaultValue;
+
+  for (const PlannedField& field : plan.fields) {
+    if (referenced_fields != nullptr &&
+        !referenced_fields->contains(field.name)) {
       continue;
     }
 
-    CEL_ASSIGN_OR_RETURN(
-        Value field, GetFieldValue(field_desc, struct_value, value_manager));
+    if (field.unset_any_check) {
+      // Special case unset any.
+      CEL_ASSIGN_OR_RETURN(bool present,
+                           struct_value.HasFieldByNumber(field.number));
+      if (!present) {
+        if (bind_default) {
+          activation.InsertOrAssignValue(field.name, NullValue());
+        }
+        continue;
+      }
+    } else if (!field.always_bind && !bind_default) {
+      CEL_ASSIGN_OR_RETURN(bool present,
+                           struct_value.HasFieldByNumber(field.number));
+      if (!present) {
+        continue;
+      }
+    }
 
-    activation.InsertOrAssignValue(field_desc->name(), std::move(field));
+    CEL_ASSIGN_OR_RETURN(
+        Value value,
+        struct_value.GetFieldByNumber(value_manager, field.number));
+    activation.InsertOrAssignValue(field.name, std::move(value));
   }
 
   return absl::OkStatus();
 }
 
+}  // namespace
+
+absl::Status BindProtoToActivation(
+    const Descriptor& descriptor, const StructValue& struct_value,
+    ValueManager& value_manager, Activation& activation,
+    BindProtoUnsetFieldBehavior unset_field_behavior) {
+  return BindProtoToActivationImpl(descriptor, struct_value, value_manager,
+                                   activation, unset_field_behavior,
+                                   /*referenced_fields=*/nullptr);
+}
+
+absl::Status BindProtoToActivation(
+    const Descriptor& descriptor, const StructValue& struct_value,
+    ValueManager& value_manager, Activation& activation,
+    BindProtoUnsetFieldBehavior unset_field_behavior,
+    const absl::flat_hash_set<std::string>& referenced_fields) {
+  return BindProtoToActivationImpl(descriptor, struct_value, value_manager,
+                                   activation, unset_field_behavior,
+                                   &referenced_fields);
+}
+
 }  // namespace cel::extensions::protobuf_internal
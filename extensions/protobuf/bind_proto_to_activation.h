@@ -15,6 +15,9 @@
 #ifndef THIRD_PARTY_CEL_CPP_EXTENSIONS_PROTOBUF_BIND_PROTO_TO_ACTIVATION_H_
 #define THIRD_PARTY_CEL_CPP_EXTENSIONS_PROTOBUF_BIND_PROTO_TO_ACTIVATION_H_
 
+#include <string>
+
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "common/casting.h"
 #include "common/value.h"
@@ -40,12 +43,24 @@ namespace protobuf_internal {
 
 // Implements binding provided the context message has already
 // been adapted to a suitable struct value.
+//
+// The per-field work (name, number, presence handling) is resolved once per
+// descriptor into a cached binding plan, so repeated binds of the same
+// message type run a flat loop of direct reads.
 absl::Status BindProtoToActivation(
     const google::protobuf::Descriptor& descriptor, const StructValue& struct_value,
     ValueManager& value_manager, Activation& activation,
     BindProtoUnsetFieldBehavior unset_field_behavior =
         BindProtoUnsetFieldBehavior::kSkip);
 
+// As above, but only binds fields named in `referenced_fields`; see the
+// template overload below.
+absl::Status BindProtoToActivation(
+    const google::protobuf::Descriptor& descriptor, const StructValue& struct_value,
+    ValueManager& value_manager, Activation& activation,
+    BindProtoUnsetFieldBehavior unset_field_behavior,
+    const absl::flat_hash_set<std::string>& referenced_fields);
+
 }  // namespace protobuf_internal
 
 // Utility method, that takes a protobuf Message and interprets it as a
@@ -109,6 +124,42 @@ absl::Status BindProtoToActivation(
                                                   unset_field_behavior);
 }
 
+// As above, but only binds the fields named in `referenced_fields`, skipping
+// the conversion and insertion cost of fields the target programs provably
+// never read.
+//
+// `referenced_fields` should hold the top-level identifiers the programs
+// reference — e.g. the root segments of the paths returned by
+// cel::ExtractFieldPaths, or the variable names recorded in a checked
+// expression's reference map. Names that are not fields of the context
+// message are ignored.
+template <typename T>
+absl::Status BindProtoToActivation(
+    const T& context, ValueManager& value_manager, Activation& activation,
+    BindProtoUnsetFieldBehavior unset_field_behavior,
+    const absl::flat_hash_set<std::string>& referenced_fields) {
+  static_assert(protobuf_internal::IsProtoMessage<T>);
+  CEL_ASSIGN_OR_RETURN(Value parent,
+                       ProtoMessageToValue(value_manager, context));
+
+  if (!InstanceOf<StructValue>(parent)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("context is a well-known type: ", context.GetTypeName()));
+  }
+  const StructValue& struct_value = Cast<StructValue>(parent);
+
+  const google::protobuf::Descriptor* descriptor = context.GetDescriptor();
+
+  if (descriptor == nullptr) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("context missing descriptor: ", context.GetTypeName()));
+  }
+
+  return protobuf_internal::BindProtoToActivation(
+      *descriptor, struct_value, value_manager, activation,
+      unset_field_behavior, referenced_fields);
+}
+
 }  // namespace cel::extensions
 
 #endif  // THIRD_PARTY_CEL_CPP_EXTENSIONS_PROTOBUF_BIND_PROTO_TO_ACTIVATION_H_
@@ -14,7 +14,10 @@
 
 #include "extensions/protobuf/bind_proto_to_activation.h"
 
+#include <string>
+
 #include "google/protobuf/wrappers.pb.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/types/optional.h"
 #include "common/casting.h"
@@ -89,6 +92,26 @@ TEST_P(BindProtoToActivationTest, BindProtoToActivationSkip) {
               IsOkAndHolds(Eq(absl::nullopt)));
 }
 
+TEST_P(BindProtoToActivationTest, BindProtoToActivationReferencedFields) {
+  ProtoTypeReflector provider;
+  ManagedValueFactory value_factory(provider, memory_manager());
+  TestAllTypes test_all_types;
+  test_all_types.set_single_int64(123);
+  test_all_types.set_single_int32(456);
+  Activation activation;
+
+  ASSERT_OK(BindProtoToActivation(
+      test_all_types, value_factory.get(), activation,
+      BindProtoUnsetFieldBehavior::kSkip,
+      absl::flat_hash_set<std::string>{"single_int64", "not_a_field"}));
+
+  EXPECT_THAT(activation.FindVariable(value_factory.get(), "single_int64"),
+              IsOkAndHolds(Optional(IntValueIs(123))));
+  // Set on the message, but not referenced, so not bound.
+  EXPECT_THAT(activation.FindVariable(value_factory.get(), "single_int32"),
+              IsOkAndHolds(Eq(absl::nullopt)));
+}
+
 TEST_P(BindProtoToActivationTest, BindProtoToActivationDefault) {
   ProtoTypeReflector provider;
   ManagedValueFactory value_factory(provider, memory_manager());
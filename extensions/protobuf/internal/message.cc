@@ -29,6 +29,7 @@
 #include "absl/base/attributes.h"
 #include "absl/base/nullability.h"
 #include "absl/base/optimization.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/absl_check.h"
 #include "absl/numeric/bits.h"
 #include "absl/status/status.h"
@@ -1402,6 +1403,34 @@ class ParsedProtoQualifyState final : public ProtoQualifyState {
 
 class ParsedProtoStructValueInterface;
 
+// Thread-local memo of field descriptor lookups. Select steps resolve the
+// same field name against the same message type on every evaluation, so this
+// turns the descriptor probe (and the extension registry fallback for known
+// misses) into one local hash probe. Negative results are cached as nullptr.
+const google::protobuf::FieldDescriptor* FindFieldByNameMemoized(
+    const google::protobuf::Message& message, absl::string_view name) {
+  using Key = std::pair<const google::protobuf::Descriptor*, std::string>;
+  static thread_local absl::flat_hash_map<
+      Key, const google::protobuf::FieldDescriptor*>
+      cache;
+  // Bound growth in the face of dynamically created descriptors.
+  constexpr size_t kMaxEntries = 4096;
+  const auto* desc = message.GetDescriptor();
+  auto it = cache.find(Key(desc, std::string(name)));
+  if (it != cache.end()) {
+    return it->second;
+  }
+  const auto* field_desc = desc->FindFieldByName(name);
+  if (field_desc == nullptr) {
+    field_desc = message.GetReflection()->FindKnownExtensionByName(name);
+  }
+  if (cache.size() >= kMaxEntries) {
+    cache.clear();
+  }
+  cache.insert({Key(desc, std::string(name)), field_desc});
+  return field_desc;
+}
+
 const ParsedProtoStructValueInterface* AsParsedProtoStructValue(
     const ParsedStructValue& value);
 
@@ -1455,14 +1484,10 @@ class ParsedProtoStructValueInterface
   absl::Status GetFieldByName(
       ValueManager& value_manager, absl::string_view name, Value& result,
       ProtoWrapperTypeOptions unboxing_options) const final {
-    const auto* desc = message().GetDescriptor();
-    const auto* field_desc = desc->FindFieldByName(name);
+    const auto* field_desc = FindFieldByNameMemoized(message(), name);
     if (ABSL_PREDICT_FALSE(field_desc == nullptr)) {
-      field_desc = message().GetReflection()->FindKnownExtensionByName(name);
-      if (ABSL_PREDICT_FALSE(field_desc == nullptr)) {
-        result = NoSuchFieldError(name);
-        return absl::OkStatus();
-      }
+      result = NoSuchFieldError(name);
+      return absl::OkStatus();
     }
     return GetField(value_manager, field_desc, result, unboxing_options);
   }
@@ -1484,13 +1509,9 @@ class ParsedProtoStructValueInterface
   }
 
   absl::StatusOr<bool> HasFieldByName(absl::string_view name) const final {
-    const auto* desc = message().GetDescriptor();
-    const auto* field_desc = desc->FindFieldByName(name);
+    const auto* field_desc = FindFieldByNameMemoized(message(), name);
     if (ABSL_PREDICT_FALSE(field_desc == nullptr)) {
-      field_desc = message().GetReflection()->FindKnownExtensionByName(name);
-      if (ABSL_PREDICT_FALSE(field_desc == nullptr)) {
-        return NoSuchFieldError(name).NativeValue();
-      }
+      return NoSuchFieldError(name).NativeValue();
     }
     return HasField(field_desc);
   }
@@ -14,18 +14,28 @@
 
 #include "extensions/regex_functions.h"
 
+#include <cstddef>
+#include <list>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "eval/public/cel_function.h"
 #include "eval/public/cel_options.h"
 #include "eval/public/cel_value.h"
 #include "eval/public/containers/container_backed_map_impl.h"
 #include "eval/public/portable_cel_function_adapter.h"
+#include "internal/status_macros.h"
+#include "runtime/internal/regex_program_cache.h"
 #include "re2/re2.h"
 
 namespace cel::extensions {
@@ -40,18 +50,112 @@ using ::google::api::expr::runtime::PortableBinaryFunctionAdapter;
 using ::google::api::expr::runtime::PortableFunctionAdapter;
 using ::google::protobuf::Arena;
 
+// A compiled pattern together with its capture plan: the display name of
+// each capturing group (the group's name when named, otherwise its 1-based
+// index in decimal), resolved once at compile time instead of per call.
+struct CompiledRegexPlan {
+  std::shared_ptr<const RE2> re2;
+  std::vector<std::string> group_names;
+};
+
+// Process-wide bounded cache of compiled patterns with capture plans.
+//
+// The regex functions receive the pattern as an ordinary argument, so unlike
+// matches() there is no planner rewrite point; caching by pattern gives
+// literal patterns the same compile-once behavior. Compilation delegates to
+// RegexProgramCache, sharing programs with precompiled matches() call sites.
+// The strong references here keep the hot entries alive between calls;
+// least recently used patterns are dropped to bound memory when callers
+// construct patterns dynamically.
+class CompiledRegexPlanCache final {
+ public:
+  static CompiledRegexPlanCache& Global() {
+    static absl::NoDestructor<CompiledRegexPlanCache> cache;
+    return *cache;
+  }
+
+  absl::StatusOr<std::shared_ptr<const CompiledRegexPlan>> GetOrCompile(
+      absl::string_view pattern, int max_program_size) {
+    Key key{std::string(pattern), max_program_size};
+    {
+      absl::MutexLock lock(&mutex_);
+      auto it = index_.find(key);
+      if (it != index_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->plan;
+      }
+    }
+
+    // Compile outside the lock; concurrent misses for one pattern may race,
+    // but they receive the same interned RE2 from the program cache.
+    CEL_ASSIGN_OR_RETURN(
+        std::shared_ptr<const RE2> re2,
+        cel::runtime_internal::RegexProgramCache::Global().GetOrCompile(
+            key.first, max_program_size));
+    auto plan = std::make_shared<CompiledRegexPlan>();
+    const int group_count = re2->NumberOfCapturingGroups();
+    const auto& named_groups = re2->CapturingGroupNames();
+    plan->re2 = std::move(re2);
+    plan->group_names.reserve(group_count);
+    for (int index = 1; index <= group_count; ++index) {
+      auto it = named_groups.find(index);
+      plan->group_names.push_back(it != named_groups.end()
+                                      ? it->second
+                                      : std::to_string(index));
+    }
+
+    absl::MutexLock lock(&mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second);
+      return it->second->plan;
+    }
+    lru_.push_front(Entry{key, std::move(plan)});
+    index_[std::move(key)] = lru_.begin();
+    if (lru_.size() > kMaxEntries) {
+      index_.erase(lru_.back().key);
+      lru_.pop_back();
+    }
+    return lru_.front().plan;
+  }
+
+ private:
+  using Key = std::pair<std::string, int>;
+
+  struct Entry {
+    Key key;
+    std::shared_ptr<const CompiledRegexPlan> plan;
+  };
+
+  static constexpr size_t kMaxEntries = 64;
+
+  absl::Mutex mutex_;
+  std::list<Entry> lru_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<Key, std::list<Entry>::iterator> index_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+// Returns the compiled plan for `regex`, or an error CelValue matching the
+// previous per-call compilation behavior when the pattern does not compile.
+absl::StatusOr<std::shared_ptr<const CompiledRegexPlan>> Compile(
+    CelValue::StringHolder regex, int max_program_size) {
+  return CompiledRegexPlanCache::Global().GetOrCompile(regex.value(),
+                                                       max_program_size);
+}
+
 // Extract matched group values from the given target string and rewrite the
 // string
 CelValue ExtractString(Arena* arena, CelValue::StringHolder target,
                        CelValue::StringHolder regex,
-                       CelValue::StringHolder rewrite) {
-  RE2 re2(regex.value());
-  if (!re2.ok()) {
+                       CelValue::StringHolder rewrite, int max_program_size) {
+  auto plan = Compile(regex, max_program_size);
+  if (!plan.ok()) {
     return CreateErrorValue(
         arena, absl::InvalidArgumentError("Given Regex is Invalid"));
   }
   std::string output;
-  auto result = RE2::Extract(target.value(), re2, rewrite.value(), &output);
+  auto result =
+      RE2::Extract(target.value(), *(*plan)->re2, rewrite.value(), &output);
   if (!result) {
     return CreateErrorValue(
         arena, absl::InvalidArgumentError(
@@ -64,14 +168,14 @@ CelValue ExtractString(Arena* arena, CelValue::StringHolder target,
 // Captures the first unnamed/named group value
 // NOTE: For capturing all the groups, use CaptureStringN instead
 CelValue CaptureString(Arena* arena, CelValue::StringHolder target,
-                       CelValue::StringHolder regex) {
-  RE2 re2(regex.value());
-  if (!re2.ok()) {
+                       CelValue::StringHolder regex, int max_program_size) {
+  auto plan = Compile(regex, max_program_size);
+  if (!plan.ok()) {
     return CreateErrorValue(
         arena, absl::InvalidArgumentError("Given Regex is Invalid"));
   }
   std::string output;
-  auto result = RE2::FullMatch(target.value(), re2, &output);
+  auto result = RE2::FullMatch(target.value(), *(*plan)->re2, &output);
   if (!result) {
     return CreateErrorValue(
         arena, absl::InvalidArgumentError(
@@ -88,14 +192,15 @@ CelValue CaptureString(Arena* arena, CelValue::StringHolder target,
 //   a. For a named group - <named_group_name, captured_string>
 //   b. For an unnamed group - <group_index, captured_string>
 CelValue CaptureStringN(Arena* arena, CelValue::StringHolder target,
-                        CelValue::StringHolder regex) {
-  RE2 re2(regex.value());
-  if (!re2.ok()) {
+                        CelValue::StringHolder regex, int max_program_size) {
+  auto plan_or = Compile(regex, max_program_size);
+  if (!plan_or.ok()) {
     return CreateErrorValue(
         arena, absl::InvalidArgumentError("Given Regex is Invalid"));
   }
-  const int capturing_groups_count = re2.NumberOfCapturingGroups();
-  const auto& named_capturing_groups_map = re2.CapturingGroupNames();
+  const CompiledRegexPlan& plan = **plan_or;
+  const int capturing_groups_count =
+      static_cast<int>(plan.group_names.size());
   if (capturing_groups_count <= 0) {
     return CreateErrorValue(arena,
                             absl::InvalidArgumentError(
@@ -109,8 +214,8 @@ CelValue CaptureStringN(Arena* arena, CelValue::StringHolder target,
     captured_string_addresses[j] = &captured_strings[j];
     argv[j] = &captured_string_addresses[j];
   }
-  auto result =
-      RE2::FullMatchN(target.value(), re2, argv.data(), capturing_groups_count);
+  auto result = RE2::FullMatchN(target.value(), *plan.re2, argv.data(),
+                                capturing_groups_count);
   if (!result) {
     return CreateErrorValue(
         arena, absl::InvalidArgumentError(
@@ -118,12 +223,9 @@ CelValue CaptureStringN(Arena* arena, CelValue::StringHolder target,
   }
   std::vector<std::pair<CelValue, CelValue>> cel_values;
   for (int index = 1; index <= capturing_groups_count; index++) {
-    auto it = named_capturing_groups_map.find(index);
-    std::string name = it != named_capturing_groups_map.end()
-                           ? it->second
-                           : std::to_string(index);
     cel_values.emplace_back(
-        CelValue::CreateString(google::protobuf::Arena::Create<std::string>(arena, name)),
+        CelValue::CreateString(google::protobuf::Arena::Create<std::string>(
+            arena, plan.group_names[index - 1])),
         CelValue::CreateString(google::protobuf::Arena::Create<std::string>(
             arena, captured_strings[index - 1])));
   }
@@ -136,17 +238,19 @@ CelValue CaptureStringN(Arena* arena, CelValue::StringHolder target,
   return CelValue::CreateMap(cel_map);
 }
 
-absl::Status RegisterRegexFunctions(CelFunctionRegistry* registry) {
+absl::Status RegisterRegexFunctions(CelFunctionRegistry* registry,
+                                    int max_program_size) {
   // Register Regex Extract Function
   CEL_RETURN_IF_ERROR(
       (PortableFunctionAdapter<CelValue, CelValue::StringHolder,
                                CelValue::StringHolder, CelValue::StringHolder>::
            CreateAndRegister(
                kRegexExtract, /*receiver_type=*/false,
-               [](Arena* arena, CelValue::StringHolder target,
-                  CelValue::StringHolder regex,
-                  CelValue::StringHolder rewrite) -> CelValue {
-                 return ExtractString(arena, target, regex, rewrite);
+               [max_program_size](Arena* arena, CelValue::StringHolder target,
+                                  CelValue::StringHolder regex,
+                                  CelValue::StringHolder rewrite) -> CelValue {
+                 return ExtractString(arena, target, regex, rewrite,
+                                      max_program_size);
                },
                registry)));
 
@@ -155,9 +259,10 @@ absl::Status RegisterRegexFunctions(CelFunctionRegistry* registry) {
       PortableBinaryFunctionAdapter<CelValue, CelValue::StringHolder,
                                     CelValue::StringHolder>::
           Create(kRegexCapture, /*receiver_style=*/false,
-                 [](Arena* arena, CelValue::StringHolder target,
-                    CelValue::StringHolder regex) -> CelValue {
-                   return CaptureString(arena, target, regex);
+                 [max_program_size](Arena* arena, CelValue::StringHolder target,
+                                    CelValue::StringHolder regex) -> CelValue {
+                   return CaptureString(arena, target, regex,
+                                        max_program_size);
                  })));
 
   // Register Regex CaptureN Function
@@ -165,9 +270,10 @@ absl::Status RegisterRegexFunctions(CelFunctionRegistry* registry) {
       PortableBinaryFunctionAdapter<CelValue, CelValue::StringHolder,
                                     CelValue::StringHolder>::
           Create(kRegexCaptureN, /*receiver_style=*/false,
-                 [](Arena* arena, CelValue::StringHolder target,
-                    CelValue::StringHolder regex) -> CelValue {
-                   return CaptureStringN(arena, target, regex);
+                 [max_program_size](Arena* arena, CelValue::StringHolder target,
+                                    CelValue::StringHolder regex) -> CelValue {
+                   return CaptureStringN(arena, target, regex,
+                                         max_program_size);
                  }));
 }
 
@@ -176,7 +282,8 @@ absl::Status RegisterRegexFunctions(CelFunctionRegistry* registry) {
 absl::Status RegisterRegexFunctions(CelFunctionRegistry* registry,
                                     const InterpreterOptions& options) {
   if (options.enable_regex) {
-    CEL_RETURN_IF_ERROR(RegisterRegexFunctions(registry));
+    CEL_RETURN_IF_ERROR(
+        RegisterRegexFunctions(registry, options.regex_max_program_size));
   }
   return absl::OkStatus();
 }
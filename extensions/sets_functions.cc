@@ -14,11 +14,20 @@
 
 #include "extensions/sets_functions.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/optional.h"
 #include "base/function_adapter.h"
+#include "common/casting.h"
 #include "common/value.h"
 #include "common/value_manager.h"
+#include "internal/number.h"
 #include "internal/status_macros.h"
 #include "runtime/function_registry.h"
 #include "runtime/runtime_options.h"
@@ -27,9 +36,136 @@ namespace cel::extensions {
 
 namespace {
 
+using ::cel::internal::Number;
+
+// Below this many elementwise comparisons the nested scan is cheaper than
+// building a hash index over one operand.
+constexpr size_t kIndexCostThreshold = 64;
+
+// Lifts a scalar value into the shared numeric comparison domain, or nullopt
+// if it is not numeric.
+absl::optional<Number> GetNumber(const Value& value) {
+  switch (value.kind()) {
+    case ValueKind::kInt:
+      return Number::FromInt64(Cast<IntValue>(value).NativeValue());
+    case ValueKind::kUint:
+      return Number::FromUint64(Cast<UintValue>(value).NativeValue());
+    case ValueKind::kDouble:
+      return Number::FromDouble(Cast<DoubleValue>(value).NativeValue());
+    default:
+      return absl::nullopt;
+  }
+}
+
+// Hash index over the scalar elements of one list operand.
+//
+// sets.contains/intersects/equivalent are quadratic when both operands are
+// plain lists: every probe is a linear Contains scan. When the repeatedly
+// probed operand holds only scalars, the index is built once per call and
+// each probe becomes a hash lookup, making the operation O(n + m). Numbers
+// are canonicalized into int/uint/double domains the same way on build and
+// probe, so heterogeneous numeric equality (`2.0` matching `2`) is preserved
+// exactly.
+class ScalarSetIndex {
+ public:
+  // Builds an index over `list`, or nullopt if it holds elements other than
+  // bool, numeric or string; callers fall back to the scanning path.
+  static absl::StatusOr<absl::optional<ScalarSetIndex>> Build(
+      ValueManager& value_manager, const ListValue& list) {
+    ScalarSetIndex index;
+    bool eligible = true;
+    CEL_RETURN_IF_ERROR(list.ForEach(
+        value_manager,
+        [&index, &eligible](const Value& element) -> absl::StatusOr<bool> {
+          switch (element.kind()) {
+            case ValueKind::kBool:
+              (Cast<BoolValue>(element).NativeValue() ? index.has_true_
+                                                      : index.has_false_) =
+                  true;
+              return true;
+            case ValueKind::kInt:
+            case ValueKind::kUint:
+            case ValueKind::kDouble: {
+              Number number = *GetNumber(element);
+              if (number.LosslessConvertibleToInt()) {
+                index.ints_.insert(number.AsInt());
+              } else if (number.LosslessConvertibleToUint()) {
+                index.uints_.insert(number.AsUint());
+              } else {
+                index.doubles_.insert(number.AsDouble());
+              }
+              return true;
+            }
+            case ValueKind::kString:
+              index.strings_.insert(Cast<StringValue>(element).NativeString());
+              return true;
+            default:
+              eligible = false;
+              return false;
+          }
+        }));
+    if (!eligible) {
+      return absl::nullopt;
+    }
+    return absl::optional<ScalarSetIndex>(std::move(index));
+  }
+
+  bool Contains(const Value& value) const {
+    switch (value.kind()) {
+      case ValueKind::kBool:
+        return Cast<BoolValue>(value).NativeValue() ? has_true_ : has_false_;
+      case ValueKind::kInt:
+      case ValueKind::kUint:
+      case ValueKind::kDouble: {
+        Number number = *GetNumber(value);
+        if (number.LosslessConvertibleToInt()) {
+          return ints_.contains(number.AsInt());
+        }
+        if (number.LosslessConvertibleToUint()) {
+          return uints_.contains(number.AsUint());
+        }
+        return doubles_.contains(number.AsDouble());
+      }
+      case ValueKind::kString: {
+        std::string scratch;
+        return strings_.contains(
+            Cast<StringValue>(value).NativeString(scratch));
+      }
+      default:
+        // Equality between the indexed scalar kinds and any other kind is
+        // always false.
+        return false;
+    }
+  }
+
+ private:
+  absl::flat_hash_set<std::string> strings_;
+  absl::flat_hash_set<int64_t> ints_;
+  absl::flat_hash_set<uint64_t> uints_;
+  absl::flat_hash_set<double> doubles_;
+  bool has_true_ = false;
+  bool has_false_ = false;
+};
+
 absl::StatusOr<Value> SetsContains(ValueManager& value_factory,
                                    const ListValue& list,
                                    const ListValue& sublist) {
+  CEL_ASSIGN_OR_RETURN(size_t list_size, list.Size());
+  CEL_ASSIGN_OR_RETURN(size_t sublist_size, sublist.Size());
+  if (list_size * sublist_size > kIndexCostThreshold) {
+    CEL_ASSIGN_OR_RETURN(absl::optional<ScalarSetIndex> index,
+                         ScalarSetIndex::Build(value_factory, list));
+    if (index.has_value()) {
+      bool all_present = true;
+      CEL_RETURN_IF_ERROR(sublist.ForEach(
+          value_factory,
+          [&index, &all_present](const Value& element) -> absl::StatusOr<bool> {
+            all_present = index->Contains(element);
+            return all_present;
+          }));
+      return value_factory.CreateBoolValue(all_present);
+    }
+  }
   bool any_missing = false;
   CEL_RETURN_IF_ERROR(sublist.ForEach(
       value_factory,
@@ -50,6 +186,31 @@ absl::StatusOr<Value> SetsContains(ValueManager& value_factory,
 absl::StatusOr<Value> SetsIntersects(ValueManager& value_factory,
                                      const ListValue& list,
                                      const ListValue& sublist) {
+  CEL_ASSIGN_OR_RETURN(size_t list_size, list.Size());
+  CEL_ASSIGN_OR_RETURN(size_t sublist_size, sublist.Size());
+  if (list_size * sublist_size > kIndexCostThreshold) {
+    // Intersection is symmetric: index the smaller operand and probe with the
+    // larger, swapping roles if only the larger side is scalar-only.
+    const ListValue* index_side = list_size <= sublist_size ? &list : &sublist;
+    const ListValue* probe_side = list_size <= sublist_size ? &sublist : &list;
+    CEL_ASSIGN_OR_RETURN(absl::optional<ScalarSetIndex> index,
+                         ScalarSetIndex::Build(value_factory, *index_side));
+    if (!index.has_value()) {
+      CEL_ASSIGN_OR_RETURN(index,
+                           ScalarSetIndex::Build(value_factory, *probe_side));
+      std::swap(index_side, probe_side);
+    }
+    if (index.has_value()) {
+      bool exists = false;
+      CEL_RETURN_IF_ERROR(probe_side->ForEach(
+          value_factory,
+          [&index, &exists](const Value& element) -> absl::StatusOr<bool> {
+            exists = index->Contains(element);
+            return !exists;
+          }));
+      return value_factory.CreateBoolValue(exists);
+    }
+  }
   bool exists = false;
   CEL_RETURN_IF_ERROR(list.ForEach(
       value_factory,
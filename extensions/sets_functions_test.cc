@@ -159,6 +159,24 @@ INSTANTIATE_TEST_SUITE_P(
 
         {"sets.equivalent([{'foo': true, 'bar': false}], [{'bar': false, "
          "'foo': true}])"},
+
+        // Operands large enough to take the hash-indexed path instead of the
+        // nested scan.
+        {"sets.contains([0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, "
+         "15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29], "
+         "[10, 20.0, 3u])"},
+        {"!sets.contains([0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, "
+         "15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29], "
+         "[10, 'ten', 30])"},
+        {"sets.intersects([0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, "
+         "15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29], "
+         "[100, 29.0, 50])"},
+        {"!sets.intersects([0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, "
+         "14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29], "
+         "['a', 99, 100])"},
+        // Non-scalar elements at scale fall back to the scanning path.
+        {"sets.contains([[0], [1], [2], [3], [4], [5], [6], [7], [8], [9]], "
+         "[[0], [3], [5], [7], [9], [2], [4], [6]])"},
     }));
 
 }  // namespace
@@ -16,15 +16,18 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <string>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/ascii.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "common/casting.h"
 #include "common/type.h"
@@ -55,31 +58,36 @@ struct AppendToStringVisitor {
 
 absl::StatusOr<Value> Join2(ValueManager& value_manager, const ListValue& value,
                             const StringValue& separator) {
-  std::string result;
+  // Collect the elements up front so the result can be built with a single
+  // presized allocation instead of growing through repeated appends. The list
+  // is iterated exactly once, which matters for lazily produced lists.
+  std::vector<StringValue> elements;
+  size_t total_size = 0;
   CEL_ASSIGN_OR_RETURN(auto iterator, value.NewIterator(value_manager));
   Value element;
-  if (iterator->HasNext()) {
+  while (iterator->HasNext()) {
     CEL_RETURN_IF_ERROR(iterator->Next(value_manager, element));
     if (auto string_element = As<StringValue>(element); string_element) {
-      string_element->NativeValue(AppendToStringVisitor{result});
+      total_size += string_element->Size();
+      elements.push_back(std::move(*string_element));
     } else {
       return ErrorValue{
           runtime_internal::CreateNoMatchingOverloadError("join")};
     }
   }
+  if (!elements.empty()) {
+    total_size += (elements.size() - 1) * separator.Size();
+  }
   std::string separator_scratch;
   absl::string_view separator_view = separator.NativeString(separator_scratch);
-  while (iterator->HasNext()) {
-    result.append(separator_view);
-    CEL_RETURN_IF_ERROR(iterator->Next(value_manager, element));
-    if (auto string_element = As<StringValue>(element); string_element) {
-      string_element->NativeValue(AppendToStringVisitor{result});
-    } else {
-      return ErrorValue{
-          runtime_internal::CreateNoMatchingOverloadError("join")};
+  std::string result;
+  result.reserve(total_size);
+  for (size_t i = 0; i < elements.size(); ++i) {
+    if (i > 0) {
+      result.append(separator_view);
     }
+    elements[i].NativeValue(AppendToStringVisitor{result});
   }
-  result.shrink_to_fit();
   // We assume the original string was well-formed.
   return value_manager.CreateUncheckedStringValue(std::move(result));
 }
@@ -208,6 +216,169 @@ absl::StatusOr<Value> Split2(ValueManager& value_manager,
   return Split3(value_manager, string, delimiter, -1);
 }
 
+// True when every byte is ASCII, in which case code point indices coincide
+// with byte indices and the indexing functions need no decoding. Checked a
+// word at a time; the compiler vectorizes the main loop.
+bool IsAllAscii(absl::string_view string) {
+  constexpr uint64_t kHighBits = 0x8080808080808080u;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= string.size(); i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, string.data() + i, sizeof(word));
+    if ((word & kHighBits) != 0) {
+      return false;
+    }
+  }
+  for (; i < string.size(); ++i) {
+    if ((static_cast<unsigned char>(string[i]) & 0x80) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Byte offset of the code point at `index` (which must be non-negative), or
+// npos when the string has fewer than `index` code points. An offset equal
+// to the string size is returned for `index` equal to the code point count.
+size_t CodePointToByteOffset(absl::string_view string, int64_t index) {
+  size_t offset = 0;
+  while (index > 0 && offset < string.size()) {
+    offset += internal::Utf8Decode(string.substr(offset)).second;
+    --index;
+  }
+  return index == 0 ? offset : absl::string_view::npos;
+}
+
+absl::StatusOr<Value> CharAt(ValueManager& value_manager,
+                             const StringValue& string, int64_t index) {
+  if (index < 0) {
+    return ErrorValue{absl::InvalidArgumentError(
+        absl::StrCat("index out of range: ", index))};
+  }
+  std::string scratch;
+  absl::string_view view = string.NativeString(scratch);
+  if (IsAllAscii(view)) {
+    if (static_cast<size_t>(index) > view.size()) {
+      return ErrorValue{absl::InvalidArgumentError(
+          absl::StrCat("index out of range: ", index))};
+    }
+    if (static_cast<size_t>(index) == view.size()) {
+      return StringValue{};
+    }
+    return value_manager.CreateUncheckedStringValue(view.substr(index, 1));
+  }
+  size_t offset = CodePointToByteOffset(view, index);
+  if (offset == absl::string_view::npos) {
+    return ErrorValue{absl::InvalidArgumentError(
+        absl::StrCat("index out of range: ", index))};
+  }
+  if (offset == view.size()) {
+    return StringValue{};
+  }
+  size_t count = internal::Utf8Decode(view.substr(offset)).second;
+  // We assume the original string was well-formed.
+  return value_manager.CreateUncheckedStringValue(view.substr(offset, count));
+}
+
+absl::StatusOr<Value> IndexOf3(ValueManager& value_manager,
+                               const StringValue& string,
+                               const StringValue& substring, int64_t offset) {
+  if (offset < 0) {
+    return ErrorValue{absl::InvalidArgumentError(
+        absl::StrCat("index out of range: ", offset))};
+  }
+  std::string scratch;
+  absl::string_view view = string.NativeString(scratch);
+  std::string substring_scratch;
+  absl::string_view substring_view =
+      substring.NativeString(substring_scratch);
+  if (IsAllAscii(view)) {
+    if (static_cast<size_t>(offset) > view.size()) {
+      return ErrorValue{absl::InvalidArgumentError(
+          absl::StrCat("index out of range: ", offset))};
+    }
+    size_t pos = view.find(substring_view, offset);
+    return value_manager.CreateIntValue(
+        pos == absl::string_view::npos ? -1 : static_cast<int64_t>(pos));
+  }
+  size_t byte_offset = CodePointToByteOffset(view, offset);
+  if (byte_offset == absl::string_view::npos) {
+    return ErrorValue{absl::InvalidArgumentError(
+        absl::StrCat("index out of range: ", offset))};
+  }
+  // A byte-wise search is code point aligned: UTF-8 is self-synchronizing, so
+  // a well-formed needle can only match at a code point boundary.
+  size_t pos = view.find(substring_view, byte_offset);
+  if (pos == absl::string_view::npos) {
+    return value_manager.CreateIntValue(-1);
+  }
+  return value_manager.CreateIntValue(
+      static_cast<int64_t>(internal::Utf8CodePointCount(view.substr(0, pos))));
+}
+
+absl::StatusOr<Value> IndexOf2(ValueManager& value_manager,
+                               const StringValue& string,
+                               const StringValue& substring) {
+  return IndexOf3(value_manager, string, substring, 0);
+}
+
+absl::StatusOr<Value> Substring3(ValueManager& value_manager,
+                                 const StringValue& string, int64_t start,
+                                 int64_t end) {
+  if (start < 0 || end < start) {
+    return ErrorValue{absl::InvalidArgumentError(absl::StrCat(
+        "invalid substring range. start: ", start, ", end: ", end))};
+  }
+  std::string scratch;
+  absl::string_view view = string.NativeString(scratch);
+  if (IsAllAscii(view)) {
+    if (static_cast<size_t>(end) > view.size()) {
+      return ErrorValue{absl::InvalidArgumentError(
+          absl::StrCat("index out of range: ", end))};
+    }
+    return value_manager.CreateUncheckedStringValue(
+        view.substr(start, end - start));
+  }
+  size_t start_offset = CodePointToByteOffset(view, start);
+  if (start_offset == absl::string_view::npos) {
+    return ErrorValue{absl::InvalidArgumentError(
+        absl::StrCat("index out of range: ", start))};
+  }
+  size_t length =
+      CodePointToByteOffset(view.substr(start_offset), end - start);
+  if (length == absl::string_view::npos) {
+    return ErrorValue{absl::InvalidArgumentError(
+        absl::StrCat("index out of range: ", end))};
+  }
+  // We assume the original string was well-formed.
+  return value_manager.CreateUncheckedStringValue(
+      view.substr(start_offset, length));
+}
+
+absl::StatusOr<Value> Substring2(ValueManager& value_manager,
+                                 const StringValue& string, int64_t start) {
+  if (start < 0) {
+    return ErrorValue{absl::InvalidArgumentError(
+        absl::StrCat("index out of range: ", start))};
+  }
+  std::string scratch;
+  absl::string_view view = string.NativeString(scratch);
+  if (IsAllAscii(view)) {
+    if (static_cast<size_t>(start) > view.size()) {
+      return ErrorValue{absl::InvalidArgumentError(
+          absl::StrCat("index out of range: ", start))};
+    }
+    return value_manager.CreateUncheckedStringValue(view.substr(start));
+  }
+  size_t start_offset = CodePointToByteOffset(view, start);
+  if (start_offset == absl::string_view::npos) {
+    return ErrorValue{absl::InvalidArgumentError(
+        absl::StrCat("index out of range: ", start))};
+  }
+  // We assume the original string was well-formed.
+  return value_manager.CreateUncheckedStringValue(view.substr(start_offset));
+}
+
 absl::StatusOr<Value> LowerAscii(ValueManager& value_manager,
                                  const StringValue& string) {
   std::string content = string.NativeString();
@@ -246,6 +417,33 @@ absl::Status RegisterStringsFunctions(FunctionRegistry& registry,
           CreateDescriptor("lowerAscii", /*receiver_style=*/true),
       UnaryFunctionAdapter<absl::StatusOr<Value>, StringValue>::WrapFunction(
           LowerAscii)));
+  CEL_RETURN_IF_ERROR(registry.Register(
+      BinaryFunctionAdapter<absl::StatusOr<Value>, StringValue, int64_t>::
+          CreateDescriptor("charAt", /*receiver_style=*/true),
+      BinaryFunctionAdapter<absl::StatusOr<Value>, StringValue,
+                            int64_t>::WrapFunction(CharAt)));
+  CEL_RETURN_IF_ERROR(registry.Register(
+      BinaryFunctionAdapter<absl::StatusOr<Value>, StringValue, StringValue>::
+          CreateDescriptor("indexOf", /*receiver_style=*/true),
+      BinaryFunctionAdapter<absl::StatusOr<Value>, StringValue,
+                            StringValue>::WrapFunction(IndexOf2)));
+  CEL_RETURN_IF_ERROR(registry.Register(
+      VariadicFunctionAdapter<
+          absl::StatusOr<Value>, StringValue, StringValue,
+          int64_t>::CreateDescriptor("indexOf", /*receiver_style=*/true),
+      VariadicFunctionAdapter<absl::StatusOr<Value>, StringValue, StringValue,
+                              int64_t>::WrapFunction(IndexOf3)));
+  CEL_RETURN_IF_ERROR(registry.Register(
+      BinaryFunctionAdapter<absl::StatusOr<Value>, StringValue, int64_t>::
+          CreateDescriptor("substring", /*receiver_style=*/true),
+      BinaryFunctionAdapter<absl::StatusOr<Value>, StringValue,
+                            int64_t>::WrapFunction(Substring2)));
+  CEL_RETURN_IF_ERROR(registry.Register(
+      VariadicFunctionAdapter<
+          absl::StatusOr<Value>, StringValue, int64_t,
+          int64_t>::CreateDescriptor("substring", /*receiver_style=*/true),
+      VariadicFunctionAdapter<absl::StatusOr<Value>, StringValue, int64_t,
+                              int64_t>::WrapFunction(Substring3)));
   return absl::OkStatus();
 }
 
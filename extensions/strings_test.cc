@@ -68,5 +68,122 @@ TEST(Strings, SplitWithEmptyDelimiterCord) {
   EXPECT_TRUE(result.As<BoolValue>().NativeValue());
 }
 
+TEST(Strings, JoinWithSeparator) {
+  MemoryManagerRef memory_manager = MemoryManagerRef::ReferenceCounting();
+  const auto options = RuntimeOptions{};
+  ASSERT_OK_AND_ASSIGN(auto builder, CreateStandardRuntimeBuilder(options));
+  EXPECT_OK(RegisterStringsFunctions(builder.function_registry(), options));
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(
+      ParsedExpr expr,
+      Parse("['hello', 'world', '!'].join(' ') == 'hello world !' && "
+            "[].join('-') == '' && ['solo'].join('-') == 'solo'",
+            "<input>", ParserOptions{}));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  common_internal::LegacyValueManager value_factory(memory_manager,
+                                                    runtime->GetTypeProvider());
+
+  Activation activation;
+
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       program->Evaluate(activation, value_factory));
+  ASSERT_TRUE(result.Is<BoolValue>());
+  EXPECT_TRUE(result.As<BoolValue>().NativeValue());
+}
+
+TEST(Strings, CharAtIndexOfSubstringAscii) {
+  MemoryManagerRef memory_manager = MemoryManagerRef::ReferenceCounting();
+  const auto options = RuntimeOptions{};
+  ASSERT_OK_AND_ASSIGN(auto builder, CreateStandardRuntimeBuilder(options));
+  EXPECT_OK(RegisterStringsFunctions(builder.function_registry(), options));
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(
+      ParsedExpr expr,
+      Parse("'hello world'.charAt(4) == 'o' && "
+            "'hello world'.charAt(11) == '' && "
+            "'hello world'.indexOf('world') == 6 && "
+            "'hello world'.indexOf('o', 5) == 7 && "
+            "'hello world'.indexOf('nope') == -1 && "
+            "'hello world'.substring(6) == 'world' && "
+            "'hello world'.substring(0, 5) == 'hello'",
+            "<input>", ParserOptions{}));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  common_internal::LegacyValueManager value_factory(memory_manager,
+                                                    runtime->GetTypeProvider());
+
+  Activation activation;
+
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       program->Evaluate(activation, value_factory));
+  ASSERT_TRUE(result.Is<BoolValue>());
+  EXPECT_TRUE(result.As<BoolValue>().NativeValue());
+}
+
+TEST(Strings, CharAtIndexOfSubstringNonAscii) {
+  MemoryManagerRef memory_manager = MemoryManagerRef::ReferenceCounting();
+  const auto options = RuntimeOptions{};
+  ASSERT_OK_AND_ASSIGN(auto builder, CreateStandardRuntimeBuilder(options));
+  EXPECT_OK(RegisterStringsFunctions(builder.function_registry(), options));
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  // Indices are code points, not bytes.
+  ASSERT_OK_AND_ASSIGN(
+      ParsedExpr expr,
+      Parse("'héllo wörld'.charAt(1) == 'é' && "
+            "'héllo wörld'.indexOf('wörld') == 6 && "
+            "'héllo wörld'.indexOf('ö', 2) == 7 && "
+            "'héllo wörld'.substring(6) == 'wörld' && "
+            "'héllo wörld'.substring(1, 2) == 'é'",
+            "<input>", ParserOptions{}));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  common_internal::LegacyValueManager value_factory(memory_manager,
+                                                    runtime->GetTypeProvider());
+
+  Activation activation;
+
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       program->Evaluate(activation, value_factory));
+  ASSERT_TRUE(result.Is<BoolValue>());
+  EXPECT_TRUE(result.As<BoolValue>().NativeValue());
+}
+
+TEST(Strings, CharAtOutOfRangeIsError) {
+  MemoryManagerRef memory_manager = MemoryManagerRef::ReferenceCounting();
+  const auto options = RuntimeOptions{};
+  ASSERT_OK_AND_ASSIGN(auto builder, CreateStandardRuntimeBuilder(options));
+  EXPECT_OK(RegisterStringsFunctions(builder.function_registry(), options));
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr expr, Parse("'hello'.charAt(6)", "<input>",
+                                              ParserOptions{}));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  common_internal::LegacyValueManager value_factory(memory_manager,
+                                                    runtime->GetTypeProvider());
+
+  Activation activation;
+
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       program->Evaluate(activation, value_factory));
+  EXPECT_TRUE(result.Is<ErrorValue>());
+}
+
 }  // namespace
 }  // namespace cel::extensions
@@ -15,6 +15,58 @@
 #ifndef THIRD_PARTY_CEL_CPP_INTERNAL_BENCHMARK_H_
 #define THIRD_PARTY_CEL_CPP_INTERNAL_BENCHMARK_H_
 
+#include <cstdint>
+
 #include "benchmark/benchmark.h"  // IWYU pragma: export
 
+namespace cel::internal {
+
+// Number of heap allocations (operator new calls) made by the calling thread
+// so far. Monotonically increasing; measure a region by taking a delta.
+//
+// Counting is implemented by a replacement operator new that lives in the
+// same object file as this function, so any benchmark binary that uses the
+// allocation accounting below links the counting allocator automatically.
+int64_t ThreadHeapAllocationCount();
+
+// Accounts heap allocations across the measured region of a benchmark and
+// reports the per-iteration average as the "allocs_per_iter" counter. If
+// max_allocs_per_iteration is non-negative and the average exceeds it, the
+// benchmark run is failed, turning allocation regressions in hot paths into
+// test failures rather than silent slowdowns.
+//
+// Construct after setup and let the destructor (after the measurement loop)
+// report and enforce the budget:
+//
+//   void BM_Foo(benchmark::State& state) {
+//     ...setup (not counted)...
+//     AllocationCounter counter(state, /*max_allocs_per_iteration=*/2);
+//     for (auto _ : state) { ...measured work... }
+//   }
+//
+// Only allocations made by the benchmark thread are counted; benchmarks
+// using ->Threads() should not rely on the reported counter.
+class AllocationCounter {
+ public:
+  explicit AllocationCounter(benchmark::State& state,
+                             int64_t max_allocs_per_iteration = -1);
+
+  AllocationCounter(const AllocationCounter&) = delete;
+  AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+  ~AllocationCounter();
+
+ private:
+  benchmark::State& state_;
+  int64_t max_allocs_per_iteration_;
+  int64_t start_count_;
+};
+
+// Reports bytes drawn from an arena across the whole run as the
+// "arena_bytes_per_iter" counter. Call after the measurement loop with
+// arena.SpaceUsed() for benchmarks that evaluate into a shared arena.
+void ReportArenaBytesPerIteration(benchmark::State& state, int64_t space_used);
+
+}  // namespace cel::internal
+
 #endif  // THIRD_PARTY_CEL_CPP_INTERNAL_BENCHMARK_H_
@@ -0,0 +1,151 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Per-thread heap allocation accounting for benchmarks, via replacement
+// global operator new/delete. The replacement operators live in this
+// translation unit together with ThreadHeapAllocationCount and
+// AllocationCounter, so linking happens exactly for binaries that use the
+// accounting API: referencing any of those symbols pulls this object file
+// (and with it the counting allocator) into the binary.
+
+#include "internal/benchmark.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "absl/strings/str_cat.h"
+
+namespace cel::internal {
+
+namespace {
+
+thread_local int64_t thread_heap_allocation_count = 0;
+
+void* CountedAllocate(std::size_t size) {
+  ++thread_heap_allocation_count;
+  if (size == 0) {
+    size = 1;
+  }
+  void* pointer = std::malloc(size);
+  if (pointer == nullptr) {
+    throw std::bad_alloc();
+  }
+  return pointer;
+}
+
+void* CountedAllocateAligned(std::size_t size, std::size_t alignment) {
+  ++thread_heap_allocation_count;
+  // aligned_alloc requires the size to be a multiple of the alignment.
+  size = (size + alignment - 1) & ~(alignment - 1);
+  if (size == 0) {
+    size = alignment;
+  }
+  void* pointer = std::aligned_alloc(alignment, size);
+  if (pointer == nullptr) {
+    throw std::bad_alloc();
+  }
+  return pointer;
+}
+
+}  // namespace
+
+int64_t ThreadHeapAllocationCount() { return thread_heap_allocation_count; }
+
+AllocationCounter::AllocationCounter(benchmark::State& state,
+                                     int64_t max_allocs_per_iteration)
+    : state_(state),
+      max_allocs_per_iteration_(max_allocs_per_iteration),
+      start_count_(ThreadHeapAllocationCount()) {}
+
+AllocationCounter::~AllocationCounter() {
+  int64_t iterations = static_cast<int64_t>(state_.iterations());
+  if (iterations <= 0) {
+    return;
+  }
+  int64_t allocs_per_iter =
+      (ThreadHeapAllocationCount() - start_count_) / iterations;
+  state_.counters["allocs_per_iter"] =
+      benchmark::Counter(static_cast<double>(allocs_per_iter));
+  if (max_allocs_per_iteration_ >= 0 &&
+      allocs_per_iter > max_allocs_per_iteration_) {
+    std::string error =
+        absl::StrCat("allocation budget exceeded: ", allocs_per_iter,
+                     " allocs/iteration, budget ", max_allocs_per_iteration_);
+    state_.SkipWithError(error.c_str());
+  }
+}
+
+void ReportArenaBytesPerIteration(benchmark::State& state,
+                                  int64_t space_used) {
+  int64_t iterations = static_cast<int64_t>(state.iterations());
+  if (iterations <= 0) {
+    return;
+  }
+  state.counters["arena_bytes_per_iter"] =
+      benchmark::Counter(static_cast<double>(space_used / iterations));
+}
+
+}  // namespace cel::internal
+
+// Replacement allocation functions. Deallocation must be replaced alongside
+// allocation since the counted allocations come from malloc/aligned_alloc.
+
+void* operator new(std::size_t size) {
+  return cel::internal::CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size) {
+  return cel::internal::CountedAllocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return cel::internal::CountedAllocateAligned(
+      size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return cel::internal::CountedAllocateAligned(
+      size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+  std::free(pointer);
+}
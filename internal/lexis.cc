@@ -14,50 +14,32 @@
 
 #include "internal/lexis.h"
 
-#include "absl/base/call_once.h"
-#include "absl/base/macros.h"
-#include "absl/container/flat_hash_set.h"
+#include <algorithm>
+#include <iterator>
+
 #include "absl/strings/ascii.h"
+#include "absl/strings/string_view.h"
 
 namespace cel::internal {
 
 namespace {
 
-ABSL_CONST_INIT absl::once_flag reserved_keywords_once_flag = {};
-ABSL_CONST_INIT absl::flat_hash_set<absl::string_view>* reserved_keywords =
-    nullptr;
-
-void InitializeReservedKeywords() {
-  ABSL_ASSERT(reserved_keywords == nullptr);
-  reserved_keywords = new absl::flat_hash_set<absl::string_view>();
-  reserved_keywords->insert("false");
-  reserved_keywords->insert("true");
-  reserved_keywords->insert("null");
-  reserved_keywords->insert("in");
-  reserved_keywords->insert("as");
-  reserved_keywords->insert("break");
-  reserved_keywords->insert("const");
-  reserved_keywords->insert("continue");
-  reserved_keywords->insert("else");
-  reserved_keywords->insert("for");
-  reserved_keywords->insert("function");
-  reserved_keywords->insert("if");
-  reserved_keywords->insert("import");
-  reserved_keywords->insert("let");
-  reserved_keywords->insert("loop");
-  reserved_keywords->insert("package");
-  reserved_keywords->insert("namespace");
-  reserved_keywords->insert("return");
-  reserved_keywords->insert("var");
-  reserved_keywords->insert("void");
-  reserved_keywords->insert("while");
-}
+// Reserved keywords, sorted so membership can be tested with a binary
+// search. The table is built entirely at compile time: `LexisIsReserved` is
+// on the parse hot path for every identifier token, so it must not pay for
+// lazy initialization or hashing.
+constexpr absl::string_view kReservedKeywords[] = {
+    "as",        "break", "const",  "continue", "else",   "false", "for",
+    "function",  "if",    "import", "in",       "let",    "loop",
+    "namespace", "null",  "package", "return",  "true",   "var",
+    "void",      "while",
+};
 
 }  // namespace
 
 bool LexisIsReserved(absl::string_view text) {
-  absl::call_once(reserved_keywords_once_flag, InitializeReservedKeywords);
-  return reserved_keywords->find(text) != reserved_keywords->end();
+  return std::binary_search(std::begin(kReservedKeywords),
+                            std::end(kReservedKeywords), text);
 }
 
 bool LexisIsIdentifier(absl::string_view text) {
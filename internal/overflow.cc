@@ -49,16 +49,47 @@ const int64_t kMinUnixTime =
 const int64_t kMaxUnixTime =
     absl::ToInt64Seconds(MaxTimestamp() - absl::UnixEpoch());
 
-absl::Status CheckRange(bool valid_expression,
-                        absl::string_view error_message) {
-  return valid_expression ? absl::OkStatus()
-                          : absl::OutOfRangeError(error_message);
+// Pooled statuses for the fixed error messages produced below. Checked
+// arithmetic sits on the evaluator's hot path and its errors are frequently
+// discarded again (e.g. a short-circuited branch of `||`), so a failed check
+// copies a preallocated status — a reference count update — instead of
+// allocating a fresh one each time.
+struct PooledStatuses {
+  const absl::Status integer_overflow =
+      absl::OutOfRangeError("integer overflow");
+  const absl::Status unsigned_integer_overflow =
+      absl::OutOfRangeError("unsigned integer overflow");
+  const absl::Status timestamp_overflow =
+      absl::OutOfRangeError("timestamp overflow");
+  const absl::Status divide_by_zero =
+      absl::InvalidArgumentError("divide by zero");
+  const absl::Status modulus_by_zero =
+      absl::InvalidArgumentError("modulus by zero");
+  const absl::Status double_out_of_int64_range =
+      absl::OutOfRangeError("double out of int64_t range");
+  const absl::Status double_out_of_uint64_range =
+      absl::OutOfRangeError("double out of uint64_t range");
+  const absl::Status int64_out_of_uint64_range =
+      absl::OutOfRangeError("int64 out of uint64_t range");
+  const absl::Status int64_out_of_int32_range =
+      absl::OutOfRangeError("int64 out of int32_t range");
+  const absl::Status uint64_out_of_int64_range =
+      absl::OutOfRangeError("uint64 out of int64_t range");
+  const absl::Status uint64_out_of_uint32_range =
+      absl::OutOfRangeError("uint64 out of uint32_t range");
+};
+
+const PooledStatuses& Pooled() {
+  static const auto* const kPooled = new PooledStatuses;
+  return *kPooled;
 }
 
-absl::Status CheckArgument(bool valid_expression,
-                           absl::string_view error_message) {
-  return valid_expression ? absl::OkStatus()
-                          : absl::InvalidArgumentError(error_message);
+absl::Status CheckRange(bool valid_expression, const absl::Status& error) {
+  return valid_expression ? absl::OkStatus() : error;
+}
+
+absl::Status CheckArgument(bool valid_expression, const absl::Status& error) {
+  return valid_expression ? absl::OkStatus() : error;
 }
 
 // Determine whether the duration is finite.
@@ -79,10 +110,11 @@ absl::StatusOr<int64_t> CheckedAdd(int64_t x, int64_t y) {
   if (!__builtin_add_overflow(x, y, &sum)) {
     return sum;
   }
-  return absl::OutOfRangeError("integer overflow");
+  return Pooled().integer_overflow;
 #else
-  CEL_RETURN_IF_ERROR(CheckRange(
-      y > 0 ? x <= kInt64Max - y : x >= kInt64Min - y, "integer overflow"));
+  CEL_RETURN_IF_ERROR(
+      CheckRange(y > 0 ? x <= kInt64Max - y : x >= kInt64Min - y,
+                 Pooled().integer_overflow));
   return x + y;
 #endif
 }
@@ -93,10 +125,11 @@ absl::StatusOr<int64_t> CheckedSub(int64_t x, int64_t y) {
   if (!__builtin_sub_overflow(x, y, &diff)) {
     return diff;
   }
-  return absl::OutOfRangeError("integer overflow");
+  return Pooled().integer_overflow;
 #else
-  CEL_RETURN_IF_ERROR(CheckRange(
-      y < 0 ? x <= kInt64Max + y : x >= kInt64Min + y, "integer overflow"));
+  CEL_RETURN_IF_ERROR(
+      CheckRange(y < 0 ? x <= kInt64Max + y : x >= kInt64Min + y,
+                 Pooled().integer_overflow));
   return x - y;
 #endif
 }
@@ -107,9 +140,9 @@ absl::StatusOr<int64_t> CheckedNegation(int64_t v) {
   if (!__builtin_mul_overflow(v, -1, &prod)) {
     return prod;
   }
-  return absl::OutOfRangeError("integer overflow");
+  return Pooled().integer_overflow;
 #else
-  CEL_RETURN_IF_ERROR(CheckRange(v != kInt64Min, "integer overflow"));
+  CEL_RETURN_IF_ERROR(CheckRange(v != kInt64Min, Pooled().integer_overflow));
   return -v;
 #endif
 }
@@ -120,7 +153,7 @@ absl::StatusOr<int64_t> CheckedMul(int64_t x, int64_t y) {
   if (!__builtin_mul_overflow(x, y, &prod)) {
     return prod;
   }
-  return absl::OutOfRangeError("integer overflow");
+  return Pooled().integer_overflow;
 #else
   CEL_RETURN_IF_ERROR(
       CheckRange(!((x == -1 && y == kInt64Min) || (y == -1 && x == kInt64Min) ||
@@ -130,22 +163,22 @@ absl::StatusOr<int64_t> CheckedMul(int64_t x, int64_t y) {
                    // or y is positive as the divisor.
                    (x > 0 && y < 0 && y < kInt64Min / x) ||
                    (x < 0 && y > 0 && x < kInt64Min / y)),
-                 "integer overflow"));
+                 Pooled().integer_overflow));
   return x * y;
 #endif
 }
 
 absl::StatusOr<int64_t> CheckedDiv(int64_t x, int64_t y) {
   CEL_RETURN_IF_ERROR(
-      CheckRange(x != kInt64Min || y != -1, "integer overflow"));
-  CEL_RETURN_IF_ERROR(CheckArgument(y != 0, "divide by zero"));
+      CheckRange(x != kInt64Min || y != -1, Pooled().integer_overflow));
+  CEL_RETURN_IF_ERROR(CheckArgument(y != 0, Pooled().divide_by_zero));
   return x / y;
 }
 
 absl::StatusOr<int64_t> CheckedMod(int64_t x, int64_t y) {
   CEL_RETURN_IF_ERROR(
-      CheckRange(x != kInt64Min || y != -1, "integer overflow"));
-  CEL_RETURN_IF_ERROR(CheckArgument(y != 0, "modulus by zero"));
+      CheckRange(x != kInt64Min || y != -1, Pooled().integer_overflow));
+  CEL_RETURN_IF_ERROR(CheckArgument(y != 0, Pooled().modulus_by_zero));
   return x % y;
 }
 
@@ -155,10 +188,10 @@ absl::StatusOr<uint64_t> CheckedAdd(uint64_t x, uint64_t y) {
   if (!__builtin_add_overflow(x, y, &sum)) {
     return sum;
   }
-  return absl::OutOfRangeError("unsigned integer overflow");
+  return Pooled().unsigned_integer_overflow;
 #else
   CEL_RETURN_IF_ERROR(
-      CheckRange(x <= kUint64Max - y, "unsigned integer overflow"));
+      CheckRange(x <= kUint64Max - y, Pooled().unsigned_integer_overflow));
   return x + y;
 #endif
 }
@@ -169,9 +202,9 @@ absl::StatusOr<uint64_t> CheckedSub(uint64_t x, uint64_t y) {
   if (!__builtin_sub_overflow(x, y, &diff)) {
     return diff;
   }
-  return absl::OutOfRangeError("unsigned integer overflow");
+  return Pooled().unsigned_integer_overflow;
 #else
-  CEL_RETURN_IF_ERROR(CheckRange(y <= x, "unsigned integer overflow"));
+  CEL_RETURN_IF_ERROR(CheckRange(y <= x, Pooled().unsigned_integer_overflow));
   return x - y;
 #endif
 }
@@ -182,27 +215,124 @@ absl::StatusOr<uint64_t> CheckedMul(uint64_t x, uint64_t y) {
   if (!__builtin_mul_overflow(x, y, &prod)) {
     return prod;
   }
-  return absl::OutOfRangeError("unsigned integer overflow");
+  return Pooled().unsigned_integer_overflow;
 #else
   CEL_RETURN_IF_ERROR(
-      CheckRange(y == 0 || x <= kUint64Max / y, "unsigned integer overflow"));
+      CheckRange(y == 0 || x <= kUint64Max / y,
+                 Pooled().unsigned_integer_overflow));
   return x * y;
 #endif
 }
 
 absl::StatusOr<uint64_t> CheckedDiv(uint64_t x, uint64_t y) {
-  CEL_RETURN_IF_ERROR(CheckArgument(y != 0, "divide by zero"));
+  CEL_RETURN_IF_ERROR(CheckArgument(y != 0, Pooled().divide_by_zero));
   return x / y;
 }
 
 absl::StatusOr<uint64_t> CheckedMod(uint64_t x, uint64_t y) {
-  CEL_RETURN_IF_ERROR(CheckArgument(y != 0, "modulus by zero"));
+  CEL_RETURN_IF_ERROR(CheckArgument(y != 0, Pooled().modulus_by_zero));
   return x % y;
 }
 
+bool AddOverflow(int64_t x, int64_t y, int64_t* result) {
+#if ABSL_HAVE_BUILTIN(__builtin_add_overflow)
+  return __builtin_add_overflow(x, y, result);
+#else
+  if (y > 0 ? x > kInt64Max - y : x < kInt64Min - y) {
+    return true;
+  }
+  *result = x + y;
+  return false;
+#endif
+}
+
+bool SubOverflow(int64_t x, int64_t y, int64_t* result) {
+#if ABSL_HAVE_BUILTIN(__builtin_sub_overflow)
+  return __builtin_sub_overflow(x, y, result);
+#else
+  if (y < 0 ? x > kInt64Max + y : x < kInt64Min + y) {
+    return true;
+  }
+  *result = x - y;
+  return false;
+#endif
+}
+
+bool MulOverflow(int64_t x, int64_t y, int64_t* result) {
+#if ABSL_HAVE_BUILTIN(__builtin_mul_overflow)
+  return __builtin_mul_overflow(x, y, result);
+#else
+  if ((x == -1 && y == kInt64Min) || (y == -1 && x == kInt64Min) ||
+      (x > 0 && y > 0 && x > kInt64Max / y) ||
+      (x < 0 && y < 0 && x < kInt64Max / y) ||
+      (x > 0 && y < 0 && y < kInt64Min / x) ||
+      (x < 0 && y > 0 && x < kInt64Min / y)) {
+    return true;
+  }
+  *result = x * y;
+  return false;
+#endif
+}
+
+bool NegationOverflow(int64_t v, int64_t* result) {
+#if ABSL_HAVE_BUILTIN(__builtin_sub_overflow)
+  return __builtin_sub_overflow(int64_t{0}, v, result);
+#else
+  if (v == kInt64Min) {
+    return true;
+  }
+  *result = -v;
+  return false;
+#endif
+}
+
+bool AddOverflow(uint64_t x, uint64_t y, uint64_t* result) {
+#if ABSL_HAVE_BUILTIN(__builtin_add_overflow)
+  return __builtin_add_overflow(x, y, result);
+#else
+  if (x > kUint64Max - y) {
+    return true;
+  }
+  *result = x + y;
+  return false;
+#endif
+}
+
+bool SubOverflow(uint64_t x, uint64_t y, uint64_t* result) {
+#if ABSL_HAVE_BUILTIN(__builtin_sub_overflow)
+  return __builtin_sub_overflow(x, y, result);
+#else
+  if (y > x) {
+    return true;
+  }
+  *result = x - y;
+  return false;
+#endif
+}
+
+bool MulOverflow(uint64_t x, uint64_t y, uint64_t* result) {
+#if ABSL_HAVE_BUILTIN(__builtin_mul_overflow)
+  return __builtin_mul_overflow(x, y, result);
+#else
+  if (y != 0 && x > kUint64Max / y) {
+    return true;
+  }
+  *result = x * y;
+  return false;
+#endif
+}
+
+const absl::Status& IntegerOverflowError() {
+  return Pooled().integer_overflow;
+}
+
+const absl::Status& UnsignedIntegerOverflowError() {
+  return Pooled().unsigned_integer_overflow;
+}
+
 absl::StatusOr<absl::Duration> CheckedAdd(absl::Duration x, absl::Duration y) {
   CEL_RETURN_IF_ERROR(
-      CheckRange(IsFinite(x) && IsFinite(y), "integer overflow"));
+      CheckRange(IsFinite(x) && IsFinite(y), Pooled().integer_overflow));
   // absl::Duration can handle +- infinite durations, but the Go time.Duration
   // implementation caps the durations to those expressible within a single
   // int64_t rather than (seconds int64_t, nanos int32_t).
@@ -221,14 +351,14 @@ absl::StatusOr<absl::Duration> CheckedAdd(absl::Duration x, absl::Duration y) {
 
 absl::StatusOr<absl::Duration> CheckedSub(absl::Duration x, absl::Duration y) {
   CEL_RETURN_IF_ERROR(
-      CheckRange(IsFinite(x) && IsFinite(y), "integer overflow"));
+      CheckRange(IsFinite(x) && IsFinite(y), Pooled().integer_overflow));
   CEL_ASSIGN_OR_RETURN(int64_t nanos, CheckedSub(absl::ToInt64Nanoseconds(x),
                                                  absl::ToInt64Nanoseconds(y)));
   return absl::Nanoseconds(nanos);
 }
 
 absl::StatusOr<absl::Duration> CheckedNegation(absl::Duration v) {
-  CEL_RETURN_IF_ERROR(CheckRange(IsFinite(v), "integer overflow"));
+  CEL_RETURN_IF_ERROR(CheckRange(IsFinite(v), Pooled().integer_overflow));
   CEL_ASSIGN_OR_RETURN(int64_t nanos,
                        CheckedNegation(absl::ToInt64Nanoseconds(v)));
   return absl::Nanoseconds(nanos);
@@ -236,7 +366,7 @@ absl::StatusOr<absl::Duration> CheckedNegation(absl::Duration v) {
 
 absl::StatusOr<absl::Time> CheckedAdd(absl::Time t, absl::Duration d) {
   CEL_RETURN_IF_ERROR(
-      CheckRange(IsFinite(t) && IsFinite(d), "timestamp overflow"));
+      CheckRange(IsFinite(t) && IsFinite(d), Pooled().timestamp_overflow));
   // First we break time into its components by truncating and subtracting.
   const int64_t s1 = absl::ToUnixSeconds(t);
   const int64_t ns1 = (t - absl::FromUnixSeconds(s1)) / absl::Nanoseconds(1);
@@ -266,7 +396,8 @@ absl::StatusOr<absl::Time> CheckedAdd(absl::Time t, absl::Duration d) {
   // Check if the the number of seconds from Unix epoch is within our acceptable
   // range.
   CEL_RETURN_IF_ERROR(
-      CheckRange(s >= kMinUnixTime && s <= kMaxUnixTime, "timestamp overflow"));
+      CheckRange(s >= kMinUnixTime && s <= kMaxUnixTime,
+                 Pooled().timestamp_overflow));
 
   // Return resulting time.
   return absl::FromUnixSeconds(s) + ns;
@@ -279,7 +410,7 @@ absl::StatusOr<absl::Time> CheckedSub(absl::Time t, absl::Duration d) {
 
 absl::StatusOr<absl::Duration> CheckedSub(absl::Time t1, absl::Time t2) {
   CEL_RETURN_IF_ERROR(
-      CheckRange(IsFinite(t1) && IsFinite(t2), "integer overflow"));
+      CheckRange(IsFinite(t1) && IsFinite(t2), Pooled().integer_overflow));
   // First we break time into its components by truncating and subtracting.
   const int64_t s1 = absl::ToUnixSeconds(t1);
   const int64_t ns1 = (t1 - absl::FromUnixSeconds(s1)) / absl::Nanoseconds(1);
@@ -302,37 +433,38 @@ absl::StatusOr<absl::Duration> CheckedSub(absl::Time t1, absl::Time t2) {
 absl::StatusOr<int64_t> CheckedDoubleToInt64(double v) {
   CEL_RETURN_IF_ERROR(
       CheckRange(std::isfinite(v) && v < kDoubleToIntMax && v > kDoubleToIntMin,
-                 "double out of int64_t range"));
+                 Pooled().double_out_of_int64_range));
   return static_cast<int64_t>(v);
 }
 
 absl::StatusOr<uint64_t> CheckedDoubleToUint64(double v) {
   CEL_RETURN_IF_ERROR(
       CheckRange(std::isfinite(v) && v >= 0 && v < kDoubleTwoTo64,
-                 "double out of uint64_t range"));
+                 Pooled().double_out_of_uint64_range));
   return static_cast<uint64_t>(v);
 }
 
 absl::StatusOr<uint64_t> CheckedInt64ToUint64(int64_t v) {
-  CEL_RETURN_IF_ERROR(CheckRange(v >= 0, "int64 out of uint64_t range"));
+  CEL_RETURN_IF_ERROR(CheckRange(v >= 0, Pooled().int64_out_of_uint64_range));
   return static_cast<uint64_t>(v);
 }
 
 absl::StatusOr<int32_t> CheckedInt64ToInt32(int64_t v) {
   CEL_RETURN_IF_ERROR(
-      CheckRange(v >= kInt32Min && v <= kInt32Max, "int64 out of int32_t range"));
+      CheckRange(v >= kInt32Min && v <= kInt32Max,
+                 Pooled().int64_out_of_int32_range));
   return static_cast<int32_t>(v);
 }
 
 absl::StatusOr<int64_t> CheckedUint64ToInt64(uint64_t v) {
   CEL_RETURN_IF_ERROR(
-      CheckRange(v <= kUintToIntMax, "uint64 out of int64_t range"));
+      CheckRange(v <= kUintToIntMax, Pooled().uint64_out_of_int64_range));
   return static_cast<int64_t>(v);
 }
 
 absl::StatusOr<uint32_t> CheckedUint64ToUint32(uint64_t v) {
   CEL_RETURN_IF_ERROR(
-      CheckRange(v <= kUint32Max, "uint64 out of uint32_t range"));
+      CheckRange(v <= kUint32Max, Pooled().uint64_out_of_uint32_range));
   return static_cast<uint32_t>(v);
 }
 
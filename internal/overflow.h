@@ -17,6 +17,7 @@
 
 #include <cstdint>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/time/time.h"
 
@@ -75,6 +76,27 @@ absl::StatusOr<uint64_t> CheckedDiv(uint64_t x, uint64_t y);
 // absl::StatusCode::kInvalidArgumentError, e.g. 1 / 0.
 absl::StatusOr<uint64_t> CheckedMod(uint64_t x, uint64_t y);
 
+// Flag-style variants of the checked integer helpers above, following the
+// `__builtin_*_overflow` convention: the result is written to `*result` and
+// the return value is true if the operation overflowed, in which case the
+// stored value is unspecified. The success path carries no status machinery
+// at all; a caller evaluating several operations can accumulate the flags
+// and materialize a single error afterwards from `IntegerOverflowError` or
+// `UnsignedIntegerOverflowError`.
+bool AddOverflow(int64_t x, int64_t y, int64_t* result);
+bool SubOverflow(int64_t x, int64_t y, int64_t* result);
+bool MulOverflow(int64_t x, int64_t y, int64_t* result);
+bool NegationOverflow(int64_t v, int64_t* result);
+bool AddOverflow(uint64_t x, uint64_t y, uint64_t* result);
+bool SubOverflow(uint64_t x, uint64_t y, uint64_t* result);
+bool MulOverflow(uint64_t x, uint64_t y, uint64_t* result);
+
+// Shared instances of the statuses the checked helpers produce on overflow,
+// for deferred-error callers of the flag-style variants; copying one is a
+// reference count update rather than a fresh allocation.
+const absl::Status& IntegerOverflowError();
+const absl::Status& UnsignedIntegerOverflowError();
+
 // Add two durations together.
 // If overflow is detected, return an absl::StatusCode::kOutOfRangeError, e.g.
 //   duration(int64_t_max, "ns") + duration(int64_t_max, "ns")
@@ -627,5 +627,54 @@ INSTANTIATE_TEST_SUITE_P(
     [](const testing::TestParamInfo<CheckedConvertUint64Uint32Test::ParamType>&
            info) { return info.param.test_name; });
 
+TEST(FlagStyleKernels, IntOperationsAgreeWithCheckedHelpers) {
+  constexpr int64_t kMax = std::numeric_limits<int64_t>::max();
+  constexpr int64_t kMin = std::numeric_limits<int64_t>::lowest();
+  int64_t result;
+
+  EXPECT_FALSE(AddOverflow(int64_t{1}, int64_t{2}, &result));
+  EXPECT_EQ(result, 3);
+  EXPECT_TRUE(AddOverflow(kMax, int64_t{1}, &result));
+
+  EXPECT_FALSE(SubOverflow(int64_t{1}, int64_t{2}, &result));
+  EXPECT_EQ(result, -1);
+  EXPECT_TRUE(SubOverflow(kMin, int64_t{1}, &result));
+
+  EXPECT_FALSE(MulOverflow(int64_t{-3}, int64_t{4}, &result));
+  EXPECT_EQ(result, -12);
+  EXPECT_TRUE(MulOverflow(kMax, int64_t{2}, &result));
+  EXPECT_TRUE(MulOverflow(kMin, int64_t{-1}, &result));
+
+  EXPECT_FALSE(NegationOverflow(int64_t{42}, &result));
+  EXPECT_EQ(result, -42);
+  EXPECT_TRUE(NegationOverflow(kMin, &result));
+}
+
+TEST(FlagStyleKernels, UintOperationsAgreeWithCheckedHelpers) {
+  constexpr uint64_t kMax = std::numeric_limits<uint64_t>::max();
+  uint64_t result;
+
+  EXPECT_FALSE(AddOverflow(uint64_t{1}, uint64_t{2}, &result));
+  EXPECT_EQ(result, 3);
+  EXPECT_TRUE(AddOverflow(kMax, uint64_t{1}, &result));
+
+  EXPECT_FALSE(SubOverflow(uint64_t{2}, uint64_t{1}, &result));
+  EXPECT_EQ(result, 1);
+  EXPECT_TRUE(SubOverflow(uint64_t{1}, uint64_t{2}, &result));
+
+  EXPECT_FALSE(MulOverflow(uint64_t{3}, uint64_t{4}, &result));
+  EXPECT_EQ(result, 12);
+  EXPECT_TRUE(MulOverflow(kMax, uint64_t{2}, &result));
+}
+
+TEST(FlagStyleKernels, PooledErrorStatuses) {
+  EXPECT_EQ(IntegerOverflowError().code(), absl::StatusCode::kOutOfRange);
+  EXPECT_THAT(IntegerOverflowError().message(), HasSubstr("integer overflow"));
+  EXPECT_EQ(UnsignedIntegerOverflowError().code(),
+            absl::StatusCode::kOutOfRange);
+  // Copies of the pooled statuses share a single representation.
+  EXPECT_EQ(&IntegerOverflowError(), &IntegerOverflowError());
+}
+
 }  // namespace
 }  // namespace cel::internal
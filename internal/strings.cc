@@ -14,12 +14,12 @@
 
 #include "internal/strings.h"
 
+#include <cstddef>
 #include <string>
 
 #include "absl/base/attributes.h"
 #include "absl/status/status.h"
 #include "absl/strings/ascii.h"
-#include "absl/strings/escaping.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "internal/lexis.h"
@@ -439,12 +439,51 @@ bool UnescapeInternal(absl::string_view source, absl::string_view closing_str,
   return true;
 }
 
-std::string EscapeInternal(absl::string_view src, bool escape_all_bytes,
+// Computes the exact size EscapeInternal's output for `src` would have, so
+// callers can reserve the destination once before filling it.
+size_t EscapedInternalSize(absl::string_view src, bool escape_all_bytes,
                            char escape_quote_char) {
-  std::string dest;
-  // Worst case size is every byte has to be hex escaped, so 4 char for every
-  // byte.
-  dest.reserve(src.size() * 4);
+  size_t size = 0;
+  bool last_hex_escape = false;  // true if last output char was \xNN.
+  const char* p = src.data();
+  const char* end = p + src.size();
+  for (; p < end; ++p) {
+    unsigned char c = static_cast<unsigned char>(*p);
+    bool is_hex_escape = false;
+    switch (c) {
+      case '\n':
+        ABSL_FALLTHROUGH_INTENDED;
+      case '\r':
+        ABSL_FALLTHROUGH_INTENDED;
+      case '\t':
+        ABSL_FALLTHROUGH_INTENDED;
+      case '\\':
+        size += 2;
+        break;
+      case '\'':
+        ABSL_FALLTHROUGH_INTENDED;
+      case '\"':
+        ABSL_FALLTHROUGH_INTENDED;
+      case '`':
+        size += (escape_quote_char == 0 || c == escape_quote_char) ? 2 : 1;
+        break;
+      default:
+        if ((!escape_all_bytes || c < 0x80) &&
+            (!absl::ascii_isprint(c) ||
+             (last_hex_escape && absl::ascii_isxdigit(c)))) {
+          size += 4;
+          is_hex_escape = true;
+        } else {
+          ++size;
+        }
+    }
+    last_hex_escape = is_hex_escape;
+  }
+  return size;
+}
+
+void AppendEscapedInternal(absl::string_view src, bool escape_all_bytes,
+                           char escape_quote_char, std::string& dest) {
   bool last_hex_escape = false;  // true if last output char was \xNN.
   const char* p = src.data();
   const char* end = p + src.size();
@@ -493,10 +532,100 @@ std::string EscapeInternal(absl::string_view src, bool escape_all_bytes,
     }
     last_hex_escape = is_hex_escape;
   }
-  dest.shrink_to_fit();
+}
+
+std::string EscapeInternal(absl::string_view src, bool escape_all_bytes,
+                           char escape_quote_char) {
+  // Two passes: an exact size scan, then a single reservation and fill. When
+  // nothing needs escaping the scan degenerates to one pass and the result is
+  // a plain copy.
+  size_t escaped_size =
+      EscapedInternalSize(src, escape_all_bytes, escape_quote_char);
+  if (escaped_size == src.size()) {
+    return std::string(src);
+  }
+  std::string dest;
+  dest.reserve(escaped_size);
+  AppendEscapedInternal(src, escape_all_bytes, escape_quote_char, dest);
   return dest;
 }
 
+// Computes the exact size EscapeBytes' output for `str` would have, so
+// callers can reserve the destination once before filling it.
+size_t EscapedBytesSize(absl::string_view str, bool escape_all_bytes,
+                        char escape_quote_char) {
+  size_t size = 0;
+  for (char ch : str) {
+    unsigned char c = static_cast<unsigned char>(ch);
+    if (escape_all_bytes || !absl::ascii_isprint(c)) {
+      size += 4;
+    } else if (c == '\\') {
+      size += 2;
+    } else if (c == '\'' || c == '"' || c == '`') {
+      size += (escape_quote_char == 0 || c == escape_quote_char) ? 2 : 1;
+    } else {
+      ++size;
+    }
+  }
+  return size;
+}
+
+void AppendEscapedBytes(absl::string_view str, bool escape_all_bytes,
+                        char escape_quote_char, std::string& escaped_bytes) {
+  const char* p = str.data();
+  const char* end = p + str.size();
+  for (; p < end; ++p) {
+    unsigned char c = *p;
+    if (escape_all_bytes || !absl::ascii_isprint(c)) {
+      escaped_bytes += "\\x";
+      escaped_bytes += kHexTable[c / 16];
+      escaped_bytes += kHexTable[c % 16];
+    } else {
+      switch (c) {
+        // Note that we only handle printable escape characters here.  All
+        // unprintable (\n, \r, \t, etc.) are hex escaped above.
+        case '\\':
+          escaped_bytes += "\\\\";
+          break;
+        case '\'':
+        case '"':
+        case '`':
+          // Escape only quote chars that match escape_quote_char.
+          if (escape_quote_char == 0 || c == escape_quote_char) {
+            escaped_bytes += '\\';
+          }
+          escaped_bytes += c;
+          break;
+        default:
+          escaped_bytes += c;
+          break;
+      }
+    }
+  }
+}
+
+// Formats `quote` + escaped `str` + `quote` with one exactly-sized
+// allocation instead of escaping into a temporary and concatenating.
+std::string QuoteStringLiteral(absl::string_view str, char quote) {
+  std::string result;
+  result.reserve(EscapedInternalSize(str, true, quote) + 2);
+  result.push_back(quote);
+  AppendEscapedInternal(str, true, quote, result);
+  result.push_back(quote);
+  return result;
+}
+
+// As above for bytes literals, which carry a leading 'b'.
+std::string QuoteBytesLiteral(absl::string_view str, char quote) {
+  std::string result;
+  result.reserve(EscapedBytesSize(str, false, quote) + 3);
+  result.push_back('b');
+  result.push_back(quote);
+  AppendEscapedBytes(str, false, quote, result);
+  result.push_back(quote);
+  return result;
+}
+
 bool MayBeTripleQuotedString(absl::string_view str) {
   return (str.size() >= 6 &&
           ((absl::StartsWith(str, "\"\"\"") && absl::EndsWith(str, "\"\"\"")) ||
@@ -553,36 +682,14 @@ std::string EscapeString(absl::string_view str) {
 
 std::string EscapeBytes(absl::string_view str, bool escape_all_bytes,
                         char escape_quote_char) {
-  std::string escaped_bytes;
-  const char* p = str.data();
-  const char* end = p + str.size();
-  for (; p < end; ++p) {
-    unsigned char c = *p;
-    if (escape_all_bytes || !absl::ascii_isprint(c)) {
-      escaped_bytes += "\\x";
-      escaped_bytes += absl::BytesToHexString(absl::string_view(p, 1));
-    } else {
-      switch (c) {
-        // Note that we only handle printable escape characters here.  All
-        // unprintable (\n, \r, \t, etc.) are hex escaped above.
-        case '\\':
-          escaped_bytes += "\\\\";
-          break;
-        case '\'':
-        case '"':
-        case '`':
-          // Escape only quote chars that match escape_quote_char.
-          if (escape_quote_char == 0 || c == escape_quote_char) {
-            escaped_bytes += '\\';
-          }
-          escaped_bytes += c;
-          break;
-        default:
-          escaped_bytes += c;
-          break;
-      }
-    }
+  size_t escaped_size =
+      EscapedBytesSize(str, escape_all_bytes, escape_quote_char);
+  if (escaped_size == str.size()) {
+    return std::string(str);
   }
+  std::string escaped_bytes;
+  escaped_bytes.reserve(escaped_size);
+  AppendEscapedBytes(str, escape_all_bytes, escape_quote_char, escaped_bytes);
   return escaped_bytes;
 }
 
@@ -649,29 +756,29 @@ absl::StatusOr<std::string> ParseBytesLiteral(absl::string_view str) {
 std::string FormatStringLiteral(absl::string_view str) {
   absl::string_view quote =
       (str.find('"') != str.npos && str.find('\'') == str.npos) ? "'" : "\"";
-  return absl::StrCat(quote, EscapeInternal(str, true, quote[0]), quote);
+  return QuoteStringLiteral(str, quote[0]);
 }
 
 std::string FormatSingleQuotedStringLiteral(absl::string_view str) {
-  return absl::StrCat("'", EscapeInternal(str, true, '\''), "'");
+  return QuoteStringLiteral(str, '\'');
 }
 
 std::string FormatDoubleQuotedStringLiteral(absl::string_view str) {
-  return absl::StrCat("\"", EscapeInternal(str, true, '"'), "\"");
+  return QuoteStringLiteral(str, '"');
 }
 
 std::string FormatBytesLiteral(absl::string_view str) {
   absl::string_view quote =
       (str.find('"') != str.npos && str.find('\'') == str.npos) ? "'" : "\"";
-  return absl::StrCat("b", quote, EscapeBytes(str, false, quote[0]), quote);
+  return QuoteBytesLiteral(str, quote[0]);
 }
 
 std::string FormatSingleQuotedBytesLiteral(absl::string_view str) {
-  return absl::StrCat("b'", EscapeBytes(str, false, '\''), "'");
+  return QuoteBytesLiteral(str, '\'');
 }
 
 std::string FormatDoubleQuotedBytesLiteral(absl::string_view str) {
-  return absl::StrCat("b\"", EscapeBytes(str, false, '"'), "\"");
+  return QuoteBytesLiteral(str, '"');
 }
 
 absl::StatusOr<std::string> ParseIdentifier(absl::string_view str) {
@@ -203,6 +203,149 @@ class CordReader final {
   size_t index_;
 };
 
+// Mask selecting the high bit of each byte in a 64-bit word.
+constexpr uint64_t kAsciiHighBits = 0x8080808080808080;
+
+// Advances `index` past the longest ASCII run starting there, consuming eight
+// bytes per iteration while no byte has its high bit set. Contiguous input is
+// overwhelmingly ASCII in practice, so this word-at-a-time scan is where
+// validation and counting spend most of their time.
+size_t SkipAscii(absl::string_view str, size_t index) {
+  while (index + sizeof(uint64_t) <= str.size()) {
+    uint64_t word;
+    std::memcpy(&word, str.data() + index, sizeof(uint64_t));
+    if ((word & kAsciiHighBits) != 0) {
+      break;
+    }
+    index += sizeof(uint64_t);
+  }
+  while (index < str.size() &&
+         static_cast<uint8_t>(str[index]) < kUtf8RuneSelf) {
+    ++index;
+  }
+  return index;
+}
+
+// Flat counterparts of the reader-based implementations below, for contiguous
+// input. They share the same leading/accept tables and decisions; the only
+// difference is the word-at-a-time ASCII scan.
+
+bool Utf8IsValidFlat(absl::string_view str) {
+  size_t index = 0;
+  while (index < str.size()) {
+    const auto b = static_cast<uint8_t>(str[index]);
+    if (b < kUtf8RuneSelf) {
+      index = SkipAscii(str, index);
+      continue;
+    }
+    const auto leading = kLeading[b];
+    if (leading == kXX) {
+      return false;
+    }
+    const auto size = static_cast<size_t>(leading & 7) - 1;
+    ++index;
+    if (size > str.size() - index) {
+      return false;
+    }
+    const auto& accept = kAccept[leading >> 4];
+    if (static_cast<uint8_t>(str[index]) < accept.first ||
+        static_cast<uint8_t>(str[index]) > accept.second) {
+      return false;
+    } else if (size == 1) {
+    } else if (static_cast<uint8_t>(str[index + 1]) < kLow ||
+               static_cast<uint8_t>(str[index + 1]) > kHigh) {
+      return false;
+    } else if (size == 2) {
+    } else if (static_cast<uint8_t>(str[index + 2]) < kLow ||
+               static_cast<uint8_t>(str[index + 2]) > kHigh) {
+      return false;
+    }
+    index += size;
+  }
+  return true;
+}
+
+size_t Utf8CodePointCountFlat(absl::string_view str) {
+  size_t count = 0;
+  size_t index = 0;
+  while (index < str.size()) {
+    const auto b = static_cast<uint8_t>(str[index]);
+    if (b < kUtf8RuneSelf) {
+      size_t next = SkipAscii(str, index);
+      count += next - index;
+      index = next;
+      continue;
+    }
+    count++;
+    ++index;
+    const auto leading = kLeading[b];
+    if (leading == kXX) {
+      continue;
+    }
+    auto size = static_cast<size_t>(leading & 7) - 1;
+    if (size > str.size() - index) {
+      continue;
+    }
+    const auto& accept = kAccept[leading >> 4];
+    if (static_cast<uint8_t>(str[index]) < accept.first ||
+        static_cast<uint8_t>(str[index]) > accept.second) {
+      size = 0;
+    } else if (size == 1) {
+    } else if (static_cast<uint8_t>(str[index + 1]) < kLow ||
+               static_cast<uint8_t>(str[index + 1]) > kHigh) {
+      size = 0;
+    } else if (size == 2) {
+    } else if (static_cast<uint8_t>(str[index + 2]) < kLow ||
+               static_cast<uint8_t>(str[index + 2]) > kHigh) {
+      size = 0;
+    }
+    index += size;
+  }
+  return count;
+}
+
+std::pair<size_t, bool> Utf8ValidateFlat(absl::string_view str) {
+  size_t count = 0;
+  size_t index = 0;
+  while (index < str.size()) {
+    const auto b = static_cast<uint8_t>(str[index]);
+    if (b < kUtf8RuneSelf) {
+      size_t next = SkipAscii(str, index);
+      count += next - index;
+      index = next;
+      continue;
+    }
+    const auto leading = kLeading[b];
+    if (leading == kXX) {
+      return {count, false};
+    }
+    const auto size = static_cast<size_t>(leading & 7) - 1;
+    ++index;
+    if (size > str.size() - index) {
+      return {count, false};
+    }
+    const auto& accept = kAccept[leading >> 4];
+    if (static_cast<uint8_t>(str[index]) < accept.first ||
+        static_cast<uint8_t>(str[index]) > accept.second) {
+      return {count, false};
+    } else if (size == 1) {
+      count++;
+    } else if (static_cast<uint8_t>(str[index + 1]) < kLow ||
+               static_cast<uint8_t>(str[index + 1]) > kHigh) {
+      return {count, false};
+    } else if (size == 2) {
+      count++;
+    } else if (static_cast<uint8_t>(str[index + 2]) < kLow ||
+               static_cast<uint8_t>(str[index + 2]) > kHigh) {
+      return {count, false};
+    } else {
+      count++;
+    }
+    index += size;
+  }
+  return {count, true};
+}
+
 template <typename BufferedByteReader>
 bool Utf8IsValidImpl(BufferedByteReader* reader) {
   while (reader->HasRemaining()) {
@@ -316,13 +459,18 @@ std::pair<size_t, bool> Utf8ValidateImpl(BufferedByteReader* reader) {
 }  // namespace
 
 bool Utf8IsValid(absl::string_view str) {
-  StringReader reader(str);
-  bool valid = Utf8IsValidImpl(&reader);
-  ABSL_ASSERT((reader.Reset(str), valid == Utf8ValidateImpl(&reader).second));
+  bool valid = Utf8IsValidFlat(str);
+  ABSL_ASSERT([&]() {
+    StringReader reader(str);
+    return valid == Utf8IsValidImpl(&reader);
+  }());
   return valid;
 }
 
 bool Utf8IsValid(const absl::Cord& str) {
+  if (auto flat = str.TryFlat(); flat.has_value()) {
+    return Utf8IsValidFlat(*flat);
+  }
   CordReader reader(str);
   bool valid = Utf8IsValidImpl(&reader);
   ABSL_ASSERT((reader.Reset(str), valid == Utf8ValidateImpl(&reader).second));
@@ -330,23 +478,35 @@ bool Utf8IsValid(const absl::Cord& str) {
 }
 
 size_t Utf8CodePointCount(absl::string_view str) {
-  StringReader reader(str);
-  return Utf8CodePointCountImpl(&reader);
+  size_t count = Utf8CodePointCountFlat(str);
+  ABSL_ASSERT([&]() {
+    StringReader reader(str);
+    return count == Utf8CodePointCountImpl(&reader);
+  }());
+  return count;
 }
 
 size_t Utf8CodePointCount(const absl::Cord& str) {
+  if (auto flat = str.TryFlat(); flat.has_value()) {
+    return Utf8CodePointCountFlat(*flat);
+  }
   CordReader reader(str);
   return Utf8CodePointCountImpl(&reader);
 }
 
 std::pair<size_t, bool> Utf8Validate(absl::string_view str) {
-  StringReader reader(str);
-  auto result = Utf8ValidateImpl(&reader);
-  ABSL_ASSERT((reader.Reset(str), result.second == Utf8IsValidImpl(&reader)));
+  auto result = Utf8ValidateFlat(str);
+  ABSL_ASSERT([&]() {
+    StringReader reader(str);
+    return result == Utf8ValidateImpl(&reader);
+  }());
   return result;
 }
 
 std::pair<size_t, bool> Utf8Validate(const absl::Cord& str) {
+  if (auto flat = str.TryFlat(); flat.has_value()) {
+    return Utf8ValidateFlat(*flat);
+  }
   CordReader reader(str);
   auto result = Utf8ValidateImpl(&reader);
   ABSL_ASSERT((reader.Reset(str), result.second == Utf8IsValidImpl(&reader)));
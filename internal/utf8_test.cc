@@ -15,6 +15,7 @@
 #include "internal/utf8.h"
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/strings/cord.h"
@@ -161,6 +162,35 @@ TEST(Utf8Validate, Cord) {
   EXPECT_EQ(Utf8Validate(absl::Cord("a\xe2\x80")).first, 1);
 }
 
+// Exercise the word-at-a-time ASCII scan with runs longer than one word and
+// multibyte or invalid sequences at every offset within a word.
+TEST(Utf8AsciiFastPath, LongRuns) {
+  const std::string ascii(1024, 'a');
+  EXPECT_TRUE(Utf8IsValid(ascii));
+  EXPECT_EQ(Utf8CodePointCount(ascii), 1024);
+  EXPECT_EQ(Utf8Validate(ascii), (std::pair<size_t, bool>(1024, true)));
+
+  for (size_t offset = 0; offset < 16; ++offset) {
+    const std::string prefix(offset, 'a');
+
+    std::string multibyte = prefix + "\xd0\x96" + ascii;
+    EXPECT_TRUE(Utf8IsValid(multibyte));
+    EXPECT_EQ(Utf8CodePointCount(multibyte), offset + 1 + 1024);
+    EXPECT_EQ(Utf8Validate(multibyte),
+              (std::pair<size_t, bool>(offset + 1 + 1024, true)));
+
+    std::string invalid = prefix + "\xfa" + ascii;
+    EXPECT_FALSE(Utf8IsValid(invalid));
+    EXPECT_EQ(Utf8Validate(invalid), (std::pair<size_t, bool>(offset, false)));
+    EXPECT_EQ(Utf8CodePointCount(invalid), offset + 1 + 1024);
+
+    std::string truncated = prefix + "\xe2\x98";
+    EXPECT_FALSE(Utf8IsValid(truncated));
+    EXPECT_EQ(Utf8Validate(truncated),
+              (std::pair<size_t, bool>(offset, false)));
+  }
+}
+
 struct Utf8EncodeTestCase final {
   char32_t code_point;
   absl::string_view code_units;
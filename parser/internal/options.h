@@ -22,6 +22,7 @@ inline constexpr int kDefaultMaxRecursionDepth = 32;
 inline constexpr int kExpressionSizeCodepointLimit = 100'000;
 inline constexpr int kDefaultErrorRecoveryTokenLookaheadLimit = 512;
 inline constexpr bool kDefaultAddMacroCalls = false;
+inline constexpr int kDefaultMaxExpressionNodeCount = 0;
 
 }  // namespace cel_parser_internal
 
@@ -14,9 +14,11 @@
 
 #include "parser/macro_expr_factory.h"
 
+#include <cstddef>
 #include <utility>
 #include <vector>
 
+#include "absl/container/inlined_vector.h"
 #include "absl/functional/overload.h"
 #include "absl/types/optional.h"
 #include "absl/types/variant.h"
@@ -25,85 +27,157 @@
 
 namespace cel {
 
+namespace {
+
+// Work items for the iterative copy. Each frame copies one node (or one
+// struct field / map entry wrapper) from `src` into the already allocated
+// destination slot `dst`; composite nodes allocate their children up front
+// and push one frame per child.
+struct CopyExprFrame {
+  const Expr* src;
+  Expr* dst;
+};
+
+struct CopyFieldFrame {
+  const StructExprField* src;
+  StructExprField* dst;
+};
+
+struct CopyEntryFrame {
+  const MapExprEntry* src;
+  MapExprEntry* dst;
+};
+
+using CopyFrame =
+    absl::variant<CopyExprFrame, CopyFieldFrame, CopyEntryFrame>;
+
+}  // namespace
+
 Expr MacroExprFactory::Copy(const Expr& expr) {
-  // Copying logic is recursive at the moment, we alter it to be iterative in
-  // the future.
-  return absl::visit(
-      absl::Overload(
-          [this, &expr](const UnspecifiedExpr&) -> Expr {
-            return NewUnspecified(CopyId(expr));
-          },
-          [this, &expr](const Constant& const_expr) -> Expr {
-            return NewConst(CopyId(expr), const_expr);
-          },
-          [this, &expr](const IdentExpr& ident_expr) -> Expr {
-            return NewIdent(CopyId(expr), ident_expr.name());
-          },
-          [this, &expr](const SelectExpr& select_expr) -> Expr {
-            const auto id = CopyId(expr);
-            return select_expr.test_only()
-                       ? NewPresenceTest(id, Copy(select_expr.operand()),
-                                         select_expr.field())
-                       : NewSelect(id, Copy(select_expr.operand()),
-                                   select_expr.field());
-          },
-          [this, &expr](const CallExpr& call_expr) -> Expr {
-            const auto id = CopyId(expr);
-            absl::optional<Expr> target;
-            if (call_expr.has_target()) {
-              target = Copy(call_expr.target());
-            }
-            std::vector<Expr> args;
-            args.reserve(call_expr.args().size());
-            for (const auto& arg : call_expr.args()) {
-              args.push_back(Copy(arg));
-            }
-            return target.has_value()
-                       ? NewMemberCall(id, call_expr.function(),
-                                       std::move(*target), std::move(args))
-                       : NewCall(id, call_expr.function(), std::move(args));
-          },
-          [this, &expr](const ListExpr& list_expr) -> Expr {
-            const auto id = CopyId(expr);
-            std::vector<ListExprElement> elements;
-            elements.reserve(list_expr.elements().size());
-            for (const auto& element : list_expr.elements()) {
-              elements.push_back(Copy(element));
-            }
-            return NewList(id, std::move(elements));
-          },
-          [this, &expr](const StructExpr& struct_expr) -> Expr {
-            const auto id = CopyId(expr);
-            std::vector<StructExprField> fields;
-            fields.reserve(struct_expr.fields().size());
-            for (const auto& field : struct_expr.fields()) {
-              fields.push_back(Copy(field));
-            }
-            return NewStruct(id, struct_expr.name(), std::move(fields));
-          },
-          [this, &expr](const MapExpr& map_expr) -> Expr {
-            const auto id = CopyId(expr);
-            std::vector<MapExprEntry> entries;
-            entries.reserve(map_expr.entries().size());
-            for (const auto& entry : map_expr.entries()) {
-              entries.push_back(Copy(entry));
-            }
-            return NewMap(id, std::move(entries));
-          },
-          [this, &expr](const ComprehensionExpr& comprehension_expr) -> Expr {
-            const auto id = CopyId(expr);
-            auto iter_range = Copy(comprehension_expr.iter_range());
-            auto accu_init = Copy(comprehension_expr.accu_init());
-            auto loop_condition = Copy(comprehension_expr.loop_condition());
-            auto loop_step = Copy(comprehension_expr.loop_step());
-            auto result = Copy(comprehension_expr.result());
-            return NewComprehension(
-                id, comprehension_expr.iter_var(), std::move(iter_range),
-                comprehension_expr.accu_var(), std::move(accu_init),
-                std::move(loop_condition), std::move(loop_step),
-                std::move(result));
-          }),
-      expr.kind());
+  // Iterative so deeply nested subtrees cannot exhaust the native stack.
+  // Frames are processed LIFO and children are pushed in reverse, so nodes
+  // are visited — and ids assigned by CopyId — in the same pre-order as a
+  // recursive copy.
+  Expr result;
+  absl::InlinedVector<CopyFrame, 16> stack;
+  stack.push_back(CopyExprFrame{&expr, &result});
+  while (!stack.empty()) {
+    CopyFrame frame = stack.back();
+    stack.pop_back();
+    if (auto* field_frame = absl::get_if<CopyFieldFrame>(&frame);
+        field_frame != nullptr) {
+      const StructExprField& src = *field_frame->src;
+      StructExprField& dst = *field_frame->dst;
+      dst.set_id(CopyId(src.id()));
+      dst.set_name(src.name());
+      dst.set_optional(src.optional());
+      stack.push_back(CopyExprFrame{&src.value(), &dst.mutable_value()});
+      continue;
+    }
+    if (auto* entry_frame = absl::get_if<CopyEntryFrame>(&frame);
+        entry_frame != nullptr) {
+      const MapExprEntry& src = *entry_frame->src;
+      MapExprEntry& dst = *entry_frame->dst;
+      dst.set_id(CopyId(src.id()));
+      dst.set_optional(src.optional());
+      stack.push_back(CopyExprFrame{&src.value(), &dst.mutable_value()});
+      stack.push_back(CopyExprFrame{&src.key(), &dst.mutable_key()});
+      continue;
+    }
+    const Expr& src = *absl::get<CopyExprFrame>(frame).src;
+    Expr& dst = *absl::get<CopyExprFrame>(frame).dst;
+    const auto id = CopyId(src);
+    absl::visit(
+        absl::Overload(
+            [this, id, &dst](const UnspecifiedExpr&) {
+              dst = NewUnspecified(id);
+            },
+            [this, id, &dst](const Constant& const_expr) {
+              dst = NewConst(id, const_expr);
+            },
+            [this, id, &dst](const IdentExpr& ident_expr) {
+              dst = NewIdent(id, ident_expr.name());
+            },
+            [this, id, &dst, &stack](const SelectExpr& select_expr) {
+              dst = select_expr.test_only()
+                        ? NewPresenceTest(id, Expr(), select_expr.field())
+                        : NewSelect(id, Expr(), select_expr.field());
+              stack.push_back(
+                  CopyExprFrame{&select_expr.operand(),
+                                &dst.mutable_select_expr().mutable_operand()});
+            },
+            [this, id, &dst, &stack](const CallExpr& call_expr) {
+              std::vector<Expr> args(call_expr.args().size());
+              dst = call_expr.has_target()
+                        ? NewMemberCall(id, call_expr.function(), Expr(),
+                                        std::move(args))
+                        : NewCall(id, call_expr.function(), std::move(args));
+              auto& dst_call = dst.mutable_call_expr();
+              for (size_t i = call_expr.args().size(); i > 0; --i) {
+                stack.push_back(CopyExprFrame{
+                    &call_expr.args()[i - 1], &dst_call.mutable_args()[i - 1]});
+              }
+              if (call_expr.has_target()) {
+                stack.push_back(CopyExprFrame{&call_expr.target(),
+                                              &dst_call.mutable_target()});
+              }
+            },
+            [this, id, &dst, &stack](const ListExpr& list_expr) {
+              std::vector<ListExprElement> elements(list_expr.elements().size());
+              for (size_t i = 0; i < elements.size(); ++i) {
+                elements[i].set_optional(list_expr.elements()[i].optional());
+              }
+              dst = NewList(id, std::move(elements));
+              auto& dst_elements = dst.mutable_list_expr().mutable_elements();
+              for (size_t i = list_expr.elements().size(); i > 0; --i) {
+                stack.push_back(
+                    CopyExprFrame{&list_expr.elements()[i - 1].expr(),
+                                  &dst_elements[i - 1].mutable_expr()});
+              }
+            },
+            [this, id, &dst, &stack](const StructExpr& struct_expr) {
+              std::vector<StructExprField> fields(struct_expr.fields().size());
+              dst = NewStruct(id, struct_expr.name(), std::move(fields));
+              auto& dst_fields = dst.mutable_struct_expr().mutable_fields();
+              for (size_t i = struct_expr.fields().size(); i > 0; --i) {
+                stack.push_back(CopyFieldFrame{&struct_expr.fields()[i - 1],
+                                               &dst_fields[i - 1]});
+              }
+            },
+            [this, id, &dst, &stack](const MapExpr& map_expr) {
+              std::vector<MapExprEntry> entries(map_expr.entries().size());
+              dst = NewMap(id, std::move(entries));
+              auto& dst_entries = dst.mutable_map_expr().mutable_entries();
+              for (size_t i = map_expr.entries().size(); i > 0; --i) {
+                stack.push_back(CopyEntryFrame{&map_expr.entries()[i - 1],
+                                               &dst_entries[i - 1]});
+              }
+            },
+            [this, id, &dst,
+             &stack](const ComprehensionExpr& comprehension_expr) {
+              dst = NewComprehension(id, comprehension_expr.iter_var(), Expr(),
+                                     comprehension_expr.accu_var(), Expr(),
+                                     Expr(), Expr(), Expr());
+              auto& dst_comprehension = dst.mutable_comprehension_expr();
+              stack.push_back(
+                  CopyExprFrame{&comprehension_expr.result(),
+                                &dst_comprehension.mutable_result()});
+              stack.push_back(
+                  CopyExprFrame{&comprehension_expr.loop_step(),
+                                &dst_comprehension.mutable_loop_step()});
+              stack.push_back(
+                  CopyExprFrame{&comprehension_expr.loop_condition(),
+                                &dst_comprehension.mutable_loop_condition()});
+              stack.push_back(
+                  CopyExprFrame{&comprehension_expr.accu_init(),
+                                &dst_comprehension.mutable_accu_init()});
+              stack.push_back(
+                  CopyExprFrame{&comprehension_expr.iter_range(),
+                                &dst_comprehension.mutable_iter_range()});
+            }),
+        src.kind());
+  }
+  return result;
 }
 
 ListExprElement MacroExprFactory::Copy(const ListExprElement& element) {
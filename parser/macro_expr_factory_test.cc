@@ -147,5 +147,25 @@ TEST(MacroExprFactory, CopyComprehension) {
           factory.NewIdent(11, "foo"), factory.NewIdent(12, "bar")));
 }
 
+TEST(MacroExprFactory, CopyDeeplyNested) {
+  TestMacroExprFactory factory;
+  constexpr int kDepth = 2000;
+  Expr expr = factory.NewIdent("leaf");
+  for (int i = 0; i < kDepth; ++i) {
+    expr = factory.NewSelect(std::move(expr), "field");
+  }
+
+  Expr copied = factory.Copy(expr);
+
+  const Expr* node = &copied;
+  for (int i = 0; i < kDepth; ++i) {
+    ASSERT_TRUE(node->has_select_expr());
+    EXPECT_EQ(node->select_expr().field(), "field");
+    node = &node->select_expr().operand();
+  }
+  ASSERT_TRUE(node->has_ident_expr());
+  EXPECT_EQ(node->ident_expr().name(), "leaf");
+}
+
 }  // namespace
 }  // namespace cel
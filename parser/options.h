@@ -47,6 +47,20 @@ struct ParserOptions final {
 
   // Enable support for optional syntax.
   bool enable_optional_syntax = false;
+
+  // Limit on the number of AST nodes allocated for a single expression,
+  // including nodes synthesized by macro expansion. The parse aborts as soon
+  // as the limit is exceeded instead of building the rest of the tree, which
+  // bounds the work an adversarial input can cause beyond the codepoint and
+  // recursion limits. 0 disables the limit.
+  int max_expression_node_count =
+      ::cel_parser_internal::kDefaultMaxExpressionNodeCount;
+
+  // Enable the process-wide bounded cache of parse results in
+  // `google::api::expr::parser::Parse`. Repeat parses of an identical
+  // expression with identical options become a lookup plus a copy of the
+  // cached `ParsedExpr` instead of a full lexer/parser run.
+  bool enable_expression_cache = false;
 };
 
 }  // namespace cel
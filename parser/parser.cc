@@ -23,6 +23,7 @@
 #include <functional>
 #include <iterator>
 #include <limits>
+#include <list>
 #include <map>
 #include <memory>
 #include <string>
@@ -33,8 +34,10 @@
 #include "google/api/expr/v1alpha1/syntax.pb.h"
 #include "absl/base/macros.h"
 #include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/container/btree_map.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
 #include "absl/functional/overload.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
@@ -46,6 +49,7 @@
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_replace.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "absl/types/variant.h"
@@ -153,8 +157,9 @@ SourceRange SourceRangeFromParserRuleContext(
 
 class ParserMacroExprFactory final : public MacroExprFactory {
  public:
-  explicit ParserMacroExprFactory(const cel::Source& source)
-      : MacroExprFactory(), source_(source) {}
+  explicit ParserMacroExprFactory(const cel::Source& source,
+                                  int max_node_count = 0)
+      : MacroExprFactory(), max_node_count_(max_node_count), source_(source) {}
 
   void BeginMacro(SourceRange macro_position) {
     macro_position_ = macro_position;
@@ -190,6 +195,15 @@ class ParserMacroExprFactory final : public MacroExprFactory {
   }
 
   int64_t NextId(const SourceRange& range) {
+    // Every node, including those synthesized by macro expansion, allocates
+    // its id here, so this is a complete O(1) accounting of tree size. Thrown
+    // rather than reported through `ReportError`, which would itself allocate
+    // an id; the caller surfaces it as a cancelled parse like the recursion
+    // and error-recovery limits.
+    if (max_node_count_ > 0 && expr_id_ > max_node_count_) {
+      throw antlr4::ParseCancellationException(absl::StrCat(
+          "expression node count exceeds limit: ", max_node_count_));
+    }
     auto id = expr_id_++;
     if (range.begin != -1 || range.end != -1) {
       positions_.insert(std::pair{id, range});
@@ -382,6 +396,9 @@ class ParserMacroExprFactory final : public MacroExprFactory {
 
  private:
   int64_t expr_id_ = 1;
+  // Maximum id (and therefore node count) before the parse is aborted; 0
+  // disables the limit.
+  int max_node_count_ = 0;
   absl::btree_map<int64_t, SourceRange> positions_;
   absl::flat_hash_map<int64_t, Expr> macro_calls_;
   std::vector<ParserError> errors_;
@@ -591,7 +608,8 @@ class ParserVisitor final : public CelBaseVisitor,
   ParserVisitor(const cel::Source& source, int max_recursion_depth,
                 const cel::MacroRegistry& macro_registry,
                 bool add_macro_calls = false,
-                bool enable_optional_syntax = false);
+                bool enable_optional_syntax = false,
+                int max_expression_node_count = 0);
   ~ParserVisitor() override;
 
   std::any visit(antlr4::tree::ParseTree* tree) override;
@@ -692,9 +710,10 @@ ParserVisitor::ParserVisitor(const cel::Source& source,
                              const int max_recursion_depth,
                              const cel::MacroRegistry& macro_registry,
                              const bool add_macro_calls,
-                             bool enable_optional_syntax)
+                             bool enable_optional_syntax,
+                             int max_expression_node_count)
     : source_(source),
-      factory_(source_),
+      factory_(source_, max_expression_node_count),
       macro_registry_(macro_registry),
       recursion_depth_(0),
       max_recursion_depth_(max_recursion_depth),
@@ -1588,17 +1607,268 @@ class RecoveryLimitErrorStrategy final : public DefaultErrorStrategy {
   int recovery_token_lookahead_limit_;
 };
 
+// Cache key for `Parse` results. The macro set used by `Parse` is a function
+// of the options, so expression, description and every option that affects
+// the output or reported errors together identify the result.
+struct ParseCacheKey final {
+  ParseCacheKey(absl::string_view expression, absl::string_view description,
+                const ParserOptions& options)
+      : expression(expression),
+        description(description),
+        error_recovery_limit(options.error_recovery_limit),
+        max_recursion_depth(options.max_recursion_depth),
+        expression_size_codepoint_limit(
+            options.expression_size_codepoint_limit),
+        error_recovery_token_lookahead_limit(
+            options.error_recovery_token_lookahead_limit),
+        add_macro_calls(options.add_macro_calls),
+        enable_optional_syntax(options.enable_optional_syntax),
+        max_expression_node_count(options.max_expression_node_count) {}
+
+  friend bool operator==(const ParseCacheKey& lhs, const ParseCacheKey& rhs) {
+    return lhs.expression == rhs.expression &&
+           lhs.description == rhs.description &&
+           lhs.error_recovery_limit == rhs.error_recovery_limit &&
+           lhs.max_recursion_depth == rhs.max_recursion_depth &&
+           lhs.expression_size_codepoint_limit ==
+               rhs.expression_size_codepoint_limit &&
+           lhs.error_recovery_token_lookahead_limit ==
+               rhs.error_recovery_token_lookahead_limit &&
+           lhs.add_macro_calls == rhs.add_macro_calls &&
+           lhs.enable_optional_syntax == rhs.enable_optional_syntax &&
+           lhs.max_expression_node_count == rhs.max_expression_node_count;
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H state, const ParseCacheKey& key) {
+    return H::combine(std::move(state), key.expression, key.description,
+                      key.error_recovery_limit, key.max_recursion_depth,
+                      key.expression_size_codepoint_limit,
+                      key.error_recovery_token_lookahead_limit,
+                      key.add_macro_calls, key.enable_optional_syntax,
+                      key.max_expression_node_count);
+  }
+
+  std::string expression;
+  std::string description;
+  int error_recovery_limit;
+  int max_recursion_depth;
+  int expression_size_codepoint_limit;
+  int error_recovery_token_lookahead_limit;
+  bool add_macro_calls;
+  bool enable_optional_syntax;
+  int max_expression_node_count;
+};
+
+// Process-wide bounded LRU cache of successful `Parse` results, shared
+// immutably so that a hit is a lookup plus a proto copy instead of a full
+// ANTLR lexer/parser run. Only consulted when
+// `ParserOptions::enable_expression_cache` is set.
+class ParseCache final {
+ public:
+  static ParseCache& Global() {
+    static ParseCache* cache = new ParseCache();
+    return *cache;
+  }
+
+  std::shared_ptr<const ParsedExpr> Lookup(const ParseCacheKey& key) {
+    absl::MutexLock lock(&mutex_);
+    auto entry = entries_.find(key);
+    if (entry == entries_.end()) {
+      return nullptr;
+    }
+    lru_.splice(lru_.end(), lru_, entry->second.second);
+    return entry->second.first;
+  }
+
+  void Insert(ParseCacheKey key, std::shared_ptr<const ParsedExpr> value) {
+    absl::MutexLock lock(&mutex_);
+    auto entry = entries_.find(key);
+    if (entry != entries_.end()) {
+      // Lost a race with another thread parsing the same expression; keep
+      // the existing entry.
+      return;
+    }
+    if (entries_.size() >= kMaxEntries) {
+      entries_.erase(*lru_.front());
+      lru_.pop_front();
+    }
+    auto inserted = entries_.emplace(
+        std::move(key), std::make_pair(std::move(value), lru_.end()));
+    inserted.first->second.second =
+        lru_.insert(lru_.end(), &inserted.first->first);
+  }
+
+ private:
+  static constexpr size_t kMaxEntries = 256;
+
+  // Least-recently-used order, oldest first. Node-based map keeps the key
+  // pointers stable.
+  using LruList = std::list<const ParseCacheKey*>;
+
+  absl::Mutex mutex_;
+  absl::node_hash_map<ParseCacheKey,
+                      std::pair<std::shared_ptr<const ParsedExpr>,
+                                LruList::iterator>>
+      entries_ ABSL_GUARDED_BY(mutex_);
+  LruList lru_ ABSL_GUARDED_BY(mutex_);
+};
+
+absl::StatusOr<ParsedExpr> ParseImpl(absl::string_view expression,
+                                     absl::string_view description,
+                                     const ParserOptions& options) {
+  std::vector<Macro> macros = Macro::AllMacros();
+  if (options.enable_optional_syntax) {
+    macros.push_back(cel::OptMapMacro());
+    macros.push_back(cel::OptFlatMapMacro());
+  }
+  return ParseWithMacros(expression, macros, description, options);
+}
+
+// Parses a single bundle entry with the shared, reusable ANTLR objects.
+// Mirrors `EnrichedParse` except that the lexer, token buffer and parser are
+// reset rather than reconstructed, so later entries reuse the allocations
+// made by earlier ones.
+absl::StatusOr<ParsedExpr> ParseBundleEntry(
+    CelLexer& lexer, CommonTokenStream& tokens, CelParser& parser,
+    cel::SourcePtr& source, std::unique_ptr<CodePointStream>& input,
+    absl::string_view expression, absl::string_view description,
+    const cel::MacroRegistry& registry, const ParserOptions& options) {
+  try {
+    CEL_ASSIGN_OR_RETURN(auto next_source,
+                         cel::NewSource(expression, std::string(description)));
+    auto next_input = std::make_unique<CodePointStream>(
+        next_source->content(), next_source->description());
+    if (next_input->size() > options.expression_size_codepoint_limit) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("expression size exceeds codepoint limit.",
+                       " input size: ", next_input->size(),
+                       ", limit: ", options.expression_size_codepoint_limit));
+    }
+    // Install the new stream before releasing the previous one: the lexer
+    // reset performed by `setInputStream` still touches the stream it is
+    // replacing. Resetting clears the lexer and parser state and the
+    // buffered tokens, but keeps the token buffer's backing storage.
+    lexer.setInputStream(next_input.get());
+    input = std::move(next_input);
+    source = std::move(next_source);
+
+    ExprRecursionListener recursion_listener(options.max_recursion_depth);
+    ParserVisitor visitor(*source, options.max_recursion_depth, registry,
+                          options.add_macro_calls,
+                          options.enable_optional_syntax,
+                          options.max_expression_node_count);
+
+    // This entry's listeners must replace the previous entry's before the
+    // token stream is installed below, which may already pull tokens from
+    // the lexer and report errors.
+    lexer.removeErrorListeners();
+    parser.removeErrorListeners();
+    lexer.addErrorListener(&visitor);
+    parser.addErrorListener(&visitor);
+    parser.removeParseListeners();
+    parser.addParseListener(&recursion_listener);
+
+    // The error recovery attempt budget is per expression, so the strategy
+    // cannot be carried over from the previous entry.
+    parser.setErrorHandler(std::make_shared<RecoveryLimitErrorStrategy>(
+        options.error_recovery_limit,
+        options.error_recovery_token_lookahead_limit));
+
+    tokens.setTokenSource(&lexer);
+    parser.setTokenStream(&tokens);
+
+    Expr expr;
+    try {
+      expr = ExprFromAny(visitor.visit(parser.start()));
+    } catch (const ParseCancellationException& e) {
+      if (visitor.HasErrored()) {
+        return absl::InvalidArgumentError(visitor.ErrorMessage());
+      }
+      return absl::CancelledError(e.what());
+    }
+
+    if (visitor.HasErrored()) {
+      return absl::InvalidArgumentError(visitor.ErrorMessage());
+    }
+
+    ParsedExpr parsed_expr;
+    CEL_RETURN_IF_ERROR(cel::extensions::protobuf_internal::ExprToProto(
+        expr, parsed_expr.mutable_expr()));
+    CEL_RETURN_IF_ERROR(
+        visitor.GetSourceInfo(parsed_expr.mutable_source_info()));
+    return parsed_expr;
+  } catch (const std::exception& e) {
+    return absl::AbortedError(e.what());
+  } catch (const char* what) {
+    // ANTLRv4 has historically thrown C string literals.
+    return absl::AbortedError(what);
+  } catch (...) {
+    // We guarantee to never throw and always return a status.
+    return absl::UnknownError("An unknown exception occurred");
+  }
+}
+
 }  // namespace
 
 absl::StatusOr<ParsedExpr> Parse(absl::string_view expression,
                                  absl::string_view description,
                                  const ParserOptions& options) {
+  if (!options.enable_expression_cache) {
+    return ParseImpl(expression, description, options);
+  }
+  ParseCacheKey key(expression, description, options);
+  if (auto cached = ParseCache::Global().Lookup(key); cached != nullptr) {
+    return *cached;
+  }
+  CEL_ASSIGN_OR_RETURN(ParsedExpr parsed,
+                       ParseImpl(expression, description, options));
+  auto shared = std::make_shared<const ParsedExpr>(std::move(parsed));
+  ParseCache::Global().Insert(std::move(key), shared);
+  return *shared;
+}
+
+std::vector<absl::StatusOr<ParsedExpr>> ParseBundle(
+    absl::Span<const std::string> expressions, absl::string_view description,
+    const ParserOptions& options) {
+  std::vector<absl::StatusOr<ParsedExpr>> results;
+  results.reserve(expressions.size());
+  if (expressions.empty()) {
+    return results;
+  }
+
+  // The macro set and registry are a function of the options alone, so build
+  // them once for the whole bundle instead of once per entry.
   std::vector<Macro> macros = Macro::AllMacros();
   if (options.enable_optional_syntax) {
     macros.push_back(cel::OptMapMacro());
     macros.push_back(cel::OptFlatMapMacro());
   }
-  return ParseWithMacros(expression, macros, description, options);
+  cel::MacroRegistry macro_registry;
+  if (absl::Status status = macro_registry.RegisterMacros(macros);
+      !status.ok()) {
+    results.assign(expressions.size(), status);
+    return results;
+  }
+
+  // One lexer, token buffer and parser serve the whole bundle; each entry
+  // resets them instead of paying construction cost again. `source` and
+  // `input` keep the current entry's source text and character stream alive
+  // between entries; the initial empty stream only exists so that
+  // construction sees a valid input before the first entry is installed.
+  cel::SourcePtr source;
+  auto input =
+      std::make_unique<CodePointStream>(cel::SourceContentView(), description);
+  CelLexer lexer(input.get());
+  CommonTokenStream tokens(&lexer);
+  CelParser parser(&tokens);
+
+  for (const std::string& expression : expressions) {
+    results.push_back(ParseBundleEntry(lexer, tokens, parser, source, input,
+                                       expression, description, macro_registry,
+                                       options));
+  }
+  return results;
 }
 
 absl::StatusOr<ParsedExpr> ParseWithMacros(absl::string_view expression,
@@ -1610,6 +1880,46 @@ absl::StatusOr<ParsedExpr> ParseWithMacros(absl::string_view expression,
   return verbose_parsed_expr.parsed_expr();
 }
 
+struct ParserState::Impl {
+  Impl()
+      : input(std::make_unique<CodePointStream>(cel::SourceContentView(),
+                                                absl::string_view())),
+        lexer(input.get()),
+        tokens(&lexer),
+        parser(&tokens) {}
+
+  // Source text and character stream of the most recent parse. Kept alive
+  // between calls because installing the next stream still touches the one
+  // being replaced; the initial empty stream only exists so construction
+  // sees a valid input.
+  cel::SourcePtr source;
+  std::unique_ptr<CodePointStream> input;
+  CelLexer lexer;
+  CommonTokenStream tokens;
+  CelParser parser;
+};
+
+ParserState::ParserState() : impl_(std::make_unique<Impl>()) {}
+
+ParserState::~ParserState() = default;
+
+ParserState::ParserState(ParserState&&) = default;
+
+ParserState& ParserState::operator=(ParserState&&) = default;
+
+absl::StatusOr<ParsedExpr> ParseWithMacros(ParserState& state,
+                                           absl::string_view expression,
+                                           const std::vector<Macro>& macros,
+                                           absl::string_view description,
+                                           const ParserOptions& options) {
+  cel::MacroRegistry macro_registry;
+  CEL_RETURN_IF_ERROR(macro_registry.RegisterMacros(macros));
+  ParserState::Impl& impl = *state.impl_;
+  return ParseBundleEntry(impl.lexer, impl.tokens, impl.parser, impl.source,
+                          impl.input, expression, description, macro_registry,
+                          options);
+}
+
 absl::StatusOr<VerboseParsedExpr> EnrichedParse(
     absl::string_view expression, const std::vector<Macro>& macros,
     absl::string_view description, const ParserOptions& options) {
@@ -1636,7 +1946,8 @@ absl::StatusOr<VerboseParsedExpr> EnrichedParse(
     ExprRecursionListener listener(options.max_recursion_depth);
     ParserVisitor visitor(source, options.max_recursion_depth, registry,
                           options.add_macro_calls,
-                          options.enable_optional_syntax);
+                          options.enable_optional_syntax,
+                          options.max_expression_node_count);
 
     lexer.removeErrorListeners();
     parser.removeErrorListeners();
@@ -15,12 +15,15 @@
 #ifndef THIRD_PARTY_CEL_CPP_PARSER_PARSER_H_
 #define THIRD_PARTY_CEL_CPP_PARSER_PARSER_H_
 
+#include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "google/api/expr/v1alpha1/syntax.pb.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "common/source.h"
 #include "parser/macro.h"
 #include "parser/macro_registry.h"
@@ -57,11 +60,55 @@ absl::StatusOr<google::api::expr::v1alpha1::ParsedExpr> Parse(
     absl::string_view expression, absl::string_view description = "<input>",
     const ParserOptions& options = ParserOptions());
 
+// Parses every expression in `expressions` independently and returns one
+// result per entry, in order. Equivalent to calling `Parse` on each entry,
+// but the ANTLR lexer, parser and token buffer are constructed once and
+// reset between entries, which is significantly cheaper when loading a file
+// containing many expressions. A malformed entry produces an error status in
+// its slot without affecting the other entries.
+std::vector<absl::StatusOr<google::api::expr::v1alpha1::ParsedExpr>>
+ParseBundle(absl::Span<const std::string> expressions,
+            absl::string_view description = "<input>",
+            const ParserOptions& options = ParserOptions());
+
 absl::StatusOr<google::api::expr::v1alpha1::ParsedExpr> ParseWithMacros(
     absl::string_view expression, const std::vector<Macro>& macros,
     absl::string_view description = "<input>",
     const ParserOptions& options = ParserOptions());
 
+// Reusable scratch state for repeated parses.
+//
+// Holds the ANTLR lexer, parser and token buffer so that each parse resets
+// them instead of reconstructing them -- the same reuse `ParseBundle` applies
+// internally, but available when expressions arrive one at a time rather
+// than as a batch. Move-only; not thread safe, use one instance per thread.
+class ParserState final {
+ public:
+  ParserState();
+  ~ParserState();
+
+  ParserState(ParserState&&);
+  ParserState& operator=(ParserState&&);
+
+  ParserState(const ParserState&) = delete;
+  ParserState& operator=(const ParserState&) = delete;
+
+ private:
+  friend absl::StatusOr<google::api::expr::v1alpha1::ParsedExpr>
+  ParseWithMacros(ParserState&, absl::string_view, const std::vector<Macro>&,
+                  absl::string_view, const ParserOptions&);
+
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+// As `ParseWithMacros` above, but reuses the lexer, parser and token buffer
+// held by `state` instead of constructing them for this call alone.
+absl::StatusOr<google::api::expr::v1alpha1::ParsedExpr> ParseWithMacros(
+    ParserState& state, absl::string_view expression,
+    const std::vector<Macro>& macros, absl::string_view description = "<input>",
+    const ParserOptions& options = ParserOptions());
+
 absl::StatusOr<VerboseParsedExpr> EnrichedParse(
     const cel::Source& source, const cel::MacroRegistry& registry,
     const ParserOptions& options = ParserOptions());
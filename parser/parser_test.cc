@@ -1495,6 +1495,125 @@ TEST(ExpressionTest, RecursionDepthIgnoresParentheses) {
   EXPECT_THAT(result, IsOk());
 }
 
+TEST(ExpressionTest, ExpressionCacheRepeatParsesAgree) {
+  ParserOptions options;
+  options.enable_expression_cache = true;
+
+  ASSERT_OK_AND_ASSIGN(auto first,
+                       Parse("has(a.b) && a.b.c.matches('[0-9]+')",
+                             "<input>", options));
+  ASSERT_OK_AND_ASSIGN(auto second,
+                       Parse("has(a.b) && a.b.c.matches('[0-9]+')",
+                             "<input>", options));
+
+  EXPECT_EQ(first.DebugString(), second.DebugString());
+}
+
+TEST(ExpressionTest, ExpressionCacheKeyedByOptions) {
+  ParserOptions with_macro_calls;
+  with_macro_calls.enable_expression_cache = true;
+  with_macro_calls.add_macro_calls = true;
+
+  ParserOptions without_macro_calls;
+  without_macro_calls.enable_expression_cache = true;
+  without_macro_calls.add_macro_calls = false;
+
+  ASSERT_OK_AND_ASSIGN(auto with,
+                       Parse("[1, 2, 3].exists(x, x > 2)", "<input>",
+                             with_macro_calls));
+  ASSERT_OK_AND_ASSIGN(auto without,
+                       Parse("[1, 2, 3].exists(x, x > 2)", "<input>",
+                             without_macro_calls));
+
+  EXPECT_FALSE(with.source_info().macro_calls().empty());
+  EXPECT_TRUE(without.source_info().macro_calls().empty());
+}
+
+TEST(ExpressionTest, ExpressionCacheDoesNotCacheErrors) {
+  ParserOptions options;
+  options.enable_expression_cache = true;
+
+  EXPECT_THAT(Parse("1 +", "<input>", options), Not(IsOk()));
+  EXPECT_THAT(Parse("1 +", "<input>", options), Not(IsOk()));
+  EXPECT_THAT(Parse("1 + 1", "<input>", options), IsOk());
+}
+
+TEST(ExpressionTest, ParseBundleMatchesIndividualParse) {
+  std::vector<std::string> expressions = {
+      "1 + 2 * 3",
+      "has(a.b) && a.b.c.matches('[0-9]+')",
+      "[1, 2, 3].exists(x, x > 2)",
+  };
+
+  auto results = ParseBundle(expressions);
+
+  ASSERT_EQ(results.size(), expressions.size());
+  for (size_t i = 0; i < expressions.size(); ++i) {
+    ASSERT_OK_AND_ASSIGN(auto individual, Parse(expressions[i]));
+    ASSERT_THAT(results[i], IsOk());
+    EXPECT_EQ(results[i]->DebugString(), individual.DebugString());
+  }
+}
+
+TEST(ExpressionTest, ParseBundleIsolatesErrors) {
+  std::vector<std::string> expressions = {"1 + 1", "1 +", "2 + 2"};
+
+  auto results = ParseBundle(expressions);
+
+  ASSERT_EQ(results.size(), 3);
+  EXPECT_THAT(results[0], IsOk());
+  EXPECT_THAT(results[1], Not(IsOk()));
+  EXPECT_THAT(results[1].status().message(), HasSubstr("Syntax error"));
+  EXPECT_THAT(results[2], IsOk());
+}
+
+TEST(ExpressionTest, ParseBundleEmpty) {
+  EXPECT_TRUE(ParseBundle({}).empty());
+}
+
+TEST(ExpressionTest, NodeCountLimit) {
+  ParserOptions options;
+  options.max_expression_node_count = 4;
+
+  EXPECT_THAT(Parse("1 + 2", "<input>", options), IsOk());
+
+  auto result = Parse("1 + 2 + 3 + 4 + 5 + 6 + 7 + 8", "<input>", options);
+  EXPECT_THAT(result, Not(IsOk()));
+  EXPECT_THAT(result.status().message(),
+              HasSubstr("node count exceeds limit"));
+
+  // Nodes synthesized by macro expansion count toward the limit even when
+  // the source text is small.
+  EXPECT_THAT(Parse("[1, 2].exists(x, x > 0)", "<input>", options),
+              Not(IsOk()));
+}
+
+TEST(ExpressionTest, ParserStateReuseMatchesIndividualParse) {
+  std::vector<std::string> expressions = {
+      "1 + 2 * 3",
+      "has(a.b) && a.b.c.matches('[0-9]+')",
+      "[1, 2, 3].exists(x, x > 2)",
+  };
+  std::vector<Macro> macros = Macro::AllMacros();
+
+  ParserState state;
+  for (const auto& expression : expressions) {
+    ASSERT_OK_AND_ASSIGN(auto reused,
+                         ParseWithMacros(state, expression, macros));
+    ASSERT_OK_AND_ASSIGN(auto individual, ParseWithMacros(expression, macros));
+    EXPECT_EQ(reused.DebugString(), individual.DebugString());
+  }
+}
+
+TEST(ExpressionTest, ParserStateReuseIsolatesErrors) {
+  std::vector<Macro> macros = Macro::AllMacros();
+
+  ParserState state;
+  EXPECT_THAT(ParseWithMacros(state, "1 + 1", macros), IsOk());
+  EXPECT_THAT(ParseWithMacros(state, "1 +", macros), Not(IsOk()));
+  EXPECT_THAT(ParseWithMacros(state, "2 + 2", macros), IsOk());
+}
+
 std::string TestName(const testing::TestParamInfo<TestInfo>& test_info) {
   std::string name = absl::StrCat(test_info.index, "-", test_info.param.I);
   absl::c_replace_if(name, [](char c) { return !absl::ascii_isalnum(c); }, '_');
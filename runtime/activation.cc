@@ -14,22 +14,71 @@
 
 #include "runtime/activation.h"
 
+#include <cstddef>
 #include <memory>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "base/function.h"
 #include "base/function_descriptor.h"
+#include "base/kind.h"
+#include "common/internal/shared_byte_string.h"
 #include "common/value.h"
 #include "internal/status_macros.h"
 #include "runtime/function_overload_reference.h"
+#include "runtime/internal/value_hash.h"
 
 namespace cel {
 
+namespace {
+
+// Decorator caching Invoke results keyed by an argument hash. See
+// Activation::FunctionMemoization::kMemoized for the contract; thread
+// compatibility matches the activation's provided-value memoization (the memo
+// table is internally synchronized).
+class MemoizedFunction final : public Function {
+ public:
+  explicit MemoizedFunction(std::unique_ptr<Function> impl)
+      : impl_(std::move(impl)) {}
+
+  absl::StatusOr<Value> Invoke(const InvokeContext& context,
+                               absl::Span<const Value> args) const override {
+    absl::optional<size_t> key = runtime_internal::HashPrimitiveValues(args);
+    if (!key.has_value()) {
+      return impl_->Invoke(context, args);
+    }
+    {
+      absl::MutexLock lock(&mutex_);
+      auto it = memo_.find(*key);
+      if (it != memo_.end()) {
+        return it->second;
+      }
+    }
+    CEL_ASSIGN_OR_RETURN(Value result, impl_->Invoke(context, args));
+    // Error and unknown results depend on evaluation context (attribute
+    // tracking, partial inputs), so only plain results are cached.
+    if (!result->Is<ErrorValue>() && !result->Is<UnknownValue>()) {
+      absl::MutexLock lock(&mutex_);
+      memo_.insert_or_assign(*key, result);
+    }
+    return result;
+  }
+
+ private:
+  std::unique_ptr<Function> impl_;
+  mutable absl::Mutex mutex_;
+  mutable absl::flat_hash_map<size_t, Value> memo_;
+};
+
+}  // namespace
+
 absl::StatusOr<bool> Activation::FindVariable(ValueManager& factory,
                                               absl::string_view name,
                                               Value& result) const {
@@ -42,6 +91,14 @@ absl::StatusOr<bool> Activation::FindVariable(ValueManager& factory,
   if (entry.provider.has_value()) {
     return ProvideValue(factory, name, result);
   }
+  if (entry.handle.has_value()) {
+    const absl::optional<Value>& slot = handle_values_[*entry.handle];
+    if (slot.has_value()) {
+      result = *slot;
+      return true;
+    }
+    return false;
+  }
   if (entry.value.has_value()) {
     result = *entry.value;
     return true;
@@ -84,12 +141,77 @@ std::vector<FunctionOverloadReference> Activation::FindFunctionOverloads(
   return result;
 }
 
+absl::StatusOr<absl::optional<FunctionOverloadReference>>
+Activation::FindFunctionOverload(absl::string_view name, bool receiver_style,
+                                 absl::Span<const Kind> types) const {
+  absl::optional<FunctionOverloadReference> matched;
+  auto iter = functions_.find(name);
+  if (iter == functions_.end()) {
+    return matched;
+  }
+  for (const FunctionEntry& overload : iter->second) {
+    if (overload.descriptor->ShapeMatches(receiver_style, types)) {
+      if (matched.has_value()) {
+        return absl::Status(absl::StatusCode::kInvalidArgument,
+                            "Couldn't resolve function.");
+      }
+      matched.emplace(FunctionOverloadReference{*overload.descriptor,
+                                                *overload.implementation});
+    }
+  }
+  return matched;
+}
+
 bool Activation::InsertOrAssignValue(absl::string_view name, Value value) {
   return values_
       .insert_or_assign(name, ValueEntry{std::move(value), absl::nullopt})
       .second;
 }
 
+Activation::BindingHandle Activation::BindHandle(absl::string_view name) {
+  ValueEntry& entry = values_.try_emplace(name).first->second;
+  if (entry.handle.has_value()) {
+    return *entry.handle;
+  }
+  entry.provider.reset();
+  const BindingHandle handle = handle_values_.size();
+  handle_values_.push_back(std::move(entry.value));
+  entry.value.reset();
+  entry.handle = handle;
+  return handle;
+}
+
+bool Activation::InsertOrAssignBorrowedString(absl::string_view name,
+                                              absl::string_view value) {
+  // The two-argument SharedByteString constructor produces the borrowed
+  // (non-owning) representation; StringValue(absl::string_view) would copy.
+  return InsertOrAssignValue(
+      name, StringValue(common_internal::SharedByteString(
+                /*refcount=*/nullptr, value)));
+}
+
+void Activation::InsertOrAssignValues(
+    absl::Span<std::pair<absl::string_view, Value>> entries) {
+  values_.reserve(values_.size() + entries.size());
+  for (auto& entry : entries) {
+    values_.insert_or_assign(
+        entry.first, ValueEntry{std::move(entry.second), absl::nullopt});
+  }
+}
+
+void Activation::ClearValues() {
+  absl::erase_if(values_, [](const auto& entry) {
+    return !entry.second.provider.has_value() &&
+           !entry.second.handle.has_value();
+  });
+  for (auto& entry : values_) {
+    entry.second.value.reset();
+  }
+  for (absl::optional<Value>& slot : handle_values_) {
+    slot.reset();
+  }
+}
+
 bool Activation::InsertOrAssignValueProvider(absl::string_view name,
                                              ValueProvider provider) {
   return values_
@@ -110,6 +232,15 @@ bool Activation::InsertFunction(const cel::FunctionDescriptor& descriptor,
   return true;
 }
 
+bool Activation::InsertFunction(const cel::FunctionDescriptor& descriptor,
+                                std::unique_ptr<cel::Function> impl,
+                                FunctionMemoization memoization) {
+  if (memoization == FunctionMemoization::kMemoized) {
+    impl = std::make_unique<MemoizedFunction>(std::move(impl));
+  }
+  return InsertFunction(descriptor, std::move(impl));
+}
+
 Activation::Activation(Activation&& other) {
   using std::swap;
   swap(*this, other);
@@ -15,11 +15,13 @@
 #ifndef THIRD_PARTY_CEL_CPP_RUNTIME_ACTIVATION_H_
 #define THIRD_PARTY_CEL_CPP_RUNTIME_ACTIVATION_H_
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/functional/any_invocable.h"
 #include "absl/status/statusor.h"
@@ -28,8 +30,10 @@
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "base/attribute.h"
+#include "base/attribute_pattern_index.h"
 #include "base/function.h"
 #include "base/function_descriptor.h"
+#include "base/kind.h"
 #include "common/value.h"
 #include "common/value_manager.h"
 #include "runtime/activation_interface.h"
@@ -63,6 +67,12 @@ class Activation final : public ActivationInterface {
   std::vector<FunctionOverloadReference> FindFunctionOverloads(
       absl::string_view name) const override;
 
+  // Scans the activation's own overload storage without materializing a
+  // candidate vector.
+  absl::StatusOr<absl::optional<FunctionOverloadReference>>
+  FindFunctionOverload(absl::string_view name, bool receiver_style,
+                       absl::Span<const Kind> types) const override;
+
   absl::Span<const cel::AttributePattern> GetUnknownAttributes()
       const override {
     return unknown_patterns_;
@@ -73,11 +83,69 @@ class Activation final : public ActivationInterface {
     return missing_patterns_;
   }
 
+  // Preallocates storage for at least `capacity` variable bindings.
+  void Reserve(size_t capacity) { values_.reserve(capacity); }
+
   // Bind a value to a named variable.
   //
   // Returns false if the entry for name was overwritten.
   bool InsertOrAssignValue(absl::string_view name, Value value);
 
+  // Bind a string variable whose character storage is borrowed from the
+  // caller instead of copied. The bound `StringValue` carries a non-owning
+  // reference to `value`, so the caller must guarantee that the storage
+  // stays valid and unchanged until the last evaluation using this
+  // activation completes -- including the lifetime of any evaluation result
+  // that may reference the bound string (results outliving the storage must
+  // not be possible in the caller's usage). Nothing enforces the contract at
+  // runtime; when the lifetime is not clearly scoped, bind an owned value
+  // with InsertOrAssignValue instead.
+  //
+  // Intended for request-scoped bindings (header strings and the like) that
+  // would otherwise be copied on every request. `value` must be valid UTF-8.
+  //
+  // Returns false if the entry for name was overwritten.
+  bool InsertOrAssignBorrowedString(absl::string_view name,
+                                    absl::string_view value);
+
+  // A stable handle to a variable binding, returned by BindHandle. Handles
+  // remain valid for the lifetime of the activation (moves transfer them).
+  using BindingHandle = size_t;
+
+  // Returns a stable handle for `name`, binding the variable if it is not
+  // already bound. A value already bound to the name is preserved; a value
+  // provider bound to the name is replaced. The name is hashed only here:
+  // rebinding through SetByHandle is a plain array store with no hashing,
+  // allocation or entry churn, which is the cheap way to rebind the same few
+  // variables per event on an activation kept alive across many
+  // evaluations.
+  //
+  // Re-binding the name afterwards with InsertOrAssignValue or a value
+  // provider detaches the handle; SetByHandle calls on a detached handle are
+  // not observed by lookups.
+  BindingHandle BindHandle(absl::string_view name);
+
+  // Rebinds the variable behind `handle` to `value`. `handle` must have been
+  // returned by BindHandle on this activation.
+  void SetByHandle(BindingHandle handle, Value value) {
+    handle_values_[handle] = std::move(value);
+  }
+
+  // Bind each name/value pair in `entries`, moving the values out. A single
+  // hash table reservation covers the whole batch, which is cheaper than
+  // inserting bindings one at a time when rebuilding a large activation per
+  // request.
+  void InsertOrAssignValues(
+      absl::Span<std::pair<absl::string_view, Value>> entries);
+
+  // Removes all value bindings while retaining hash table capacity, so a
+  // long-lived activation can be refilled per request without reallocating.
+  // Provider entries are kept, with any memoized results discarded so
+  // providers run again on the next lookup. Handle-bound entries are kept
+  // with their slots unbound, so existing handles stay valid. Functions and
+  // unknown or missing patterns are unaffected.
+  void ClearValues();
+
   // Bind a provider to a named variable. The result of the provider may be
   // memoized by the activation.
   //
@@ -87,23 +155,62 @@ class Activation final : public ActivationInterface {
 
   void SetUnknownPatterns(std::vector<cel::AttributePattern> patterns) {
     unknown_patterns_ = std::move(patterns);
+    RebuildIndex(unknown_patterns_, unknown_index_);
   }
 
   void SetMissingPatterns(std::vector<cel::AttributePattern> patterns) {
     missing_patterns_ = std::move(patterns);
+    RebuildIndex(missing_patterns_, missing_index_);
   }
 
+  absl::Nullable<const AttributePatternIndex*> GetUnknownAttributesIndex()
+      const override {
+    return unknown_index_.has_value() ? &*unknown_index_ : nullptr;
+  }
+
+  absl::Nullable<const AttributePatternIndex*> GetMissingAttributesIndex()
+      const override {
+    return missing_index_.has_value() ? &*missing_index_ : nullptr;
+  }
+
+  // Controls whether results of a function registered on this activation are
+  // memoized for the activation's lifetime.
+  enum class FunctionMemoization {
+    kDisabled,
+    // Invoke results are cached in the activation, keyed by a combined hash
+    // of the arguments. Only calls whose arguments are all primitive values
+    // (bool, int, uint, double, string, bytes, null, duration, timestamp)
+    // are memoized; calls with aggregate or opaque arguments, and calls
+    // producing error or unknown results, re-invoke every time.
+    //
+    // Only sound for functions that are pure for the life of the activation.
+    // Cached values are returned to later evaluations, so the values the
+    // function creates must remain valid for the activation's lifetime: do
+    // not memoize functions that allocate results on a shorter-lived arena.
+    kMemoized,
+  };
+
   // Returns true if the function was inserted (no other registered function has
   // a matching descriptor).
   bool InsertFunction(const cel::FunctionDescriptor& descriptor,
                       std::unique_ptr<cel::Function> impl);
 
+  // As above, with an explicit memoization policy. A lazily bound lookup
+  // function that is called repeatedly with identical arguments during one
+  // request runs once when registered with `kMemoized`.
+  bool InsertFunction(const cel::FunctionDescriptor& descriptor,
+                      std::unique_ptr<cel::Function> impl,
+                      FunctionMemoization memoization);
+
  private:
   struct ValueEntry {
     // If provider is present, then access must be synchronized to maintain
     // thread-compatible semantics for the lazily provided value.
     absl::optional<Value> value;
     absl::optional<ValueProvider> provider;
+    // Index into handle_values_ for handle-bound variables; the slot holds
+    // the binding and `value` stays unset.
+    absl::optional<BindingHandle> handle;
   };
 
   struct FunctionEntry {
@@ -114,9 +221,23 @@ class Activation final : public ActivationInterface {
   friend void swap(Activation& a, Activation& b) {
     using std::swap;
     swap(a.values_, b.values_);
+    swap(a.handle_values_, b.handle_values_);
     swap(a.functions_, b.functions_);
     swap(a.unknown_patterns_, b.unknown_patterns_);
     swap(a.missing_patterns_, b.missing_patterns_);
+    swap(a.unknown_index_, b.unknown_index_);
+    swap(a.missing_index_, b.missing_index_);
+  }
+
+  // Indexes pattern sets large enough that per-access linear scans hurt;
+  // built once here so every evaluation against this activation shares it.
+  static void RebuildIndex(const std::vector<cel::AttributePattern>& patterns,
+                           absl::optional<AttributePatternIndex>& index) {
+    if (patterns.size() > AttributePatternIndex::kDirectScanThreshold) {
+      index.emplace(patterns);
+    } else {
+      index.reset();
+    }
   }
 
   // Internal getter for provided values.
@@ -129,9 +250,14 @@ class Activation final : public ActivationInterface {
   // mutex_ used for safe caching of provided variables
   mutable absl::Mutex mutex_;
   mutable absl::flat_hash_map<std::string, ValueEntry> values_;
+  // Slot storage for handle-bound variables; indexed by BindingHandle and
+  // never shrunk, so handles stay stable as other bindings come and go.
+  std::vector<absl::optional<Value>> handle_values_;
 
   std::vector<cel::AttributePattern> unknown_patterns_;
   std::vector<cel::AttributePattern> missing_patterns_;
+  absl::optional<AttributePatternIndex> unknown_index_;
+  absl::optional<AttributePatternIndex> missing_index_;
 
   absl::flat_hash_map<std::string, std::vector<FunctionEntry>> functions_;
 };
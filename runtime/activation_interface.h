@@ -17,11 +17,15 @@
 
 #include <vector>
 
+#include "absl/base/nullability.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "base/attribute.h"
+#include "base/attribute_pattern_index.h"
+#include "base/kind.h"
 #include "common/value.h"
 #include "common/value_manager.h"
 #include "internal/status_macros.h"
@@ -29,6 +33,8 @@
 
 namespace cel {
 
+class SlotActivation;
+
 // Interface for providing runtime with variable lookups.
 //
 // Clients should prefer to use one of the concrete implementations provided by
@@ -57,6 +63,30 @@ class ActivationInterface {
   virtual std::vector<FunctionOverloadReference> FindFunctionOverloads(
       absl::string_view name) const = 0;
 
+  // Resolves the unique context function overload whose shape matches the
+  // given call signature.
+  //
+  // Allocation-free counterpart of `FindFunctionOverloads` for the
+  // evaluator's call hot path: implementations should scan their own storage
+  // rather than materializing a candidate vector. Returns an empty optional
+  // if no overload matches, and an InvalidArgument status if more than one
+  // does. The default implementation falls back to `FindFunctionOverloads`.
+  virtual absl::StatusOr<absl::optional<FunctionOverloadReference>>
+  FindFunctionOverload(absl::string_view name, bool receiver_style,
+                       absl::Span<const Kind> types) const {
+    absl::optional<FunctionOverloadReference> matched;
+    for (const auto& overload : FindFunctionOverloads(name)) {
+      if (overload.descriptor.ShapeMatches(receiver_style, types)) {
+        if (matched.has_value()) {
+          return absl::Status(absl::StatusCode::kInvalidArgument,
+                              "Couldn't resolve function.");
+        }
+        matched.emplace(overload);
+      }
+    }
+    return matched;
+  }
+
   // Return a list of unknown attribute patterns.
   //
   // If an attribute (select path) encountered during evaluation matches any of
@@ -78,6 +108,30 @@ class ActivationInterface {
   // using this activation.
   virtual absl::Span<const cel::AttributePattern> GetMissingAttributes()
       const = 0;
+
+  // Optional prebuilt index over GetUnknownAttributes(), bucketed by root
+  // variable. Implementations that own their patterns may build the index
+  // once when patterns are bound and share it across evaluations; when null
+  // (the default), the evaluator indexes large pattern sets itself, once per
+  // evaluation. Must stay valid as long as GetUnknownAttributes().
+  virtual absl::Nullable<const AttributePatternIndex*>
+  GetUnknownAttributesIndex() const {
+    return nullptr;
+  }
+
+  // As above, for GetMissingAttributes().
+  virtual absl::Nullable<const AttributePatternIndex*>
+  GetMissingAttributesIndex() const {
+    return nullptr;
+  }
+
+  // Returns this activation as a SlotActivation if it resolves variables by
+  // precomputed slot index, nullptr otherwise. Planned ident steps use this
+  // to replace the per-access name lookup with an array read when the
+  // activation was built against the same binding plan.
+  virtual absl::Nullable<const SlotActivation*> AsSlotActivation() const {
+    return nullptr;
+  }
 };
 
 }  // namespace cel
@@ -15,10 +15,13 @@
 #include "runtime/activation.h"
 
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "base/attribute.h"
@@ -66,6 +69,26 @@ class FunctionImpl : public cel::Function {
   }
 };
 
+// Counts invocations; returns arg + 1 for a single int argument, null
+// otherwise.
+class CountingFunctionImpl : public cel::Function {
+ public:
+  explicit CountingFunctionImpl(int* call_count) : call_count_(call_count) {}
+
+  absl::StatusOr<Value> Invoke(const FunctionEvaluationContext& ctx,
+                               absl::Span<const Value> args) const override {
+    ++*call_count_;
+    if (args.size() == 1 && args[0]->Is<IntValue>()) {
+      return ctx.value_factory().CreateIntValue(
+          args[0].As<IntValue>().NativeValue() + 1);
+    }
+    return NullValue();
+  }
+
+ private:
+  int* call_count_;
+};
+
 class ActivationTest : public testing::Test {
  public:
   ActivationTest()
@@ -103,6 +126,127 @@ TEST_F(ActivationTest, InsertValueOverwrite) {
               IsOkAndHolds(Optional(IsIntValue(0))));
 }
 
+TEST_F(ActivationTest, BulkInsert) {
+  Activation activation;
+  std::vector<std::pair<absl::string_view, Value>> entries = {
+      {"var1", value_factory_.CreateIntValue(1)},
+      {"var2", value_factory_.CreateIntValue(2)},
+      {"var3", value_factory_.CreateIntValue(3)}};
+
+  activation.InsertOrAssignValues(absl::MakeSpan(entries));
+
+  EXPECT_THAT(activation.FindVariable(value_factory_, "var1"),
+              IsOkAndHolds(Optional(IsIntValue(1))));
+  EXPECT_THAT(activation.FindVariable(value_factory_, "var2"),
+              IsOkAndHolds(Optional(IsIntValue(2))));
+  EXPECT_THAT(activation.FindVariable(value_factory_, "var3"),
+              IsOkAndHolds(Optional(IsIntValue(3))));
+}
+
+TEST_F(ActivationTest, InsertBorrowedString) {
+  Activation activation;
+  std::string backing = "request-scoped";
+
+  EXPECT_TRUE(activation.InsertOrAssignBorrowedString("var1", backing));
+
+  ASSERT_OK_AND_ASSIGN(auto var,
+                       activation.FindVariable(value_factory_, "var1"));
+  ASSERT_TRUE(var.has_value());
+  ASSERT_TRUE((*var)->Is<StringValue>());
+  std::string scratch;
+  absl::string_view contents = var->As<StringValue>().NativeString(scratch);
+  EXPECT_EQ(contents, "request-scoped");
+  // The binding borrows the caller's storage rather than copying it.
+  EXPECT_EQ(contents.data(), backing.data());
+}
+
+TEST_F(ActivationTest, BindHandleRebinds) {
+  Activation activation;
+  Activation::BindingHandle handle = activation.BindHandle("var1");
+
+  EXPECT_THAT(activation.FindVariable(value_factory_, "var1"),
+              IsOkAndHolds(Eq(absl::nullopt)));
+
+  activation.SetByHandle(handle, value_factory_.CreateIntValue(1));
+  EXPECT_THAT(activation.FindVariable(value_factory_, "var1"),
+              IsOkAndHolds(Optional(IsIntValue(1))));
+
+  activation.SetByHandle(handle, value_factory_.CreateIntValue(2));
+  EXPECT_THAT(activation.FindVariable(value_factory_, "var1"),
+              IsOkAndHolds(Optional(IsIntValue(2))));
+
+  // Binding the name again returns the same handle.
+  EXPECT_EQ(activation.BindHandle("var1"), handle);
+}
+
+TEST_F(ActivationTest, BindHandlePreservesExistingValue) {
+  Activation activation;
+  ASSERT_TRUE(activation.InsertOrAssignValue(
+      "var1", value_factory_.CreateIntValue(42)));
+
+  Activation::BindingHandle handle = activation.BindHandle("var1");
+  EXPECT_THAT(activation.FindVariable(value_factory_, "var1"),
+              IsOkAndHolds(Optional(IsIntValue(42))));
+
+  activation.SetByHandle(handle, value_factory_.CreateIntValue(1));
+  EXPECT_THAT(activation.FindVariable(value_factory_, "var1"),
+              IsOkAndHolds(Optional(IsIntValue(1))));
+}
+
+TEST_F(ActivationTest, ClearValuesRetainsHandles) {
+  Activation activation;
+  Activation::BindingHandle handle = activation.BindHandle("var1");
+  activation.SetByHandle(handle, value_factory_.CreateIntValue(1));
+
+  activation.ClearValues();
+
+  EXPECT_THAT(activation.FindVariable(value_factory_, "var1"),
+              IsOkAndHolds(Eq(absl::nullopt)));
+
+  // The handle survives clearing and can rebind without re-hashing.
+  activation.SetByHandle(handle, value_factory_.CreateIntValue(2));
+  EXPECT_THAT(activation.FindVariable(value_factory_, "var1"),
+              IsOkAndHolds(Optional(IsIntValue(2))));
+}
+
+TEST_F(ActivationTest, ClearValuesRefill) {
+  Activation activation;
+  activation.Reserve(2);
+  ASSERT_TRUE(activation.InsertOrAssignValue(
+      "var1", value_factory_.CreateIntValue(42)));
+
+  activation.ClearValues();
+
+  EXPECT_THAT(activation.FindVariable(value_factory_, "var1"),
+              IsOkAndHolds(Eq(absl::nullopt)));
+
+  ASSERT_TRUE(
+      activation.InsertOrAssignValue("var1", value_factory_.CreateIntValue(1)));
+  EXPECT_THAT(activation.FindVariable(value_factory_, "var1"),
+              IsOkAndHolds(Optional(IsIntValue(1))));
+}
+
+TEST_F(ActivationTest, ClearValuesRetainsProviders) {
+  Activation activation;
+  int call_count = 0;
+
+  ASSERT_TRUE(activation.InsertOrAssignValueProvider(
+      "var1", [&call_count](ValueManager& factory, absl::string_view name) {
+        call_count++;
+        return factory.CreateIntValue(42);
+      }));
+
+  EXPECT_THAT(activation.FindVariable(value_factory_, "var1"),
+              IsOkAndHolds(Optional(IsIntValue(42))));
+
+  // The provider survives clearing; its memoized result does not.
+  activation.ClearValues();
+
+  EXPECT_THAT(activation.FindVariable(value_factory_, "var1"),
+              IsOkAndHolds(Optional(IsIntValue(42))));
+  EXPECT_EQ(call_count, 2);
+}
+
 TEST_F(ActivationTest, InsertProvider) {
   Activation activation;
 
@@ -299,6 +443,118 @@ TEST_F(ActivationTest, InsertFunctionFails) {
       << "expected overload Fn(any)";
 }
 
+TEST_F(ActivationTest, FindFunctionOverloadMatchesShape) {
+  Activation activation;
+
+  ASSERT_TRUE(
+      activation.InsertFunction(FunctionDescriptor("Fn", false, {Kind::kUint}),
+                                std::make_unique<FunctionImpl>()));
+  ASSERT_TRUE(
+      activation.InsertFunction(FunctionDescriptor("Fn", false, {Kind::kInt}),
+                                std::make_unique<FunctionImpl>()));
+
+  EXPECT_THAT(activation.FindFunctionOverload("Fn", false, {Kind::kInt}),
+              IsOkAndHolds(Optional(
+                  Truly([](const FunctionOverloadReference& ref) {
+                    return ref.descriptor.name() == "Fn" &&
+                           ref.descriptor.types() ==
+                               std::vector<Kind>{Kind::kInt};
+                  }))));
+  EXPECT_THAT(activation.FindFunctionOverload("Fn", false, {Kind::kDouble}),
+              IsOkAndHolds(Eq(absl::nullopt)));
+  EXPECT_THAT(activation.FindFunctionOverload("Unknown", false, {Kind::kInt}),
+              IsOkAndHolds(Eq(absl::nullopt)));
+}
+
+TEST_F(ActivationTest, FindFunctionOverloadAmbiguous) {
+  Activation activation;
+
+  ASSERT_TRUE(
+      activation.InsertFunction(FunctionDescriptor("Fn", false, {Kind::kUint}),
+                                std::make_unique<FunctionImpl>()));
+  ASSERT_TRUE(
+      activation.InsertFunction(FunctionDescriptor("Fn", false, {Kind::kInt}),
+                                std::make_unique<FunctionImpl>()));
+
+  // A wildcard call signature matches both registered overloads.
+  EXPECT_THAT(activation.FindFunctionOverload("Fn", false, {Kind::kAny}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(ActivationTest, PatternIndexBuiltForLargeSets) {
+  Activation activation;
+
+  // At or below the direct-scan threshold no index is built.
+  activation.SetUnknownPatterns(
+      {AttributePattern("var1", {}), AttributePattern("var2", {})});
+  EXPECT_EQ(activation.GetUnknownAttributesIndex(), nullptr);
+
+  std::vector<AttributePattern> patterns;
+  for (int i = 0; i < 8; ++i) {
+    patterns.push_back(AttributePattern(
+        absl::StrCat("var", i), {AttributeQualifierPattern::OfString("f")}));
+  }
+  activation.SetUnknownPatterns(std::move(patterns));
+
+  const AttributePatternIndex* index = activation.GetUnknownAttributesIndex();
+  ASSERT_NE(index, nullptr);
+  EXPECT_THAT(index->PatternsForRoot("var3"), SizeIs(1));
+  EXPECT_THAT(index->PatternsForRoot("other"), IsEmpty());
+  EXPECT_EQ(activation.GetMissingAttributesIndex(), nullptr);
+}
+
+TEST_F(ActivationTest, MemoizedFunctionInvokesOncePerArguments) {
+  Activation activation;
+
+  int call_count = 0;
+  ASSERT_TRUE(activation.InsertFunction(
+      FunctionDescriptor("Fn", false, {Kind::kInt}),
+      std::make_unique<CountingFunctionImpl>(&call_count),
+      Activation::FunctionMemoization::kMemoized));
+
+  ASSERT_OK_AND_ASSIGN(auto overload,
+                       activation.FindFunctionOverload("Fn", false,
+                                                       {Kind::kInt}));
+  ASSERT_TRUE(overload.has_value());
+
+  Function::InvokeContext context(value_factory_);
+  std::vector<Value> args = {value_factory_.CreateIntValue(1)};
+  ASSERT_OK_AND_ASSIGN(Value first,
+                       overload->implementation.Invoke(context, args));
+  ASSERT_OK_AND_ASSIGN(Value second,
+                       overload->implementation.Invoke(context, args));
+  EXPECT_EQ(call_count, 1);
+  EXPECT_THAT(first, IsIntValue(2));
+  EXPECT_THAT(second, IsIntValue(2));
+
+  args = {value_factory_.CreateIntValue(20)};
+  ASSERT_OK_AND_ASSIGN(Value third,
+                       overload->implementation.Invoke(context, args));
+  EXPECT_EQ(call_count, 2);
+  EXPECT_THAT(third, IsIntValue(21));
+}
+
+TEST_F(ActivationTest, MemoizedFunctionBypassedForAggregateArguments) {
+  Activation activation;
+
+  int call_count = 0;
+  ASSERT_TRUE(activation.InsertFunction(
+      FunctionDescriptor("Fn", false, {Kind::kList}),
+      std::make_unique<CountingFunctionImpl>(&call_count),
+      Activation::FunctionMemoization::kMemoized));
+
+  ASSERT_OK_AND_ASSIGN(auto overload,
+                       activation.FindFunctionOverload("Fn", false,
+                                                       {Kind::kList}));
+  ASSERT_TRUE(overload.has_value());
+
+  Function::InvokeContext context(value_factory_);
+  std::vector<Value> args = {ListValue()};
+  ASSERT_OK(overload->implementation.Invoke(context, args).status());
+  ASSERT_OK(overload->implementation.Invoke(context, args).status());
+  EXPECT_EQ(call_count, 2);
+}
+
 TEST_F(ActivationTest, MoveAssignment) {
   Activation moved_from;
 
@@ -0,0 +1,204 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/columnar_activation.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+
+Column Column::Bool(absl::Span<const bool> values) {
+  Column column(Kind::kBool, values.size());
+  column.bool_values_ = values;
+  return column;
+}
+
+Column Column::Int64(absl::Span<const int64_t> values) {
+  Column column(Kind::kInt64, values.size());
+  column.int64_values_ = values;
+  return column;
+}
+
+Column Column::Uint64(absl::Span<const uint64_t> values) {
+  Column column(Kind::kUint64, values.size());
+  column.uint64_values_ = values;
+  return column;
+}
+
+Column Column::Double(absl::Span<const double> values) {
+  Column column(Kind::kDouble, values.size());
+  column.double_values_ = values;
+  return column;
+}
+
+Column Column::String(absl::Span<const int32_t> offsets,
+                      absl::string_view data) {
+  ABSL_DCHECK(!offsets.empty());
+  Column column(Kind::kString, offsets.empty() ? 0 : offsets.size() - 1);
+  column.string_offsets_ = offsets;
+  column.string_data_ = data;
+  return column;
+}
+
+Column Column::DictionaryString(absl::Span<const int32_t> codes,
+                                absl::Span<const int32_t> dictionary_offsets,
+                                absl::string_view dictionary_data) {
+  ABSL_DCHECK(!dictionary_offsets.empty());
+  Column column(Kind::kDictionaryString, codes.size());
+  column.dictionary_codes_ = codes;
+  column.string_offsets_ = dictionary_offsets;
+  column.string_data_ = dictionary_data;
+  return column;
+}
+
+Column& Column::WithValidity(absl::Span<const bool> validity) {
+  ABSL_DCHECK_EQ(validity.size(), row_count_);
+  validity_ = validity;
+  return *this;
+}
+
+absl::Status ColumnarBatch::AddColumn(absl::string_view name, Column column) {
+  if (columns_.empty()) {
+    row_count_ = column.row_count();
+  } else if (column.row_count() != row_count_) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("column \"", name, "\" has ", column.row_count(),
+                     " rows, batch has ", row_count_));
+  }
+  auto inserted =
+      columns_by_name_.insert_or_assign(std::string(name), columns_.size())
+          .second;
+  if (!inserted) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("duplicate column \"", name, "\""));
+  }
+  columns_.push_back(std::move(column));
+  return absl::OkStatus();
+}
+
+absl::StatusOr<bool> ColumnarRowActivation::FindVariable(
+    ValueManager& factory, absl::string_view name, Value& result) const {
+  auto it = batch_->columns_by_name_.find(name);
+  if (it == batch_->columns_by_name_.end()) {
+    return false;
+  }
+  const Column& column = batch_->columns_[it->second];
+  ABSL_DCHECK_LT(row_, column.row_count());
+  if (!column.validity_.empty() && !column.validity_[row_]) {
+    return false;
+  }
+  switch (column.kind_) {
+    case Column::Kind::kBool:
+      result = factory.CreateBoolValue(column.bool_values_[row_]);
+      return true;
+    case Column::Kind::kInt64:
+      result = factory.CreateIntValue(column.int64_values_[row_]);
+      return true;
+    case Column::Kind::kUint64:
+      result = factory.CreateUintValue(column.uint64_values_[row_]);
+      return true;
+    case Column::Kind::kDouble:
+      result = factory.CreateDoubleValue(column.double_values_[row_]);
+      return true;
+    case Column::Kind::kString: {
+      size_t begin = static_cast<size_t>(column.string_offsets_[row_]);
+      size_t end = static_cast<size_t>(column.string_offsets_[row_ + 1]);
+      result = StringValue(column.string_data_.substr(begin, end - begin));
+      return true;
+    }
+    case Column::Kind::kDictionaryString: {
+      const int32_t code = column.dictionary_codes_[row_];
+      ABSL_DCHECK_GE(code, 0);
+      ABSL_DCHECK_LT(static_cast<size_t>(code) + 1,
+                     column.string_offsets_.size());
+      size_t begin = static_cast<size_t>(column.string_offsets_[code]);
+      size_t end = static_cast<size_t>(column.string_offsets_[code + 1]);
+      result = StringValue(column.string_data_.substr(begin, end - begin));
+      return true;
+    }
+  }
+  return false;
+}
+
+absl::Status EvaluateColumns(const Program& program,
+                             const ColumnarBatch& batch,
+                             absl::Span<Value> results,
+                             ValueManager& value_factory) {
+  if (results.size() < batch.row_count()) {
+    return absl::InvalidArgumentError(
+        "EvaluateColumns: fewer result slots than rows");
+  }
+  ColumnarRowActivation activation(batch);
+
+  // A batch that is a single dictionary-encoded column can only produce
+  // results that depend on the row's dictionary code, so the program runs
+  // once per distinct code (plus once for rows marked absent) and results
+  // are broadcast to every row sharing the code.
+  if (batch.columns_.size() == 1 &&
+      batch.columns_.front().kind_ == Column::Kind::kDictionaryString) {
+    const Column& column = batch.columns_.front();
+    std::vector<absl::optional<Value>> memo(column.string_offsets_.size() - 1);
+    absl::optional<Value> absent_memo;
+    for (size_t row = 0; row < batch.row_count(); ++row) {
+      absl::optional<Value>* slot;
+      if (!column.validity_.empty() && !column.validity_[row]) {
+        slot = &absent_memo;
+      } else {
+        const int32_t code = column.dictionary_codes_[row];
+        if (code < 0 || static_cast<size_t>(code) >= memo.size()) {
+          return absl::InvalidArgumentError(absl::StrCat(
+              "EvaluateColumns: dictionary code ", code, " out of range"));
+        }
+        slot = &memo[static_cast<size_t>(code)];
+      }
+      if (!slot->has_value()) {
+        activation.set_row(row);
+        auto result = program.Evaluate(activation, value_factory);
+        if (!result.ok()) {
+          return std::move(result).status();
+        }
+        *slot = *std::move(result);
+      }
+      results[row] = **slot;
+    }
+    return absl::OkStatus();
+  }
+
+  for (size_t row = 0; row < batch.row_count(); ++row) {
+    activation.set_row(row);
+    auto result = program.Evaluate(activation, value_factory);
+    if (!result.ok()) {
+      return std::move(result).status();
+    }
+    results[row] = *std::move(result);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace cel
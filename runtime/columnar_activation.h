@@ -0,0 +1,193 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_COLUMNAR_ACTIVATION_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_COLUMNAR_ACTIVATION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "base/attribute.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "runtime/activation_interface.h"
+#include "runtime/function_overload_reference.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+
+// A typed column of row values backed by caller-owned contiguous storage.
+//
+// The spans must outlive any batch or activation referring to them; no data
+// is copied. String columns use the Arrow layout: one shared character
+// buffer plus `row_count + 1` byte offsets, so row i spans
+// [offsets[i], offsets[i + 1]).
+class Column final {
+ public:
+  static Column Bool(absl::Span<const bool> values);
+  static Column Int64(absl::Span<const int64_t> values);
+  static Column Uint64(absl::Span<const uint64_t> values);
+  static Column Double(absl::Span<const double> values);
+  static Column String(absl::Span<const int32_t> offsets,
+                       absl::string_view data);
+
+  // Dictionary-encoded string column (the Arrow dictionary layout): `codes`
+  // holds one dictionary index per row, and the dictionary itself is laid
+  // out as a string column of `dictionary_offsets.size() - 1` unique entries
+  // over `dictionary_data`. Suited to low-cardinality columns (country
+  // codes, verdict strings); see the memoizing fast path in EvaluateColumns.
+  static Column DictionaryString(absl::Span<const int32_t> codes,
+                                 absl::Span<const int32_t> dictionary_offsets,
+                                 absl::string_view dictionary_data);
+
+  // Marks individual rows as absent. `validity` must match the column's row
+  // count; rows with a false entry behave as unbound variables.
+  Column& WithValidity(absl::Span<const bool> validity);
+
+  size_t row_count() const { return row_count_; }
+
+ private:
+  friend class ColumnarRowActivation;
+  friend absl::Status EvaluateColumns(const Program& program,
+                                      const ColumnarBatch& batch,
+                                      absl::Span<Value> results,
+                                      ValueManager& value_factory);
+
+  enum class Kind {
+    kBool,
+    kInt64,
+    kUint64,
+    kDouble,
+    kString,
+    kDictionaryString,
+  };
+
+  Column(Kind kind, size_t row_count) : kind_(kind), row_count_(row_count) {}
+
+  Kind kind_;
+  size_t row_count_;
+  absl::Span<const bool> bool_values_;
+  absl::Span<const int64_t> int64_values_;
+  absl::Span<const uint64_t> uint64_values_;
+  absl::Span<const double> double_values_;
+  // For kDictionaryString these describe the dictionary entries rather than
+  // the rows, and dictionary_codes_ maps rows to entries.
+  absl::Span<const int32_t> string_offsets_;
+  absl::string_view string_data_;
+  absl::Span<const int32_t> dictionary_codes_;
+  absl::Span<const bool> validity_;
+};
+
+// A named collection of equal-length columns.
+//
+// Built once per batch of rows; the name -> column map replaces the per-row
+// InsertOrAssignValue calls that row-at-a-time ingestion would make.
+class ColumnarBatch final {
+ public:
+  ColumnarBatch() = default;
+
+  // Move only.
+  ColumnarBatch(ColumnarBatch&&) = default;
+  ColumnarBatch& operator=(ColumnarBatch&&) = default;
+
+  // Adds a column bound to the given variable name. All columns in a batch
+  // must have the same row count.
+  absl::Status AddColumn(absl::string_view name, Column column);
+
+  size_t row_count() const { return row_count_; }
+
+  size_t column_count() const { return columns_.size(); }
+
+ private:
+  friend class ColumnarRowActivation;
+  friend absl::Status EvaluateColumns(const Program& program,
+                                      const ColumnarBatch& batch,
+                                      absl::Span<Value> results,
+                                      ValueManager& value_factory);
+
+  std::vector<Column> columns_;
+  absl::flat_hash_map<std::string, size_t> columns_by_name_;
+  size_t row_count_ = 0;
+};
+
+// Activation exposing one row of a ColumnarBatch.
+//
+// Values are materialized on demand from the column storage when the
+// evaluator asks for them; advancing to the next row (set_row) is an index
+// update with no allocation, so one activation instance serves an entire
+// batch. Pairs with Program::EvaluateBatch or the EvaluateColumns helper
+// below.
+class ColumnarRowActivation final : public ActivationInterface {
+ public:
+  explicit ColumnarRowActivation(const ColumnarBatch& batch)
+      : batch_(&batch), row_(0) {}
+
+  // Implements ActivationInterface.
+  absl::StatusOr<bool> FindVariable(ValueManager& factory,
+                                    absl::string_view name,
+                                    Value& result) const override;
+  using ActivationInterface::FindVariable;
+
+  std::vector<FunctionOverloadReference> FindFunctionOverloads(
+      absl::string_view name) const override {
+    return {};
+  }
+
+  absl::Span<const cel::AttributePattern> GetUnknownAttributes()
+      const override {
+    return {};
+  }
+
+  absl::Span<const cel::AttributePattern> GetMissingAttributes()
+      const override {
+    return {};
+  }
+
+  // Selects the row exposed by this activation. Must be less than the
+  // batch's row count.
+  void set_row(size_t row) { row_ = row; }
+
+  size_t row() const { return row_; }
+
+ private:
+  const ColumnarBatch* batch_;
+  size_t row_;
+};
+
+// Evaluates the program once per row of the batch, writing one result per
+// row to `results` (which must be at least batch.row_count() long). A single
+// row activation is reused across the batch, so per-row cost is the
+// evaluation itself. CEL errors land in the corresponding result slot; the
+// first non-recoverable error aborts the batch.
+//
+// When the batch is a single dictionary-encoded column, the result can only
+// depend on the row's dictionary code, so the program is evaluated once per
+// distinct code (and once for rows marked absent) and the results are
+// broadcast per code — O(dictionary) evaluations instead of O(rows).
+absl::Status EvaluateColumns(const Program& program,
+                             const ColumnarBatch& batch,
+                             absl::Span<Value> results,
+                             ValueManager& value_factory);
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_COLUMNAR_ACTIVATION_H_
@@ -0,0 +1,244 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/columnar_activation.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/types/span.h"
+#include "base/function_adapter.h"
+#include "base/type_provider.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "common/values/legacy_value_manager.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/register_function_helper.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+
+namespace cel {
+namespace {
+
+using ::cel::extensions::ProtobufRuntimeAdapter;
+using ::google::api::expr::v1alpha1::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+using cel::internal::IsOkAndHolds;
+using cel::internal::StatusIs;
+using testing::HasSubstr;
+
+class ColumnarActivationTest : public testing::Test {
+ public:
+  ColumnarActivationTest()
+      : value_factory_(MemoryManagerRef::ReferenceCounting(),
+                       TypeProvider::Builtin()) {}
+
+ protected:
+  common_internal::LegacyValueManager value_factory_;
+};
+
+TEST_F(ColumnarActivationTest, RowViewExposesTypedColumns) {
+  std::vector<int64_t> ints = {1, 2, 3};
+  std::vector<double> doubles = {0.5, 1.5, 2.5};
+  // Arrow-style string column: shared buffer plus row offsets.
+  std::string string_data = "foobarbazqux";
+  std::vector<int32_t> offsets = {0, 3, 6, 12};
+
+  ColumnarBatch batch;
+  ASSERT_OK(batch.AddColumn("i", Column::Int64(ints)));
+  ASSERT_OK(batch.AddColumn("d", Column::Double(doubles)));
+  ASSERT_OK(batch.AddColumn("s", Column::String(offsets, string_data)));
+  EXPECT_EQ(batch.row_count(), 3);
+
+  ColumnarRowActivation activation(batch);
+  activation.set_row(1);
+
+  Value result;
+  ASSERT_THAT(activation.FindVariable(value_factory_, "i", result),
+              IsOkAndHolds(true));
+  EXPECT_EQ(result.As<IntValue>().NativeValue(), 2);
+  ASSERT_THAT(activation.FindVariable(value_factory_, "d", result),
+              IsOkAndHolds(true));
+  EXPECT_EQ(result.As<DoubleValue>().NativeValue(), 1.5);
+  ASSERT_THAT(activation.FindVariable(value_factory_, "s", result),
+              IsOkAndHolds(true));
+  EXPECT_EQ(result.As<StringValue>().ToString(), "bar");
+
+  activation.set_row(2);
+  ASSERT_THAT(activation.FindVariable(value_factory_, "s", result),
+              IsOkAndHolds(true));
+  EXPECT_EQ(result.As<StringValue>().ToString(), "bazqux");
+
+  EXPECT_THAT(activation.FindVariable(value_factory_, "missing", result),
+              IsOkAndHolds(false));
+}
+
+TEST_F(ColumnarActivationTest, MismatchedColumnLengthRejected) {
+  std::vector<int64_t> ints = {1, 2, 3};
+  std::vector<double> doubles = {0.5};
+
+  ColumnarBatch batch;
+  ASSERT_OK(batch.AddColumn("i", Column::Int64(ints)));
+  EXPECT_THAT(batch.AddColumn("d", Column::Double(doubles)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("rows")));
+  EXPECT_THAT(batch.AddColumn("i", Column::Int64(ints)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("duplicate")));
+}
+
+TEST_F(ColumnarActivationTest, ValidityMarksRowsAbsent) {
+  std::vector<int64_t> ints = {1, 2};
+  // Note: std::vector<bool> is bit-packed and cannot back a Span<const bool>.
+  const bool validity[] = {true, false};
+
+  ColumnarBatch batch;
+  ASSERT_OK(batch.AddColumn(
+      "i", Column::Int64(ints).WithValidity(absl::MakeConstSpan(validity))));
+
+  ColumnarRowActivation activation(batch);
+  Value result;
+  ASSERT_THAT(activation.FindVariable(value_factory_, "i", result),
+              IsOkAndHolds(true));
+  activation.set_row(1);
+  EXPECT_THAT(activation.FindVariable(value_factory_, "i", result),
+              IsOkAndHolds(false));
+}
+
+TEST_F(ColumnarActivationTest, DictionaryStringColumnDecodesPerRow) {
+  // Dictionary {"allow", "deny", "log"} with one code per row.
+  std::string dictionary_data = "allowdenylog";
+  std::vector<int32_t> dictionary_offsets = {0, 5, 9, 12};
+  std::vector<int32_t> codes = {1, 0, 2, 0};
+
+  ColumnarBatch batch;
+  ASSERT_OK(batch.AddColumn(
+      "verdict",
+      Column::DictionaryString(codes, dictionary_offsets, dictionary_data)));
+  EXPECT_EQ(batch.row_count(), 4);
+
+  ColumnarRowActivation activation(batch);
+  Value result;
+  ASSERT_THAT(activation.FindVariable(value_factory_, "verdict", result),
+              IsOkAndHolds(true));
+  EXPECT_EQ(result.As<StringValue>().ToString(), "deny");
+  activation.set_row(2);
+  ASSERT_THAT(activation.FindVariable(value_factory_, "verdict", result),
+              IsOkAndHolds(true));
+  EXPECT_EQ(result.As<StringValue>().ToString(), "log");
+}
+
+TEST_F(ColumnarActivationTest, EvaluateColumnsBroadcastsPerDictionaryCode) {
+  RuntimeOptions options;
+  ASSERT_OK_AND_ASSIGN(auto builder, CreateStandardRuntimeBuilder(options));
+
+  int call_count = 0;
+  ASSERT_OK(RegisterHelper<UnaryFunctionAdapter<bool, const StringValue&>>::
+                RegisterGlobalOverload(
+                    "is_allowed",
+                    [&call_count](ValueManager&, const StringValue& verdict) {
+                      ++call_count;
+                      return verdict.Equals("allow");
+                    },
+                    builder.function_registry()));
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+  ASSERT_OK_AND_ASSIGN(ParsedExpr expr, Parse("is_allowed(verdict)"));
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  std::string dictionary_data = "allowdenylog";
+  std::vector<int32_t> dictionary_offsets = {0, 5, 9, 12};
+  std::vector<int32_t> codes = {0, 1, 0, 2, 0, 1};
+
+  ColumnarBatch batch;
+  ASSERT_OK(batch.AddColumn(
+      "verdict",
+      Column::DictionaryString(codes, dictionary_offsets, dictionary_data)));
+
+  std::vector<Value> results(batch.row_count());
+  ASSERT_OK(EvaluateColumns(*program, batch, absl::MakeSpan(results),
+                            value_factory_));
+
+  EXPECT_TRUE(results[0].As<BoolValue>().NativeValue());
+  EXPECT_FALSE(results[1].As<BoolValue>().NativeValue());
+  EXPECT_TRUE(results[2].As<BoolValue>().NativeValue());
+  EXPECT_FALSE(results[3].As<BoolValue>().NativeValue());
+  EXPECT_TRUE(results[4].As<BoolValue>().NativeValue());
+  EXPECT_FALSE(results[5].As<BoolValue>().NativeValue());
+  // One evaluation per distinct code, not per row.
+  EXPECT_EQ(call_count, 3);
+}
+
+TEST_F(ColumnarActivationTest, EvaluateColumnsRejectsOutOfRangeCode) {
+  RuntimeOptions options;
+  ASSERT_OK_AND_ASSIGN(auto builder, CreateStandardRuntimeBuilder(options));
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+  ASSERT_OK_AND_ASSIGN(ParsedExpr expr, Parse("verdict == 'allow'"));
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  std::string dictionary_data = "allow";
+  std::vector<int32_t> dictionary_offsets = {0, 5};
+  std::vector<int32_t> codes = {0, 7};
+
+  ColumnarBatch batch;
+  ASSERT_OK(batch.AddColumn(
+      "verdict",
+      Column::DictionaryString(codes, dictionary_offsets, dictionary_data)));
+
+  std::vector<Value> results(batch.row_count());
+  EXPECT_THAT(EvaluateColumns(*program, batch, absl::MakeSpan(results),
+                              value_factory_),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("out of range")));
+}
+
+TEST_F(ColumnarActivationTest, EvaluateColumnsFiltersBatch) {
+  RuntimeOptions options;
+  ASSERT_OK_AND_ASSIGN(auto builder, CreateStandardRuntimeBuilder(options));
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr expr, Parse("x > 1 && y < 2.0"));
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  std::vector<int64_t> xs = {0, 2, 5, 1};
+  std::vector<double> ys = {1.0, 1.5, 3.0, 0.5};
+
+  ColumnarBatch batch;
+  ASSERT_OK(batch.AddColumn("x", Column::Int64(xs)));
+  ASSERT_OK(batch.AddColumn("y", Column::Double(ys)));
+
+  std::vector<Value> results(batch.row_count());
+  ASSERT_OK(EvaluateColumns(*program, batch, absl::MakeSpan(results),
+                            value_factory_));
+
+  ASSERT_EQ(results.size(), 4);
+  EXPECT_FALSE(results[0].As<BoolValue>().NativeValue());
+  EXPECT_TRUE(results[1].As<BoolValue>().NativeValue());
+  EXPECT_FALSE(results[2].As<BoolValue>().NativeValue());
+  EXPECT_FALSE(results[3].As<BoolValue>().NativeValue());
+}
+
+}  // namespace
+}  // namespace cel
@@ -0,0 +1,196 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/columnar_result.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/variant.h"
+#include "common/casting.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "common/value_manager.h"
+#include "internal/status_macros.h"
+#include "runtime/columnar_activation.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+
+namespace {
+
+// Extracts the declared piece of a row result. Returns false (with `piece`
+// untouched) when the piece is absent: a missing map key, an out-of-range
+// list index, or a container of the wrong shape.
+absl::StatusOr<bool> ExtractPiece(ValueManager& value_factory,
+                                  const Value& row_result,
+                                  const ColumnarResultSink::Selector& selector,
+                                  Value& piece) {
+  if (absl::holds_alternative<absl::monostate>(selector)) {
+    piece = row_result;
+    return true;
+  }
+  if (const std::string* key = absl::get_if<std::string>(&selector);
+      key != nullptr) {
+    if (row_result.kind() == ValueKind::kMap) {
+      return Cast<MapValue>(row_result)
+          .Find(value_factory, value_factory.CreateUncheckedStringValue(*key),
+                piece);
+    }
+    if (row_result.kind() == ValueKind::kStruct) {
+      const auto& struct_value = Cast<StructValue>(row_result);
+      CEL_ASSIGN_OR_RETURN(bool has, struct_value.HasFieldByName(*key));
+      if (!has) {
+        return false;
+      }
+      CEL_RETURN_IF_ERROR(
+          struct_value.GetFieldByName(value_factory, *key, piece));
+      return true;
+    }
+    return false;
+  }
+  int64_t index = absl::get<int64_t>(selector);
+  if (row_result.kind() != ValueKind::kList || index < 0) {
+    return false;
+  }
+  const auto& list_value = Cast<ListValue>(row_result);
+  CEL_ASSIGN_OR_RETURN(size_t size, list_value.Size());
+  if (static_cast<size_t>(index) >= size) {
+    return false;
+  }
+  CEL_RETURN_IF_ERROR(
+      list_value.Get(value_factory, static_cast<size_t>(index), piece));
+  return true;
+}
+
+}  // namespace
+
+void ColumnBuilder::AppendNull() {
+  validity_.push_back(false);
+  switch (kind_) {
+    case Kind::kBool:
+      bool_values_.push_back(false);
+      break;
+    case Kind::kInt64:
+      int64_values_.push_back(0);
+      break;
+    case Kind::kUint64:
+      uint64_values_.push_back(0);
+      break;
+    case Kind::kDouble:
+      double_values_.push_back(0);
+      break;
+    case Kind::kString:
+      string_offsets_.push_back(static_cast<int32_t>(string_data_.size()));
+      break;
+  }
+}
+
+void ColumnBuilder::Append(const Value& value) {
+  switch (kind_) {
+    case Kind::kBool:
+      if (value.kind() == ValueKind::kBool) {
+        validity_.push_back(true);
+        bool_values_.push_back(Cast<BoolValue>(value).NativeValue());
+        return;
+      }
+      break;
+    case Kind::kInt64:
+      if (value.kind() == ValueKind::kInt) {
+        validity_.push_back(true);
+        int64_values_.push_back(Cast<IntValue>(value).NativeValue());
+        return;
+      }
+      break;
+    case Kind::kUint64:
+      if (value.kind() == ValueKind::kUint) {
+        validity_.push_back(true);
+        uint64_values_.push_back(Cast<UintValue>(value).NativeValue());
+        return;
+      }
+      break;
+    case Kind::kDouble:
+      if (value.kind() == ValueKind::kDouble) {
+        validity_.push_back(true);
+        double_values_.push_back(Cast<DoubleValue>(value).NativeValue());
+        return;
+      }
+      break;
+    case Kind::kString:
+      if (value.kind() == ValueKind::kString) {
+        validity_.push_back(true);
+        string_data_.append(Cast<StringValue>(value).ToString());
+        string_offsets_.push_back(static_cast<int32_t>(string_data_.size()));
+        return;
+      }
+      break;
+  }
+  AppendNull();
+}
+
+ColumnBuilder& ColumnarResultSink::DeclareValueColumn(ColumnBuilder::Kind kind) {
+  columns_.push_back(Output{Selector(absl::monostate()), ColumnBuilder(kind)});
+  return columns_.back().builder;
+}
+
+ColumnBuilder& ColumnarResultSink::DeclareKeyColumn(absl::string_view key,
+                                                    ColumnBuilder::Kind kind) {
+  columns_.push_back(Output{Selector(std::string(key)), ColumnBuilder(kind)});
+  return columns_.back().builder;
+}
+
+ColumnBuilder& ColumnarResultSink::DeclareIndexColumn(int64_t index,
+                                                      ColumnBuilder::Kind kind) {
+  columns_.push_back(Output{Selector(index), ColumnBuilder(kind)});
+  return columns_.back().builder;
+}
+
+absl::Status EvaluateColumnsInto(const Program& program,
+                                 const ColumnarBatch& batch,
+                                 ColumnarResultSink& sink,
+                                 ValueManager& value_factory) {
+  ColumnarRowActivation activation(batch);
+  for (size_t row = 0; row < batch.row_count(); ++row) {
+    activation.set_row(row);
+    CEL_ASSIGN_OR_RETURN(Value row_result,
+                         program.Evaluate(activation, value_factory));
+    const bool row_failed = row_result.kind() == ValueKind::kError ||
+                            row_result.kind() == ValueKind::kUnknown;
+    for (auto& output : sink.columns_) {
+      if (row_failed) {
+        output.builder.AppendNull();
+        continue;
+      }
+      Value piece;
+      CEL_ASSIGN_OR_RETURN(
+          bool present,
+          ExtractPiece(value_factory, row_result, output.selector, piece));
+      if (!present || piece.kind() == ValueKind::kError ||
+          piece.kind() == ValueKind::kUnknown) {
+        output.builder.AppendNull();
+      } else {
+        output.builder.Append(piece);
+      }
+    }
+    // The row's container result goes out of scope here; nothing columnar
+    // retains it.
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace cel
@@ -0,0 +1,144 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_COLUMNAR_RESULT_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_COLUMNAR_RESULT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/variant.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "runtime/columnar_activation.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+
+// An appendable typed output column: one validity bit and, for valid rows,
+// one element per evaluated row. The backing arrays use the Arrow layout
+// (typed array plus validity bitmap; strings as a shared character buffer
+// with row_count + 1 byte offsets), so a finished builder can be handed to a
+// columnar consumer without another conversion pass.
+class ColumnBuilder final {
+ public:
+  enum class Kind {
+    kBool,
+    kInt64,
+    kUint64,
+    kDouble,
+    kString,
+  };
+
+  explicit ColumnBuilder(Kind kind) : kind_(kind) { string_offsets_ = {0}; }
+
+  Kind kind() const { return kind_; }
+
+  size_t row_count() const { return validity_.size(); }
+
+  // Appends an absent row: the validity bit is cleared and the typed array
+  // receives a zero element so the arrays stay row-aligned.
+  void AppendNull();
+
+  // Appends `value` if it matches the column's type, otherwise appends an
+  // absent row. Errors, unknowns and missing map keys also land as absent
+  // rows; the validity bitmap is the consumer's signal for them.
+  void Append(const Value& value);
+
+  // Finished arrays, valid until the next Append.
+  const std::vector<bool>& validity() const { return validity_; }
+  const std::vector<bool>& bool_values() const { return bool_values_; }
+  const std::vector<int64_t>& int64_values() const { return int64_values_; }
+  const std::vector<uint64_t>& uint64_values() const { return uint64_values_; }
+  const std::vector<double>& double_values() const { return double_values_; }
+  const std::vector<int32_t>& string_offsets() const { return string_offsets_; }
+  const std::string& string_data() const { return string_data_; }
+
+ private:
+  Kind kind_;
+  std::vector<bool> validity_;
+  std::vector<bool> bool_values_;
+  std::vector<int64_t> int64_values_;
+  std::vector<uint64_t> uint64_values_;
+  std::vector<double> double_values_;
+  std::vector<int32_t> string_offsets_;
+  std::string string_data_;
+};
+
+// Caller-declared columnar sink for batch evaluation results.
+//
+// Each declared column names one piece of the per-row result -- the whole
+// result for scalar programs, a map key or struct field name for
+// map-producing projections, or a list index for list-producing ones. When
+// passed to EvaluateColumnsInto, declared pieces are written straight into
+// the typed builders as each row is evaluated, so per-row container results
+// stay transient instead of being retained and converted afterwards.
+class ColumnarResultSink final {
+ public:
+  // Selects the piece of the row result a column is filled from; monostate
+  // selects the whole result.
+  using Selector = absl::variant<absl::monostate, std::string, int64_t>;
+
+  ColumnarResultSink() = default;
+
+  // Move only; builders hold growing buffers.
+  ColumnarResultSink(ColumnarResultSink&&) = default;
+  ColumnarResultSink& operator=(ColumnarResultSink&&) = default;
+
+  // Declares a column filled from the whole per-row result.
+  ColumnBuilder& DeclareValueColumn(ColumnBuilder::Kind kind);
+
+  // Declares a column filled from the given key of a per-row map result (or
+  // the field of a struct result).
+  ColumnBuilder& DeclareKeyColumn(absl::string_view key,
+                                  ColumnBuilder::Kind kind);
+
+  // Declares a column filled from the given index of a per-row list result.
+  ColumnBuilder& DeclareIndexColumn(int64_t index, ColumnBuilder::Kind kind);
+
+  size_t column_count() const { return columns_.size(); }
+
+  const ColumnBuilder& column(size_t i) const { return columns_[i].builder; }
+
+ private:
+  friend absl::Status EvaluateColumnsInto(const Program& program,
+                                          const ColumnarBatch& batch,
+                                          ColumnarResultSink& sink,
+                                          ValueManager& value_factory);
+
+  struct Output {
+    Selector selector;
+    ColumnBuilder builder;
+  };
+
+  std::vector<Output> columns_;
+};
+
+// Evaluates the program once per row of the batch, decomposing each row's
+// result into the sink's declared columns. Rows whose result (or declared
+// piece of it) is an error, an unknown, a missing key or a type mismatch are
+// recorded as absent via the validity bitmap; a non-recoverable evaluation
+// error aborts the batch.
+absl::Status EvaluateColumnsInto(const Program& program,
+                                 const ColumnarBatch& batch,
+                                 ColumnarResultSink& sink,
+                                 ValueManager& value_factory);
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_COLUMNAR_RESULT_H_
@@ -0,0 +1,174 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/columnar_result.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "base/type_provider.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "common/values/legacy_value_manager.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/columnar_activation.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+
+namespace cel {
+namespace {
+
+using ::cel::extensions::ProtobufRuntimeAdapter;
+using ::google::api::expr::v1alpha1::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+using testing::ElementsAre;
+
+class ColumnarResultTest : public testing::Test {
+ public:
+  ColumnarResultTest()
+      : value_factory_(MemoryManagerRef::ReferenceCounting(),
+                       TypeProvider::Builtin()) {}
+
+ protected:
+  absl::StatusOr<std::unique_ptr<Program>> MakeProgram(
+      absl::string_view expression) {
+    RuntimeOptions options;
+    CEL_ASSIGN_OR_RETURN(auto builder, CreateStandardRuntimeBuilder(options));
+    CEL_ASSIGN_OR_RETURN(runtime_, std::move(builder).Build());
+    CEL_ASSIGN_OR_RETURN(ParsedExpr expr, Parse(expression));
+    return ProtobufRuntimeAdapter::CreateProgram(*runtime_, expr);
+  }
+
+  std::unique_ptr<const Runtime> runtime_;
+  common_internal::LegacyValueManager value_factory_;
+};
+
+TEST_F(ColumnarResultTest, MapProjectionFillsKeyColumns) {
+  ASSERT_OK_AND_ASSIGN(
+      auto program,
+      MakeProgram("{'doubled': i * 2, 'flag': i > 2, 'label': s}"));
+
+  std::vector<int64_t> ints = {1, 2, 3};
+  std::string string_data = "foobarbaz";
+  std::vector<int32_t> offsets = {0, 3, 6, 9};
+
+  ColumnarBatch batch;
+  ASSERT_OK(batch.AddColumn("i", Column::Int64(ints)));
+  ASSERT_OK(batch.AddColumn("s", Column::String(offsets, string_data)));
+
+  ColumnarResultSink sink;
+  ColumnBuilder& doubled =
+      sink.DeclareKeyColumn("doubled", ColumnBuilder::Kind::kInt64);
+  ColumnBuilder& flag = sink.DeclareKeyColumn("flag", ColumnBuilder::Kind::kBool);
+  ColumnBuilder& label =
+      sink.DeclareKeyColumn("label", ColumnBuilder::Kind::kString);
+
+  ASSERT_OK(EvaluateColumnsInto(*program, batch, sink, value_factory_));
+
+  EXPECT_THAT(doubled.int64_values(), ElementsAre(2, 4, 6));
+  EXPECT_THAT(doubled.validity(), ElementsAre(true, true, true));
+  EXPECT_THAT(flag.bool_values(), ElementsAre(false, false, true));
+  EXPECT_EQ(label.string_data(), "foobarbaz");
+  EXPECT_THAT(label.string_offsets(), ElementsAre(0, 3, 6, 9));
+}
+
+TEST_F(ColumnarResultTest, MissingKeyAndMismatchAreAbsentRows) {
+  // 'extra' is only present for some rows; 'mixed' changes type per row.
+  ASSERT_OK_AND_ASSIGN(
+      auto program,
+      MakeProgram("i > 1 ? {'extra': i, 'mixed': i} : {'mixed': 'str'}"));
+
+  std::vector<int64_t> ints = {1, 2};
+  ColumnarBatch batch;
+  ASSERT_OK(batch.AddColumn("i", Column::Int64(ints)));
+
+  ColumnarResultSink sink;
+  ColumnBuilder& extra =
+      sink.DeclareKeyColumn("extra", ColumnBuilder::Kind::kInt64);
+  ColumnBuilder& mixed =
+      sink.DeclareKeyColumn("mixed", ColumnBuilder::Kind::kInt64);
+
+  ASSERT_OK(EvaluateColumnsInto(*program, batch, sink, value_factory_));
+
+  EXPECT_THAT(extra.validity(), ElementsAre(false, true));
+  EXPECT_THAT(extra.int64_values(), ElementsAre(0, 2));
+  // Row 0 produced a string where an int column was declared.
+  EXPECT_THAT(mixed.validity(), ElementsAre(false, true));
+}
+
+TEST_F(ColumnarResultTest, ListProjectionFillsIndexColumns) {
+  ASSERT_OK_AND_ASSIGN(auto program, MakeProgram("[i, i * i]"));
+
+  std::vector<int64_t> ints = {2, 3};
+  ColumnarBatch batch;
+  ASSERT_OK(batch.AddColumn("i", Column::Int64(ints)));
+
+  ColumnarResultSink sink;
+  ColumnBuilder& first = sink.DeclareIndexColumn(0, ColumnBuilder::Kind::kInt64);
+  ColumnBuilder& second =
+      sink.DeclareIndexColumn(1, ColumnBuilder::Kind::kInt64);
+  ColumnBuilder& third = sink.DeclareIndexColumn(2, ColumnBuilder::Kind::kInt64);
+
+  ASSERT_OK(EvaluateColumnsInto(*program, batch, sink, value_factory_));
+
+  EXPECT_THAT(first.int64_values(), ElementsAre(2, 3));
+  EXPECT_THAT(second.int64_values(), ElementsAre(4, 9));
+  // Out of range for every row.
+  EXPECT_THAT(third.validity(), ElementsAre(false, false));
+}
+
+TEST_F(ColumnarResultTest, ScalarResultFillsValueColumn) {
+  ASSERT_OK_AND_ASSIGN(auto program, MakeProgram("i * 10"));
+
+  std::vector<int64_t> ints = {1, 2, 3};
+  ColumnarBatch batch;
+  ASSERT_OK(batch.AddColumn("i", Column::Int64(ints)));
+
+  ColumnarResultSink sink;
+  ColumnBuilder& out = sink.DeclareValueColumn(ColumnBuilder::Kind::kInt64);
+
+  ASSERT_OK(EvaluateColumnsInto(*program, batch, sink, value_factory_));
+
+  EXPECT_THAT(out.int64_values(), ElementsAre(10, 20, 30));
+}
+
+TEST_F(ColumnarResultTest, ErrorRowsAreAbsentNotFatal) {
+  // Division by zero on row 1 produces a CEL error for that row only.
+  ASSERT_OK_AND_ASSIGN(auto program, MakeProgram("{'q': 10 / i}"));
+
+  std::vector<int64_t> ints = {5, 0, 2};
+  ColumnarBatch batch;
+  ASSERT_OK(batch.AddColumn("i", Column::Int64(ints)));
+
+  ColumnarResultSink sink;
+  ColumnBuilder& q = sink.DeclareKeyColumn("q", ColumnBuilder::Kind::kInt64);
+
+  ASSERT_OK(EvaluateColumnsInto(*program, batch, sink, value_factory_));
+
+  EXPECT_THAT(q.validity(), ElementsAre(true, false, true));
+  EXPECT_THAT(q.int64_values(), ElementsAre(2, 0, 5));
+}
+
+}  // namespace
+}  // namespace cel
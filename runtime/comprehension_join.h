@@ -0,0 +1,40 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_COMPREHENSION_JOIN_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_COMPREHENSION_JOIN_H_
+
+#include "absl/status/status.h"
+#include "runtime/runtime_builder.h"
+
+namespace cel::extensions {
+
+// Enable hash join rewriting of nested comprehensions in the runtime being
+// built.
+//
+// Equality-correlated nested comprehensions such as
+// `a.all(x, b.exists(y, y.id == x.id))` are rewritten from a nested loop
+// into a build/probe hash join: the inner keys are indexed once and probed
+// per outer element, O(|a| + |b|) instead of O(|a| * |b|). The original
+// nested loop is retained and used whenever the join cannot reproduce its
+// result exactly (tracing or attribute tracking active, non-list ranges,
+// keys outside the indexed scalar domain).
+//
+// Only applies to recursively planned subexpressions; see
+// RuntimeOptions::max_recursion_depth.
+absl::Status EnableComprehensionJoinOptimization(RuntimeBuilder& builder);
+
+}  // namespace cel::extensions
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_COMPREHENSION_JOIN_H_
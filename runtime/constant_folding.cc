@@ -22,6 +22,7 @@
 #include "eval/compiler/constant_folding.h"
 #include "internal/casts.h"
 #include "internal/status_macros.h"
+#include "runtime/activation_interface.h"
 #include "runtime/internal/runtime_friend_access.h"
 #include "runtime/internal/runtime_impl.h"
 #include "runtime/runtime.h"
@@ -61,4 +62,16 @@ absl::Status EnableConstantFolding(RuntimeBuilder& builder,
   return absl::OkStatus();
 }
 
+absl::Status EnableConstantFolding(
+    RuntimeBuilder& builder, MemoryManagerRef memory_manager,
+    const ActivationInterface& pinned_activation) {
+  CEL_ASSIGN_OR_RETURN(RuntimeImpl * runtime_impl,
+                       RuntimeImplFromBuilder(builder));
+  ABSL_ASSERT(runtime_impl != nullptr);
+  runtime_impl->expr_builder().AddProgramOptimizer(
+      runtime_internal::CreateConstantFoldingOptimizer(memory_manager,
+                                                       pinned_activation));
+  return absl::OkStatus();
+}
+
 }  // namespace cel::extensions
@@ -17,6 +17,7 @@
 
 #include "absl/status/status.h"
 #include "common/memory.h"
+#include "runtime/activation_interface.h"
 #include "runtime/runtime_builder.h"
 
 namespace cel::extensions {
@@ -32,6 +33,22 @@ namespace cel::extensions {
 absl::Status EnableConstantFolding(RuntimeBuilder& builder,
                                    MemoryManagerRef memory_manager);
 
+// Enable constant folding with program specialization over pinned variables.
+//
+// In addition to ordinary constant folding, variables bound in
+// `pinned_activation` are folded through the plan as constants, and
+// short-circuiting calls (`&&`, `||`, `_?_:_`) whose condition becomes a
+// constant bool are reduced to their fixed outcome or surviving branch.
+// Intended for bindings that are fixed for the life of the runtime, such as
+// per-tenant feature flags: programs built by the runtime are specialized to
+// that tenant and must not be shared across tenants.
+//
+// The provided memory manager and pinned activation must outlive the runtime
+// object built from builder and any programs it creates.
+absl::Status EnableConstantFolding(RuntimeBuilder& builder,
+                                   MemoryManagerRef memory_manager,
+                                   const ActivationInterface& pinned_activation);
+
 }  // namespace cel::extensions
 
 #endif  // THIRD_PARTY_CEL_CPP_RUNTIME_CONSTANT_FOLDING_H_
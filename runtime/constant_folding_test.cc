@@ -14,6 +14,7 @@
 
 #include "runtime/constant_folding.h"
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -22,14 +23,19 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
 #include "base/function_adapter.h"
+#include "common/memory.h"
 #include "common/value.h"
 #include "extensions/protobuf/runtime_adapter.h"
+#include "internal/status_macros.h"
 #include "internal/testing.h"
 #include "parser/parser.h"
 #include "runtime/activation.h"
+#include "runtime/internal/runtime_impl.h"
 #include "runtime/managed_value_factory.h"
 #include "runtime/register_function_helper.h"
+#include "runtime/runtime.h"
 #include "runtime/runtime_builder.h"
 #include "runtime/runtime_options.h"
 #include "runtime/standard_runtime_builder_factory.h"
@@ -138,5 +144,119 @@ INSTANTIATE_TEST_SUITE_P(
       return info.param.name;
     });
 
+class ProgramSpecializationTest : public testing::Test {
+ protected:
+  // Builds a runtime specialized against `pinned_`, then evaluates
+  // `expression` with a fresh per-request activation holding only `x`.
+  absl::StatusOr<Value> EvaluateSpecialized(absl::string_view expression) {
+    RuntimeOptions options;
+    CEL_ASSIGN_OR_RETURN(RuntimeBuilder builder,
+                         CreateStandardRuntimeBuilder(options));
+    CEL_RETURN_IF_ERROR(EnableConstantFolding(
+        builder, MemoryManagerRef::ReferenceCounting(), pinned_));
+    CEL_ASSIGN_OR_RETURN(auto runtime, std::move(builder).Build());
+
+    CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+    CEL_ASSIGN_OR_RETURN(auto program, ProtobufRuntimeAdapter::CreateProgram(
+                                           *runtime, parsed_expr));
+
+    ManagedValueFactory value_factory(program->GetTypeProvider(),
+                                      MemoryManagerRef::ReferenceCounting());
+    Activation activation;
+    activation.InsertOrAssignValue("x",
+                                   value_factory.get().CreateIntValue(7));
+    return program->Evaluate(activation, value_factory.get());
+  }
+
+  Activation pinned_;
+};
+
+TEST_F(ProgramSpecializationTest, PinnedVariableFoldsToConstant) {
+  pinned_.InsertOrAssignValue("flag", BoolValue(true));
+  // `flag` is not bound in the per-request activation: only a specialized
+  // program can evaluate this without a missing-variable error.
+  ASSERT_OK_AND_ASSIGN(Value result, EvaluateSpecialized("flag ? 1 : 2"));
+  EXPECT_THAT(result, IsIntValue(1));
+}
+
+TEST_F(ProgramSpecializationTest, FalseAndShortCircuits) {
+  pinned_.InsertOrAssignValue("flag", BoolValue(false));
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       EvaluateSpecialized("flag && undefined_var"));
+  EXPECT_THAT(result, IsBoolValue(false));
+}
+
+TEST_F(ProgramSpecializationTest, TrueOrShortCircuits) {
+  pinned_.InsertOrAssignValue("flag", BoolValue(true));
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       EvaluateSpecialized("flag || undefined_var"));
+  EXPECT_THAT(result, IsBoolValue(true));
+}
+
+TEST_F(ProgramSpecializationTest, SurvivingBranchStaysDynamic) {
+  pinned_.InsertOrAssignValue("flag", BoolValue(true));
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       EvaluateSpecialized("flag ? x * 2 : undefined_var"));
+  EXPECT_THAT(result, IsIntValue(14));
+}
+
+TEST_F(ProgramSpecializationTest, UnpinnedConditionPreserved) {
+  pinned_.InsertOrAssignValue("flag", BoolValue(true));
+  ASSERT_OK_AND_ASSIGN(Value result, EvaluateSpecialized("x > 0 ? x : 0"));
+  EXPECT_THAT(result, IsIntValue(7));
+}
+
+class ConstantProgramTest : public testing::Test {
+ protected:
+  // Builds a runtime with constant folding enabled and plans `expression`.
+  absl::StatusOr<std::unique_ptr<Program>> Plan(absl::string_view expression) {
+    RuntimeOptions options;
+    CEL_ASSIGN_OR_RETURN(RuntimeBuilder builder,
+                         CreateStandardRuntimeBuilder(options));
+    CEL_RETURN_IF_ERROR(EnableConstantFolding(
+        builder, MemoryManagerRef::ReferenceCounting()));
+    CEL_ASSIGN_OR_RETURN(runtime_, std::move(builder).Build());
+
+    CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+    return ProtobufRuntimeAdapter::CreateProgram(*runtime_, parsed_expr);
+  }
+
+  std::unique_ptr<const Runtime> runtime_;
+};
+
+TEST_F(ConstantProgramTest, FullyConstantExpressionUsesConstantProgram) {
+  ASSERT_OK_AND_ASSIGN(auto program, Plan("'a' + 'b' == 'ab' && 1 < 2"));
+
+  // Fully constant plans reduce to a trivially invokable program that skips
+  // evaluator state construction.
+  EXPECT_TRUE(runtime_internal::TestOnly_IsConstantImpl(program.get()));
+
+  ManagedValueFactory value_factory(program->GetTypeProvider(),
+                                    MemoryManagerRef::ReferenceCounting());
+  Activation activation;
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       program->Evaluate(activation, value_factory.get()));
+  EXPECT_THAT(result, IsBoolValue(true));
+
+  // Repeated evaluation returns the same folded value.
+  ASSERT_OK_AND_ASSIGN(result,
+                       program->Evaluate(activation, value_factory.get()));
+  EXPECT_THAT(result, IsBoolValue(true));
+}
+
+TEST_F(ConstantProgramTest, VariableExpressionStaysDynamic) {
+  ASSERT_OK_AND_ASSIGN(auto program, Plan("x + 1"));
+
+  EXPECT_FALSE(runtime_internal::TestOnly_IsConstantImpl(program.get()));
+
+  ManagedValueFactory value_factory(program->GetTypeProvider(),
+                                    MemoryManagerRef::ReferenceCounting());
+  Activation activation;
+  activation.InsertOrAssignValue("x", value_factory.get().CreateIntValue(41));
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       program->Evaluate(activation, value_factory.get()));
+  EXPECT_THAT(result, IsIntValue(42));
+}
+
 }  // namespace
 }  // namespace cel::extensions
@@ -796,5 +796,87 @@ TEST_F(FunctionAdapterTest,
                        HasSubstr("unexpected number of arguments")));
 }
 
+TEST_F(FunctionAdapterTest, StaticUnaryFunctionAdapterWrapFunctionInt) {
+  std::unique_ptr<Function> wrapped =
+      StaticUnaryFunctionAdapter<int64_t, int64_t>::WrapFunction(
+          [](ValueManager&, int64_t x) -> int64_t { return x + 2; });
+
+  std::vector<Value> args{value_factory().CreateIntValue(40)};
+  ASSERT_OK_AND_ASSIGN(auto result, wrapped->Invoke(test_context(), args));
+
+  ASSERT_TRUE(result->Is<IntValue>());
+  EXPECT_EQ(result.As<IntValue>().NativeValue(), 42);
+}
+
+TEST_F(FunctionAdapterTest, StaticUnaryFunctionAdapterWrapFunctionWrongArgType) {
+  std::unique_ptr<Function> wrapped =
+      StaticUnaryFunctionAdapter<int64_t, int64_t>::WrapFunction(
+          [](ValueManager&, int64_t x) -> int64_t { return x + 2; });
+
+  std::vector<Value> args{value_factory().CreateDoubleValue(40.0)};
+  EXPECT_THAT(wrapped->Invoke(test_context(), args),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("expected int value")));
+}
+
+TEST_F(FunctionAdapterTest, StaticUnaryFunctionAdapterCreateDescriptor) {
+  FunctionDescriptor desc =
+      StaticUnaryFunctionAdapter<int64_t, int64_t>::CreateDescriptor(
+          "Increment", /*receiver_style=*/true);
+
+  EXPECT_EQ(desc.name(), "Increment");
+  EXPECT_TRUE(desc.is_strict());
+  EXPECT_TRUE(desc.receiver_style());
+  EXPECT_THAT(desc.types(), ElementsAre(Kind::kInt64));
+}
+
+TEST_F(FunctionAdapterTest, StaticBinaryFunctionAdapterWrapFunctionDouble) {
+  std::unique_ptr<Function> wrapped =
+      StaticBinaryFunctionAdapter<double, double, double>::WrapFunction(
+          [](ValueManager&, double x, double y) -> double {
+            return x * x - y * y;
+          });
+
+  std::vector<Value> args{value_factory().CreateDoubleValue(4),
+                          value_factory().CreateDoubleValue(3)};
+  ASSERT_OK_AND_ASSIGN(auto result, wrapped->Invoke(test_context(), args));
+
+  ASSERT_TRUE(result->Is<DoubleValue>());
+  EXPECT_EQ(result.As<DoubleValue>().NativeValue(), 7.0);
+}
+
+TEST_F(FunctionAdapterTest, StaticBinaryFunctionAdapterWrapFunctionString) {
+  std::unique_ptr<Function> wrapped = StaticBinaryFunctionAdapter<
+      absl::StatusOr<Value>, const StringValue&,
+      const StringValue&>::WrapFunction([](ValueManager& value_factory,
+                                           const StringValue& x,
+                                           const StringValue& y)
+                                            -> absl::StatusOr<Value> {
+    return value_factory.CreateStringValue(
+        absl::StrCat(x.ToString(), y.ToString()));
+  });
+
+  std::vector<Value> args;
+  ASSERT_OK_AND_ASSIGN(args.emplace_back(),
+                       value_factory().CreateStringValue("abc"));
+  ASSERT_OK_AND_ASSIGN(args.emplace_back(),
+                       value_factory().CreateStringValue("def"));
+  ASSERT_OK_AND_ASSIGN(auto result, wrapped->Invoke(test_context(), args));
+
+  ASSERT_TRUE(result->Is<StringValue>());
+  EXPECT_EQ(result.As<StringValue>().ToString(), "abcdef");
+}
+
+TEST_F(FunctionAdapterTest, StaticBinaryFunctionAdapterWrapFunctionBadArgCount) {
+  std::unique_ptr<Function> wrapped =
+      StaticBinaryFunctionAdapter<double, double, double>::WrapFunction(
+          [](ValueManager&, double x, double y) -> double { return x - y; });
+
+  std::vector<Value> args{value_factory().CreateDoubleValue(4)};
+  EXPECT_THAT(wrapped->Invoke(test_context(), args),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("unexpected number of arguments")));
+}
+
 }  // namespace
 }  // namespace cel
@@ -15,8 +15,14 @@
 #ifndef THIRD_PARTY_CEL_CPP_RUNTIME_FUNCTION_PROVIDER_H_
 #define THIRD_PARTY_CEL_CPP_RUNTIME_FUNCTION_PROVIDER_H_
 
+#include <vector>
+
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "base/function_descriptor.h"
+#include "base/kind.h"
 #include "runtime/activation_interface.h"
 #include "runtime/function_overload_reference.h"
 
@@ -39,6 +45,22 @@ class FunctionProvider {
   virtual absl::StatusOr<absl::optional<FunctionOverloadReference>> GetFunction(
       const FunctionDescriptor& descriptor,
       const ActivationInterface& activation) const = 0;
+
+  // Overload of `GetFunction` taking the call signature directly.
+  //
+  // This is the entry point used on the evaluation hot path: it lets callers
+  // resolve an overload without constructing a temporary FunctionDescriptor,
+  // which heap-allocates its type list. The default implementation
+  // materializes a descriptor and defers to the descriptor overload, for
+  // providers that predate this entry point.
+  virtual absl::StatusOr<absl::optional<FunctionOverloadReference>> GetFunction(
+      absl::string_view name, bool receiver_style, absl::Span<const Kind> types,
+      const ActivationInterface& activation) const {
+    return GetFunction(
+        FunctionDescriptor(name, receiver_style,
+                           std::vector<Kind>(types.begin(), types.end())),
+        activation);
+  }
 };
 
 }  // namespace cel::runtime_internal
@@ -14,6 +14,8 @@
 
 #include "runtime/function_registry.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -46,23 +48,17 @@ class ActivationFunctionProviderImpl
   absl::StatusOr<absl::optional<cel::FunctionOverloadReference>> GetFunction(
       const cel::FunctionDescriptor& descriptor,
       const cel::ActivationInterface& activation) const override {
-    std::vector<cel::FunctionOverloadReference> overloads =
-        activation.FindFunctionOverloads(descriptor.name());
-
-    absl::optional<cel::FunctionOverloadReference> matching_overload =
-        absl::nullopt;
-
-    for (const auto& overload : overloads) {
-      if (overload.descriptor.ShapeMatches(descriptor)) {
-        if (matching_overload.has_value()) {
-          return absl::Status(absl::StatusCode::kInvalidArgument,
-                              "Couldn't resolve function.");
-        }
-        matching_overload.emplace(overload);
-      }
-    }
+    return GetFunction(descriptor.name(), descriptor.receiver_style(),
+                       descriptor.types(), activation);
+  }
 
-    return matching_overload;
+  absl::StatusOr<absl::optional<cel::FunctionOverloadReference>> GetFunction(
+      absl::string_view name, bool receiver_style,
+      absl::Span<const cel::Kind> types,
+      const cel::ActivationInterface& activation) const override {
+    // Resolution happens in the activation against its own overload storage,
+    // so no candidate vector is materialized on the call path.
+    return activation.FindFunctionOverload(name, receiver_style, types);
   }
 };
 
@@ -76,9 +72,69 @@ CreateActivationFunctionProvider() {
 
 }  // namespace
 
+void FunctionRegistry::Finalize() {
+  if (finalized_) {
+    return;
+  }
+  size_t static_count = 0;
+  size_t lazy_count = 0;
+  for (const auto& entry : functions_) {
+    static_count += entry.second.static_overloads.size();
+    lazy_count += entry.second.lazy_overloads.size();
+  }
+  static_descriptors_.reserve(static_count);
+  static_implementations_.reserve(static_count);
+  lazy_descriptors_.reserve(lazy_count);
+  lazy_providers_.reserve(lazy_count);
+  index_.reserve(functions_.size());
+  for (const auto& entry : functions_) {
+    IndexedEntry indexed;
+    indexed.static_offset = static_cast<uint32_t>(static_descriptors_.size());
+    indexed.static_count =
+        static_cast<uint32_t>(entry.second.static_overloads.size());
+    indexed.lazy_offset = static_cast<uint32_t>(lazy_descriptors_.size());
+    indexed.lazy_count =
+        static_cast<uint32_t>(entry.second.lazy_overloads.size());
+    for (const auto& overload : entry.second.static_overloads) {
+      static_descriptors_.push_back(*overload.descriptor);
+      static_implementations_.push_back(overload.implementation.get());
+    }
+    for (const auto& overload : entry.second.lazy_overloads) {
+      lazy_descriptors_.push_back(*overload.descriptor);
+      lazy_providers_.push_back(overload.function_provider.get());
+    }
+    index_.insert({absl::string_view(entry.first), indexed});
+  }
+  finalized_ = true;
+}
+
+FunctionRegistry FunctionRegistry::Clone() const {
+  FunctionRegistry clone;
+  clone.functions_.reserve(functions_.size());
+  for (const auto& entry : functions_) {
+    RegistryEntry& cloned_entry = clone.functions_[entry.first];
+    cloned_entry.static_overloads.reserve(
+        entry.second.static_overloads.size());
+    for (const auto& overload : entry.second.static_overloads) {
+      cloned_entry.static_overloads.push_back(
+          StaticFunctionEntry(*overload.descriptor, overload.implementation));
+    }
+    cloned_entry.lazy_overloads.reserve(entry.second.lazy_overloads.size());
+    for (const auto& overload : entry.second.lazy_overloads) {
+      cloned_entry.lazy_overloads.push_back(
+          LazyFunctionEntry(*overload.descriptor, overload.function_provider));
+    }
+  }
+  return clone;
+}
+
 absl::Status FunctionRegistry::Register(
     const cel::FunctionDescriptor& descriptor,
     std::unique_ptr<cel::Function> implementation) {
+  if (finalized_) {
+    return absl::FailedPreconditionError(
+        "FunctionRegistry is finalized and no longer accepts registrations");
+  }
   if (DescriptorRegistered(descriptor)) {
     return absl::Status(
         absl::StatusCode::kAlreadyExists,
@@ -97,6 +153,10 @@ absl::Status FunctionRegistry::Register(
 
 absl::Status FunctionRegistry::RegisterLazyFunction(
     const cel::FunctionDescriptor& descriptor) {
+  if (finalized_) {
+    return absl::FailedPreconditionError(
+        "FunctionRegistry is finalized and no longer accepts registrations");
+  }
   if (DescriptorRegistered(descriptor)) {
     return absl::Status(
         absl::StatusCode::kAlreadyExists,
@@ -120,6 +180,22 @@ FunctionRegistry::FindStaticOverloads(absl::string_view name,
                                       absl::Span<const cel::Kind> types) const {
   std::vector<cel::FunctionOverloadReference> matched_funcs;
 
+  if (finalized_) {
+    auto indexed = index_.find(name);
+    if (indexed == index_.end()) {
+      return matched_funcs;
+    }
+    const IndexedEntry& entry = indexed->second;
+    for (uint32_t i = entry.static_offset;
+         i < entry.static_offset + entry.static_count; ++i) {
+      if (static_descriptors_[i].ShapeMatches(receiver_style, types)) {
+        matched_funcs.push_back(
+            {static_descriptors_[i], *static_implementations_[i]});
+      }
+    }
+    return matched_funcs;
+  }
+
   auto overloads = functions_.find(name);
   if (overloads == functions_.end()) {
     return matched_funcs;
@@ -139,6 +215,21 @@ std::vector<FunctionRegistry::LazyOverload> FunctionRegistry::FindLazyOverloads(
     absl::Span<const cel::Kind> types) const {
   std::vector<FunctionRegistry::LazyOverload> matched_funcs;
 
+  if (finalized_) {
+    auto indexed = index_.find(name);
+    if (indexed == index_.end()) {
+      return matched_funcs;
+    }
+    const IndexedEntry& entry = indexed->second;
+    for (uint32_t i = entry.lazy_offset;
+         i < entry.lazy_offset + entry.lazy_count; ++i) {
+      if (lazy_descriptors_[i].ShapeMatches(receiver_style, types)) {
+        matched_funcs.push_back({lazy_descriptors_[i], *lazy_providers_[i]});
+      }
+    }
+    return matched_funcs;
+  }
+
   auto overloads = functions_.find(name);
   if (overloads == functions_.end()) {
     return matched_funcs;
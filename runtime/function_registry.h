@@ -15,6 +15,7 @@
 #ifndef THIRD_PARTY_CEL_CPP_RUNTIME_FUNCTION_REGISTRY_H_
 #define THIRD_PARTY_CEL_CPP_RUNTIME_FUNCTION_REGISTRY_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -57,6 +58,27 @@ class FunctionRegistry {
   FunctionRegistry(FunctionRegistry&&) = default;
   FunctionRegistry& operator=(FunctionRegistry&&) = default;
 
+  // Freezes the registry into an immutable, contiguous overload index.
+  //
+  // Lookups afterwards scan densely packed descriptors for the queried name
+  // instead of chasing per-registration heap entries, and require no
+  // synchronization since the registry can no longer change. Registration
+  // after finalization fails with FAILED_PRECONDITION. Idempotent.
+  //
+  // Called by RuntimeBuilder::Build; standalone users finalizing manually
+  // must do so before sharing the registry across threads.
+  void Finalize();
+
+  // Returns a copy of this registry's registration state.
+  //
+  // Descriptors are copied; function implementations and lazy providers are
+  // shared with the original (they are immutable once registered), so a clone
+  // is much cheaper than repeating the registrations. The clone accepts
+  // further registrations and is not finalized, even if this registry is.
+  // Intended for stamping out registries from a prebuilt snapshot, e.g. the
+  // standard library.
+  FunctionRegistry Clone() const;
+
   // Register a function implementation for the given descriptor.
   // Function registration should be performed prior to CelExpression creation.
   absl::Status Register(const cel::FunctionDescriptor& descriptor,
@@ -106,27 +128,31 @@ class FunctionRegistry {
  private:
   struct StaticFunctionEntry {
     StaticFunctionEntry(const cel::FunctionDescriptor& descriptor,
-                        std::unique_ptr<cel::Function> impl)
+                        std::shared_ptr<const cel::Function> impl)
         : descriptor(std::make_unique<cel::FunctionDescriptor>(descriptor)),
           implementation(std::move(impl)) {}
 
     // Extra indirection needed to preserve pointer stability for the
     // descriptors.
     std::unique_ptr<cel::FunctionDescriptor> descriptor;
-    std::unique_ptr<cel::Function> implementation;
+    // Shared so clones of the registry can reuse the implementation; an
+    // implementation is never mutated after registration.
+    std::shared_ptr<const cel::Function> implementation;
   };
 
   struct LazyFunctionEntry {
     LazyFunctionEntry(
         const cel::FunctionDescriptor& descriptor,
-        std::unique_ptr<cel::runtime_internal::FunctionProvider> provider)
+        std::shared_ptr<const cel::runtime_internal::FunctionProvider> provider)
         : descriptor(std::make_unique<cel::FunctionDescriptor>(descriptor)),
           function_provider(std::move(provider)) {}
 
     // Extra indirection needed to preserve pointer stability for the
     // descriptors.
     std::unique_ptr<cel::FunctionDescriptor> descriptor;
-    std::unique_ptr<cel::runtime_internal::FunctionProvider> function_provider;
+    // Shared so clones of the registry can reuse the provider.
+    std::shared_ptr<const cel::runtime_internal::FunctionProvider>
+        function_provider;
   };
 
   struct RegistryEntry {
@@ -143,8 +169,27 @@ class FunctionRegistry {
   bool ValidateNonStrictOverload(
       const cel::FunctionDescriptor& descriptor) const;
 
+  // Per-name ranges into the finalized index arrays.
+  struct IndexedEntry {
+    uint32_t static_offset;
+    uint32_t static_count;
+    uint32_t lazy_offset;
+    uint32_t lazy_count;
+  };
+
   // indexed by function name (not type checker overload id).
   absl::flat_hash_map<std::string, RegistryEntry> functions_;
+
+  // Finalized index. Descriptors are copied into contiguous storage grouped
+  // by name; implementations and providers stay owned by `functions_`. Keys
+  // view into the keys of `functions_`, which are stable once registration
+  // stops.
+  bool finalized_ = false;
+  absl::flat_hash_map<absl::string_view, IndexedEntry> index_;
+  std::vector<cel::FunctionDescriptor> static_descriptors_;
+  std::vector<const cel::Function*> static_implementations_;
+  std::vector<cel::FunctionDescriptor> lazy_descriptors_;
+  std::vector<const cel::runtime_internal::FunctionProvider*> lazy_providers_;
 };
 
 }  // namespace cel
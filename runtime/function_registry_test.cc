@@ -93,6 +93,80 @@ TEST(FunctionRegistryTest, FindStaticOverloadsReturns) {
       << "Expected single ConstFunction()";
 }
 
+TEST(FunctionRegistryTest, FindStaticOverloadsAfterFinalize) {
+  FunctionRegistry registry;
+  cel::FunctionDescriptor desc = ConstIntFunction::MakeDescriptor();
+  ASSERT_OK(registry.Register(desc, std::make_unique<ConstIntFunction>()));
+
+  registry.Finalize();
+
+  std::vector<cel::FunctionOverloadReference> overloads =
+      registry.FindStaticOverloads(desc.name(), false, {});
+  EXPECT_THAT(overloads, SizeIs(1));
+  EXPECT_THAT(registry.FindStaticOverloads("MissingFunction", false, {}),
+              SizeIs(0));
+}
+
+TEST(FunctionRegistryTest, FindLazyOverloadsAfterFinalize) {
+  cel::FunctionDescriptor lazy_function_desc{"LazyFunction", false, {}};
+  FunctionRegistry registry;
+  ASSERT_OK(registry.RegisterLazyFunction(lazy_function_desc));
+
+  registry.Finalize();
+
+  EXPECT_THAT(registry.FindLazyOverloads("LazyFunction", false, {}),
+              SizeIs(1));
+}
+
+TEST(FunctionRegistryTest, CloneSharesImplementations) {
+  FunctionRegistry registry;
+  cel::FunctionDescriptor desc = ConstIntFunction::MakeDescriptor();
+  ASSERT_OK(registry.Register(desc, std::make_unique<ConstIntFunction>()));
+  ASSERT_OK(registry.RegisterLazyFunction(
+      cel::FunctionDescriptor{"LazyFunction", false, {}}));
+
+  FunctionRegistry clone = registry.Clone();
+
+  std::vector<cel::FunctionOverloadReference> original_overloads =
+      registry.FindStaticOverloads(desc.name(), false, {});
+  std::vector<cel::FunctionOverloadReference> cloned_overloads =
+      clone.FindStaticOverloads(desc.name(), false, {});
+  ASSERT_THAT(original_overloads, SizeIs(1));
+  ASSERT_THAT(cloned_overloads, SizeIs(1));
+  // The implementation is shared rather than copied.
+  EXPECT_EQ(&original_overloads[0].implementation,
+            &cloned_overloads[0].implementation);
+  EXPECT_THAT(clone.FindLazyOverloads("LazyFunction", false, {}), SizeIs(1));
+}
+
+TEST(FunctionRegistryTest, CloneOfFinalizedRegistryAcceptsRegistrations) {
+  FunctionRegistry registry;
+  ASSERT_OK(registry.Register(ConstIntFunction::MakeDescriptor(),
+                              std::make_unique<ConstIntFunction>()));
+  registry.Finalize();
+
+  FunctionRegistry clone = registry.Clone();
+
+  ASSERT_OK(clone.Register(cel::FunctionDescriptor{"Other", false, {}},
+                           std::make_unique<ConstIntFunction>()));
+  EXPECT_THAT(clone.FindStaticOverloads("Other", false, {}), SizeIs(1));
+  // The original is unaffected.
+  EXPECT_THAT(registry.FindStaticOverloads("Other", false, {}), SizeIs(0));
+}
+
+TEST(FunctionRegistryTest, RegisterAfterFinalizeFails) {
+  FunctionRegistry registry;
+  registry.Finalize();
+
+  EXPECT_THAT(registry.Register(ConstIntFunction::MakeDescriptor(),
+                                std::make_unique<ConstIntFunction>()),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+  EXPECT_THAT(
+      registry.RegisterLazyFunction(
+          cel::FunctionDescriptor{"LazyFunction", false, {}}),
+      StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
 TEST(FunctionRegistryTest, ListFunctions) {
   cel::FunctionDescriptor lazy_function_desc{"LazyFunction", false, {}};
   FunctionRegistry registry;
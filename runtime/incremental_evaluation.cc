@@ -0,0 +1,119 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/incremental_evaluation.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "base/attribute.h"
+#include "base/kind.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "internal/status_macros.h"
+#include "runtime/activation_interface.h"
+#include "runtime/function_overload_reference.h"
+#include "runtime/slot_activation.h"
+
+namespace cel {
+
+namespace {
+
+// Forwards to a delegate activation while recording the name of every
+// variable the evaluation resolves. Lookups that find nothing are recorded
+// too: binding a previously unbound variable is a change the cache must see.
+class RecordingActivation final : public ActivationInterface {
+ public:
+  RecordingActivation(const ActivationInterface& delegate,
+                      absl::flat_hash_set<std::string>& dependencies)
+      : delegate_(delegate), dependencies_(dependencies) {}
+
+  absl::StatusOr<bool> FindVariable(ValueManager& factory,
+                                    absl::string_view name,
+                                    Value& result) const override {
+    dependencies_.emplace(name);
+    return delegate_.FindVariable(factory, name, result);
+  }
+
+  std::vector<FunctionOverloadReference> FindFunctionOverloads(
+      absl::string_view name) const override {
+    return delegate_.FindFunctionOverloads(name);
+  }
+
+  absl::StatusOr<absl::optional<FunctionOverloadReference>>
+  FindFunctionOverload(absl::string_view name, bool receiver_style,
+                       absl::Span<const Kind> types) const override {
+    return delegate_.FindFunctionOverload(name, receiver_style, types);
+  }
+
+  absl::Span<const cel::AttributePattern> GetUnknownAttributes()
+      const override {
+    return delegate_.GetUnknownAttributes();
+  }
+
+  absl::Span<const cel::AttributePattern> GetMissingAttributes()
+      const override {
+    return delegate_.GetMissingAttributes();
+  }
+
+  // Slot-based reads bypass FindVariable, which would hide dependencies from
+  // the recorder, so force name-based resolution.
+  absl::Nullable<const SlotActivation*> AsSlotActivation() const override {
+    return nullptr;
+  }
+
+ private:
+  const ActivationInterface& delegate_;
+  absl::flat_hash_set<std::string>& dependencies_;
+};
+
+}  // namespace
+
+absl::StatusOr<Value> IncrementalProgram::Evaluate(
+    const ActivationInterface& activation, ValueManager& value_factory,
+    absl::Span<const std::string> changed_variables) {
+  if (has_cached_result_) {
+    bool stale = false;
+    for (const auto& name : changed_variables) {
+      if (dependencies_.contains(name)) {
+        stale = true;
+        break;
+      }
+    }
+    if (!stale) {
+      return cached_result_;
+    }
+  }
+  has_cached_result_ = false;
+  dependencies_.clear();
+  RecordingActivation recording(activation, dependencies_);
+  CEL_ASSIGN_OR_RETURN(cached_result_,
+                       program_->Evaluate(recording, value_factory));
+  has_cached_result_ = true;
+  return cached_result_;
+}
+
+void IncrementalProgram::Invalidate() {
+  has_cached_result_ = false;
+  cached_result_ = Value();
+  dependencies_.clear();
+}
+
+}  // namespace cel
@@ -0,0 +1,87 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_INCREMENTAL_EVALUATION_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_INCREMENTAL_EVALUATION_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "runtime/activation_interface.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+
+// Memoizing wrapper for watch-style workloads that re-evaluate the same
+// program whenever one of many bound variables changes.
+//
+// The wrapper records which activation variables an evaluation actually
+// resolves. On the next evaluation the caller reports which variables changed
+// since the prior run; if none of them intersect the recorded dependency set,
+// the cached result is returned without running the program at all. Programs
+// that reference a handful of a large activation's variables therefore only
+// pay for evaluation when one of those few variables moves.
+//
+// The cached result is a `Value` produced by the wrapped program, so the
+// caller must use the same memory manager across evaluations and keep it
+// alive for as long as cached results are handed out. The cache also assumes
+// the activation's unknown and missing attribute patterns are stable between
+// runs; call `Invalidate` if they change.
+//
+// Not thread-safe: unlike `Program`, an `IncrementalProgram` carries
+// per-evaluation state and must be confined to one evaluation at a time.
+class IncrementalProgram final {
+ public:
+  explicit IncrementalProgram(std::unique_ptr<Program> program)
+      : program_(std::move(program)) {}
+
+  // Move only.
+  IncrementalProgram(const IncrementalProgram&) = delete;
+  IncrementalProgram& operator=(const IncrementalProgram&) = delete;
+  IncrementalProgram(IncrementalProgram&&) = default;
+  IncrementalProgram& operator=(IncrementalProgram&&) = default;
+
+  // Evaluate the program, reusing the prior result when possible.
+  //
+  // `changed_variables` names the variables whose bindings changed since the
+  // last call. It is ignored on the first evaluation and after `Invalidate`.
+  // Reporting a superset of the actual changes is safe (it can only force an
+  // unnecessary re-evaluation); under-reporting returns a stale result.
+  absl::StatusOr<Value> Evaluate(const ActivationInterface& activation,
+                                 ValueManager& value_factory,
+                                 absl::Span<const std::string> changed_variables);
+
+  // Drop the cached result and recorded dependencies. The next evaluation
+  // runs the program unconditionally.
+  void Invalidate();
+
+  const Program& program() const { return *program_; }
+
+ private:
+  std::unique_ptr<Program> program_;
+  bool has_cached_result_ = false;
+  Value cached_result_;
+  absl::flat_hash_set<std::string> dependencies_;
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_INCREMENTAL_EVALUATION_H_
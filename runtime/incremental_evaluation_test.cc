@@ -0,0 +1,130 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/incremental_evaluation.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+
+namespace cel {
+namespace {
+
+using ::google::api::expr::v1alpha1::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+using ::cel::extensions::ProtobufRuntimeAdapter;
+
+class IncrementalEvaluationTest : public testing::Test {
+ protected:
+  absl::StatusOr<IncrementalProgram> MakeProgram(
+      absl::string_view expression) {
+    RuntimeOptions options;
+    CEL_ASSIGN_OR_RETURN(RuntimeBuilder builder,
+                         CreateStandardRuntimeBuilder(options));
+    CEL_ASSIGN_OR_RETURN(runtime_, std::move(builder).Build());
+
+    CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+    CEL_ASSIGN_OR_RETURN(auto program, ProtobufRuntimeAdapter::CreateProgram(
+                                           *runtime_, parsed_expr));
+    value_factory_ = std::make_unique<ManagedValueFactory>(
+        program->GetTypeProvider(), MemoryManagerRef::ReferenceCounting());
+    return IncrementalProgram(std::move(program));
+  }
+
+  ValueManager& value_manager() { return value_factory_->get(); }
+
+  std::unique_ptr<const Runtime> runtime_;
+  std::unique_ptr<ManagedValueFactory> value_factory_;
+};
+
+TEST_F(IncrementalEvaluationTest, UnchangedDependenciesReturnCachedResult) {
+  ASSERT_OK_AND_ASSIGN(IncrementalProgram program, MakeProgram("a + b"));
+
+  Activation activation;
+  activation.InsertOrAssignValue("a", value_manager().CreateIntValue(1));
+  activation.InsertOrAssignValue("b", value_manager().CreateIntValue(2));
+  activation.InsertOrAssignValue("c", value_manager().CreateIntValue(100));
+
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       program.Evaluate(activation, value_manager(), {}));
+  EXPECT_EQ(result->As<IntValue>().NativeValue(), 3);
+
+  // Rebind a dependency, but only report an unrelated variable as changed:
+  // the cached result must be returned without re-evaluating.
+  activation.InsertOrAssignValue("a", value_manager().CreateIntValue(10));
+  std::vector<std::string> changed = {"c"};
+  ASSERT_OK_AND_ASSIGN(result,
+                       program.Evaluate(activation, value_manager(), changed));
+  EXPECT_EQ(result->As<IntValue>().NativeValue(), 3);
+
+  // Reporting the dependency picks up the new binding.
+  changed = {"a"};
+  ASSERT_OK_AND_ASSIGN(result,
+                       program.Evaluate(activation, value_manager(), changed));
+  EXPECT_EQ(result->As<IntValue>().NativeValue(), 12);
+}
+
+TEST_F(IncrementalEvaluationTest, BindingAnUnboundDependencyInvalidates) {
+  ASSERT_OK_AND_ASSIGN(IncrementalProgram program, MakeProgram("a + b"));
+
+  Activation activation;
+  activation.InsertOrAssignValue("a", value_manager().CreateIntValue(1));
+
+  // `b` is unbound: evaluation yields a CEL error, and the failed lookup is
+  // still recorded as a dependency.
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       program.Evaluate(activation, value_manager(), {}));
+  EXPECT_TRUE(result->Is<ErrorValue>());
+
+  activation.InsertOrAssignValue("b", value_manager().CreateIntValue(2));
+  std::vector<std::string> changed = {"b"};
+  ASSERT_OK_AND_ASSIGN(result,
+                       program.Evaluate(activation, value_manager(), changed));
+  EXPECT_EQ(result->As<IntValue>().NativeValue(), 3);
+}
+
+TEST_F(IncrementalEvaluationTest, InvalidateForcesReEvaluation) {
+  ASSERT_OK_AND_ASSIGN(IncrementalProgram program, MakeProgram("a * 2"));
+
+  Activation activation;
+  activation.InsertOrAssignValue("a", value_manager().CreateIntValue(3));
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       program.Evaluate(activation, value_manager(), {}));
+  EXPECT_EQ(result->As<IntValue>().NativeValue(), 6);
+
+  activation.InsertOrAssignValue("a", value_manager().CreateIntValue(4));
+  program.Invalidate();
+  ASSERT_OK_AND_ASSIGN(result,
+                       program.Evaluate(activation, value_manager(), {}));
+  EXPECT_EQ(result->As<IntValue>().NativeValue(), 8);
+}
+
+}  // namespace
+}  // namespace cel
@@ -0,0 +1,240 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/inlined_builtin_optimization.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+
+#include "google/api/expr/v1alpha1/checked.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "runtime/activation.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "google/protobuf/text_format.h"
+
+namespace cel {
+namespace {
+
+using ::cel::extensions::ProtobufRuntimeAdapter;
+using ::google::api::expr::v1alpha1::CheckedExpr;
+
+// !x, with the checker-resolved bool overload.
+constexpr absl::string_view kNotExpression = R"pb(
+  reference_map: {
+    key: 2
+    value: { overload_id: "logical_not" }
+  }
+  expr: {
+    id: 2
+    call_expr: {
+      function: "!_"
+      args: {
+        id: 1
+        ident_expr: { name: "x" }
+      }
+    }
+  })pb";
+
+// -x, with the checker-resolved int64 overload.
+constexpr absl::string_view kNegExpression = R"pb(
+  reference_map: {
+    key: 2
+    value: { overload_id: "negate_int64" }
+  }
+  expr: {
+    id: 2
+    call_expr: {
+      function: "-_"
+      args: {
+        id: 1
+        ident_expr: { name: "x" }
+      }
+    }
+  })pb";
+
+// x.size(), with the checker-resolved receiver-style string overload.
+constexpr absl::string_view kStringSizeExpression = R"pb(
+  reference_map: {
+    key: 2
+    value: { overload_id: "string_size" }
+  }
+  expr: {
+    id: 2
+    call_expr: {
+      function: "size"
+      target: {
+        id: 1
+        ident_expr: { name: "x" }
+      }
+    }
+  })pb";
+
+// string(x), with the checker-resolved int64 overload.
+constexpr absl::string_view kIntToStringExpression = R"pb(
+  reference_map: {
+    key: 2
+    value: { overload_id: "int64_to_string" }
+  }
+  expr: {
+    id: 2
+    call_expr: {
+      function: "string"
+      args: {
+        id: 1
+        ident_expr: { name: "x" }
+      }
+    }
+  })pb";
+
+// int(x), with the checker-resolved string overload.
+constexpr absl::string_view kStringToIntExpression = R"pb(
+  reference_map: {
+    key: 2
+    value: { overload_id: "string_to_int64" }
+  }
+  expr: {
+    id: 2
+    call_expr: {
+      function: "int"
+      args: {
+        id: 1
+        ident_expr: { name: "x" }
+      }
+    }
+  })pb";
+
+// double(x), with the checker-resolved int64 overload.
+constexpr absl::string_view kIntToDoubleExpression = R"pb(
+  reference_map: {
+    key: 2
+    value: { overload_id: "int64_to_double" }
+  }
+  expr: {
+    id: 2
+    call_expr: {
+      function: "double"
+      args: {
+        id: 1
+        ident_expr: { name: "x" }
+      }
+    }
+  })pb";
+
+class InlinedBuiltinOptimizationTest : public testing::Test {
+ protected:
+  absl::StatusOr<Value> EvaluateChecked(absl::string_view checked_textproto,
+                                        Value x) {
+    CheckedExpr checked_expr;
+    if (!google::protobuf::TextFormat::ParseFromString(checked_textproto,
+                                             &checked_expr)) {
+      return absl::InternalError("failed to parse test expression");
+    }
+    RuntimeOptions options;
+    CEL_ASSIGN_OR_RETURN(RuntimeBuilder builder,
+                         CreateStandardRuntimeBuilder(options));
+    CEL_RETURN_IF_ERROR(extensions::EnableInlinedBuiltinOptimization(builder));
+    CEL_ASSIGN_OR_RETURN(auto runtime, std::move(builder).Build());
+    CEL_ASSIGN_OR_RETURN(auto program, ProtobufRuntimeAdapter::CreateProgram(
+                                           *runtime, checked_expr));
+
+    ManagedValueFactory value_factory(program->GetTypeProvider(),
+                                      MemoryManagerRef::ReferenceCounting());
+    Activation activation;
+    activation.InsertOrAssignValue("x", std::move(x));
+    return program->Evaluate(activation, value_factory.get());
+  }
+};
+
+TEST_F(InlinedBuiltinOptimizationTest, Not) {
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       EvaluateChecked(kNotExpression, BoolValue(false)));
+  ASSERT_TRUE(result->Is<BoolValue>());
+  EXPECT_TRUE(result->As<BoolValue>().NativeValue());
+}
+
+TEST_F(InlinedBuiltinOptimizationTest, NegateInt64) {
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       EvaluateChecked(kNegExpression, IntValue(42)));
+  ASSERT_TRUE(result->Is<IntValue>());
+  EXPECT_EQ(result->As<IntValue>().NativeValue(), -42);
+}
+
+TEST_F(InlinedBuiltinOptimizationTest, NegateInt64Overflow) {
+  ASSERT_OK_AND_ASSIGN(
+      Value result,
+      EvaluateChecked(kNegExpression,
+                      IntValue(std::numeric_limits<int64_t>::min())));
+  ASSERT_TRUE(result->Is<ErrorValue>());
+}
+
+TEST_F(InlinedBuiltinOptimizationTest, StringSize) {
+  ASSERT_OK_AND_ASSIGN(
+      Value result,
+      EvaluateChecked(kStringSizeExpression, StringValue("hello")));
+  ASSERT_TRUE(result->Is<IntValue>());
+  EXPECT_EQ(result->As<IntValue>().NativeValue(), 5);
+}
+
+TEST_F(InlinedBuiltinOptimizationTest, StringFromInt) {
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       EvaluateChecked(kIntToStringExpression, IntValue(42)));
+  ASSERT_TRUE(result->Is<StringValue>());
+  EXPECT_EQ(result->As<StringValue>().ToString(), "42");
+}
+
+TEST_F(InlinedBuiltinOptimizationTest, IntFromString) {
+  ASSERT_OK_AND_ASSIGN(
+      Value result,
+      EvaluateChecked(kStringToIntExpression, StringValue("123")));
+  ASSERT_TRUE(result->Is<IntValue>());
+  EXPECT_EQ(result->As<IntValue>().NativeValue(), 123);
+}
+
+TEST_F(InlinedBuiltinOptimizationTest, IntFromStringInvalid) {
+  ASSERT_OK_AND_ASSIGN(
+      Value result,
+      EvaluateChecked(kStringToIntExpression, StringValue("not a number")));
+  ASSERT_TRUE(result->Is<ErrorValue>());
+}
+
+TEST_F(InlinedBuiltinOptimizationTest, DoubleFromInt) {
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       EvaluateChecked(kIntToDoubleExpression, IntValue(3)));
+  ASSERT_TRUE(result->Is<DoubleValue>());
+  EXPECT_EQ(result->As<DoubleValue>().NativeValue(), 3.0);
+}
+
+TEST_F(InlinedBuiltinOptimizationTest, MistypedOperandIsError) {
+  // The checker pinned bool, but the activation binds an int; the inlined
+  // step reports a missing overload like regular dispatch.
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       EvaluateChecked(kNotExpression, IntValue(1)));
+  ASSERT_TRUE(result->Is<ErrorValue>());
+}
+
+}  // namespace
+}  // namespace cel
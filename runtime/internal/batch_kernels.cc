@@ -0,0 +1,129 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/batch_kernels.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "absl/log/absl_check.h"
+#include "absl/types/span.h"
+
+namespace cel::runtime_internal {
+
+namespace {
+
+// __builtin_*_overflow compiles to flag checks that vectorize reasonably;
+// fall back to the portable checks otherwise.
+#if defined(__clang__) || defined(__GNUC__)
+inline bool AddOverflow(int64_t x, int64_t y, int64_t* out) {
+  return __builtin_add_overflow(x, y, out);
+}
+inline bool SubOverflow(int64_t x, int64_t y, int64_t* out) {
+  return __builtin_sub_overflow(x, y, out);
+}
+inline bool MulOverflow(int64_t x, int64_t y, int64_t* out) {
+  return __builtin_mul_overflow(x, y, out);
+}
+#else
+inline bool AddOverflow(int64_t x, int64_t y, int64_t* out) {
+  *out = static_cast<int64_t>(static_cast<uint64_t>(x) +
+                              static_cast<uint64_t>(y));
+  return (y > 0 && x > std::numeric_limits<int64_t>::max() - y) ||
+         (y < 0 && x < std::numeric_limits<int64_t>::min() - y);
+}
+inline bool SubOverflow(int64_t x, int64_t y, int64_t* out) {
+  *out = static_cast<int64_t>(static_cast<uint64_t>(x) -
+                              static_cast<uint64_t>(y));
+  return (y < 0 && x > std::numeric_limits<int64_t>::max() + y) ||
+         (y > 0 && x < std::numeric_limits<int64_t>::min() + y);
+}
+inline bool MulOverflow(int64_t x, int64_t y, int64_t* out) {
+  *out = static_cast<int64_t>(static_cast<uint64_t>(x) *
+                              static_cast<uint64_t>(y));
+  return x != 0 && (*out / x != y || (x == -1 && y == std::numeric_limits<int64_t>::min()));
+}
+#endif
+
+}  // namespace
+
+#define CEL_BATCH_BINARY_KERNEL(name, in_type, out_type, expr)       \
+  void name(absl::Span<const in_type> lhs, absl::Span<const in_type> rhs, \
+            absl::Span<out_type> out) {                              \
+    ABSL_DCHECK_EQ(lhs.size(), rhs.size());                          \
+    ABSL_DCHECK_EQ(lhs.size(), out.size());                          \
+    const size_t n = lhs.size();                                     \
+    for (size_t i = 0; i < n; ++i) {                                 \
+      out[i] = (expr);                                               \
+    }                                                                \
+  }
+
+CEL_BATCH_BINARY_KERNEL(BatchAddDouble, double, double, lhs[i] + rhs[i])
+CEL_BATCH_BINARY_KERNEL(BatchSubDouble, double, double, lhs[i] - rhs[i])
+CEL_BATCH_BINARY_KERNEL(BatchMulDouble, double, double, lhs[i] * rhs[i])
+CEL_BATCH_BINARY_KERNEL(BatchDivDouble, double, double, lhs[i] / rhs[i])
+
+CEL_BATCH_BINARY_KERNEL(BatchLtInt64, int64_t, uint8_t,
+                        static_cast<uint8_t>(lhs[i] < rhs[i]))
+CEL_BATCH_BINARY_KERNEL(BatchLeInt64, int64_t, uint8_t,
+                        static_cast<uint8_t>(lhs[i] <= rhs[i]))
+CEL_BATCH_BINARY_KERNEL(BatchEqInt64, int64_t, uint8_t,
+                        static_cast<uint8_t>(lhs[i] == rhs[i]))
+CEL_BATCH_BINARY_KERNEL(BatchLtDouble, double, uint8_t,
+                        static_cast<uint8_t>(lhs[i] < rhs[i]))
+CEL_BATCH_BINARY_KERNEL(BatchLeDouble, double, uint8_t,
+                        static_cast<uint8_t>(lhs[i] <= rhs[i]))
+CEL_BATCH_BINARY_KERNEL(BatchEqDouble, double, uint8_t,
+                        static_cast<uint8_t>(lhs[i] == rhs[i]))
+
+CEL_BATCH_BINARY_KERNEL(BatchAndBool, uint8_t, uint8_t,
+                        static_cast<uint8_t>(lhs[i] & rhs[i]))
+CEL_BATCH_BINARY_KERNEL(BatchOrBool, uint8_t, uint8_t,
+                        static_cast<uint8_t>(lhs[i] | rhs[i]))
+
+#undef CEL_BATCH_BINARY_KERNEL
+
+void BatchNotBool(absl::Span<const uint8_t> operand, absl::Span<uint8_t> out) {
+  ABSL_DCHECK_EQ(operand.size(), out.size());
+  const size_t n = operand.size();
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = static_cast<uint8_t>(operand[i] ^ uint8_t{1});
+  }
+}
+
+#define CEL_BATCH_CHECKED_KERNEL(name, op)                                 \
+  bool name(absl::Span<const int64_t> lhs, absl::Span<const int64_t> rhs,  \
+            absl::Span<int64_t> out, absl::Span<uint8_t> overflow) {       \
+    ABSL_DCHECK_EQ(lhs.size(), rhs.size());                                \
+    ABSL_DCHECK_EQ(lhs.size(), out.size());                                \
+    ABSL_DCHECK_EQ(lhs.size(), overflow.size());                          \
+    const size_t n = lhs.size();                                           \
+    uint8_t any = 0;                                                       \
+    for (size_t i = 0; i < n; ++i) {                                       \
+      int64_t result;                                                      \
+      overflow[i] = static_cast<uint8_t>(op(lhs[i], rhs[i], &result));     \
+      any |= overflow[i];                                                  \
+      out[i] = result;                                                     \
+    }                                                                      \
+    return any != 0;                                                       \
+  }
+
+CEL_BATCH_CHECKED_KERNEL(BatchAddInt64, AddOverflow)
+CEL_BATCH_CHECKED_KERNEL(BatchSubInt64, SubOverflow)
+CEL_BATCH_CHECKED_KERNEL(BatchMulInt64, MulOverflow)
+
+#undef CEL_BATCH_CHECKED_KERNEL
+
+}  // namespace cel::runtime_internal
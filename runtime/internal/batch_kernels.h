@@ -0,0 +1,79 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_BATCH_KERNELS_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_BATCH_KERNELS_H_
+
+#include <cstdint>
+
+#include "absl/types/span.h"
+
+namespace cel::runtime_internal {
+
+// Columnar kernels for the standard arithmetic and comparison operators.
+//
+// These operate on contiguous spans of unboxed values so batch evaluation
+// can bypass per-value function dispatch. They are written as plain loops
+// over spans rather than with explicit SIMD intrinsics so that they
+// vectorize under the default toolchain flags on both x86 and ARM without
+// per-platform code paths.
+//
+// All spans must be the same size; `out` may alias an input.
+
+// Double arithmetic. CEL double arithmetic has no error cases.
+void BatchAddDouble(absl::Span<const double> lhs, absl::Span<const double> rhs,
+                    absl::Span<double> out);
+void BatchSubDouble(absl::Span<const double> lhs, absl::Span<const double> rhs,
+                    absl::Span<double> out);
+void BatchMulDouble(absl::Span<const double> lhs, absl::Span<const double> rhs,
+                    absl::Span<double> out);
+void BatchDivDouble(absl::Span<const double> lhs, absl::Span<const double> rhs,
+                    absl::Span<double> out);
+
+// Checked int64 arithmetic matching CEL overflow semantics. Lane `i` of
+// `overflow` is set to 1 when the operation over- or underflows (the
+// corresponding `out` lane is unspecified); callers materialize an
+// ErrorValue for flagged lanes. Returns true if any lane overflowed, so the
+// caller can skip the error scan entirely in the common case.
+bool BatchAddInt64(absl::Span<const int64_t> lhs, absl::Span<const int64_t> rhs,
+                   absl::Span<int64_t> out, absl::Span<uint8_t> overflow);
+bool BatchSubInt64(absl::Span<const int64_t> lhs, absl::Span<const int64_t> rhs,
+                   absl::Span<int64_t> out, absl::Span<uint8_t> overflow);
+bool BatchMulInt64(absl::Span<const int64_t> lhs, absl::Span<const int64_t> rhs,
+                   absl::Span<int64_t> out, absl::Span<uint8_t> overflow);
+
+// Comparisons. Results are 0/1 bytes.
+void BatchLtInt64(absl::Span<const int64_t> lhs, absl::Span<const int64_t> rhs,
+                  absl::Span<uint8_t> out);
+void BatchLeInt64(absl::Span<const int64_t> lhs, absl::Span<const int64_t> rhs,
+                  absl::Span<uint8_t> out);
+void BatchEqInt64(absl::Span<const int64_t> lhs, absl::Span<const int64_t> rhs,
+                  absl::Span<uint8_t> out);
+void BatchLtDouble(absl::Span<const double> lhs, absl::Span<const double> rhs,
+                   absl::Span<uint8_t> out);
+void BatchLeDouble(absl::Span<const double> lhs, absl::Span<const double> rhs,
+                   absl::Span<uint8_t> out);
+void BatchEqDouble(absl::Span<const double> lhs, absl::Span<const double> rhs,
+                   absl::Span<uint8_t> out);
+
+// Logical operators over 0/1 bytes.
+void BatchAndBool(absl::Span<const uint8_t> lhs, absl::Span<const uint8_t> rhs,
+                  absl::Span<uint8_t> out);
+void BatchOrBool(absl::Span<const uint8_t> lhs, absl::Span<const uint8_t> rhs,
+                 absl::Span<uint8_t> out);
+void BatchNotBool(absl::Span<const uint8_t> operand, absl::Span<uint8_t> out);
+
+}  // namespace cel::runtime_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_BATCH_KERNELS_H_
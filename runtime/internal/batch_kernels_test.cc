@@ -0,0 +1,100 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/batch_kernels.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "internal/testing.h"
+
+namespace cel::runtime_internal {
+
+namespace {
+
+using testing::ElementsAre;
+
+TEST(BatchKernelsTest, AddDouble) {
+  std::vector<double> lhs = {1.0, 2.5, -3.0};
+  std::vector<double> rhs = {0.5, 0.5, 3.0};
+  std::vector<double> out(3);
+  BatchAddDouble(lhs, rhs, absl::MakeSpan(out));
+  EXPECT_THAT(out, ElementsAre(1.5, 3.0, 0.0));
+}
+
+TEST(BatchKernelsTest, AddInt64NoOverflow) {
+  std::vector<int64_t> lhs = {1, 2, 3};
+  std::vector<int64_t> rhs = {4, 5, 6};
+  std::vector<int64_t> out(3);
+  std::vector<uint8_t> overflow(3);
+  EXPECT_FALSE(BatchAddInt64(lhs, rhs, absl::MakeSpan(out),
+                             absl::MakeSpan(overflow)));
+  EXPECT_THAT(out, ElementsAre(5, 7, 9));
+  EXPECT_THAT(overflow, ElementsAre(0, 0, 0));
+}
+
+TEST(BatchKernelsTest, AddInt64FlagsOverflowLanes) {
+  constexpr int64_t kMax = std::numeric_limits<int64_t>::max();
+  std::vector<int64_t> lhs = {kMax, 1};
+  std::vector<int64_t> rhs = {1, 1};
+  std::vector<int64_t> out(2);
+  std::vector<uint8_t> overflow(2);
+  EXPECT_TRUE(BatchAddInt64(lhs, rhs, absl::MakeSpan(out),
+                            absl::MakeSpan(overflow)));
+  EXPECT_EQ(overflow[0], 1);
+  EXPECT_EQ(overflow[1], 0);
+  EXPECT_EQ(out[1], 2);
+}
+
+TEST(BatchKernelsTest, MulInt64FlagsOverflowLanes) {
+  constexpr int64_t kMin = std::numeric_limits<int64_t>::min();
+  std::vector<int64_t> lhs = {kMin, 3};
+  std::vector<int64_t> rhs = {-1, 3};
+  std::vector<int64_t> out(2);
+  std::vector<uint8_t> overflow(2);
+  EXPECT_TRUE(BatchMulInt64(lhs, rhs, absl::MakeSpan(out),
+                            absl::MakeSpan(overflow)));
+  EXPECT_EQ(overflow[0], 1);
+  EXPECT_EQ(overflow[1], 0);
+  EXPECT_EQ(out[1], 9);
+}
+
+TEST(BatchKernelsTest, Comparisons) {
+  std::vector<int64_t> lhs = {1, 2, 3};
+  std::vector<int64_t> rhs = {2, 2, 2};
+  std::vector<uint8_t> out(3);
+  BatchLtInt64(lhs, rhs, absl::MakeSpan(out));
+  EXPECT_THAT(out, ElementsAre(1, 0, 0));
+  BatchLeInt64(lhs, rhs, absl::MakeSpan(out));
+  EXPECT_THAT(out, ElementsAre(1, 1, 0));
+  BatchEqInt64(lhs, rhs, absl::MakeSpan(out));
+  EXPECT_THAT(out, ElementsAre(0, 1, 0));
+}
+
+TEST(BatchKernelsTest, Logical) {
+  std::vector<uint8_t> lhs = {0, 0, 1, 1};
+  std::vector<uint8_t> rhs = {0, 1, 0, 1};
+  std::vector<uint8_t> out(4);
+  BatchAndBool(lhs, rhs, absl::MakeSpan(out));
+  EXPECT_THAT(out, ElementsAre(0, 0, 0, 1));
+  BatchOrBool(lhs, rhs, absl::MakeSpan(out));
+  EXPECT_THAT(out, ElementsAre(0, 1, 1, 1));
+  BatchNotBool(lhs, absl::MakeSpan(out));
+  EXPECT_THAT(out, ElementsAre(1, 1, 0, 0));
+}
+
+}  // namespace
+
+}  // namespace cel::runtime_internal
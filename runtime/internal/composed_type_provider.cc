@@ -58,6 +58,9 @@ ComposedTypeProvider::NewStructValueBuilder(ValueFactory& value_factory,
       return builder;
     }
   }
+  if (parent_ != nullptr) {
+    return parent_->NewStructValueBuilder(value_factory, type);
+  }
   return absl::nullopt;
 }
 
@@ -70,6 +73,9 @@ absl::StatusOr<bool> ComposedTypeProvider::FindValue(
       return value;
     }
   }
+  if (parent_ != nullptr) {
+    return parent_->FindValue(value_factory, name, result);
+  }
   return false;
 }
 
@@ -84,6 +90,9 @@ ComposedTypeProvider::DeserializeValueImpl(ValueFactory& value_factory,
       return result;
     }
   }
+  if (parent_ != nullptr) {
+    return parent_->DeserializeValue(value_factory, type_url, value);
+  }
   return absl::nullopt;
 }
 
@@ -96,6 +105,9 @@ absl::StatusOr<absl::optional<TypeView>> ComposedTypeProvider::FindTypeImpl(
       return result;
     }
   }
+  if (parent_ != nullptr) {
+    return parent_->FindType(type_factory, name, scratch);
+  }
   return absl::nullopt;
 }
 
@@ -110,6 +122,10 @@ ComposedTypeProvider::FindStructTypeFieldByNameImpl(
       return result;
     }
   }
+  if (parent_ != nullptr) {
+    return parent_->FindStructTypeFieldByName(type_factory, type, name,
+                                              scratch);
+  }
   return absl::nullopt;
 }
 
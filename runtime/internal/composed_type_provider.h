@@ -18,6 +18,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/nullability.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
@@ -50,6 +51,19 @@ class ComposedTypeProvider : public TypeReflector {
     use_legacy_container_builders_ = use_legacy_container_builders;
   }
 
+  bool use_legacy_container_builders() const {
+    return use_legacy_container_builders_;
+  }
+
+  // Sets a parent provider consulted after this provider's own registrations.
+  //
+  // Used for copy-on-write registry snapshots: a child provider stores only
+  // its delta and falls back to the parent for everything else. The parent
+  // must outlive this provider and must not be updated afterwards.
+  void set_parent(absl::Nullable<const ComposedTypeProvider*> parent) {
+    parent_ = parent;
+  }
+
   // `NewListValueBuilder` returns a new `ListValueBuilderInterface` for the
   // corresponding `ListType` `type`.
   absl::StatusOr<Unique<ListValueBuilder>> NewListValueBuilder(
@@ -84,6 +98,7 @@ class ComposedTypeProvider : public TypeReflector {
 
  private:
   std::vector<std::unique_ptr<TypeReflector>> providers_;
+  absl::Nullable<const ComposedTypeProvider*> parent_ = nullptr;
   bool use_legacy_container_builders_ = true;
 };
 
@@ -0,0 +1,236 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/constant_list_impl.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "common/casting.h"
+#include "common/json.h"
+#include "common/native_type.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "internal/number.h"
+#include "internal/status_macros.h"
+
+namespace cel::runtime_internal {
+
+namespace {
+
+using ::cel::internal::Number;
+
+// Lifts a scalar value into the shared numeric comparison domain, or nullopt
+// if it is not numeric.
+absl::optional<Number> GetNumber(const Value& value) {
+  switch (value.kind()) {
+    case ValueKind::kInt:
+      return Number::FromInt64(Cast<IntValue>(value).NativeValue());
+    case ValueKind::kUint:
+      return Number::FromUint64(Cast<UintValue>(value).NativeValue());
+    case ValueKind::kDouble:
+      return Number::FromDouble(Cast<DoubleValue>(value).NativeValue());
+    default:
+      return absl::nullopt;
+  }
+}
+
+// Immutable list of scalar constants carrying hash indexes over its elements.
+//
+// Elements and their order are preserved for indexing and iteration;
+// `Contains` consults the indexes instead of scanning. Numbers are indexed
+// under a canonical domain (int if losslessly representable, then uint, then
+// double) and probes are canonicalized the same way, which reproduces
+// heterogeneous numeric equality exactly.
+class ConstantListValue final : public ParsedListValueInterface {
+ public:
+  ConstantListValue(ListType type, std::vector<Value> elements)
+      : type_(std::move(type)), elements_(std::move(elements)) {
+    for (const auto& element : elements_) {
+      switch (element.kind()) {
+        case ValueKind::kBool:
+          (Cast<BoolValue>(element).NativeValue() ? has_true_ : has_false_) =
+              true;
+          break;
+        case ValueKind::kString:
+          // Views alias the element storage, which is immutable and owned by
+          // this object. Eligibility checked that every string is flat.
+          strings_.insert(*Cast<StringValue>(element).TryFlat());
+          break;
+        default: {
+          Number number = *GetNumber(element);
+          if (number.LosslessConvertibleToInt()) {
+            ints_.insert(number.AsInt());
+          } else if (number.LosslessConvertibleToUint()) {
+            uints_.insert(number.AsUint());
+          } else {
+            doubles_.insert(number.AsDouble());
+          }
+          break;
+        }
+      }
+    }
+  }
+
+  std::string DebugString() const override {
+    return absl::StrCat(
+        "[", absl::StrJoin(elements_, ", ", absl::StreamFormatter()), "]");
+  }
+
+  bool IsEmpty() const override { return elements_.empty(); }
+
+  size_t Size() const override { return elements_.size(); }
+
+  absl::StatusOr<JsonArray> ConvertToJsonArray(
+      AnyToJsonConverter& converter) const override {
+    JsonArrayBuilder builder;
+    builder.reserve(Size());
+    for (const auto& element : elements_) {
+      CEL_ASSIGN_OR_RETURN(auto json_value, element.ConvertToJson(converter));
+      builder.push_back(std::move(json_value));
+    }
+    return std::move(builder).Build();
+  }
+
+  absl::Status ForEach(ValueManager&,
+                       ForEachWithIndexCallback callback) const override {
+    for (size_t i = 0; i < elements_.size(); ++i) {
+      CEL_ASSIGN_OR_RETURN(auto ok, callback(i, elements_[i]));
+      if (!ok) {
+        break;
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status Contains(ValueManager&, const Value& other,
+                        Value& result) const override {
+    result = BoolValue(ContainsImpl(other));
+    return absl::OkStatus();
+  }
+
+ protected:
+  Type GetTypeImpl(TypeManager&) const override { return type_; }
+
+ private:
+  bool ContainsImpl(const Value& other) const {
+    switch (other.kind()) {
+      case ValueKind::kBool:
+        return Cast<BoolValue>(other).NativeValue() ? has_true_ : has_false_;
+      case ValueKind::kInt:
+      case ValueKind::kUint:
+      case ValueKind::kDouble: {
+        Number number = *GetNumber(other);
+        if (number.LosslessConvertibleToInt()) {
+          return ints_.contains(number.AsInt());
+        }
+        if (number.LosslessConvertibleToUint()) {
+          return uints_.contains(number.AsUint());
+        }
+        return doubles_.contains(number.AsDouble());
+      }
+      case ValueKind::kString: {
+        const StringValue& string_value = Cast<StringValue>(other);
+        std::string scratch;
+        absl::string_view view;
+        if (auto flat = string_value.TryFlat(); flat.has_value()) {
+          view = *flat;
+        } else {
+          view = string_value.NativeString(scratch);
+        }
+        return strings_.contains(view);
+      }
+      default:
+        // Equality between the scalar element kinds and any other kind is
+        // always false.
+        return false;
+    }
+  }
+
+  absl::Status GetImpl(ValueManager&, size_t index,
+                       Value& result) const override {
+    result = elements_[index];
+    return absl::OkStatus();
+  }
+
+  NativeTypeId GetNativeTypeId() const noexcept override {
+    return NativeTypeId::For<ConstantListValue>();
+  }
+
+  const ListType type_;
+  const std::vector<Value> elements_;
+  absl::flat_hash_set<absl::string_view> strings_;
+  absl::flat_hash_set<int64_t> ints_;
+  absl::flat_hash_set<uint64_t> uints_;
+  absl::flat_hash_set<double> doubles_;
+  bool has_true_ = false;
+  bool has_false_ = false;
+};
+
+}  // namespace
+
+absl::optional<Value> TryMakeConstantList(ValueManager& value_manager,
+                                          const Value& value) {
+  if (!value.Is<ListValue>()) {
+    return absl::nullopt;
+  }
+  ListValue list_value = value.As<ListValue>();
+
+  std::vector<Value> elements;
+  bool eligible = true;
+  absl::Status status = list_value.ForEach(
+      value_manager, [&](const Value& element) -> absl::StatusOr<bool> {
+        switch (element.kind()) {
+          case ValueKind::kBool:
+          case ValueKind::kInt:
+          case ValueKind::kUint:
+          case ValueKind::kDouble:
+            break;
+          case ValueKind::kString:
+            // Fragmented cord elements are never produced by constant
+            // folding, so don't bother flattening them.
+            if (!Cast<StringValue>(element).TryFlat().has_value()) {
+              eligible = false;
+              return false;
+            }
+            break;
+          default:
+            eligible = false;
+            return false;
+        }
+        elements.push_back(element);
+        return true;
+      });
+  if (!status.ok() || !eligible || elements.empty()) {
+    return absl::nullopt;
+  }
+
+  ListType type = value_manager.CreateListType(DynType());
+  return Value(ParsedListValue(
+      value_manager.GetMemoryManager().MakeShared<ConstantListValue>(
+          std::move(type), std::move(elements))));
+}
+
+}  // namespace cel::runtime_internal
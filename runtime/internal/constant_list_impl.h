@@ -0,0 +1,43 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_CONSTANT_LIST_IMPL_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_CONSTANT_LIST_IMPL_H_
+
+#include "absl/types/optional.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+
+namespace cel::runtime_internal {
+
+// Attempts to rebuild a fully-constant list of scalar values as a list with
+// hash-indexed membership.
+//
+// The rebuilt list keeps the original elements and order, but additionally
+// carries hash sets over the element values so that `Contains` -- the `@in`
+// operator -- is a single lookup instead of a linear scan with elementwise
+// equality. Numeric elements are indexed in the shared numeric domain, so
+// heterogeneous equality semantics (`2.0 in [2]`) are preserved. Intended
+// for constant list literals folded at plan time (the allowlist idiom
+// `x in ["a", "b", ...]`), where the build cost is paid once per program.
+//
+// Returns nullopt when the input is not a non-empty list of exclusively
+// bool, numeric or flat string constants; callers keep the original value in
+// that case.
+absl::optional<Value> TryMakeConstantList(ValueManager& value_manager,
+                                          const Value& value);
+
+}  // namespace cel::runtime_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_CONSTANT_LIST_IMPL_H_
@@ -0,0 +1,168 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/constant_list_impl.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+#include "base/type_provider.h"
+#include "common/casting.h"
+#include "common/memory.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "common/values/legacy_value_manager.h"
+#include "internal/testing.h"
+
+namespace cel::runtime_internal {
+namespace {
+
+using cel::internal::IsOkAndHolds;
+
+absl::StatusOr<Value> MakeSourceList(ValueManager& value_factory,
+                                     std::vector<Value> elements) {
+  CEL_ASSIGN_OR_RETURN(auto builder,
+                       value_factory.NewListValueBuilder(
+                           value_factory.CreateListType(DynType())));
+  builder->Reserve(elements.size());
+  for (auto& element : elements) {
+    CEL_RETURN_IF_ERROR(builder->Add(std::move(element)));
+  }
+  return std::move(*builder).Build();
+}
+
+absl::StatusOr<bool> Contains(ValueManager& value_factory,
+                              const ListValue& list_value, Value probe) {
+  Value result;
+  CEL_RETURN_IF_ERROR(list_value.Contains(value_factory, probe, result));
+  if (!InstanceOf<BoolValue>(result)) {
+    return absl::InternalError("expected bool result");
+  }
+  return Cast<BoolValue>(result).NativeValue();
+}
+
+TEST(ConstantListImpl, ContainsScalars) {
+  common_internal::LegacyValueManager value_factory(
+      MemoryManagerRef::ReferenceCounting(), TypeProvider::Builtin());
+
+  ASSERT_OK_AND_ASSIGN(
+      Value source,
+      MakeSourceList(value_factory,
+                     {value_factory.CreateIntValue(1),
+                      value_factory.CreateUintValue(2),
+                      value_factory.CreateDoubleValue(3.5),
+                      value_factory.CreateUncheckedStringValue("a"),
+                      value_factory.CreateBoolValue(true)}));
+
+  auto constant_list = TryMakeConstantList(value_factory, source);
+  ASSERT_TRUE(constant_list.has_value());
+  ASSERT_TRUE((*constant_list).Is<ListValue>());
+  ListValue list_value = (*constant_list).As<ListValue>();
+
+  EXPECT_THAT(list_value.Size(), IsOkAndHolds(5));
+
+  EXPECT_THAT(Contains(value_factory, list_value,
+                       value_factory.CreateIntValue(1)),
+              IsOkAndHolds(true));
+  // Heterogeneous numeric equality applies across domains.
+  EXPECT_THAT(Contains(value_factory, list_value,
+                       value_factory.CreateDoubleValue(1.0)),
+              IsOkAndHolds(true));
+  EXPECT_THAT(Contains(value_factory, list_value,
+                       value_factory.CreateUintValue(1)),
+              IsOkAndHolds(true));
+  EXPECT_THAT(Contains(value_factory, list_value,
+                       value_factory.CreateIntValue(2)),
+              IsOkAndHolds(true));
+  EXPECT_THAT(Contains(value_factory, list_value,
+                       value_factory.CreateDoubleValue(3.5)),
+              IsOkAndHolds(true));
+  EXPECT_THAT(Contains(value_factory, list_value,
+                       value_factory.CreateIntValue(3)),
+              IsOkAndHolds(false));
+  EXPECT_THAT(Contains(value_factory, list_value,
+                       value_factory.CreateUncheckedStringValue("a")),
+              IsOkAndHolds(true));
+  EXPECT_THAT(Contains(value_factory, list_value,
+                       value_factory.CreateUncheckedStringValue("b")),
+              IsOkAndHolds(false));
+  EXPECT_THAT(Contains(value_factory, list_value,
+                       value_factory.CreateBoolValue(true)),
+              IsOkAndHolds(true));
+  EXPECT_THAT(Contains(value_factory, list_value,
+                       value_factory.CreateBoolValue(false)),
+              IsOkAndHolds(false));
+  EXPECT_THAT(Contains(value_factory, list_value, NullValue()),
+              IsOkAndHolds(false));
+}
+
+TEST(ConstantListImpl, PreservesElementsAndOrder) {
+  common_internal::LegacyValueManager value_factory(
+      MemoryManagerRef::ReferenceCounting(), TypeProvider::Builtin());
+
+  std::vector<Value> elements;
+  for (int64_t i = 0; i < 100; ++i) {
+    elements.push_back(value_factory.CreateIntValue(i));
+  }
+  ASSERT_OK_AND_ASSIGN(Value source,
+                       MakeSourceList(value_factory, std::move(elements)));
+
+  auto constant_list = TryMakeConstantList(value_factory, source);
+  ASSERT_TRUE(constant_list.has_value());
+  ListValue list_value = (*constant_list).As<ListValue>();
+
+  for (int64_t i = 0; i < 100; ++i) {
+    ASSERT_OK_AND_ASSIGN(Value element, list_value.Get(value_factory, i));
+    ASSERT_TRUE(InstanceOf<IntValue>(element));
+    EXPECT_EQ(Cast<IntValue>(element).NativeValue(), i);
+    EXPECT_THAT(Contains(value_factory, list_value,
+                         value_factory.CreateIntValue(i)),
+                IsOkAndHolds(true));
+  }
+  EXPECT_THAT(Contains(value_factory, list_value,
+                       value_factory.CreateIntValue(100)),
+              IsOkAndHolds(false));
+}
+
+TEST(ConstantListImpl, RejectsNonScalarElements) {
+  common_internal::LegacyValueManager value_factory(
+      MemoryManagerRef::ReferenceCounting(), TypeProvider::Builtin());
+
+  ASSERT_OK_AND_ASSIGN(Value nested,
+                       MakeSourceList(value_factory,
+                                      {value_factory.CreateIntValue(1)}));
+  ASSERT_OK_AND_ASSIGN(Value source,
+                       MakeSourceList(value_factory, {nested}));
+
+  EXPECT_EQ(TryMakeConstantList(value_factory, source), absl::nullopt);
+}
+
+TEST(ConstantListImpl, RejectsEmptyAndNonList) {
+  common_internal::LegacyValueManager value_factory(
+      MemoryManagerRef::ReferenceCounting(), TypeProvider::Builtin());
+
+  ASSERT_OK_AND_ASSIGN(Value empty, MakeSourceList(value_factory, {}));
+  EXPECT_EQ(TryMakeConstantList(value_factory, empty), absl::nullopt);
+  EXPECT_EQ(
+      TryMakeConstantList(value_factory, value_factory.CreateIntValue(1)),
+      absl::nullopt);
+}
+
+}  // namespace
+}  // namespace cel::runtime_internal
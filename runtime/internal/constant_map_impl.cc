@@ -0,0 +1,280 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/constant_map_impl.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/base/nullability.h"
+#include "absl/base/optimization.h"
+#include "absl/hash/hash.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "common/casting.h"
+#include "common/json.h"
+#include "common/native_type.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "internal/status_macros.h"
+
+namespace cel::runtime_internal {
+
+namespace {
+
+// Number of seeds tried before giving up on a collision-free assignment. With
+// a table twice the entry count, the expected number of attempts is small.
+constexpr uint64_t kMaxSeedAttempts = 64;
+
+// Sentinel for an unoccupied slot in the table.
+constexpr int32_t kEmptySlot = -1;
+
+size_t TableSlot(uint64_t seed, absl::string_view key, size_t mask) {
+  return absl::HashOf(seed, key) & mask;
+}
+
+class ConstantMapValueKeyIterator final : public ValueIterator {
+ public:
+  explicit ConstantMapValueKeyIterator(
+      const std::vector<std::pair<StringValue, Value>>& entries
+          ABSL_ATTRIBUTE_LIFETIME_BOUND)
+      : begin_(entries.begin()), end_(entries.end()) {}
+
+  bool HasNext() override { return begin_ != end_; }
+
+  absl::Status Next(ValueManager&, Value& result) override {
+    if (ABSL_PREDICT_FALSE(begin_ == end_)) {
+      return absl::FailedPreconditionError(
+          "ValueIterator::Next() called when "
+          "ValueIterator::HasNext() returns false");
+    }
+    result = Value(begin_->first);
+    ++begin_;
+    return absl::OkStatus();
+  }
+
+ private:
+  std::vector<std::pair<StringValue, Value>>::const_iterator begin_;
+  const std::vector<std::pair<StringValue, Value>>::const_iterator end_;
+};
+
+// Immutable string-keyed map backed by a collision-free seeded hash table.
+//
+// `slots_` has power-of-two size and maps a hashed key to at most one entry
+// index; the seed was chosen at build time so that no two keys share a slot,
+// making lookup a single hash, one slot load and one byte comparison.
+class ConstantMapValue final : public ParsedMapValueInterface {
+ public:
+  ConstantMapValue(MapType type,
+                   std::vector<std::pair<StringValue, Value>> entries,
+                   std::vector<int32_t> slots, uint64_t seed)
+      : type_(std::move(type)),
+        entries_(std::move(entries)),
+        slots_(std::move(slots)),
+        seed_(seed) {}
+
+  std::string DebugString() const override {
+    return absl::StrCat(
+        "{",
+        absl::StrJoin(entries_, ", ",
+                      absl::PairFormatter(absl::StreamFormatter(), ": ",
+                                          absl::StreamFormatter())),
+        "}");
+  }
+
+  bool IsEmpty() const override { return entries_.empty(); }
+
+  size_t Size() const override { return entries_.size(); }
+
+  absl::StatusOr<JsonObject> ConvertToJsonObject(
+      AnyToJsonConverter& value_manager) const override {
+    JsonObjectBuilder builder;
+    builder.reserve(Size());
+    for (const auto& entry : entries_) {
+      CEL_ASSIGN_OR_RETURN(auto json_value,
+                           entry.second.ConvertToJson(value_manager));
+      builder.insert(
+          std::pair{entry.first.NativeCord(), std::move(json_value)});
+    }
+    return std::move(builder).Build();
+  }
+
+  absl::Status ListKeys(ValueManager& value_manager,
+                        ListValue& result) const override {
+    CEL_ASSIGN_OR_RETURN(
+        auto keys, value_manager.NewListValueBuilder(
+                       value_manager.CreateListType(StringType())));
+    keys->Reserve(Size());
+    for (const auto& entry : entries_) {
+      CEL_RETURN_IF_ERROR(keys->Add(entry.first));
+    }
+    result = std::move(*keys).Build();
+    return absl::OkStatus();
+  }
+
+  absl::Status ForEach(ValueManager& value_manager,
+                       ForEachCallback callback) const override {
+    for (const auto& entry : entries_) {
+      CEL_ASSIGN_OR_RETURN(auto ok, callback(entry.first, entry.second));
+      if (!ok) {
+        break;
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<absl::Nonnull<ValueIteratorPtr>> NewIterator(
+      ValueManager&) const override {
+    return std::make_unique<ConstantMapValueKeyIterator>(entries_);
+  }
+
+ protected:
+  Type GetTypeImpl(TypeManager&) const override { return type_; }
+
+ private:
+  const std::pair<StringValue, Value>* Find(const Value& key) const {
+    if (!key.Is<StringValue>()) {
+      return nullptr;
+    }
+    const StringValue& string_key = Cast<StringValue>(key);
+    std::string scratch;
+    absl::string_view key_view;
+    if (auto flat = string_key.TryFlat(); flat.has_value()) {
+      key_view = *flat;
+    } else {
+      key_view = string_key.NativeString(scratch);
+    }
+    int32_t slot = slots_[TableSlot(seed_, key_view, slots_.size() - 1)];
+    if (slot == kEmptySlot) {
+      return nullptr;
+    }
+    const auto& entry = entries_[slot];
+    if (!entry.first.Equals(key_view)) {
+      return nullptr;
+    }
+    return &entry;
+  }
+
+  absl::StatusOr<bool> FindImpl(ValueManager&, const Value& key,
+                                Value& result) const override {
+    if (const auto* entry = Find(key); entry != nullptr) {
+      result = entry->second;
+      return true;
+    }
+    return false;
+  }
+
+  absl::StatusOr<bool> HasImpl(ValueManager&, const Value& key) const override {
+    return Find(key) != nullptr;
+  }
+
+  NativeTypeId GetNativeTypeId() const noexcept override {
+    return NativeTypeId::For<ConstantMapValue>();
+  }
+
+  const MapType type_;
+  const std::vector<std::pair<StringValue, Value>> entries_;
+  const std::vector<int32_t> slots_;
+  const uint64_t seed_;
+};
+
+size_t NextPowerOfTwo(size_t n) {
+  size_t result = 1;
+  while (result < n) {
+    result <<= 1;
+  }
+  return result;
+}
+
+}  // namespace
+
+absl::optional<Value> TryMakeConstantMap(ValueManager& value_manager,
+                                         const Value& value) {
+  if (!value.Is<MapValue>()) {
+    return absl::nullopt;
+  }
+  MapValue map_value = value.As<MapValue>();
+
+  std::vector<std::pair<StringValue, Value>> sorted_entries;
+  bool eligible = true;
+  absl::Status status = map_value.ForEach(
+      value_manager,
+      [&](const Value& key, const Value& entry) -> absl::StatusOr<bool> {
+        // Fragmented cord keys are never produced by constant folding, so
+        // don't bother flattening them.
+        if (!key.Is<StringValue>() ||
+            !Cast<StringValue>(key).TryFlat().has_value()) {
+          eligible = false;
+          return false;
+        }
+        sorted_entries.push_back(std::pair{Cast<StringValue>(key), entry});
+        return true;
+      });
+  if (!status.ok() || !eligible || sorted_entries.empty()) {
+    return absl::nullopt;
+  }
+
+  // Deterministic iteration order regardless of how the source map hashed.
+  std::stable_sort(sorted_entries.begin(), sorted_entries.end(),
+                   [](const std::pair<StringValue, Value>& lhs,
+                      const std::pair<StringValue, Value>& rhs) {
+                     return *lhs.first.TryFlat() < *rhs.first.TryFlat();
+                   });
+  // Views are taken only after the entries have reached their final storage:
+  // small cord-backed keys store their bytes inline and moving the entry
+  // would invalidate earlier views.
+  std::vector<absl::string_view> sorted_views;
+  sorted_views.reserve(sorted_entries.size());
+  for (const auto& entry : sorted_entries) {
+    sorted_views.push_back(*entry.first.TryFlat());
+  }
+
+  const size_t table_size = NextPowerOfTwo(2 * sorted_entries.size());
+  const size_t mask = table_size - 1;
+  std::vector<int32_t> slots;
+  for (uint64_t seed = 0; seed < kMaxSeedAttempts; ++seed) {
+    slots.assign(table_size, kEmptySlot);
+    bool collision = false;
+    for (size_t i = 0; i < sorted_views.size(); ++i) {
+      int32_t& slot = slots[TableSlot(seed, sorted_views[i], mask)];
+      if (slot != kEmptySlot) {
+        collision = true;
+        break;
+      }
+      slot = static_cast<int32_t>(i);
+    }
+    if (!collision) {
+      MapType type =
+          value_manager.CreateMapType(StringType(), DynType());
+      return Value(ParsedMapValue(
+          value_manager.GetMemoryManager().MakeShared<ConstantMapValue>(
+              std::move(type), std::move(sorted_entries), std::move(slots),
+              seed)));
+    }
+  }
+  return absl::nullopt;
+}
+
+}  // namespace cel::runtime_internal
@@ -0,0 +1,43 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_CONSTANT_MAP_IMPL_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_CONSTANT_MAP_IMPL_H_
+
+#include "absl/types/optional.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+
+namespace cel::runtime_internal {
+
+// Attempts to rebuild a fully-constant, string-keyed map value as an
+// immutable collision-free hash table.
+//
+// The table stores entries at slots chosen by a seeded hash picked at build
+// time so that every key maps to a distinct slot; lookups are then a single
+// hash, one slot probe, and one byte comparison, with no open-addressing
+// probe sequence and no per-evaluation allocation. Intended for constant map
+// literals folded at plan time (the switch-on-value idiom
+// `{"a": 1, "b": 2, ...}[key]`), where the build cost is paid once per
+// program.
+//
+// Returns nullopt when the input is not a non-empty map with exclusively
+// flat string keys, or when no collision-free seed is found within the
+// attempt budget; callers keep the original value in that case.
+absl::optional<Value> TryMakeConstantMap(ValueManager& value_manager,
+                                         const Value& value);
+
+}  // namespace cel::runtime_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_CONSTANT_MAP_IMPL_H_
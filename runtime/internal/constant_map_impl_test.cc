@@ -0,0 +1,132 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/constant_map_impl.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+#include "base/type_provider.h"
+#include "common/casting.h"
+#include "common/memory.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "common/values/legacy_value_manager.h"
+#include "internal/testing.h"
+
+namespace cel::runtime_internal {
+namespace {
+
+using cel::internal::IsOkAndHolds;
+
+absl::StatusOr<Value> MakeSourceMap(
+    ValueManager& value_factory,
+    const std::vector<std::pair<std::string, int64_t>>& entries) {
+  CEL_ASSIGN_OR_RETURN(auto builder, value_factory.NewMapValueBuilder(
+                                         value_factory.GetDynDynMapType()));
+  builder->Reserve(entries.size());
+  for (const auto& entry : entries) {
+    CEL_RETURN_IF_ERROR(
+        builder->Put(value_factory.CreateUncheckedStringValue(entry.first),
+                     value_factory.CreateIntValue(entry.second)));
+  }
+  return std::move(*builder).Build();
+}
+
+TEST(ConstantMapImpl, LookupHitAndMiss) {
+  common_internal::LegacyValueManager value_factory(
+      MemoryManagerRef::ReferenceCounting(), TypeProvider::Builtin());
+
+  ASSERT_OK_AND_ASSIGN(
+      Value source,
+      MakeSourceMap(value_factory, {{"a", 1}, {"b", 2}, {"c", 3}}));
+
+  auto constant_map = TryMakeConstantMap(value_factory, source);
+  ASSERT_TRUE(constant_map.has_value());
+  ASSERT_TRUE((*constant_map).Is<MapValue>());
+  MapValue map_value = (*constant_map).As<MapValue>();
+
+  EXPECT_THAT(map_value.Size(), IsOkAndHolds(3));
+
+  ASSERT_OK_AND_ASSIGN(
+      Value element,
+      map_value.Get(value_factory, value_factory.CreateUncheckedStringValue("b")));
+  ASSERT_TRUE(InstanceOf<IntValue>(element));
+  EXPECT_EQ(Cast<IntValue>(element).NativeValue(), 2);
+
+  ASSERT_OK_AND_ASSIGN(
+      Value missing,
+      map_value.Has(value_factory,
+                    value_factory.CreateUncheckedStringValue("missing")));
+  ASSERT_TRUE(InstanceOf<BoolValue>(missing));
+  EXPECT_FALSE(Cast<BoolValue>(missing).NativeValue());
+
+  ASSERT_OK_AND_ASSIGN(
+      Value non_string,
+      map_value.Has(value_factory, value_factory.CreateIntValue(1)));
+  ASSERT_TRUE(InstanceOf<BoolValue>(non_string));
+  EXPECT_FALSE(Cast<BoolValue>(non_string).NativeValue());
+}
+
+TEST(ConstantMapImpl, ManyKeysAllFound) {
+  common_internal::LegacyValueManager value_factory(
+      MemoryManagerRef::ReferenceCounting(), TypeProvider::Builtin());
+
+  std::vector<std::pair<std::string, int64_t>> entries;
+  for (int64_t i = 0; i < 100; ++i) {
+    entries.push_back({absl::StrCat("key_", i), i});
+  }
+  ASSERT_OK_AND_ASSIGN(Value source, MakeSourceMap(value_factory, entries));
+
+  auto constant_map = TryMakeConstantMap(value_factory, source);
+  ASSERT_TRUE(constant_map.has_value());
+  MapValue map_value = (*constant_map).As<MapValue>();
+
+  for (const auto& entry : entries) {
+    ASSERT_OK_AND_ASSIGN(
+        Value element,
+        map_value.Get(value_factory,
+                      value_factory.CreateUncheckedStringValue(entry.first)));
+    ASSERT_TRUE(InstanceOf<IntValue>(element));
+    EXPECT_EQ(Cast<IntValue>(element).NativeValue(), entry.second);
+  }
+}
+
+TEST(ConstantMapImpl, RejectsNonStringKeys) {
+  common_internal::LegacyValueManager value_factory(
+      MemoryManagerRef::ReferenceCounting(), TypeProvider::Builtin());
+
+  ASSERT_OK_AND_ASSIGN(auto builder, value_factory.NewMapValueBuilder(
+                                         value_factory.GetDynDynMapType()));
+  ASSERT_OK(builder->Put(value_factory.CreateIntValue(1),
+                         value_factory.CreateIntValue(2)));
+  Value source = std::move(*builder).Build();
+
+  EXPECT_EQ(TryMakeConstantMap(value_factory, source), absl::nullopt);
+}
+
+TEST(ConstantMapImpl, RejectsNonMaps) {
+  common_internal::LegacyValueManager value_factory(
+      MemoryManagerRef::ReferenceCounting(), TypeProvider::Builtin());
+
+  EXPECT_EQ(TryMakeConstantMap(value_factory, value_factory.CreateIntValue(1)),
+            absl::nullopt);
+}
+
+}  // namespace
+}  // namespace cel::runtime_internal
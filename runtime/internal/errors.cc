@@ -17,9 +17,19 @@
 #include "absl/strings/cord.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "base/builtins.h"
 
 namespace cel::runtime_internal {
 
+namespace {
+
+absl::Status MakeNoMatchingOverloadError(absl::string_view fn) {
+  return absl::UnknownError(
+      absl::StrCat(kErrNoMatchingOverload, fn.empty() ? "" : " : ", fn));
+}
+
+}  // namespace
+
 const absl::Status* DurationOverflowError() {
   static const auto* const kDurationOverflow = new absl::Status(
       absl::StatusCode::kInvalidArgument, "Duration is out of range");
@@ -31,14 +41,42 @@ absl::Status CreateNoSuchKeyError(absl::string_view key) {
 }
 
 absl::Status CreateNoMatchingOverloadError(absl::string_view fn) {
-  return absl::UnknownError(
-      absl::StrCat(kErrNoMatchingOverload, fn.empty() ? "" : " : ", fn));
+  // The operators the interpreter's own steps report are pooled: these errors
+  // are created on hot paths and frequently discarded again without ever
+  // being observed, e.g. by a short-circuiting logic step whose other branch
+  // succeeds. The message is formatted once, on first use, and later copies
+  // of the singleton only update a reference count.
+  if (fn.empty()) {
+    static const auto* const kError =
+        new absl::Status(MakeNoMatchingOverloadError(""));
+    return *kError;
+  }
+  if (fn == builtin::kOr) {
+    static const auto* const kError =
+        new absl::Status(MakeNoMatchingOverloadError(builtin::kOr));
+    return *kError;
+  }
+  if (fn == builtin::kAnd) {
+    static const auto* const kError =
+        new absl::Status(MakeNoMatchingOverloadError(builtin::kAnd));
+    return *kError;
+  }
+  if (fn == builtin::kTernary) {
+    static const auto* const kError =
+        new absl::Status(MakeNoMatchingOverloadError(builtin::kTernary));
+    return *kError;
+  }
+  return MakeNoMatchingOverloadError(fn);
 }
 
 absl::Status CreateNoSuchFieldError(absl::string_view field) {
-  return absl::Status(
-      absl::StatusCode::kNotFound,
-      absl::StrCat(kErrNoSuchField, field.empty() ? "" : " : ", field));
+  if (field.empty()) {
+    static const auto* const kError =
+        new absl::Status(absl::StatusCode::kNotFound, kErrNoSuchField);
+    return *kError;
+  }
+  return absl::Status(absl::StatusCode::kNotFound,
+                      absl::StrCat(kErrNoSuchField, " : ", field));
 }
 
 absl::Status CreateMissingAttributeError(
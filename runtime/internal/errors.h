@@ -41,6 +41,8 @@ constexpr absl::Duration kDurationLow = absl::Seconds(-315576000001);
 const absl::Status* DurationOverflowError();
 
 // At runtime, no matching overload could be found for a function invocation.
+// Errors for the operators the interpreter itself reports are pooled, so
+// copies of the returned status do not allocate.
 absl::Status CreateNoMatchingOverloadError(absl::string_view fn);
 
 // No such field for struct access.
@@ -15,6 +15,7 @@
 
 #include "runtime/internal/mutable_list_impl.h"
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <utility>
@@ -34,6 +35,10 @@ absl::Status MutableListValue::Append(cel::Value element) {
   return list_builder_->Add(std::move(element));
 }
 
+void MutableListValue::Reserve(size_t capacity) {
+  list_builder_->Reserve(capacity);
+}
+
 absl::StatusOr<cel::ListValue> MutableListValue::Build() && {
   return std::move(*list_builder_).Build();
 }
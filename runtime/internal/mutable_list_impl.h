@@ -17,6 +17,7 @@
 #ifndef THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_MUTABLE_LIST_IMPL_H_
 #define THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_MUTABLE_LIST_IMPL_H_
 
+#include <cstddef>
 #include <string>
 
 #include "absl/status/status.h"
@@ -69,6 +70,10 @@ class MutableListValue final : public cel::OpaqueValueInterface {
   // Caller must validate that mutating this object is safe.
   absl::Status Append(cel::Value element);
 
+  // Hint the expected number of elements.
+  // Caller must validate that mutating this object is safe.
+  void Reserve(size_t capacity);
+
   // Build a list value from this object.
   // The instance is no longer usable after the call to Build.
   // Caller must clean up any handles still referring to this object.
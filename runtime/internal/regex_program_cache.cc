@@ -0,0 +1,82 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/regex_program_cache.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "re2/re2.h"
+
+namespace cel::runtime_internal {
+
+RegexProgramCache& RegexProgramCache::Global() {
+  static RegexProgramCache* instance = new RegexProgramCache();
+  return *instance;
+}
+
+absl::StatusOr<std::shared_ptr<const RE2>> RegexProgramCache::GetOrCompile(
+    const std::string& pattern, int max_program_size) {
+  Key key(pattern, max_program_size);
+  {
+    absl::MutexLock lock(&mutex_);
+    auto existing = programs_.find(key);
+    if (existing != programs_.end()) {
+      if (auto program = existing->second.lock(); program) {
+        ++stats_.hits;
+        return program;
+      }
+      programs_.erase(existing);
+      ++stats_.evictions;
+    }
+  }
+
+  // Compile outside the lock; RE2 construction can be expensive and
+  // concurrent builders should not serialize on it. A race compiling the
+  // same pattern twice is resolved below by keeping the first insertion.
+  auto program = std::make_shared<RE2>(pattern);
+  if (max_program_size > 0 && program->ProgramSize() > max_program_size) {
+    return absl::InvalidArgumentError("exceeded RE2 max program size");
+  }
+  if (!program->ok()) {
+    return absl::InvalidArgumentError(
+        "invalid_argument unsupported RE2 pattern for matches");
+  }
+
+  absl::MutexLock lock(&mutex_);
+  auto [entry, inserted] = programs_.insert({std::move(key), program});
+  if (!inserted) {
+    if (auto winner = entry->second.lock(); winner) {
+      ++stats_.hits;
+      return winner;
+    }
+    entry->second = program;
+  }
+  ++stats_.misses;
+  stats_.size = static_cast<int64_t>(programs_.size());
+  return program;
+}
+
+RegexProgramCacheStats RegexProgramCache::GetStats() const {
+  absl::MutexLock lock(&mutex_);
+  RegexProgramCacheStats stats = stats_;
+  stats.size = static_cast<int64_t>(programs_.size());
+  return stats;
+}
+
+}  // namespace cel::runtime_internal
@@ -0,0 +1,87 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_REGEX_PROGRAM_CACHE_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_REGEX_PROGRAM_CACHE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "re2/re2.h"
+
+namespace cel::runtime_internal {
+
+// Counters describing the effectiveness of a `RegexProgramCache`.
+struct RegexProgramCacheStats {
+  // Lookups answered by an existing live program.
+  int64_t hits = 0;
+  // Lookups that compiled a new program.
+  int64_t misses = 0;
+  // Expired entries purged after all referencing programs were destroyed.
+  int64_t evictions = 0;
+  // Entries currently in the cache, including not-yet-purged expired ones.
+  int64_t size = 0;
+};
+
+// Process-wide interning cache for compiled RE2 programs.
+//
+// Identical `matches` patterns are common across large sets of planned
+// expressions and an RE2 program can be megabytes, so compiling one per call
+// site duplicates significant memory. Entries are keyed by
+// (pattern, max program size) and held weakly: the planned expressions using
+// a program keep it alive via std::shared_ptr, and once the last one is
+// destroyed the entry is purged on a later lookup rather than pinning the
+// program for the process lifetime.
+//
+// Thread-safe.
+class RegexProgramCache final {
+ public:
+  // Returns the process-wide instance shared by all expression builders.
+  static RegexProgramCache& Global();
+
+  RegexProgramCache() = default;
+
+  RegexProgramCache(const RegexProgramCache&) = delete;
+  RegexProgramCache(RegexProgramCache&&) = delete;
+  RegexProgramCache& operator=(const RegexProgramCache&) = delete;
+  RegexProgramCache& operator=(RegexProgramCache&&) = delete;
+
+  // Returns the interned program for `pattern`, compiling it on a miss.
+  //
+  // `max_program_size` disables the size check when <= 0, matching
+  // `RuntimeOptions::regex_max_program_size`. Compilation failures are not
+  // cached.
+  absl::StatusOr<std::shared_ptr<const RE2>> GetOrCompile(
+      const std::string& pattern, int max_program_size);
+
+  RegexProgramCacheStats GetStats() const;
+
+ private:
+  using Key = std::pair<std::string, int>;
+
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<Key, std::weak_ptr<const RE2>> programs_
+      ABSL_GUARDED_BY(mutex_);
+  RegexProgramCacheStats stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace cel::runtime_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_REGEX_PROGRAM_CACHE_H_
@@ -0,0 +1,98 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/regex_program_cache.h"
+
+#include <memory>
+
+#include "absl/status/status.h"
+#include "internal/testing.h"
+#include "re2/re2.h"
+
+namespace cel::runtime_internal {
+namespace {
+
+using cel::internal::StatusIs;
+
+TEST(RegexProgramCache, InternsIdenticalPatterns) {
+  RegexProgramCache cache;
+
+  ASSERT_OK_AND_ASSIGN(std::shared_ptr<const RE2> first,
+                       cache.GetOrCompile("[a-z]+", 0));
+  ASSERT_OK_AND_ASSIGN(std::shared_ptr<const RE2> second,
+                       cache.GetOrCompile("[a-z]+", 0));
+
+  EXPECT_EQ(first.get(), second.get());
+
+  RegexProgramCacheStats stats = cache.GetStats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.size, 1);
+}
+
+TEST(RegexProgramCache, KeyedByMaxProgramSize) {
+  RegexProgramCache cache;
+
+  ASSERT_OK_AND_ASSIGN(std::shared_ptr<const RE2> unlimited,
+                       cache.GetOrCompile("[a-z]+", 0));
+  ASSERT_OK_AND_ASSIGN(std::shared_ptr<const RE2> limited,
+                       cache.GetOrCompile("[a-z]+", 1000));
+
+  EXPECT_NE(unlimited.get(), limited.get());
+  EXPECT_EQ(cache.GetStats().size, 2);
+}
+
+TEST(RegexProgramCache, EvictsExpiredEntries) {
+  RegexProgramCache cache;
+
+  ASSERT_OK_AND_ASSIGN(std::shared_ptr<const RE2> program,
+                       cache.GetOrCompile("[a-z]+", 0));
+  const RE2* original = program.get();
+  program.reset();
+
+  // The entry expires when the last holder is destroyed and is purged on the
+  // next lookup, which recompiles.
+  ASSERT_OK_AND_ASSIGN(program, cache.GetOrCompile("[a-z]+", 0));
+  EXPECT_TRUE(program->ok());
+  static_cast<void>(original);
+
+  RegexProgramCacheStats stats = cache.GetStats();
+  EXPECT_EQ(stats.evictions, 1);
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.hits, 0);
+  EXPECT_EQ(stats.size, 1);
+}
+
+TEST(RegexProgramCache, InvalidPatternNotCached) {
+  RegexProgramCache cache;
+
+  EXPECT_THAT(cache.GetOrCompile("[a-z", 0).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(cache.GetStats().size, 0);
+}
+
+TEST(RegexProgramCache, OversizedProgramRejected) {
+  RegexProgramCache cache;
+
+  EXPECT_THAT(cache.GetOrCompile("[a-z]+", 1).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(cache.GetStats().size, 0);
+}
+
+TEST(RegexProgramCache, GlobalReturnsSameInstance) {
+  EXPECT_EQ(&RegexProgramCache::Global(), &RegexProgramCache::Global());
+}
+
+}  // namespace
+}  // namespace cel::runtime_internal
@@ -13,34 +13,69 @@
 // limitations under the License.
 #include "runtime/internal/runtime_impl.h"
 
+#include <cstddef>
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/base/nullability.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "base/ast.h"
 #include "base/type_provider.h"
 #include "common/native_type.h"
 #include "common/value.h"
 #include "eval/eval/attribute_trail.h"
+#include "eval/eval/compiler_constant_step.h"
 #include "eval/eval/comprehension_slots.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
+#include "eval/eval/evaluator_state_pool.h"
 #include "internal/casts.h"
 #include "internal/status_macros.h"
 #include "runtime/activation_interface.h"
 #include "runtime/runtime.h"
+#include "runtime/slot_activation.h"
 
 namespace cel::runtime_internal {
 namespace {
 
 using ::google::api::expr::runtime::AttributeTrail;
+using ::google::api::expr::runtime::CompilerConstantStep;
 using ::google::api::expr::runtime::ComprehensionSlots;
+using ::google::api::expr::runtime::DirectCompilerConstantStep;
 using ::google::api::expr::runtime::DirectExpressionStep;
 using ::google::api::expr::runtime::ExecutionFrameBase;
 using ::google::api::expr::runtime::FlatExpression;
+using ::google::api::expr::runtime::PooledEvaluatorState;
 using ::google::api::expr::runtime::WrappedDirectStep;
 
+// Touches every planned step object, faulting in plan memory before the first
+// evaluation. The virtual dispatch reads each step's vtable pointer and
+// object body; constants and precompiled regex programs are owned by their
+// steps, so this pulls them into cache as well.
+absl::Status WarmupPath(const FlatExpression& impl) {
+  for (const auto& step : impl.path()) {
+    step->GetNativeTypeId();
+  }
+  return absl::OkStatus();
+}
+
+// The variable binding plan assigns a slot to every identifier the planner
+// resolved against the activation, so its name list is exactly the set of
+// variables the program may read.
+absl::optional<std::vector<std::string>> ReferencedVariablesFromPlan(
+    const FlatExpression& impl) {
+  const auto& plan = impl.variable_binding_plan();
+  if (plan == nullptr) {
+    return absl::nullopt;
+  }
+  return std::vector<std::string>(plan->names().begin(), plan->names().end());
+}
+
 class ProgramImpl final : public TraceableProgram {
  public:
   using EvaluationListener = TraceableProgram::EvaluationListener;
@@ -57,8 +92,34 @@ class ProgramImpl final : public TraceableProgram {
   absl::StatusOr<Value> Trace(const ActivationInterface& activation,
                               EvaluationListener callback,
                               ValueManager& value_factory) const override {
-    auto state = impl_.MakeEvaluatorState(value_factory);
-    return impl_.EvaluateWithCallback(activation, std::move(callback), state);
+    PooledEvaluatorState state(impl_, value_factory);
+    return impl_.EvaluateWithCallback(activation, std::move(callback),
+                                      state.get());
+  }
+
+  absl::Status EvaluateBatch(
+      absl::Span<const ActivationInterface* const> activations,
+      absl::Span<Value> results, ValueManager& value_factory) const override {
+    if (results.size() < activations.size()) {
+      return absl::InvalidArgumentError(
+          "EvaluateBatch: fewer result slots than activations");
+    }
+    // One state checkout for the whole batch: the value stack and
+    // comprehension slots are reset, not reallocated, between rows.
+    PooledEvaluatorState state(impl_, value_factory);
+    for (size_t i = 0; i < activations.size(); ++i) {
+      CEL_ASSIGN_OR_RETURN(
+          results[i], impl_.EvaluateWithCallback(
+                          *activations[i], EvaluationListener(), state.get()));
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status Warmup() const override { return WarmupPath(impl_); }
+
+  absl::optional<std::vector<std::string>> ReferencedVariables()
+      const override {
+    return ReferencedVariablesFromPlan(impl_);
   }
 
   const TypeProvider& GetTypeProvider() const override {
@@ -98,6 +159,13 @@ class RecursiveProgramImpl final : public TraceableProgram {
     return result;
   }
 
+  absl::Status Warmup() const override { return WarmupPath(impl_); }
+
+  absl::optional<std::vector<std::string>> ReferencedVariables()
+      const override {
+    return ReferencedVariablesFromPlan(impl_);
+  }
+
   const TypeProvider& GetTypeProvider() const override {
     return environment_->type_registry.GetComposedTypeProvider();
   }
@@ -109,6 +177,93 @@ class RecursiveProgramImpl final : public TraceableProgram {
   absl::Nonnull<const DirectExpressionStep*> root_;
 };
 
+// Program for expressions that planning (typically constant folding) reduced
+// to a single constant step. Evaluation returns the folded value directly,
+// skipping evaluator state construction and the dispatch loop entirely.
+class ConstantProgramImpl final : public TraceableProgram {
+ public:
+  using EvaluationListener = TraceableProgram::EvaluationListener;
+  ConstantProgramImpl(
+      const std::shared_ptr<const RuntimeImpl::Environment>& environment,
+      FlatExpression impl, Value value)
+      : environment_(environment),
+        impl_(std::move(impl)),
+        value_(std::move(value)) {}
+
+  absl::StatusOr<Value> Evaluate(const ActivationInterface& activation,
+                                 ValueManager& value_factory) const override {
+    return value_;
+  }
+
+  absl::StatusOr<Value> Trace(const ActivationInterface& activation,
+                              EvaluationListener callback,
+                              ValueManager& value_factory) const override {
+    if (!callback) {
+      return value_;
+    }
+    // Listeners observe per-step evaluation, so tracing runs the full plan.
+    PooledEvaluatorState state(impl_, value_factory);
+    return impl_.EvaluateWithCallback(activation, std::move(callback),
+                                      state.get());
+  }
+
+  absl::Status EvaluateBatch(
+      absl::Span<const ActivationInterface* const> activations,
+      absl::Span<Value> results, ValueManager& value_factory) const override {
+    if (results.size() < activations.size()) {
+      return absl::InvalidArgumentError(
+          "EvaluateBatch: fewer result slots than activations");
+    }
+    for (size_t i = 0; i < activations.size(); ++i) {
+      results[i] = value_;
+    }
+    return absl::OkStatus();
+  }
+
+  absl::optional<std::vector<std::string>> ReferencedVariables()
+      const override {
+    // The folded constant depends on no activation state.
+    return std::vector<std::string>();
+  }
+
+  const TypeProvider& GetTypeProvider() const override {
+    return environment_->type_registry.GetComposedTypeProvider();
+  }
+
+ private:
+  // Keep the Runtime environment alive while programs reference it.
+  std::shared_ptr<const RuntimeImpl::Environment> environment_;
+  // Retained for tracing and to keep the plan (which may own memory the
+  // constant references) alive.
+  FlatExpression impl_;
+  Value value_;
+};
+
+// Returns the folded constant if the mainline plan is exactly one constant
+// step, from either the stack-machine or the recursive plan shape.
+absl::Nullable<const Value*> FoldedConstantRoot(
+    const FlatExpression& flat_expr) {
+  if (flat_expr.subexpressions().empty() ||
+      flat_expr.subexpressions().front().size() != 1) {
+    return nullptr;
+  }
+  const auto& step = flat_expr.subexpressions().front().front();
+  if (step->GetNativeTypeId() == NativeTypeId::For<CompilerConstantStep>()) {
+    return &internal::down_cast<const CompilerConstantStep*>(step.get())
+                ->value();
+  }
+  if (step->GetNativeTypeId() == NativeTypeId::For<WrappedDirectStep>()) {
+    const DirectExpressionStep* wrapped =
+        internal::down_cast<const WrappedDirectStep*>(step.get())->wrapped();
+    if (wrapped->GetNativeTypeId() ==
+        NativeTypeId::For<DirectCompilerConstantStep>()) {
+      return &internal::down_cast<const DirectCompilerConstantStep*>(wrapped)
+                  ->value();
+    }
+  }
+  return nullptr;
+}
+
 }  // namespace
 
 absl::StatusOr<std::unique_ptr<Program>> RuntimeImpl::CreateProgram(
@@ -124,6 +279,18 @@ RuntimeImpl::CreateTraceableProgram(
   CEL_ASSIGN_OR_RETURN(auto flat_expr, expr_builder_.CreateExpressionImpl(
                                            std::move(ast), options.issues));
 
+  // Special case if planning reduced the expression to a single constant.
+  //
+  // A notable fraction of submitted expressions are constant or fold to a
+  // constant; those evaluations then bypass evaluator state construction
+  // altogether.
+  if (const Value* constant = FoldedConstantRoot(flat_expr);
+      constant != nullptr) {
+    Value value = *constant;
+    return std::make_unique<ConstantProgramImpl>(
+        environment_, std::move(flat_expr), std::move(value));
+  }
+
   // Special case if the program is fully recursive.
   //
   // This implementation avoids unnecessary allocs at evaluation time which
@@ -149,4 +316,8 @@ bool TestOnly_IsRecursiveImpl(const Program* program) {
   return dynamic_cast<const RecursiveProgramImpl*>(program) != nullptr;
 }
 
+bool TestOnly_IsConstantImpl(const Program* program) {
+  return dynamic_cast<const ConstantProgramImpl*>(program) != nullptr;
+}
+
 }  // namespace cel::runtime_internal
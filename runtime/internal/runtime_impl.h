@@ -88,6 +88,11 @@ class RuntimeImpl : public Runtime {
 // Uses dynamic_casts to test.
 bool TestOnly_IsRecursiveImpl(const Program* program);
 
+// Exposed for testing to validate program was reduced to a constant.
+//
+// Uses dynamic_casts to test.
+bool TestOnly_IsConstantImpl(const Program* program);
+
 }  // namespace cel::runtime_internal
 
 #endif  // THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_RUNTIME_IMPL_H_
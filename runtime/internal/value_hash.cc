@@ -0,0 +1,69 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/value_hash.h"
+
+#include <cstddef>
+
+#include "absl/hash/hash.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+
+namespace cel::runtime_internal {
+
+absl::optional<size_t> HashPrimitiveValue(const Value& value) {
+  switch (value.kind()) {
+    case ValueKind::kNull:
+      return absl::HashOf(ValueKind::kNull);
+    case ValueKind::kBool:
+      return absl::HashOf(ValueKind::kBool,
+                          value.As<BoolValue>().NativeValue());
+    case ValueKind::kInt:
+      return absl::HashOf(ValueKind::kInt, value.As<IntValue>().NativeValue());
+    case ValueKind::kUint:
+      return absl::HashOf(ValueKind::kUint,
+                          value.As<UintValue>().NativeValue());
+    case ValueKind::kDouble:
+      return absl::HashOf(ValueKind::kDouble,
+                          value.As<DoubleValue>().NativeValue());
+    case ValueKind::kString:
+      return absl::HashOf(ValueKind::kString, value.As<StringValue>());
+    case ValueKind::kBytes:
+      return absl::HashOf(ValueKind::kBytes, value.As<BytesValue>().ToString());
+    case ValueKind::kDuration:
+      return absl::HashOf(ValueKind::kDuration,
+                          value.As<DurationValue>().NativeValue());
+    case ValueKind::kTimestamp:
+      return absl::HashOf(ValueKind::kTimestamp,
+                          value.As<TimestampValue>().NativeValue());
+    default:
+      return absl::nullopt;
+  }
+}
+
+absl::optional<size_t> HashPrimitiveValues(absl::Span<const Value> values) {
+  size_t combined = absl::HashOf(values.size());
+  for (const Value& value : values) {
+    absl::optional<size_t> value_hash = HashPrimitiveValue(value);
+    if (!value_hash.has_value()) {
+      return absl::nullopt;
+    }
+    combined = absl::HashOf(combined, *value_hash);
+  }
+  return combined;
+}
+
+}  // namespace cel::runtime_internal
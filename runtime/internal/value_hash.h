@@ -0,0 +1,39 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_VALUE_HASH_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_VALUE_HASH_H_
+
+#include <cstddef>
+
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "common/value.h"
+
+namespace cel::runtime_internal {
+
+// Hashes a single primitive value (bool, int, uint, double, string, bytes,
+// null, duration, timestamp), or returns nullopt for aggregate and opaque
+// kinds whose identity a hash cannot capture safely. Used for fingerprinting
+// inputs in memoization caches; callers must tolerate hash collisions or key
+// on the original values as well.
+absl::optional<size_t> HashPrimitiveValue(const Value& value);
+
+// Combined order-sensitive hash over a span of values. Returns nullopt if any
+// element is not a primitive value.
+absl::optional<size_t> HashPrimitiveValues(absl::Span<const Value> values);
+
+}  // namespace cel::runtime_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_VALUE_HASH_H_
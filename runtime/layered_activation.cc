@@ -0,0 +1,136 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/layered_activation.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "base/function.h"
+#include "base/function_descriptor.h"
+#include "common/value.h"
+#include "runtime/function_overload_reference.h"
+
+namespace cel {
+
+bool FrozenActivation::Builder::InsertOrAssignValue(absl::string_view name,
+                                                    Value value) {
+  return values_.insert_or_assign(name, std::move(value)).second;
+}
+
+bool FrozenActivation::Builder::InsertFunction(
+    const cel::FunctionDescriptor& descriptor,
+    std::unique_ptr<cel::Function> impl) {
+  auto& overloads = functions_[descriptor.name()];
+  for (auto& overload : overloads) {
+    if (overload.descriptor->ShapeMatches(descriptor)) {
+      return false;
+    }
+  }
+  overloads.push_back(
+      {std::make_unique<FunctionDescriptor>(descriptor), std::move(impl)});
+  return true;
+}
+
+FrozenActivation FrozenActivation::Builder::Build() && {
+  return FrozenActivation(std::move(*this));
+}
+
+FrozenActivation::FrozenActivation(Builder builder)
+    : values_(std::move(builder.values_)),
+      functions_(std::move(builder.functions_)),
+      unknown_patterns_(std::move(builder.unknown_patterns_)),
+      missing_patterns_(std::move(builder.missing_patterns_)) {}
+
+absl::StatusOr<bool> FrozenActivation::FindVariable(ValueManager& factory,
+                                                    absl::string_view name,
+                                                    Value& result) const {
+  auto iter = values_.find(name);
+  if (iter == values_.end()) {
+    return false;
+  }
+  result = iter->second;
+  return true;
+}
+
+std::vector<FunctionOverloadReference> FrozenActivation::FindFunctionOverloads(
+    absl::string_view name) const {
+  std::vector<FunctionOverloadReference> result;
+  auto iter = functions_.find(name);
+  if (iter != functions_.end()) {
+    const std::vector<FunctionEntry>& overloads = iter->second;
+    result.reserve(overloads.size());
+    for (const auto& overload : overloads) {
+      result.push_back({*overload.descriptor, *overload.implementation});
+    }
+  }
+  return result;
+}
+
+absl::StatusOr<bool> LayeredActivation::FindVariable(ValueManager& factory,
+                                                     absl::string_view name,
+                                                     Value& result) const {
+  for (const auto& entry : values_) {
+    if (entry.first == name) {
+      result = entry.second;
+      return true;
+    }
+  }
+  return base_->FindVariable(factory, name, result);
+}
+
+std::vector<FunctionOverloadReference> LayeredActivation::FindFunctionOverloads(
+    absl::string_view name) const {
+  std::vector<FunctionOverloadReference> result;
+  for (const auto& entry : functions_) {
+    if (entry.descriptor->name() == name) {
+      result.push_back({*entry.descriptor, *entry.implementation});
+    }
+  }
+  std::vector<FunctionOverloadReference> base_overloads =
+      base_->FindFunctionOverloads(name);
+  result.insert(result.end(), base_overloads.begin(), base_overloads.end());
+  return result;
+}
+
+bool LayeredActivation::InsertOrAssignValue(absl::string_view name,
+                                            Value value) {
+  for (auto& entry : values_) {
+    if (entry.first == name) {
+      entry.second = std::move(value);
+      return false;
+    }
+  }
+  values_.push_back({std::string(name), std::move(value)});
+  return true;
+}
+
+bool LayeredActivation::InsertFunction(
+    const cel::FunctionDescriptor& descriptor,
+    std::unique_ptr<cel::Function> impl) {
+  for (auto& entry : functions_) {
+    if (entry.descriptor->name() == descriptor.name() &&
+        entry.descriptor->ShapeMatches(descriptor)) {
+      return false;
+    }
+  }
+  functions_.push_back(
+      {std::make_unique<FunctionDescriptor>(descriptor), std::move(impl)});
+  return true;
+}
+
+}  // namespace cel
@@ -0,0 +1,188 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_LAYERED_ACTIVATION_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_LAYERED_ACTIVATION_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "base/attribute.h"
+#include "base/function.h"
+#include "base/function_descriptor.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "runtime/activation_interface.h"
+#include "runtime/function_overload_reference.h"
+
+namespace cel {
+
+// Immutable, thread-safe snapshot of a set of variable and function bindings.
+//
+// Unlike Activation, a FrozenActivation supports no value providers, so
+// lookups never synchronize and a single instance may back concurrent
+// evaluations. Intended for bindings shared by every request against a
+// Runtime (configuration, environment constants, context functions); pair
+// with LayeredActivation for the per-request tier.
+class FrozenActivation final : public ActivationInterface {
+ public:
+  struct FunctionEntry {
+    std::unique_ptr<cel::FunctionDescriptor> descriptor;
+    std::unique_ptr<cel::Function> implementation;
+  };
+
+  // Accumulates bindings, then relinquishes them to an immutable snapshot.
+  // Values that would otherwise be lazily provided must be materialized by
+  // the caller before insertion; that up-front cost is what makes the
+  // snapshot lock-free afterwards.
+  class Builder {
+   public:
+    Builder() = default;
+
+    // Move only.
+    Builder(const Builder&) = delete;
+    Builder& operator=(const Builder&) = delete;
+    Builder(Builder&&) = default;
+    Builder& operator=(Builder&&) = default;
+
+    // Bind a value to a named variable.
+    //
+    // Returns false if the entry for name was overwritten.
+    bool InsertOrAssignValue(absl::string_view name, Value value);
+
+    // Returns true if the function was inserted (no other function in the
+    // builder has a matching descriptor).
+    bool InsertFunction(const cel::FunctionDescriptor& descriptor,
+                        std::unique_ptr<cel::Function> impl);
+
+    void SetUnknownPatterns(std::vector<cel::AttributePattern> patterns) {
+      unknown_patterns_ = std::move(patterns);
+    }
+
+    void SetMissingPatterns(std::vector<cel::AttributePattern> patterns) {
+      missing_patterns_ = std::move(patterns);
+    }
+
+    FrozenActivation Build() &&;
+
+   private:
+    friend class FrozenActivation;
+
+    absl::flat_hash_map<std::string, Value> values_;
+    absl::flat_hash_map<std::string,
+                        std::vector<FrozenActivation::FunctionEntry>>
+        functions_;
+    std::vector<cel::AttributePattern> unknown_patterns_;
+    std::vector<cel::AttributePattern> missing_patterns_;
+  };
+
+  // Move only.
+  FrozenActivation(FrozenActivation&&) = default;
+  FrozenActivation& operator=(FrozenActivation&&) = default;
+
+  // Implements ActivationInterface.
+  absl::StatusOr<bool> FindVariable(ValueManager& factory,
+                                    absl::string_view name,
+                                    Value& result) const override;
+  using ActivationInterface::FindVariable;
+
+  std::vector<FunctionOverloadReference> FindFunctionOverloads(
+      absl::string_view name) const override;
+
+  absl::Span<const cel::AttributePattern> GetUnknownAttributes()
+      const override {
+    return unknown_patterns_;
+  }
+
+  absl::Span<const cel::AttributePattern> GetMissingAttributes()
+      const override {
+    return missing_patterns_;
+  }
+
+ private:
+  explicit FrozenActivation(Builder builder);
+
+  absl::flat_hash_map<std::string, Value> values_;
+  absl::flat_hash_map<std::string, std::vector<FunctionEntry>> functions_;
+  std::vector<cel::AttributePattern> unknown_patterns_;
+  std::vector<cel::AttributePattern> missing_patterns_;
+};
+
+// Thread-compatible per-request overlay over a shared base activation.
+//
+// The overlay stores its few bindings inline and resolves lookups with a
+// linear scan before delegating to the base, so binding a handful of
+// request-scoped variables or functions costs no locks and (for small
+// overlays) no heap allocations. The base — typically a FrozenActivation
+// shared across threads — is consulted for everything else, including
+// unknown and missing attribute patterns.
+//
+// The base must outlive the overlay and any evaluation using it.
+class LayeredActivation final : public ActivationInterface {
+ public:
+  explicit LayeredActivation(
+      const ActivationInterface& base ABSL_ATTRIBUTE_LIFETIME_BOUND)
+      : base_(&base) {}
+
+  // Move only.
+  LayeredActivation(LayeredActivation&&) = default;
+  LayeredActivation& operator=(LayeredActivation&&) = default;
+
+  // Implements ActivationInterface.
+  absl::StatusOr<bool> FindVariable(ValueManager& factory,
+                                    absl::string_view name,
+                                    Value& result) const override;
+  using ActivationInterface::FindVariable;
+
+  std::vector<FunctionOverloadReference> FindFunctionOverloads(
+      absl::string_view name) const override;
+
+  absl::Span<const cel::AttributePattern> GetUnknownAttributes()
+      const override {
+    return base_->GetUnknownAttributes();
+  }
+
+  absl::Span<const cel::AttributePattern> GetMissingAttributes()
+      const override {
+    return base_->GetMissingAttributes();
+  }
+
+  // Bind a value to a named variable, shadowing any base binding.
+  //
+  // Returns false if an overlay entry for name was overwritten.
+  bool InsertOrAssignValue(absl::string_view name, Value value);
+
+  // Returns true if the function was inserted (no other overlay function has
+  // a matching descriptor). Overlay overloads are offered before base
+  // overloads during resolution.
+  bool InsertFunction(const cel::FunctionDescriptor& descriptor,
+                      std::unique_ptr<cel::Function> impl);
+
+ private:
+  const ActivationInterface* base_;
+  absl::InlinedVector<std::pair<std::string, Value>, 8> values_;
+  absl::InlinedVector<FrozenActivation::FunctionEntry, 2> functions_;
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_LAYERED_ACTIVATION_H_
@@ -0,0 +1,153 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/layered_activation.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "base/attribute.h"
+#include "base/function.h"
+#include "base/function_descriptor.h"
+#include "base/type_provider.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "common/values/legacy_value_manager.h"
+#include "internal/testing.h"
+
+namespace cel {
+namespace {
+
+using testing::Eq;
+using testing::IsEmpty;
+using testing::SizeIs;
+using testing::Truly;
+using cel::internal::IsOkAndHolds;
+
+MATCHER_P(IsIntValue, x, absl::StrCat("is IntValue Handle with value ", x)) {
+  const Value& handle = arg;
+
+  return handle->Is<IntValue>() && handle.As<IntValue>().NativeValue() == x;
+}
+
+class FunctionImpl : public cel::Function {
+ public:
+  FunctionImpl() = default;
+
+  absl::StatusOr<Value> Invoke(const FunctionEvaluationContext& ctx,
+                               absl::Span<const Value> args) const override {
+    return NullValue();
+  }
+};
+
+class LayeredActivationTest : public testing::Test {
+ public:
+  LayeredActivationTest()
+      : value_factory_(MemoryManagerRef::ReferenceCounting(),
+                       TypeProvider::Builtin()) {}
+
+ protected:
+  common_internal::LegacyValueManager value_factory_;
+};
+
+TEST_F(LayeredActivationTest, FrozenValueLookup) {
+  FrozenActivation::Builder builder;
+  EXPECT_TRUE(builder.InsertOrAssignValue("var1",
+                                          value_factory_.CreateIntValue(42)));
+  EXPECT_FALSE(builder.InsertOrAssignValue("var1",
+                                           value_factory_.CreateIntValue(43)));
+  FrozenActivation base = std::move(builder).Build();
+
+  EXPECT_THAT(base.FindVariable(value_factory_, "var1"),
+              IsOkAndHolds(testing::Optional(IsIntValue(43))));
+  EXPECT_THAT(base.FindVariable(value_factory_, "var2"),
+              IsOkAndHolds(Eq(absl::nullopt)));
+}
+
+TEST_F(LayeredActivationTest, FrozenFunctionLookup) {
+  FrozenActivation::Builder builder;
+  EXPECT_TRUE(builder.InsertFunction(
+      FunctionDescriptor("Fn", false, {Kind::kUint}),
+      std::make_unique<FunctionImpl>()));
+  EXPECT_FALSE(builder.InsertFunction(
+      FunctionDescriptor("Fn", false, {Kind::kUint}),
+      std::make_unique<FunctionImpl>()));
+  FrozenActivation base = std::move(builder).Build();
+
+  EXPECT_THAT(base.FindFunctionOverloads("Fn"), SizeIs(1));
+  EXPECT_THAT(base.FindFunctionOverloads("Fn2"), IsEmpty());
+}
+
+TEST_F(LayeredActivationTest, OverlayShadowsBase) {
+  FrozenActivation::Builder builder;
+  builder.InsertOrAssignValue("var1", value_factory_.CreateIntValue(1));
+  builder.InsertOrAssignValue("var2", value_factory_.CreateIntValue(2));
+  FrozenActivation base = std::move(builder).Build();
+
+  LayeredActivation overlay(base);
+  EXPECT_TRUE(
+      overlay.InsertOrAssignValue("var1", value_factory_.CreateIntValue(10)));
+  EXPECT_FALSE(
+      overlay.InsertOrAssignValue("var1", value_factory_.CreateIntValue(11)));
+
+  EXPECT_THAT(overlay.FindVariable(value_factory_, "var1"),
+              IsOkAndHolds(testing::Optional(IsIntValue(11))));
+  EXPECT_THAT(overlay.FindVariable(value_factory_, "var2"),
+              IsOkAndHolds(testing::Optional(IsIntValue(2))));
+  EXPECT_THAT(overlay.FindVariable(value_factory_, "var3"),
+              IsOkAndHolds(Eq(absl::nullopt)));
+}
+
+TEST_F(LayeredActivationTest, OverlayFunctionsPrecedeBase) {
+  FrozenActivation::Builder builder;
+  builder.InsertFunction(FunctionDescriptor("Fn", false, {Kind::kUint}),
+                         std::make_unique<FunctionImpl>());
+  FrozenActivation base = std::move(builder).Build();
+
+  LayeredActivation overlay(base);
+  EXPECT_TRUE(
+      overlay.InsertFunction(FunctionDescriptor("Fn", false, {Kind::kInt}),
+                             std::make_unique<FunctionImpl>()));
+  EXPECT_FALSE(
+      overlay.InsertFunction(FunctionDescriptor("Fn", false, {Kind::kInt}),
+                             std::make_unique<FunctionImpl>()));
+
+  auto overloads = overlay.FindFunctionOverloads("Fn");
+  ASSERT_THAT(overloads, SizeIs(2));
+  EXPECT_THAT(overloads[0].descriptor.types(),
+              testing::ElementsAre(Kind::kInt));
+}
+
+TEST_F(LayeredActivationTest, AttributePatternsDelegateToBase) {
+  FrozenActivation::Builder builder;
+  builder.SetUnknownPatterns(
+      {AttributePattern("var1", {AttributeQualifierPattern::OfString("field1")}),
+       AttributePattern("var1",
+                        {AttributeQualifierPattern::OfString("field2")})});
+  builder.SetMissingPatterns(
+      {AttributePattern("var1",
+                        {AttributeQualifierPattern::OfString("field3")})});
+  FrozenActivation base = std::move(builder).Build();
+  LayeredActivation overlay(base);
+
+  EXPECT_THAT(overlay.GetUnknownAttributes(), SizeIs(2));
+  EXPECT_THAT(overlay.GetMissingAttributes(), SizeIs(1));
+}
+
+}  // namespace
+}  // namespace cel
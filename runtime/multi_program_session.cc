@@ -0,0 +1,176 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/multi_program_session.h"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "base/ast.h"
+#include "base/ast_internal/ast_impl.h"
+#include "base/ast_internal/expr.h"
+#include "base/attribute.h"
+#include "base/attribute_pattern_index.h"
+#include "base/kind.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "eval/compiler/subexpression_elimination.h"
+#include "internal/status_macros.h"
+#include "runtime/activation_interface.h"
+#include "runtime/function_overload_reference.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+
+using ::cel::ast_internal::AstImpl;
+using ::cel::ast_internal::SourceInfo;
+using ::google::api::expr::runtime::CrossProgramSubexpression;
+using ::google::api::expr::runtime::ExtractCrossProgramSubexpressions;
+
+// Wraps the caller's activation for the duration of one EvaluateAll call.
+// Session aliases resolve by evaluating their subprogram on first use and
+// memoizing the result; everything else forwards to the wrapped activation.
+// Subprograms evaluate against this activation too, so a hoisted chain may
+// reference the aliases of smaller chains hoisted before it.
+class MultiProgramSession::SessionActivation final
+    : public ActivationInterface {
+ public:
+  SessionActivation(const MultiProgramSession& session,
+                    const ActivationInterface& base,
+                    std::vector<absl::optional<Value>>& memo)
+      : session_(session), base_(base), memo_(memo) {}
+
+  absl::StatusOr<bool> FindVariable(ValueManager& factory,
+                                    absl::string_view name,
+                                    Value& result) const override {
+    auto it = session_.alias_index_.find(name);
+    if (it == session_.alias_index_.end()) {
+      return base_.FindVariable(factory, name, result);
+    }
+    absl::optional<Value>& memoized = memo_[it->second];
+    if (!memoized.has_value()) {
+      CEL_ASSIGN_OR_RETURN(
+          Value value,
+          session_.shared_[it->second].program->Evaluate(*this, factory));
+      memoized = std::move(value);
+    }
+    result = *memoized;
+    return true;
+  }
+
+  std::vector<FunctionOverloadReference> FindFunctionOverloads(
+      absl::string_view name) const override {
+    return base_.FindFunctionOverloads(name);
+  }
+
+  absl::StatusOr<absl::optional<FunctionOverloadReference>>
+  FindFunctionOverload(absl::string_view name, bool receiver_style,
+                       absl::Span<const Kind> types) const override {
+    return base_.FindFunctionOverload(name, receiver_style, types);
+  }
+
+  absl::Span<const AttributePattern> GetUnknownAttributes() const override {
+    return base_.GetUnknownAttributes();
+  }
+
+  absl::Span<const AttributePattern> GetMissingAttributes() const override {
+    return base_.GetMissingAttributes();
+  }
+
+  absl::Nullable<const AttributePatternIndex*> GetUnknownAttributesIndex()
+      const override {
+    return base_.GetUnknownAttributesIndex();
+  }
+
+  absl::Nullable<const AttributePatternIndex*> GetMissingAttributesIndex()
+      const override {
+    return base_.GetMissingAttributesIndex();
+  }
+
+  // Deliberately not forwarded: the session's programs were not planned
+  // against the wrapped activation's binding plan, and alias lookups must go
+  // through FindVariable.
+
+ private:
+  const MultiProgramSession& session_;
+  const ActivationInterface& base_;
+  std::vector<absl::optional<Value>>& memo_;
+};
+
+absl::StatusOr<std::unique_ptr<MultiProgramSession>> MultiProgramSession::
+    Create(const Runtime& runtime, std::vector<std::unique_ptr<Ast>> asts) {
+  std::vector<AstImpl*> ast_impls;
+  ast_impls.reserve(asts.size());
+  for (const std::unique_ptr<Ast>& ast : asts) {
+    ast_impls.push_back(&AstImpl::CastFromPublicAst(*ast));
+  }
+
+  CEL_ASSIGN_OR_RETURN(
+      std::vector<CrossProgramSubexpression> shared_subexpressions,
+      ExtractCrossProgramSubexpressions(absl::MakeConstSpan(ast_impls)));
+
+  std::vector<SharedSubprogram> shared;
+  shared.reserve(shared_subexpressions.size());
+  for (CrossProgramSubexpression& subexpression : shared_subexpressions) {
+    CEL_ASSIGN_OR_RETURN(
+        std::unique_ptr<Program> program,
+        runtime.CreateProgram(std::make_unique<AstImpl>(
+            std::move(subexpression.init), SourceInfo())));
+    shared.push_back(SharedSubprogram{std::move(subexpression.alias),
+                                      std::move(program)});
+  }
+
+  std::vector<std::unique_ptr<Program>> programs;
+  programs.reserve(asts.size());
+  for (std::unique_ptr<Ast>& ast : asts) {
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<Program> program,
+                         runtime.CreateProgram(std::move(ast)));
+    programs.push_back(std::move(program));
+  }
+
+  return std::unique_ptr<MultiProgramSession>(
+      new MultiProgramSession(std::move(programs), std::move(shared)));
+}
+
+absl::StatusOr<std::vector<Value>> MultiProgramSession::EvaluateAll(
+    const ActivationInterface& activation, ValueManager& value_factory) const {
+  std::vector<Value> results;
+  results.reserve(programs_.size());
+
+  if (shared_.empty()) {
+    for (const std::unique_ptr<Program>& program : programs_) {
+      CEL_ASSIGN_OR_RETURN(results.emplace_back(),
+                           program->Evaluate(activation, value_factory));
+    }
+    return results;
+  }
+
+  std::vector<absl::optional<Value>> memo(shared_.size());
+  SessionActivation session_activation(*this, activation, memo);
+  for (const std::unique_ptr<Program>& program : programs_) {
+    CEL_ASSIGN_OR_RETURN(
+        results.emplace_back(),
+        program->Evaluate(session_activation, value_factory));
+  }
+  return results;
+}
+
+}  // namespace cel
@@ -0,0 +1,103 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_MULTI_PROGRAM_SESSION_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_MULTI_PROGRAM_SESSION_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "base/ast.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "runtime/activation_interface.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+
+// A group of programs compiled together so that attribute-style
+// subexpressions shared between them are evaluated once per request.
+//
+// At build time, attribute chains (field selections and index operations,
+// e.g. `request.auth.claims["groups"]`) occurring in two or more of the
+// registered expressions are hoisted into hidden session variables and each
+// occurrence is rewritten into a reference to its variable, using the same
+// analysis as EnableSubexpressionElimination. At evaluation time,
+// EvaluateAll runs every program in registration order against one
+// activation; a session variable is computed lazily by a small dedicated
+// program on its first use by any program and memoized for the rest of the
+// group, so a chain of related policies costs little more than their union.
+//
+// Chains repeated within a single program are not hoisted here; enable the
+// per-program subexpression elimination on the runtime for those.
+//
+// The session is immutable after creation and safe for concurrent
+// EvaluateAll calls; the memo table lives on the EvaluateAll stack. Memoized
+// values are allocated through the ValueManager passed to EvaluateAll and are
+// released when the call returns.
+class MultiProgramSession final {
+ public:
+  // Rewrites and compiles `asts` (in the given order) against `runtime`.
+  // `runtime` must outlive the session, as must anything the runtime itself
+  // requires to outlive its programs.
+  static absl::StatusOr<std::unique_ptr<MultiProgramSession>> Create(
+      const Runtime& runtime, std::vector<std::unique_ptr<Ast>> asts);
+
+  // Evaluates every registered program against `activation`, returning their
+  // results in registration order. Shared subexpressions are evaluated at
+  // most once per call. A non-OK status from any program aborts the
+  // remainder of the chain.
+  absl::StatusOr<std::vector<Value>> EvaluateAll(
+      const ActivationInterface& activation, ValueManager& value_factory) const;
+
+  size_t program_count() const { return programs_.size(); }
+
+  // The compiled program for the index-th registered expression.
+  const Program& program(size_t index) const { return *programs_[index]; }
+
+  // Number of distinct subexpressions hoisted out of the registered
+  // programs.
+  size_t shared_subexpression_count() const { return shared_.size(); }
+
+ private:
+  class SessionActivation;
+
+  struct SharedSubprogram {
+    std::string alias;
+    std::unique_ptr<Program> program;
+  };
+
+  MultiProgramSession(std::vector<std::unique_ptr<Program>> programs,
+                      std::vector<SharedSubprogram> shared)
+      : programs_(std::move(programs)), shared_(std::move(shared)) {
+    for (size_t i = 0; i < shared_.size(); ++i) {
+      alias_index_[shared_[i].alias] = i;
+    }
+  }
+
+  std::vector<std::unique_ptr<Program>> programs_;
+  // In dependency order: a shared subprogram may reference the aliases of
+  // earlier entries only.
+  std::vector<SharedSubprogram> shared_;
+  absl::flat_hash_map<std::string, size_t> alias_index_;
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_MULTI_PROGRAM_SESSION_H_
@@ -0,0 +1,226 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/multi_program_session.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "base/attribute.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "extensions/protobuf/ast_converters.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/activation_interface.h"
+#include "runtime/function_overload_reference.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+
+namespace cel {
+namespace {
+
+using ::google::api::expr::v1alpha1::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+
+// Counts variable lookups by name while forwarding to a wrapped activation,
+// to observe how often a shared chain's root is actually resolved.
+class CountingActivation final : public ActivationInterface {
+ public:
+  explicit CountingActivation(const ActivationInterface& base) : base_(base) {}
+
+  absl::StatusOr<bool> FindVariable(ValueManager& factory,
+                                    absl::string_view name,
+                                    Value& result) const override {
+    ++lookups_[std::string(name)];
+    return base_.FindVariable(factory, name, result);
+  }
+
+  std::vector<FunctionOverloadReference> FindFunctionOverloads(
+      absl::string_view name) const override {
+    return base_.FindFunctionOverloads(name);
+  }
+
+  absl::Span<const AttributePattern> GetUnknownAttributes() const override {
+    return base_.GetUnknownAttributes();
+  }
+
+  absl::Span<const AttributePattern> GetMissingAttributes() const override {
+    return base_.GetMissingAttributes();
+  }
+
+  int lookups(absl::string_view name) const {
+    auto it = lookups_.find(name);
+    return it == lookups_.end() ? 0 : it->second;
+  }
+
+ private:
+  const ActivationInterface& base_;
+  mutable absl::flat_hash_map<std::string, int> lookups_;
+};
+
+class MultiProgramSessionTest : public testing::Test {
+ protected:
+  absl::StatusOr<std::unique_ptr<MultiProgramSession>> CreateSession(
+      std::vector<absl::string_view> expressions) {
+    RuntimeOptions options;
+    CEL_ASSIGN_OR_RETURN(RuntimeBuilder builder,
+                         CreateStandardRuntimeBuilder(options));
+    CEL_ASSIGN_OR_RETURN(runtime_, std::move(builder).Build());
+
+    std::vector<std::unique_ptr<Ast>> asts;
+    for (absl::string_view expression : expressions) {
+      CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+      CEL_ASSIGN_OR_RETURN(asts.emplace_back(),
+                           extensions::CreateAstFromParsedExpr(parsed_expr));
+    }
+    return MultiProgramSession::Create(*runtime_, std::move(asts));
+  }
+
+  // Binds m = {"a": 21, "b": 10}.
+  absl::Status BindMap(ValueManager& value_factory, Activation& activation) {
+    CEL_ASSIGN_OR_RETURN(
+        auto builder,
+        value_factory.NewMapValueBuilder(value_factory.GetDynDynMapType()));
+    CEL_RETURN_IF_ERROR(
+        builder->Put(value_factory.CreateUncheckedStringValue("a"),
+                     value_factory.CreateIntValue(21)));
+    CEL_RETURN_IF_ERROR(
+        builder->Put(value_factory.CreateUncheckedStringValue("b"),
+                     value_factory.CreateIntValue(10)));
+    activation.InsertOrAssignValue("m", std::move(*builder).Build());
+    return absl::OkStatus();
+  }
+
+  std::unique_ptr<const Runtime> runtime_;
+};
+
+TEST_F(MultiProgramSessionTest, SharesChainAcrossPrograms) {
+  ASSERT_OK_AND_ASSIGN(
+      auto session, CreateSession({R"cel(m["a"] + 1)cel",
+                                   R"cel(m["a"] + 2)cel"}));
+  EXPECT_EQ(session->shared_subexpression_count(), 1);
+
+  ManagedValueFactory value_factory(session->program(0).GetTypeProvider(),
+                                    MemoryManagerRef::ReferenceCounting());
+  Activation activation;
+  ASSERT_OK(BindMap(value_factory.get(), activation));
+  CountingActivation counting_activation(activation);
+
+  ASSERT_OK_AND_ASSIGN(
+      std::vector<Value> results,
+      session->EvaluateAll(counting_activation, value_factory.get()));
+  ASSERT_EQ(results.size(), 2);
+  ASSERT_TRUE(results[0]->Is<IntValue>());
+  EXPECT_EQ(results[0]->As<IntValue>().NativeValue(), 22);
+  ASSERT_TRUE(results[1]->Is<IntValue>());
+  EXPECT_EQ(results[1]->As<IntValue>().NativeValue(), 23);
+
+  // The hoisted chain resolved its root once, for the whole session.
+  EXPECT_EQ(counting_activation.lookups("m"), 1);
+}
+
+TEST_F(MultiProgramSessionTest, NoSharedChains) {
+  ASSERT_OK_AND_ASSIGN(auto session,
+                       CreateSession({R"cel(x + 1)cel", R"cel(x * 2)cel"}));
+  // Bare identifiers are not hoisted.
+  EXPECT_EQ(session->shared_subexpression_count(), 0);
+
+  ManagedValueFactory value_factory(session->program(0).GetTypeProvider(),
+                                    MemoryManagerRef::ReferenceCounting());
+  Activation activation;
+  activation.InsertOrAssignValue("x", value_factory.get().CreateIntValue(5));
+
+  ASSERT_OK_AND_ASSIGN(std::vector<Value> results,
+                       session->EvaluateAll(activation, value_factory.get()));
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_EQ(results[0]->As<IntValue>().NativeValue(), 6);
+  EXPECT_EQ(results[1]->As<IntValue>().NativeValue(), 10);
+}
+
+TEST_F(MultiProgramSessionTest, IntraProgramRepeatsAreNotHoisted) {
+  ASSERT_OK_AND_ASSIGN(auto session,
+                       CreateSession({R"cel(m["a"] + m["a"])cel"}));
+  EXPECT_EQ(session->shared_subexpression_count(), 0);
+
+  ManagedValueFactory value_factory(session->program(0).GetTypeProvider(),
+                                    MemoryManagerRef::ReferenceCounting());
+  Activation activation;
+  ASSERT_OK(BindMap(value_factory.get(), activation));
+
+  ASSERT_OK_AND_ASSIGN(std::vector<Value> results,
+                       session->EvaluateAll(activation, value_factory.get()));
+  ASSERT_EQ(results.size(), 1);
+  EXPECT_EQ(results[0]->As<IntValue>().NativeValue(), 42);
+}
+
+TEST_F(MultiProgramSessionTest, DistinctChainsHoistedSeparately) {
+  ASSERT_OK_AND_ASSIGN(
+      auto session, CreateSession({R"cel(m["a"] + m["b"])cel",
+                                   R"cel(m["a"] - m["b"])cel"}));
+  EXPECT_EQ(session->shared_subexpression_count(), 2);
+
+  ManagedValueFactory value_factory(session->program(0).GetTypeProvider(),
+                                    MemoryManagerRef::ReferenceCounting());
+  Activation activation;
+  ASSERT_OK(BindMap(value_factory.get(), activation));
+  CountingActivation counting_activation(activation);
+
+  ASSERT_OK_AND_ASSIGN(
+      std::vector<Value> results,
+      session->EvaluateAll(counting_activation, value_factory.get()));
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_EQ(results[0]->As<IntValue>().NativeValue(), 31);
+  EXPECT_EQ(results[1]->As<IntValue>().NativeValue(), 11);
+  // One lookup per distinct chain.
+  EXPECT_EQ(counting_activation.lookups("m"), 2);
+}
+
+TEST_F(MultiProgramSessionTest, UnusedSharedChainIsNeverEvaluated) {
+  ASSERT_OK_AND_ASSIGN(
+      auto session, CreateSession({R"cel(false && m["a"] == 1)cel",
+                                   R"cel(true || m["a"] == 1)cel"}));
+  EXPECT_EQ(session->shared_subexpression_count(), 1);
+
+  ManagedValueFactory value_factory(session->program(0).GetTypeProvider(),
+                                    MemoryManagerRef::ReferenceCounting());
+  Activation activation;
+  ASSERT_OK(BindMap(value_factory.get(), activation));
+  CountingActivation counting_activation(activation);
+
+  ASSERT_OK_AND_ASSIGN(
+      std::vector<Value> results,
+      session->EvaluateAll(counting_activation, value_factory.get()));
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_FALSE(results[0]->As<BoolValue>().NativeValue());
+  EXPECT_TRUE(results[1]->As<BoolValue>().NativeValue());
+
+  // Both branches short-circuited, so the shared chain stayed unevaluated.
+  EXPECT_EQ(counting_activation.lookups("m"), 0);
+}
+
+}  // namespace
+}  // namespace cel
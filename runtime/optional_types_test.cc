@@ -271,7 +271,17 @@ INSTANTIATE_TEST_SUITE_P(
             {"optional_orValue_present", "optional.of(1).orValue(2)",
              IntValueIs(1)},
             {"list_of_optional", "[optional.of(1)][0].orValue(1)",
-             IntValueIs(1)}}),
+             IntValueIs(1)},
+            {"optional_select_chain_present",
+             "{'a': {'b': {'c': 42}}}.?a.?b.?c.orValue(-1)", IntValueIs(42)},
+            {"optional_select_chain_absent",
+             "{'a': {}}.?a.?b.?c.orValue(-1)", IntValueIs(-1)},
+            {"optional_select_chain_escapes", "{'a': {'b': 2}}.?a.?b",
+             OptionalValueIs(IntValueIs(2))},
+            {"optional_select_chain_optional_base",
+             "optional.of({'a': {'b': 3}}).?a.?b.orValue(-1)", IntValueIs(3)},
+            {"optional_select_chain_none_base",
+             "optional.none().?a.?b.orValue(-1)", IntValueIs(-1)}}),
         /*enable_short_circuiting*/ testing::Bool()),
     OptionalTypesTest::ToString);
 
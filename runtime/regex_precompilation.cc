@@ -18,6 +18,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "common/native_type.h"
+#include "eval/compiler/regex_alternation_optimization.h"
 #include "eval/compiler/regex_precompilation_optimization.h"
 #include "internal/casts.h"
 #include "internal/status_macros.h"
@@ -32,6 +33,7 @@ namespace {
 using ::cel::internal::down_cast;
 using ::cel::runtime_internal::RuntimeFriendAccess;
 using ::cel::runtime_internal::RuntimeImpl;
+using ::google::api::expr::runtime::CreateRegexAlternationExtension;
 using ::google::api::expr::runtime::CreateRegexPrecompilationExtension;
 
 absl::StatusOr<RuntimeImpl*> RuntimeImplFromBuilder(RuntimeBuilder& builder) {
@@ -62,4 +64,15 @@ absl::Status EnableRegexPrecompilation(RuntimeBuilder& builder) {
   return absl::OkStatus();
 }
 
+absl::Status EnableRegexAlternationOptimization(RuntimeBuilder& builder) {
+  CEL_ASSIGN_OR_RETURN(RuntimeImpl * runtime_impl,
+                       RuntimeImplFromBuilder(builder));
+  ABSL_ASSERT(runtime_impl != nullptr);
+
+  runtime_impl->expr_builder().AddProgramOptimizer(
+      CreateRegexAlternationExtension(
+          runtime_impl->expr_builder().options().regex_max_program_size));
+  return absl::OkStatus();
+}
+
 }  // namespace cel::extensions
@@ -31,6 +31,13 @@ namespace cel::extensions {
 // from builder.
 absl::Status EnableRegexPrecompilation(RuntimeBuilder& builder);
 
+// Enable lowering of matches() disjunction chains in the runtime being built.
+//
+// Disjunctions of standard 'Match' calls with constant patterns on the same
+// operand (`x.matches(p1) || x.matches(p2) || ...`) are rewritten into a
+// single RE2::Set scan of the subject instead of one scan per pattern.
+absl::Status EnableRegexAlternationOptimization(RuntimeBuilder& builder);
+
 }  // namespace cel::extensions
 
 #endif  // THIRD_PARTY_CEL_CPP_REGEX_PRECOMPILATION_FOLDING_H_
@@ -0,0 +1,160 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/result_memoization.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/hash/hash.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "internal/status_macros.h"
+#include "runtime/activation_interface.h"
+#include "runtime/internal/value_hash.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+
+using ::cel::runtime_internal::HashPrimitiveValue;
+
+ProgramResultCache::ProgramResultCache(size_t max_entries, size_t shard_count)
+    : max_entries_per_shard_(
+          std::max<size_t>(1, max_entries / std::max<size_t>(1, shard_count))) {
+  shards_.reserve(std::max<size_t>(1, shard_count));
+  for (size_t i = 0; i < std::max<size_t>(1, shard_count); ++i) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+ProgramResultCache::Shard& ProgramResultCache::ShardFor(const Key& key) {
+  return *shards_[absl::HashOf(key) % shards_.size()];
+}
+
+bool ProgramResultCache::Lookup(const Key& key, Value& result) {
+  Shard& shard = ShardFor(key);
+  absl::MutexLock lock(&shard.mu);
+  auto it = shard.index.find(key);
+  if (it == shard.index.end()) {
+    return false;
+  }
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  result = it->second->value;
+  return true;
+}
+
+void ProgramResultCache::Insert(const Key& key, Value value) {
+  Shard& shard = ShardFor(key);
+  absl::MutexLock lock(&shard.mu);
+  auto it = shard.index.find(key);
+  if (it != shard.index.end()) {
+    it->second->value = std::move(value);
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    return;
+  }
+  if (shard.lru.size() >= max_entries_per_shard_) {
+    shard.index.erase(shard.lru.back().key);
+    shard.lru.pop_back();
+  }
+  shard.lru.push_front(Entry{key, std::move(value)});
+  shard.index[key] = shard.lru.begin();
+}
+
+void ProgramResultCache::Clear() {
+  for (auto& shard : shards_) {
+    absl::MutexLock lock(&shard->mu);
+    shard->lru.clear();
+    shard->index.clear();
+  }
+}
+
+absl::StatusOr<std::unique_ptr<MemoizedProgram>> MemoizedProgram::Create(
+    std::unique_ptr<Program> program, ResultMemoizationOptions options,
+    std::shared_ptr<ProgramResultCache> cache) {
+  if (!options.fingerprint && options.fingerprint_variables.empty()) {
+    absl::optional<std::vector<std::string>> derived =
+        program->ReferencedVariables();
+    if (!derived.has_value()) {
+      return absl::InvalidArgumentError(
+          "MemoizedProgram: no fingerprint source: the program cannot "
+          "enumerate its referenced variables, so either "
+          "fingerprint_variables or a fingerprint callback is required");
+    }
+    options.fingerprint_variables = *std::move(derived);
+  }
+  if (cache == nullptr) {
+    cache = std::make_shared<ProgramResultCache>(options.max_entries,
+                                                 options.shard_count);
+  }
+  return std::unique_ptr<MemoizedProgram>(new MemoizedProgram(
+      std::move(program), std::move(options), std::move(cache)));
+}
+
+absl::optional<size_t> MemoizedProgram::Fingerprint(
+    const ActivationInterface& activation, ValueManager& value_factory) const {
+  if (options_.fingerprint) {
+    return options_.fingerprint(activation);
+  }
+  size_t combined = absl::HashOf(options_.fingerprint_variables.size());
+  Value value;
+  for (const std::string& name : options_.fingerprint_variables) {
+    auto found = activation.FindVariable(value_factory, name, value);
+    if (!found.ok()) {
+      return absl::nullopt;
+    }
+    if (!*found) {
+      // Unbound variables are part of the input shape; tag them distinctly
+      // from any bound value.
+      combined = absl::HashOf(combined, name, false);
+      continue;
+    }
+    absl::optional<size_t> value_hash = HashPrimitiveValue(value);
+    if (!value_hash.has_value()) {
+      return absl::nullopt;
+    }
+    combined = absl::HashOf(combined, name, true, *value_hash);
+  }
+  return combined;
+}
+
+absl::StatusOr<Value> MemoizedProgram::Evaluate(
+    const ActivationInterface& activation, ValueManager& value_factory) const {
+  absl::optional<size_t> fingerprint = Fingerprint(activation, value_factory);
+  if (!fingerprint.has_value()) {
+    return program_->Evaluate(activation, value_factory);
+  }
+  ProgramResultCache::Key key{reinterpret_cast<uintptr_t>(program_.get()),
+                              generation_.load(std::memory_order_acquire),
+                              *fingerprint};
+  Value cached;
+  if (cache_->Lookup(key, cached)) {
+    return cached;
+  }
+  CEL_ASSIGN_OR_RETURN(Value result,
+                       program_->Evaluate(activation, value_factory));
+  cache_->Insert(key, result);
+  return result;
+}
+
+}  // namespace cel
@@ -0,0 +1,188 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_RESULT_MEMOIZATION_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_RESULT_MEMOIZATION_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+#include "base/type_provider.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "runtime/activation_interface.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+
+// Sharded, bounded LRU cache of evaluation results keyed by
+// (program, generation, input fingerprint).
+//
+// Thread-safe; contention is limited to the shard a fingerprint maps to. One
+// cache may be shared by several MemoizedPrograms — the program component of
+// the key keeps their entries apart. Bumping a program's generation makes all
+// of its prior entries unreachable in O(1); the stale entries age out through
+// the LRU bound rather than being swept eagerly.
+class ProgramResultCache final {
+ public:
+  struct Key {
+    uintptr_t program;
+    uint64_t generation;
+    size_t fingerprint;
+
+    friend bool operator==(const Key& lhs, const Key& rhs) {
+      return lhs.program == rhs.program && lhs.generation == rhs.generation &&
+             lhs.fingerprint == rhs.fingerprint;
+    }
+
+    template <typename H>
+    friend H AbslHashValue(H state, const Key& key) {
+      return H::combine(std::move(state), key.program, key.generation,
+                        key.fingerprint);
+    }
+  };
+
+  explicit ProgramResultCache(size_t max_entries, size_t shard_count = 8);
+
+  // Move-only would still copy-share shards; keep it pinned.
+  ProgramResultCache(const ProgramResultCache&) = delete;
+  ProgramResultCache& operator=(const ProgramResultCache&) = delete;
+
+  // Returns true and copies the cached value into `result` on a hit, marking
+  // the entry most recently used.
+  bool Lookup(const Key& key, Value& result);
+
+  // Inserts (or refreshes) an entry, evicting the least recently used entry
+  // of the target shard when it is full.
+  void Insert(const Key& key, Value value);
+
+  // Drops every entry.
+  void Clear();
+
+ private:
+  struct Entry {
+    Key key;
+    Value value;
+  };
+
+  struct Shard {
+    absl::Mutex mu;
+    std::list<Entry> lru ABSL_GUARDED_BY(mu);
+    absl::flat_hash_map<Key, std::list<Entry>::iterator> index
+        ABSL_GUARDED_BY(mu);
+  };
+
+  Shard& ShardFor(const Key& key);
+
+  const size_t max_entries_per_shard_;
+  // unique_ptr since absl::Mutex is neither movable nor copyable.
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+struct ResultMemoizationOptions {
+  // Total cache capacity, split evenly across shards. Ignored when a shared
+  // cache is supplied to MemoizedProgram::Create.
+  size_t max_entries = 1024;
+  size_t shard_count = 8;
+
+  // Activation variables to fingerprint. When empty and no `fingerprint`
+  // callback is set, the variable set is derived from
+  // Program::ReferencedVariables().
+  std::vector<std::string> fingerprint_variables;
+
+  // Caller-provided fingerprint. Takes precedence over variable-based
+  // fingerprinting; returning nullopt bypasses the cache for that
+  // evaluation.
+  std::function<absl::optional<size_t>(const ActivationInterface&)> fingerprint;
+};
+
+// A Program decorator that caches evaluation results by input fingerprint.
+//
+// The fingerprint is either computed by a caller-supplied callback or by
+// hashing the values of a declared (or plan-derived) set of activation
+// variables. Only primitive values (bool, int, uint, double, string, bytes,
+// null, duration, timestamp) participate in hashing; an evaluation whose
+// fingerprinted variables include anything else bypasses the cache rather
+// than risk a false hit. A cache hit returns the stored value directly,
+// skipping evaluator state construction and the dispatch loop entirely.
+//
+// Cached values must outlive the activation they were computed from, so the
+// ValueManager passed to Evaluate must use a memory manager whose values
+// survive individual evaluations (e.g. reference counting). Do not memoize
+// results allocated on a per-request arena.
+//
+// Invalidate() discards all cached results in O(1); use it when registered
+// functions are impure and their backing state changes.
+class MemoizedProgram final : public Program {
+ public:
+  // Wraps `program`. Uses `cache` when non-null, otherwise builds a private
+  // cache from the options. Fails with InvalidArgument when no fingerprint
+  // source is available: no callback, no declared variables, and the wrapped
+  // program cannot enumerate its referenced variables.
+  static absl::StatusOr<std::unique_ptr<MemoizedProgram>> Create(
+      std::unique_ptr<Program> program, ResultMemoizationOptions options,
+      std::shared_ptr<ProgramResultCache> cache = nullptr);
+
+  absl::StatusOr<Value> Evaluate(const ActivationInterface& activation,
+                                 ValueManager& value_factory) const override;
+
+  absl::Status Warmup() const override { return program_->Warmup(); }
+
+  absl::optional<std::vector<std::string>> ReferencedVariables()
+      const override {
+    return program_->ReferencedVariables();
+  }
+
+  const TypeProvider& GetTypeProvider() const override {
+    return program_->GetTypeProvider();
+  }
+
+  // Makes all previously cached results unreachable. Safe to call
+  // concurrently with evaluation.
+  void Invalidate() { generation_.fetch_add(1, std::memory_order_release); }
+
+ private:
+  MemoizedProgram(std::unique_ptr<Program> program,
+                  ResultMemoizationOptions options,
+                  std::shared_ptr<ProgramResultCache> cache)
+      : program_(std::move(program)),
+        options_(std::move(options)),
+        cache_(std::move(cache)) {}
+
+  // Returns nullopt when the inputs cannot be fingerprinted safely.
+  absl::optional<size_t> Fingerprint(const ActivationInterface& activation,
+                                     ValueManager& value_factory) const;
+
+  std::unique_ptr<Program> program_;
+  ResultMemoizationOptions options_;
+  std::shared_ptr<ProgramResultCache> cache_;
+  std::atomic<uint64_t> generation_{0};
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_RESULT_MEMOIZATION_H_
@@ -0,0 +1,209 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/result_memoization.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "base/function_adapter.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/register_function_helper.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+
+namespace cel {
+namespace {
+
+using ::google::api::expr::v1alpha1::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+using ::cel::extensions::ProtobufRuntimeAdapter;
+
+class ResultMemoizationTest : public testing::Test {
+ protected:
+  // Builds a program for `expression` with a counting `probe(int) -> int`
+  // function registered, so tests can observe whether an evaluation hit the
+  // cache or ran the wrapped program.
+  absl::StatusOr<std::unique_ptr<Program>> MakeProgram(
+      absl::string_view expression) {
+    RuntimeOptions options;
+    CEL_ASSIGN_OR_RETURN(RuntimeBuilder builder,
+                         CreateStandardRuntimeBuilder(options));
+    CEL_RETURN_IF_ERROR(
+        (RegisterHelper<UnaryFunctionAdapter<int64_t, int64_t>>::
+             RegisterGlobalOverload(
+                 "probe",
+                 [this](ValueManager&, int64_t value) {
+                   ++eval_count_;
+                   return value;
+                 },
+                 builder.function_registry())));
+    CEL_ASSIGN_OR_RETURN(runtime_, std::move(builder).Build());
+
+    CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+    CEL_ASSIGN_OR_RETURN(auto program, ProtobufRuntimeAdapter::CreateProgram(
+                                           *runtime_, parsed_expr));
+    value_factory_ = std::make_unique<ManagedValueFactory>(
+        program->GetTypeProvider(), MemoryManagerRef::ReferenceCounting());
+    return program;
+  }
+
+  ValueManager& value_manager() { return value_factory_->get(); }
+
+  int eval_count_ = 0;
+  std::unique_ptr<const Runtime> runtime_;
+  std::unique_ptr<ManagedValueFactory> value_factory_;
+};
+
+TEST_F(ResultMemoizationTest, RepeatedInputsEvaluateOnce) {
+  ASSERT_OK_AND_ASSIGN(auto program, MakeProgram("probe(x) + 1"));
+  ASSERT_OK_AND_ASSIGN(
+      auto memoized,
+      MemoizedProgram::Create(std::move(program), ResultMemoizationOptions{}));
+
+  Activation activation;
+  activation.InsertOrAssignValue("x", value_manager().CreateIntValue(41));
+
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       memoized->Evaluate(activation, value_manager()));
+  EXPECT_EQ(result.As<IntValue>().NativeValue(), 42);
+  ASSERT_OK_AND_ASSIGN(result, memoized->Evaluate(activation, value_manager()));
+  EXPECT_EQ(result.As<IntValue>().NativeValue(), 42);
+  EXPECT_EQ(eval_count_, 1);
+
+  // A different input misses the cache.
+  activation.InsertOrAssignValue("x", value_manager().CreateIntValue(1));
+  ASSERT_OK_AND_ASSIGN(result, memoized->Evaluate(activation, value_manager()));
+  EXPECT_EQ(result.As<IntValue>().NativeValue(), 2);
+  EXPECT_EQ(eval_count_, 2);
+
+  // The first input is still cached.
+  activation.InsertOrAssignValue("x", value_manager().CreateIntValue(41));
+  ASSERT_OK_AND_ASSIGN(result, memoized->Evaluate(activation, value_manager()));
+  EXPECT_EQ(result.As<IntValue>().NativeValue(), 42);
+  EXPECT_EQ(eval_count_, 2);
+}
+
+TEST_F(ResultMemoizationTest, InvalidateForcesReevaluation) {
+  ASSERT_OK_AND_ASSIGN(auto program, MakeProgram("probe(x)"));
+  ASSERT_OK_AND_ASSIGN(
+      auto memoized,
+      MemoizedProgram::Create(std::move(program), ResultMemoizationOptions{}));
+
+  Activation activation;
+  activation.InsertOrAssignValue("x", value_manager().CreateIntValue(7));
+
+  ASSERT_OK(memoized->Evaluate(activation, value_manager()).status());
+  ASSERT_OK(memoized->Evaluate(activation, value_manager()).status());
+  EXPECT_EQ(eval_count_, 1);
+
+  memoized->Invalidate();
+  ASSERT_OK(memoized->Evaluate(activation, value_manager()).status());
+  EXPECT_EQ(eval_count_, 2);
+}
+
+TEST_F(ResultMemoizationTest, CallerProvidedFingerprint) {
+  ASSERT_OK_AND_ASSIGN(auto program, MakeProgram("probe(x)"));
+
+  ResultMemoizationOptions options;
+  size_t fingerprint = 1;
+  options.fingerprint = [&fingerprint](const ActivationInterface&) {
+    return absl::make_optional(fingerprint);
+  };
+  ASSERT_OK_AND_ASSIGN(
+      auto memoized,
+      MemoizedProgram::Create(std::move(program), std::move(options)));
+
+  Activation activation;
+  activation.InsertOrAssignValue("x", value_manager().CreateIntValue(7));
+
+  ASSERT_OK(memoized->Evaluate(activation, value_manager()).status());
+  ASSERT_OK(memoized->Evaluate(activation, value_manager()).status());
+  EXPECT_EQ(eval_count_, 1);
+
+  // The callback, not the activation contents, decides hit or miss.
+  fingerprint = 2;
+  ASSERT_OK(memoized->Evaluate(activation, value_manager()).status());
+  EXPECT_EQ(eval_count_, 2);
+}
+
+TEST_F(ResultMemoizationTest, NonPrimitiveVariableBypassesCache) {
+  ASSERT_OK_AND_ASSIGN(auto program, MakeProgram("probe(xs[0])"));
+  ASSERT_OK_AND_ASSIGN(
+      auto memoized,
+      MemoizedProgram::Create(std::move(program), ResultMemoizationOptions{}));
+
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       value_manager().NewListValueBuilder(
+                           value_manager().GetDynListType()));
+  ASSERT_OK(builder->Add(value_manager().CreateIntValue(3)));
+  Activation activation;
+  activation.InsertOrAssignValue("xs", std::move(*builder).Build());
+
+  // Lists cannot be fingerprinted safely, so every evaluation runs.
+  ASSERT_OK(memoized->Evaluate(activation, value_manager()).status());
+  ASSERT_OK(memoized->Evaluate(activation, value_manager()).status());
+  EXPECT_EQ(eval_count_, 2);
+}
+
+TEST_F(ResultMemoizationTest, DeclaredVariablesOverrideDerivedSet) {
+  ASSERT_OK_AND_ASSIGN(auto program, MakeProgram("probe(x) + y"));
+
+  // Only `x` participates in the fingerprint, so rebinding `y` alone
+  // (incorrectly, from the cache's point of view) returns the stale result.
+  ResultMemoizationOptions options;
+  options.fingerprint_variables = {"x"};
+  ASSERT_OK_AND_ASSIGN(
+      auto memoized,
+      MemoizedProgram::Create(std::move(program), std::move(options)));
+
+  Activation activation;
+  activation.InsertOrAssignValue("x", value_manager().CreateIntValue(1));
+  activation.InsertOrAssignValue("y", value_manager().CreateIntValue(1));
+
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       memoized->Evaluate(activation, value_manager()));
+  EXPECT_EQ(result.As<IntValue>().NativeValue(), 2);
+
+  activation.InsertOrAssignValue("y", value_manager().CreateIntValue(100));
+  ASSERT_OK_AND_ASSIGN(result, memoized->Evaluate(activation, value_manager()));
+  EXPECT_EQ(result.As<IntValue>().NativeValue(), 2);
+  EXPECT_EQ(eval_count_, 1);
+}
+
+TEST_F(ResultMemoizationTest, ReferencedVariablesReportedByPlan) {
+  ASSERT_OK_AND_ASSIGN(auto program, MakeProgram("x + y > 0"));
+  auto variables = program->ReferencedVariables();
+  ASSERT_TRUE(variables.has_value());
+  EXPECT_THAT(*variables, testing::UnorderedElementsAre("x", "y"));
+}
+
+}  // namespace
+}  // namespace cel
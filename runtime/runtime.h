@@ -17,14 +17,18 @@
 #ifndef THIRD_PARTY_CEL_CPP_RUNTIME_RUNTIME_H_
 #define THIRD_PARTY_CEL_CPP_RUNTIME_RUNTIME_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/functional/any_invocable.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "base/ast.h"
 #include "base/type_provider.h"
 #include "common/native_type.h"
@@ -75,6 +79,67 @@ class Program {
   virtual absl::StatusOr<Value> Evaluate(const ActivationInterface& activation,
                                          ValueManager& value_factory) const = 0;
 
+  // Evaluate the program over a batch of activations.
+  //
+  // One result is written per activation to `results`, which must be at least
+  // as large as `activations`. Recoverable (CEL) errors are recorded in the
+  // corresponding result slot as cel::ErrorValue; the first non-recoverable
+  // error aborts the batch and is returned.
+  //
+  // The default implementation evaluates row by row. Implementations may
+  // override this to amortize per-evaluation setup across the batch.
+  virtual absl::Status EvaluateBatch(
+      absl::Span<const ActivationInterface* const> activations,
+      absl::Span<Value> results, ValueManager& value_factory) const {
+    if (results.size() < activations.size()) {
+      return absl::InvalidArgumentError(
+          "EvaluateBatch: fewer result slots than activations");
+    }
+    for (size_t i = 0; i < activations.size(); ++i) {
+      auto result = Evaluate(*activations[i], value_factory);
+      if (!result.ok()) {
+        return std::move(result).status();
+      }
+      results[i] = *std::move(result);
+    }
+    return absl::OkStatus();
+  }
+
+  // Touches the program's memory ahead of serving traffic.
+  //
+  // Walks the planned step objects so plan memory (steps, pooled constants,
+  // precompiled regex programs) is faulted in and cache-warm before the first
+  // evaluation, instead of that evaluation paying the page faults after a
+  // config push. Safe to call concurrently with evaluation.
+  //
+  // The default implementation is a no-op, for implementations without a
+  // step-based plan.
+  virtual absl::Status Warmup() const { return absl::OkStatus(); }
+
+  // As above, and additionally runs one dry evaluation against `activation`,
+  // discarding the result. The dry run exercises the same code paths as
+  // Evaluate, so `activation` should be a synthetic stand-in for production
+  // inputs. Recoverable CEL errors from the dry run are ignored.
+  absl::Status Warmup(const ActivationInterface& activation,
+                      ValueManager& value_factory) const {
+    if (absl::Status status = Warmup(); !status.ok()) {
+      return status;
+    }
+    return Evaluate(activation, value_factory).status();
+  }
+
+  // Names of the activation variables the planned expression may read, in no
+  // particular order, or nullopt if the implementation cannot enumerate them.
+  //
+  // A variable appearing in the result does not imply every evaluation reads
+  // it (short-circuiting may skip it), but evaluations never read variables
+  // outside the result. Useful for fingerprinting the inputs of an
+  // evaluation, e.g. for result memoization.
+  virtual absl::optional<std::vector<std::string>> ReferencedVariables()
+      const {
+    return absl::nullopt;
+  }
+
   virtual const TypeProvider& GetTypeProvider() const = 0;
 };
 
@@ -55,6 +55,9 @@ class RuntimeBuilder {
   // The builder is left in an undefined state after this call and cannot be
   // reused.
   absl::StatusOr<std::unique_ptr<const Runtime>> Build() && {
+    // The runtime is immutable once built; freeze the function registry into
+    // its contention-free lookup index.
+    function_registry_->Finalize();
     return std::move(runtime_);
   }
 
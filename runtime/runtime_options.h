@@ -17,9 +17,14 @@
 #ifndef THIRD_PARTY_CEL_CPP_RUNTIME_RUNTIME_OPTIONS_H_
 #define THIRD_PARTY_CEL_CPP_RUNTIME_RUNTIME_OPTIONS_H_
 
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <vector>
 
 #include "absl/base/attributes.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/time/time.h"
 
 namespace cel {
 
@@ -150,8 +155,12 @@ struct RuntimeOptions {
 
   // Enable tracing support for recursively planned programs.
   //
-  // Unlike the stack machine implementation, supporting tracing can affect
-  // performance whether or not tracing is requested for a given evaluation.
+  // Unlike the stack machine implementation, supporting tracing wraps each
+  // planned subexpression in a trace decorator, so it slightly grows the plan
+  // and adds a predicted branch per node whether or not tracing is requested
+  // for a given evaluation. Whether the listener is invoked is decided once
+  // per evaluation, so a single plan built with this option serves both
+  // traced and untraced evaluations.
   bool enable_recursive_tracing = false;
 
   // Use legacy containers for lists and maps when possible.
@@ -162,6 +171,97 @@ struct RuntimeOptions {
   //
   // Default is false for the modern option type.
   bool use_legacy_container_builders = false;
+
+  // Set maximum total evaluation cost per evaluation. Each dispatched
+  // execution step charges its relative cost (ExpressionStep::Cost(); most
+  // steps cost 1, function calls and container construction cost more)
+  // against the budget, and evaluation aborts with a kResourceExhausted error
+  // once it is exhausted. Unlike comprehension_max_iterations, which counts
+  // loop trips regardless of how much work each trip does, this bounds the
+  // total work performed, so iteration caps can be raised for cheap loops
+  // while overall CPU stays bounded.
+  //
+  // Only enforced by the stack machine interpreter; it does not apply to
+  // subtrees planned recursively via max_recursion_depth. Use value 0 to
+  // disable the budget.
+  int64_t evaluation_cost_budget = 0;
+
+  // Set maximum arena bytes allocated per evaluation. The evaluator samples
+  // the backing arena's allocated block space at step boundaries and aborts
+  // with a kResourceExhausted error once growth since the start of the
+  // evaluation exceeds the limit. Accounting is per arena block rather than
+  // per object, so the steady-state overhead is a short walk of the arena's
+  // block list per dispatched step; a single step may overshoot the limit
+  // before the next boundary check observes it. This bounds runaway
+  // allocation (e.g. repeated string concatenation inside a comprehension)
+  // that iteration caps alone do not, so comprehension limits can be raised
+  // for legitimate heavy users while memory stays bounded.
+  //
+  // Only enforced by the stack machine interpreter, and only when evaluating
+  // against an arena-backed (pooling) memory manager; with a
+  // reference-counting memory manager the limit is not enforced. Use value 0
+  // to disable the limit.
+  int64_t evaluation_memory_limit_bytes = 0;
+
+  // Executor used to evaluate side-effect-free ternary branches
+  // speculatively, in parallel with the condition, instead of serializing on
+  // the condition result. Null (the default) disables speculation.
+  //
+  // The executor must run each submitted task exactly once, possibly inline.
+  // Speculative branches evaluate concurrently with the main evaluation
+  // against the same activation and memory manager, so both must tolerate
+  // concurrent use (e.g. a protobuf arena and an activation whose lookups are
+  // read-only or internally synchronized).
+  //
+  // Only the stack machine interpreter speculates, and only for ternaries
+  // whose branches the planner can prove side-effect-free (constants, idents,
+  // selects, containers, comprehensions and builtin functions; extension
+  // functions are conservatively assumed impure). Speculation is disabled
+  // for plans that track unknowns or missing attributes.
+  std::function<void(absl::AnyInvocable<void()>)> speculation_executor;
+
+  // Maximum number of speculative branch evaluations started per evaluation
+  // (each speculated ternary starts two). Once exhausted, remaining ternaries
+  // fall back to sequential evaluation. Only meaningful when
+  // speculation_executor is set.
+  int max_speculative_branches = 8;
+
+  // Names of "ambient" variables (e.g. `now` or a request id) snapshotted
+  // once per evaluation. The first reference in an evaluation resolves
+  // through the activation as usual; the result — including absence — is
+  // pinned for the remainder of that evaluation, so repeated references see
+  // a consistent value and activation value providers (e.g. a clock read
+  // behind `now`) run at most once per evaluation, even for activations
+  // that do not memoize provider results. Empty (the default) disables
+  // snapshotting.
+  std::vector<std::string> ambient_variables;
+
+  // Wall-clock budget per evaluation. When positive, evaluation aborts with
+  // a kDeadlineExceeded error once the deadline (taken at the start of the
+  // evaluation) has passed.
+  //
+  // The check is cooperative and amortized: rather than reading the clock on
+  // every step, the interpreter decrements a dispatch counter and reads the
+  // clock every ExecutionFrameBase::kDeadlineCheckInterval dispatched steps,
+  // and once per comprehension iteration (which also covers recursively
+  // planned comprehensions). A single long-running step — e.g. one large
+  // regex scan, separately bounded by regex_max_program_size — can therefore
+  // overshoot the deadline before the next check. Zero (the default)
+  // disables the deadline.
+  absl::Duration evaluation_timeout = absl::ZeroDuration();
+
+  // Enable strict plan-time resolution of enum constants.
+  //
+  // When enabled, enum constants registered with the runtime's TypeRegistry
+  // compile into plain constant steps instead of runtime-shadowable values,
+  // removing the per-evaluation identifier lookup. A reference that selects
+  // an undefined enumerator from a registered enum type fails planning with
+  // an InvalidArgument error instead of deferring to an identifier lookup at
+  // evaluation time.
+  //
+  // Only enable for expressions that never shadow enum names with activation
+  // variables.
+  bool enable_strict_enum_constant_folding = false;
 };
 // LINT.ThenChange(//depot/google3/eval/public/cel_options.h)
 
@@ -0,0 +1,66 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/runtime_replication.h"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "base/ast.h"
+#include "internal/status_macros.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+
+absl::StatusOr<std::vector<std::unique_ptr<const Runtime>>> ReplicateRuntime(
+    size_t count,
+    absl::AnyInvocable<absl::StatusOr<std::unique_ptr<const Runtime>>()>
+        factory) {
+  if (count == 0) {
+    return absl::InvalidArgumentError(
+        "ReplicateRuntime: replica count must be positive");
+  }
+  std::vector<std::unique_ptr<const Runtime>> replicas;
+  replicas.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    CEL_ASSIGN_OR_RETURN(auto replica, factory());
+    replicas.push_back(std::move(replica));
+  }
+  return replicas;
+}
+
+absl::StatusOr<ProgramReplicas> ProgramReplicas::Plan(
+    absl::Span<const std::unique_ptr<const Runtime>> replicas,
+    absl::AnyInvocable<absl::StatusOr<std::unique_ptr<Ast>>()> ast_factory) {
+  if (replicas.empty()) {
+    return absl::InvalidArgumentError(
+        "ProgramReplicas: at least one runtime replica is required");
+  }
+  std::vector<std::unique_ptr<Program>> programs;
+  programs.reserve(replicas.size());
+  for (const std::unique_ptr<const Runtime>& runtime : replicas) {
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<Ast> ast, ast_factory());
+    CEL_ASSIGN_OR_RETURN(auto program, runtime->CreateProgram(std::move(ast)));
+    programs.push_back(std::move(program));
+  }
+  return ProgramReplicas(std::move(programs));
+}
+
+}  // namespace cel
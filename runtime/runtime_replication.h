@@ -0,0 +1,82 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Helpers for shared-nothing runtime partitioning on multi-socket hosts.
+//
+// A built Runtime cannot be cloned into node-local memory directly: its
+// registries own type-erased cel::Function implementations with no deep-copy
+// operation. Replication instead rebuilds the runtime and its programs once
+// per partition. When each factory invocation runs on a thread pinned to the
+// target NUMA node, first-touch allocation places the registry and plan bytes
+// node-locally, so threads on that socket evaluate against local memory.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_RUNTIME_REPLICATION_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_RUNTIME_REPLICATION_H_
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "base/ast.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+
+// Builds `count` independent runtime replicas by invoking `factory` once per
+// replica. Returns the first factory error, if any.
+//
+// Callers targeting specific NUMA nodes should run each invocation on a
+// thread pinned to the corresponding node; this function itself performs no
+// thread placement.
+absl::StatusOr<std::vector<std::unique_ptr<const Runtime>>> ReplicateRuntime(
+    size_t count,
+    absl::AnyInvocable<absl::StatusOr<std::unique_ptr<const Runtime>>()>
+        factory);
+
+// Holds one planned program per runtime replica and selects a replica by
+// partition index.
+//
+// The replicated runtimes must outlive this object.
+class ProgramReplicas final {
+ public:
+  // Plans one program per replica. `ast_factory` is invoked once per replica
+  // to produce a fresh AST, since planning consumes it; see
+  // extensions/protobuf/ast_converters.h for producing ASTs from a parsed
+  // expression.
+  static absl::StatusOr<ProgramReplicas> Plan(
+      absl::Span<const std::unique_ptr<const Runtime>> replicas,
+      absl::AnyInvocable<absl::StatusOr<std::unique_ptr<Ast>>()> ast_factory);
+
+  size_t size() const { return programs_.size(); }
+
+  // Returns the program for `partition`, e.g. the calling thread's NUMA node.
+  // Partitions beyond the replica count wrap around.
+  const Program& ForPartition(size_t partition) const {
+    return *programs_[partition % programs_.size()];
+  }
+
+ private:
+  explicit ProgramReplicas(std::vector<std::unique_ptr<Program>> programs)
+      : programs_(std::move(programs)) {}
+
+  std::vector<std::unique_ptr<Program>> programs_;
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_RUNTIME_REPLICATION_H_
@@ -0,0 +1,109 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/runtime_replication.h"
+
+#include <memory>
+#include <utility>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "extensions/protobuf/ast_converters.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+
+namespace cel {
+namespace {
+
+using ::google::api::expr::v1alpha1::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+using cel::internal::StatusIs;
+
+absl::StatusOr<std::unique_ptr<const Runtime>> MakeStandardRuntime() {
+  RuntimeOptions options;
+  CEL_ASSIGN_OR_RETURN(auto builder, CreateStandardRuntimeBuilder(options));
+  return std::move(builder).Build();
+}
+
+TEST(RuntimeReplicationTest, ReplicateRuntimeBuildsIndependentInstances) {
+  ASSERT_OK_AND_ASSIGN(auto replicas,
+                       ReplicateRuntime(3, MakeStandardRuntime));
+
+  ASSERT_EQ(replicas.size(), 3);
+  EXPECT_NE(replicas[0].get(), replicas[1].get());
+  EXPECT_NE(replicas[1].get(), replicas[2].get());
+}
+
+TEST(RuntimeReplicationTest, ReplicateRuntimeRejectsZeroCount) {
+  EXPECT_THAT(ReplicateRuntime(0, MakeStandardRuntime),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(RuntimeReplicationTest, ReplicateRuntimeForwardsFactoryError) {
+  EXPECT_THAT(
+      ReplicateRuntime(2,
+                       []() -> absl::StatusOr<std::unique_ptr<const Runtime>> {
+                         return absl::InternalError("boom");
+                       }),
+      StatusIs(absl::StatusCode::kInternal, "boom"));
+}
+
+TEST(RuntimeReplicationTest, ProgramReplicasEvaluatePerPartition) {
+  ASSERT_OK_AND_ASSIGN(auto replicas,
+                       ReplicateRuntime(2, MakeStandardRuntime));
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr, Parse("x + 1"));
+  ASSERT_OK_AND_ASSIGN(
+      auto programs,
+      ProgramReplicas::Plan(replicas, [&parsed_expr]() {
+        return extensions::CreateAstFromParsedExpr(parsed_expr);
+      }));
+
+  ASSERT_EQ(programs.size(), 2);
+
+  // Every partition evaluates to the same result; partitions beyond the
+  // replica count wrap around.
+  for (size_t partition = 0; partition < 4; ++partition) {
+    const Program& program = programs.ForPartition(partition);
+    ManagedValueFactory value_factory(program.GetTypeProvider(),
+                                      MemoryManagerRef::ReferenceCounting());
+    Activation activation;
+    activation.InsertOrAssignValue("x",
+                                   value_factory.get().CreateIntValue(41));
+    ASSERT_OK_AND_ASSIGN(Value result,
+                         program.Evaluate(activation, value_factory.get()));
+    ASSERT_TRUE(result->Is<IntValue>());
+    EXPECT_EQ(result->As<IntValue>().NativeValue(), 42);
+  }
+}
+
+TEST(RuntimeReplicationTest, ProgramReplicasRejectEmptyReplicaSet) {
+  EXPECT_THAT(
+      ProgramReplicas::Plan({},
+                            []() -> absl::StatusOr<std::unique_ptr<Ast>> {
+                              return absl::InternalError("unreachable");
+                            }),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace cel
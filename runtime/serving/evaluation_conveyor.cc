@@ -0,0 +1,119 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/serving/evaluation_conveyor.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "runtime/managed_value_factory.h"
+
+namespace cel {
+
+EvaluationConveyor::EvaluationConveyor(
+    const EvaluationConveyorOptions& options)
+    : max_queued_jobs_(options.max_queued_jobs) {
+  int worker_count = options.worker_count >= 1 ? options.worker_count : 1;
+  workers_.reserve(worker_count);
+  for (int i = 0; i < worker_count; ++i) {
+    workers_.emplace_back(&EvaluationConveyor::WorkerLoop, this);
+  }
+}
+
+EvaluationConveyor::~EvaluationConveyor() {
+  {
+    absl::MutexLock lock(&mutex_);
+    draining_ = true;
+  }
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+absl::StatusOr<std::future<absl::StatusOr<Value>>> EvaluationConveyor::Submit(
+    const Program& program, const ActivationInterface& activation) {
+  absl::MutexLock lock(&mutex_);
+  if (draining_) {
+    return absl::FailedPreconditionError(
+        "EvaluationConveyor: submit after shutdown");
+  }
+  if (queue_.size() >= max_queued_jobs_) {
+    ++stats_[&program].rejected;
+    return absl::ResourceExhaustedError(
+        "EvaluationConveyor: job queue is full");
+  }
+  queue_.push_back(Job{&program, &activation, {}});
+  return queue_.back().result.get_future();
+}
+
+EvaluationConveyorStats EvaluationConveyor::GetStats(
+    const Program& program) const {
+  absl::MutexLock lock(&mutex_);
+  auto iter = stats_.find(&program);
+  return iter != stats_.end() ? iter->second : EvaluationConveyorStats{};
+}
+
+bool EvaluationConveyor::HasWork() const {
+  return !queue_.empty() || draining_;
+}
+
+void EvaluationConveyor::WorkerLoop() {
+  // Value factories are created on the worker that first serves a program
+  // and reused for all of its later jobs, keeping program-hot data local to
+  // this thread for the conveyor's lifetime.
+  absl::flat_hash_map<const Program*, std::unique_ptr<ManagedValueFactory>>
+      factories;
+
+  for (;;) {
+    Job job;
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(this, &EvaluationConveyor::HasWork));
+      if (queue_.empty()) {
+        // Draining and nothing left to do.
+        return;
+      }
+      job = std::move(queue_.front());
+      queue_.pop_front();
+    }
+
+    auto [iter, inserted] = factories.try_emplace(job.program);
+    if (inserted) {
+      iter->second = std::make_unique<ManagedValueFactory>(
+          job.program->GetTypeProvider(),
+          MemoryManagerRef::ReferenceCounting());
+    }
+
+    absl::StatusOr<Value> result =
+        job.program->Evaluate(*job.activation, iter->second->get());
+    {
+      absl::MutexLock lock(&mutex_);
+      EvaluationConveyorStats& stats = stats_[job.program];
+      if (result.ok()) {
+        ++stats.completed;
+      } else {
+        ++stats.failed;
+      }
+    }
+    job.result.set_value(std::move(result));
+  }
+}
+
+}  // namespace cel
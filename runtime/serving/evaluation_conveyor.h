@@ -0,0 +1,118 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_SERVING_EVALUATION_CONVEYOR_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_SERVING_EVALUATION_CONVEYOR_H_
+
+#include <cstdint>
+#include <deque>
+#include <future>  // NOLINT(build/c++11)
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "common/value.h"
+#include "runtime/activation_interface.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+
+struct EvaluationConveyorOptions {
+  // Number of worker threads. Must be >= 1.
+  int worker_count = 4;
+
+  // Maximum number of jobs waiting for a worker. Submissions beyond this
+  // limit are rejected with kResourceExhausted so callers can shed load or
+  // retry instead of queuing unboundedly.
+  size_t max_queued_jobs = 1024;
+};
+
+// Counters for jobs submitted against one Program.
+struct EvaluationConveyorStats {
+  // Jobs whose future was fulfilled with a value (including CEL errors).
+  int64_t completed = 0;
+  // Jobs whose future was fulfilled with a non-ok status.
+  int64_t failed = 0;
+  // Submissions rejected due to queue capacity.
+  int64_t rejected = 0;
+};
+
+// A fixed pool of worker threads evaluating (program, activation) jobs.
+//
+// Evaluation state in this library is thread-compatible, not thread-safe:
+// each concurrent evaluation needs its own ValueManager. The conveyor owns
+// one value factory per worker per program, created on the worker that first
+// serves the program and reused for every later job, so the per-program hot
+// data (type caches, pooled evaluator state from the thread-local free list)
+// stays pinned to the worker touching it. Result values are allocated with
+// reference-counting memory management and are safe to consume on the
+// caller's thread.
+//
+// Programs and activations are borrowed, not owned: both must outlive the
+// fulfillment of the returned future. Activations must not be mutated while
+// a job referencing them is in flight.
+//
+// Destruction drains already-queued jobs, then joins the workers.
+class EvaluationConveyor {
+ public:
+  explicit EvaluationConveyor(const EvaluationConveyorOptions& options);
+
+  EvaluationConveyor(const EvaluationConveyor&) = delete;
+  EvaluationConveyor& operator=(const EvaluationConveyor&) = delete;
+
+  ~EvaluationConveyor();
+
+  // Enqueue evaluation of `program` against `activation`.
+  //
+  // Returns kResourceExhausted without queuing when max_queued_jobs are
+  // already waiting. Otherwise returns a future fulfilled with the
+  // evaluation result; non-recoverable evaluation errors surface as the
+  // future's StatusOr, CEL errors as a held ErrorValue.
+  absl::StatusOr<std::future<absl::StatusOr<Value>>> Submit(
+      const Program& program ABSL_ATTRIBUTE_LIFETIME_BOUND,
+      const ActivationInterface& activation ABSL_ATTRIBUTE_LIFETIME_BOUND);
+
+  // Counters for jobs submitted for `program` so far. Counters are updated
+  // when a job finishes, so in-flight jobs are not yet reflected.
+  EvaluationConveyorStats GetStats(const Program& program) const;
+
+ private:
+  struct Job {
+    const Program* program;
+    const ActivationInterface* activation;
+    std::promise<absl::StatusOr<Value>> result;
+  };
+
+  void WorkerLoop();
+
+  bool HasWork() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  mutable absl::Mutex mutex_;
+  std::deque<Job> queue_ ABSL_GUARDED_BY(mutex_);
+  bool draining_ ABSL_GUARDED_BY(mutex_) = false;
+  absl::flat_hash_map<const Program*, EvaluationConveyorStats> stats_
+      ABSL_GUARDED_BY(mutex_);
+
+  const size_t max_queued_jobs_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_SERVING_EVALUATION_CONVEYOR_H_
@@ -0,0 +1,113 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/serving/evaluation_conveyor.h"
+
+#include <future>  // NOLINT(build/c++11)
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/value.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+
+namespace cel {
+namespace {
+
+using ::cel::extensions::ProtobufRuntimeAdapter;
+using ::google::api::expr::parser::Parse;
+
+absl::StatusOr<std::unique_ptr<const Runtime>> MakeRuntime() {
+  CEL_ASSIGN_OR_RETURN(auto builder,
+                       CreateStandardRuntimeBuilder(RuntimeOptions{}));
+  return std::move(builder).Build();
+}
+
+absl::StatusOr<std::unique_ptr<Program>> MakeProgram(
+    const Runtime& runtime, absl::string_view expression) {
+  CEL_ASSIGN_OR_RETURN(auto expr, Parse(expression));
+  return ProtobufRuntimeAdapter::CreateProgram(runtime, expr);
+}
+
+TEST(EvaluationConveyorTest, EvaluatesSubmittedJobs) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime());
+  ASSERT_OK_AND_ASSIGN(auto program, MakeProgram(*runtime, "x + 1"));
+
+  EvaluationConveyorOptions options;
+  options.worker_count = 2;
+  EvaluationConveyor conveyor(options);
+
+  std::vector<Activation> activations(16);
+  std::vector<std::future<absl::StatusOr<Value>>> futures;
+  for (int i = 0; i < 16; ++i) {
+    activations[i].InsertOrAssignValue("x", IntValue(i));
+    ASSERT_OK_AND_ASSIGN(auto future,
+                         conveyor.Submit(*program, activations[i]));
+    futures.push_back(std::move(future));
+  }
+
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_OK_AND_ASSIGN(Value result, futures[i].get());
+    ASSERT_TRUE(result->Is<IntValue>());
+    EXPECT_EQ(result.As<IntValue>().NativeValue(), i + 1);
+  }
+
+  EvaluationConveyorStats stats = conveyor.GetStats(*program);
+  EXPECT_EQ(stats.completed, 16);
+  EXPECT_EQ(stats.failed, 0);
+  EXPECT_EQ(stats.rejected, 0);
+}
+
+TEST(EvaluationConveyorTest, CelErrorsAreCompletedResults) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime());
+  ASSERT_OK_AND_ASSIGN(auto program, MakeProgram(*runtime, "1 / 0"));
+
+  EvaluationConveyor conveyor(EvaluationConveyorOptions{});
+  Activation activation;
+  ASSERT_OK_AND_ASSIGN(auto future, conveyor.Submit(*program, activation));
+
+  ASSERT_OK_AND_ASSIGN(Value result, future.get());
+  EXPECT_TRUE(result->Is<ErrorValue>());
+  EXPECT_EQ(conveyor.GetStats(*program).completed, 1);
+}
+
+TEST(EvaluationConveyorTest, BackpressureRejectsWhenQueueIsFull) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime());
+  ASSERT_OK_AND_ASSIGN(auto program, MakeProgram(*runtime, "1 + 1"));
+
+  EvaluationConveyorOptions options;
+  options.worker_count = 1;
+  options.max_queued_jobs = 0;
+  EvaluationConveyor conveyor(options);
+
+  Activation activation;
+  // With no queue capacity every submission is shed.
+  auto submitted = conveyor.Submit(*program, activation);
+  EXPECT_THAT(submitted.status(),
+              cel::internal::StatusIs(absl::StatusCode::kResourceExhausted));
+  EXPECT_EQ(conveyor.GetStats(*program).rejected, 1);
+}
+
+}  // namespace
+}  // namespace cel
@@ -0,0 +1,88 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/slot_activation.h"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include "absl/base/nullability.h"
+#include "absl/log/absl_check.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+
+namespace cel {
+
+size_t VariableBindingPlan::AssignSlot(absl::string_view name) {
+  if (auto it = slots_.find(name); it != slots_.end()) {
+    return it->second;
+  }
+  size_t slot = names_.size();
+  names_.push_back(std::string(name));
+  slots_.insert_or_assign(names_.back(), slot);
+  return slot;
+}
+
+absl::optional<size_t> VariableBindingPlan::FindSlot(
+    absl::string_view name) const {
+  if (auto it = slots_.find(name); it != slots_.end()) {
+    return it->second;
+  }
+  return absl::nullopt;
+}
+
+absl::StatusOr<bool> SlotActivation::FindVariable(ValueManager& factory,
+                                                  absl::string_view name,
+                                                  Value& result) const {
+  absl::optional<size_t> slot = plan_->FindSlot(name);
+  if (!slot.has_value() || !slots_[*slot].has_value()) {
+    return false;
+  }
+  result = *slots_[*slot];
+  return true;
+}
+
+void SlotActivation::BindSlot(size_t slot, Value value) {
+  ABSL_DCHECK_LT(slot, slots_.size());
+  slots_[slot] = std::move(value);
+}
+
+bool SlotActivation::Bind(absl::string_view name, Value value) {
+  absl::optional<size_t> slot = plan_->FindSlot(name);
+  if (!slot.has_value()) {
+    return false;
+  }
+  BindSlot(*slot, std::move(value));
+  return true;
+}
+
+absl::Nullable<const Value*> SlotActivation::GetSlot(size_t slot) const {
+  ABSL_DCHECK_LT(slot, slots_.size());
+  if (!slots_[slot].has_value()) {
+    return nullptr;
+  }
+  return &*slots_[slot];
+}
+
+void SlotActivation::ClearSlots() {
+  for (auto& slot : slots_) {
+    slot.reset();
+  }
+}
+
+}  // namespace cel
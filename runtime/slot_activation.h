@@ -0,0 +1,152 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_SLOT_ACTIVATION_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_SLOT_ACTIVATION_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "base/attribute.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "runtime/activation_interface.h"
+#include "runtime/function_overload_reference.h"
+
+namespace cel {
+
+// Dense slot assignment for the identifiers referenced by a planned
+// expression.
+//
+// The planner assigns each distinct identifier a slot index in order of first
+// use while building the execution plan, then the plan is shared (immutably)
+// between the planned expression and any number of `SlotActivation` instances
+// bound against it. Ident steps that carry a slot index resolve variables
+// with an array read instead of a per-access hash lookup.
+class VariableBindingPlan final {
+ public:
+  VariableBindingPlan() = default;
+
+  // Not copyable or movable: planned steps and activations hold pointers to
+  // an agreed-upon instance.
+  VariableBindingPlan(const VariableBindingPlan&) = delete;
+  VariableBindingPlan& operator=(const VariableBindingPlan&) = delete;
+
+  // Returns the slot for name, assigning the next free slot on first use.
+  //
+  // Intended for use by the planner while building an expression; the plan
+  // must not be mutated once an activation or planned expression refers to
+  // it.
+  size_t AssignSlot(absl::string_view name);
+
+  // Returns the slot assigned to name, if any.
+  absl::optional<size_t> FindSlot(absl::string_view name) const;
+
+  // Number of assigned slots.
+  size_t slot_count() const { return names_.size(); }
+
+  // Identifier names in slot order.
+  absl::Span<const std::string> names() const { return names_; }
+
+ private:
+  std::vector<std::string> names_;
+  absl::flat_hash_map<std::string, size_t> slots_;
+};
+
+// Activation resolving variables by precomputed slot index.
+//
+// The name -> slot mapping is built once (by the planner or from a plan
+// constructed up front); callers then write values by slot or by name and
+// reuse the activation across evaluations via ClearSlots(). Planned ident
+// steps that share this activation's plan bypass FindVariable entirely and
+// read the slot array directly.
+//
+// Thread-compatible: like Activation, concurrent use requires external
+// synchronization if values are mutated.
+class SlotActivation final : public ActivationInterface {
+ public:
+  explicit SlotActivation(std::shared_ptr<const VariableBindingPlan> plan)
+      : plan_(std::move(plan)), slots_(plan_->slot_count()) {}
+
+  // Move only.
+  SlotActivation(SlotActivation&&) = default;
+  SlotActivation& operator=(SlotActivation&&) = default;
+
+  // Implements ActivationInterface.
+  absl::StatusOr<bool> FindVariable(ValueManager& factory,
+                                    absl::string_view name,
+                                    Value& result) const override;
+  using ActivationInterface::FindVariable;
+
+  std::vector<FunctionOverloadReference> FindFunctionOverloads(
+      absl::string_view name) const override {
+    return {};
+  }
+
+  absl::Span<const cel::AttributePattern> GetUnknownAttributes()
+      const override {
+    return unknown_patterns_;
+  }
+
+  absl::Span<const cel::AttributePattern> GetMissingAttributes()
+      const override {
+    return missing_patterns_;
+  }
+
+  absl::Nullable<const SlotActivation*> AsSlotActivation() const override {
+    return this;
+  }
+
+  const VariableBindingPlan& plan() const { return *plan_; }
+
+  // Bind a value to the given slot. Slot must be within the plan's range.
+  void BindSlot(size_t slot, Value value);
+
+  // Bind a value by name. Returns false if the plan has no slot for name.
+  bool Bind(absl::string_view name, Value value);
+
+  // Returns the value bound to slot, or nullptr if the slot is unbound.
+  absl::Nullable<const Value*> GetSlot(size_t slot) const;
+
+  // Unbind all slots, retaining the slot storage for reuse.
+  void ClearSlots();
+
+  void SetUnknownPatterns(std::vector<cel::AttributePattern> patterns) {
+    unknown_patterns_ = std::move(patterns);
+  }
+
+  void SetMissingPatterns(std::vector<cel::AttributePattern> patterns) {
+    missing_patterns_ = std::move(patterns);
+  }
+
+ private:
+  std::shared_ptr<const VariableBindingPlan> plan_;
+  std::vector<absl::optional<Value>> slots_;
+
+  std::vector<cel::AttributePattern> unknown_patterns_;
+  std::vector<cel::AttributePattern> missing_patterns_;
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_SLOT_ACTIVATION_H_
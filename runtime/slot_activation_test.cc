@@ -0,0 +1,119 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/slot_activation.h"
+
+#include <memory>
+
+#include "absl/types/optional.h"
+#include "base/type_provider.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "common/values/legacy_value_manager.h"
+#include "internal/testing.h"
+
+namespace cel {
+namespace {
+
+using testing::ElementsAre;
+using testing::Eq;
+using testing::Optional;
+using cel::internal::IsOkAndHolds;
+
+class SlotActivationTest : public testing::Test {
+ public:
+  SlotActivationTest()
+      : value_factory_(MemoryManagerRef::ReferenceCounting(),
+                       TypeProvider::Builtin()) {}
+
+ protected:
+  common_internal::LegacyValueManager value_factory_;
+};
+
+TEST_F(SlotActivationTest, PlanAssignsDenseSlotsInFirstUseOrder) {
+  VariableBindingPlan plan;
+
+  EXPECT_EQ(plan.AssignSlot("a"), 0);
+  EXPECT_EQ(plan.AssignSlot("b"), 1);
+  // Repeated assignment returns the existing slot.
+  EXPECT_EQ(plan.AssignSlot("a"), 0);
+  EXPECT_EQ(plan.AssignSlot("c"), 2);
+
+  EXPECT_EQ(plan.slot_count(), 3);
+  EXPECT_THAT(plan.names(), ElementsAre("a", "b", "c"));
+  EXPECT_THAT(plan.FindSlot("b"), Optional(Eq(1)));
+  EXPECT_EQ(plan.FindSlot("unknown"), absl::nullopt);
+}
+
+TEST_F(SlotActivationTest, BindByNameAndSlot) {
+  auto plan = std::make_shared<VariableBindingPlan>();
+  plan->AssignSlot("a");
+  plan->AssignSlot("b");
+
+  SlotActivation activation(plan);
+  EXPECT_TRUE(activation.Bind("a", value_factory_.CreateIntValue(1)));
+  activation.BindSlot(1, value_factory_.CreateIntValue(2));
+  EXPECT_FALSE(activation.Bind("unknown", value_factory_.CreateIntValue(3)));
+
+  ASSERT_NE(activation.GetSlot(0), nullptr);
+  EXPECT_EQ(activation.GetSlot(0)->As<IntValue>().NativeValue(), 1);
+  ASSERT_NE(activation.GetSlot(1), nullptr);
+  EXPECT_EQ(activation.GetSlot(1)->As<IntValue>().NativeValue(), 2);
+}
+
+TEST_F(SlotActivationTest, FindVariableResolvesThroughPlan) {
+  auto plan = std::make_shared<VariableBindingPlan>();
+  plan->AssignSlot("a");
+  plan->AssignSlot("b");
+
+  SlotActivation activation(plan);
+  activation.BindSlot(0, value_factory_.CreateIntValue(42));
+
+  Value result;
+  EXPECT_THAT(activation.FindVariable(value_factory_, "a", result),
+              IsOkAndHolds(true));
+  EXPECT_EQ(result.As<IntValue>().NativeValue(), 42);
+  // Declared but unbound slots behave as absent.
+  EXPECT_THAT(activation.FindVariable(value_factory_, "b", result),
+              IsOkAndHolds(false));
+  EXPECT_THAT(activation.FindVariable(value_factory_, "unknown", result),
+              IsOkAndHolds(false));
+}
+
+TEST_F(SlotActivationTest, ClearSlotsRetainsPlan) {
+  auto plan = std::make_shared<VariableBindingPlan>();
+  plan->AssignSlot("a");
+
+  SlotActivation activation(plan);
+  activation.BindSlot(0, value_factory_.CreateIntValue(1));
+  activation.ClearSlots();
+
+  EXPECT_EQ(activation.GetSlot(0), nullptr);
+  EXPECT_EQ(&activation.plan(), plan.get());
+  // Rebinding after a clear works without rebuilding the activation.
+  activation.BindSlot(0, value_factory_.CreateIntValue(2));
+  ASSERT_NE(activation.GetSlot(0), nullptr);
+  EXPECT_EQ(activation.GetSlot(0)->As<IntValue>().NativeValue(), 2);
+}
+
+TEST_F(SlotActivationTest, AsSlotActivationIdentity) {
+  auto plan = std::make_shared<VariableBindingPlan>();
+  SlotActivation activation(plan);
+
+  const ActivationInterface& interface = activation;
+  EXPECT_EQ(interface.AsSlotActivation(), &activation);
+}
+
+}  // namespace
+}  // namespace cel
@@ -16,6 +16,7 @@
 
 #include <limits>
 
+#include "absl/base/optimization.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
 #include "base/builtins.h"
@@ -34,20 +35,22 @@ Value Add(ValueManager&, Type v0, Type v1);
 
 template <>
 Value Add<int64_t>(ValueManager& value_factory, int64_t v0, int64_t v1) {
-  auto sum = cel::internal::CheckedAdd(v0, v1);
-  if (!sum.ok()) {
-    return value_factory.CreateErrorValue(sum.status());
+  int64_t sum;
+  if (ABSL_PREDICT_FALSE(cel::internal::AddOverflow(v0, v1, &sum))) {
+    return value_factory.CreateErrorValue(
+        cel::internal::IntegerOverflowError());
   }
-  return value_factory.CreateIntValue(*sum);
+  return value_factory.CreateIntValue(sum);
 }
 
 template <>
 Value Add<uint64_t>(ValueManager& value_factory, uint64_t v0, uint64_t v1) {
-  auto sum = cel::internal::CheckedAdd(v0, v1);
-  if (!sum.ok()) {
-    return value_factory.CreateErrorValue(sum.status());
+  uint64_t sum;
+  if (ABSL_PREDICT_FALSE(cel::internal::AddOverflow(v0, v1, &sum))) {
+    return value_factory.CreateErrorValue(
+        cel::internal::UnsignedIntegerOverflowError());
   }
-  return value_factory.CreateUintValue(*sum);
+  return value_factory.CreateUintValue(sum);
 }
 
 template <>
@@ -60,20 +63,22 @@ Value Sub(ValueManager&, Type v0, Type v1);
 
 template <>
 Value Sub<int64_t>(ValueManager& value_factory, int64_t v0, int64_t v1) {
-  auto diff = cel::internal::CheckedSub(v0, v1);
-  if (!diff.ok()) {
-    return value_factory.CreateErrorValue(diff.status());
+  int64_t diff;
+  if (ABSL_PREDICT_FALSE(cel::internal::SubOverflow(v0, v1, &diff))) {
+    return value_factory.CreateErrorValue(
+        cel::internal::IntegerOverflowError());
   }
-  return value_factory.CreateIntValue(*diff);
+  return value_factory.CreateIntValue(diff);
 }
 
 template <>
 Value Sub<uint64_t>(ValueManager& value_factory, uint64_t v0, uint64_t v1) {
-  auto diff = cel::internal::CheckedSub(v0, v1);
-  if (!diff.ok()) {
-    return value_factory.CreateErrorValue(diff.status());
+  uint64_t diff;
+  if (ABSL_PREDICT_FALSE(cel::internal::SubOverflow(v0, v1, &diff))) {
+    return value_factory.CreateErrorValue(
+        cel::internal::UnsignedIntegerOverflowError());
   }
-  return value_factory.CreateUintValue(*diff);
+  return value_factory.CreateUintValue(diff);
 }
 
 template <>
@@ -86,20 +91,22 @@ Value Mul(ValueManager&, Type v0, Type v1);
 
 template <>
 Value Mul<int64_t>(ValueManager& value_factory, int64_t v0, int64_t v1) {
-  auto prod = cel::internal::CheckedMul(v0, v1);
-  if (!prod.ok()) {
-    return value_factory.CreateErrorValue(prod.status());
+  int64_t prod;
+  if (ABSL_PREDICT_FALSE(cel::internal::MulOverflow(v0, v1, &prod))) {
+    return value_factory.CreateErrorValue(
+        cel::internal::IntegerOverflowError());
   }
-  return value_factory.CreateIntValue(*prod);
+  return value_factory.CreateIntValue(prod);
 }
 
 template <>
 Value Mul<uint64_t>(ValueManager& value_factory, uint64_t v0, uint64_t v1) {
-  auto prod = cel::internal::CheckedMul(v0, v1);
-  if (!prod.ok()) {
-    return value_factory.CreateErrorValue(prod.status());
+  uint64_t prod;
+  if (ABSL_PREDICT_FALSE(cel::internal::MulOverflow(v0, v1, &prod))) {
+    return value_factory.CreateErrorValue(
+        cel::internal::UnsignedIntegerOverflowError());
   }
-  return value_factory.CreateUintValue(*prod);
+  return value_factory.CreateUintValue(prod);
 }
 
 template <>
@@ -214,11 +221,13 @@ absl::Status RegisterArithmeticFunctions(FunctionRegistry& registry,
                                                              false),
       UnaryFunctionAdapter<Value, int64_t>::WrapFunction(
           [](ValueManager& value_factory, int64_t value) -> Value {
-            auto inv = cel::internal::CheckedNegation(value);
-            if (!inv.ok()) {
-              return value_factory.CreateErrorValue(inv.status());
+            int64_t inv;
+            if (ABSL_PREDICT_FALSE(
+                    cel::internal::NegationOverflow(value, &inv))) {
+              return value_factory.CreateErrorValue(
+                  cel::internal::IntegerOverflowError());
             }
-            return value_factory.CreateIntValue(*inv);
+            return value_factory.CreateIntValue(inv);
           })));
 
   return registry.Register(
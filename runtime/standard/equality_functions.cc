@@ -68,6 +68,24 @@ struct HeterogeneousEqualProvider {
                                                   const Value& rhs) const;
 };
 
+// String equality with a pointer-identity fast path.
+//
+// Interned strings (ValueFactory::InternStringValue) and copies of one value
+// share storage, so equal data pointers prove equality without touching the
+// bytes. Falls back to byte comparison for distinct or non-flat storage.
+bool StringValueEquals(const StringValue& lhs, const StringValue& rhs) {
+  absl::optional<absl::string_view> lhs_flat = lhs.TryFlat();
+  absl::optional<absl::string_view> rhs_flat = rhs.TryFlat();
+  if (lhs_flat.has_value() && rhs_flat.has_value()) {
+    if (lhs_flat->data() == rhs_flat->data() &&
+        lhs_flat->size() == rhs_flat->size()) {
+      return true;
+    }
+    return *lhs_flat == *rhs_flat;
+  }
+  return lhs.Equals(rhs);
+}
+
 // Comparison template functions
 template <class Type>
 absl::optional<bool> Inequal(Type lhs, Type rhs) {
@@ -76,7 +94,7 @@ absl::optional<bool> Inequal(Type lhs, Type rhs) {
 
 template <>
 absl::optional<bool> Inequal(const StringValue& lhs, const StringValue& rhs) {
-  return !lhs.Equals(rhs);
+  return !StringValueEquals(lhs, rhs);
 }
 
 template <>
@@ -101,7 +119,7 @@ absl::optional<bool> Equal(Type lhs, Type rhs) {
 
 template <>
 absl::optional<bool> Equal(const StringValue& lhs, const StringValue& rhs) {
-  return lhs.Equals(rhs);
+  return StringValueEquals(lhs, rhs);
 }
 
 template <>
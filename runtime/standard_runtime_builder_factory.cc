@@ -14,8 +14,15 @@
 
 #include "runtime/standard_runtime_builder_factory.h"
 
+#include <memory>
+#include <utility>
+
+#include "absl/base/no_destructor.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "internal/status_macros.h"
+#include "runtime/function_registry.h"
 #include "runtime/runtime_builder.h"
 #include "runtime/runtime_builder_factory.h"
 #include "runtime/runtime_options.h"
@@ -23,12 +30,100 @@
 
 namespace cel {
 
+namespace {
+
+// The RuntimeOptions fields that change which standard functions are
+// registered or how they behave. Snapshots are cached per combination; all
+// fields but the regex program size limit are booleans, so the cache stays
+// small in practice.
+struct StandardFunctionsOptionsKey {
+  bool enable_regex;
+  int regex_max_program_size;
+  bool enable_string_concat;
+  bool enable_string_conversion;
+  bool enable_list_concat;
+  bool enable_list_contains;
+  bool enable_heterogeneous_equality;
+  bool enable_timestamp_duration_overflow_errors;
+
+  static StandardFunctionsOptionsKey FromOptions(
+      const RuntimeOptions& options) {
+    return {options.enable_regex,
+            options.regex_max_program_size,
+            options.enable_string_concat,
+            options.enable_string_conversion,
+            options.enable_list_concat,
+            options.enable_list_contains,
+            options.enable_heterogeneous_equality,
+            options.enable_timestamp_duration_overflow_errors};
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const StandardFunctionsOptionsKey& key) {
+    return H::combine(std::move(h), key.enable_regex,
+                      key.regex_max_program_size, key.enable_string_concat,
+                      key.enable_string_conversion, key.enable_list_concat,
+                      key.enable_list_contains,
+                      key.enable_heterogeneous_equality,
+                      key.enable_timestamp_duration_overflow_errors);
+  }
+
+  friend bool operator==(const StandardFunctionsOptionsKey& lhs,
+                         const StandardFunctionsOptionsKey& rhs) {
+    return lhs.enable_regex == rhs.enable_regex &&
+           lhs.regex_max_program_size == rhs.regex_max_program_size &&
+           lhs.enable_string_concat == rhs.enable_string_concat &&
+           lhs.enable_string_conversion == rhs.enable_string_conversion &&
+           lhs.enable_list_concat == rhs.enable_list_concat &&
+           lhs.enable_list_contains == rhs.enable_list_contains &&
+           lhs.enable_heterogeneous_equality ==
+               rhs.enable_heterogeneous_equality &&
+           lhs.enable_timestamp_duration_overflow_errors ==
+               rhs.enable_timestamp_duration_overflow_errors;
+  }
+};
+
+// Returns a process-lifetime snapshot of the standard library registrations
+// for the given options, building it on first use. Builders start from a
+// clone of the snapshot instead of re-running every standard registration
+// (descriptor construction, overload validation and adapter allocation) on
+// each process start or test.
+absl::StatusOr<const FunctionRegistry*> GetStandardFunctionsSnapshot(
+    const RuntimeOptions& options) {
+  static absl::NoDestructor<absl::Mutex> mutex;
+  static absl::NoDestructor<absl::flat_hash_map<
+      StandardFunctionsOptionsKey, std::unique_ptr<const FunctionRegistry>>>
+      snapshots;
+
+  StandardFunctionsOptionsKey key =
+      StandardFunctionsOptionsKey::FromOptions(options);
+  {
+    absl::MutexLock lock(&*mutex);
+    auto it = snapshots->find(key);
+    if (it != snapshots->end()) {
+      return it->second.get();
+    }
+  }
+
+  // Built outside the lock; a concurrent first use for the same key loses the
+  // try_emplace below and its copy is discarded.
+  auto registry = std::make_unique<FunctionRegistry>();
+  CEL_RETURN_IF_ERROR(RegisterStandardFunctions(*registry, options));
+
+  absl::MutexLock lock(&*mutex);
+  auto [it, inserted] = snapshots->try_emplace(key, std::move(registry));
+  return it->second.get();
+}
+
+}  // namespace
+
 absl::StatusOr<RuntimeBuilder> CreateStandardRuntimeBuilder(
     const RuntimeOptions& options) {
   RuntimeBuilder result = CreateRuntimeBuilder(options);
 
-  CEL_RETURN_IF_ERROR(
-      RegisterStandardFunctions(result.function_registry(), options));
+  CEL_ASSIGN_OR_RETURN(const FunctionRegistry* standard,
+                       GetStandardFunctionsSnapshot(options));
+  result.function_registry() = standard->Clone();
 
   return result;
 }
@@ -128,6 +128,39 @@ TEST_P(StandardRuntimeTest, Defaults) {
       << test_case.expression;
 }
 
+TEST_P(StandardRuntimeTest, Warmup) {
+  RuntimeOptions opts;
+  const EvaluateResultTestCase& test_case = GetTestCase();
+
+  ASSERT_OK_AND_ASSIGN(auto builder, CreateStandardRuntimeBuilder(opts));
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr expr,
+                       ParseWithTestMacros(test_case.expression));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  common_internal::LegacyValueManager value_factory(memory_manager(),
+                                                    runtime->GetTypeProvider());
+
+  Activation activation;
+  if (test_case.activation_builder != nullptr) {
+    ASSERT_OK(test_case.activation_builder(value_factory, activation));
+  }
+
+  ASSERT_OK(program->Warmup());
+  ASSERT_OK(program->Warmup(activation, value_factory));
+
+  // Warmup must not disturb subsequent evaluations.
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       program->Evaluate(activation, value_factory));
+
+  EXPECT_THAT(result, BoolValueIs(test_case.expected_result))
+      << test_case.expression;
+}
+
 TEST_P(StandardRuntimeTest, Recursive) {
   RuntimeOptions opts;
   opts.max_recursion_depth = -1;
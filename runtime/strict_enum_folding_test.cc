@@ -0,0 +1,122 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <utility>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+
+namespace cel {
+namespace {
+
+using ::google::api::expr::v1alpha1::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+using ::cel::extensions::ProtobufRuntimeAdapter;
+using testing::HasSubstr;
+using cel::internal::StatusIs;
+
+class StrictEnumFoldingTest : public testing::Test {
+ protected:
+  absl::StatusOr<std::unique_ptr<Program>> Plan(absl::string_view expression,
+                                                bool strict) {
+    RuntimeOptions options;
+    options.container = "com.example";
+    options.enable_strict_enum_constant_folding = strict;
+    CEL_ASSIGN_OR_RETURN(RuntimeBuilder builder,
+                         CreateStandardRuntimeBuilder(options));
+    builder.type_registry().RegisterEnum("com.example.Severity",
+                                         {{"LOW", 1}, {"HIGH", 2}});
+    CEL_ASSIGN_OR_RETURN(runtime_, std::move(builder).Build());
+
+    CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+    return ProtobufRuntimeAdapter::CreateProgram(*runtime_, parsed_expr);
+  }
+
+  std::unique_ptr<const Runtime> runtime_;
+};
+
+TEST_F(StrictEnumFoldingTest, EnumConstantEvaluates) {
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       Plan("Severity.HIGH == 2", /*strict=*/true));
+
+  ManagedValueFactory value_factory(program->GetTypeProvider(),
+                                    MemoryManagerRef::ReferenceCounting());
+  Activation activation;
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       program->Evaluate(activation, value_factory.get()));
+  ASSERT_TRUE(result->Is<BoolValue>());
+  EXPECT_TRUE(result->As<BoolValue>().NativeValue());
+}
+
+TEST_F(StrictEnumFoldingTest, EnumConstantNotShadowable) {
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       Plan("Severity.HIGH == 2", /*strict=*/true));
+
+  ManagedValueFactory value_factory(program->GetTypeProvider(),
+                                    MemoryManagerRef::ReferenceCounting());
+  Activation activation;
+  // With strict folding the enum compiled into a constant step, so the
+  // activation binding is ignored.
+  activation.InsertOrAssignValue("Severity.HIGH",
+                                 value_factory.get().CreateIntValue(-1));
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       program->Evaluate(activation, value_factory.get()));
+  ASSERT_TRUE(result->Is<BoolValue>());
+  EXPECT_TRUE(result->As<BoolValue>().NativeValue());
+}
+
+TEST_F(StrictEnumFoldingTest, DefaultKeepsShadowing) {
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       Plan("Severity.HIGH == 2", /*strict=*/false));
+
+  ManagedValueFactory value_factory(program->GetTypeProvider(),
+                                    MemoryManagerRef::ReferenceCounting());
+  Activation activation;
+  activation.InsertOrAssignValue("Severity.HIGH",
+                                 value_factory.get().CreateIntValue(-1));
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       program->Evaluate(activation, value_factory.get()));
+  ASSERT_TRUE(result->Is<BoolValue>());
+  EXPECT_FALSE(result->As<BoolValue>().NativeValue());
+}
+
+TEST_F(StrictEnumFoldingTest, UndefinedEnumeratorFailsPlanning) {
+  EXPECT_THAT(Plan("Severity.CRITICAL == 3", /*strict=*/true).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("undefined value")));
+}
+
+TEST_F(StrictEnumFoldingTest, UndefinedEnumeratorDefersByDefault) {
+  // Without strict folding, the undefined enumerator plans as an identifier
+  // resolved per evaluation.
+  EXPECT_OK(Plan("Severity.CRITICAL == 3", /*strict=*/false).status());
+}
+
+}  // namespace
+}  // namespace cel
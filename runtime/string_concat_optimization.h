@@ -0,0 +1,34 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_STRING_CONCAT_OPTIMIZATION_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_STRING_CONCAT_OPTIMIZATION_H_
+
+#include "absl/status/status.h"
+#include "runtime/runtime_builder.h"
+
+namespace cel::extensions {
+
+// Enable collapsing of string concatenation chains in the runtime being
+// built.
+//
+// Chains of `+` that are known (checked expressions) or safely assumed
+// (parse-only expressions anchored by a string constant) to be string
+// concatenations are planned as one n-ary join that sizes the result once,
+// instead of one pairwise call — and one intermediate string — per `+`.
+absl::Status EnableStringConcatOptimization(RuntimeBuilder& builder);
+
+}  // namespace cel::extensions
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_STRING_CONCAT_OPTIMIZATION_H_
@@ -0,0 +1,102 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/string_concat_optimization.h"
+
+#include <utility>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+
+namespace cel {
+namespace {
+
+using ::google::api::expr::v1alpha1::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+using ::cel::extensions::ProtobufRuntimeAdapter;
+
+class StringConcatOptimizationTest : public testing::Test {
+ protected:
+  absl::StatusOr<Value> Evaluate(absl::string_view expression) {
+    RuntimeOptions options;
+    CEL_ASSIGN_OR_RETURN(RuntimeBuilder builder,
+                         CreateStandardRuntimeBuilder(options));
+    CEL_RETURN_IF_ERROR(extensions::EnableStringConcatOptimization(builder));
+    CEL_ASSIGN_OR_RETURN(auto runtime, std::move(builder).Build());
+
+    CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+    CEL_ASSIGN_OR_RETURN(auto program, ProtobufRuntimeAdapter::CreateProgram(
+                                           *runtime, parsed_expr));
+
+    ManagedValueFactory value_factory(program->GetTypeProvider(),
+                                      MemoryManagerRef::ReferenceCounting());
+    Activation activation;
+    activation.InsertOrAssignValue(
+        "s", value_factory.get().CreateUncheckedStringValue("x"));
+    activation.InsertOrAssignValue("i",
+                                   value_factory.get().CreateIntValue(2));
+
+    return program->Evaluate(activation, value_factory.get());
+  }
+};
+
+TEST_F(StringConcatOptimizationTest, ChainJoins) {
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       Evaluate(R"cel('a ' + s + ' b ' + s + ' c')cel"));
+  ASSERT_TRUE(result->Is<StringValue>());
+  EXPECT_EQ(result->As<StringValue>().ToString(), "a x b x c");
+}
+
+TEST_F(StringConcatOptimizationTest, NestedChainJoins) {
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       Evaluate(R"cel('a' + ('b' + s) + 'c')cel"));
+  ASSERT_TRUE(result->Is<StringValue>());
+  EXPECT_EQ(result->As<StringValue>().ToString(), "abxc");
+}
+
+TEST_F(StringConcatOptimizationTest, NonStringOperandErrors) {
+  ASSERT_OK_AND_ASSIGN(Value result, Evaluate(R"cel('a' + s + 'b' + i)cel"));
+  ASSERT_TRUE(result->Is<ErrorValue>());
+  EXPECT_TRUE(absl::StrContains(
+      result->As<ErrorValue>().NativeValue().message(),
+      "No matching overloads found"));
+}
+
+TEST_F(StringConcatOptimizationTest, ErroringOperandPropagates) {
+  // `e` is not bound in the activation.
+  ASSERT_OK_AND_ASSIGN(Value result, Evaluate(R"cel('a' + e + 'b' + s)cel"));
+  EXPECT_TRUE(result->Is<ErrorValue>());
+}
+
+TEST_F(StringConcatOptimizationTest, NonStringChainUnchanged) {
+  ASSERT_OK_AND_ASSIGN(Value result, Evaluate(R"cel(i + i + i)cel"));
+  ASSERT_TRUE(result->Is<IntValue>());
+  EXPECT_EQ(result->As<IntValue>().NativeValue(), 6);
+}
+
+}  // namespace
+}  // namespace cel
@@ -0,0 +1,38 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_SUBEXPRESSION_ELIMINATION_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_SUBEXPRESSION_ELIMINATION_H_
+
+#include "absl/status/status.h"
+#include "runtime/runtime_builder.h"
+
+namespace cel {
+
+// Enables common subexpression elimination in the runtime being built.
+//
+// Attribute-style subexpressions (chains of field selections and index
+// operations, e.g. `request.auth.claims["groups"]`) that occur more than once
+// in an expression are hoisted into hidden lazily-initialized aliases, so
+// each is planned once and evaluated at most once per evaluation.
+//
+// Subexpressions containing function calls other than the index operator are
+// never hoisted, since user functions may have observable side effects.
+// Requires comprehension support to be enabled in the runtime options. If
+// reference resolution is in use it should be enabled before this.
+absl::Status EnableSubexpressionElimination(RuntimeBuilder& builder);
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_SUBEXPRESSION_ELIMINATION_H_
@@ -0,0 +1,93 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/subexpression_elimination.h"
+
+#include <utility>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+
+namespace cel {
+namespace {
+
+using ::google::api::expr::v1alpha1::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+using ::cel::extensions::ProtobufRuntimeAdapter;
+
+class SubexpressionEliminationTest : public testing::Test {
+ protected:
+  absl::StatusOr<Value> Evaluate(absl::string_view expression) {
+    RuntimeOptions options;
+    CEL_ASSIGN_OR_RETURN(RuntimeBuilder builder,
+                         CreateStandardRuntimeBuilder(options));
+    CEL_RETURN_IF_ERROR(EnableSubexpressionElimination(builder));
+    CEL_ASSIGN_OR_RETURN(auto runtime, std::move(builder).Build());
+
+    CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+    CEL_ASSIGN_OR_RETURN(auto program, ProtobufRuntimeAdapter::CreateProgram(
+                                           *runtime, parsed_expr));
+
+    ManagedValueFactory value_factory(program->GetTypeProvider(),
+                                      MemoryManagerRef::ReferenceCounting());
+    Activation activation;
+    CEL_ASSIGN_OR_RETURN(auto builder_or, value_factory.get().NewMapValueBuilder(
+                                              value_factory.get().GetDynDynMapType()));
+    CEL_RETURN_IF_ERROR(builder_or->Put(
+        value_factory.get().CreateUncheckedStringValue("a"),
+        value_factory.get().CreateIntValue(21)));
+    activation.InsertOrAssignValue("m", std::move(*builder_or).Build());
+
+    return program->Evaluate(activation, value_factory.get());
+  }
+};
+
+TEST_F(SubexpressionEliminationTest, RepeatedChainEvaluates) {
+  ASSERT_OK_AND_ASSIGN(Value result, Evaluate(R"cel(m["a"] + m["a"] == 42)cel"));
+  ASSERT_TRUE(result->Is<BoolValue>());
+  EXPECT_TRUE(result->As<BoolValue>().NativeValue());
+}
+
+TEST_F(SubexpressionEliminationTest, RepeatedChainInComprehension) {
+  ASSERT_OK_AND_ASSIGN(
+      Value result,
+      Evaluate(R"cel([1, 2].map(x, x + m["a"])[0] + m["a"] == 43)cel"));
+  ASSERT_TRUE(result->Is<BoolValue>());
+  EXPECT_TRUE(result->As<BoolValue>().NativeValue());
+}
+
+TEST_F(SubexpressionEliminationTest, UnusedAliasNotEvaluated) {
+  // `e` is not bound in the activation; the hoisted alias must stay
+  // uninitialized behind the short-circuited branch.
+  ASSERT_OK_AND_ASSIGN(
+      Value result,
+      Evaluate(R"cel(false && (e.f.g == 1 || e.f.g == 2))cel"));
+  ASSERT_TRUE(result->Is<BoolValue>());
+  EXPECT_FALSE(result->As<BoolValue>().NativeValue());
+}
+
+}  // namespace
+}  // namespace cel
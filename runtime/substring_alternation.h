@@ -0,0 +1,34 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_SUBSTRING_ALTERNATION_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_SUBSTRING_ALTERNATION_H_
+
+#include "absl/status/status.h"
+#include "runtime/runtime_builder.h"
+
+namespace cel::extensions {
+
+// Enable lowering of contains() / startsWith() disjunction chains in the
+// runtime being built.
+//
+// Disjunctions of standard 'contains' or 'startsWith' calls with constant
+// literals on the same operand (`x.contains(s1) || x.contains(s2) || ...`)
+// are rewritten into a single Aho-Corasick scan of the subject instead of one
+// scan per literal.
+absl::Status EnableSubstringAlternationOptimization(RuntimeBuilder& builder);
+
+}  // namespace cel::extensions
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_SUBSTRING_ALTERNATION_H_
@@ -0,0 +1,35 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_TIME_WINDOW_OPTIMIZATION_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_TIME_WINDOW_OPTIMIZATION_H_
+
+#include "absl/status/status.h"
+#include "runtime/runtime_builder.h"
+
+namespace cel::extensions {
+
+// Enable fusing of time window checks in the runtime being built.
+//
+// Comparisons of the shape `(t1 - t2) op d` in checked expressions, where
+// the checker resolved the subtraction to timestamps and the comparison to
+// durations, are planned as one fused step working on the native time
+// representations with a single range check, instead of a checked
+// subtraction materializing an intermediate duration followed by a
+// dispatched comparison. Parse-only expressions are unaffected.
+absl::Status EnableTimeWindowOptimization(RuntimeBuilder& builder);
+
+}  // namespace cel::extensions
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_TIME_WINDOW_OPTIMIZATION_H_
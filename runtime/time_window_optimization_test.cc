@@ -0,0 +1,222 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/time_window_optimization.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "google/api/expr/v1alpha1/checked.pb.h"
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "google/protobuf/text_format.h"
+
+namespace cel {
+namespace {
+
+using ::cel::extensions::ProtobufRuntimeAdapter;
+using ::google::api::expr::v1alpha1::CheckedExpr;
+using ::google::api::expr::v1alpha1::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+
+// t1 - t2 < d, with checker-resolved overloads.
+constexpr absl::string_view kLessExpression = R"pb(
+  reference_map: {
+    key: 3
+    value: { overload_id: "subtract_timestamp_timestamp" }
+  }
+  reference_map: {
+    key: 5
+    value: { overload_id: "less_duration" }
+  }
+  expr: {
+    id: 5
+    call_expr: {
+      function: "_<_"
+      args: {
+        id: 3
+        call_expr: {
+          function: "_-_"
+          args: {
+            id: 1
+            ident_expr: { name: "t1" }
+          }
+          args: {
+            id: 2
+            ident_expr: { name: "t2" }
+          }
+        }
+      }
+      args: {
+        id: 4
+        ident_expr: { name: "d" }
+      }
+    }
+  })pb";
+
+// t1 - t2 >= d, with checker-resolved overloads.
+constexpr absl::string_view kGreaterEqualExpression = R"pb(
+  reference_map: {
+    key: 3
+    value: { overload_id: "subtract_timestamp_timestamp" }
+  }
+  reference_map: {
+    key: 5
+    value: { overload_id: "greater_equals_duration" }
+  }
+  expr: {
+    id: 5
+    call_expr: {
+      function: "_>=_"
+      args: {
+        id: 3
+        call_expr: {
+          function: "_-_"
+          args: {
+            id: 1
+            ident_expr: { name: "t1" }
+          }
+          args: {
+            id: 2
+            ident_expr: { name: "t2" }
+          }
+        }
+      }
+      args: {
+        id: 4
+        ident_expr: { name: "d" }
+      }
+    }
+  })pb";
+
+class TimeWindowOptimizationTest : public testing::Test {
+ protected:
+  absl::StatusOr<Value> EvaluateChecked(absl::string_view checked_textproto,
+                                        absl::Time t1, absl::Time t2,
+                                        absl::Duration d) {
+    CheckedExpr checked_expr;
+    if (!google::protobuf::TextFormat::ParseFromString(checked_textproto,
+                                             &checked_expr)) {
+      return absl::InternalError("failed to parse test expression");
+    }
+    CEL_ASSIGN_OR_RETURN(auto runtime, MakeRuntime());
+    CEL_ASSIGN_OR_RETURN(auto program, ProtobufRuntimeAdapter::CreateProgram(
+                                           *runtime, checked_expr));
+    return Evaluate(*program, t1, t2, d);
+  }
+
+  absl::StatusOr<Value> EvaluateParsed(absl::string_view expression,
+                                       absl::Time t1, absl::Time t2,
+                                       absl::Duration d) {
+    CEL_ASSIGN_OR_RETURN(auto runtime, MakeRuntime());
+    CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+    CEL_ASSIGN_OR_RETURN(auto program, ProtobufRuntimeAdapter::CreateProgram(
+                                           *runtime, parsed_expr));
+    return Evaluate(*program, t1, t2, d);
+  }
+
+ private:
+  absl::StatusOr<std::unique_ptr<const Runtime>> MakeRuntime() {
+    RuntimeOptions options;
+    CEL_ASSIGN_OR_RETURN(RuntimeBuilder builder,
+                         CreateStandardRuntimeBuilder(options));
+    CEL_RETURN_IF_ERROR(extensions::EnableTimeWindowOptimization(builder));
+    return std::move(builder).Build();
+  }
+
+  absl::StatusOr<Value> Evaluate(const Program& program, absl::Time t1,
+                                 absl::Time t2, absl::Duration d) {
+    ManagedValueFactory value_factory(program.GetTypeProvider(),
+                                      MemoryManagerRef::ReferenceCounting());
+    Activation activation;
+    activation.InsertOrAssignValue(
+        "t1", value_factory.get().CreateUncheckedTimestampValue(t1));
+    activation.InsertOrAssignValue(
+        "t2", value_factory.get().CreateUncheckedTimestampValue(t2));
+    activation.InsertOrAssignValue(
+        "d", value_factory.get().CreateUncheckedDurationValue(d));
+    return program.Evaluate(activation, value_factory.get());
+  }
+};
+
+TEST_F(TimeWindowOptimizationTest, LessInsideWindow) {
+  ASSERT_OK_AND_ASSIGN(
+      Value result,
+      EvaluateChecked(kLessExpression, absl::FromUnixSeconds(100),
+                      absl::FromUnixSeconds(40), absl::Minutes(5)));
+  ASSERT_TRUE(result->Is<BoolValue>());
+  EXPECT_TRUE(result->As<BoolValue>().NativeValue());
+}
+
+TEST_F(TimeWindowOptimizationTest, LessOutsideWindow) {
+  ASSERT_OK_AND_ASSIGN(
+      Value result,
+      EvaluateChecked(kLessExpression, absl::FromUnixSeconds(1000),
+                      absl::FromUnixSeconds(40), absl::Minutes(5)));
+  ASSERT_TRUE(result->Is<BoolValue>());
+  EXPECT_FALSE(result->As<BoolValue>().NativeValue());
+}
+
+TEST_F(TimeWindowOptimizationTest, GreaterEqualAtBoundary) {
+  ASSERT_OK_AND_ASSIGN(
+      Value result,
+      EvaluateChecked(kGreaterEqualExpression, absl::FromUnixSeconds(300),
+                      absl::FromUnixSeconds(0), absl::Minutes(5)));
+  ASSERT_TRUE(result->Is<BoolValue>());
+  EXPECT_TRUE(result->As<BoolValue>().NativeValue());
+}
+
+TEST_F(TimeWindowOptimizationTest, OverflowingDifferenceErrors) {
+  // The difference does not fit the int64 nanosecond range, matching the
+  // overflow behavior of the checked subtraction.
+  ASSERT_OK_AND_ASSIGN(
+      Value result,
+      EvaluateChecked(kLessExpression,
+                      absl::FromUnixSeconds(int64_t{253402300799}),
+                      absl::FromUnixSeconds(int64_t{-62135596800}),
+                      absl::Hours(1)));
+  ASSERT_TRUE(result->Is<ErrorValue>());
+  EXPECT_TRUE(
+      absl::StrContains(result->As<ErrorValue>().NativeValue().message(),
+                        "integer overflow"));
+}
+
+TEST_F(TimeWindowOptimizationTest, ParseOnlyExpressionUnaffected) {
+  ASSERT_OK_AND_ASSIGN(
+      Value result,
+      EvaluateParsed("t1 - t2 < d", absl::FromUnixSeconds(100),
+                     absl::FromUnixSeconds(40), absl::Minutes(5)));
+  ASSERT_TRUE(result->Is<BoolValue>());
+  EXPECT_TRUE(result->As<BoolValue>().NativeValue());
+}
+
+}  // namespace
+}  // namespace cel
@@ -29,8 +29,18 @@ TypeRegistry::TypeRegistry() {
 
 void TypeRegistry::RegisterEnum(absl::string_view enum_name,
                                 std::vector<Enumerator> enumerators) {
-  enum_types_[enum_name] =
+  enum_types_.mutable_get()[enum_name] =
       Enumeration{std::string(enum_name), std::move(enumerators)};
 }
 
+TypeRegistry TypeRegistry::NewChild() const {
+  TypeRegistry child;
+  child.impl_.set_parent(&impl_);
+  child.impl_.set_use_legacy_container_builders(
+      impl_.use_legacy_container_builders());
+  // Share the enum table; the child copies it lazily on first registration.
+  child.enum_types_ = enum_types_;
+  return child;
+}
+
 }  // namespace cel
@@ -25,6 +25,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "base/type_provider.h"
+#include "internal/copy_on_write.h"
 #include "runtime/internal/composed_type_provider.h"
 
 namespace cel {
@@ -66,9 +67,19 @@ class TypeRegistry {
 
   const absl::flat_hash_map<std::string, Enumeration>& resolveable_enums()
       const {
-    return enum_types_;
+    return enum_types_.get();
   }
 
+  // Derives a child registry that shares this registry's storage.
+  //
+  // The child consults its own type providers first and falls back to this
+  // registry's providers, so only per-tenant additions are materialized in
+  // the child. The enum table is shared copy-on-write: it is copied at most
+  // once, on the child's first RegisterEnum call. This registry must outlive
+  // the child and must not be modified after children are derived; existing
+  // children are unaffected by later additions to one another.
+  TypeRegistry NewChild() const;
+
   // Returns the effective type provider.
   const TypeProvider& GetComposedTypeProvider() const { return impl_; }
   void set_use_legacy_container_builders(bool use_legacy_container_builders) {
@@ -77,7 +88,8 @@ class TypeRegistry {
 
  private:
   runtime_internal::ComposedTypeProvider impl_;
-  absl::flat_hash_map<std::string, Enumeration> enum_types_;
+  internal::CopyOnWrite<absl::flat_hash_map<std::string, Enumeration>>
+      enum_types_;
 };
 
 }  // namespace cel
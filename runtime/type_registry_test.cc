@@ -0,0 +1,113 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/type_registry.h"
+
+#include <memory>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "base/type_provider.h"
+#include "common/memory.h"
+#include "common/type_reflector.h"
+#include "common/value.h"
+#include "common/value_factory.h"
+#include "common/values/legacy_value_manager.h"
+#include "internal/testing.h"
+
+namespace cel {
+namespace {
+
+using testing::Contains;
+using testing::Key;
+using testing::Not;
+
+// Minimal provider resolving a single named value; used to check that child
+// registries fall back to parent providers.
+class TestValueProvider : public TypeReflector {
+ public:
+  explicit TestValueProvider(absl::string_view name) : name_(name) {}
+
+  absl::StatusOr<bool> FindValue(ValueFactory& value_factory,
+                                 absl::string_view name,
+                                 Value& result) const override {
+    if (name == name_) {
+      result = value_factory.CreateIntValue(42);
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  std::string name_;
+};
+
+TEST(TypeRegistryTest, ChildSharesParentEnums) {
+  TypeRegistry parent;
+  parent.RegisterEnum("com.example.ParentEnum", {{"VALUE", 1}});
+
+  TypeRegistry child = parent.NewChild();
+
+  EXPECT_THAT(child.resolveable_enums(),
+              Contains(Key("com.example.ParentEnum")));
+}
+
+TEST(TypeRegistryTest, ChildEnumAdditionsStayLocal) {
+  TypeRegistry parent;
+  parent.RegisterEnum("com.example.ParentEnum", {{"VALUE", 1}});
+
+  TypeRegistry child_a = parent.NewChild();
+  TypeRegistry child_b = parent.NewChild();
+  child_a.RegisterEnum("com.example.TenantEnum", {{"VALUE", 1}});
+
+  EXPECT_THAT(child_a.resolveable_enums(),
+              Contains(Key("com.example.ParentEnum")));
+  EXPECT_THAT(child_a.resolveable_enums(),
+              Contains(Key("com.example.TenantEnum")));
+  // The parent and sibling snapshots are untouched by the child's delta.
+  EXPECT_THAT(parent.resolveable_enums(),
+              Not(Contains(Key("com.example.TenantEnum"))));
+  EXPECT_THAT(child_b.resolveable_enums(),
+              Not(Contains(Key("com.example.TenantEnum"))));
+}
+
+TEST(TypeRegistryTest, ChildFallsBackToParentProviders) {
+  TypeRegistry parent;
+  parent.AddTypeProvider(std::make_unique<TestValueProvider>("parent_value"));
+
+  TypeRegistry child = parent.NewChild();
+  child.AddTypeProvider(std::make_unique<TestValueProvider>("child_value"));
+
+  common_internal::LegacyValueManager value_factory(
+      MemoryManagerRef::ReferenceCounting(), TypeProvider::Builtin());
+
+  Value result;
+  ASSERT_OK_AND_ASSIGN(bool found,
+                       child.GetComposedTypeProvider().FindValue(
+                           value_factory, "parent_value", result));
+  EXPECT_TRUE(found);
+
+  ASSERT_OK_AND_ASSIGN(found, child.GetComposedTypeProvider().FindValue(
+                                  value_factory, "child_value", result));
+  EXPECT_TRUE(found);
+
+  // The parent does not see child registrations.
+  ASSERT_OK_AND_ASSIGN(found, parent.GetComposedTypeProvider().FindValue(
+                                  value_factory, "child_value", result));
+  EXPECT_FALSE(found);
+}
+
+}  // namespace
+}  // namespace cel
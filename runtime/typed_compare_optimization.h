@@ -0,0 +1,33 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_TYPED_COMPARE_OPTIMIZATION_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_TYPED_COMPARE_OPTIMIZATION_H_
+
+#include "absl/status/status.h"
+#include "runtime/runtime_builder.h"
+
+namespace cel::extensions {
+
+// Enable type-pinned comparison planning in the runtime being built.
+//
+// In checked expressions, comparisons whose operand types the checker
+// proved to be the same primitive type are planned as direct primitive
+// comparisons, skipping overload resolution and the heterogeneous numeric
+// conversion at evaluation time. Parse-only expressions are unaffected.
+absl::Status EnableTypedCompareOptimization(RuntimeBuilder& builder);
+
+}  // namespace cel::extensions
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_TYPED_COMPARE_OPTIMIZATION_H_
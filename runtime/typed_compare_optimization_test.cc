@@ -0,0 +1,171 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/typed_compare_optimization.h"
+
+#include <memory>
+#include <utility>
+
+#include "google/api/expr/v1alpha1/checked.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "runtime/activation.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "google/protobuf/text_format.h"
+
+namespace cel {
+namespace {
+
+using ::cel::extensions::ProtobufRuntimeAdapter;
+using ::google::api::expr::v1alpha1::CheckedExpr;
+
+// x < y, with the checker-resolved int64 overload.
+constexpr absl::string_view kLessExpression = R"pb(
+  reference_map: {
+    key: 2
+    value: { overload_id: "less_int64" }
+  }
+  expr: {
+    id: 2
+    call_expr: {
+      function: "_<_"
+      args: {
+        id: 1
+        ident_expr: { name: "x" }
+      }
+      args: {
+        id: 3
+        ident_expr: { name: "y" }
+      }
+    }
+  })pb";
+
+// x == y, with both operands deduced int64. The equality overload id is not
+// type specific, so the pinning comes from the type map.
+constexpr absl::string_view kEqualExpression = R"pb(
+  reference_map: {
+    key: 2
+    value: { overload_id: "equals" }
+  }
+  type_map: {
+    key: 1
+    value: { primitive: INT64 }
+  }
+  type_map: {
+    key: 3
+    value: { primitive: INT64 }
+  }
+  expr: {
+    id: 2
+    call_expr: {
+      function: "_==_"
+      args: {
+        id: 1
+        ident_expr: { name: "x" }
+      }
+      args: {
+        id: 3
+        ident_expr: { name: "y" }
+      }
+    }
+  })pb";
+
+class TypedCompareOptimizationTest : public testing::Test {
+ protected:
+  absl::StatusOr<Value> EvaluateChecked(absl::string_view checked_textproto,
+                                        Value x, Value y) {
+    CheckedExpr checked_expr;
+    if (!google::protobuf::TextFormat::ParseFromString(checked_textproto,
+                                             &checked_expr)) {
+      return absl::InternalError("failed to parse test expression");
+    }
+    RuntimeOptions options;
+    CEL_ASSIGN_OR_RETURN(RuntimeBuilder builder,
+                         CreateStandardRuntimeBuilder(options));
+    CEL_RETURN_IF_ERROR(extensions::EnableTypedCompareOptimization(builder));
+    CEL_ASSIGN_OR_RETURN(auto runtime, std::move(builder).Build());
+    CEL_ASSIGN_OR_RETURN(auto program, ProtobufRuntimeAdapter::CreateProgram(
+                                           *runtime, checked_expr));
+
+    ManagedValueFactory value_factory(program->GetTypeProvider(),
+                                      MemoryManagerRef::ReferenceCounting());
+    Activation activation;
+    activation.InsertOrAssignValue("x", std::move(x));
+    activation.InsertOrAssignValue("y", std::move(y));
+    return program->Evaluate(activation, value_factory.get());
+  }
+};
+
+TEST_F(TypedCompareOptimizationTest, Int64Less) {
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       EvaluateChecked(kLessExpression, IntValue(1),
+                                       IntValue(2)));
+  ASSERT_TRUE(result->Is<BoolValue>());
+  EXPECT_TRUE(result->As<BoolValue>().NativeValue());
+}
+
+TEST_F(TypedCompareOptimizationTest, Int64LessFalse) {
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       EvaluateChecked(kLessExpression, IntValue(3),
+                                       IntValue(2)));
+  ASSERT_TRUE(result->Is<BoolValue>());
+  EXPECT_FALSE(result->As<BoolValue>().NativeValue());
+}
+
+TEST_F(TypedCompareOptimizationTest, Int64Equal) {
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       EvaluateChecked(kEqualExpression, IntValue(42),
+                                       IntValue(42)));
+  ASSERT_TRUE(result->Is<BoolValue>());
+  EXPECT_TRUE(result->As<BoolValue>().NativeValue());
+}
+
+TEST_F(TypedCompareOptimizationTest, Int64NotEqualValues) {
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       EvaluateChecked(kEqualExpression, IntValue(42),
+                                       IntValue(43)));
+  ASSERT_TRUE(result->Is<BoolValue>());
+  EXPECT_FALSE(result->As<BoolValue>().NativeValue());
+}
+
+TEST_F(TypedCompareOptimizationTest, MistypedNumericFallsBackToHeterogeneous) {
+  // The checker pinned int64, but the activation binds a double. The fused
+  // step reproduces heterogeneous numeric equality.
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       EvaluateChecked(kEqualExpression, DoubleValue(42.0),
+                                       IntValue(42)));
+  ASSERT_TRUE(result->Is<BoolValue>());
+  EXPECT_TRUE(result->As<BoolValue>().NativeValue());
+}
+
+TEST_F(TypedCompareOptimizationTest, MistypedNonNumericUnequal) {
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       EvaluateChecked(kEqualExpression, StringValue("42"),
+                                       IntValue(42)));
+  ASSERT_TRUE(result->Is<BoolValue>());
+  EXPECT_FALSE(result->As<BoolValue>().NativeValue());
+}
+
+}  // namespace
+}  // namespace cel
@@ -0,0 +1,136 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tools/cel_field_extractor.h"
+
+#include <string>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+
+namespace cel {
+
+namespace {
+
+using ::google::api::expr::v1alpha1::Expr;
+
+class FieldPathCollector {
+ public:
+  explicit FieldPathCollector(absl::flat_hash_set<std::string>& paths)
+      : paths_(paths) {}
+
+  void Collect(const Expr& expr) {
+    switch (expr.expr_kind_case()) {
+      case Expr::kIdentExpr:
+        paths_.insert(expr.ident_expr().name());
+        break;
+      case Expr::kSelectExpr:
+        CollectSelectChain(expr);
+        break;
+      case Expr::kCallExpr: {
+        const auto& call = expr.call_expr();
+        if (call.has_target()) {
+          Collect(call.target());
+        }
+        for (const auto& arg : call.args()) {
+          Collect(arg);
+        }
+        break;
+      }
+      case Expr::kListExpr:
+        for (const auto& element : expr.list_expr().elements()) {
+          Collect(element);
+        }
+        break;
+      case Expr::kStructExpr:
+        for (const auto& entry : expr.struct_expr().entries()) {
+          if (entry.has_map_key()) {
+            Collect(entry.map_key());
+          }
+          Collect(entry.value());
+        }
+        break;
+      case Expr::kComprehensionExpr: {
+        const auto& comprehension = expr.comprehension_expr();
+        // The iteration and accumulation variables are comprehension-local;
+        // shadowed uses inside the loop subexpressions are not attribute
+        // reads. Over-approximating here (treating every identifier as a
+        // top-level read) would only widen the mask, but the macro-generated
+        // accumulator would then leak into every result, so the common
+        // shadowing cases are filtered out below.
+        Collect(comprehension.iter_range());
+        Collect(comprehension.accu_init());
+        CollectShadowed(comprehension.loop_condition(), comprehension);
+        CollectShadowed(comprehension.loop_step(), comprehension);
+        CollectShadowed(comprehension.result(), comprehension);
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+ private:
+  // Walks a chain of field selections down to its base expression. If the
+  // base is an identifier the joined dotted path is recorded; otherwise the
+  // base is collected on its own and the intermediate field names are
+  // dropped (they name fields of a computed value, not of an attribute).
+  void CollectSelectChain(const Expr& expr) {
+    std::vector<absl::string_view> fields;
+    const Expr* node = &expr;
+    while (node->expr_kind_case() == Expr::kSelectExpr) {
+      fields.push_back(node->select_expr().field());
+      node = &node->select_expr().operand();
+    }
+    if (node->expr_kind_case() == Expr::kIdentExpr) {
+      fields.push_back(node->ident_expr().name());
+      paths_.insert(absl::StrJoin(fields.rbegin(), fields.rend(), "."));
+      return;
+    }
+    Collect(*node);
+  }
+
+  void CollectShadowed(
+      const Expr& expr,
+      const google::api::expr::v1alpha1::Expr::Comprehension& comprehension) {
+    absl::flat_hash_set<std::string> inner;
+    FieldPathCollector collector(inner);
+    collector.Collect(expr);
+    for (auto& path : inner) {
+      absl::string_view root = path;
+      root = root.substr(0, root.find('.'));
+      if (root == comprehension.iter_var() ||
+          root == comprehension.accu_var()) {
+        continue;
+      }
+      paths_.insert(path);
+    }
+  }
+
+  absl::flat_hash_set<std::string>& paths_;
+};
+
+}  // namespace
+
+absl::flat_hash_set<std::string> ExtractFieldPaths(const Expr& expr) {
+  absl::flat_hash_set<std::string> paths;
+  FieldPathCollector collector(paths);
+  collector.Collect(expr);
+  return paths;
+}
+
+}  // namespace cel
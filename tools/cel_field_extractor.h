@@ -0,0 +1,44 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_TOOLS_CEL_FIELD_EXTRACTOR_H_
+#define THIRD_PARTY_CEL_CPP_TOOLS_CEL_FIELD_EXTRACTOR_H_
+
+#include <string>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/container/flat_hash_set.h"
+
+namespace cel {
+
+// Returns the set of dotted attribute paths an expression can read, e.g.
+// {"request.user.name", "resource.labels"} for
+// `request.user.name == "admin" || "prod" in resource.labels`.
+//
+// A path is the longest chain of field selections (including `has(...)`
+// test-only selections) applied directly to a top-level identifier.
+// Selections applied to intermediate results (function calls, indexing,
+// comprehension variables) contribute the paths of their subexpressions
+// instead, so the result is a conservative over-approximation of the data
+// the expression touches: fetching exactly these paths is always sufficient.
+//
+// Intended to drive upstream pruning — e.g. populating a read mask for a
+// storage fetch, or deciding which lazily parsed messages need to be bound
+// at all — before evaluating a compiled expression over many rows.
+absl::flat_hash_set<std::string> ExtractFieldPaths(
+    const google::api::expr::v1alpha1::Expr& expr);
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_TOOLS_CEL_FIELD_EXTRACTOR_H_
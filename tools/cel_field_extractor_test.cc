@@ -0,0 +1,79 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tools/cel_field_extractor.h"
+
+#include <string>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/container/flat_hash_set.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+
+namespace cel {
+namespace {
+
+using ::google::api::expr::parser::Parse;
+using testing::IsEmpty;
+using testing::UnorderedElementsAre;
+
+absl::flat_hash_set<std::string> ExtractPaths(const std::string& expression) {
+  return ExtractFieldPaths(Parse(expression).value().expr());
+}
+
+TEST(CelFieldExtractor, SelectChains) {
+  EXPECT_THAT(ExtractPaths("request.user.name == 'admin' || "
+                           "request.auth.claims.group == 'admin'"),
+              UnorderedElementsAre("request.user.name",
+                                   "request.auth.claims.group"));
+}
+
+TEST(CelFieldExtractor, BareIdent) {
+  EXPECT_THAT(ExtractPaths("x < y"), UnorderedElementsAre("x", "y"));
+}
+
+TEST(CelFieldExtractor, TestOnlySelect) {
+  EXPECT_THAT(ExtractPaths("has(request.user.name)"),
+              UnorderedElementsAre("request.user.name"));
+}
+
+TEST(CelFieldExtractor, SelectOnComputedValueDropsFieldNames) {
+  // `.name` applies to a call result, not to an attribute; only the call's
+  // own operands are attribute reads.
+  EXPECT_THAT(ExtractPaths("lookup(request.id).name == 'admin'"),
+              UnorderedElementsAre("request.id"));
+}
+
+TEST(CelFieldExtractor, IndexOperandIsCollected) {
+  EXPECT_THAT(ExtractPaths("resource.labels['env'] == tier"),
+              UnorderedElementsAre("resource.labels", "tier"));
+}
+
+TEST(CelFieldExtractor, ComprehensionVariablesAreNotPaths) {
+  EXPECT_THAT(
+      ExtractPaths("request.items.exists(item, item.size > limits.max)"),
+      UnorderedElementsAre("request.items", "limits.max"));
+}
+
+TEST(CelFieldExtractor, MapAndListLiterals) {
+  EXPECT_THAT(ExtractPaths("{request.key: [resource.name, 1]}"),
+              UnorderedElementsAre("request.key", "resource.name"));
+}
+
+TEST(CelFieldExtractor, ConstantsHaveNoPaths) {
+  EXPECT_THAT(ExtractPaths("1 + 2 == 3"), IsEmpty());
+}
+
+}  // namespace
+}  // namespace cel
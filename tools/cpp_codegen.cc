@@ -0,0 +1,461 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tools/cpp_codegen.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "internal/status_macros.h"
+
+namespace cel {
+
+namespace {
+
+using ::google::api::expr::v1alpha1::Expr;
+
+// Runtime helpers emitted into every generated translation unit. They carry
+// the CEL operator semantics (error absorption, checked integer arithmetic,
+// short-circuiting) so the generated expression body is a plain tree of
+// calls.
+constexpr absl::string_view kPreamble = R"cc(
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "common/value.h"
+#include "internal/overflow.h"
+
+namespace {
+
+using ::cel::Value;
+
+bool IsError(const Value& value) { return value->Is<cel::ErrorValue>(); }
+
+Value NoOverload(const char* op) {
+  return cel::ErrorValue(
+      absl::UnknownError(std::string("No matching overloads found : ") + op));
+}
+
+Value FromCheckedInt(const absl::StatusOr<int64_t>& result) {
+  if (!result.ok()) return cel::ErrorValue(result.status());
+  return cel::IntValue(*result);
+}
+
+Value FromCheckedUint(const absl::StatusOr<uint64_t>& result) {
+  if (!result.ok()) return cel::ErrorValue(result.status());
+  return cel::UintValue(*result);
+}
+
+#define CEL_CODEGEN_ARITHMETIC(name, op, checked)                           \
+  Value name(const Value& lhs, const Value& rhs) {                          \
+    if (IsError(lhs)) return lhs;                                           \
+    if (IsError(rhs)) return rhs;                                           \
+    if (lhs->Is<cel::IntValue>() && rhs->Is<cel::IntValue>()) {             \
+      return FromCheckedInt(                                                \
+          cel::internal::checked(lhs.As<cel::IntValue>().NativeValue(),     \
+                                 rhs.As<cel::IntValue>().NativeValue()));   \
+    }                                                                       \
+    if (lhs->Is<cel::UintValue>() && rhs->Is<cel::UintValue>()) {           \
+      return FromCheckedUint(                                               \
+          cel::internal::checked(lhs.As<cel::UintValue>().NativeValue(),    \
+                                 rhs.As<cel::UintValue>().NativeValue()));  \
+    }                                                                       \
+    if (lhs->Is<cel::DoubleValue>() && rhs->Is<cel::DoubleValue>()) {       \
+      return cel::DoubleValue(lhs.As<cel::DoubleValue>().NativeValue()      \
+                                  op rhs.As<cel::DoubleValue>()             \
+                                  .NativeValue());                          \
+    }                                                                       \
+    return NoOverload(#op);                                                 \
+  }
+
+CEL_CODEGEN_ARITHMETIC(CelAdd, +, CheckedAdd)
+CEL_CODEGEN_ARITHMETIC(CelSub, -, CheckedSub)
+CEL_CODEGEN_ARITHMETIC(CelMul, *, CheckedMul)
+
+#undef CEL_CODEGEN_ARITHMETIC
+
+Value CelDiv(const Value& lhs, const Value& rhs) {
+  if (IsError(lhs)) return lhs;
+  if (IsError(rhs)) return rhs;
+  if (lhs->Is<cel::IntValue>() && rhs->Is<cel::IntValue>()) {
+    return FromCheckedInt(
+        cel::internal::CheckedDiv(lhs.As<cel::IntValue>().NativeValue(),
+                                  rhs.As<cel::IntValue>().NativeValue()));
+  }
+  if (lhs->Is<cel::UintValue>() && rhs->Is<cel::UintValue>()) {
+    return FromCheckedUint(
+        cel::internal::CheckedDiv(lhs.As<cel::UintValue>().NativeValue(),
+                                  rhs.As<cel::UintValue>().NativeValue()));
+  }
+  if (lhs->Is<cel::DoubleValue>() && rhs->Is<cel::DoubleValue>()) {
+    return cel::DoubleValue(lhs.As<cel::DoubleValue>().NativeValue() /
+                            rhs.As<cel::DoubleValue>().NativeValue());
+  }
+  return NoOverload("/");
+}
+
+Value CelMod(const Value& lhs, const Value& rhs) {
+  if (IsError(lhs)) return lhs;
+  if (IsError(rhs)) return rhs;
+  if (lhs->Is<cel::IntValue>() && rhs->Is<cel::IntValue>()) {
+    return FromCheckedInt(
+        cel::internal::CheckedMod(lhs.As<cel::IntValue>().NativeValue(),
+                                  rhs.As<cel::IntValue>().NativeValue()));
+  }
+  if (lhs->Is<cel::UintValue>() && rhs->Is<cel::UintValue>()) {
+    return FromCheckedUint(
+        cel::internal::CheckedMod(lhs.As<cel::UintValue>().NativeValue(),
+                                  rhs.As<cel::UintValue>().NativeValue()));
+  }
+  return NoOverload("%");
+}
+
+Value CelNeg(const Value& operand) {
+  if (IsError(operand)) return operand;
+  if (operand->Is<cel::IntValue>()) {
+    return FromCheckedInt(
+        cel::internal::CheckedNegation(operand.As<cel::IntValue>().NativeValue()));
+  }
+  if (operand->Is<cel::DoubleValue>()) {
+    return cel::DoubleValue(-operand.As<cel::DoubleValue>().NativeValue());
+  }
+  return NoOverload("-");
+}
+
+Value CelNot(const Value& operand) {
+  if (IsError(operand)) return operand;
+  if (operand->Is<cel::BoolValue>()) {
+    return cel::BoolValue(!operand.As<cel::BoolValue>().NativeValue());
+  }
+  return NoOverload("!");
+}
+
+// Three-way comparison within a kind: negative, zero or positive, or an
+// error status for uncomparable kinds.
+absl::StatusOr<int> CelCompare(const Value& lhs, const Value& rhs) {
+  if (lhs->Is<cel::BoolValue>() && rhs->Is<cel::BoolValue>()) {
+    return static_cast<int>(lhs.As<cel::BoolValue>().NativeValue()) -
+           static_cast<int>(rhs.As<cel::BoolValue>().NativeValue());
+  }
+  if (lhs->Is<cel::IntValue>() && rhs->Is<cel::IntValue>()) {
+    int64_t l = lhs.As<cel::IntValue>().NativeValue();
+    int64_t r = rhs.As<cel::IntValue>().NativeValue();
+    return l < r ? -1 : (l > r ? 1 : 0);
+  }
+  if (lhs->Is<cel::UintValue>() && rhs->Is<cel::UintValue>()) {
+    uint64_t l = lhs.As<cel::UintValue>().NativeValue();
+    uint64_t r = rhs.As<cel::UintValue>().NativeValue();
+    return l < r ? -1 : (l > r ? 1 : 0);
+  }
+  if (lhs->Is<cel::DoubleValue>() && rhs->Is<cel::DoubleValue>()) {
+    double l = lhs.As<cel::DoubleValue>().NativeValue();
+    double r = rhs.As<cel::DoubleValue>().NativeValue();
+    return l < r ? -1 : (l > r ? 1 : 0);
+  }
+  if (lhs->Is<cel::StringValue>() && rhs->Is<cel::StringValue>()) {
+    return lhs.As<cel::StringValue>().ToString().compare(
+        rhs.As<cel::StringValue>().ToString());
+  }
+  if (lhs->Is<cel::NullValue>() && rhs->Is<cel::NullValue>()) {
+    return 0;
+  }
+  return absl::UnknownError("No matching overloads found : comparison");
+}
+
+#define CEL_CODEGEN_COMPARISON(name, op)                  \
+  Value name(const Value& lhs, const Value& rhs) {        \
+    if (IsError(lhs)) return lhs;                         \
+    if (IsError(rhs)) return rhs;                         \
+    absl::StatusOr<int> cmp = CelCompare(lhs, rhs);       \
+    if (!cmp.ok()) return cel::ErrorValue(cmp.status());  \
+    return cel::BoolValue(*cmp op 0);                     \
+  }
+
+CEL_CODEGEN_COMPARISON(CelLt, <)
+CEL_CODEGEN_COMPARISON(CelLe, <=)
+CEL_CODEGEN_COMPARISON(CelGt, >)
+CEL_CODEGEN_COMPARISON(CelGe, >=)
+CEL_CODEGEN_COMPARISON(CelEq, ==)
+CEL_CODEGEN_COMPARISON(CelNe, !=)
+
+#undef CEL_CODEGEN_COMPARISON
+
+template <typename RhsFn>
+Value CelOr(const Value& lhs, RhsFn&& rhs_fn) {
+  if (lhs->Is<cel::BoolValue>() && lhs.As<cel::BoolValue>().NativeValue()) {
+    return lhs;
+  }
+  Value rhs = rhs_fn();
+  if (rhs->Is<cel::BoolValue>() && rhs.As<cel::BoolValue>().NativeValue()) {
+    return rhs;
+  }
+  if (lhs->Is<cel::BoolValue>() && rhs->Is<cel::BoolValue>()) {
+    return cel::BoolValue(false);
+  }
+  if (IsError(lhs)) return lhs;
+  if (IsError(rhs)) return rhs;
+  return NoOverload("||");
+}
+
+template <typename RhsFn>
+Value CelAnd(const Value& lhs, RhsFn&& rhs_fn) {
+  if (lhs->Is<cel::BoolValue>() && !lhs.As<cel::BoolValue>().NativeValue()) {
+    return lhs;
+  }
+  Value rhs = rhs_fn();
+  if (rhs->Is<cel::BoolValue>() && !rhs.As<cel::BoolValue>().NativeValue()) {
+    return rhs;
+  }
+  if (lhs->Is<cel::BoolValue>() && rhs->Is<cel::BoolValue>()) {
+    return cel::BoolValue(true);
+  }
+  if (IsError(lhs)) return lhs;
+  if (IsError(rhs)) return rhs;
+  return NoOverload("&&");
+}
+
+template <typename TrueFn, typename FalseFn>
+Value CelTernary(const Value& condition, TrueFn&& true_fn,
+                 FalseFn&& false_fn) {
+  if (condition->Is<cel::BoolValue>()) {
+    return condition.As<cel::BoolValue>().NativeValue() ? true_fn()
+                                                        : false_fn();
+  }
+  if (IsError(condition)) return condition;
+  return NoOverload("?:");
+}
+
+}  // namespace
+)cc";
+
+class Emitter {
+ public:
+  // Appends the statements computing `expr` to `body` at the given indent and
+  // returns the name of the local holding the result.
+  absl::StatusOr<std::string> EmitExpr(const Expr& expr, std::string* body,
+                                       int indent);
+
+  const std::vector<std::string>& parameters() const { return parameters_; }
+
+ private:
+  std::string NewLocal() { return absl::StrCat("v", next_local_++); }
+
+  absl::StatusOr<std::string> EmitConst(const Expr& expr, std::string* body,
+                                        int indent);
+  absl::StatusOr<std::string> EmitIdent(const Expr& expr, std::string* body,
+                                        int indent);
+  absl::StatusOr<std::string> EmitCall(const Expr& expr, std::string* body,
+                                       int indent);
+
+  // Emits a nested block evaluating `expr` as a lazily-invoked lambda
+  // argument.
+  absl::StatusOr<std::string> EmitLazyArg(const Expr& expr, int indent);
+
+  int next_local_ = 0;
+  std::vector<std::string> parameters_;
+  absl::flat_hash_map<std::string, int> parameter_index_;
+};
+
+std::string Indent(int indent) { return std::string(indent, ' '); }
+
+absl::StatusOr<std::string> Emitter::EmitConst(const Expr& expr,
+                                               std::string* body, int indent) {
+  const auto& constant = expr.const_expr();
+  std::string local = NewLocal();
+  std::string initializer;
+  switch (constant.constant_kind_case()) {
+    case google::api::expr::v1alpha1::Constant::kInt64Value:
+      if (constant.int64_value() == std::numeric_limits<int64_t>::min()) {
+        initializer = "cel::IntValue(int64_t{-9223372036854775807} - 1)";
+      } else {
+        initializer =
+            absl::StrCat("cel::IntValue(int64_t{", constant.int64_value(), "})");
+      }
+      break;
+    case google::api::expr::v1alpha1::Constant::kUint64Value:
+      initializer = absl::StrCat("cel::UintValue(uint64_t{",
+                                 constant.uint64_value(), "u})");
+      break;
+    case google::api::expr::v1alpha1::Constant::kDoubleValue:
+      initializer = absl::StrFormat("cel::DoubleValue(%.17g)",
+                                    constant.double_value());
+      break;
+    case google::api::expr::v1alpha1::Constant::kBoolValue:
+      initializer = absl::StrCat("cel::BoolValue(",
+                                 constant.bool_value() ? "true" : "false", ")");
+      break;
+    case google::api::expr::v1alpha1::Constant::kStringValue:
+      initializer = absl::StrCat("cel::StringValue(std::string(\"",
+                                 absl::CEscape(constant.string_value()),
+                                 "\"))");
+      break;
+    case google::api::expr::v1alpha1::Constant::kNullValue:
+      initializer = "cel::NullValue()";
+      break;
+    default:
+      return absl::UnimplementedError(absl::StrCat(
+          "no codegen for constant kind ", constant.constant_kind_case()));
+  }
+  absl::StrAppend(body, Indent(indent), "Value ", local, " = ", initializer,
+                  ";\n");
+  return local;
+}
+
+absl::StatusOr<std::string> Emitter::EmitIdent(const Expr& expr,
+                                               std::string* body, int indent) {
+  const std::string& name = expr.ident_expr().name();
+  auto [it, inserted] =
+      parameter_index_.insert({name, static_cast<int>(parameters_.size())});
+  if (inserted) {
+    parameters_.push_back(name);
+  }
+  std::string local = NewLocal();
+  absl::StrAppend(body, Indent(indent), "const Value& ", local, " = params[",
+                  it->second, "];\n");
+  return local;
+}
+
+absl::StatusOr<std::string> Emitter::EmitLazyArg(const Expr& expr,
+                                                 int indent) {
+  std::string block;
+  CEL_ASSIGN_OR_RETURN(std::string local,
+                       EmitExpr(expr, &block, indent + 2));
+  return absl::StrCat("[&]() -> Value {\n", block, Indent(indent + 2),
+                      "return ", local, ";\n", Indent(indent), "}");
+}
+
+absl::StatusOr<std::string> Emitter::EmitCall(const Expr& expr,
+                                              std::string* body, int indent) {
+  const auto& call = expr.call_expr();
+  if (call.has_target()) {
+    return absl::UnimplementedError(absl::StrCat(
+        "no codegen for receiver-style call to ", call.function()));
+  }
+  const std::string& function = call.function();
+
+  struct StrictOp {
+    absl::string_view function;
+    absl::string_view helper;
+    int arity;
+  };
+  static constexpr StrictOp kStrictOps[] = {
+      {"_+_", "CelAdd", 2},  {"_-_", "CelSub", 2}, {"_*_", "CelMul", 2},
+      {"_/_", "CelDiv", 2},  {"_%_", "CelMod", 2}, {"-_", "CelNeg", 1},
+      {"!_", "CelNot", 1},   {"_<_", "CelLt", 2},  {"_<=_", "CelLe", 2},
+      {"_>_", "CelGt", 2},   {"_>=_", "CelGe", 2}, {"_==_", "CelEq", 2},
+      {"_!=_", "CelNe", 2},
+  };
+
+  for (const StrictOp& op : kStrictOps) {
+    if (function != op.function) continue;
+    if (call.args_size() != op.arity) {
+      return absl::UnimplementedError(
+          absl::StrCat("unexpected arity for ", function));
+    }
+    std::vector<std::string> args;
+    for (const Expr& arg : call.args()) {
+      CEL_ASSIGN_OR_RETURN(std::string arg_local,
+                           EmitExpr(arg, body, indent));
+      args.push_back(std::move(arg_local));
+    }
+    std::string local = NewLocal();
+    absl::StrAppend(body, Indent(indent), "Value ", local, " = ", op.helper,
+                    "(", absl::StrJoin(args, ", "), ");\n");
+    return local;
+  }
+
+  if ((function == "_&&_" || function == "_||_") && call.args_size() == 2) {
+    CEL_ASSIGN_OR_RETURN(std::string lhs,
+                         EmitExpr(call.args(0), body, indent));
+    CEL_ASSIGN_OR_RETURN(std::string rhs_fn,
+                         EmitLazyArg(call.args(1), indent));
+    std::string local = NewLocal();
+    absl::StrAppend(body, Indent(indent), "Value ", local, " = ",
+                    function == "_&&_" ? "CelAnd" : "CelOr", "(", lhs, ", ",
+                    rhs_fn, ");\n");
+    return local;
+  }
+
+  if (function == "_?_:_" && call.args_size() == 3) {
+    CEL_ASSIGN_OR_RETURN(std::string condition,
+                         EmitExpr(call.args(0), body, indent));
+    CEL_ASSIGN_OR_RETURN(std::string true_fn,
+                         EmitLazyArg(call.args(1), indent));
+    CEL_ASSIGN_OR_RETURN(std::string false_fn,
+                         EmitLazyArg(call.args(2), indent));
+    std::string local = NewLocal();
+    absl::StrAppend(body, Indent(indent), "Value ", local, " = CelTernary(",
+                    condition, ", ", true_fn, ", ", false_fn, ");\n");
+    return local;
+  }
+
+  return absl::UnimplementedError(
+      absl::StrCat("no codegen for function ", function));
+}
+
+absl::StatusOr<std::string> Emitter::EmitExpr(const Expr& expr,
+                                              std::string* body, int indent) {
+  switch (expr.expr_kind_case()) {
+    case Expr::kConstExpr:
+      return EmitConst(expr, body, indent);
+    case Expr::kIdentExpr:
+      return EmitIdent(expr, body, indent);
+    case Expr::kCallExpr:
+      return EmitCall(expr, body, indent);
+    default:
+      return absl::UnimplementedError(absl::StrCat(
+          "no codegen for expression kind ", expr.expr_kind_case()));
+  }
+}
+
+}  // namespace
+
+absl::StatusOr<GeneratedCppExpr> GenerateCppExpr(const Expr& expr,
+                                                 absl::string_view symbol) {
+  Emitter emitter;
+  std::string body;
+  CEL_ASSIGN_OR_RETURN(std::string result_local,
+                       emitter.EmitExpr(expr, &body, 2));
+
+  GeneratedCppExpr generated;
+  generated.symbol = std::string(symbol);
+  generated.parameters = emitter.parameters();
+  generated.source = absl::StrCat(
+      "// Generated by tools/cpp_codegen.h. Do not edit.\n", kPreamble,
+      "\nextern \"C\" bool ", symbol,
+      "(const cel::Value* params, std::size_t param_count,\n"
+      "    cel::Value* result) {\n",
+      "  if (result == nullptr || param_count != ",
+      generated.parameters.size(), ") return false;\n", "  (void)params;\n",
+      body, "  *result = std::move(", result_local, ");\n  return true;\n}\n");
+  return generated;
+}
+
+}  // namespace cel
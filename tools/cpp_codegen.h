@@ -0,0 +1,67 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_TOOLS_CPP_CODEGEN_H_
+#define THIRD_PARTY_CEL_CPP_TOOLS_CPP_CODEGEN_H_
+
+#include <string>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace cel {
+
+// Result of translating a CEL expression into standalone C++ source.
+struct GeneratedCppExpr {
+  // A complete C++ translation unit implementing the expression against the
+  // cel::Value API. Intended to be compiled offline against cel-cpp and
+  // loaded with internal/dynamic_loader.h.
+  std::string source;
+
+  // Name of the exported entry point, declared as:
+  //
+  //   extern "C" bool <symbol>(const cel::Value* params,
+  //                            std::size_t param_count, cel::Value* result);
+  //
+  // The entry point returns false if param_count does not match the expected
+  // parameter count; otherwise it writes the evaluation result (which may be
+  // an ErrorValue) to *result and returns true.
+  std::string symbol;
+
+  // Identifier names bound to params[i], in order of first appearance in the
+  // expression. The caller resolves these against its activation before
+  // invoking the entry point.
+  std::vector<std::string> parameters;
+};
+
+// Translates `expr` into standalone C++ source with the given entry point
+// symbol.
+//
+// Supported subset: constants (int, uint, double, bool, string, null), bare
+// identifiers, and calls to the core operators (arithmetic with checked
+// overflow, comparisons, equality within a kind, !_, and short-circuiting
+// &&, || and _?_:_ with CEL error-absorption semantics). Unknown-value
+// processing and heterogeneous numeric comparisons are not supported.
+//
+// Returns kUnimplemented for any expression outside the subset (selects,
+// comprehensions, lists, maps, non-operator functions), so callers can keep
+// routing those programs to the interpreter.
+absl::StatusOr<GeneratedCppExpr> GenerateCppExpr(
+    const google::api::expr::v1alpha1::Expr& expr, absl::string_view symbol);
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_TOOLS_CPP_CODEGEN_H_
@@ -0,0 +1,91 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tools/cpp_codegen.h"
+
+#include <string>
+
+#include "google/api/expr/v1alpha1/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+
+namespace cel {
+namespace {
+
+using ::google::api::expr::parser::Parse;
+using cel::internal::StatusIs;
+using testing::ElementsAre;
+using testing::HasSubstr;
+
+absl::StatusOr<GeneratedCppExpr> Generate(const std::string& expression) {
+  CEL_ASSIGN_OR_RETURN(google::api::expr::v1alpha1::ParsedExpr parsed,
+                       Parse(expression));
+  return GenerateCppExpr(parsed.expr(), "CelCompiledExpr");
+}
+
+TEST(CppCodegenTest, ArithmeticExpression) {
+  ASSERT_OK_AND_ASSIGN(GeneratedCppExpr generated, Generate("a + b * 2"));
+
+  EXPECT_EQ(generated.symbol, "CelCompiledExpr");
+  EXPECT_THAT(generated.parameters, ElementsAre("a", "b"));
+  EXPECT_THAT(generated.source, HasSubstr("extern \"C\" bool CelCompiledExpr"));
+  EXPECT_THAT(generated.source, HasSubstr("CelAdd"));
+  EXPECT_THAT(generated.source, HasSubstr("CelMul"));
+  EXPECT_THAT(generated.source, HasSubstr("param_count != 2"));
+}
+
+TEST(CppCodegenTest, RepeatedIdentBindsOneParameter) {
+  ASSERT_OK_AND_ASSIGN(GeneratedCppExpr generated, Generate("a < a + 1"));
+  EXPECT_THAT(generated.parameters, ElementsAre("a"));
+}
+
+TEST(CppCodegenTest, ShortCircuitingLogicUsesLazyArguments) {
+  ASSERT_OK_AND_ASSIGN(GeneratedCppExpr generated,
+                       Generate("a || (b && !c)"));
+
+  EXPECT_THAT(generated.parameters, ElementsAre("a", "b", "c"));
+  EXPECT_THAT(generated.source, HasSubstr("CelOr"));
+  EXPECT_THAT(generated.source, HasSubstr("CelAnd"));
+  // The right-hand side is wrapped in a deferred lambda.
+  EXPECT_THAT(generated.source, HasSubstr("[&]() -> Value {"));
+}
+
+TEST(CppCodegenTest, TernaryAndStringConstants) {
+  ASSERT_OK_AND_ASSIGN(GeneratedCppExpr generated,
+                       Generate("a ? 'yes\\n' : 'no'"));
+
+  EXPECT_THAT(generated.source, HasSubstr("CelTernary"));
+  EXPECT_THAT(generated.source, HasSubstr("yes\\n"));
+}
+
+TEST(CppCodegenTest, ComprehensionFallsBackToInterpreter) {
+  EXPECT_THAT(Generate("[1, 2, 3].all(x, x > 0)"),
+              StatusIs(absl::StatusCode::kUnimplemented));
+}
+
+TEST(CppCodegenTest, UnknownFunctionFallsBackToInterpreter) {
+  EXPECT_THAT(Generate("size(a)"),
+              StatusIs(absl::StatusCode::kUnimplemented,
+                       HasSubstr("no codegen for function size")));
+}
+
+TEST(CppCodegenTest, SelectFallsBackToInterpreter) {
+  EXPECT_THAT(Generate("request.path == '/'"),
+              StatusIs(absl::StatusCode::kUnimplemented));
+}
+
+}  // namespace
+}  // namespace cel
@@ -0,0 +1,356 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tools/program_cache/program_disk_cache.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/checked.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "eval/compiler/program_image.h"
+#include "internal/status_macros.h"
+#include "runtime/runtime_options.h"
+
+namespace cel {
+
+namespace {
+
+using ::google::api::expr::v1alpha1::CheckedExpr;
+using ::google::api::expr::runtime::LoadProgramImage;
+using ::google::api::expr::runtime::RuntimeOptionsFingerprint;
+using ::google::api::expr::runtime::SerializeProgramImage;
+
+constexpr absl::string_view kEntrySuffix = ".celp";
+
+inline uint32_t RotateRight(uint32_t value, int shift) {
+  return (value >> shift) | (value << (32 - shift));
+}
+
+constexpr std::array<uint32_t, 64> kSha256RoundConstants = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+// Self-contained SHA-256 (FIPS 180-4). The key must be collision resistant
+// across every process writing to a shared host directory, which rules out
+// the 64-bit FNV fingerprints used elsewhere, and the tree carries no crypto
+// dependency to lean on.
+class Sha256 {
+ public:
+  void Update(absl::string_view input) {
+    total_bytes_ += input.size();
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(input.data());
+    size_t size = input.size();
+    if (buffered_ > 0) {
+      size_t take = std::min(size, sizeof(buffer_) - buffered_);
+      std::memcpy(buffer_ + buffered_, data, take);
+      buffered_ += take;
+      data += take;
+      size -= take;
+      if (buffered_ == sizeof(buffer_)) {
+        Compress(buffer_);
+        buffered_ = 0;
+      }
+    }
+    while (size >= sizeof(buffer_)) {
+      Compress(data);
+      data += sizeof(buffer_);
+      size -= sizeof(buffer_);
+    }
+    std::memcpy(buffer_, data, size);
+    buffered_ += size;
+  }
+
+  std::array<uint8_t, 32> Finish() {
+    uint64_t bit_length = total_bytes_ * 8;
+    uint8_t trailer[72];
+    size_t pad = buffered_ < 56 ? 56 - buffered_ : 120 - buffered_;
+    std::memset(trailer, 0, sizeof(trailer));
+    trailer[0] = 0x80;
+    for (int i = 0; i < 8; ++i) {
+      trailer[pad + i] = static_cast<uint8_t>(bit_length >> (56 - 8 * i));
+    }
+    Update(absl::string_view(reinterpret_cast<const char*>(trailer), pad + 8));
+    std::array<uint8_t, 32> digest;
+    for (int i = 0; i < 8; ++i) {
+      digest[4 * i] = static_cast<uint8_t>(state_[i] >> 24);
+      digest[4 * i + 1] = static_cast<uint8_t>(state_[i] >> 16);
+      digest[4 * i + 2] = static_cast<uint8_t>(state_[i] >> 8);
+      digest[4 * i + 3] = static_cast<uint8_t>(state_[i]);
+    }
+    return digest;
+  }
+
+ private:
+  void Compress(const uint8_t block[64]) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+      w[i] = (uint32_t{block[4 * i]} << 24) |
+             (uint32_t{block[4 * i + 1]} << 16) |
+             (uint32_t{block[4 * i + 2]} << 8) | uint32_t{block[4 * i + 3]};
+    }
+    for (int i = 16; i < 64; ++i) {
+      uint32_t s0 = RotateRight(w[i - 15], 7) ^ RotateRight(w[i - 15], 18) ^
+                    (w[i - 15] >> 3);
+      uint32_t s1 = RotateRight(w[i - 2], 17) ^ RotateRight(w[i - 2], 19) ^
+                    (w[i - 2] >> 10);
+      w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+    uint32_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+    for (int i = 0; i < 64; ++i) {
+      uint32_t s1 = RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+      uint32_t ch = (e & f) ^ (~e & g);
+      uint32_t t1 = h + s1 + ch + kSha256RoundConstants[i] + w[i];
+      uint32_t s0 = RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+      uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+      uint32_t t2 = s0 + maj;
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + t2;
+    }
+    state_[0] += a;
+    state_[1] += b;
+    state_[2] += c;
+    state_[3] += d;
+    state_[4] += e;
+    state_[5] += f;
+    state_[6] += g;
+    state_[7] += h;
+  }
+
+  uint32_t state_[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+  uint64_t total_bytes_ = 0;
+  uint8_t buffer_[64];
+  size_t buffered_ = 0;
+};
+
+std::string EntryPath(absl::string_view directory, absl::string_view key) {
+  return absl::StrCat(directory, "/", key, kEntrySuffix);
+}
+
+absl::Status PosixError(absl::string_view operation, absl::string_view path) {
+  return absl::InternalError(
+      absl::StrCat(operation, " failed for ", path, ": ", strerror(errno)));
+}
+
+}  // namespace
+
+std::string ProgramCacheKey(absl::string_view source,
+                            const RuntimeOptions& runtime_options) {
+  Sha256 hasher;
+  uint64_t fingerprint = RuntimeOptionsFingerprint(runtime_options);
+  char prefix[sizeof(fingerprint)];
+  for (size_t i = 0; i < sizeof(prefix); ++i) {
+    prefix[i] = static_cast<char>(fingerprint >> (8 * i));
+  }
+  hasher.Update(absl::string_view(prefix, sizeof(prefix)));
+  hasher.Update(source);
+  std::array<uint8_t, 32> digest = hasher.Finish();
+  return absl::BytesToHexString(absl::string_view(
+      reinterpret_cast<const char*>(digest.data()), digest.size()));
+}
+
+std::string Sha256HexForTesting(absl::Span<const absl::string_view> chunks) {
+  Sha256 hasher;
+  for (absl::string_view chunk : chunks) {
+    hasher.Update(chunk);
+  }
+  std::array<uint8_t, 32> digest = hasher.Finish();
+  return absl::BytesToHexString(absl::string_view(
+      reinterpret_cast<const char*>(digest.data()), digest.size()));
+}
+
+absl::StatusOr<ProgramDiskCache> ProgramDiskCache::Create(
+    std::string directory, const Options& options) {
+  if (directory.empty()) {
+    return absl::InvalidArgumentError("cache directory must be non-empty");
+  }
+  if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+    return PosixError("mkdir", directory);
+  }
+  struct stat info;
+  if (stat(directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat(directory, " is not a directory"));
+  }
+  return ProgramDiskCache(std::move(directory), options);
+}
+
+absl::StatusOr<absl::optional<CheckedExpr>> ProgramDiskCache::Lookup(
+    absl::string_view source, const RuntimeOptions& runtime_options) const {
+  std::string path =
+      EntryPath(directory_, ProgramCacheKey(source, runtime_options));
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      return absl::nullopt;
+    }
+    return PosixError("open", path);
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    close(fd);
+    return PosixError("fstat", path);
+  }
+  if (info.st_size == 0) {
+    close(fd);
+    unlink(path.c_str());
+    return absl::nullopt;
+  }
+  void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ,
+                       MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return PosixError("mmap", path);
+  }
+  absl::StatusOr<CheckedExpr> expr = LoadProgramImage(
+      absl::string_view(static_cast<const char*>(mapping),
+                        static_cast<size_t>(info.st_size)),
+      runtime_options);
+  munmap(mapping, static_cast<size_t>(info.st_size));
+  if (!expr.ok()) {
+    // Corrupt or incompatible entry, e.g. a torn write surviving a crash or
+    // a key collision across image versions: drop it so the caller's
+    // recompilation overwrites it, and report a plain miss.
+    unlink(path.c_str());
+    return absl::nullopt;
+  }
+  // Refresh recency so eviction keeps the working set.
+  utime(path.c_str(), nullptr);
+  return absl::optional<CheckedExpr>(*std::move(expr));
+}
+
+absl::Status ProgramDiskCache::Insert(absl::string_view source,
+                                      const CheckedExpr& expr,
+                                      const RuntimeOptions& runtime_options) {
+  CEL_ASSIGN_OR_RETURN(std::string image,
+                       SerializeProgramImage(expr, runtime_options));
+  // Write to a private temporary file, then publish with an atomic rename so
+  // concurrent readers never map a partial entry.
+  std::string temp_path = absl::StrCat(directory_, "/tmp.XXXXXX");
+  int fd = mkstemp(&temp_path[0]);
+  if (fd < 0) {
+    return PosixError("mkstemp", temp_path);
+  }
+  const char* data = image.data();
+  size_t remaining = image.size();
+  while (remaining > 0) {
+    ssize_t written = write(fd, data, remaining);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      close(fd);
+      unlink(temp_path.c_str());
+      return PosixError("write", temp_path);
+    }
+    data += written;
+    remaining -= static_cast<size_t>(written);
+  }
+  // mkstemp creates the file owner-only; entries are meant to be shared by
+  // every process on the host.
+  fchmod(fd, 0644);
+  close(fd);
+  std::string path =
+      EntryPath(directory_, ProgramCacheKey(source, runtime_options));
+  if (rename(temp_path.c_str(), path.c_str()) != 0) {
+    unlink(temp_path.c_str());
+    return PosixError("rename", path);
+  }
+  return EnforceSizeBound();
+}
+
+absl::Status ProgramDiskCache::EnforceSizeBound() const {
+  if (options_.max_size_bytes <= 0) {
+    return absl::OkStatus();
+  }
+  struct Entry {
+    std::string path;
+    int64_t size;
+    time_t mtime;
+  };
+  DIR* dir = opendir(directory_.c_str());
+  if (dir == nullptr) {
+    return PosixError("opendir", directory_);
+  }
+  std::vector<Entry> entries;
+  int64_t total_size = 0;
+  while (struct dirent* ent = readdir(dir)) {
+    if (!absl::EndsWith(ent->d_name, kEntrySuffix)) {
+      continue;
+    }
+    std::string path = absl::StrCat(directory_, "/", ent->d_name);
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+      continue;  // Concurrently evicted.
+    }
+    total_size += info.st_size;
+    entries.push_back(Entry{std::move(path), info.st_size, info.st_mtime});
+  }
+  closedir(dir);
+  if (total_size <= options_.max_size_bytes) {
+    return absl::OkStatus();
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& lhs, const Entry& rhs) {
+              return lhs.mtime < rhs.mtime;
+            });
+  for (const Entry& entry : entries) {
+    if (total_size <= options_.max_size_bytes) {
+      break;
+    }
+    if (unlink(entry.path.c_str()) == 0 || errno == ENOENT) {
+      total_size -= entry.size;
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace cel
@@ -0,0 +1,102 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_TOOLS_PROGRAM_CACHE_PROGRAM_DISK_CACHE_H_
+#define THIRD_PARTY_CEL_CPP_TOOLS_PROGRAM_CACHE_PROGRAM_DISK_CACHE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "google/api/expr/v1alpha1/checked.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "runtime/runtime_options.h"
+
+namespace cel {
+
+// Persistent content-addressed store of compiled CEL programs, shared by all
+// processes on a host.
+//
+// Entries are program images (eval/compiler/program_image.h) keyed by
+// SHA-256(runtime options fingerprint || expression source) and written one
+// file per entry under a common directory, so any process can reuse the
+// parse and type-check work of another. A hit memory-maps the entry and
+// yields the checked expression ready for the expression builder; a miss
+// means the caller compiles as usual and inserts the result.
+//
+// Writes go to a temporary file and are published with an atomic rename, so
+// readers never observe partial entries and concurrent writers of the same
+// key simply race to produce identical files. Corrupt or incompatible
+// entries (e.g. torn writes surviving a crash) are deleted on lookup and
+// reported as misses. Inserts keep the directory under a configurable size
+// bound by evicting the least recently used entries; lookups refresh entry
+// recency.
+
+class ProgramDiskCache {
+ public:
+  struct Options {
+    // Total size of cached entries an insert may leave behind; the least
+    // recently used entries are deleted once the bound is exceeded.
+    // Non-positive disables eviction.
+    int64_t max_size_bytes = int64_t{256} << 20;
+  };
+
+  // Opens (creating if needed) the cache rooted at `directory`. The
+  // directory's parent must already exist.
+  static absl::StatusOr<ProgramDiskCache> Create(std::string directory,
+                                                 const Options& options = {});
+
+  // Returns the cached checked expression for `source` compiled under
+  // `runtime_options`, or nullopt if no usable entry exists.
+  absl::StatusOr<absl::optional<google::api::expr::v1alpha1::CheckedExpr>>
+  Lookup(absl::string_view source,
+         const RuntimeOptions& runtime_options) const;
+
+  // Stores the compilation result for `source`, replacing any existing entry
+  // for the same key, then enforces the size bound.
+  absl::Status Insert(absl::string_view source,
+                      const google::api::expr::v1alpha1::CheckedExpr& expr,
+                      const RuntimeOptions& runtime_options);
+
+  const std::string& directory() const { return directory_; }
+
+ private:
+  ProgramDiskCache(std::string directory, const Options& options)
+      : directory_(std::move(directory)), options_(options) {}
+
+  absl::Status EnforceSizeBound() const;
+
+  std::string directory_;
+  Options options_;
+};
+
+// Returns the hex cache key for `source` under `runtime_options`. The entry
+// for a key, if present, is the file "<key>.celp" in the cache directory;
+// exposed so operators and build tooling can locate entries.
+std::string ProgramCacheKey(absl::string_view source,
+                            const RuntimeOptions& runtime_options);
+
+// Hex SHA-256 digest of the concatenation of `chunks`, fed through the
+// hasher one chunk at a time. Exposes the cache's private hash primitive so
+// tests can pin it against the FIPS 180-4 known-answer vectors, including
+// the multi-block and buffered-Update paths the cache key depends on. Not
+// part of the cache interface.
+std::string Sha256HexForTesting(absl::Span<const absl::string_view> chunks);
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_TOOLS_PROGRAM_CACHE_PROGRAM_DISK_CACHE_H_
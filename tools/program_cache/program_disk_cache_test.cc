@@ -0,0 +1,261 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tools/program_cache/program_disk_cache.h"
+
+#include <utime.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "google/api/expr/v1alpha1/checked.pb.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "eval/compiler/program_image.h"
+#include "internal/testing.h"
+#include "runtime/runtime_options.h"
+
+namespace cel {
+
+namespace {
+
+using ::google::api::expr::v1alpha1::CheckedExpr;
+
+CheckedExpr MakeExpr(int64_t value) {
+  CheckedExpr expr;
+  expr.mutable_expr()->mutable_const_expr()->set_int64_value(value);
+  expr.mutable_expr()->set_id(1);
+  return expr;
+}
+
+std::string CacheDir(absl::string_view name) {
+  return absl::StrCat(::testing::TempDir(), "/program_disk_cache_", name);
+}
+
+std::string EntryPath(const ProgramDiskCache& cache, absl::string_view source,
+                      const RuntimeOptions& options) {
+  return absl::StrCat(cache.directory(), "/", ProgramCacheKey(source, options),
+                      ".celp");
+}
+
+TEST(ProgramDiskCacheTest, MissThenHit) {
+  RuntimeOptions options;
+  ASSERT_OK_AND_ASSIGN(ProgramDiskCache cache,
+                       ProgramDiskCache::Create(CacheDir("miss_then_hit")));
+
+  ASSERT_OK_AND_ASSIGN(auto missing, cache.Lookup("1 + 2", options));
+  EXPECT_EQ(missing, absl::nullopt);
+
+  ASSERT_OK(cache.Insert("1 + 2", MakeExpr(3), options));
+  ASSERT_OK_AND_ASSIGN(auto hit, cache.Lookup("1 + 2", options));
+  ASSERT_TRUE(hit.has_value());
+  EXPECT_EQ(hit->expr().const_expr().int64_value(), 3);
+}
+
+TEST(ProgramDiskCacheTest, SharedAcrossInstances) {
+  RuntimeOptions options;
+  std::string dir = CacheDir("shared");
+  ASSERT_OK_AND_ASSIGN(ProgramDiskCache writer, ProgramDiskCache::Create(dir));
+  ASSERT_OK(writer.Insert("1 + 2", MakeExpr(3), options));
+
+  // A second instance over the same directory, as another process would
+  // open, sees the entry.
+  ASSERT_OK_AND_ASSIGN(ProgramDiskCache reader, ProgramDiskCache::Create(dir));
+  ASSERT_OK_AND_ASSIGN(auto hit, reader.Lookup("1 + 2", options));
+  ASSERT_TRUE(hit.has_value());
+  EXPECT_EQ(hit->expr().const_expr().int64_value(), 3);
+}
+
+TEST(ProgramDiskCacheTest, KeyedBySourceAndOptions) {
+  RuntimeOptions options;
+  ASSERT_OK_AND_ASSIGN(ProgramDiskCache cache,
+                       ProgramDiskCache::Create(CacheDir("keying")));
+  ASSERT_OK(cache.Insert("1 + 2", MakeExpr(3), options));
+
+  ASSERT_OK_AND_ASSIGN(auto other_source, cache.Lookup("1 + 3", options));
+  EXPECT_EQ(other_source, absl::nullopt);
+
+  RuntimeOptions other_options;
+  other_options.enable_comprehension = false;
+  ASSERT_OK_AND_ASSIGN(auto mismatched, cache.Lookup("1 + 2", other_options));
+  EXPECT_EQ(mismatched, absl::nullopt);
+}
+
+TEST(ProgramDiskCacheTest, CorruptEntryIsAMiss) {
+  RuntimeOptions options;
+  ASSERT_OK_AND_ASSIGN(ProgramDiskCache cache,
+                       ProgramDiskCache::Create(CacheDir("corrupt")));
+  ASSERT_OK(cache.Insert("1 + 2", MakeExpr(3), options));
+
+  {
+    std::ofstream entry(EntryPath(cache, "1 + 2", options),
+                        std::ios::binary | std::ios::trunc);
+    entry << "not a program image";
+  }
+
+  ASSERT_OK_AND_ASSIGN(auto hit, cache.Lookup("1 + 2", options));
+  EXPECT_EQ(hit, absl::nullopt);
+  // The bad entry was dropped so the next insert replaces it cleanly.
+  ASSERT_OK(cache.Insert("1 + 2", MakeExpr(3), options));
+  ASSERT_OK_AND_ASSIGN(hit, cache.Lookup("1 + 2", options));
+  ASSERT_TRUE(hit.has_value());
+}
+
+void Backdate(const std::string& path, time_t seconds_ago) {
+  struct utimbuf times;
+  times.actime = time(nullptr) - seconds_ago;
+  times.modtime = times.actime;
+  ASSERT_EQ(utime(path.c_str(), &times), 0);
+}
+
+TEST(ProgramDiskCacheTest, EvictsLeastRecentlyUsed) {
+  RuntimeOptions options;
+  // Every entry serializes the same expression, so they are all the same
+  // size; budget exactly two of them.
+  ASSERT_OK_AND_ASSIGN(
+      std::string image,
+      google::api::expr::runtime::SerializeProgramImage(MakeExpr(3), options));
+  ProgramDiskCache::Options cache_options;
+  cache_options.max_size_bytes = 2 * static_cast<int64_t>(image.size());
+  ASSERT_OK_AND_ASSIGN(
+      ProgramDiskCache cache,
+      ProgramDiskCache::Create(CacheDir("eviction"), cache_options));
+
+  ASSERT_OK(cache.Insert("a", MakeExpr(3), options));
+  ASSERT_OK(cache.Insert("b", MakeExpr(3), options));
+  Backdate(EntryPath(cache, "a", options), 1000);
+  Backdate(EntryPath(cache, "b", options), 500);
+
+  ASSERT_OK(cache.Insert("c", MakeExpr(3), options));
+
+  ASSERT_OK_AND_ASSIGN(auto a, cache.Lookup("a", options));
+  EXPECT_EQ(a, absl::nullopt);
+  ASSERT_OK_AND_ASSIGN(auto b, cache.Lookup("b", options));
+  EXPECT_TRUE(b.has_value());
+  ASSERT_OK_AND_ASSIGN(auto c, cache.Lookup("c", options));
+  EXPECT_TRUE(c.has_value());
+}
+
+TEST(ProgramDiskCacheTest, LookupRefreshesRecency) {
+  RuntimeOptions options;
+  ASSERT_OK_AND_ASSIGN(
+      std::string image,
+      google::api::expr::runtime::SerializeProgramImage(MakeExpr(3), options));
+  ProgramDiskCache::Options cache_options;
+  cache_options.max_size_bytes = 2 * static_cast<int64_t>(image.size());
+  ASSERT_OK_AND_ASSIGN(
+      ProgramDiskCache cache,
+      ProgramDiskCache::Create(CacheDir("recency"), cache_options));
+
+  ASSERT_OK(cache.Insert("a", MakeExpr(3), options));
+  ASSERT_OK(cache.Insert("b", MakeExpr(3), options));
+  Backdate(EntryPath(cache, "a", options), 1000);
+  Backdate(EntryPath(cache, "b", options), 500);
+
+  // Touching "a" makes "b" the eviction candidate.
+  ASSERT_OK_AND_ASSIGN(auto a, cache.Lookup("a", options));
+  ASSERT_TRUE(a.has_value());
+  ASSERT_OK(cache.Insert("c", MakeExpr(3), options));
+
+  ASSERT_OK_AND_ASSIGN(a, cache.Lookup("a", options));
+  EXPECT_TRUE(a.has_value());
+  ASSERT_OK_AND_ASSIGN(auto b, cache.Lookup("b", options));
+  EXPECT_EQ(b, absl::nullopt);
+}
+
+TEST(ProgramDiskCacheTest, KeyIsStableHex) {
+  RuntimeOptions options;
+  std::string key = ProgramCacheKey("1 + 2", options);
+  EXPECT_EQ(key.size(), 64);
+  EXPECT_EQ(key, ProgramCacheKey("1 + 2", options));
+  EXPECT_NE(key, ProgramCacheKey("1 + 3", options));
+  RuntimeOptions other;
+  other.enable_comprehension = false;
+  EXPECT_NE(key, ProgramCacheKey("1 + 2", other));
+}
+
+// FIPS 180-4 known-answer vectors for the private SHA-256 implementation.
+// The shared-host cache key depends on its collision resistance, which the
+// shape-only assertions above cannot detect regressions in.
+TEST(ProgramDiskCacheTest, Sha256MatchesFipsKnownAnswers) {
+  // SHA-256("").
+  EXPECT_EQ(
+      Sha256HexForTesting({}),
+      "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  // SHA-256("abc"): single short block.
+  EXPECT_EQ(
+      Sha256HexForTesting({"abc"}),
+      "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  // Two-block message: 56 bytes buffered forces the length into a second
+  // padding block.
+  EXPECT_EQ(
+      Sha256HexForTesting(
+          {"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"}),
+      "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+  // One million 'a': exercises the bulk whole-block compression loop.
+  std::string million(1000000, 'a');
+  EXPECT_EQ(
+      Sha256HexForTesting({million}),
+      "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+// The digest must not depend on how the input is split across Update()
+// calls; chunk boundaries straddling the 64-byte block buffer exercise the
+// partial-buffer fill and drain paths.
+TEST(ProgramDiskCacheTest, Sha256ChunkedUpdateMatchesSingleShot) {
+  absl::string_view two_block =
+      "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+  EXPECT_EQ(
+      Sha256HexForTesting(
+          {two_block.substr(0, 1), two_block.substr(1, 30),
+           two_block.substr(31)}),
+      "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+  std::string million(1000000, 'a');
+  std::vector<absl::string_view> chunks;
+  absl::string_view remaining = million;
+  // Uneven chunk size so boundaries drift across block boundaries.
+  while (remaining.size() > 977) {
+    chunks.push_back(remaining.substr(0, 977));
+    remaining.remove_prefix(977);
+  }
+  chunks.push_back(remaining);
+  EXPECT_EQ(
+      Sha256HexForTesting(chunks),
+      "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+// Ties the cache key derivation to the pinned primitive: the key is the
+// SHA-256 of the little-endian options fingerprint followed by the source.
+TEST(ProgramDiskCacheTest, KeyDerivationMatchesPinnedSha256) {
+  RuntimeOptions options;
+  uint64_t fingerprint =
+      ::google::api::expr::runtime::RuntimeOptionsFingerprint(options);
+  char prefix[sizeof(fingerprint)];
+  for (size_t i = 0; i < sizeof(prefix); ++i) {
+    prefix[i] = static_cast<char>(fingerprint >> (8 * i));
+  }
+  EXPECT_EQ(ProgramCacheKey("1 + 2", options),
+            Sha256HexForTesting(
+                {absl::string_view(prefix, sizeof(prefix)), "1 + 2"}));
+}
+
+}  // namespace
+
+}  // namespace cel